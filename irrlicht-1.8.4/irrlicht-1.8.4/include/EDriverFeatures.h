@@ -121,6 +121,9 @@ namespace video
 		//! Support for NVidia's CG shader language
 		EVDF_CG,
 
+		//! Supports textures with DXT1 and DXT5 compressed data, see ECF_DXT1 and ECF_DXT5
+		EVDF_TEXTURE_COMPRESSED_DXT,
+
 		//! Only used for counting the elements of this enum
 		EVDF_COUNT
 	};
@@ -51,6 +51,12 @@ namespace scene
 		//! Mesh Scene Node
 		ESNT_MESH           = MAKE_IRR_ID('m','e','s','h'),
 
+		//! Mesh Scene Node with levels of detail
+		ESNT_LOD_MESH       = MAKE_IRR_ID('l','o','d','m'),
+
+		//! Instanced Mesh Scene Node
+		ESNT_INSTANCED_MESH = MAKE_IRR_ID('i','m','s','h'),
+
 		//! Light Scene Node
 		ESNT_LIGHT          = MAKE_IRR_ID('l','g','h','t'),
 
@@ -75,6 +81,9 @@ namespace scene
 		//! Quake3 Shader Scene Node
 		ESNT_Q3SHADER_SCENE_NODE  = MAKE_IRR_ID('q','3','s','h'),
 
+		//! Quake3 Level Scene Node
+		ESNT_Q3LEVEL = MAKE_IRR_ID('q','3','l','v'),
+
 		//! Quake3 Model Scene Node ( has tag to link to )
 		ESNT_MD3_SCENE_NODE  = MAKE_IRR_ID('m','d','3','_'),
 
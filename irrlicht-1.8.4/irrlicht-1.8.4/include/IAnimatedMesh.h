@@ -96,6 +96,26 @@ namespace scene
 		\return Returns the animated mesh based on a detail level. */
 		virtual IMesh* getMesh(s32 frame, s32 detailLevel=255, s32 startFrameLoop=-1, s32 endFrameLoop=-1) = 0;
 
+		//! Creates a mesh which receives the frames of this mesh for one user.
+		/** The mesh returned by getMesh() is shared by all users, so
+		several scene nodes showing different frames overwrite it with
+		each call. Each node can instead keep a mesh of its own and
+		update it with updateFrameMesh().
+		\return New mesh, drop it when it is no longer needed. 0 if
+		this type of mesh only supports getMesh(). */
+		virtual IMesh* createFrameMesh()
+		{
+			return 0;
+		}
+
+		//! Writes a frame into a mesh created by createFrameMesh() of this mesh.
+		/** \param target Mesh created by createFrameMesh().
+		The other parameters are the same as for getMesh(). */
+		virtual void updateFrameMesh(IMesh* target, s32 frame, s32 detailLevel=255,
+			s32 startFrameLoop=-1, s32 endFrameLoop=-1)
+		{
+		}
+
 		//! Returns the type of the animated mesh.
 		/** In most cases it is not neccessary to use this method.
 		This is useful for making a safe downcast. For example,
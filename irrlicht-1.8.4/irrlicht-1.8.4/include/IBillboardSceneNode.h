@@ -65,6 +65,17 @@ public:
 	\param[out] bottomColor Stores the color of the bottom vertices */
 	virtual void getColor(video::SColor& topColor,
 			video::SColor& bottomColor) const = 0;
+
+	//! Sets the part of the texture shown on the billboard
+	/** Used for billboards sharing a texture atlas, see
+	video::ITextureAtlas::getTextureCoords().
+	\param[in] rect Texture coordinates of the upper left and lower right
+	corner of the billboard, by default 0,0 and 1,1. */
+	virtual void setTextureRect(const core::rect<f32>& rect) = 0;
+
+	//! Gets the part of the texture shown on the billboard
+	/** \return Texture coordinates of the upper left and lower right corner. */
+	virtual const core::rect<f32>& getTextureRect() const = 0;
 };
 
 } // end namespace scene
@@ -71,6 +71,16 @@ public:
 	no matching name name was found. */
 	virtual s32 findFile(const io::path& filename, bool isFolder=false) const = 0;
 
+	//! Searches for a file or folder in the list
+	/** Same as findFile(const io::path&, bool), but does not need to
+	create a path, so searching for a string literal does not allocate
+	memory.
+	\param filename The name of the file to search for.
+	\param isFolder True if you are searching for a directory path, false if you are searching for a file
+	\return Returns the index of the file in the file list, or -1 if
+	no matching name name was found. */
+	virtual s32 findFile(const fschar_t* filename, bool isFolder=false) const = 0;
+
 	//! Returns the base path of the file list
 	virtual const io::path& getPath() const = 0;
 
@@ -34,7 +34,7 @@ public:
 		MaxSize(0,0), MinSize(1,1), IsVisible(true), IsEnabled(true),
 		IsSubElement(false), NoClip(false), ID(id), IsTabStop(false), TabOrder(-1), IsTabGroup(false),
 		AlignLeft(EGUIA_UPPERLEFT), AlignRight(EGUIA_UPPERLEFT), AlignTop(EGUIA_UPPERLEFT), AlignBottom(EGUIA_UPPERLEFT),
-		Environment(environment), Type(type)
+		Environment(environment), Type(type), IsDirty(true), IsLayoutDirty(true)
 	{
 		#ifdef _DEBUG
 		setDebugName("IGUIElement");
@@ -45,6 +45,7 @@ public:
 		{
 			parent->addChildToEnd(this);
 			recalculateAbsolutePosition(true);
+			setDirty();
 		}
 	}
 
@@ -268,7 +269,9 @@ public:
 
 
 	//! Returns true if a point is within this element.
-	/** Elements with a shape other than a rectangle should override this method */
+	/** Elements with a shape other than a rectangle should override this
+	method. The hit-testing index of the GUI environment only considers an
+	element for points inside its absolute clipping rectangle. */
 	virtual bool isPointInside(const core::position2d<s32>& point) const
 	{
 		return AbsoluteClippingRect.isPointInside(point);
@@ -282,6 +285,7 @@ public:
 		if (child)
 		{
 			child->updateAbsolutePosition();
+			child->setDirty();
 		}
 	}
 
@@ -295,6 +299,8 @@ public:
 				(*it)->Parent = 0;
 				(*it)->drop();
 				Children.erase(it);
+				setDirty();
+				setLayoutDirty();
 				return;
 			}
 	}
@@ -350,6 +356,11 @@ public:
 	//! Sets the visible state of this element.
 	virtual void setVisible(bool visible)
 	{
+		if (IsVisible != visible)
+		{
+			setDirty();
+			setLayoutDirty();
+		}
 		IsVisible = visible;
 	}
 
@@ -472,6 +483,8 @@ public:
 	//! Sets the enabled state of this element.
 	virtual void setEnabled(bool enabled)
 	{
+		if (IsEnabled != enabled)
+			setDirty();
 		IsEnabled = enabled;
 	}
 
@@ -480,6 +493,7 @@ public:
 	virtual void setText(const wchar_t* text)
 	{
 		Text = text;
+		setDirty();
 	}
 
 
@@ -518,6 +532,68 @@ public:
 	}
 
 
+	//! Marks this element as changed, so a cached image of it has to be redrawn.
+	/** Also marks all parents, as their cached image contains this element.
+	Elements changing their look outside of the common setters, like by
+	custom drawing depending on own state, should call this. */
+	void setDirty()
+	{
+		IGUIElement* e = this;
+		while (e)
+		{
+			e->IsDirty = true;
+			e = e->Parent;
+		}
+	}
+
+
+	//! Returns true if the element or one of its children changed since the last clearDirty()
+	bool isDirty() const
+	{
+		return IsDirty;
+	}
+
+
+	//! Resets the dirty state of this element and all its children.
+	void clearDirty()
+	{
+		IsDirty = false;
+		core::list<IGUIElement*>::Iterator it = Children.begin();
+		for (; it != Children.end(); ++it)
+			(*it)->clearDirty();
+	}
+
+
+	//! Returns true if the element changes its look on its own, like by animations.
+	/** Such elements are always drawn directly instead of from a cached
+	image, see IGUIEnvironment::setCachedComposition(). */
+	virtual bool isAnimated() const
+	{
+		return false;
+	}
+
+
+	//! Marks the position, visibility or order of this element as changed.
+	/** Tells the root element that its index of the areas covered by
+	its visible children has to be rebuilt. Elements changing their
+	absolute clipping rectangle or isPointInside() results without the
+	common setters should call this. */
+	void setLayoutDirty()
+	{
+		IGUIElement* e = this;
+		while (e->Parent)
+			e = e->Parent;
+		e->IsLayoutDirty = true;
+	}
+
+
+	//! Returns true if an element below this root element changed its area since the last clearLayoutDirty()
+	bool isLayoutDirty() const
+	{
+		return IsLayoutDirty;
+	}
+
+
 	//! Called if an event happened.
 	virtual bool OnEvent(const SEvent& event)
 	{
@@ -536,6 +612,8 @@ public:
 			{
 				Children.erase(it);
 				Children.push_back(element);
+				setDirty();
+				setLayoutDirty();
 				return true;
 			}
 		}
@@ -558,6 +636,8 @@ public:
 			{
 				Children.erase(it);
 				Children.push_front(child);
+				setDirty();
+				setLayoutDirty();
 				return true;
 			}
 		}
@@ -824,9 +904,16 @@ protected:
 			child->LastParentRect = getAbsolutePosition();
 			child->Parent = this;
 			Children.push_back(child);
+			child->setLayoutDirty();
 		}
 	}
 
+	//! Resets the layout state of this root element
+	void clearLayoutDirty()
+	{
+		IsLayoutDirty = false;
+	}
+
 	// not virtual because needed in constructor
 	void recalculateAbsolutePosition(bool recursive)
 	{
@@ -935,6 +1022,9 @@ protected:
 
 		RelativeRect.repair();
 
+		const core::rect<s32> oldRect(AbsoluteRect);
+		const core::rect<s32> oldClip(AbsoluteClippingRect);
+
 		AbsoluteRect = RelativeRect + parentAbsolute.UpperLeftCorner;
 
 		if (!Parent)
@@ -943,6 +1033,15 @@ protected:
 		AbsoluteClippingRect = AbsoluteRect;
 		AbsoluteClippingRect.clipAgainst(parentAbsoluteClip);
 
+		// pure movement keeps the look, only a different size or clipping needs a redraw
+		if (AbsoluteRect.getSize() != oldRect.getSize() ||
+			AbsoluteClippingRect.UpperLeftCorner - AbsoluteRect.UpperLeftCorner != oldClip.UpperLeftCorner - oldRect.UpperLeftCorner ||
+			AbsoluteClippingRect.getSize() != oldClip.getSize())
+			setDirty();
+
+		if (AbsoluteClippingRect != oldClip)
+			setLayoutDirty();
+
 		LastParentRect = parentAbsolute;
 
 		if ( recursive )
@@ -1027,6 +1126,14 @@ protected:
 
 	//! type of element
 	EGUI_ELEMENT_TYPE Type;
+
+private:
+
+	//! changed since it was last drawn into a cache?
+	bool IsDirty;
+
+	//! did a child of this root element change its area?
+	bool IsLayoutDirty;
 };
 
 
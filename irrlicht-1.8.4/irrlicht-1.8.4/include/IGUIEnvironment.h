@@ -74,6 +74,26 @@ public:
 	//! Draws all gui elements by traversing the GUI environment starting at the root node.
 	virtual void drawAll() = 0;
 
+	//! Enables drawing unchanged top-level elements from cached images.
+	/** Each visible child of the root element, usually a window, is drawn
+	into a texture once and afterwards composited with a single quad until
+	it or one of its children changes. This saves most of the draw calls of
+	mostly static GUIs, which is noticeable especially with the software
+	renderers. Changes are tracked with IGUIElement::setDirty(), custom
+	elements which change their look on their own have to call it, as do
+	users changing the colors or fonts of the current skin. Elements with
+	animated children (see IGUIElement::isAnimated()), unclipped children,
+	menus, modal screens, faders, mesh viewers and custom element types
+	are always drawn directly. Needs a driver
+	supporting EVDF_RENDER_TO_TARGET and drawAll() being called while the
+	screen is the render target, otherwise all elements are drawn as usual.
+	Disabled by default.
+	\param enable True to draw top-level elements from cached images. */
+	virtual void setCachedComposition(bool enable) = 0;
+
+	//! Returns if unchanged top-level elements are drawn from cached images.
+	virtual bool getCachedComposition() const = 0;
+
 	//! Sets the focus to an element.
 	/** Causes a EGET_ELEMENT_FOCUS_LOST event followed by a
 	EGET_ELEMENT_FOCUSED event. If someone absorbed either of the events,
@@ -48,6 +48,16 @@ namespace gui
 
 		//! Returns true if the image is using the alpha channel, false if not
 		virtual bool isAlphaChannelUsed() const = 0;
+
+		//! Sets the part of the texture which is drawn
+		/** Used for images sharing a texture atlas, see
+		video::ITextureAtlas::getTexture().
+		\param sourceRect Area of the texture in texels, or an empty
+		rectangle to draw the whole texture, which is the default. */
+		virtual void setSourceRect(const core::rect<s32>& sourceRect) = 0;
+
+		//! Returns the part of the texture which is drawn, empty for the whole texture
+		virtual const core::rect<s32>& getSourceRect() const = 0;
 	};
 
 
@@ -6,6 +6,7 @@
 #define __I_GUI_LIST_BOX_H_INCLUDED__
 
 #include "IGUIElement.h"
+#include "IGUIRowSource.h"
 #include "SColor.h"
 
 namespace irr
@@ -128,6 +129,17 @@ namespace gui
 
 		//! Sets whether to draw the background
 		virtual void setDrawBackground(bool draw) = 0;
+
+		//! Lets the list box ask a row source for its items.
+		/** Only the visible rows are requested, so this allows lists
+		with a huge amount of items. While a source is set, the items
+		added to the list box are not shown and item override colors
+		are replaced by IGUIRowSource::getCellColor().
+		\param source Source of the rows, or 0 to show the own items again. */
+		virtual void setRowSource(IGUIRowSource* source) = 0;
+
+		//! Returns the row source set with setRowSource(), or 0 if there is none.
+		virtual IGUIRowSource* getRowSource() const = 0;
 };
 
 
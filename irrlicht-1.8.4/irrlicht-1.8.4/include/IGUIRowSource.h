@@ -0,0 +1,62 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_GUI_ROW_SOURCE_H_INCLUDED__
+#define __I_GUI_ROW_SOURCE_H_INCLUDED__
+
+#include "IReferenceCounted.h"
+#include "SColor.h"
+
+namespace irr
+{
+namespace gui
+{
+
+//! Provides the rows of a list box or a table on demand.
+/** Set with IGUIListBox::setRowSource() or IGUITable::setRowSource(). The
+element then does not store its rows itself, but only asks for the rows
+it currently draws, so it can show a huge amount of them. All rows have the
+same height. When the rows change, call IGUIElement::setDirty() of the
+element, the row count is read again each frame. */
+class IGUIRowSource : public virtual IReferenceCounted
+{
+public:
+
+	//! Returns the amount of rows.
+	virtual u32 getRowCount() const = 0;
+
+	//! Returns the text of a cell.
+	/** Mostly called for the visible rows only. List boxes always ask for
+	column 0. The text has to stay valid until the next call.
+	\param row Index of the row, from 0 to getRowCount()-1.
+	\param column Index of the column.
+	\return Text of the cell, 0 for none. */
+	virtual const wchar_t* getCellText(u32 row, u32 column) const = 0;
+
+	//! Returns the icon of a row.
+	/** Only used by list boxes.
+	\param row Index of the row.
+	\return Index of the sprite in the sprite bank of the list box, or -1 for none. */
+	virtual s32 getRowIcon(u32 row) const
+	{
+		return -1;
+	}
+
+	//! Returns the text color of a cell if it differs from the skin.
+	/** \param row Index of the row.
+	\param column Index of the column.
+	\param color Receives the color of the text.
+	\return True if color was set, false for the default color. */
+	virtual bool getCellColor(u32 row, u32 column, video::SColor& color) const
+	{
+		return false;
+	}
+};
+
+
+} // end namespace gui
+} // end namespace irr
+
+#endif
+
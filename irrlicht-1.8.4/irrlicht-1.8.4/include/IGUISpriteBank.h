@@ -69,6 +69,12 @@ public:
 	//! returns the index of the sprite or -1 on failure
 	virtual s32 addTextureAsSprite(video::ITexture* texture) = 0;
 
+	//! Add a part of a texture and use it for a single non-animated sprite.
+	//! Used for sprites packed into a texture atlas, see video::ITextureAtlas::getTexture().
+	//! The texture is only added if it isn't in the sprite bank yet.
+	//! returns the index of the sprite or -1 on failure
+	virtual s32 addTextureAsSprite(video::ITexture* texture, const core::rect<s32>& sourceRect) = 0;
+
 	//! clears sprites, rectangles and textures
 	virtual void clear() = 0;
 
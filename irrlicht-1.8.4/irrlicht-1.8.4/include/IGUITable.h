@@ -6,6 +6,7 @@
 #define __I_GUI_TABLE_H_INCLUDED__
 
 #include "IGUIElement.h"
+#include "IGUIRowSource.h"
 #include "irrTypes.h"
 #include "SColor.h"
 #include "IGUISkin.h"
@@ -195,6 +196,18 @@ namespace gui
 
 		//! Get the flags, as defined in EGUI_TABLE_DRAW_FLAGS, which influence the layout
 		virtual s32 getDrawFlags() const = 0;
+
+		//! Lets the table ask a row source for the text of its cells.
+		/** Only the visible rows are requested, so this allows tables
+		with a huge amount of rows. The columns are still added to the
+		table. While a source is set, the own rows are not shown,
+		orderRows() does nothing and sorting has to be done by the
+		source when EGET_TABLE_HEADER_CHANGED is received.
+		\param source Source of the rows, or 0 to show the own rows again. */
+		virtual void setRowSource(IGUIRowSource* source) = 0;
+
+		//! Returns the row source set with setRowSource(), or 0 if there is none.
+		virtual IGUIRowSource* getRowSource() const = 0;
 	};
 
 
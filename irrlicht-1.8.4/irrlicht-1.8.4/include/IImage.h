@@ -123,6 +123,10 @@ public:
 			return 64;
 		case ECF_A32B32G32R32F:
 			return 128;
+		case ECF_DXT1:
+			return 4;
+		case ECF_DXT5:
+			return 8;
 		default:
 			return 0;
 		}
@@ -146,6 +150,26 @@ public:
 		}
 	}
 
+	//! test if the color format stores blocks of 4x4 pixels instead of single pixels
+	static bool isCompressedFormat(const ECOLOR_FORMAT format)
+	{
+		return format == ECF_DXT1 || format == ECF_DXT5;
+	}
+
+	//! get the size in bytes of a 4x4 block of a compressed color format, 0 for other formats
+	static u32 getBlockSizeFromFormat(const ECOLOR_FORMAT format)
+	{
+		switch(format)
+		{
+			case ECF_DXT1:
+				return 8;
+			case ECF_DXT5:
+				return 16;
+			default:
+				return 0;
+		}
+	}
+
 };
 
 } // end namespace video
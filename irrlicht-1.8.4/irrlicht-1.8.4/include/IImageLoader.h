@@ -43,6 +43,24 @@ public:
 	/** \param file File handle to check.
 	\return Pointer to newly created image, or 0 upon error. */
 	virtual IImage* loadImage(io::IReadFile* file) const = 0;
+
+	//! Creates a surface from the file, in the color format of a texture
+	/** Textures often store their pixels in another color format than
+	the loader decodes. Loaders which decode row by row can write the rows
+	in that format right away, which saves converting the whole image once
+	more when the texture is created. The default implementation, and
+	loaders which can't write the requested format, return loadImage(file).
+	This method may be called from several threads at once, with different
+	files.
+	\param file File handle to load from.
+	\param opaqueFormat Color format for images without alpha channel.
+	\param alphaFormat Color format for images with alpha channel.
+	\return Pointer to newly created image, or 0 upon error. */
+	virtual IImage* loadTextureImage(io::IReadFile* file,
+		ECOLOR_FORMAT opaqueFormat, ECOLOR_FORMAT alphaFormat) const
+	{
+		return loadImage(file);
+	}
 };
 
 
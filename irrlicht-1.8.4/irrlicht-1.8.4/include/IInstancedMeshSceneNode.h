@@ -0,0 +1,92 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_INSTANCED_MESH_SCENE_NODE_H_INCLUDED__
+#define __I_INSTANCED_MESH_SCENE_NODE_H_INCLUDED__
+
+#include "ISceneNode.h"
+#include "SColor.h"
+
+namespace irr
+{
+namespace scene
+{
+
+class IMesh;
+
+
+//! A scene node drawing many copies of the same static mesh
+/** Each copy, called instance, has its own transformation relative to
+the node and its own color, which is multiplied with the vertex colors.
+The instances are culled against the view frustum one by one and all
+visible ones are drawn with one IVideoDriver::drawMeshBufferInstanced()
+call per meshbuffer. This is much cheaper than a scene node per copy for
+things like trees, rocks or debris. */
+class IInstancedMeshSceneNode : public ISceneNode
+{
+public:
+
+	//! Constructor
+	IInstancedMeshSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1,1,1))
+		: ISceneNode(parent, mgr, id, position, rotation, scale) {}
+
+	//! Sets the mesh drawn by all instances
+	virtual void setMesh(IMesh* mesh) = 0;
+
+	//! Get the mesh drawn by all instances
+	virtual IMesh* getMesh() = 0;
+
+	//! Adds an instance
+	/** \param transform Transformation of the instance relative to the node.
+	\param color Color of the instance, multiplied with the vertex colors.
+	\return Index of the new instance. */
+	virtual u32 addInstance(const core::matrix4& transform,
+		video::SColor color=video::SColor(255,255,255,255)) = 0;
+
+	//! Adds an instance
+	/** \param position Position relative to the node.
+	\param rotation Rotation in degrees relative to the node.
+	\param scale Scale relative to the node.
+	\param color Color of the instance, multiplied with the vertex colors.
+	\return Index of the new instance. */
+	virtual u32 addInstance(const core::vector3df& position,
+		const core::vector3df& rotation = core::vector3df(0,0,0),
+		const core::vector3df& scale = core::vector3df(1,1,1),
+		video::SColor color=video::SColor(255,255,255,255)) = 0;
+
+	//! Removes an instance
+	/** The last instance takes the index of the removed one. */
+	virtual void removeInstance(u32 index) = 0;
+
+	//! Removes all instances
+	virtual void clearInstances() = 0;
+
+	//! Get the amount of instances
+	virtual u32 getInstanceCount() const = 0;
+
+	//! Sets the transformation of an instance relative to the node
+	virtual void setInstanceTransform(u32 index, const core::matrix4& transform) = 0;
+
+	//! Get the transformation of an instance relative to the node
+	virtual const core::matrix4& getInstanceTransform(u32 index) const = 0;
+
+	//! Sets the color of an instance
+	virtual void setInstanceColor(u32 index, video::SColor color) = 0;
+
+	//! Get the color of an instance
+	virtual video::SColor getInstanceColor(u32 index) const = 0;
+
+	//! Get the amount of instances which passed culling in the last frame
+	virtual u32 getVisibleInstanceCount() const = 0;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+
+#endif
+
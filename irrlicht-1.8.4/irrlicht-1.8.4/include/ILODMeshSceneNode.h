@@ -0,0 +1,89 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_LOD_MESH_SCENE_NODE_H_INCLUDED__
+#define __I_LOD_MESH_SCENE_NODE_H_INCLUDED__
+
+#include "IMeshSceneNode.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! A scene node displaying a static mesh with several levels of detail
+/** Level 0 is the full mesh, each further level has fewer triangles. The
+level is chosen each frame from the size of the node on the screen. Nodes
+of this type also take part in the triangle budget of the scene manager,
+see ISceneManager::setTriangleBudget().
+setMesh() creates the levels from the given mesh with
+IMeshManipulator::createMeshLODChain(), getMesh() always returns the most
+detailed level. */
+class ILODMeshSceneNode : public IMeshSceneNode
+{
+public:
+
+	//! Constructor
+	ILODMeshSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1,1,1))
+		: IMeshSceneNode(parent, mgr, id, position, rotation, scale) {}
+
+	//! Replaces all levels of detail
+	/** \param lods Meshes starting with the most detailed one. They all
+	need the same amount of meshbuffers with the same materials. The
+	meshes are grabbed by the node. */
+	virtual void setLODMeshes(const core::array<IMesh*>& lods) = 0;
+
+	//! Get the amount of levels of detail
+	virtual u32 getLODCount() const = 0;
+
+	//! Get the mesh of a level of detail
+	/** \param level Level between 0 and getLODCount()-1.
+	\return Mesh of the level, or 0 if the level does not exist. */
+	virtual IMesh* getLODMesh(u32 level) const = 0;
+
+	//! Get the amount of triangles of a level of detail
+	virtual u32 getLODTriangleCount(u32 level) const = 0;
+
+	//! Set the size on screen down to which the full detail is shown
+	/** Each time the size of the node on the screen halves, the next
+	level of detail is used.
+	\param pixels Diameter of the bounding sphere of the node in pixels.
+	Default is 256. */
+	virtual void setLODScreenSize(f32 pixels) = 0;
+
+	//! Get the size on screen down to which the full detail is shown
+	virtual f32 getLODScreenSize() const = 0;
+
+	//! Forces a level of detail
+	/** \param level Level to use, or -1 to choose the level from the
+	size on the screen, which is the default. */
+	virtual void setForcedLOD(s32 level) = 0;
+
+	//! Get the forced level of detail, -1 if there is none
+	virtual s32 getForcedLOD() const = 0;
+
+	//! Get the size of the node on the screen in pixels
+	/** Updated in OnRegisterSceneNode() from the active camera. */
+	virtual f32 getScreenSize() const = 0;
+
+	//! Get the level of detail used in the current frame
+	virtual u32 getCurrentLOD() const = 0;
+
+	//! Set the level of detail used in the current frame
+	/** This is used by the scene manager to shed detail when the
+	triangle budget is exceeded. It is chosen again in the next
+	OnRegisterSceneNode(). */
+	virtual void setCurrentLOD(u32 level) = 0;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+
+#endif
+
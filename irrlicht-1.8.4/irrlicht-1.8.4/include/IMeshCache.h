@@ -123,6 +123,14 @@ namespace scene
 		\return Pointer to the mesh or 0 if there is none with this number. */
 		virtual IAnimatedMesh* getMeshByName(const io::path& name) = 0;
 
+		//! Returns a mesh based on its name.
+		/** Same as getMeshByName(const io::path&), but does not need to
+		create a path, so looking up a mesh by a string literal does not
+		allocate memory.
+		\param name Name of the mesh. Usually a filename.
+		\return Pointer to the mesh or 0 if there is none with this name. */
+		virtual IAnimatedMesh* getMeshByName(const fschar_t* name) = 0;
+
 		//! Get the name of a loaded mesh, based on its index.
 		/** \param index: Index of the mesh, number between 0 and getMeshCount()-1.
 		\return The name if mesh was found and has a name, else	the path is empty. */
@@ -43,6 +43,14 @@ public:
 	If you no longer need the mesh, you should call IAnimatedMesh::drop().
 	See IReferenceCounted::drop() for more information. */
 	virtual IAnimatedMesh* createMesh(io::IReadFile* file) = 0;
+
+	//! Returns true if createMesh() may be called on worker threads.
+	/** Loaders which keep no state between calls and use neither the
+	video driver nor the scene manager can load meshes on the thread
+	pool, e.g. while a scene is loaded. Their messages are collected
+	and logged on the main thread. Several meshes may be loaded at once.
+	eturn False by default. */
+	virtual bool isThreadSafe() const { return false; }
 };
 
 
@@ -20,6 +20,20 @@ namespace scene
 
 	struct SMesh;
 
+	//! Flags for IMeshManipulator::optimizeMesh()
+	enum E_MESH_OPTIMIZATION
+	{
+		//! Reorder triangles for the post transform vertex cache
+		EMO_VERTEX_CACHE = 1,
+
+		//! Reorder vertices in the order they are used by the triangles
+		EMO_VERTEX_FETCH = 2,
+
+		//! Reorder groups of triangles so that outer ones are drawn first
+		/** Needs EMO_VERTEX_CACHE to form useful groups. */
+		EMO_OVERDRAW = 4
+	};
+
 	//! An interface for easy manipulation of meshes.
 	/** Scale, set alpha value, flip surfaces, and so on. This exists for
 	fixing problems with wrong imported or exported meshes quickly after
@@ -82,6 +96,22 @@ namespace scene
 		virtual void recalculateNormals(IMeshBuffer* buffer,
 				bool smooth = false, bool angleWeighted = false) const=0;
 
+		//! Recalculates smooth normals of the mesh, also across vertices sharing a position.
+		/** recalculateNormals() only smoothes over triangles which share
+		the same vertex, so seams from texture coordinates or colors stay
+		visible. This method averages the normals of all vertices of a
+		meshbuffer with exactly the same position instead.
+		\param mesh: Mesh on which the operation is performed.
+		\param angleWeighted: If the normals shall be smoothed in relation to their angles. More expensive, but also higher precision. */
+		virtual void recalculateNormalsAcrossSeams(IMesh* mesh,
+				bool angleWeighted = false) const=0;
+
+		//! Recalculates smooth normals of the mesh buffer, also across vertices sharing a position.
+		/** \param buffer: Mesh buffer on which the operation is performed.
+		\param angleWeighted: If the normals shall be smoothed in relation to their angles. More expensive, but also higher precision. */
+		virtual void recalculateNormalsAcrossSeams(IMeshBuffer* buffer,
+				bool angleWeighted = false) const=0;
+
 		//! Recalculates tangents, requires a tangent mesh
 		/** \param mesh Mesh on which the operation is performed.
 		\param recalculateNormals If the normals shall be recalculated, otherwise original normals of the mesh are used unchanged.
@@ -295,6 +325,60 @@ namespace scene
 		\return A new mesh optimized for the vertex cache. */
 		virtual IMesh* createForsythOptimizedMesh(const IMesh *mesh) const = 0;
 
+		//! Optimizes the order of triangles and vertices of a meshbuffer in place
+		/** Unlike createForsythOptimizedMesh() no copy is made, 32 bit
+		indices are supported and the vertices can also be reordered,
+		which improves memory locality when fetching them. The visual
+		result stays the same, but indices into the vertex array from
+		outside of the meshbuffer become invalid. So don't use it for
+		meshbuffers of skinned or morphed meshes.
+		\param buffer Meshbuffer to optimize.
+		\param flags Combination of E_MESH_OPTIMIZATION flags. */
+		virtual void optimizeMeshBuffer(IMeshBuffer* buffer,
+				u32 flags=EMO_VERTEX_CACHE|EMO_VERTEX_FETCH) const = 0;
+
+		//! Optimizes the order of triangles and vertices of all meshbuffers in place
+		/** See optimizeMeshBuffer(). This can be done automatically
+		when loading meshes, see scene::MESH_OPTIMIZE_ON_LOAD.
+		\param mesh Mesh to optimize.
+		\param flags Combination of E_MESH_OPTIMIZATION flags. */
+		virtual void optimizeMesh(IMesh* mesh,
+				u32 flags=EMO_VERTEX_CACHE|EMO_VERTEX_FETCH) const = 0;
+
+		//! Creates a copy of a mesh with a reduced amount of triangles
+		/** Edges are collapsed in the order of the smallest quadric
+		error, so flat areas lose their triangles first. Vertices are
+		never moved, only removed, so all vertex attributes are kept.
+		Vertices at the same position are collapsed together, so flat
+		shaded meshes don't tear apart. Open borders and texture seams
+		may only shrink along themselves. Meshbuffers keep their order
+		and materials, even if they end up empty.
+		\param mesh Input mesh
+		\param triangleRatio Amount of triangles to keep per meshbuffer,
+		relative to the input. 0.5 means about half of the triangles.
+		\param maxError Stops the simplification of a meshbuffer once the
+		mean distance to the original surface would become larger than
+		this value. 0 means no limit.
+		\return Simplified mesh. If you no longer need the mesh, you
+		should call IMesh::drop(). See IReferenceCounted::drop() for more
+		information. */
+		virtual IMesh* createMeshSimplified(IMesh* mesh, f32 triangleRatio, f32 maxError=0.f) const = 0;
+
+		//! Creates a chain of increasingly simplified meshes for level of detail rendering
+		/** \param mesh Input mesh, becomes the first level of the chain.
+		\param lods Receives the levels, starting with the input mesh.
+		Each level is created from the previous one by
+		createMeshSimplified(). All meshes in the array are grabbed, call
+		IMesh::drop() on each of them once you no longer need them.
+		\param levelCount Maximal amount of levels including the input
+		mesh. Fewer levels are created if a mesh can't be simplified any
+		further.
+		\param reduction Amount of triangles each level keeps from the
+		previous one.
+		\return Amount of levels created. */
+		virtual u32 createMeshLODChain(IMesh* mesh, core::array<IMesh*>& lods,
+			u32 levelCount=4, f32 reduction=0.5f) const = 0;
+
 		//! Apply a manipulator on the Meshbuffer
 		/** \param func A functor defining the mesh manipulation.
 		\param buffer The Meshbuffer to apply the manipulator to.
@@ -18,6 +18,7 @@ namespace io
 namespace scene
 {
 	class IMesh;
+	class IAnimatedMesh;
 
 	//! Interface for writing meshes
 	class IMeshWriter : public virtual IReferenceCounted
@@ -42,12 +43,19 @@ namespace scene
 		virtual bool writeMesh(io::IWriteFile* file, scene::IMesh* mesh,
 							s32 flags=EMWF_NONE) = 0;
 
-		// Writes an animated mesh
-		// for future use, no writer is able to write animated meshes currently
-		/* \return Returns true if sucessful */
-		//virtual bool writeAnimatedMesh(io::IWriteFile* file,
-		// scene::IAnimatedMesh* mesh,
-		// s32 flags=EMWF_NONE) = 0;
+		//! Write an animated mesh.
+		/** Only the binary Irrlicht mesh writer keeps the joints and
+		animation of skinned meshes currently, the other writers return
+		false here and have to be used with writeMesh().
+		\param file File handle to write the mesh to.
+		\param mesh Pointer to mesh to be written.
+		\param flags Optional flags to set properties of the writer.
+		\return True if sucessful */
+		virtual bool writeAnimatedMesh(io::IWriteFile* file,
+				scene::IAnimatedMesh* mesh, s32 flags=EMWF_NONE)
+		{
+			return false;
+		}
 	};
 
 
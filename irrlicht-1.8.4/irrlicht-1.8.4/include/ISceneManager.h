@@ -102,6 +102,8 @@ namespace scene
 	class IDummyTransformationSceneNode;
 	class ILightManager;
 	class ILightSceneNode;
+	class ILODMeshSceneNode;
+	class IInstancedMeshSceneNode;
 	class IMesh;
 	class IMeshBuffer;
 	class IMeshCache;
@@ -111,6 +113,7 @@ namespace scene
 	class IMeshWriter;
 	class IMetaTriangleSelector;
 	class IParticleSystemSceneNode;
+	class IQ3LevelMesh;
 	class ISceneCollisionManager;
 	class ISceneLoader;
 	class ISceneNode;
@@ -270,6 +273,13 @@ namespace scene
 		 *      lightmapper.</TD>
 		 *  </TR>
 		 *  <TR>
+		 *    <TD>Irrlicht Binary Mesh (.irrbmesh)</TD>
+		 *    <TD>A compact binary format native to Irrlicht, for static
+		 *      and skinned meshes, written by the irr binary mesh writer.
+		 *      Vertices are quantized and the data can be compressed,
+		 *      so files are small and load fast.</TD>
+		 *  </TR>
+		 *  <TR>
 		 *    <TD>LightWave (.lwo)</TD>
 		 *    <TD>Native to NewTek's LightWave 3D, the LWO format is well
 		 *      known and supported by many exporters. This loader will
@@ -522,6 +532,52 @@ namespace scene
 			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
 			bool alsoAddIfMeshPointerZero=false) = 0;
 
+		//! Adds a scene node for rendering a static mesh with levels of detail.
+		/** The levels are created with
+		IMeshManipulator::createMeshLODChain(), and the node chooses one
+		of them each frame from its size on the screen. If the mesh is
+		in the mesh cache, the levels are added to the cache as well, so
+		all nodes showing the same mesh share them.
+		\param mesh: Pointer to the loaded static mesh to be displayed.
+		\param levelCount: Maximal amount of levels including the mesh itself.
+		\param reduction: Amount of triangles each level keeps from the previous one.
+		\param parent: Parent of the scene node. Can be NULL if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\param position: Position of the space relative to its parent where the
+		scene node will be placed.
+		\param rotation: Initital rotation of the scene node.
+		\param scale: Initial scale of the scene node.
+		\param alsoAddIfMeshPointerZero: Add the scene node even if a 0 pointer is passed.
+		\return Pointer to the created scene node.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual ILODMeshSceneNode* addLODMeshSceneNode(IMesh* mesh, u32 levelCount=4, f32 reduction=0.5f,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
+			bool alsoAddIfMeshPointerZero=false) = 0;
+
+		//! Adds a scene node for rendering many copies of a static mesh.
+		/** Add the copies with IInstancedMeshSceneNode::addInstance().
+		All visible copies are drawn together, which is much faster
+		than adding a mesh scene node for each of them.
+		\param mesh: Pointer to the loaded static mesh to be displayed.
+		\param parent: Parent of the scene node. Can be NULL if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\param position: Position of the space relative to its parent where the
+		scene node will be placed.
+		\param rotation: Initital rotation of the scene node.
+		\param scale: Initial scale of the scene node.
+		\param alsoAddIfMeshPointerZero: Add the scene node even if a 0 pointer is passed.
+		\return Pointer to the created scene node.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual IInstancedMeshSceneNode* addInstancedMeshSceneNode(IMesh* mesh,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
+			bool alsoAddIfMeshPointerZero=false) = 0;
+
 		//! Adds a scene node for rendering a animated water surface mesh.
 		/** Looks really good when the Material type EMT_TRANSPARENT_REFLECTION
 		is used.
@@ -922,6 +978,21 @@ namespace scene
 												ISceneNode* parent=0, s32 id=-1
 												) = 0;
 
+		//! Adds a scene node drawing the geometry of a quake3 level.
+		/** The node uses the BSP tree and the potentially visible sets
+		stored in the .bsp file: Each frame only the faces of the leafs
+		which can be seen from the leaf the camera is in and which are
+		inside the view frustum are drawn. This is much faster than an
+		octree for most levels. Only the E_Q3_MESH_GEOMETRY mesh of the
+		level is drawn, the shader meshes still need their own nodes.
+		\param mesh: The level, loaded with getMesh() from a .bsp file.
+		\param parent: Parent node of the level node.
+		\param id: id of the node. This id can be used to identify the node.
+		\return Pointer to the level node if successful, otherwise 0.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual ISceneNode* addQ3LevelSceneNode(IQ3LevelMesh* mesh,
+			ISceneNode* parent=0, s32 id=-1) = 0;
+
 
 		//! Adds an empty scene node to the scene graph.
 		/** Can be used for doing advanced transformations
@@ -1633,6 +1704,17 @@ namespace scene
 		//! Get ambient color of the scene
 		virtual const video::SColorf& getAmbientLight() const = 0;
 
+		//! Sets the maximal amount of triangles drawn by level of detail nodes per frame
+		/** When the visible ILODMeshSceneNodes would draw more triangles,
+		the scene manager switches them to coarser levels, starting with
+		the nodes which are smallest on the screen.
+		\param triangles Maximal amount of triangles, 0 for no limit,
+		which is the default. */
+		virtual void setTriangleBudget(u32 triangles) = 0;
+
+		//! Get the maximal amount of triangles drawn by level of detail nodes per frame
+		virtual u32 getTriangleBudget() const = 0;
+
 		//! Register a custom callbacks manager which gets callbacks during scene rendering.
 		/** \param[in] lightManager: the new callbacks manager. You may pass 0 to remove the
 			current callbacks manager and restore the default behavior. */
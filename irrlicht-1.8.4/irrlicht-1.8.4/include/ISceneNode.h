@@ -49,7 +49,9 @@ namespace scene
 			: RelativeTranslation(position), RelativeRotation(rotation), RelativeScale(scale),
 				Parent(0), SceneManager(mgr), TriangleSelector(0), ID(id),
 				AutomaticCullingState(EAC_BOX), DebugDataVisible(EDS_OFF),
-				IsVisible(true), IsDebugObject(false)
+				IsVisible(true), IsDebugObject(false),
+				TransformRevision(0), ParentTransformRevision(0), TransformDirty(true),
+				RelativeTransformationCacheValid(false)
 		{
 			if (parent)
 				parent->addChild(this);
@@ -123,7 +125,7 @@ namespace scene
 				}
 
 				// update absolute position
-				updateAbsolutePosition();
+				updateAbsolutePositionAndRevision();
 
 				// perform the post render process on all children
 
@@ -200,9 +202,16 @@ namespace scene
 		/** The relative transformation is stored internally as 3
 		vectors: translation, rotation and scale. To get the relative
 		transformation matrix, it is calculated from these values.
+		The matrix is cached until one of the values changes.
 		\return The relative transformation matrix. */
 		virtual core::matrix4 getRelativeTransformation() const
 		{
+			if (RelativeTransformationCacheValid &&
+				CachedTranslation == RelativeTranslation &&
+				CachedRotation == RelativeRotation &&
+				CachedScale == RelativeScale)
+				return RelativeTransformationCache;
+
 			core::matrix4 mat;
 			mat.setRotationDegrees(RelativeRotation);
 			mat.setTranslation(RelativeTranslation);
@@ -214,6 +223,12 @@ namespace scene
 				mat *= smat;
 			}
 
+			RelativeTransformationCache = mat;
+			CachedTranslation = RelativeTranslation;
+			CachedRotation = RelativeRotation;
+			CachedScale = RelativeScale;
+			RelativeTransformationCacheValid = true;
+
 			return mat;
 		}
 
@@ -289,6 +304,7 @@ namespace scene
 				child->remove(); // remove from old parent
 				Children.push_back(child);
 				child->Parent = this;
+				child->TransformDirty = true;
 			}
 		}
 
@@ -306,6 +322,7 @@ namespace scene
 				if ((*it) == child)
 				{
 					(*it)->Parent = 0;
+					(*it)->TransformDirty = true;
 					(*it)->drop();
 					Children.erase(it);
 					return true;
@@ -326,6 +343,7 @@ namespace scene
 			for (; it != Children.end(); ++it)
 			{
 				(*it)->Parent = 0;
+				(*it)->TransformDirty = true;
 				(*it)->drop();
 			}
 
@@ -599,6 +617,7 @@ namespace scene
 			remove();
 
 			Parent = newParent;
+			TransformDirty = true;
 
 			if (Parent)
 				Parent->addChild(this);
@@ -648,16 +667,74 @@ namespace scene
 
 		//! Updates the absolute position based on the relative and the parents position
 		/** Note: This does not recursively update the parents absolute positions, so if you have a deeper
-			hierarchy you might want to update the parents first.*/
+			hierarchy you might want to update the parents first.
+			Nothing is calculated if neither the relative transformation nor the
+			transformation revision of the parent changed since the last call, so
+			static nodes are cheap. Child nodes only recalculate when the revision
+			changed, so call updateAbsolutePositionAndRevision() instead of this
+			method if it may be overridden. */
 		virtual void updateAbsolutePosition()
 		{
+			const core::matrix4 relative = getRelativeTransformation();
+			const u32 parentRevision = Parent ? Parent->getTransformRevision() : 0;
+
+			if (!TransformDirty && parentRevision == ParentTransformRevision &&
+				relative == LastRelativeTransformation)
+				return;
+
 			if (Parent)
 			{
 				AbsoluteTransformation =
-					Parent->getAbsoluteTransformation() * getRelativeTransformation();
+					Parent->getAbsoluteTransformation() * relative;
 			}
 			else
-				AbsoluteTransformation = getRelativeTransformation();
+				AbsoluteTransformation = relative;
+
+			LastRelativeTransformation = relative;
+			ParentTransformRevision = parentRevision;
+			TransformDirty = false;
+			++TransformRevision;
+		}
+
+
+		//! Updates the absolute position and the revision of the absolute transformation
+		/** Calls updateAbsolutePosition() and increases the revision if the
+		absolute transformation changed, also when updateAbsolutePosition()
+		is overridden without calling the implementation of ISceneNode.
+		OnAnimate() uses this, call it instead of updateAbsolutePosition()
+		so that child nodes notice the change. */
+		void updateAbsolutePositionAndRevision()
+		{
+			const u32 revision = TransformRevision;
+			const core::matrix4 previous = AbsoluteTransformation;
+
+			updateAbsolutePosition();
+
+			if (revision == TransformRevision && previous != AbsoluteTransformation)
+				++TransformRevision;
+		}
+
+
+		//! Get the revision of the absolute transformation
+		/** The revision is increased each time the absolute transformation
+		is recalculated by updateAbsolutePosition() of ISceneNode or changed
+		by an override of it called through updateAbsolutePositionAndRevision().
+		Comparing it with a stored value is a cheap way to find out if data
+		depending on the transformation has to be updated.
+		\return Current revision of the absolute transformation. */
+		u32 getTransformRevision() const
+		{
+			return TransformRevision;
+		}
+
+
+		//! Forces the next updateAbsolutePosition() to recalculate the absolute transformation
+		/** Only needed by derived nodes with a relative transformation
+		which isn't stored in the usual members, if changes to it can't be
+		detected by comparing the result of getRelativeTransformation(). */
+		void setTransformDirty()
+		{
+			TransformDirty = true;
 		}
 
 
@@ -731,7 +808,7 @@ namespace scene
 			DebugDataVisible = in->getAttributeAsInt("DebugDataVisible");
 			IsDebugObject = in->getAttributeAsBool("IsDebugObject");
 
-			updateAbsolutePosition();
+			updateAbsolutePositionAndRevision();
 		}
 
 		//! Creates a clone of this scene node and its children.
@@ -767,6 +844,7 @@ namespace scene
 			DebugDataVisible = toCopyFrom->DebugDataVisible;
 			IsVisible = toCopyFrom->IsVisible;
 			IsDebugObject = toCopyFrom->IsDebugObject;
+			TransformDirty = true;
 
 			if (newManager)
 				SceneManager = newManager;
@@ -848,6 +926,27 @@ namespace scene
 
 		//! Is debug object?
 		bool IsDebugObject;
+
+		//! Revision of AbsoluteTransformation, see getTransformRevision()
+		u32 TransformRevision;
+
+		//! Revision of the parent transformation used for AbsoluteTransformation
+		u32 ParentTransformRevision;
+
+		//! Relative transformation used for AbsoluteTransformation
+		core::matrix4 LastRelativeTransformation;
+
+		//! Forces the next updateAbsolutePosition() to recalculate
+		bool TransformDirty;
+
+	private:
+
+		//! Cache of getRelativeTransformation() with the values it was made of
+		mutable core::matrix4 RelativeTransformationCache;
+		mutable core::vector3df CachedTranslation;
+		mutable core::vector3df CachedRotation;
+		mutable core::vector3df CachedScale;
+		mutable bool RelativeTransformationCacheValid;
 	};
 
 
@@ -91,6 +91,12 @@ namespace scene
 			//! Weight Strength/Percentage (0-1)
 			f32 strength;
 
+			//! Position of the vertex before skinning, set by finalize()
+			const core::vector3df& getStaticPos() const { return StaticPos; }
+
+			//! Normal of the vertex before skinning, set by finalize()
+			const core::vector3df& getStaticNormal() const { return StaticNormal; }
+
 		private:
 			//! Internal members used by CSkinnedMesh
 			friend class CSkinnedMesh;
@@ -0,0 +1,91 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_TEXTURE_ATLAS_H_INCLUDED__
+#define __I_TEXTURE_ATLAS_H_INCLUDED__
+
+#include "IReferenceCounted.h"
+#include "path.h"
+#include "rect.h"
+#include "dimension2d.h"
+
+namespace irr
+{
+namespace video
+{
+	class ITexture;
+	class IImage;
+
+	//! Packs many small images into a few large textures, called pages.
+	/** Drawing things which use the same texture needs no texture switch,
+	so sprites, billboards and gui images packed into one page can be
+	batched. Add all images first, then call build() once, which packs them
+	and creates the textures of the pages. Each image keeps its name, use
+	getTexture() or getTextureCoords() to find out where it was placed and
+	hand the result to scene::IBillboardSceneNode::setTextureRect(),
+	gui::IGUIImage::setSourceRect() or gui::IGUISpriteBank::addTextureAsSprite().
+
+	Each image gets a border of padding texels around it, which repeats
+	the edge texels of the image. So bilinear filtering doesn't blend in the
+	neighbouring images, and a border of n texels keeps mip map levels up to
+	log2(n) clean. The areas reserved for the images, borders included,
+	start and end on multiples of 4, so neighbouring images don't share
+	texels in the first mip map levels even without borders.
+	Create an atlas with IVideoDriver::createTextureAtlas(). */
+	class ITextureAtlas : public virtual IReferenceCounted
+	{
+	public:
+
+		//! Adds an image to be packed with the next call of build().
+		/** \param name Name to find the image in the atlas again.
+		\param image Image to add, it is grabbed until build() is called.
+		\return False if the name is already used or the image, including
+		its borders, doesn't fit onto a page. */
+		virtual bool addImage(const io::path& name, IImage* image) = 0;
+
+		//! Loads an image from a file and adds it to be packed with the next call of build().
+		/** \param filename Name of the file, also used as name in the atlas.
+		\return False if the file couldn't be loaded, or see addImage(). */
+		virtual bool addImage(const io::path& filename) = 0;
+
+		//! Packs all images added since the last call and creates the textures of their pages.
+		/** Images which were packed before keep their place, new images
+		are put onto new pages.
+		\return False if textures for the pages couldn't be created. */
+		virtual bool build() = 0;
+
+		//! Returns the amount of images in the atlas
+		virtual u32 getImageCount() const = 0;
+
+		//! Returns the page texture of an image.
+		/** \param name Name of the image.
+		\param sourceRect If not 0, receives the area of the image on the
+		page in texels.
+		\return The texture of the page, or 0 if the name is unknown or
+		build() wasn't called yet. */
+		virtual ITexture* getTexture(const io::path& name, core::rect<s32>* sourceRect=0) const = 0;
+
+		//! Returns the texture coordinates of an image on its page.
+		/** \param name Name of the image.
+		\return The area of the image in texture coordinates between 0 and 1,
+		or the whole texture if the name is unknown. */
+		virtual core::rect<f32> getTextureCoords(const io::path& name) const = 0;
+
+		//! Returns the amount of pages
+		virtual u32 getPageCount() const = 0;
+
+		//! Returns the texture of a page.
+		/** \param index Index of the page, smaller than getPageCount().
+		\return The texture, or 0 if the index is out of range. */
+		virtual ITexture* getPage(u32 index) const = 0;
+
+		//! Returns the size of the pages
+		virtual const core::dimension2d<u32>& getPageSize() const = 0;
+	};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
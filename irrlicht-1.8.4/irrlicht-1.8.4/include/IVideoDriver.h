@@ -47,6 +47,7 @@ namespace video
 	class IImageWriter;
 	class IMaterialRenderer;
 	class IGPUProgrammingServices;
+	class ITextureAtlas;
 
 	//! enumeration for geometry transformation states
 	enum E_TRANSFORMATION_STATE
@@ -384,6 +385,20 @@ namespace video
 		IReferenceCounted::drop() for more information. */
 		virtual ITexture* getTexture(io::IReadFile* file) =0;
 
+		//! Get access to many named textures at once.
+		/** Works like getTexture(const io::path&) for each of the
+		files. If the engine was compiled with _IRR_COMPILE_WITH_THREADS_
+		and has worker threads, the files which aren't loaded yet are read
+		and decoded on all threads at once, only the textures are created
+		on the calling thread.
+		\param filenames Filenames of the textures to be loaded.
+		\param outTextures Receives the texture of each filename at the
+		same index, or 0 if it could not be loaded. These pointers should
+		not be dropped. See IReferenceCounted::drop() for more information.
+		\return Amount of textures which could be loaded. */
+		virtual u32 getTextures(const core::array<io::path>& filenames,
+			core::array<ITexture*>& outTextures) =0;
+
 		//! Returns a texture by index
 		/** \param index: Index of the texture, must be smaller than
 		getTextureCount() Please note that this index might change when
@@ -397,6 +412,15 @@ namespace video
 		/** \return Amount of textures currently loaded */
 		virtual u32 getTextureCount() const = 0;
 
+		//! Returns the memory used by the textures in a color format
+		/** Block compressed textures are counted in ECF_DXT1 or ECF_DXT5,
+		their uncompressed mip map levels in the format of these.
+		\param format Color format of the texture data.
+		\return Size of the texture data in bytes. Drivers which don't
+		know the actual size estimate it from the size and color format
+		of the textures. */
+		virtual u32 getTextureMemory(ECOLOR_FORMAT format) const = 0;
+
 		//! Renames a texture
 		/** \param texture Pointer to the texture to rename.
 		\param newName New name for the texture. This should be a unique name. */
@@ -1018,6 +1042,21 @@ namespace video
 		/** \param mb Buffer to draw */
 		virtual void drawMeshBuffer(const scene::IMeshBuffer* mb) =0;
 
+		//! Draws a mesh buffer several times with different transformations
+		/** All instances are drawn with the current material. Drivers
+		without native support merge small buffers on the CPU into
+		pre-transformed batches, which are drawn with one call each.
+		Buffers with 32bit indices or too many vertices for merging are
+		drawn one instance after the other, without instance colors.
+		The world transformation is restored afterwards.
+		\param mb Buffer to draw
+		\param transforms World transformation of each instance.
+		\param colors Color of each instance, multiplied with the vertex
+		colors. Can be 0 to keep the vertex colors.
+		\param instanceCount Amount of instances */
+		virtual void drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+			const core::matrix4* transforms, const SColor* colors, u32 instanceCount) =0;
+
 		//! Draws normals of a mesh buffer
 		/** \param mb Buffer to draw the normals of
 		\param length length scale factor of the normals
@@ -1177,6 +1216,18 @@ namespace video
 		See IReferenceCounted::drop() for more information. */
 		virtual IImage* createImageFromFile(io::IReadFile* file) =0;
 
+		//! Creates a software image from a file, to become a texture.
+		/** Unlike createImageFromFile(), block compressed images stay
+		compressed, addTexture() unpacks them if the driver can't use
+		them. Only the image loaders are used, so the images of many
+		textures can be loaded on other threads, and turned into textures
+		with addTexture() on the thread of the driver afterwards.
+		\param file File from which the image is created.
+		\return The created image, or 0 if the file couldn't be loaded.
+		If you no longer need the image, you should call IImage::drop().
+		See IReferenceCounted::drop() for more information. */
+		virtual IImage* createTextureImageFromFile(io::IReadFile* file) =0;
+
 		//! Writes the provided image to a file.
 		/** Requires that there is a suitable image writer registered
 		for writing the image.
@@ -1260,6 +1311,20 @@ namespace video
 				const core::position2d<s32>& pos,
 				const core::dimension2d<u32>& size) =0;
 
+		//! Creates a texture atlas which packs images into shared textures.
+		/** \param name Name of the atlas, the textures of its pages are
+		named after it.
+		\param pageSize Size of the textures of the pages.
+		\param padding Width of the borders around the images, which
+		repeat their edge texels.
+		\return The created atlas. If you no longer need it, you should
+		call ITextureAtlas::drop(). The page textures stay in the driver
+		until they are removed from it.
+		See IReferenceCounted::drop() for more information. */
+		virtual ITextureAtlas* createTextureAtlas(const io::path& name,
+				const core::dimension2d<u32>& pageSize=core::dimension2d<u32>(1024,1024),
+				u32 padding=2) =0;
+
 		//! Event handler for resize events. Only used by the engine internally.
 		/** Used to notify the driver that the window was resized.
 		Usually, there is no need to call this method. */
@@ -1380,6 +1445,14 @@ namespace video
 		\return Pointer to loaded texture, or 0 if not found. */
 		virtual video::ITexture* findTexture(const io::path& filename) = 0;
 
+		//! Check if the image is already loaded.
+		/** Same as findTexture(const io::path&), but does not need to
+		create a path, so looking up a texture by a string literal does
+		not allocate memory.
+		\param filename Name of the texture.
+		\return Pointer to loaded texture, or 0 if not found. */
+		virtual video::ITexture* findTexture(const fschar_t* filename) = 0;
+
 		//! Set or unset a clipping plane.
 		/** There are at least 6 clipping planes available for the user
 		to set at will.
@@ -228,6 +228,14 @@ you will not be able to use anything provided by the GUI Environment, including
 #undef _IRR_COMPILE_WITH_GUI_
 #endif
 
+//! Define _IRR_COMPILE_WITH_THREADS_ to let the engine spread expensive work over worker threads
+/** This is used for load-time work like building octrees. If you disable this, all such work
+is done on the calling thread. On posix systems the application has to link against pthread. */
+#define _IRR_COMPILE_WITH_THREADS_
+#ifdef NO_IRR_COMPILE_WITH_THREADS_
+#undef _IRR_COMPILE_WITH_THREADS_
+#endif
+
 //! Define _IRR_WCHAR_FILESYSTEM to enable unicode filesystem support for the engine.
 /** This enables the engine to read/write from unicode filesystem. If you
 disable this feature, the engine behave as before (ansi). This is currently only supported
@@ -309,6 +317,16 @@ to provide the user with the proper DLL. That's why it's disabled by default. */
 tool <http://developer.nvidia.com/object/nvperfhud_home.html>. */
 #undef _IRR_USE_NVIDIA_PERFHUD_
 
+//! Uncomment this line to count the heap allocations of the engine containers
+/** The allocators of irrAllocator.h then count their heap allocations. Read the count
+with core::getAllocationCount(), for example to make sure a frame does not allocate once
+the scene is set up. There is one counter in the engine library for the allocations of
+all threads, it is incremented atomically. */
+//#define _IRR_COUNT_ALLOCATIONS_
+#ifdef NO_IRR_COUNT_ALLOCATIONS_
+#undef _IRR_COUNT_ALLOCATIONS_
+#endif
+
 //! Define one of the three setting for Burning's Video Software Rasterizer
 /** So if we were marketing guys we could say Irrlicht has 4 Software-Rasterizers.
 	In a Nutshell:
@@ -378,6 +396,11 @@ B3D, MS3D or X meshes */
 #ifdef NO_IRR_COMPILE_WITH_IRR_MESH_LOADER_
 #undef _IRR_COMPILE_WITH_IRR_MESH_LOADER_
 #endif
+//! Define _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_ if you want to load binary Irrlicht Engine .irrbmesh files
+#define _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+#ifdef NO_IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+#undef _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+#endif
 //! Define _IRR_COMPILE_WITH_HALFLIFE_LOADER_ if you want to load Halflife animated files
 #define _IRR_COMPILE_WITH_HALFLIFE_LOADER_
 #ifdef NO_IRR_COMPILE_WITH_HALFLIFE_LOADER_
@@ -464,6 +487,11 @@ B3D, MS3D or X meshes */
 #ifdef NO_IRR_COMPILE_WITH_IRR_WRITER_
 #undef _IRR_COMPILE_WITH_IRR_WRITER_
 #endif
+//! Define _IRR_COMPILE_WITH_IRR_BINARY_WRITER_ if you want to write binary .irrbmesh files
+#define _IRR_COMPILE_WITH_IRR_BINARY_WRITER_
+#ifdef NO_IRR_COMPILE_WITH_IRR_BINARY_WRITER_
+#undef _IRR_COMPILE_WITH_IRR_BINARY_WRITER_
+#endif
 //! Define _IRR_COMPILE_WITH_COLLADA_WRITER_ if you want to write Collada files
 #define _IRR_COMPILE_WITH_COLLADA_WRITER_
 #ifdef NO_IRR_COMPILE_WITH_COLLADA_WRITER_
@@ -517,9 +545,8 @@ B3D, MS3D or X meshes */
 #undef _IRR_COMPILE_WITH_PSD_LOADER_
 #endif
 //! Define _IRR_COMPILE_WITH_DDS_LOADER_ if you want to load .dds files
-// Outcommented because
-// a) it doesn't compile on 64-bit currently
-// b) anyone enabling it should be aware that S3TC compression algorithm which might be used in that loader
+// DXT1 and DXT5 data are kept compressed for drivers supporting EVDF_TEXTURE_COMPRESSED_DXT.
+// Outcommented because anyone enabling it should be aware that S3TC compression algorithm which might be used in that loader
 // is patented in the US by S3 and they do collect license fees when it's used in applications.
 // So if you are unfortunate enough to develop applications for US market and their broken patent system be careful.
 // #define _IRR_COMPILE_WITH_DDS_LOADER_
@@ -673,6 +700,23 @@ precision will be lower but speed higher. currently X86 only
 	#endif
 #endif
 
+//! Use SSE or NEON instructions for the f32 matrix functions and the interpolation of vertex animated meshes
+/** Enabled when the compiler targets SSE (always the case for x86-64) or NEON.
+The results stay within float precision of the plain C++ code, most functions
+even give the same bits. Define NO_IRR_COMPILE_WITH_SIMD_ to use the C++ code. */
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define _IRR_COMPILE_WITH_SSE_
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define _IRR_COMPILE_WITH_NEON_
+#endif
+#ifdef NO_IRR_COMPILE_WITH_SIMD_
+#undef _IRR_COMPILE_WITH_SSE_
+#undef _IRR_COMPILE_WITH_NEON_
+#endif
+#if defined(_IRR_COMPILE_WITH_SSE_) || defined(_IRR_COMPILE_WITH_NEON_)
+#define _IRR_COMPILE_WITH_SIMD_
+#endif
+
 // Some cleanup and standard stuff
 
 #ifdef _IRR_WINDOWS_API_
@@ -742,6 +786,7 @@ precision will be lower but speed higher. currently X86 only
 	//#define _IRR_WCHAR_FILESYSTEM
 
 	#undef _IRR_COMPILE_WITH_IRR_MESH_LOADER_
+	#undef _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
 	//#undef _IRR_COMPILE_WITH_MD2_LOADER_
 	#undef _IRR_COMPILE_WITH_MD3_LOADER_
 	#undef _IRR_COMPILE_WITH_3DS_LOADER_
@@ -757,6 +802,7 @@ precision will be lower but speed higher. currently X86 only
 	#undef _IRR_COMPILE_WITH_LWO_LOADER_
 	#undef _IRR_COMPILE_WITH_STL_LOADER_
 	#undef _IRR_COMPILE_WITH_IRR_WRITER_
+	#undef _IRR_COMPILE_WITH_IRR_BINARY_WRITER_
 	#undef _IRR_COMPILE_WITH_COLLADA_WRITER_
 	#undef _IRR_COMPILE_WITH_STL_WRITER_
 	#undef _IRR_COMPILE_WITH_OBJ_WRITER_
@@ -85,6 +85,22 @@ struct S3DVertex
 				((Pos == other.Pos) && (Normal == other.Normal) && (Color == other.Color) && (TCoords < other.TCoords)));
 	}
 
+	//! Hash value for core::hash_map
+	/** Uses the exact values, so only vertices which are exactly the same
+	are guaranteed to get the same hash. */
+	u32 hash() const
+	{
+		const f32 values[8] = { Pos.X, Pos.Y, Pos.Z, Normal.X, Normal.Y, Normal.Z, TCoords.X, TCoords.Y };
+		u32 h = 2166136261u ^ Color.color;
+		for (u32 i=0; i<8; ++i)
+		{
+			// -0 and 0 are equal
+			h ^= values[i] != 0.f ? core::IR(values[i]) : 0;
+			h *= 16777619u;
+		}
+		return h;
+	}
+
 	E_VERTEX_TYPE getType() const
 	{
 		return EVT_STANDARD;
@@ -51,6 +51,15 @@ namespace video
 		//! 128 bit floating point format. 32 bits are used for the red, green, blue and alpha channels.
 		ECF_A32B32G32R32F,
 
+		/** Block compressed formats. The image data are blocks of 4x4 pixels,
+		the rows of blocks follow each other. They can't be accessed per pixel. */
+
+		//! DXT1 (BC1) compression, 8 bytes per block with two colors and an optional 1 bit alpha.
+		ECF_DXT1,
+
+		//! DXT5 (BC3) compression, 16 bytes per block with interpolated 8 bit alpha and DXT1 colors.
+		ECF_DXT5,
+
 		//! Unknown color format:
 		ECF_UNKNOWN
 	};
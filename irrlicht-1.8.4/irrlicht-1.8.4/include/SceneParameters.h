@@ -174,6 +174,19 @@ namespace scene
 	**/
 	const c8* const DEBUG_NORMAL_COLOR = "DEBUG_Normal_Color";
 
+	//! Name of the parameter for optimizing static meshes when they are loaded.
+	/** The value is a combination of E_MESH_OPTIMIZATION flags and is
+	passed to IMeshManipulator::optimizeMesh() for each static mesh loaded
+	by ISceneManager::getMesh(). The mesh cache keeps the optimized mesh,
+	so the work is only done once. Default is 0, which leaves meshes as they
+	were loaded. Use it like this:
+	\code
+	SceneManager->getParameters()->setAttribute(scene::MESH_OPTIMIZE_ON_LOAD,
+		scene::EMO_VERTEX_CACHE | scene::EMO_VERTEX_FETCH);
+	\endcode
+	**/
+	const c8* const MESH_OPTIMIZE_ON_LOAD = "MESH_OptimizeOnLoad";
+
 
 } // end namespace scene
 } // end namespace irr
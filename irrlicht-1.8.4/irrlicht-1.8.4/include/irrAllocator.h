@@ -20,6 +20,35 @@ namespace core
 #define DEBUG_CLIENTBLOCK new
 #endif
 
+#ifdef _IRR_COUNT_ALLOCATIONS_
+
+//! Returns the amount of heap allocations done by the allocators of this file
+/** Only counts when compiled with _IRR_COUNT_ALLOCATIONS_, otherwise it stays 0.
+The counter lives in the engine library, so it counts the allocations of the
+engine and of the application, on all threads including the worker threads
+of the engine. Compare the counts before and after a frame to find out if
+the frame allocated. */
+IRRLICHT_API u32 IRRCALLCONV getAllocationCount();
+
+//! Called by the allocators for each heap allocation, thread safe
+IRRLICHT_API void IRRCALLCONV countAllocation();
+
+#else
+
+//! Returns the amount of heap allocations done by the allocators of this file
+/** Only counts when compiled with _IRR_COUNT_ALLOCATIONS_, otherwise it stays 0. */
+inline u32 getAllocationCount()
+{
+	return 0;
+}
+
+//! Called by the allocators for each heap allocation
+inline void countAllocation()
+{
+}
+
+#endif
+
 //! Very simple allocator implementation, containers using it can be used across dll boundaries
 template<typename T>
 class irrAllocator
@@ -53,10 +82,18 @@ public:
 		ptr->~T();
 	}
 
+	//! The same allocator for another type, used by core::list for its nodes
+	template<typename U>
+	struct rebind
+	{
+		typedef irrAllocator<U> other;
+	};
+
 protected:
 
 	virtual void* internal_new(size_t cnt)
 	{
+		countAllocation();
 		return operator new(cnt);
 	}
 
@@ -79,6 +116,7 @@ public:
 	//! Allocate memory for an array of objects
 	T* allocate(size_t cnt)
 	{
+		countAllocation();
 		return (T*)operator new(cnt* sizeof(T));
 	}
 
@@ -99,6 +137,394 @@ public:
 	{
 		ptr->~T();
 	}
+
+	//! The same allocator for another type, used by core::list for its nodes
+	template<typename U>
+	struct rebind
+	{
+		typedef irrAllocatorFast<U> other;
+	};
+};
+
+
+//! Linear allocator which gives back all its memory at once
+/** Allocating just moves a pointer forward and deallocating does nothing.
+Instead the memory is given back by rewinding the arena to a mark taken
+before, usually with a CMemoryArenaScope. When an allocation does not fit
+into the block anymore it gets its own heap memory. Once the arena is rewound
+completely, the block is enlarged, so the next round fits into it and does
+not touch the heap at all.
+Not thread safe, and NOT able to be used across dll boundaries. */
+class CMemoryArena
+{
+public:
+
+	//! Position in the arena, see getMark() and rewind()
+	struct SMark
+	{
+		size_t Top;
+		u32 Overflows;
+	};
+
+	//! Constructor
+	/** \param blockSize Initial size of the block in bytes, allocated on first use. */
+	CMemoryArena(size_t blockSize=65536)
+		: Block(0), BlockSize(blockSize), Top(0), Peak(0),
+		Overflow(0), OverflowCount(0), OverflowSize(0)
+	{
+	}
+
+	//! Destructor
+	~CMemoryArena()
+	{
+		releaseOverflow(0);
+		operator delete(Block);
+	}
+
+	//! Allocate memory, aligned like memory of operator new
+	void* allocate(size_t size)
+	{
+		size = (size + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+
+		void* ptr;
+		if (Top + size <= BlockSize)
+		{
+			if (!Block)
+			{
+				countAllocation();
+				Block = (u8*)operator new(BlockSize);
+			}
+			ptr = Block + Top;
+			Top += size;
+		}
+		else
+		{
+			// too large for the rest of the block, use the heap until the next rewind
+			countAllocation();
+			SOverflow* chunk = (SOverflow*)operator new(ALIGNMENT + size);
+			chunk->Next = Overflow;
+			chunk->Size = size;
+			Overflow = chunk;
+			++OverflowCount;
+			OverflowSize += size;
+			ptr = (u8*)chunk + ALIGNMENT;
+		}
+
+		if (Top + OverflowSize > Peak)
+			Peak = Top + OverflowSize;
+		return ptr;
+	}
+
+	//! Returns the current position, to be passed to rewind() later
+	SMark getMark() const
+	{
+		SMark mark;
+		mark.Top = Top;
+		mark.Overflows = OverflowCount;
+		return mark;
+	}
+
+	//! Gives back all memory allocated since the mark was taken
+	void rewind(const SMark& mark)
+	{
+		releaseOverflow(mark.Overflows);
+		Top = mark.Top;
+
+		if (Top == 0 && OverflowCount == 0)
+		{
+			// make the next round fit into the block
+			if (Peak > BlockSize)
+			{
+				operator delete(Block);
+				Block = 0;
+				BlockSize = Peak + Peak / 2;
+			}
+			Peak = 0;
+		}
+	}
+
+	//! Gives back all memory
+	void reset()
+	{
+		SMark mark;
+		mark.Top = 0;
+		mark.Overflows = 0;
+		rewind(mark);
+	}
+
+	//! Returns the size of the block in bytes
+	size_t getBlockSize() const
+	{
+		return BlockSize;
+	}
+
+private:
+
+	enum { ALIGNMENT = 16 };
+
+	//! Allocation which did not fit into the block
+	struct SOverflow
+	{
+		SOverflow* Next;
+		size_t Size;
+	};
+
+	void releaseOverflow(u32 keep)
+	{
+		while (OverflowCount > keep)
+		{
+			SOverflow* next = Overflow->Next;
+			OverflowSize -= Overflow->Size;
+			operator delete(Overflow);
+			Overflow = next;
+			--OverflowCount;
+		}
+	}
+
+	// not copyable
+	CMemoryArena(const CMemoryArena&);
+	CMemoryArena& operator=(const CMemoryArena&);
+
+	u8* Block;
+	size_t BlockSize;
+	size_t Top;
+	size_t Peak;
+	SOverflow* Overflow;
+	u32 OverflowCount;
+	size_t OverflowSize;
+};
+
+
+//! Returns the arena used by irrAllocatorFrame
+/** Only to be used by the thread which draws. */
+inline CMemoryArena& getFrameArena()
+{
+	static CMemoryArena arena;
+	return arena;
+}
+
+
+//! Gives back all memory allocated from an arena while the scope exists
+/** Scopes can be nested. Declare the scope before the containers using the
+arena, so the containers are destroyed before the memory is given back. */
+class CMemoryArenaScope
+{
+public:
+
+	//! Constructor, marks the current position of the arena
+	CMemoryArenaScope(CMemoryArena& arena = getFrameArena())
+		: Arena(arena), Mark(arena.getMark())
+	{
+	}
+
+	//! Destructor, rewinds the arena to the mark
+	~CMemoryArenaScope()
+	{
+		Arena.rewind(Mark);
+	}
+
+private:
+
+	// not copyable
+	CMemoryArenaScope(const CMemoryArenaScope&);
+	CMemoryArenaScope& operator=(const CMemoryArenaScope&);
+
+	CMemoryArena& Arena;
+	CMemoryArena::SMark Mark;
+};
+
+
+//! Allocator taking its memory from the frame arena, for temporary containers
+/** Deallocating does nothing, the memory is given back when the enclosing
+CMemoryArenaScope ends, so containers using it must not live longer than
+that scope. Containers using it are NOT able to be used across dll boundaries. */
+template<typename T>
+class irrAllocatorFrame
+{
+public:
+
+	//! Allocate memory for an array of objects
+	T* allocate(size_t cnt)
+	{
+		return (T*)getFrameArena().allocate(cnt* sizeof(T));
+	}
+
+	//! Deallocate memory for an array of objects, does nothing
+	void deallocate(T* ptr)
+	{
+	}
+
+	//! Construct an element
+	void construct(T* ptr, const T&e)
+	{
+		new ((void*)ptr) T(e);
+	}
+
+	//! Destruct an element
+	void destruct(T* ptr)
+	{
+		ptr->~T();
+	}
+
+	//! The same allocator for another type, used by core::list for its nodes
+	template<typename U>
+	struct rebind
+	{
+		typedef irrAllocatorFrame<U> other;
+	};
+};
+
+
+//! Keeps freed small allocations in lists per size and hands them out again
+/** Allocations up to MAX_POOLED_SIZE bytes are pooled, larger ones go directly
+to the heap. Freed memory is never given back to the heap, so once the pool
+is warmed up, allocating and freeing memory of the same sizes does not touch
+the heap at all.
+Not thread safe, and NOT able to be used across dll boundaries. */
+class CMemoryPool
+{
+public:
+
+	enum
+	{
+		GRANULARITY = 16,
+		MAX_POOLED_SIZE = 256,
+		PAGE_SIZE = 4096
+	};
+
+	//! Constructor
+	CMemoryPool() : Pages(0)
+	{
+		for (u32 i=0; i<CLASS_COUNT; ++i)
+			FreeLists[i] = 0;
+	}
+
+	//! Allocate memory, aligned like memory of operator new
+	void* allocate(size_t size)
+	{
+		const u32 sizeClass = size ? (u32)((size + GRANULARITY - 1) / GRANULARITY) : 1;
+		if (sizeClass >= CLASS_COUNT)
+		{
+			countAllocation();
+			SBlock* block = (SBlock*)operator new(HEADER_SIZE + size);
+			block->SizeClass = 0;
+			return (u8*)block + HEADER_SIZE;
+		}
+
+		if (!FreeLists[sizeClass])
+			refill(sizeClass);
+
+		SBlock* block = FreeLists[sizeClass];
+		FreeLists[sizeClass] = block->Next;
+		return (u8*)block + HEADER_SIZE;
+	}
+
+	//! Deallocate memory from allocate()
+	void deallocate(void* ptr)
+	{
+		if (!ptr)
+			return;
+
+		SBlock* block = (SBlock*)((u8*)ptr - HEADER_SIZE);
+		if (block->SizeClass == 0)
+		{
+			operator delete(block);
+			return;
+		}
+
+		block->Next = FreeLists[block->SizeClass];
+		FreeLists[block->SizeClass] = block;
+	}
+
+private:
+
+	enum
+	{
+		CLASS_COUNT = MAX_POOLED_SIZE / GRANULARITY + 1,
+		HEADER_SIZE = 16
+	};
+
+	//! Header in front of each allocation
+	struct SBlock
+	{
+		u32 SizeClass;
+		SBlock* Next;
+	};
+
+	//! Cuts a new page into blocks of one size
+	void refill(u32 sizeClass)
+	{
+		const u32 blockSize = HEADER_SIZE + sizeClass * GRANULARITY;
+
+		countAllocation();
+		u8* page = (u8*)operator new(PAGE_SIZE);
+
+		// the first block of each page links the pages, so they stay reachable
+		*(u8**)page = Pages;
+		Pages = page;
+
+		for (u32 offset = HEADER_SIZE; offset + blockSize <= PAGE_SIZE; offset += blockSize)
+		{
+			SBlock* block = (SBlock*)(page + offset);
+			block->SizeClass = sizeClass;
+			block->Next = FreeLists[sizeClass];
+			FreeLists[sizeClass] = block;
+		}
+	}
+
+	SBlock* FreeLists[CLASS_COUNT];
+	u8* Pages;
+};
+
+
+//! Returns the pool used by irrAllocatorPool
+/** The pool is never destroyed, so containers may use it at any time. */
+inline CMemoryPool& getMemoryPool()
+{
+	static CMemoryPool* pool = new CMemoryPool();
+	return *pool;
+}
+
+
+//! Allocator taking its memory from the shared memory pool
+/** Good for containers which often allocate and free small pieces of memory,
+like the nodes of a core::list. Containers using it are NOT able to be used
+across dll boundaries. */
+template<typename T>
+class irrAllocatorPool
+{
+public:
+
+	//! Allocate memory for an array of objects
+	T* allocate(size_t cnt)
+	{
+		return (T*)getMemoryPool().allocate(cnt* sizeof(T));
+	}
+
+	//! Deallocate memory for an array of objects
+	void deallocate(T* ptr)
+	{
+		getMemoryPool().deallocate(ptr);
+	}
+
+	//! Construct an element
+	void construct(T* ptr, const T&e)
+	{
+		new ((void*)ptr) T(e);
+	}
+
+	//! Destruct an element
+	void destruct(T* ptr)
+	{
+		ptr->~T();
+	}
+
+	//! The same allocator for another type, used by core::list for its nodes
+	template<typename U>
+	struct rebind
+	{
+		typedef irrAllocatorPool<U> other;
+	};
 };
 
 
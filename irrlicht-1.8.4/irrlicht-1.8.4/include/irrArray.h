@@ -497,6 +497,46 @@ public:
 	}
 
 
+	//! Performs a binary search for a key, returns -1 if not found.
+	/** Like binary_search(), but searches for a key instead of an element,
+	so no temporary element has to be created. The array has to be sorted
+	in the order of the compare function. If it is not known to be sorted,
+	the elements are searched linearly instead.
+	\param key Key to search for.
+	\param compare Function or functor called as compare(element, key).
+	Has to return less than 0 if the element sorts before the key, 0 if it
+	matches and greater than 0 if it sorts after it.
+	\return Position of the searched element if it was found, otherwise -1
+	is returned. */
+	template <class K, class C>
+	s32 binary_search_key(const K& key, C compare) const
+	{
+		if (!is_sorted)
+		{
+			for (u32 i=0; i<used; ++i)
+				if (compare(data[i], key) == 0)
+					return (s32)i;
+			return -1;
+		}
+
+		s32 left = 0;
+		s32 right = (s32)used - 1;
+		while (left <= right)
+		{
+			const s32 m = (left+right)>>1;
+			const s32 cmp = compare(data[m], key);
+			if (cmp < 0)
+				left = m + 1;
+			else if (cmp > 0)
+				right = m - 1;
+			else
+				return m;
+		}
+
+		return -1;
+	}
+
+
 	//! Finds an element in linear time, which is very slow.
 	/** Use binary_search for faster finding. Only works if ==operator is
 	implemented.
@@ -0,0 +1,488 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __IRR_HASH_MAP_H_INCLUDED__
+#define __IRR_HASH_MAP_H_INCLUDED__
+
+#include "irrTypes.h"
+#include "irrArray.h"
+#include "irrMath.h"
+
+namespace irr
+{
+namespace core
+{
+
+//! Mixes the bits of an integer, so keys following each other are spread over the table
+inline u32 hash_integer(u32 x)
+{
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+
+//! Function object computing the hash values of a hash_map
+/** By default the hash() method of the key is used, like core::string::hash().
+Specialize it or pass another function object to hash_map for other keys. */
+template <class T>
+struct hash
+{
+	u32 operator()(const T& key) const
+	{
+		return key.hash();
+	}
+};
+
+//! Hash of signed integers
+template <>
+struct hash<s32>
+{
+	u32 operator()(s32 key) const
+	{
+		return hash_integer((u32)key);
+	}
+};
+
+//! Hash of unsigned integers
+template <>
+struct hash<u32>
+{
+	u32 operator()(u32 key) const
+	{
+		return hash_integer(key);
+	}
+};
+
+//! Hash of wide characters
+template <>
+struct hash<wchar_t>
+{
+	u32 operator()(wchar_t key) const
+	{
+		return hash_integer((u32)key);
+	}
+};
+
+//! Hash of pointers
+template <class T>
+struct hash<T*>
+{
+	u32 operator()(T* key) const
+	{
+		const u64 value = (u64)(size_t)key;
+		return hash_integer((u32)value ^ (u32)(value >> 32));
+	}
+};
+
+
+//! Associative array using a hash table with open addressing
+/** Faster than core::map when the order of the keys does not matter. The
+elements are stored in one array in the order of insertion, the table only
+refers to them, so there is no allocation per element. Collisions are
+resolved with robin hood probing, which keeps the probe sequences short even
+in full tables.
+Keys need an operator== and a hash function object, see core::hash.
+Inserting may move the elements, so pointers to nodes from find() are only
+valid until the next insertion or removal. */
+template <class KeyType, class ValueType, class THash = hash<KeyType> >
+class hash_map
+{
+public:
+
+	//! An element of the map
+	class Node
+	{
+	public:
+
+		Node(const KeyType& k, const ValueType& v, u32 h)
+			: Key(k), Value(v), Hash(h) {}
+
+		const KeyType& getKey() const
+		{
+			return Key;
+		}
+
+		ValueType& getValue()
+		{
+			return Value;
+		}
+
+		const ValueType& getValue() const
+		{
+			return Value;
+		}
+
+		void setValue(const ValueType& v)
+		{
+			Value = v;
+		}
+
+	private:
+
+		friend class hash_map<KeyType, ValueType, THash>;
+
+		KeyType Key;
+		ValueType Value;
+		u32 Hash;
+	};
+
+
+	//! Iterator over all elements, in insertion order as long as none was removed
+	class Iterator
+	{
+	public:
+
+		Iterator() : Map(0), Index(0) {}
+
+		explicit Iterator(hash_map<KeyType, ValueType, THash>* map)
+			: Map(map), Index(0) {}
+
+		void reset()
+		{
+			Index = 0;
+		}
+
+		bool atEnd() const
+		{
+			return !Map || Index >= Map->Nodes.size();
+		}
+
+		Node* getNode() const
+		{
+			return &Map->Nodes[Index];
+		}
+
+		Iterator& operator++()
+		{
+			++Index;
+			return *this;
+		}
+
+		void operator++(int)
+		{
+			++Index;
+		}
+
+		Node* operator->()
+		{
+			return getNode();
+		}
+
+		Node& operator*()
+		{
+			_IRR_DEBUG_BREAK_IF(atEnd()) // access violation
+
+			return *getNode();
+		}
+
+	private:
+
+		hash_map<KeyType, ValueType, THash>* Map;
+		u32 Index;
+	};
+
+
+	//! Const iterator over all elements, in insertion order as long as none was removed
+	class ConstIterator
+	{
+	public:
+
+		ConstIterator() : Map(0), Index(0) {}
+
+		explicit ConstIterator(const hash_map<KeyType, ValueType, THash>* map)
+			: Map(map), Index(0) {}
+
+		void reset()
+		{
+			Index = 0;
+		}
+
+		bool atEnd() const
+		{
+			return !Map || Index >= Map->Nodes.size();
+		}
+
+		const Node* getNode() const
+		{
+			return &Map->Nodes[Index];
+		}
+
+		ConstIterator& operator++()
+		{
+			++Index;
+			return *this;
+		}
+
+		void operator++(int)
+		{
+			++Index;
+		}
+
+		const Node* operator->()
+		{
+			return getNode();
+		}
+
+		const Node& operator*()
+		{
+			_IRR_DEBUG_BREAK_IF(atEnd()) // access violation
+
+			return *getNode();
+		}
+
+	private:
+
+		const hash_map<KeyType, ValueType, THash>* Map;
+		u32 Index;
+	};
+
+
+	//! Default constructor, allocates nothing until the first insertion
+	hash_map() : Mask(0) {}
+
+	//! Makes room for count elements, so inserting them does not reallocate
+	void reserve(u32 count)
+	{
+		Nodes.reallocate(core::max_(count, Nodes.size()));
+
+		u32 slots = 8;
+		while (slots - slots / 8 < count)
+			slots *= 2;
+		if (slots > Slots.size())
+			rehash(slots);
+	}
+
+	//! Inserts a new element into the map.
+	/** \param keyNew The key of the new element.
+	\param v The value of the new element.
+	\return True if successful, false if the key already exists. */
+	bool insert(const KeyType& keyNew, const ValueType& v)
+	{
+		const u32 h = hashKey(keyNew);
+		if (findSlot(keyNew, h) >= 0)
+			return false;
+
+		if (Nodes.size() + 1 > Slots.size() - Slots.size() / 8)
+			rehash(Slots.size() ? Slots.size() * 2 : 8);
+
+		Nodes.push_back(Node(keyNew, v, h));
+		insertSlot(h, Nodes.size() - 1);
+		return true;
+	}
+
+	//! Replaces the value of an element, or inserts it if it does not exist yet.
+	/** \param k The key of the element.
+	\param v The new value. */
+	void set(const KeyType& k, const ValueType& v)
+	{
+		Node* p = find(k);
+		if (p)
+			p->setValue(v);
+		else
+			insert(k, v);
+	}
+
+	//! Removes an element from the map.
+	/** The last element is moved into its place.
+	\param k The key of the element.
+	\return True if the element was found and removed. */
+	bool remove(const KeyType& k)
+	{
+		const s32 slot = findSlot(k, hashKey(k));
+		if (slot < 0)
+			return false;
+
+		const u32 index = Slots[slot].Index;
+
+		// shift the following elements of the probe sequence back
+		u32 pos = (u32)slot;
+		for (;;)
+		{
+			const u32 next = (pos + 1) & Mask;
+			if (!Slots[next].Hash || probeDistance(Slots[next].Hash, next) == 0)
+				break;
+			Slots[pos] = Slots[next];
+			pos = next;
+		}
+		Slots[pos].Hash = 0;
+
+		// move the last element into the gap
+		const u32 last = Nodes.size() - 1;
+		if (index != last)
+		{
+			Nodes[index] = Nodes[last];
+
+			pos = Nodes[index].Hash & Mask;
+			while (!Slots[pos].Hash || Slots[pos].Index != last)
+				pos = (pos + 1) & Mask;
+			Slots[pos].Index = index;
+		}
+		Nodes.erase(last);
+
+		return true;
+	}
+
+	//! Removes all elements, the memory is kept.
+	void clear()
+	{
+		if (!Nodes.empty())
+			Nodes.erase(0, Nodes.size());
+		for (u32 i=0; i<Slots.size(); ++i)
+			Slots[i].Hash = 0;
+	}
+
+	//! Is the map empty?
+	bool empty() const
+	{
+		return Nodes.empty();
+	}
+
+	//! Returns the amount of elements.
+	u32 size() const
+	{
+		return Nodes.size();
+	}
+
+	//! Finds an element.
+	/** \param keyToFind The key to find.
+	\return Pointer to the element, or 0 if not found. */
+	Node* find(const KeyType& keyToFind) const
+	{
+		const s32 slot = findSlot(keyToFind, hashKey(keyToFind));
+		return slot >= 0 ? const_cast<Node*>(&Nodes[Slots[slot].Index]) : 0;
+	}
+
+	//! Returns the value of an element, inserts a default value first if it does not exist.
+	ValueType& operator[](const KeyType& k)
+	{
+		Node* p = find(k);
+		if (!p)
+		{
+			insert(k, ValueType());
+			p = &Nodes.getLast();
+		}
+		return p->getValue();
+	}
+
+	//! Returns an iterator over all elements.
+	Iterator getIterator()
+	{
+		return Iterator(this);
+	}
+
+	//! Returns a const iterator over all elements.
+	ConstIterator getConstIterator() const
+	{
+		return ConstIterator(this);
+	}
+
+	//! Swaps the content of this map with another one.
+	void swap(hash_map<KeyType, ValueType, THash>& other)
+	{
+		Nodes.swap(other.Nodes);
+		Slots.swap(other.Slots);
+		core::swap(Mask, other.Mask);
+		core::swap(Hasher, other.Hasher);
+	}
+
+private:
+
+	friend class Iterator;
+	friend class ConstIterator;
+
+	//! Entry of the table, refers to an element. A hash of 0 marks an empty entry.
+	struct SSlot
+	{
+		u32 Hash;
+		u32 Index;
+	};
+
+	u32 hashKey(const KeyType& k) const
+	{
+		const u32 h = Hasher(k);
+		return h ? h : 1;
+	}
+
+	//! How far an entry is away from the slot its hash belongs to
+	u32 probeDistance(u32 h, u32 pos) const
+	{
+		return (pos - (h & Mask)) & Mask;
+	}
+
+	s32 findSlot(const KeyType& k, u32 h) const
+	{
+		if (Nodes.empty())
+			return -1;
+
+		u32 pos = h & Mask;
+		for (u32 dist = 0; ; ++dist)
+		{
+			const SSlot& slot = Slots[pos];
+
+			// the key would have displaced an entry closer to its own slot
+			if (!slot.Hash || probeDistance(slot.Hash, pos) < dist)
+				return -1;
+
+			if (slot.Hash == h && Nodes[slot.Index].Key == k)
+				return (s32)pos;
+
+			pos = (pos + 1) & Mask;
+		}
+	}
+
+	//! Robin hood insertion: take the slot of entries which are closer to their own slot
+	void insertSlot(u32 h, u32 index)
+	{
+		u32 pos = h & Mask;
+		u32 dist = 0;
+		for (;;)
+		{
+			SSlot& slot = Slots[pos];
+			if (!slot.Hash)
+			{
+				slot.Hash = h;
+				slot.Index = index;
+				return;
+			}
+
+			const u32 existing = probeDistance(slot.Hash, pos);
+			if (existing < dist)
+			{
+				core::swap(h, slot.Hash);
+				core::swap(index, slot.Index);
+				dist = existing;
+			}
+
+			pos = (pos + 1) & Mask;
+			++dist;
+		}
+	}
+
+	void rehash(u32 slotCount)
+	{
+		Slots.set_used(slotCount);
+		for (u32 i=0; i<slotCount; ++i)
+			Slots[i].Hash = 0;
+		Mask = slotCount - 1;
+
+		for (u32 i=0; i<Nodes.size(); ++i)
+			insertSlot(Nodes[i].Hash, i);
+	}
+
+	array<Node> Nodes;
+	array<SSlot> Slots;
+	u32 Mask;
+	THash Hasher;
+};
+
+
+} // end namespace core
+} // end namespace irr
+
+#endif
+
@@ -16,7 +16,8 @@ namespace core
 
 
 //! Doubly linked list template.
-template <class T>
+/** The allocator is rebound to the type of the list nodes. */
+template <class T, typename TAlloc = irrAllocator<T> >
 class list
 {
 private:
@@ -79,7 +80,7 @@ public:
 
 		SKListNode* Current;
 
-		friend class list<T>;
+		friend class list<T, TAlloc>;
 		friend class ConstIterator;
 	};
 
@@ -129,7 +130,7 @@ public:
 		SKListNode* Current;
 
 		friend class Iterator;
-		friend class list<T>;
+		friend class list<T, TAlloc>;
 	};
 
 	//! Default constructor for empty list.
@@ -138,7 +139,7 @@ public:
 
 
 	//! Copy constructor.
-	list(const list<T>& other) : First(0), Last(0), Size(0)
+	list(const list<T, TAlloc>& other) : First(0), Last(0), Size(0)
 	{
 		*this = other;
 	}
@@ -152,7 +153,7 @@ public:
 
 
 	//! Assignment operator
-	void operator=(const list<T>& other)
+	void operator=(const list<T, TAlloc>& other)
 	{
 		if(&other == this)
 		{
@@ -390,7 +391,7 @@ public:
 	object will contain the content of this object. Iterators will afterwards be valid for
 	the swapped object.
 	\param other Swap content with this object	*/
-	void swap(list<T>& other)
+	void swap(list<T, TAlloc>& other)
 	{
 		core::swap(First, other.First);
 		core::swap(Last, other.Last);
@@ -404,7 +405,7 @@ private:
 	SKListNode* First;
 	SKListNode* Last;
 	u32 Size;
-	irrAllocator<SKListNode> allocator;
+	typename TAlloc::template rebind<SKListNode>::other allocator;
 
 };
 
@@ -0,0 +1,110 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __IRR_SIMD_H_INCLUDED__
+#define __IRR_SIMD_H_INCLUDED__
+
+#include "irrTypes.h"
+
+#if defined(_IRR_COMPILE_WITH_SSE_)
+#include <xmmintrin.h>
+#elif defined(_IRR_COMPILE_WITH_NEON_)
+#include <arm_neon.h>
+#endif
+
+namespace irr
+{
+namespace core
+{
+
+#if defined(_IRR_COMPILE_WITH_SIMD_)
+
+// Thin wrappers over the instructions the matrix code needs, so it is written
+// once for SSE and NEON. Multiply and add stay separate instructions, so the
+// results are the same as those of the C++ code doing the same operations.
+
+#if defined(_IRR_COMPILE_WITH_SSE_)
+
+//! Four floats in a register
+typedef __m128 simd4f;
+
+//! Loads four floats, no alignment needed
+inline simd4f simd_load(const f32* p) { return _mm_loadu_ps(p); }
+
+//! Stores four floats, no alignment needed
+inline void simd_store(f32* p, simd4f v) { _mm_storeu_ps(p, v); }
+
+//! Stores the first three floats
+inline void simd_store3(f32* p, simd4f v)
+{
+	_mm_storel_pi((__m64*)p, v);
+	_mm_store_ss(p+2, _mm_movehl_ps(v, v));
+}
+
+//! All four floats set to f
+inline simd4f simd_splat(f32 f) { return _mm_set1_ps(f); }
+
+inline simd4f simd_add(simd4f a, simd4f b) { return _mm_add_ps(a, b); }
+inline simd4f simd_sub(simd4f a, simd4f b) { return _mm_sub_ps(a, b); }
+inline simd4f simd_mul(simd4f a, simd4f b) { return _mm_mul_ps(a, b); }
+inline simd4f simd_min(simd4f a, simd4f b) { return _mm_min_ps(a, b); }
+inline simd4f simd_max(simd4f a, simd4f b) { return _mm_max_ps(a, b); }
+
+//! Turns x, y and z components of four vectors into one register per vector, the fourth float is undefined
+inline void simd_transpose3x4(simd4f x, simd4f y, simd4f z,
+	simd4f& v0, simd4f& v1, simd4f& v2, simd4f& v3)
+{
+	const __m128 xy01 = _mm_unpacklo_ps(x, y);	// x0 y0 x1 y1
+	const __m128 xy23 = _mm_unpackhi_ps(x, y);	// x2 y2 x3 y3
+	const __m128 zz01 = _mm_unpacklo_ps(z, z);	// z0 z0 z1 z1
+	const __m128 zz23 = _mm_unpackhi_ps(z, z);	// z2 z2 z3 z3
+
+	v0 = _mm_movelh_ps(xy01, zz01);
+	v1 = _mm_movehl_ps(zz01, xy01);
+	v2 = _mm_movelh_ps(xy23, zz23);
+	v3 = _mm_movehl_ps(zz23, xy23);
+}
+
+#else // NEON
+
+typedef float32x4_t simd4f;
+
+inline simd4f simd_load(const f32* p) { return vld1q_f32(p); }
+inline void simd_store(f32* p, simd4f v) { vst1q_f32(p, v); }
+
+inline void simd_store3(f32* p, simd4f v)
+{
+	vst1_f32(p, vget_low_f32(v));
+	vst1q_lane_f32(p+2, v, 2);
+}
+
+inline simd4f simd_splat(f32 f) { return vdupq_n_f32(f); }
+
+inline simd4f simd_add(simd4f a, simd4f b) { return vaddq_f32(a, b); }
+inline simd4f simd_sub(simd4f a, simd4f b) { return vsubq_f32(a, b); }
+inline simd4f simd_mul(simd4f a, simd4f b) { return vmulq_f32(a, b); }
+inline simd4f simd_min(simd4f a, simd4f b) { return vminq_f32(a, b); }
+inline simd4f simd_max(simd4f a, simd4f b) { return vmaxq_f32(a, b); }
+
+inline void simd_transpose3x4(simd4f x, simd4f y, simd4f z,
+	simd4f& v0, simd4f& v1, simd4f& v2, simd4f& v3)
+{
+	const float32x4x2_t xy = vzipq_f32(x, y);
+	const float32x4x2_t zz = vzipq_f32(z, z);
+
+	v0 = vcombine_f32(vget_low_f32(xy.val[0]), vget_low_f32(zz.val[0]));
+	v1 = vcombine_f32(vget_high_f32(xy.val[0]), vget_high_f32(zz.val[0]));
+	v2 = vcombine_f32(vget_low_f32(xy.val[1]), vget_low_f32(zz.val[1]));
+	v3 = vcombine_f32(vget_high_f32(xy.val[1]), vget_high_f32(zz.val[1]));
+}
+
+#endif
+
+#endif // _IRR_COMPILE_WITH_SIMD_
+
+} // end namespace core
+} // end namespace irr
+
+#endif
+
@@ -78,16 +78,15 @@ public:
 
 	//! Default constructor
 	string()
-	: array(0), allocated(1), used(1)
+	: array(local), allocated(LOCAL_SIZE), used(1), hashCache(0)
 	{
-		array = allocator.allocate(1); // new T[1];
 		array[0] = 0;
 	}
 
 
 	//! Constructor
 	string(const string<T,TAlloc>& other)
-	: array(0), allocated(0), used(0)
+	: array(local), allocated(LOCAL_SIZE), used(0), hashCache(0)
 	{
 		*this = other;
 	}
@@ -95,7 +94,7 @@ public:
 	//! Constructor from other string types
 	template <class B, class A>
 	string(const string<B, A>& other)
-	: array(0), allocated(0), used(0)
+	: array(local), allocated(LOCAL_SIZE), used(0), hashCache(0)
 	{
 		*this = other;
 	}
@@ -103,7 +102,7 @@ public:
 
 	//! Constructs a string from a float
 	explicit string(const double number)
-	: array(0), allocated(0), used(0)
+	: array(local), allocated(LOCAL_SIZE), used(0), hashCache(0)
 	{
 		c8 tmpbuf[255];
 		snprintf(tmpbuf, 255, "%0.6f", number);
@@ -113,7 +112,7 @@ public:
 
 	//! Constructs a string from an int
 	explicit string(int number)
-	: array(0), allocated(0), used(0)
+	: array(local), allocated(LOCAL_SIZE), used(0), hashCache(0)
 	{
 		// store if negative and make positive
 
@@ -161,7 +160,7 @@ public:
 
 	//! Constructs a string from an unsigned int
 	explicit string(unsigned int number)
-	: array(0), allocated(0), used(0)
+	: array(local), allocated(LOCAL_SIZE), used(0), hashCache(0)
 	{
 		// temporary buffer for 16 numbers
 
@@ -192,7 +191,7 @@ public:
 
 	//! Constructs a string from a long
 	explicit string(long number)
-	: array(0), allocated(0), used(0)
+	: array(local), allocated(LOCAL_SIZE), used(0), hashCache(0)
 	{
 		// store if negative and make positive
 
@@ -240,7 +239,7 @@ public:
 
 	//! Constructs a string from an unsigned long
 	explicit string(unsigned long number)
-	: array(0), allocated(0), used(0)
+	: array(local), allocated(LOCAL_SIZE), used(0), hashCache(0)
 	{
 		// temporary buffer for 16 numbers
 
@@ -272,7 +271,7 @@ public:
 	//! Constructor for copying a string from a pointer with a given length
 	template <class B>
 	string(const B* const c, u32 length)
-	: array(0), allocated(0), used(0)
+	: array(local), allocated(LOCAL_SIZE), used(0), hashCache(0)
 	{
 		if (!c)
 		{
@@ -281,8 +280,12 @@ public:
 			return;
 		}
 
-		allocated = used = length+1;
-		array = allocator.allocate(used); // new T[used];
+		used = length+1;
+		if (used>allocated)
+		{
+			allocated = used;
+			array = allocator.allocate(used); // new T[used];
+		}
 
 		for (u32 l = 0; l<length; ++l)
 			array[l] = (T)c[l];
@@ -294,7 +297,7 @@ public:
 	//! Constructor for unicode and ascii strings
 	template <class B>
 	string(const B* const c)
-	: array(0), allocated(0), used(0)
+	: array(local), allocated(LOCAL_SIZE), used(0), hashCache(0)
 	{
 		*this = c;
 	}
@@ -303,7 +306,8 @@ public:
 	//! Destructor
 	~string()
 	{
-		allocator.deallocate(array); // delete [] array;
+		if (array != local)
+			allocator.deallocate(array); // delete [] array;
 	}
 
 
@@ -316,7 +320,8 @@ public:
 		used = other.size()+1;
 		if (used>allocated)
 		{
-			allocator.deallocate(array); // delete [] array;
+			if (array != local)
+				allocator.deallocate(array); // delete [] array;
 			allocated = used;
 			array = allocator.allocate(used); //new T[used];
 		}
@@ -325,6 +330,7 @@ public:
 		for (u32 i=0; i<used; ++i, ++p)
 			array[i] = *p;
 
+		hashCache = other.hashCache;
 		return *this;
 	}
 
@@ -343,19 +349,17 @@ public:
 	{
 		if (!c)
 		{
-			if (!array)
-			{
-				array = allocator.allocate(1); //new T[1];
-				allocated = 1;
-			}
 			used = 1;
 			array[0] = 0x0;
+			hashCache = 0;
 			return *this;
 		}
 
 		if ((void*)c == (void*)array)
 			return *this;
 
+		hashCache = 0;
+
 		u32 len = 0;
 		const B* p = c;
 		do
@@ -377,7 +381,7 @@ public:
 		for (u32 l = 0; l<len; ++l)
 			array[l] = (T)c[l];
 
-		if (oldArray != array)
+		if (oldArray != array && oldArray != local)
 			allocator.deallocate(oldArray); // delete [] oldArray;
 
 		return *this;
@@ -409,6 +413,7 @@ public:
 	T& operator [](const u32 index)
 	{
 		_IRR_DEBUG_BREAK_IF(index>=used) // bad index
+		hashCache = 0; // the character may be changed
 		return array[index];
 	}
 
@@ -437,13 +442,19 @@ public:
 
 
 	//! Equality operator
+	/** Compares all characters, also those behind embedded NUL
+	characters, just like hash() does. The cached hash values are not
+	used, they may be outdated, see hash(). */
 	bool operator==(const string<T,TAlloc>& other) const
 	{
-		for (u32 i=0; array[i] && other.array[i]; ++i)
+		if (used != other.used)
+			return false;
+
+		for (u32 i=0; i<used; ++i)
 			if (array[i] != other.array[i])
 				return false;
 
-		return used == other.used;
+		return true;
 	}
 
 
@@ -501,6 +512,7 @@ public:
 	//! Makes the string lower case.
 	string<T,TAlloc>& make_lower()
 	{
+		hashCache = 0;
 		for (u32 i=0; array[i]; ++i)
 			array[i] = locale_lower ( array[i] );
 		return *this;
@@ -510,6 +522,7 @@ public:
 	//! Makes the string upper case.
 	string<T,TAlloc>& make_upper()
 	{
+		hashCache = 0;
 		for (u32 i=0; array[i]; ++i)
 			array[i] = locale_upper ( array[i] );
 		return *this;
@@ -602,6 +615,7 @@ public:
 	/** \param character: Character to append. */
 	string<T,TAlloc>& append(T character)
 	{
+		hashCache = 0;
 		if (used + 1 > allocated)
 			reallocate(used + 1);
 
@@ -632,6 +646,7 @@ public:
 		if (len > length)
 			len = length;
 
+		hashCache = 0;
 		if (used + len > allocated)
 			reallocate(used + len);
 
@@ -654,6 +669,7 @@ public:
 		if (other.size() == 0)
 			return *this;
 
+		hashCache = 0;
 		--used;
 		u32 len = other.size()+1;
 
@@ -683,6 +699,7 @@ public:
 			return *this;
 		}
 
+		hashCache = 0;
 		if (used + length > allocated)
 			reallocate(used + length);
 
@@ -1006,6 +1023,7 @@ public:
 	\param replaceWith Character replacing the old one. */
 	string<T,TAlloc>& replace(T toReplace, T replaceWith)
 	{
+		hashCache = 0;
 		for (u32 i=0; i<used-1; ++i)
 			if (array[i] == toReplace)
 				array[i] = replaceWith;
@@ -1018,6 +1036,7 @@ public:
 	\param replaceWith The string replacing the old one. */
 	string<T,TAlloc>& replace(const string<T,TAlloc>& toReplace, const string<T,TAlloc>& replaceWith)
 	{
+		hashCache = 0;
 		if (toReplace.size() == 0)
 			return *this;
 
@@ -1126,6 +1145,7 @@ public:
 	/** \param c: Character to remove. */
 	string<T,TAlloc>& remove(T c)
 	{
+		hashCache = 0;
 		u32 pos = 0;
 		u32 found = 0;
 		for (u32 i=0; i<used-1; ++i)
@@ -1148,6 +1168,7 @@ public:
 	/** \param toRemove: String to remove. */
 	string<T,TAlloc>& remove(const string<T,TAlloc>& toRemove)
 	{
+		hashCache = 0;
 		u32 size = toRemove.size();
 		if ( size == 0 )
 			return *this;
@@ -1181,6 +1202,7 @@ public:
 	/** \param characters: Characters to remove. */
 	string<T,TAlloc>& removeChars(const string<T,TAlloc> & characters)
 	{
+		hashCache = 0;
 		if (characters.size() == 0)
 			return *this;
 
@@ -1236,6 +1258,7 @@ public:
 	{
 		_IRR_DEBUG_BREAK_IF(index>=used) // access violation
 
+		hashCache = 0;
 		for (u32 i=index+1; i<used; ++i)
 			array[i-1] = array[i];
 
@@ -1246,6 +1269,8 @@ public:
 	//! verify the existing string.
 	string<T,TAlloc>& validate()
 	{
+		hashCache = 0;
+
 		// terminate on existing null
 		for (u32 i=0; i<allocated; ++i)
 		{
@@ -1276,6 +1301,72 @@ public:
 		return used > 1 ? array[used-2] : 0;
 	}
 
+	//! Returns a hash value of the characters
+	/** The value is computed once and kept until a method changing the
+	string is called. Changing characters through a reference returned by
+	the non-const operator[] earlier does not reset it, so don't keep such
+	references after calling hash(), for example on a hash_map key.
+	Not thread safe: the first call writes the cached value, even though
+	the method is const. Call it once before sharing a string with other
+	threads for reading, or don't call it on strings used by several
+	threads at the same time. */
+	u32 hash() const
+	{
+		if (!hashCache)
+		{
+			u32 h = 2166136261u;
+			for (u32 i=0; i+1<used; ++i)
+			{
+				h ^= (u32)array[i];
+				h *= 16777619u;
+			}
+			hashCache = h ? h : 1;
+		}
+		return hashCache;
+	}
+
+	//! Exchanges the contents of two strings
+	/** Hands over allocated memory instead of copying it, so this is the
+	cheap way to move a string into another one.
+	\param other String to swap with. */
+	void swap(string<T,TAlloc>& other)
+	{
+		if (this == &other)
+			return;
+
+		// characters stored inside the objects have to be copied
+		T tmp[LOCAL_SIZE];
+		T* const oldArray = array;
+		if (array == local)
+		{
+			for (u32 i=0; i<used; ++i)
+				tmp[i] = local[i];
+		}
+
+		if (other.array == other.local)
+		{
+			for (u32 i=0; i<other.used; ++i)
+				local[i] = other.local[i];
+			array = local;
+		}
+		else
+			array = other.array;
+
+		if (oldArray == local)
+		{
+			for (u32 i=0; i<used; ++i)
+				other.local[i] = tmp[i];
+			other.array = other.local;
+		}
+		else
+			other.array = oldArray;
+
+		core::swap(allocated, other.allocated);
+		core::swap(used, other.used);
+		core::swap(hashCache, other.hashCache);
+		core::swap(allocator, other.allocator);	// memory is still released by the same allocator used for allocation
+	}
+
 	//! split string into parts.
 	/** This method will split a string at certain delimiter characters
 	into the container passed in as reference. The type of the container
@@ -1327,22 +1418,36 @@ public:
 
 private:
 
+	//! Characters stored inside the string object, so short strings need no allocation
+	enum { LOCAL_SIZE = sizeof(T) < 32 ? 32 / sizeof(T) : 1 };
+
 	//! Reallocate the array, make it bigger or smaller
 	void reallocate(u32 new_size)
 	{
 		T* old_array = array;
 
-		array = allocator.allocate(new_size); //new T[new_size];
-		allocated = new_size;
+		if (new_size <= (u32)LOCAL_SIZE)
+		{
+			if (array == local)
+				return;
+			array = local;
+			allocated = LOCAL_SIZE;
+		}
+		else
+		{
+			array = allocator.allocate(new_size); //new T[new_size];
+			allocated = new_size;
+		}
 
-		u32 amount = used < new_size ? used : new_size;
+		u32 amount = used < allocated ? used : allocated;
 		for (u32 i=0; i<amount; ++i)
 			array[i] = old_array[i];
 
 		if (allocated < used)
 			used = allocated;
 
-		allocator.deallocate(old_array); // delete [] old_array;
+		if (old_array != local)
+			allocator.deallocate(old_array); // delete [] old_array;
 	}
 
 	//--- member variables
@@ -1350,7 +1455,9 @@ private:
 	T* array;
 	u32 allocated;
 	u32 used;
+	mutable u32 hashCache;
 	TAlloc allocator;
+	T local[LOCAL_SIZE];
 };
 
 
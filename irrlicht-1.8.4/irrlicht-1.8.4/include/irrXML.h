@@ -238,6 +238,16 @@ namespace io
 	{
 	};
 
+	//! Returns the hash of an attribute name, as used by IIrrXMLReader::getAttributeIndex().
+	template<class char_type>
+	inline unsigned int getXMLNameHash(const char_type* name)
+	{
+		unsigned int h = 2166136261u;
+		for (; *name; ++name)
+			h = (h ^ (unsigned int)*name) * 16777619u;
+		return h ? h : 1;
+	}
+
 	//! Interface providing easy read access to a XML file.
 	/** You can create an instance of this reader using one of the factory functions
 	createIrrXMLReader(), createIrrXMLReaderUTF16() and createIrrXMLReaderUTF32().
@@ -307,6 +317,20 @@ namespace io
 		\return Value of the attribute, 0 if an attribute with this name does not exist. */
 		virtual const char_type* getAttributeValue(const char_type* name) const = 0;
 
+		//! Returns the index of an attribute.
+		/** Faster than looking up the value by name when the hash of the
+		name is computed once, for example in a static variable, because
+		only attributes with the same hash are compared.
+		\param name: Name of the attribute.
+		\param nameHash: Hash of the name, as returned by getXMLNameHash().
+		\return Index of the attribute, -1 if an attribute with this name does not exist. */
+		virtual int getAttributeIndex(const char_type* name, unsigned int nameHash) const = 0;
+
+		//! Returns the length of the value of an attribute.
+		/** \param idx: Zero based index, should be something between 0 and getAttributeCount()-1.
+		\return Amount of characters of the value, without the terminating 0. */
+		virtual unsigned int getAttributeValueLength(int idx) const = 0;
+
 		//! Returns the value of an attribute in a safe way.
 		/** Like getAttributeValue(), but does not
 		return 0 if the attribute does not exist. An empty string ("") is returned then.
@@ -87,6 +87,7 @@
 #include "IGUIInOutFader.h"
 #include "IGUIListBox.h"
 #include "IGUIMeshViewer.h"
+#include "IGUIRowSource.h"
 #include "IGUIScrollBar.h"
 #include "IGUISkin.h"
 #include "IGUISpinBox.h"
@@ -111,6 +112,8 @@
 #include "IMeshLoader.h"
 #include "IMeshManipulator.h"
 #include "IMeshSceneNode.h"
+#include "ILODMeshSceneNode.h"
+#include "IInstancedMeshSceneNode.h"
 #include "IMeshWriter.h"
 #include "IColladaMeshWriter.h"
 #include "IMetaTriangleSelector.h"
@@ -121,6 +124,7 @@
 #include "IReadFile.h"
 #include "IReferenceCounted.h"
 #include "irrArray.h"
+#include "irrHashMap.h"
 #include "IRandomizer.h"
 #include "IrrlichtDevice.h"
 #include "irrList.h"
@@ -147,6 +151,7 @@
 #include "ITerrainSceneNode.h"
 #include "ITextSceneNode.h"
 #include "ITexture.h"
+#include "ITextureAtlas.h"
 #include "ITimer.h"
 #include "ITriangleSelector.h"
 #include "IVertexBuffer.h"
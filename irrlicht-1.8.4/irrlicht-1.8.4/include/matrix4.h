@@ -11,7 +11,9 @@
 #include "plane3d.h"
 #include "aabbox3d.h"
 #include "rect.h"
+#include "triangle3d.h"
 #include "irrString.h"
+#include "irrSIMD.h"
 
 // enable this to keep track of changes to the matrix
 // and make simpler identity check for seldomly changing matrices
@@ -244,6 +246,32 @@ namespace core
 			is slower than transformBox(). */
 			void transformBoxEx(core::aabbox3d<f32>& box) const;
 
+			//! Transforms an array of vectors by this matrix
+			/** Faster than calling transformVect() for each of them. The
+			strides allow to transform vectors which are members of larger
+			structures, like the positions of vertices. out may be the same
+			as in.
+			\param out First vector receiving a result.
+			\param in First vector to transform.
+			\param count Amount of vectors.
+			\param outStride Distance in bytes between the output vectors.
+			\param inStride Distance in bytes between the input vectors. */
+			void transformVects(vector3df* out, const vector3df* in, u32 count,
+				u32 outStride=sizeof(vector3df), u32 inStride=sizeof(vector3df)) const;
+
+			//! Rotates an array of vectors by the rotation part of this matrix
+			/** Like transformVects(), but without translation, for normals
+			and directions. */
+			void rotateVects(vector3df* out, const vector3df* in, u32 count,
+				u32 outStride=sizeof(vector3df), u32 inStride=sizeof(vector3df)) const;
+
+			//! Transforms an array of triangles by this matrix
+			/** out may be the same as in. */
+			void transformTriangles(triangle3df* out, const triangle3df* in, u32 count) const;
+
+			//! Transforms an array of axis aligned bounding boxes like transformBoxEx()
+			void transformBoxesEx(core::aabbox3d<f32>* boxes, u32 count) const;
+
 			//! Multiplies this matrix by a 1x4 matrix
 			void multiplyWith1x4Matrix(T* matrix) const;
 
@@ -680,6 +708,33 @@ namespace core
 		return *this;
 	}
 
+#if defined(_IRR_COMPILE_WITH_SIMD_)
+	//! SIMD version, gives the same results as the C++ code
+	template <>
+	inline CMatrix4<f32>& CMatrix4<f32>::setbyproduct_nocheck(const CMatrix4<f32>& other_a,const CMatrix4<f32>& other_b )
+	{
+		const simd4f a0 = simd_load(other_a.M);
+		const simd4f a1 = simd_load(other_a.M+4);
+		const simd4f a2 = simd_load(other_a.M+8);
+		const simd4f a3 = simd_load(other_a.M+12);
+		const f32 *m2 = other_b.M;
+
+		// each row of the result only depends on the same row of other_b
+		for (u32 i=0; i<16; i+=4)
+		{
+			simd4f r = simd_mul(a0, simd_splat(m2[i]));
+			r = simd_add(r, simd_mul(a1, simd_splat(m2[i+1])));
+			r = simd_add(r, simd_mul(a2, simd_splat(m2[i+2])));
+			r = simd_add(r, simd_mul(a3, simd_splat(m2[i+3])));
+			simd_store(M+i, r);
+		}
+#if defined ( USE_MATRIX_TEST )
+		definitelyIdentityMatrix=false;
+#endif
+		return *this;
+	}
+#endif
+
 
 	//! multiply by another matrix
 	// set this matrix to the product of two other matrices
@@ -713,28 +768,7 @@ namespace core
 #endif
 
 		CMatrix4<T> m3 ( EM4CONST_NOTHING );
-
-		const T *m1 = M;
-
-		m3[0] = m1[0]*m2[0] + m1[4]*m2[1] + m1[8]*m2[2] + m1[12]*m2[3];
-		m3[1] = m1[1]*m2[0] + m1[5]*m2[1] + m1[9]*m2[2] + m1[13]*m2[3];
-		m3[2] = m1[2]*m2[0] + m1[6]*m2[1] + m1[10]*m2[2] + m1[14]*m2[3];
-		m3[3] = m1[3]*m2[0] + m1[7]*m2[1] + m1[11]*m2[2] + m1[15]*m2[3];
-
-		m3[4] = m1[0]*m2[4] + m1[4]*m2[5] + m1[8]*m2[6] + m1[12]*m2[7];
-		m3[5] = m1[1]*m2[4] + m1[5]*m2[5] + m1[9]*m2[6] + m1[13]*m2[7];
-		m3[6] = m1[2]*m2[4] + m1[6]*m2[5] + m1[10]*m2[6] + m1[14]*m2[7];
-		m3[7] = m1[3]*m2[4] + m1[7]*m2[5] + m1[11]*m2[6] + m1[15]*m2[7];
-
-		m3[8] = m1[0]*m2[8] + m1[4]*m2[9] + m1[8]*m2[10] + m1[12]*m2[11];
-		m3[9] = m1[1]*m2[8] + m1[5]*m2[9] + m1[9]*m2[10] + m1[13]*m2[11];
-		m3[10] = m1[2]*m2[8] + m1[6]*m2[9] + m1[10]*m2[10] + m1[14]*m2[11];
-		m3[11] = m1[3]*m2[8] + m1[7]*m2[9] + m1[11]*m2[10] + m1[15]*m2[11];
-
-		m3[12] = m1[0]*m2[12] + m1[4]*m2[13] + m1[8]*m2[14] + m1[12]*m2[15];
-		m3[13] = m1[1]*m2[12] + m1[5]*m2[13] + m1[9]*m2[14] + m1[13]*m2[15];
-		m3[14] = m1[2]*m2[12] + m1[6]*m2[13] + m1[10]*m2[14] + m1[14]*m2[15];
-		m3[15] = m1[3]*m2[12] + m1[7]*m2[13] + m1[11]*m2[14] + m1[15]*m2[15];
+		m3.setbyproduct_nocheck(*this, m2);
 		return m3;
 	}
 
@@ -1264,6 +1298,76 @@ namespace core
 		box.MaxEdge.Z = Bmax[2];
 	}
 
+#if defined(_IRR_COMPILE_WITH_SIMD_)
+	//! SIMD version, sums up in the same order as the C++ code
+	template <>
+	inline void CMatrix4<f32>::transformBoxEx(core::aabbox3d<f32>& box) const
+	{
+#if defined ( USE_MATRIX_TEST )
+		if (isIdentity())
+			return;
+#endif
+
+		simd4f bmin = simd_load(M+12);
+		simd4f bmax = bmin;
+
+		const f32* amin = &box.MinEdge.X;
+		const f32* amax = &box.MaxEdge.X;
+		for (u32 j=0; j<3; ++j)
+		{
+			const simd4f row = simd_load(M+j*4);
+			const simd4f a = simd_mul(row, simd_splat(amin[j]));
+			const simd4f b = simd_mul(row, simd_splat(amax[j]));
+			bmin = simd_add(bmin, simd_min(a, b));
+			bmax = simd_add(bmax, simd_max(a, b));
+		}
+
+		simd_store3(&box.MinEdge.X, bmin);
+		simd_store3(&box.MaxEdge.X, bmax);
+	}
+#endif
+
+
+	template <class T>
+	inline void CMatrix4<T>::transformVects(vector3df* out, const vector3df* in, u32 count, u32 outStride, u32 inStride) const
+	{
+		c8* dst = (c8*)out;
+		const c8* src = (const c8*)in;
+		for (u32 i=0; i<count; ++i, dst+=outStride, src+=inStride)
+		{
+			vector3df& vect = *(vector3df*)dst;
+			vect = *(const vector3df*)src;
+			transformVect(vect);
+		}
+	}
+
+	template <class T>
+	inline void CMatrix4<T>::rotateVects(vector3df* out, const vector3df* in, u32 count, u32 outStride, u32 inStride) const
+	{
+		c8* dst = (c8*)out;
+		const c8* src = (const c8*)in;
+		for (u32 i=0; i<count; ++i, dst+=outStride, src+=inStride)
+		{
+			vector3df& vect = *(vector3df*)dst;
+			vect = *(const vector3df*)src;
+			rotateVect(vect);
+		}
+	}
+
+	template <class T>
+	inline void CMatrix4<T>::transformTriangles(triangle3df* out, const triangle3df* in, u32 count) const
+	{
+		// a triangle is made of three vectors without padding
+		transformVects(&out->pointA, &in->pointA, count*3);
+	}
+
+	template <class T>
+	inline void CMatrix4<T>::transformBoxesEx(core::aabbox3d<f32>* boxes, u32 count) const
+	{
+		for (u32 i=0; i<count; ++i)
+			transformBoxEx(boxes[i]);
+	}
+
 
 	//! Multiplies this matrix by a 1x4 matrix
 	template <class T>
@@ -1388,6 +1492,90 @@ namespace core
 		return true;
 	}
 
+#if defined(_IRR_COMPILE_WITH_SSE_)
+	//! SSE version working on 2x2 sub matrices
+	/** The results differ from the C++ code by rounding only. */
+	template <>
+	inline bool CMatrix4<f32>::getInverse(CMatrix4<f32>& out) const
+	{
+#if defined ( USE_MATRIX_TEST )
+		if ( this->isIdentity() )
+		{
+			out=*this;
+			return true;
+		}
+#endif
+		const __m128 r0 = _mm_loadu_ps(M);
+		const __m128 r1 = _mm_loadu_ps(M+4);
+		const __m128 r2 = _mm_loadu_ps(M+8);
+		const __m128 r3 = _mm_loadu_ps(M+12);
+
+		// the matrix as blocks | A B |, each 2x2 block stored row by row
+		//                      | C D |
+		const __m128 A = _mm_movelh_ps(r0, r1);
+		const __m128 B = _mm_movehl_ps(r1, r0);
+		const __m128 C = _mm_movelh_ps(r2, r3);
+		const __m128 D = _mm_movehl_ps(r3, r2);
+
+		// determinants of the blocks (|A| |B| |C| |D|)
+		const __m128 detSub = _mm_sub_ps(
+			_mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2,0,2,0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3,1,3,1))),
+			_mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3,1,3,1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2,0,2,0))));
+		const __m128 detA = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(0,0,0,0));
+		const __m128 detB = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(1,1,1,1));
+		const __m128 detC = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(2,2,2,2));
+		const __m128 detD = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(3,3,3,3));
+
+		// adj(D)*C and adj(A)*B
+		const __m128 D_C = _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(D, D, _MM_SHUFFLE(0,0,3,3)), C),
+			_mm_mul_ps(_mm_shuffle_ps(D, D, _MM_SHUFFLE(2,2,1,1)), _mm_shuffle_ps(C, C, _MM_SHUFFLE(1,0,3,2))));
+		const __m128 A_B = _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(A, A, _MM_SHUFFLE(0,0,3,3)), B),
+			_mm_mul_ps(_mm_shuffle_ps(A, A, _MM_SHUFFLE(2,2,1,1)), _mm_shuffle_ps(B, B, _MM_SHUFFLE(1,0,3,2))));
+
+		// |M| = |A|*|D| + |B|*|C| - trace(adj(A)*B*adj(D)*C)
+		__m128 tr = _mm_mul_ps(A_B, _mm_shuffle_ps(D_C, D_C, _MM_SHUFFLE(3,1,2,0)));
+		tr = _mm_add_ps(tr, _mm_movehl_ps(tr, tr));
+		tr = _mm_add_ss(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(1,1,1,1)));
+		f32 d = _mm_cvtss_f32(_mm_sub_ss(_mm_add_ss(_mm_mul_ss(detA, detD), _mm_mul_ss(detB, detC)), tr));
+
+		if( core::iszero ( d, FLT_MIN ) )
+			return false;
+
+		d = core::reciprocal ( d );
+
+		// adjugates of the blocks of the inverse, times 1/|M|
+		// X = |D|*A - B*adj(D)*C
+		__m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), _mm_add_ps(_mm_mul_ps(B, _mm_shuffle_ps(D_C, D_C, _MM_SHUFFLE(3,0,3,0))),
+			_mm_mul_ps(_mm_shuffle_ps(B, B, _MM_SHUFFLE(2,3,0,1)), _mm_shuffle_ps(D_C, D_C, _MM_SHUFFLE(1,2,1,2)))));
+		// W = |A|*D - C*adj(A)*B
+		__m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), _mm_add_ps(_mm_mul_ps(C, _mm_shuffle_ps(A_B, A_B, _MM_SHUFFLE(3,0,3,0))),
+			_mm_mul_ps(_mm_shuffle_ps(C, C, _MM_SHUFFLE(2,3,0,1)), _mm_shuffle_ps(A_B, A_B, _MM_SHUFFLE(1,2,1,2)))));
+		// Y = |B|*C - D*adj(adj(A)*B)
+		__m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), _mm_sub_ps(_mm_mul_ps(D, _mm_shuffle_ps(A_B, A_B, _MM_SHUFFLE(0,3,0,3))),
+			_mm_mul_ps(_mm_shuffle_ps(D, D, _MM_SHUFFLE(2,3,0,1)), _mm_shuffle_ps(A_B, A_B, _MM_SHUFFLE(1,2,1,2)))));
+		// Z = |C|*B - A*adj(adj(D)*C)
+		__m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), _mm_sub_ps(_mm_mul_ps(A, _mm_shuffle_ps(D_C, D_C, _MM_SHUFFLE(0,3,0,3))),
+			_mm_mul_ps(_mm_shuffle_ps(A, A, _MM_SHUFFLE(2,3,0,1)), _mm_shuffle_ps(D_C, D_C, _MM_SHUFFLE(1,2,1,2)))));
+
+		const __m128 rd = _mm_mul_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), _mm_set1_ps(d));
+		X = _mm_mul_ps(X, rd);
+		Y = _mm_mul_ps(Y, rd);
+		Z = _mm_mul_ps(Z, rd);
+		W = _mm_mul_ps(W, rd);
+
+		// undo the adjugate while storing the rows
+		_mm_storeu_ps(out.M, _mm_shuffle_ps(X, Y, _MM_SHUFFLE(1,3,1,3)));
+		_mm_storeu_ps(out.M+4, _mm_shuffle_ps(X, Y, _MM_SHUFFLE(0,2,0,2)));
+		_mm_storeu_ps(out.M+8, _mm_shuffle_ps(Z, W, _MM_SHUFFLE(1,3,1,3)));
+		_mm_storeu_ps(out.M+12, _mm_shuffle_ps(Z, W, _MM_SHUFFLE(0,2,0,2)));
+
+#if defined ( USE_MATRIX_TEST )
+		out.definitelyIdentityMatrix = definitelyIdentityMatrix;
+#endif
+		return true;
+	}
+#endif
+
 
 	//! Inverts a primitive matrix which only contains a translation and a rotation
 	//! \param out: where result matrix is written to.
@@ -56,6 +56,31 @@ struct SNamedPath
 		return InternalName;
 	}
 
+	//! Compares the name with the name a path would get.
+	/** Sorts like operator<, but does not need to create the name of the
+	path, so sorted arrays can be searched for a path without allocating.
+	\param p Path to compare with.
+	\return Less than 0 if this name sorts before the name of the path,
+	0 if they are equal, greater than 0 if it sorts after it. */
+	s32 compareName(const fschar_t* p) const
+	{
+		const fschar_t* name = InternalName.c_str();
+		for (;; ++name, ++p)
+		{
+			fschar_t c = *p;
+			if (c == '\\')
+				c = '/';
+			c = core::locale_lower(c);
+
+			// a shorter name sorts first
+			if (!*name || !c)
+				return (*name ? 1 : 0) - (c ? 1 : 0);
+			const s32 diff = *name - c;
+			if (diff)
+				return diff;
+		}
+	}
+
 	//! Implicit cast to io::path
 	operator core::stringc() const
 	{
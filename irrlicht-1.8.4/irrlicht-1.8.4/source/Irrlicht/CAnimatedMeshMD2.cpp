@@ -8,6 +8,7 @@
 #include "CAnimatedMeshMD2.h"
 #include "SColor.h"
 #include "irrMath.h"
+#include "SMesh.h"
 
 namespace irr
 {
@@ -248,17 +249,48 @@ u32 CAnimatedMeshMD2::getFrameCount() const
 //! returns the animated mesh based on a detail level. 0 is the lowest, 255 the highest detail. Note, that some Meshes will ignore the detail level.
 IMesh* CAnimatedMeshMD2::getMesh(s32 frame, s32 detailLevel, s32 startFrameLoop, s32 endFrameLoop)
 {
-	if ((u32)frame > getFrameCount())
-		frame = (frame % getFrameCount());
+	updateInterpolationBuffer(InterpolationBuffer, frame, startFrameLoop, endFrameLoop);
+	return this;
+}
 
-	if (startFrameLoop == -1 && endFrameLoop == -1)
-	{
-		startFrameLoop = 0;
-		endFrameLoop = getFrameCount();
-	}
 
-	updateInterpolationBuffer(frame, startFrameLoop, endFrameLoop);
-	return this;
+//! Creates a mesh which receives the frames of this mesh for one user.
+IMesh* CAnimatedMeshMD2::createFrameMesh()
+{
+	SMeshBuffer* buffer = new SMeshBuffer();
+	buffer->Vertices = InterpolationBuffer->Vertices;
+	buffer->Indices = InterpolationBuffer->Indices;
+	buffer->Material = InterpolationBuffer->Material;
+	buffer->BoundingBox = InterpolationBuffer->BoundingBox;
+	buffer->setHardwareMappingHint(InterpolationBuffer->getHardwareMappingHint_Vertex(), EBT_VERTEX);
+	buffer->setHardwareMappingHint(InterpolationBuffer->getHardwareMappingHint_Index(), EBT_INDEX);
+
+	SMesh* mesh = new SMesh();
+	mesh->addMeshBuffer(buffer);
+	mesh->BoundingBox = buffer->BoundingBox;
+	buffer->drop();
+
+	return mesh;
+}
+
+
+//! Writes a frame into a mesh created by createFrameMesh() of this mesh.
+void CAnimatedMeshMD2::updateFrameMesh(IMesh* target, s32 frame, s32 detailLevel,
+		s32 startFrameLoop, s32 endFrameLoop)
+{
+	SMesh* mesh = static_cast<SMesh*>(target);
+	if (!mesh || mesh->getMeshBufferCount() != 1)
+		return;
+
+	SMeshBuffer* buffer = static_cast<SMeshBuffer*>(mesh->getMeshBuffer(0));
+	if (buffer->Vertices.size() != InterpolationBuffer->Vertices.size())
+		return;
+
+	// changes of the material through the animated mesh should show up in all frame meshes
+	buffer->Material = InterpolationBuffer->Material;
+
+	updateInterpolationBuffer(buffer, frame, startFrameLoop, endFrameLoop);
+	mesh->BoundingBox = buffer->BoundingBox;
 }
 
 
@@ -290,8 +322,20 @@ IMeshBuffer* CAnimatedMeshMD2::getMeshBuffer(const video::SMaterial &material) c
 
 
 // updates the interpolation buffer
-void CAnimatedMeshMD2::updateInterpolationBuffer(s32 frame, s32 startFrameLoop, s32 endFrameLoop)
+void CAnimatedMeshMD2::updateInterpolationBuffer(SMeshBuffer* target, s32 frame, s32 startFrameLoop, s32 endFrameLoop)
 {
+	if (!FrameCount)
+		return;
+
+	if ((u32)frame > getFrameCount())
+		frame = (frame % getFrameCount());
+
+	if (startFrameLoop == -1 && endFrameLoop == -1)
+	{
+		startFrameLoop = 0;
+		endFrameLoop = getFrameCount();
+	}
+
 	u32 firstFrame, secondFrame;
 	f32 div;
 
@@ -299,8 +343,8 @@ void CAnimatedMeshMD2::updateInterpolationBuffer(s32 frame, s32 startFrameLoop,
 
 	if (endFrameLoop - startFrameLoop == 0)
 	{
-		firstFrame = frame>>MD2_FRAME_SHIFT;
-		secondFrame = frame>>MD2_FRAME_SHIFT;
+		firstFrame = core::s32_min(FrameCount - 1, frame>>MD2_FRAME_SHIFT);
+		secondFrame = firstFrame;
 		div = 1.0f;
 	}
 	else
@@ -320,38 +364,44 @@ void CAnimatedMeshMD2::updateInterpolationBuffer(s32 frame, s32 startFrameLoop,
 		div = frame * MD2_FRAME_SHIFT_RECIPROCAL;
 	}
 
-	video::S3DVertex* target = static_cast<video::S3DVertex*>(InterpolationBuffer->getVertices());
-	SMD2Vert* first = FrameList[firstFrame].pointer();
-	SMD2Vert* second = FrameList[secondFrame].pointer();
+	// frames are decoded when they are used first, after that all nodes share them
+	if (KeyFrames.getFrameCount() != FrameCount)
+		KeyFrames.setSize(FrameCount, FrameList[0].size());
+	if (!KeyFrames.getFrame(firstFrame))
+		decodeFrame(firstFrame);
+	if (!KeyFrames.getFrame(secondFrame))
+		decodeFrame(secondFrame);
 
 	// interpolate both frames
-	const u32 count = FrameList[firstFrame].size();
-	for (u32 i=0; i<count; ++i)
-	{
-		const core::vector3df one = core::vector3df(f32(first->Pos.X) * FrameTransforms[firstFrame].scale.X + FrameTransforms[firstFrame].translate.X,
-				f32(first->Pos.Y) * FrameTransforms[firstFrame].scale.Y + FrameTransforms[firstFrame].translate.Y,
-				f32(first->Pos.Z) * FrameTransforms[firstFrame].scale.Z + FrameTransforms[firstFrame].translate.Z);
-		const core::vector3df two = core::vector3df(f32(second->Pos.X) * FrameTransforms[secondFrame].scale.X + FrameTransforms[secondFrame].translate.X,
-				f32(second->Pos.Y) * FrameTransforms[secondFrame].scale.Y + FrameTransforms[secondFrame].translate.Y,
-				f32(second->Pos.Z) * FrameTransforms[secondFrame].scale.Z + FrameTransforms[secondFrame].translate.Z);
-		target->Pos = two.getInterpolated(one, div);
-		const core::vector3df n1(
-				Q2_VERTEX_NORMAL_TABLE[first->NormalIdx][0],
-				Q2_VERTEX_NORMAL_TABLE[first->NormalIdx][2],
-				Q2_VERTEX_NORMAL_TABLE[first->NormalIdx][1]);
-		const core::vector3df n2(
-				Q2_VERTEX_NORMAL_TABLE[second->NormalIdx][0],
-				Q2_VERTEX_NORMAL_TABLE[second->NormalIdx][2],
-				Q2_VERTEX_NORMAL_TABLE[second->NormalIdx][1]);
-		target->Normal = n2.getInterpolated(n1, div);
-		++target;
-		++first;
-		++second;
-	}
+	KeyFrames.interpolate(firstFrame, secondFrame, div,
+		static_cast<video::S3DVertex*>(target->getVertices()), sizeof(video::S3DVertex));
 
 	//update bounding box
-	InterpolationBuffer->setBoundingBox(BoxList[secondFrame].getInterpolated(BoxList[firstFrame], div));
-	InterpolationBuffer->setDirty();
+	target->setBoundingBox(BoxList[secondFrame].getInterpolated(BoxList[firstFrame], div));
+	target->setDirty(EBT_VERTEX);
+}
+
+
+//! decodes the positions and normals of a keyframe
+void CAnimatedMeshMD2::decodeFrame(u32 frame)
+{
+	f32* data = KeyFrames.addFrame(frame);
+	const u32 pitch = KeyFrames.getPitch();
+	const SKeyFrameTransform& transform = FrameTransforms[frame];
+	const SMD2Vert* v = FrameList[frame].const_pointer();
+
+	const u32 count = core::min_(FrameList[frame].size(), KeyFrames.getVertexCount());
+	for (u32 i=0; i<count; ++i, ++v)
+	{
+		data[CVertexKeyFrames::POS_X*pitch + i] = f32(v->Pos.X) * transform.scale.X + transform.translate.X;
+		data[CVertexKeyFrames::POS_Y*pitch + i] = f32(v->Pos.Y) * transform.scale.Y + transform.translate.Y;
+		data[CVertexKeyFrames::POS_Z*pitch + i] = f32(v->Pos.Z) * transform.scale.Z + transform.translate.Z;
+
+		const f32* n = Q2_VERTEX_NORMAL_TABLE[v->NormalIdx];
+		data[CVertexKeyFrames::NORMAL_X*pitch + i] = n[0];
+		data[CVertexKeyFrames::NORMAL_Y*pitch + i] = n[2];
+		data[CVertexKeyFrames::NORMAL_Z*pitch + i] = n[1];
+	}
 }
 
 
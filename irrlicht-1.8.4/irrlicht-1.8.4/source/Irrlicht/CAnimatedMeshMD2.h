@@ -8,6 +8,7 @@
 #include "IAnimatedMeshMD2.h"
 #include "IMesh.h"
 #include "CMeshBuffer.h"
+#include "CVertexKeyFrames.h"
 #include "IReadFile.h"
 #include "S3DVertex.h"
 #include "irrArray.h"
@@ -49,6 +50,13 @@ namespace scene
 		//! returns the animated mesh based on a detail level. 0 is the lowest, 255 the highest detail. Note, that some Meshes will ignore the detail level.
 		virtual IMesh* getMesh(s32 frame, s32 detailLevel=255, s32 startFrameLoop=-1, s32 endFrameLoop=-1);
 
+		//! Creates a mesh which receives the frames of this mesh for one user.
+		virtual IMesh* createFrameMesh();
+
+		//! Writes a frame into a mesh created by createFrameMesh() of this mesh.
+		virtual void updateFrameMesh(IMesh* target, s32 frame, s32 detailLevel=255,
+			s32 startFrameLoop=-1, s32 endFrameLoop=-1);
+
 		//! returns amount of mesh buffers.
 		virtual u32 getMeshBufferCount() const;
 
@@ -142,7 +150,13 @@ namespace scene
 	private:
 
 		//! updates the interpolation buffer
-		void updateInterpolationBuffer(s32 frame, s32 startFrame, s32 endFrame);
+		void updateInterpolationBuffer(SMeshBuffer* target, s32 frame, s32 startFrame, s32 endFrame);
+
+		//! decodes the positions and normals of a keyframe
+		void decodeFrame(u32 frame);
+
+		//! decoded keyframes, shared by all frame meshes
+		CVertexKeyFrames KeyFrames;
 
 		f32 FramesPerSecond;
 	};
@@ -141,7 +141,19 @@ SMD3QuaternionTagList *CAnimatedMeshMD3::getTagList(s32 frame, s32 detailLevel,
 	if (0 == Mesh)
 		return 0;
 
-	getMesh(frame, detailLevel, startFrameLoop, endFrameLoop);
+	// the tags are cached on their own, the vertices aren't needed for them
+	SCacheInfo candidate(frame, startFrameLoop, endFrameLoop);
+	if (candidate == CurrentTags)
+		return &TagListIPol;
+
+	s32 frameA;
+	s32 frameB;
+	f32 iPol;
+	getFrames(frame, startFrameLoop, endFrameLoop, frameA, frameB, iPol);
+
+	buildTagArray(frameA, frameB, iPol);
+
+	CurrentTags = candidate;
 	return &TagListIPol;
 }
 
@@ -157,15 +169,65 @@ IMesh* CAnimatedMeshMD3::getMesh(s32 frame, s32 detailLevel, s32 startFrameLoop,
 	if (candidate == Current)
 		return MeshIPol;
 
+	buildMesh(MeshIPol, frame, startFrameLoop, endFrameLoop);
+
+	Current = candidate;
+	return MeshIPol;
+}
+
+
+//! Creates a mesh which receives the frames of this mesh for one user.
+IMesh* CAnimatedMeshMD3::createFrameMesh()
+{
+	if (0 == Mesh)
+		return 0;
+
+	SMesh* mesh = new SMesh();
+	for (u32 i = 0; i != MeshIPol->getMeshBufferCount(); ++i)
+	{
+		const SMeshBufferLightMap* source = (const SMeshBufferLightMap*) MeshIPol->getMeshBuffer(i);
+
+		SMeshBufferLightMap* dest = new SMeshBufferLightMap();
+		dest->Vertices = source->Vertices;
+		dest->Indices = source->Indices;
+		dest->Material = source->Material;
+		dest->BoundingBox = source->BoundingBox;
+		dest->setHardwareMappingHint(source->getHardwareMappingHint_Vertex(), EBT_VERTEX);
+		dest->setHardwareMappingHint(source->getHardwareMappingHint_Index(), EBT_INDEX);
+
+		mesh->addMeshBuffer(dest);
+		dest->drop();
+	}
+	mesh->BoundingBox = MeshIPol->BoundingBox;
+
+	return mesh;
+}
+
+
+//! Writes a frame into a mesh created by createFrameMesh() of this mesh.
+void CAnimatedMeshMD3::updateFrameMesh(IMesh* target, s32 frame, s32 detailLevel,
+		s32 startFrameLoop, s32 endFrameLoop)
+{
+	if (0 == Mesh || !target || target->getMeshBufferCount() != MeshIPol->getMeshBufferCount())
+		return;
+
+	// changes of the materials through the animated mesh should show up in all frame meshes
+	for (u32 i = 0; i != target->getMeshBufferCount(); ++i)
+		target->getMeshBuffer(i)->getMaterial() = MeshIPol->getMeshBuffer(i)->getMaterial();
+
+	buildMesh(static_cast<SMesh*>(target), frame, startFrameLoop, endFrameLoop);
+}
+
+
+//! finds the two keyframes and the interpolation between them for a frame
+void CAnimatedMeshMD3::getFrames(s32 frame, s32 startFrameLoop, s32 endFrameLoop,
+		s32& frameA, s32& frameB, f32& iPol) const
+{
 	startFrameLoop = core::s32_max(0, startFrameLoop >> IPolShift);
 	endFrameLoop = core::if_c_a_else_b(endFrameLoop < 0, Mesh->MD3Header.numFrames - 1, endFrameLoop >> IPolShift);
 
 	const u32 mask = 1 << IPolShift;
 
-	s32 frameA;
-	s32 frameB;
-	f32 iPol;
-
 	if (LoopMode)
 	{
 		// correct frame to "pixel center"
@@ -191,21 +253,24 @@ IMesh* CAnimatedMeshMD3::getMesh(s32 frame, s32 detailLevel, s32 startFrameLoop,
 		frameA = core::s32_clamp(frame, startFrameLoop, endFrameLoop);
 		frameB = core::s32_min(frameA + 1, endFrameLoop);
 	}
+}
+
+
+//! interpolates the vertices of all mesh buffers of a frame into a mesh
+void CAnimatedMeshMD3::buildMesh(SMesh* dest, s32 frame, s32 startFrameLoop, s32 endFrameLoop)
+{
+	s32 frameA;
+	s32 frameB;
+	f32 iPol;
+	getFrames(frame, startFrameLoop, endFrameLoop, frameA, frameB, iPol);
 
 	// build current vertex
 	for (u32 i = 0; i!= Mesh->Buffer.size(); ++i)
 	{
-		buildVertexArray(frameA, frameB, iPol,
-					Mesh->Buffer[i],
-					(SMeshBufferLightMap*) MeshIPol->getMeshBuffer(i));
+		buildVertexArray(frameA, frameB, iPol, i,
+					(SMeshBufferLightMap*) dest->getMeshBuffer(i));
 	}
-	MeshIPol->recalculateBoundingBox();
-
-	// build current tags
-	buildTagArray(frameA, frameB, iPol);
-
-	Current = candidate;
-	return MeshIPol;
+	dest->recalculateBoundingBox();
 }
 
 
@@ -252,35 +317,62 @@ IMeshBuffer * CAnimatedMeshMD3::createMeshBuffer(const SMD3MeshBuffer* source,
 
 //! build final mesh's vertices from frames frameA and frameB with linear interpolation.
 void CAnimatedMeshMD3::buildVertexArray(u32 frameA, u32 frameB, f32 interpolate,
-					const SMD3MeshBuffer* source,
-					SMeshBufferLightMap* dest)
+					u32 bufferIndex, SMeshBufferLightMap* dest)
 {
-	const u32 frameOffsetA = frameA * source->MeshHeader.numVertices;
-	const u32 frameOffsetB = frameB * source->MeshHeader.numVertices;
-	const f32 scale = (1.f/ 64.f);
-
-	for (s32 i = 0; i != source->MeshHeader.numVertices; ++i)
+	// frames are decoded when they are used first, after that all nodes share them
+	if (KeyFrames.size() != Mesh->Buffer.size())
 	{
-		video::S3DVertex2TCoords &v = dest->Vertices [ i ];
+		KeyFrames.clear();
+		KeyFrames.reallocate(Mesh->Buffer.size());
+		for (u32 i = 0; i != Mesh->Buffer.size(); ++i)
+		{
+			KeyFrames.push_back(CVertexKeyFrames());
+			KeyFrames.getLast().setSize(Mesh->MD3Header.numFrames, Mesh->Buffer[i]->MeshHeader.numVertices);
+		}
+	}
+
+	CVertexKeyFrames& keyFrames = KeyFrames[bufferIndex];
+	if (!keyFrames.getFrame(frameA))
+		decodeFrame(bufferIndex, frameA);
+	if (!keyFrames.getFrame(frameB))
+		decodeFrame(bufferIndex, frameB);
+
+	if (dest->Vertices.size() < keyFrames.getVertexCount())
+		return;
+
+	keyFrames.interpolate(frameA, frameB, interpolate,
+		dest->Vertices.pointer(), sizeof(video::S3DVertex2TCoords), &dest->BoundingBox);
+	dest->setDirty(EBT_VERTEX);
+}
+
 
-		const SMD3Vertex &vA = source->Vertices [ frameOffsetA + i ];
-		const SMD3Vertex &vB = source->Vertices [ frameOffsetB + i ];
+//! decodes the positions and normals of a keyframe of a mesh buffer
+void CAnimatedMeshMD3::decodeFrame(u32 bufferIndex, u32 frame)
+{
+	const SMD3MeshBuffer* source = Mesh->Buffer[bufferIndex];
+	CVertexKeyFrames& keyFrames = KeyFrames[bufferIndex];
+
+	f32* data = keyFrames.addFrame(frame);
+	if (!data)
+		return;
+
+	const u32 pitch = keyFrames.getPitch();
+	const SMD3Vertex* v = source->Vertices.const_pointer() + frame * source->MeshHeader.numVertices;
+	const f32 scale = (1.f/ 64.f);
 
+	for (s32 i = 0; i != source->MeshHeader.numVertices; ++i, ++v)
+	{
 		// position
-		v.Pos.X = scale * (vA.position[0] + interpolate * (vB.position[0] - vA.position[0]));
-		v.Pos.Y = scale * (vA.position[2] + interpolate * (vB.position[2] - vA.position[2]));
-		v.Pos.Z = scale * (vA.position[1] + interpolate * (vB.position[1] - vA.position[1]));
+		data[CVertexKeyFrames::POS_X*pitch + i] = scale * v->position[0];
+		data[CVertexKeyFrames::POS_Y*pitch + i] = scale * v->position[2];
+		data[CVertexKeyFrames::POS_Z*pitch + i] = scale * v->position[1];
 
 		// normal
-		const core::vector3df nA(quake3::getMD3Normal(vA.normal[0], vA.normal[1]));
-		const core::vector3df nB(quake3::getMD3Normal(vB.normal[0], vB.normal[1]));
-
-		v.Normal.X = nA.X + interpolate * (nB.X - nA.X);
-		v.Normal.Y = nA.Z + interpolate * (nB.Z - nA.Z);
-		v.Normal.Z = nA.Y + interpolate * (nB.Y - nA.Y);
+		const core::vector3df n(quake3::getMD3Normal(v->normal[0], v->normal[1]));
+		data[CVertexKeyFrames::NORMAL_X*pitch + i] = n.X;
+		data[CVertexKeyFrames::NORMAL_Y*pitch + i] = n.Z;
+		data[CVertexKeyFrames::NORMAL_Z*pitch + i] = n.Y;
 	}
-
-	dest->recalculateBoundingBox();
 }
 
 
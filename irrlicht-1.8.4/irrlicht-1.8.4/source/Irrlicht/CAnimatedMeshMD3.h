@@ -13,6 +13,7 @@
 #include "SMesh.h"
 #include "SMeshBuffer.h"
 #include "IQ3Shader.h"
+#include "CVertexKeyFrames.h"
 
 namespace irr
 {
@@ -58,6 +59,14 @@ namespace scene
 
 		virtual IMesh* getMesh(s32 frame, s32 detailLevel,
 				s32 startFrameLoop, s32 endFrameLoop);
+
+		//! Creates a mesh which receives the frames of this mesh for one user.
+		virtual IMesh* createFrameMesh();
+
+		//! Writes a frame into a mesh created by createFrameMesh() of this mesh.
+		virtual void updateFrameMesh(IMesh* target, s32 frame, s32 detailLevel=255,
+				s32 startFrameLoop=-1, s32 endFrameLoop=-1);
+
 		virtual const core::aabbox3d<f32>& getBoundingBox() const;
 		virtual E_ANIMATED_MESH_TYPE getMeshType() const;
 
@@ -111,6 +120,7 @@ namespace scene
 			s32 endFrameLoop;
 		};
 		SCacheInfo Current;
+		SCacheInfo CurrentTags;
 
 		//! return a Mesh per frame
 		SMesh* MeshIPol;
@@ -119,9 +129,21 @@ namespace scene
 		IMeshBuffer* createMeshBuffer(const SMD3MeshBuffer* source,
 				io::IFileSystem* fs, video::IVideoDriver* driver);
 
+		//! finds the two keyframes and the interpolation between them for a frame
+		void getFrames(s32 frame, s32 startFrameLoop, s32 endFrameLoop,
+				s32& frameA, s32& frameB, f32& iPol) const;
+
+		//! interpolates the vertices of all mesh buffers of a frame into a mesh
+		void buildMesh(SMesh* dest, s32 frame, s32 startFrameLoop, s32 endFrameLoop);
+
 		void buildVertexArray(u32 frameA, u32 frameB, f32 interpolate,
-					const SMD3MeshBuffer* source,
-					SMeshBufferLightMap* dest);
+					u32 bufferIndex, SMeshBufferLightMap* dest);
+
+		//! decodes the positions and normals of a keyframe of a mesh buffer
+		void decodeFrame(u32 bufferIndex, u32 frame);
+
+		//! decoded keyframes of each mesh buffer, shared by all frame meshes
+		core::array<CVertexKeyFrames> KeyFrames;
 
 		void buildTagArray(u32 frameA, u32 frameB, f32 interpolate);
 		f32 FramesPerSecond;
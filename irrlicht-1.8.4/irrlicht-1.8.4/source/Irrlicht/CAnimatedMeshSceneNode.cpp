@@ -32,6 +32,7 @@ CAnimatedMeshSceneNode::CAnimatedMeshSceneNode(IAnimatedMesh* mesh,
 		const core::vector3df& rotation,
 		const core::vector3df& scale)
 : IAnimatedMeshSceneNode(parent, mgr, id, position, rotation, scale), Mesh(0),
+	FrameMesh(0), FrameMeshFrame(-1), FrameMeshBlend(-1), FrameMeshStart(-1), FrameMeshEnd(-1),
 	StartFrame(0), EndFrame(0), FramesPerSecond(0.025f),
 	CurrentFrameNr(0.f), LastTimeMs(0),
 	TransitionTime(0), Transiting(0.f), TransitingBlend(0.f),
@@ -53,6 +54,9 @@ CAnimatedMeshSceneNode::~CAnimatedMeshSceneNode()
 	if (MD3Special)
 		MD3Special->drop();
 
+	if (FrameMesh)
+		FrameMesh->drop();
+
 	if (Mesh)
 		Mesh->drop();
 
@@ -191,7 +195,22 @@ IMesh * CAnimatedMeshSceneNode::getMeshForCurrentFrame()
 	{
 		s32 frameNr = (s32) getFrameNr();
 		s32 frameBlend = (s32) (core::fract ( getFrameNr() ) * 1000.f);
-		return Mesh->getMesh(frameNr, frameBlend, StartFrame, EndFrame);
+
+		if (!FrameMesh)
+			return Mesh->getMesh(frameNr, frameBlend, StartFrame, EndFrame);
+
+		// Nodes showing the same mesh at different frames would overwrite each
+		// other in the mesh returned by getMesh(), so each has a mesh of its own.
+		if (frameNr != FrameMeshFrame || frameBlend != FrameMeshBlend ||
+			StartFrame != FrameMeshStart || EndFrame != FrameMeshEnd)
+		{
+			Mesh->updateFrameMesh(FrameMesh, frameNr, frameBlend, StartFrame, EndFrame);
+			FrameMeshFrame = frameNr;
+			FrameMeshBlend = frameBlend;
+			FrameMeshStart = StartFrame;
+			FrameMeshEnd = EndFrame;
+		}
+		return FrameMesh;
 	}
 	else
 	{
@@ -554,7 +573,7 @@ IShadowVolumeSceneNode* CAnimatedMeshSceneNode::addShadowVolumeSceneNode(
 		return 0;
 
 	if (!shadowMesh)
-		shadowMesh = Mesh; // if null is given, use the mesh of node
+		shadowMesh = FrameMesh ? FrameMesh : Mesh; // if null is given, use the mesh of node
 
 	if (Shadow)
 		Shadow->drop();
@@ -835,6 +854,11 @@ void CAnimatedMeshSceneNode::setMesh(IAnimatedMesh* mesh)
 
 		// grab the mesh (it's non-null!)
 		Mesh->grab();
+
+		if (FrameMesh)
+			FrameMesh->drop();
+		FrameMesh = Mesh->getMeshType() != EAMT_SKINNED ? Mesh->createFrameMesh() : 0;
+		FrameMeshFrame = -1;
 	}
 
 	// get materials and bounding box
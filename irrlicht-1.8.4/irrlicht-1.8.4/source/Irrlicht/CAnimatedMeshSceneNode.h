@@ -178,6 +178,14 @@ namespace scene
 		core::aabbox3d<f32> Box;
 		IAnimatedMesh* Mesh;
 
+		//! frames of Mesh for this node only, 0 if the mesh doesn't support it
+		IMesh* FrameMesh;
+		//! parameters FrameMesh was last updated with
+		s32 FrameMeshFrame;
+		s32 FrameMeshBlend;
+		s32 FrameMeshStart;
+		s32 FrameMeshEnd;
+
 		s32 StartFrame;
 		s32 EndFrame;
 		f32 FramesPerSecond;
@@ -13,8 +13,27 @@ namespace irr
 namespace io
 {
 
+namespace
+{
+	//! FNV-1a hash of an attribute name
+	inline u32 getNameHash(const c8* name)
+	{
+		u32 hash = 2166136261u;
+		if (name)
+		{
+			for (; *name; ++name)
+				hash = (hash ^ (u8)*name) * 16777619u;
+		}
+		return hash;
+	}
+
+	//! hashes of the names of the attributes of the xml elements
+	const u32 XMLNameHash = getXMLNameHash(L"name");
+	const u32 XMLValueHash = getXMLNameHash(L"value");
+}
+
 CAttributes::CAttributes(video::IVideoDriver* driver)
-: Driver(driver)
+: IndexRevision(0), Driver(driver)
 {
 	#ifdef _DEBUG
 	setDebugName("CAttributes");
@@ -40,6 +59,62 @@ void CAttributes::clear()
 		Attributes[i]->drop();
 
 	Attributes.clear();
+	NameHashes.clear();
+	HashTable.clear();
+	++IndexRevision;
+}
+
+
+//! Adds an attribute and registers it in the hash table
+void CAttributes::addAttributeP(IAttribute* attribute)
+{
+	Attributes.push_back(attribute);
+	NameHashes.push_back(getNameHash(attribute->Name.c_str()));
+
+	// keep the table at most half full
+	if (Attributes.size()*2 > HashTable.size())
+		rebuildHashTable();
+	else
+		insertHashP(Attributes.size()-1);
+}
+
+
+//! Removes the attribute at index and rebuilds the hash table
+void CAttributes::removeAttributeP(u32 index)
+{
+	Attributes[index]->drop();
+	Attributes.erase(index);
+	NameHashes.erase(index);
+	rebuildHashTable();
+	++IndexRevision;
+}
+
+
+//! Registers the attribute at index in the hash table
+void CAttributes::insertHashP(u32 index)
+{
+	const u32 mask = HashTable.size()-1;
+	u32 slot = NameHashes[index] & mask;
+	while (HashTable[slot] != -1)
+		slot = (slot+1) & mask;
+	HashTable[slot] = index;
+}
+
+
+//! Rebuilds the hash table from the attribute list
+void CAttributes::rebuildHashTable()
+{
+	u32 size = 16;
+	while (size < Attributes.size()*4)
+		size <<= 1;
+
+	HashTable.set_used(size);
+	for (u32 i=0; i<size; ++i)
+		HashTable[i] = -1;
+
+	// inserting in order lets lookups find the first of equally named attributes
+	for (u32 i=0; i<Attributes.size(); ++i)
+		insertHashP(i);
 }
 
 
@@ -48,23 +123,20 @@ void CAttributes::clear()
 //! \param value: Value for the attribute. Set this to 0 to delete the attribute
 void CAttributes::setAttribute(const c8* attributeName, const c8* value)
 {
-	for (u32 i=0; i<Attributes.size(); ++i)
-		if (Attributes[i]->Name == attributeName)
-		{
-			if (!value)
-			{
-				Attributes[i]->drop();
-				Attributes.erase(i);
-			}
-			else
-				Attributes[i]->setString(value);
+	const s32 i = findAttribute(attributeName);
+	if (i != -1)
+	{
+		if (!value)
+			removeAttributeP(i);
+		else
+			Attributes[i]->setString(value);
 
-			return;
-		}
+		return;
+	}
 
 	if (value)
 	{
-		Attributes.push_back(new CStringAttribute(attributeName, value));
+		addAttributeP(new CStringAttribute(attributeName, value));
 	}
 }
 
@@ -116,25 +188,20 @@ core::stringc CAttributes::getAttributeAsString(s32 index)
 //! \param value: Value for the attribute. Set this to 0 to delete the attribute
 void CAttributes::setAttribute(const c8* attributeName, const wchar_t* value)
 {
-	for (u32 i=0; i<Attributes.size(); ++i)
+	const s32 i = findAttribute(attributeName);
+	if (i != -1)
 	{
-		if (Attributes[i]->Name == attributeName)
-		{
-			if (!value)
-			{
-				Attributes[i]->drop();
-				Attributes.erase(i);
-			}
-			else
-				Attributes[i]->setString(value);
+		if (!value)
+			removeAttributeP(i);
+		else
+			Attributes[i]->setString(value);
 
-			return;
-		}
+		return;
 	}
 
 	if (value)
 	{
-		Attributes.push_back(new CStringAttribute(attributeName, value));
+		addAttributeP(new CStringAttribute(attributeName, value));
 	}
 }
 
@@ -183,7 +250,7 @@ core::stringw CAttributes::getAttributeAsStringW(s32 index)
 //! Adds an attribute as an array of wide strings
 void CAttributes::addArray(const c8* attributeName, const core::array<core::stringw>& value)
 {
-	Attributes.push_back(new CStringWArrayAttribute(attributeName, value));
+	addAttributeP(new CStringWArrayAttribute(attributeName, value));
 }
 
 //! Sets an attribute value as an array of wide strings.
@@ -194,7 +261,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::array<core::
 		att->setArray(value);
 	else
 	{
-		Attributes.push_back(new CStringWArrayAttribute(attributeName, value));
+		addAttributeP(new CStringWArrayAttribute(attributeName, value));
 	}
 }
 
@@ -232,9 +299,17 @@ void CAttributes::setAttribute(s32 index, const core::array<core::stringw>& valu
 //! Returns attribute index from name, -1 if not found
 s32 CAttributes::findAttribute(const c8* attributeName) const
 {
-	for (u32 i=0; i<Attributes.size(); ++i)
-		if (Attributes[i]->Name == attributeName)
+	if (Attributes.empty())
+		return -1;
+
+	const u32 hash = getNameHash(attributeName);
+	const u32 mask = HashTable.size()-1;
+	for (u32 slot = hash & mask; HashTable[slot] != -1; slot = (slot+1) & mask)
+	{
+		const s32 i = HashTable[slot];
+		if (NameHashes[i] == hash && Attributes[i]->Name == attributeName)
 			return i;
+	}
 
 	return -1;
 }
@@ -242,11 +317,8 @@ s32 CAttributes::findAttribute(const c8* attributeName) const
 
 IAttribute* CAttributes::getAttributeP(const c8* attributeName) const
 {
-	for (u32 i=0; i<Attributes.size(); ++i)
-		if (Attributes[i]->Name == attributeName)
-			return Attributes[i];
-
-	return 0;
+	const s32 i = findAttribute(attributeName);
+	return (i != -1) ? Attributes[i] : 0;
 }
 
 
@@ -258,7 +330,7 @@ void CAttributes::setAttribute(const c8* attributeName, bool value)
 		att->setBool(value);
 	else
 	{
-		Attributes.push_back(new CBoolAttribute(attributeName, value));
+		addAttributeP(new CBoolAttribute(attributeName, value));
 	}
 }
 
@@ -286,7 +358,7 @@ void CAttributes::setAttribute(const c8* attributeName, s32 value)
 		att->setInt(value);
 	else
 	{
-		Attributes.push_back(new CIntAttribute(attributeName, value));
+		addAttributeP(new CIntAttribute(attributeName, value));
 	}
 }
 
@@ -310,7 +382,7 @@ void CAttributes::setAttribute(const c8* attributeName, f32 value)
 	if (att)
 		att->setFloat(value);
 	else
-		Attributes.push_back(new CFloatAttribute(attributeName, value));
+		addAttributeP(new CFloatAttribute(attributeName, value));
 }
 
 //! Gets a attribute as integer value
@@ -333,7 +405,7 @@ void CAttributes::setAttribute(const c8* attributeName, video::SColor value)
 	if (att)
 		att->setColor(value);
 	else
-		Attributes.push_back(new CColorAttribute(attributeName, value));
+		addAttributeP(new CColorAttribute(attributeName, value));
 }
 
 //! Gets an attribute as color
@@ -357,7 +429,7 @@ void CAttributes::setAttribute(const c8* attributeName, video::SColorf value)
 	if (att)
 		att->setColor(value);
 	else
-		Attributes.push_back(new CColorfAttribute(attributeName, value));
+		addAttributeP(new CColorfAttribute(attributeName, value));
 }
 
 //! Gets an attribute as floating point color
@@ -379,7 +451,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::position2di value)
 	if (att)
 		att->setPosition(value);
 	else
-		Attributes.push_back(new CPosition2DAttribute(attributeName, value));
+		addAttributeP(new CPosition2DAttribute(attributeName, value));
 }
 
 //! Gets an attribute as 2d position
@@ -401,7 +473,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::rect<s32> value)
 	if (att)
 		att->setRect(value);
 	else
-		Attributes.push_back(new CRectAttribute(attributeName, value));
+		addAttributeP(new CRectAttribute(attributeName, value));
 }
 
 //! Gets an attribute as rectangle
@@ -423,7 +495,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::dimension2d<u32> v
 	if (att)
 		att->setDimension2d(value);
 	else
-		Attributes.push_back(new CDimension2dAttribute(attributeName, value));
+		addAttributeP(new CDimension2dAttribute(attributeName, value));
 }
 
 //! Gets an attribute as dimension2d
@@ -445,7 +517,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::vector3df value)
 	if (att)
 		att->setVector(value);
 	else
-		Attributes.push_back(new CVector3DAttribute(attributeName, value));
+		addAttributeP(new CVector3DAttribute(attributeName, value));
 }
 
 //! Sets a attribute as vector
@@ -455,7 +527,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::vector2df value)
 	if (att)
 		att->setVector2d(value);
 	else
-		Attributes.push_back(new CVector2DAttribute(attributeName, value));
+		addAttributeP(new CVector2DAttribute(attributeName, value));
 }
 
 //! Gets an attribute as vector
@@ -487,7 +559,7 @@ void CAttributes::setAttribute(const c8* attributeName, void* data, s32 dataSize
 	if (att)
 		att->setBinary(data, dataSizeInBytes);
 	else
-		Attributes.push_back(new CBinaryAttribute(attributeName, data, dataSizeInBytes));
+		addAttributeP(new CBinaryAttribute(attributeName, data, dataSizeInBytes));
 }
 
 //! Gets an attribute as binary data
@@ -506,7 +578,7 @@ void CAttributes::setAttribute(const c8* attributeName, const char* enumValue, c
 	if (att)
 		att->setEnum(enumValue, enumerationLiterals);
 	else
-		Attributes.push_back(new CEnumAttribute(attributeName, enumValue, enumerationLiterals));
+		addAttributeP(new CEnumAttribute(attributeName, enumValue, enumerationLiterals));
 }
 
 //! Gets an attribute as enumeration
@@ -557,7 +629,7 @@ void CAttributes::setAttribute(const c8* attributeName, video::ITexture* value,
 	if (att)
 		att->setTexture(value, filename);
 	else
-		Attributes.push_back(new CTextureAttribute(attributeName, value, Driver, filename));
+		addAttributeP(new CTextureAttribute(attributeName, value, Driver, filename));
 }
 
 
@@ -802,37 +874,37 @@ void CAttributes::getAttributeEnumerationLiteralsOfEnumeration(s32 index, core::
 //! Adds an attribute as integer
 void CAttributes::addInt(const c8* attributeName, s32 value)
 {
-	Attributes.push_back(new CIntAttribute(attributeName, value));
+	addAttributeP(new CIntAttribute(attributeName, value));
 }
 
 //! Adds an attribute as float
 void CAttributes::addFloat(const c8* attributeName, f32 value)
 {
-	Attributes.push_back(new CFloatAttribute(attributeName, value));
+	addAttributeP(new CFloatAttribute(attributeName, value));
 }
 
 //! Adds an attribute as string
 void CAttributes::addString(const c8* attributeName, const char* value)
 {
-	Attributes.push_back(new CStringAttribute(attributeName, value));
+	addAttributeP(new CStringAttribute(attributeName, value));
 }
 
 //! Adds an attribute as wchar string
 void CAttributes::addString(const c8* attributeName, const wchar_t* value)
 {
-	Attributes.push_back(new CStringAttribute(attributeName, value));
+	addAttributeP(new CStringAttribute(attributeName, value));
 }
 
 //! Adds an attribute as bool
 void CAttributes::addBool(const c8* attributeName, bool value)
 {
-	Attributes.push_back(new CBoolAttribute(attributeName, value));
+	addAttributeP(new CBoolAttribute(attributeName, value));
 }
 
 //! Adds an attribute as enum
 void CAttributes::addEnum(const c8* attributeName, const char* enumValue, const char* const* enumerationLiterals)
 {
-	Attributes.push_back(new CEnumAttribute(attributeName, enumValue, enumerationLiterals));
+	addAttributeP(new CEnumAttribute(attributeName, enumValue, enumerationLiterals));
 }
 
 //! Adds an attribute as enum
@@ -845,56 +917,56 @@ void CAttributes::addEnum(const c8* attributeName, s32 enumValue, const char* co
 //! Adds an attribute as color
 void CAttributes::addColor(const c8* attributeName, video::SColor value)
 {
-	Attributes.push_back(new CColorAttribute(attributeName, value));
+	addAttributeP(new CColorAttribute(attributeName, value));
 }
 
 //! Adds an attribute as floating point color
 void CAttributes::addColorf(const c8* attributeName, video::SColorf value)
 {
-	Attributes.push_back(new CColorfAttribute(attributeName, value));
+	addAttributeP(new CColorfAttribute(attributeName, value));
 }
 
 //! Adds an attribute as 3d vector
 void CAttributes::addVector3d(const c8* attributeName, core::vector3df value)
 {
-	Attributes.push_back(new CVector3DAttribute(attributeName, value));
+	addAttributeP(new CVector3DAttribute(attributeName, value));
 }
 
 //! Adds an attribute as 2d vector
 void CAttributes::addVector2d(const c8* attributeName, core::vector2df value)
 {
-	Attributes.push_back(new CVector2DAttribute(attributeName, value));
+	addAttributeP(new CVector2DAttribute(attributeName, value));
 }
 
 
 //! Adds an attribute as 2d position
 void CAttributes::addPosition2d(const c8* attributeName, core::position2di value)
 {
-	Attributes.push_back(new CPosition2DAttribute(attributeName, value));
+	addAttributeP(new CPosition2DAttribute(attributeName, value));
 }
 
 //! Adds an attribute as rectangle
 void CAttributes::addRect(const c8* attributeName, core::rect<s32> value)
 {
-	Attributes.push_back(new CRectAttribute(attributeName, value));
+	addAttributeP(new CRectAttribute(attributeName, value));
 }
 
 //! Adds an attribute as dimension2d
 void CAttributes::addDimension2d(const c8* attributeName, core::dimension2d<u32> value)
 {
-	Attributes.push_back(new CDimension2dAttribute(attributeName, value));
+	addAttributeP(new CDimension2dAttribute(attributeName, value));
 }
 
 //! Adds an attribute as binary data
 void CAttributes::addBinary(const c8* attributeName, void* data, s32 dataSizeInBytes)
 {
-	Attributes.push_back(new CBinaryAttribute(attributeName, data, dataSizeInBytes));
+	addAttributeP(new CBinaryAttribute(attributeName, data, dataSizeInBytes));
 }
 
 //! Adds an attribute as texture reference
 void CAttributes::addTexture(const c8* attributeName, video::ITexture* texture, const io::path& filename)
 {
-	Attributes.push_back(new CTextureAttribute(attributeName, texture, Driver, filename));
+	addAttributeP(new CTextureAttribute(attributeName, texture, Driver, filename));
 }
 
 //! Returns if an attribute with a name exists
@@ -1016,7 +1088,7 @@ void CAttributes::setAttribute(s32 index, video::ITexture* texture, const io::pa
 //! Adds an attribute as matrix
 void CAttributes::addMatrix(const c8* attributeName, const core::matrix4& v)
 {
-	Attributes.push_back(new CMatrixAttribute(attributeName, v));
+	addAttributeP(new CMatrixAttribute(attributeName, v));
 }
 
 
@@ -1027,7 +1099,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::matrix4& v)
 	if (att)
 		att->setMatrix(v);
 	else
-		Attributes.push_back(new CMatrixAttribute(attributeName, v));
+		addAttributeP(new CMatrixAttribute(attributeName, v));
 }
 
 //! Gets an attribute as a matrix4
@@ -1061,7 +1133,7 @@ void CAttributes::setAttribute(s32 index, const core::matrix4& v)
 //! Adds an attribute as quaternion
 void CAttributes::addQuaternion(const c8* attributeName, core::quaternion v)
 {
-	Attributes.push_back(new CQuaternionAttribute(attributeName, v));
+	addAttributeP(new CQuaternionAttribute(attributeName, v));
 }
 
 
@@ -1073,7 +1145,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::quaternion v)
 		att->setQuaternion(v);
 	else
 	{
-		Attributes.push_back(new CQuaternionAttribute(attributeName, v));
+		addAttributeP(new CQuaternionAttribute(attributeName, v));
 	}
 }
 
@@ -1110,7 +1182,7 @@ if (index >= 0 && index < (s32)Attributes.size() )
 //! Adds an attribute as axis aligned bounding box
 void CAttributes::addBox3d(const c8* attributeName, core::aabbox3df v)
 {
-	Attributes.push_back(new CBBoxAttribute(attributeName, v));
+	addAttributeP(new CBBoxAttribute(attributeName, v));
 }
 
 //! Sets an attribute as axis aligned bounding box
@@ -1121,7 +1193,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::aabbox3df v)
 		att->setBBox(v);
 	else
 	{
-		Attributes.push_back(new CBBoxAttribute(attributeName, v));
+		addAttributeP(new CBBoxAttribute(attributeName, v));
 	}
 }
 
@@ -1158,7 +1230,7 @@ if (index >= 0 && index < (s32)Attributes.size() )
 //! Adds an attribute as 3d plane
 void CAttributes::addPlane3d(const c8* attributeName, core::plane3df v)
 {
-	Attributes.push_back(new CPlaneAttribute(attributeName, v));
+	addAttributeP(new CPlaneAttribute(attributeName, v));
 }
 
 //! Sets an attribute as 3d plane
@@ -1169,7 +1241,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::plane3df v)
 		att->setPlane(v);
 	else
 	{
-		Attributes.push_back(new CPlaneAttribute(attributeName, v));
+		addAttributeP(new CPlaneAttribute(attributeName, v));
 	}
 }
 
@@ -1206,7 +1278,7 @@ void CAttributes::setAttribute(s32 index, core::plane3df v)
 //! Adds an attribute as 3d triangle
 void CAttributes::addTriangle3d(const c8* attributeName, core::triangle3df v)
 {
-	Attributes.push_back(new CTriangleAttribute(attributeName, v));
+	addAttributeP(new CTriangleAttribute(attributeName, v));
 }
 
 //! Sets an attribute as 3d triangle
@@ -1217,7 +1289,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::triangle3df v)
 		att->setTriangle(v);
 	else
 	{
-		Attributes.push_back(new CTriangleAttribute(attributeName, v));
+		addAttributeP(new CTriangleAttribute(attributeName, v));
 	}
 }
 
@@ -1256,7 +1328,7 @@ void CAttributes::setAttribute(s32 index, core::triangle3df v)
 //! Adds an attribute as a 2d line
 void CAttributes::addLine2d(const c8* attributeName, core::line2df v)
 {
-	Attributes.push_back(new CLine2dAttribute(attributeName, v));
+	addAttributeP(new CLine2dAttribute(attributeName, v));
 }
 
 //! Sets an attribute as a 2d line
@@ -1267,7 +1339,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::line2df v)
 		att->setLine2d(v);
 	else
 	{
-		Attributes.push_back(new CLine2dAttribute(attributeName, v));
+		addAttributeP(new CLine2dAttribute(attributeName, v));
 	}
 }
 
@@ -1304,7 +1376,7 @@ void CAttributes::setAttribute(s32 index, core::line2df v)
 //! Adds an attribute as a 3d line
 void CAttributes::addLine3d(const c8* attributeName, core::line3df v)
 {
-	Attributes.push_back(new CLine3dAttribute(attributeName, v));
+	addAttributeP(new CLine3dAttribute(attributeName, v));
 }
 
 //! Sets an attribute as a 3d line
@@ -1315,7 +1387,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::line3df v)
 		att->setLine3d(v);
 	else
 	{
-		Attributes.push_back(new CLine3dAttribute(attributeName, v));
+		addAttributeP(new CLine3dAttribute(attributeName, v));
 	}
 }
 
@@ -1354,7 +1426,7 @@ void CAttributes::setAttribute(s32 index, core::line3df v)
 //! Adds an attribute as user pointner
 void CAttributes::addUserPointer(const c8* attributeName, void* userPointer)
 {
-	Attributes.push_back(new CUserPointerAttribute(attributeName, userPointer));
+	addAttributeP(new CUserPointerAttribute(attributeName, userPointer));
 }
 
 //! Sets an attribute as user pointer
@@ -1365,7 +1437,7 @@ void CAttributes::setAttribute(const c8* attributeName, void* userPointer)
 		att->setUserPointer(userPointer);
 	else
 	{
-		Attributes.push_back(new CUserPointerAttribute(attributeName, userPointer));
+		addAttributeP(new CUserPointerAttribute(attributeName, userPointer));
 	}
 }
 
@@ -1446,126 +1518,127 @@ bool CAttributes::read(io::IXMLReader* reader, bool readCurrentElementOnly,
 void CAttributes::readAttributeFromXML(io::IXMLReader* reader)
 {
 	core::stringw element = reader->getNodeName();
-	core::stringc name = reader->getAttributeValue(L"name");
+	core::stringc name = reader->getAttributeValue(reader->getAttributeIndex(L"name", XMLNameHash));
+	const wchar_t* value = reader->getAttributeValue(reader->getAttributeIndex(L"value", XMLValueHash));
 
 	if (element == L"enum")
 	{
 		addEnum(name.c_str(), 0, 0);
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"binary")
 	{
 		addBinary(name.c_str(), 0, 0);
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"color")
 	{
 		addColor(name.c_str(), video::SColor());
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"colorf")
 	{
 		addColorf(name.c_str(), video::SColorf());
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"float")
 	{
 		addFloat(name.c_str(), 0);
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"int")
 	{
 		addInt(name.c_str(), 0);
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"bool")
 	{
 		addBool(name.c_str(), 0);
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"string")
 	{
 		addString(name.c_str(), L"");
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"texture")
 	{
 		addTexture(name.c_str(), 0);
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"vector3d")
 	{
 		addVector3d(name.c_str(), core::vector3df());
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"vector2d")
 	{
 		addVector2d(name.c_str(), core::vector2df());
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"position")
 	{
 		addPosition2d(name.c_str(), core::position2di());
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"rect")
 	{
 		addRect(name.c_str(), core::rect<s32>());
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"matrix")
 	{
 		addMatrix(name.c_str(), core::matrix4());
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"quaternion")
 	{
 		addQuaternion(name.c_str(), core::quaternion());
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"box3d")
 	{
 		addBox3d(name.c_str(), core::aabbox3df());
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"plane")
 	{
 		addPlane3d(name.c_str(), core::plane3df());
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"triangle")
 	{
 		addTriangle3d(name.c_str(), core::triangle3df());
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"line2d")
 	{
 		addLine2d(name.c_str(), core::line2df());
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"line3d")
 	{
 		addLine3d(name.c_str(), core::line3df());
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 	else
 	if (element == L"stringwarray")
@@ -1591,7 +1664,7 @@ void CAttributes::readAttributeFromXML(io::IXMLReader* reader)
 	if (element == L"dimension2d")
 	{
 		addDimension2d(name.c_str(), core::dimension2d<u32>());
-		Attributes.getLast()->setString(reader->getAttributeValue(L"value"));
+		Attributes.getLast()->setString(value);
 	}
 }
 
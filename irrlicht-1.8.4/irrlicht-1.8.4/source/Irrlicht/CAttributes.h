@@ -54,8 +54,16 @@ public:
 	virtual bool existsAttribute(const c8* attributeName);
 
 	//! Returns attribute index from name, -1 if not found
+	/** Names are looked up in a hash table, so this doesn't depend on the
+	amount of attributes. The index stays valid until an attribute is
+	removed or clear() is called, which can be detected with
+	getIndexRevision(). So for attributes accessed very often it is
+	cheapest to look up the index once and use the index based methods. */
 	virtual s32 findAttribute(const c8* attributeName) const;
 
+	//! Returns a number which changes whenever indices of existing attributes become invalid
+	u32 getIndexRevision() const { return IndexRevision; }
+
 	//! Removes all attributes
 	virtual void clear();
 
@@ -702,6 +710,27 @@ protected:
 
 	IAttribute* getAttributeP(const c8* attributeName) const;
 
+	//! Adds an attribute and registers it in the hash table
+	void addAttributeP(IAttribute* attribute);
+
+	//! Removes the attribute at index and rebuilds the hash table
+	void removeAttributeP(u32 index);
+
+	//! Registers the attribute at index in the hash table
+	void insertHashP(u32 index);
+
+	//! Rebuilds the hash table from the attribute list
+	void rebuildHashTable();
+
+	//! Hashes of the attribute names, same order as Attributes
+	core::array<u32> NameHashes;
+
+	//! Open addressing table of indices into Attributes, -1 for empty slots
+	core::array<s32> HashTable;
+
+	//! Changes whenever indices of existing attributes change
+	u32 IndexRevision;
+
 	video::IVideoDriver* Driver;
 };
 
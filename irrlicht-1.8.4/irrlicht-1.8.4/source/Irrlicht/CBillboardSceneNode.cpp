@@ -32,16 +32,11 @@ CBillboardSceneNode::CBillboardSceneNode(ISceneNode* parent, ISceneManager* mgr,
 	indices[4] = 3;
 	indices[5] = 2;
 
-	vertices[0].TCoords.set(1.0f, 1.0f);
-	vertices[0].Color = colorBottom;
+	setTextureRect(core::rect<f32>(0.0f, 0.0f, 1.0f, 1.0f));
 
-	vertices[1].TCoords.set(1.0f, 0.0f);
+	vertices[0].Color = colorBottom;
 	vertices[1].Color = colorTop;
-
-	vertices[2].TCoords.set(0.0f, 0.0f);
 	vertices[2].Color = colorTop;
-
-	vertices[3].TCoords.set(0.0f, 1.0f);
 	vertices[3].Color = colorBottom;
 }
 
@@ -209,6 +204,8 @@ void CBillboardSceneNode::serializeAttributes(io::IAttributes* out, io::SAttribu
 	out->addFloat("Height", Size.Height);
 	out->addColor("Shade_Top", vertices[1].Color);
 	out->addColor("Shade_Down", vertices[0].Color);
+	out->addVector2d("TextureRectUpperLeft", TextureRect.UpperLeftCorner);
+	out->addVector2d("TextureRectLowerRight", TextureRect.LowerRightCorner);
 }
 
 
@@ -232,6 +229,10 @@ void CBillboardSceneNode::deserializeAttributes(io::IAttributes* in, io::SAttrib
 	vertices[0].Color = in->getAttributeAsColor("Shade_Down");
 	vertices[2].Color = vertices[1].Color;
 	vertices[3].Color = vertices[0].Color;
+
+	if (in->existsAttribute("TextureRectUpperLeft"))
+		setTextureRect(core::rect<f32>(in->getAttributeAsVector2d("TextureRectUpperLeft"),
+			in->getAttributeAsVector2d("TextureRectLowerRight")));
 }
 
 
@@ -268,6 +269,25 @@ void CBillboardSceneNode::getColor(video::SColor& topColor,
 }
 
 
+//! Sets the part of the texture shown on the billboard
+void CBillboardSceneNode::setTextureRect(const core::rect<f32>& rect)
+{
+	TextureRect = rect;
+
+	vertices[0].TCoords.set(rect.LowerRightCorner.X, rect.LowerRightCorner.Y);
+	vertices[1].TCoords.set(rect.LowerRightCorner.X, rect.UpperLeftCorner.Y);
+	vertices[2].TCoords.set(rect.UpperLeftCorner.X, rect.UpperLeftCorner.Y);
+	vertices[3].TCoords.set(rect.UpperLeftCorner.X, rect.LowerRightCorner.Y);
+}
+
+
+//! Gets the part of the texture shown on the billboard
+const core::rect<f32>& CBillboardSceneNode::getTextureRect() const
+{
+	return TextureRect;
+}
+
+
 //! Creates a clone of this scene node and its children.
 ISceneNode* CBillboardSceneNode::clone(ISceneNode* newParent, ISceneManager* newManager)
 {
@@ -282,6 +302,7 @@ ISceneNode* CBillboardSceneNode::clone(ISceneNode* newParent, ISceneManager* new
 	nb->cloneMembers(this, newManager);
 	nb->Material = Material;
 	nb->TopEdgeWidth = this->TopEdgeWidth;
+	nb->setTextureRect(TextureRect);
 
 	if ( newParent )
 		nb->drop();
@@ -67,6 +67,12 @@ public:
 	virtual void getColor(video::SColor& topColor,
 			video::SColor& bottomColor) const;
 
+	//! Sets the part of the texture shown on the billboard
+	virtual void setTextureRect(const core::rect<f32>& rect);
+
+	//! Gets the part of the texture shown on the billboard
+	virtual const core::rect<f32>& getTextureRect() const;
+
 	//! Writes attributes of the scene node.
 	virtual void serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options=0) const;
 
@@ -84,6 +90,7 @@ private:
 	//! Size.Width is the bottom edge width
 	core::dimension2d<f32> Size;
 	f32 TopEdgeWidth;
+	core::rect<f32> TextureRect;
 	core::aabbox3d<f32> BBox;
 	video::SMaterial Material;
 
@@ -86,7 +86,7 @@ void CBoneSceneNode::OnAnimate(u32 timeMs)
 
 void CBoneSceneNode::helper_updateAbsolutePositionOfAllChildren(ISceneNode *Node)
 {
-	Node->updateAbsolutePosition();
+	Node->updateAbsolutePositionAndRevision();
 
 	ISceneNodeList::ConstIterator it = Node->getChildren().begin();
 	for (; it != Node->getChildren().end(); ++it)
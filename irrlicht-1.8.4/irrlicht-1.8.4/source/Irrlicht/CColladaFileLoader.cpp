@@ -126,6 +126,73 @@ namespace
 
 	// We have to read ambient lights like other light types here, so we need a type for it
 	const video::E_LIGHT_TYPE ELT_AMBIENT = video::E_LIGHT_TYPE(video::ELT_COUNT+1);
+
+	//! Indices of a primitive corner into the sources of its inputs
+	/** Used to find the vertex of a corner without building it again, for
+	primitives with up to MAX_INDICES indices per corner. */
+	struct SColladaCorner
+	{
+		enum { MAX_INDICES = 4 };
+
+		SColladaCorner(const s32* indices, u32 count)
+		{
+			for (u32 i=0; i<MAX_INDICES; ++i)
+				Index[i] = (i<count) ? indices[i] : 0;
+		}
+
+		bool operator==(const SColladaCorner& other) const
+		{
+			return (Index[0] == other.Index[0]) && (Index[1] == other.Index[1]) &&
+				(Index[2] == other.Index[2]) && (Index[3] == other.Index[3]);
+		}
+
+		u32 hash() const
+		{
+			u32 h = 0;
+			for (u32 i=0; i<MAX_INDICES; ++i)
+				h = core::hash_integer(h ^ (u32)Index[i]);
+			return h;
+		}
+
+		s32 Index[MAX_INDICES];
+	};
+
+	//! Adds a vertex to a mesh buffer, unless the buffer contains the same vertex already
+	template <class T>
+	u16 addColladaVertex(CMeshBuffer<T>* buffer, core::hash_map<T, u16>& vertMap, const T& vtx)
+	{
+		//first, try to find this vertex in the mesh
+		const typename core::hash_map<T, u16>::Node* n = vertMap.find(vtx);
+		if (n)
+			return n->getValue();
+
+		const u16 index = (u16)buffer->Vertices.size();
+		buffer->Vertices.push_back(vtx);
+		vertMap.insert(vtx, index);
+		return index;
+	}
+
+	//! Triangulates a polygon
+	/** We naively interpret polygons of 4 or more vertices as a triangle
+	fan, as full tesselation is problematic. */
+	void addColladaFan(core::array<u16>& indices, const core::array<u16>& polygon, bool flip)
+	{
+		for (u32 i=0; i+2<polygon.size(); ++i)
+		{
+			if (flip)
+			{
+				indices.push_back(polygon[i+2]);
+				indices.push_back(polygon[i+1]);
+				indices.push_back(polygon[0]);
+			}
+			else
+			{
+				indices.push_back(polygon[0]);
+				indices.push_back(polygon[i+1]);
+				indices.push_back(polygon[i+2]);
+			}
+		}
+	}
 }
 
 	//! following class is for holding and creating instances of library
@@ -202,10 +269,11 @@ namespace
 	{
 	public:
 
-		CGeometryPrefab(const core::stringc& id) : CPrefab(id)
+		CGeometryPrefab(const core::stringc& id) : CPrefab(id), Mesh(0)
 		{
 		}
 
+		//! shared by all instances of the geometry
 		scene::IMesh* Mesh;
 
 		//! creates an instance of this prefab
@@ -296,7 +364,7 @@ namespace
 			{
 				s->setName(getId());
 				s->getRelativeTransformationMatrix() = Transformation;
-				s->updateAbsolutePosition();
+				s->updateAbsolutePositionAndRevision();
 				core::stringc t;
 				for (u32 i=0; i<16; ++i)
 				{
@@ -847,7 +915,7 @@ void CColladaFileLoader::readNodeSection(io::IXMLReaderUTF8* reader, scene::ISce
 		node->setPosition(transform.getTranslation());
 		node->setRotation(transform.getRotationDegrees());
 		node->setScale(transform.getScale());
-		node->updateAbsolutePosition();
+		node->updateAbsolutePositionAndRevision();
 
 		node->setName(name);
 	}
@@ -1637,10 +1705,14 @@ void CColladaFileLoader::readBindMaterialSection(io::IXMLReaderUTF8* reader, con
 #ifdef COLLADA_READER_DEBUG
 				os::Printer::log((core::stringc("Material binding: ")+meshbufferReference+" "+target).c_str(), ELL_DEBUG);
 #endif
-				if (MaterialsToBind.find(meshbufferReference))
+				// instances of a geometry share its mesh, so binding the same
+				// material once more would only repeat the work
+				const core::hash_map<core::stringc,u32>::Node* bind = MaterialsToBind.find(meshbufferReference);
+				if (bind && BoundMaterials[bind->getValue()] != material->Id)
 				{
+					BoundMaterials[bind->getValue()] = material->Id;
 					core::array<irr::scene::IMeshBuffer*> & toBind
-						= MeshesToBind[MaterialsToBind[meshbufferReference]];
+						= MeshesToBind[bind->getValue()];
 #ifdef COLLADA_READER_DEBUG
 				os::Printer::log("Material binding now ",material->Id.c_str(), ELL_DEBUG);
 				os::Printer::log("#meshbuffers",core::stringc(toBind.size()).c_str(), ELL_DEBUG);
@@ -1687,7 +1759,9 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 	SAnimatedMesh* amesh = new SAnimatedMesh();
 	scene::SMesh* mesh = new SMesh();
 	amesh->addMesh(mesh);
-	core::array<SSource> sources;
+	// a list, so the arrays read already are not copied when another source is added
+	core::list<SSource> sources;
+	SSource* source = 0;
 	bool okToReadArray = false;
 
 	// handles geometry node and the mesh children in this loop
@@ -1707,29 +1781,30 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 			{
 				// create a new source
 				sources.push_back(SSource());
-				sources.getLast().Id = readId(reader);
+				source = &(*sources.getLast());
+				source->Id = readId(reader);
 
 				#ifdef COLLADA_READER_DEBUG
-				os::Printer::log("Reading source", sources.getLast().Id.c_str(), ELL_DEBUG);
+				os::Printer::log("Reading source", source->Id.c_str(), ELL_DEBUG);
 				#endif
 			}
 			else
 			if (arraySectionName == nodeName || floatArraySectionName == nodeName || intArraySectionName == nodeName)
 			{
 				// create a new array and read it.
-				if (!sources.empty())
+				if (source)
 				{
-					sources.getLast().Array.Name = readId(reader);
+					source->Array.Name = readId(reader);
 
-					int count = reader->getAttributeValueAsInt("count");
-					sources.getLast().Array.Data.set_used(count); // pre allocate
+					const int count = reader->getAttributeValueAsInt("count");
+					source->Array.Data.set_used(core::max_(count, 0)); // pre allocate
 
 					// check if type of array is ok
 					const char* type = reader->getAttributeValue("type");
 					okToReadArray = (type && (!strcmp("float", type) || !strcmp("int", type))) || floatArraySectionName == nodeName || intArraySectionName == nodeName;
 
 					#ifdef COLLADA_READER_DEBUG
-					os::Printer::log("Read array", sources.getLast().Array.Name.c_str(), ELL_DEBUG);
+					os::Printer::log("Read array", source->Array.Name.c_str(), ELL_DEBUG);
 					#endif
 				}
 				#ifdef COLLADA_READER_DEBUG
@@ -1755,10 +1830,10 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 				// the accessor contains some information on how to access (boi!) the array,
 				// the info is stored in collada style parameters, so just read them.
 				readColladaParameters(reader, accessorSectionName);
-				if (!sources.empty())
+				if (source)
 				{
-					sources.getLast().Accessors.push_back(accessor);
-					sources.getLast().Accessors.getLast().Parameters = ColladaParameters;
+					source->Accessors.push_back(accessor);
+					source->Accessors.getLast().Parameters = ColladaParameters;
 				}
 			}
 			else
@@ -1807,13 +1882,12 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 		else
 		if (reader->getNodeType() == io::EXN_TEXT)
 		{
-			// read array data
-			if (okToReadArray && !sources.empty())
+			// read array data, right from the text of the xml reader, as
+			// the arrays of big files are much too large for another copy
+			if (okToReadArray && source)
 			{
-				core::array<f32>& a = sources.getLast().Array.Data;
-				core::stringc data = reader->getNodeData();
-				data.trim();
-				const c8* p = &data[0];
+				core::array<f32>& a = source->Array.Data;
+				const c8* p = reader->getNodeData();
 
 				for (u32 i=0; i<a.size(); ++i)
 				{
@@ -1892,14 +1966,13 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 }
 
 
-struct SPolygon
-{
-	core::array<s32> Indices;
-};
-
-//! reads a polygons section and creates a mesh from it
+//! reads a polygons section and creates mesh buffers from it
+/** The primitives are converted into vertices while their text is parsed,
+so the indices of a section are never stored. Corners with the same input
+indices are looked up in a hash map, and equal vertices are shared. Another
+mesh buffer is started when the 16 bit indices of the current one run out. */
 void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
-		core::array<SSource>& sources, scene::SMesh* mesh,
+		core::list<SSource>& sources, scene::SMesh* mesh,
 		const core::stringc& geometryId)
 {
 	#ifdef COLLADA_READER_DEBUG
@@ -1909,18 +1982,43 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 	core::stringc materialName = reader->getAttributeValue("material");
 
 	core::stringc polygonType = reader->getNodeName();
-	const int polygonCount = reader->getAttributeValueAsInt("count"); // Not useful because it only determines the number of primitives, which have arbitrary vertices in case of polygon
-	core::array<SPolygon> polygons;
-	if (polygonType == polygonsSectionName)
-		polygons.reallocate(polygonCount);
-	core::array<int> vCounts;
+	const bool isPolygons = (polygonType == polygonsSectionName);
+	core::array<s32> vCounts;
 	bool parsePolygonOK = false;
 	bool parseVcountOK = false;
-	u32 inputSemanticCount = 0;
-	bool unresolvedInput=false;
+	bool inputsResolved = false;
 	u32 maxOffset = 0;
 	core::array<SColladaInput> localInputs;
 
+	// analyze content of Inputs to create a fitting mesh buffer
+	// if there is more than one texture coordinate set, create a lightmap mesh buffer,
+	// otherwise use a standard mesh buffer
+
+	u32 textureCoordSetCount = 0;
+	bool normalSlotCount = false;
+
+	for (u32 u=0; u<Inputs.size(); ++u)
+	{
+		if (Inputs[u].Semantic == ECIS_TEXCOORD || Inputs[u].Semantic == ECIS_UV )
+			++textureCoordSetCount;
+		else
+		if (Inputs[u].Semantic == ECIS_NORMAL)
+			normalSlotCount=true;
+	}
+
+	const bool useLightMap = (textureCoordSetCount >= 2);
+	s32 secondTexCoordInput = -1;
+
+	scene::SMeshBuffer* buffer = 0;
+	scene::SMeshBufferLightMap* lightMapBuffer = 0;
+	core::hash_map<video::S3DVertex, u16> vertMap;
+	core::hash_map<video::S3DVertex2TCoords, u16> lightMapVertMap;
+	core::hash_map<SColladaCorner, u16> cornerMap;
+
+	// input indices and vertices of the primitive being read
+	core::array<s32> corners;
+	core::array<u16> polygon;
+
 	// read all <input> and primitives
 	if (!reader->isEmptyElement())
 	while(reader->read())
@@ -1937,29 +2035,30 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 
 				// resolve input source
 				SColladaInput& inp = localInputs.getLast();
+				const u32 offset = inp.Offset;
+				maxOffset = core::max_(maxOffset,offset);
 
 				// get input source array id, if it is a vertex input, take
 				// the <vertex><input>-source attribute.
+				if (inp.Semantic == ECIS_VERTEX && !Inputs.empty())
+					inp.Source = Inputs[0].Source;
+				uriToId(inp.Source);
+
 				if (inp.Semantic == ECIS_VERTEX)
 				{
-					inp.Source = Inputs[0].Source;
 					for (u32 i=1; i<Inputs.size(); ++i)
 					{
+						// the other inputs of <vertices> use the indices of the vertex input
 						localInputs.push_back(Inputs[i]);
+						localInputs.getLast().Offset = offset;
 						uriToId(localInputs.getLast().Source);
-						maxOffset = core::max_(maxOffset,localInputs.getLast().Offset);
-						++inputSemanticCount;
 					}
 				}
-				uriToId(inp.Source);
-				maxOffset = core::max_(maxOffset,inp.Offset);
-				++inputSemanticCount;
 			}
 			else
 			if (primitivesName == nodeName)
 			{
 				parsePolygonOK = true;
-				polygons.push_back(SPolygon());
 			}
 			else
 			if (vcountName == nodeName)
@@ -1985,359 +2084,245 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 		{
 			if (parseVcountOK)
 			{
-				core::stringc data = reader->getNodeData();
-				data.trim();
-				const c8* p = &data[0];
+				const c8* p = reader->getNodeData();
+				findNextNoneWhiteSpace(&p);
 				while(*p)
 				{
+					vCounts.push_back(readInt(&p));
 					findNextNoneWhiteSpace(&p);
-					if (*p)
-						vCounts.push_back(readInt(&p));
 				}
 				parseVcountOK = false;
 			}
 			else
-			if (parsePolygonOK && polygons.size())
+			if (parsePolygonOK)
 			{
-				core::stringc data = reader->getNodeData();
-				data.trim();
-				const c8* p = &data[0];
-				SPolygon& poly = polygons.getLast();
-				if (polygonType == polygonsSectionName)
-					poly.Indices.reallocate((maxOffset+1)*3);
-				else
-					poly.Indices.reallocate(polygonCount*(maxOffset+1)*3);
+				parsePolygonOK = false;
+				if (localInputs.empty())
+					continue;
 
-				if (vCounts.empty())
+				if (!inputsResolved)
 				{
-					while(*p)
+					// find source array (we'll ignore accessors for this implementation)
+					u32 textureCoordInputs = 0;
+					for (u32 i=0; i<localInputs.size(); ++i)
 					{
-						findNextNoneWhiteSpace(&p);
-						poly.Indices.push_back(readInt(&p));
-					}
-				}
-				else
-				{
-					for (u32 i = 0; i < vCounts.size(); i++)
-					{
-						const int polyVCount = vCounts[i];
-						core::array<int> polyCorners;
-
-						for (u32 j = 0; j < polyVCount * inputSemanticCount; j++)
-						{
-							if (!*p)
-								break;
-							findNextNoneWhiteSpace(&p);
-							polyCorners.push_back(readInt(&p));
-						}
-
-						while (polyCorners.size() >= 3 * inputSemanticCount)
+						SColladaInput& inp = localInputs[i];
+						core::list<SSource>::Iterator s = sources.begin();
+						for (; s != sources.end(); ++s)
 						{
-							// add one triangle's worth of indices
-							for (u32 k = 0; k < inputSemanticCount * 3; ++k)
+							if ((*s).Id == inp.Source)
 							{
-								poly.Indices.push_back(polyCorners[k]);
+								// slot found
+								inp.Data = (*s).Array.Data.pointer();
+								inp.DataSize = (*s).Array.Data.size();
+								if (!(*s).Accessors.empty())
+									inp.Stride = (*s).Accessors[0].Stride;
+								break;
 							}
-
-							// remove one corner from our poly
-							polyCorners.erase(inputSemanticCount,inputSemanticCount);
 						}
-						polyCorners.clear();
-					}
-					vCounts.clear();
-				}
-				parsePolygonOK = false;
-			}
-		}
-	} // end while reader->read()
-
-	// find source array (we'll ignore accessors for this implementation)
-	for (u32 i=0; i<localInputs.size(); ++i)
-	{
-		SColladaInput& inp = localInputs[i];
-		u32 s;
-		for (s=0; s<sources.size(); ++s)
-		{
-			if (sources[s].Id == inp.Source)
-			{
-				// slot found
-				inp.Data = sources[s].Array.Data.pointer();
-				inp.Stride = sources[s].Accessors[0].Stride;
-				break;
-			}
-		}
-
-		if (s == sources.size())
-		{
-			os::Printer::log("COLLADA Warning, polygon input source not found",
-				inp.Source.c_str(), ELL_DEBUG);
-			inp.Semantic=ECIS_COUNT; // for unknown
-			unresolvedInput=true;
-		}
-		else
-		{
-			#ifdef COLLADA_READER_DEBUG
-			// print slot
-			core::stringc tmp = "Added slot ";
-			tmp += inputSemanticNames[inp.Semantic];
-			tmp += " sourceArray:";
-			tmp += inp.Source;
-			os::Printer::log(tmp.c_str(), ELL_DEBUG);
-			#endif
-		}
-	}
-
-	if ((inputSemanticCount == 0) || !polygons.size())
-		return; // cancel if there are no polygons anyway.
-
-	// analyze content of Inputs to create a fitting mesh buffer
-
-	u32 u;
-	u32 textureCoordSetCount = 0;
-	bool normalSlotCount = false;
-	u32 secondTexCoordSetIndex = 0xFFFFFFFF;
-
-	for (u=0; u<Inputs.size(); ++u)
-	{
-		if (Inputs[u].Semantic == ECIS_TEXCOORD || Inputs[u].Semantic == ECIS_UV )
-		{
-			++textureCoordSetCount;
-
-			if (textureCoordSetCount==2)
-				secondTexCoordSetIndex = u;
-		}
-		else
-		if (Inputs[u].Semantic == ECIS_NORMAL)
-			normalSlotCount=true;
-	}
-
-	// if there is more than one texture coordinate set, create a lightmap mesh buffer,
-	// otherwise use a standard mesh buffer
-
-	scene::IMeshBuffer* buffer = 0;
-	++maxOffset; // +1 to jump to the next value
-
-	if ( textureCoordSetCount < 2 )
-	{
-		// standard mesh buffer
-
-		scene::SMeshBuffer* mbuffer = new SMeshBuffer();
-		buffer = mbuffer;
-
-		core::map<video::S3DVertex, int> vertMap;
-
-		for (u32 i=0; i<polygons.size(); ++i)
-		{
-			core::array<u16> indices;
-			const u32 vertexCount = polygons[i].Indices.size() / maxOffset;
-			mbuffer->Vertices.reallocate(mbuffer->Vertices.size()+vertexCount);
-
-			// for all index/semantic groups
-			for (u32 v=0; v<polygons[i].Indices.size(); v+=maxOffset)
-			{
-				video::S3DVertex vtx;
-				vtx.Color.set(255,255,255,255);
 
-				// for all input semantics
-				for (u32 k=0; k<localInputs.size(); ++k)
-				{
-					if (!localInputs[k].Data)
-						continue;
-					// build vertex from input semantics.
-
-					const u32 idx = localInputs[k].Stride*polygons[i].Indices[v+localInputs[k].Offset];
-
-					switch(localInputs[k].Semantic)
-					{
-					case ECIS_POSITION:
-					case ECIS_VERTEX:
-						vtx.Pos.X = localInputs[k].Data[idx+0];
-						if (FlipAxis)
+						if (s == sources.end())
 						{
-							vtx.Pos.Z = localInputs[k].Data[idx+1];
-							vtx.Pos.Y = localInputs[k].Data[idx+2];
+							os::Printer::log("COLLADA Warning, polygon input source not found",
+								inp.Source.c_str(), ELL_DEBUG);
+							inp.Semantic=ECIS_COUNT; // for unknown
 						}
 						else
 						{
-							vtx.Pos.Y = localInputs[k].Data[idx+1];
-							vtx.Pos.Z = localInputs[k].Data[idx+2];
-						}
-						break;
-					case ECIS_NORMAL:
-						vtx.Normal.X = localInputs[k].Data[idx+0];
-						if (FlipAxis)
-						{
-							vtx.Normal.Z = localInputs[k].Data[idx+1];
-							vtx.Normal.Y = localInputs[k].Data[idx+2];
+							#ifdef COLLADA_READER_DEBUG
+							// print slot
+							core::stringc tmp = "Added slot ";
+							tmp += inputSemanticNames[inp.Semantic];
+							tmp += " sourceArray:";
+							tmp += inp.Source;
+							os::Printer::log(tmp.c_str(), ELL_DEBUG);
+							#endif
 						}
-						else
+
+						if (inp.Semantic == ECIS_TEXCOORD || inp.Semantic == ECIS_UV)
 						{
-							vtx.Normal.Y = localInputs[k].Data[idx+1];
-							vtx.Normal.Z = localInputs[k].Data[idx+2];
+							if (++textureCoordInputs == 2 && useLightMap)
+								secondTexCoordInput = i;
 						}
-						break;
-					case ECIS_TEXCOORD:
-					case ECIS_UV:
-						vtx.TCoords.X = localInputs[k].Data[idx+0];
-						vtx.TCoords.Y = 1-localInputs[k].Data[idx+1];
-						break;
-					case ECIS_TANGENT:
-						break;
-					default:
-						break;
 					}
+					inputsResolved = true;
 				}
 
-				//first, try to find this vertex in the mesh
-				core::map<video::S3DVertex, int>::Node* n = vertMap.find(vtx);
-				if (n)
-				{
-					indices.push_back(n->getValue());
-				}
-				else
-				{
-					indices.push_back(mbuffer->getVertexCount());
-					mbuffer->Vertices.push_back(vtx);
-					vertMap.insert(vtx, mbuffer->getVertexCount()-1);
-				}
-			} // end for all vertices
+				const u32 stride = maxOffset + 1;
+				const c8* p = reader->getNodeData();
+				findNextNoneWhiteSpace(&p);
 
-			if (polygonsSectionName == polygonType &&
-				indices.size() > 3)
-			{
-				// need to tesselate for polygons of 4 or more vertices
-				// for now we naively turn interpret it as a triangle fan
-				// as full tesselation is problematic
-				if (FlipAxis)
+				// polygons have a <p> for each primitive, polylists take the
+				// corner counts from <vcount>, everything else are triangles
+				for (u32 primitive=0; *p; ++primitive)
 				{
-					for (u32 ind = indices.size()-3; ind>0 ; --ind)
+					u32 cornerCount = 3;
+					if (isPolygons)
+						cornerCount = 0xFFFFFFFF / stride;
+					else
+					if (!vCounts.empty())
 					{
-						mbuffer->Indices.push_back(indices[0]);
-						mbuffer->Indices.push_back(indices[ind+2]);
-						mbuffer->Indices.push_back(indices[ind+1]);
+						if (primitive == vCounts.size())
+							break;
+						cornerCount = (u32)core::max_(vCounts[primitive], 0);
 					}
-				}
-				else
-				{
-					for (u32 ind = 0; ind+2 < indices.size(); ++ind)
+
+					corners.set_used(0);
+					while (*p && corners.size() < cornerCount*stride)
 					{
-						mbuffer->Indices.push_back(indices[0]);
-						mbuffer->Indices.push_back(indices[ind+1]);
-						mbuffer->Indices.push_back(indices[ind+2]);
+						corners.push_back(readInt(&p));
+						findNextNoneWhiteSpace(&p);
 					}
-				}
-			}
-			else
-			{
-				// it's just triangles
-				for (u32 ind = 0; ind < indices.size(); ind+=3)
-				{
-					if (FlipAxis)
+
+					const u32 vertexCount = corners.size() / stride;
+					if (vertexCount < 3)
+						continue;
+
+					// start a new mesh buffer if the indices could exceed 16 bit
+					scene::IMeshBuffer* current = useLightMap ?
+						(scene::IMeshBuffer*)lightMapBuffer : (scene::IMeshBuffer*)buffer;
+					if (current && current->getVertexCount()+vertexCount > 65536)
 					{
-						mbuffer->Indices.push_back(indices[ind+2]);
-						mbuffer->Indices.push_back(indices[ind+1]);
-						mbuffer->Indices.push_back(indices[ind+0]);
+						addPolygonBuffer(current, mesh, materialName, geometryId, normalSlotCount);
+						buffer = 0;
+						lightMapBuffer = 0;
+						vertMap.clear();
+						lightMapVertMap.clear();
+						cornerMap.clear();
 					}
+					if (useLightMap && !lightMapBuffer)
+						lightMapBuffer = new SMeshBufferLightMap();
 					else
-					{
-						mbuffer->Indices.push_back(indices[ind+0]);
-						mbuffer->Indices.push_back(indices[ind+1]);
-						mbuffer->Indices.push_back(indices[ind+2]);
-					}
-				}
-			}
-
-		} // end for all polygons
-	}
-	else
-	{
-		// lightmap mesh buffer
-
-		scene::SMeshBufferLightMap* mbuffer = new SMeshBufferLightMap();
-		buffer = mbuffer;
-
-		for (u32 i=0; i<polygons.size(); ++i)
-		{
-			const u32 vertexCount = polygons[i].Indices.size() / maxOffset;
-			mbuffer->Vertices.reallocate(mbuffer->Vertices.size()+vertexCount);
-			// for all vertices in array
-			for (u32 v=0; v<polygons[i].Indices.size(); v+=maxOffset)
-			{
-				video::S3DVertex2TCoords vtx;
-				vtx.Color.set(100,255,255,255);
-
-				// for all input semantics
-				for (u32 k=0; k<Inputs.size(); ++k)
-				{
-					// build vertex from input semantics.
-
-					const u32 idx = localInputs[k].Stride*polygons[i].Indices[v+Inputs[k].Offset];
+					if (!useLightMap && !buffer)
+						buffer = new SMeshBuffer();
 
-					switch(localInputs[k].Semantic)
+					polygon.set_used(0);
+					for (u32 i=0; i<vertexCount; ++i)
 					{
-					case ECIS_POSITION:
-					case ECIS_VERTEX:
-						vtx.Pos.X = localInputs[k].Data[idx+0];
-						if (FlipAxis)
+						const s32* corner = corners.const_pointer() + i*stride;
+						const SColladaCorner key(corner, stride);
+						if (stride <= SColladaCorner::MAX_INDICES)
 						{
-							vtx.Pos.Z = localInputs[k].Data[idx+1];
-							vtx.Pos.Y = localInputs[k].Data[idx+2];
-						}
-						else
-						{
-							vtx.Pos.Y = localInputs[k].Data[idx+1];
-							vtx.Pos.Z = localInputs[k].Data[idx+2];
-						}
-						break;
-					case ECIS_NORMAL:
-						vtx.Normal.X = localInputs[k].Data[idx+0];
-						if (FlipAxis)
-						{
-							vtx.Normal.Z = localInputs[k].Data[idx+1];
-							vtx.Normal.Y = localInputs[k].Data[idx+2];
-						}
-						else
-						{
-							vtx.Normal.Y = localInputs[k].Data[idx+1];
-							vtx.Normal.Z = localInputs[k].Data[idx+2];
+							const core::hash_map<SColladaCorner, u16>::Node* n = cornerMap.find(key);
+							if (n)
+							{
+								polygon.push_back(n->getValue());
+								continue;
+							}
 						}
-						break;
-					case ECIS_TEXCOORD:
-					case ECIS_UV:
-						if (k==secondTexCoordSetIndex)
+
+						video::S3DVertex2TCoords vtx;
+						readPolygonVertex(localInputs, corner, secondTexCoordInput, vtx);
+						if (useLightMap)
 						{
-							vtx.TCoords2.X = localInputs[k].Data[idx+0];
-							vtx.TCoords2.Y = 1-localInputs[k].Data[idx+1];
+							vtx.Color.set(100,255,255,255);
+							polygon.push_back(addColladaVertex(lightMapBuffer, lightMapVertMap, vtx));
 						}
 						else
 						{
-							vtx.TCoords.X = localInputs[k].Data[idx+0];
-							vtx.TCoords.Y = 1-localInputs[k].Data[idx+1];
+							vtx.Color.set(255,255,255,255);
+							polygon.push_back(addColladaVertex(buffer, vertMap, video::S3DVertex(vtx)));
 						}
-						break;
-					case ECIS_TANGENT:
-						break;
-					default:
-						break;
+
+						if (stride <= SColladaCorner::MAX_INDICES)
+							cornerMap.insert(key, polygon.getLast());
 					}
+
+					addColladaFan(useLightMap ? lightMapBuffer->Indices : buffer->Indices,
+						polygon, FlipAxis);
 				}
+				vCounts.clear();
+			}
+		}
+	} // end while reader->read()
+
+	if (buffer)
+		addPolygonBuffer(buffer, mesh, materialName, geometryId, normalSlotCount);
+	if (lightMapBuffer)
+		addPolygonBuffer(lightMapBuffer, mesh, materialName, geometryId, normalSlotCount);
+}
 
-				mbuffer->Vertices.push_back(vtx);
 
-			} // end for all vertices
+//! builds the vertex of a primitive corner from the indices into the input sources
+void CColladaFileLoader::readPolygonVertex(const core::array<SColladaInput>& inputs,
+		const s32* corner, s32 secondTexCoordInput,
+		video::S3DVertex2TCoords& vtx) const
+{
+	// for all input semantics
+	for (u32 k=0; k<inputs.size(); ++k)
+	{
+		const SColladaInput& inp = inputs[k];
+		if (!inp.Data)
+			continue;
 
-			// add vertex indices
-			const u32 oldVertexCount = mbuffer->Vertices.size() - vertexCount;
-			for (u32 face=0; face<vertexCount-2; ++face)
+		// build vertex from input semantics, ignore indices outside of the array
+		const s32 index = corner[inp.Offset];
+		if (index < 0)
+			continue;
+		const u32 idx = inp.Stride*(u32)index;
+
+		switch(inp.Semantic)
+		{
+		case ECIS_POSITION:
+		case ECIS_VERTEX:
+			if (idx+3 > inp.DataSize)
+				break;
+			vtx.Pos.X = inp.Data[idx+0];
+			if (FlipAxis)
 			{
-				mbuffer->Indices.push_back(oldVertexCount + 0);
-				mbuffer->Indices.push_back(oldVertexCount + 1 + face);
-				mbuffer->Indices.push_back(oldVertexCount + 2 + face);
+				vtx.Pos.Z = inp.Data[idx+1];
+				vtx.Pos.Y = inp.Data[idx+2];
 			}
-
-		} // end for all polygons
+			else
+			{
+				vtx.Pos.Y = inp.Data[idx+1];
+				vtx.Pos.Z = inp.Data[idx+2];
+			}
+			break;
+		case ECIS_NORMAL:
+			if (idx+3 > inp.DataSize)
+				break;
+			vtx.Normal.X = inp.Data[idx+0];
+			if (FlipAxis)
+			{
+				vtx.Normal.Z = inp.Data[idx+1];
+				vtx.Normal.Y = inp.Data[idx+2];
+			}
+			else
+			{
+				vtx.Normal.Y = inp.Data[idx+1];
+				vtx.Normal.Z = inp.Data[idx+2];
+			}
+			break;
+		case ECIS_TEXCOORD:
+		case ECIS_UV:
+			if (idx+2 > inp.DataSize)
+				break;
+			if ((s32)k==secondTexCoordInput)
+			{
+				vtx.TCoords2.X = inp.Data[idx+0];
+				vtx.TCoords2.Y = 1-inp.Data[idx+1];
+			}
+			else
+			{
+				vtx.TCoords.X = inp.Data[idx+0];
+				vtx.TCoords.Y = 1-inp.Data[idx+1];
+			}
+			break;
+		case ECIS_TANGENT:
+			break;
+		default:
+			break;
+		}
 	}
+}
 
+
+//! sets the material of a mesh buffer read from a polygons section and adds it to the mesh
+void CColladaFileLoader::addPolygonBuffer(scene::IMeshBuffer* buffer, scene::SMesh* mesh,
+		const core::stringc& materialName, const core::stringc& geometryId,
+		bool hasNormals)
+{
 	const SColladaMaterial* m = findMaterial(materialName);
 	if (m)
 	{
@@ -2354,12 +2339,15 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 	{
 		MaterialsToBind[meshbufferReference] = MeshesToBind.size();
 		MeshesToBind.push_back(core::array<irr::scene::IMeshBuffer*>());
+		BoundMaterials.push_back(core::stringc());
 	}
-	MeshesToBind[MaterialsToBind[meshbufferReference]].push_back(buffer);
+	const u32 bindIndex = MaterialsToBind[meshbufferReference];
+	MeshesToBind[bindIndex].push_back(buffer);
+	BoundMaterials[bindIndex] = "";
 
 	// calculate normals if there is no slot for it
 
-	if (!normalSlotCount)
+	if (!hasNormals)
 		SceneManager->getMeshManipulator()->recalculateNormals(buffer, true);
 
 	// recalculate bounding box
@@ -2604,7 +2592,14 @@ inline f32 CColladaFileLoader::readFloat(const c8** p)
 //! the end of the parsed float
 inline s32 CColladaFileLoader::readInt(const c8** p)
 {
-	return (s32)readFloat(p);
+	// parsed as integer, so big indices don't lose precision like floats
+	const s32 value = core::strtol10(*p, p);
+
+	// skip what is left of the token, like a fractional part
+	while(**p && **p!=' ' && **p!='\n' && **p!='\r' && **p!='\t')
+		++*p;
+
+	return value;
 }
 
 
@@ -2636,9 +2631,7 @@ void CColladaFileLoader::readFloatsInsideElement(io::IXMLReaderUTF8* reader, f32
 		if (reader->getNodeType() == io::EXN_TEXT)
 		{
 			// parse float data
-			core::stringc data = reader->getNodeData();
-			data.trim();
-			const c8* p = &data[0];
+			const c8* p = reader->getNodeData();
 
 			for (u32 i=0; i<count; ++i)
 			{
@@ -2669,10 +2662,8 @@ void CColladaFileLoader::readIntsInsideElement(io::IXMLReaderUTF8* reader, s32*
 
 		if (reader->getNodeType() == io::EXN_TEXT)
 		{
-			// parse float data
-			core::stringc data = reader->getNodeData();
-			data.trim();
-			const c8* p = &data[0];
+			// parse int data
+			const c8* p = reader->getNodeData();
 
 			for (u32 i=0; i<count; ++i)
 			{
@@ -2754,6 +2745,7 @@ void CColladaFileLoader::clearData()
 	// clear all the materials to bind
 	MaterialsToBind.clear();
 	MeshesToBind.clear();
+	BoundMaterials.clear();
 }
 
 
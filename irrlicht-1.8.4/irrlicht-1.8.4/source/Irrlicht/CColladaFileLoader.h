@@ -13,6 +13,8 @@
 #include "SMeshBuffer.h"
 #include "ISceneManager.h"
 #include "irrMap.h"
+#include "irrList.h"
+#include "irrHashMap.h"
 #include "CAttributes.h"
 
 namespace irr
@@ -84,13 +86,14 @@ enum ECOLLADA_INPUT_SEMANTIC
 struct SColladaInput
 {
 	SColladaInput()
-		: Semantic(ECIS_COUNT), Data(0), Offset(0), Set(0), Stride(1)
+		: Semantic(ECIS_COUNT), Data(0), DataSize(0), Offset(0), Set(0), Stride(1)
 	{
 	}
 
 	ECOLLADA_INPUT_SEMANTIC Semantic;
 	core::stringc Source;
 	f32* Data;
+	u32 DataSize;
 	u32 Offset;
 	u32 Set;
 	u32 Stride;
@@ -322,11 +325,21 @@ private:
 	//! changes the XML URI into an internal id
 	void uriToId(core::stringc& str);
 
-	//! reads a polygons section and creates a mesh from it
+	//! reads a polygons section and creates mesh buffers from it
 	void readPolygonSection(io::IXMLReaderUTF8* reader,
-			core::array<SSource>& sources, scene::SMesh* mesh,
+			core::list<SSource>& sources, scene::SMesh* mesh,
 			const core::stringc& geometryId);
 
+	//! builds the vertex of a primitive corner from the indices into the input sources
+	void readPolygonVertex(const core::array<SColladaInput>& inputs,
+			const s32* corner, s32 secondTexCoordInput,
+			video::S3DVertex2TCoords& vtx) const;
+
+	//! sets the material of a mesh buffer read from a polygons section and adds it to the mesh
+	void addPolygonBuffer(scene::IMeshBuffer* buffer, scene::SMesh* mesh,
+			const core::stringc& materialName, const core::stringc& geometryId,
+			bool hasNormals);
+
 	//! finds a material, possible instancing it
 	const SColladaMaterial * findMaterial(const core::stringc & materialName);
 
@@ -359,9 +372,11 @@ private:
 	core::array<SColladaInput> Inputs;
 	core::array<SColladaEffect> Effects;
 	//! meshbuffer reference ("geomid/matname") -> index into MeshesToBind
-	core::map<core::stringc,u32> MaterialsToBind;
+	core::hash_map<core::stringc,u32> MaterialsToBind;
 	//! Array of buffers for each material binding
 	core::array< core::array<irr::scene::IMeshBuffer*> > MeshesToBind;
+	//! Id of the material last bound to each entry of MeshesToBind
+	core::array<core::stringc> BoundMaterials;
 
 	bool CreateInstances;
 };
@@ -628,6 +628,10 @@ void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN
 				case ECF_R8G8B8:
 					convert_A1R5G5B5toR8G8B8(sP, sN, dP);
 				break;
+				case ECF_DXT1:
+				case ECF_DXT5:
+					// pixels are not block compressed, the destination stays unchanged
+				break;
 #ifndef _DEBUG
 				default:
 					break;
@@ -649,6 +653,10 @@ void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN
 				case ECF_R8G8B8:
 					convert_R5G6B5toR8G8B8(sP, sN, dP);
 				break;
+				case ECF_DXT1:
+				case ECF_DXT5:
+					// pixels are not block compressed, the destination stays unchanged
+				break;
 #ifndef _DEBUG
 				default:
 					break;
@@ -670,6 +678,10 @@ void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN
 				case ECF_R8G8B8:
 					convert_A8R8G8B8toR8G8B8(sP, sN, dP);
 				break;
+				case ECF_DXT1:
+				case ECF_DXT5:
+					// pixels are not block compressed, the destination stays unchanged
+				break;
 #ifndef _DEBUG
 				default:
 					break;
@@ -691,12 +703,147 @@ void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN
 				case ECF_R8G8B8:
 					convert_R8G8B8toR8G8B8(sP, sN, dP);
 				break;
+				case ECF_DXT1:
+				case ECF_DXT5:
+					// pixels are not block compressed, the destination stays unchanged
+				break;
 #ifndef _DEBUG
 				default:
 					break;
 #endif
 			}
 		break;
+		case ECF_DXT1:
+		case ECF_DXT5:
+			// blocks of 4x4 pixels can't be converted a row at a time,
+			// images are decompressed with convert_DXTtoA8R8G8B8()
+		break;
+#ifndef _DEBUG
+		default:
+			break;
+#endif
+	}
+}
+
+
+//! expands a R5G6B5 color of a DXT block to A8R8G8B8
+static inline u32 DXTColor(u32 c)
+{
+	const u32 r = (c >> 11) & 0x1F;
+	const u32 g = (c >> 5) & 0x3F;
+	const u32 b = c & 0x1F;
+	return 0xFF000000 |
+		(((r << 3) | (r >> 2)) << 16) |
+		(((g << 2) | (g >> 4)) << 8) |
+		((b << 3) | (b >> 2));
+}
+
+
+//! mixes two A8R8G8B8 colors, (c0*w0 + c1*w1) / (w0+w1), alpha stays opaque
+static inline u32 DXTMix(u32 c0, u32 c1, u32 w0, u32 w1)
+{
+	const u32 sum = w0 + w1;
+	const u32 r = (((c0 >> 16) & 0xFF) * w0 + ((c1 >> 16) & 0xFF) * w1) / sum;
+	const u32 g = (((c0 >> 8) & 0xFF) * w0 + ((c1 >> 8) & 0xFF) * w1) / sum;
+	const u32 b = ((c0 & 0xFF) * w0 + (c1 & 0xFF) * w1) / sum;
+	return 0xFF000000 | (r << 16) | (g << 8) | b;
+}
+
+
+//! decodes one 4x4 block of ECF_DXT1 or ECF_DXT5 data into 16 A8R8G8B8 pixels, row by row
+void CColorConverter::decodeDXTBlock(const void* block, ECOLOR_FORMAT format, u32* out)
+{
+	const u8* b = (const u8*)block;
+
+	// the alpha part comes first in DXT5
+	u8 alpha[16];
+	if (format == ECF_DXT5)
+	{
+		u32 a[8];
+		a[0] = b[0];
+		a[1] = b[1];
+		if (a[0] > a[1])
+		{
+			for (u32 i=1; i<7; ++i)
+				a[i+1] = ((7-i) * a[0] + i * a[1]) / 7;
+		}
+		else
+		{
+			for (u32 i=1; i<5; ++i)
+				a[i+1] = ((5-i) * a[0] + i * a[1]) / 5;
+			a[6] = 0;
+			a[7] = 255;
+		}
+
+		// 16 indices of 3 bits, in two groups of 24 bits
+		for (u32 half=0; half<2; ++half)
+		{
+			const u8* p = b + 2 + half*3;
+			u32 bits = p[0] | (p[1] << 8) | (p[2] << 16);
+			for (u32 i=0; i<8; ++i, bits >>= 3)
+				alpha[half*8 + i] = (u8)a[bits & 7];
+		}
+
+		b += 8;
+	}
+
+	const u32 c0 = b[0] | (b[1] << 8);
+	const u32 c1 = b[2] | (b[3] << 8);
+
+	u32 colors[4];
+	colors[0] = DXTColor(c0);
+	colors[1] = DXTColor(c1);
+
+	// DXT1 blocks with c0 <= c1 have three colors and transparent black
+	if (c0 > c1 || format == ECF_DXT5)
+	{
+		colors[2] = DXTMix(colors[0], colors[1], 2, 1);
+		colors[3] = DXTMix(colors[0], colors[1], 1, 2);
+	}
+	else
+	{
+		colors[2] = DXTMix(colors[0], colors[1], 1, 1);
+		colors[3] = 0;
+	}
+
+	u32 bits = b[4] | (b[5] << 8) | (b[6] << 16) | ((u32)b[7] << 24);
+	if (format == ECF_DXT5)
+	{
+		for (u32 i=0; i<16; ++i, bits >>= 2)
+			out[i] = (colors[bits & 3] & 0x00FFFFFF) | ((u32)alpha[i] << 24);
+	}
+	else
+	{
+		for (u32 i=0; i<16; ++i, bits >>= 2)
+			out[i] = colors[bits & 3];
+	}
+}
+
+
+//! decodes ECF_DXT1 or ECF_DXT5 data into an A8R8G8B8 image of width*height pixels
+void CColorConverter::convert_DXTtoA8R8G8B8(const void* sP, ECOLOR_FORMAT sF, s32 width, s32 height, void* dP)
+{
+	const u32 blockSize = IImage::getBlockSizeFromFormat(sF);
+	if (!blockSize)
+		return;
+
+	const u8* in = (const u8*)sP;
+	u32* out = (u32*)dP;
+	u32 texel[16];
+
+	for (s32 y=0; y<height; y+=4)
+	{
+		for (s32 x=0; x<width; x+=4)
+		{
+			decodeDXTBlock(in, sF, texel);
+			in += blockSize;
+
+			// the last blocks may stick out of the image
+			const s32 w = core::min_(4, width - x);
+			const s32 h = core::min_(4, height - y);
+			for (s32 j=0; j<h; ++j)
+				memcpy(out + (y+j)*width + x, texel + j*4, w * sizeof(u32));
+		}
 	}
 }
 
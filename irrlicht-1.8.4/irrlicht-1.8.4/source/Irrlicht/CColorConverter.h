@@ -82,6 +82,19 @@ public:
 	static void convert_R5G6B5toA1R5G5B5(const void* sP, s32 sN, void* dP);
 	static void convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN,
 				void* dP, ECOLOR_FORMAT dF);
+
+	//! returns true if convert_viaFormat() converts from and to the format
+	static bool canConvertFormat(ECOLOR_FORMAT format)
+	{
+		return format == ECF_A1R5G5B5 || format == ECF_R5G6B5 ||
+			format == ECF_R8G8B8 || format == ECF_A8R8G8B8;
+	}
+
+	//! decodes one 4x4 block of ECF_DXT1 or ECF_DXT5 data into 16 A8R8G8B8 pixels, row by row
+	static void decodeDXTBlock(const void* block, ECOLOR_FORMAT format, u32* out);
+
+	//! decodes ECF_DXT1 or ECF_DXT5 data into an A8R8G8B8 image of width*height pixels
+	static void convert_DXTtoA8R8G8B8(const void* sP, ECOLOR_FORMAT sF, s32 width, s32 height, void* dP);
 };
 
 
@@ -1660,8 +1660,9 @@ void CD3D9Driver::draw2DImageBatch(const video::ITexture* texture,
 
 	const irr::u32 drawCount = core::min_<u32>(positions.size(), sourceRects.size());
 
-	core::array<S3DVertex> vtx(drawCount * 4);
-	core::array<u16> indices(drawCount * 6);
+	core::CMemoryArenaScope scratch;
+	core::array<S3DVertex, core::irrAllocatorFrame<S3DVertex> > vtx(drawCount * 4);
+	core::array<u16, core::irrAllocatorFrame<u16> > indices(drawCount * 6);
 
 	for(u32 i = 0;i < drawCount;i++)
 	{
@@ -3591,6 +3592,33 @@ core::dimension2du CD3D9Driver::getMaxTextureSize() const
 	return core::dimension2du(Caps.MaxTextureWidth, Caps.MaxTextureHeight);
 }
 
+
+//! Returns the color format the textures store images of a color format in
+/** Chooses like CD3D9Texture::createTexture() does. */
+ECOLOR_FORMAT CD3D9Driver::getTextureFormat(ECOLOR_FORMAT imageFormat) const
+{
+	ECOLOR_FORMAT format = ECF_A1R5G5B5;
+
+	if (getTextureCreationFlag(ETCF_OPTIMIZED_FOR_SPEED) ||
+			getTextureCreationFlag(ETCF_ALWAYS_16_BIT))
+		format = ECF_A1R5G5B5;
+	else if (getTextureCreationFlag(ETCF_ALWAYS_32_BIT))
+		format = ECF_A8R8G8B8;
+	else if (getTextureCreationFlag(ETCF_OPTIMIZED_FOR_QUALITY) &&
+			(imageFormat == ECF_R8G8B8 || imageFormat == ECF_A8R8G8B8))
+		format = ECF_A8R8G8B8;
+
+	if (getTextureCreationFlag(ETCF_NO_ALPHA_CHANNEL))
+	{
+		if (format == ECF_A8R8G8B8)
+			format = ECF_R8G8B8;
+		else if (format == ECF_A1R5G5B5)
+			format = ECF_R5G6B5;
+	}
+
+	return format;
+}
+
 #ifdef _IRR_COMPILE_WITH_CG_
 const CGcontext& CD3D9Driver::getCgContext()
 {
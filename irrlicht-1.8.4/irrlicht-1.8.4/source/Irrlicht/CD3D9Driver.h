@@ -322,6 +322,9 @@ namespace video
 		//! Returns the maximum texture size supported.
 		virtual core::dimension2du getMaxTextureSize() const;
 
+		//! Returns the color format the textures store images of a color format in
+		virtual ECOLOR_FORMAT getTextureFormat(ECOLOR_FORMAT imageFormat) const;
+
 		//! Get the current color format of the color buffer
 		/** \return Color format of the color buffer as D3D color value. */
 		D3DFORMAT getD3DColorFormat() const;
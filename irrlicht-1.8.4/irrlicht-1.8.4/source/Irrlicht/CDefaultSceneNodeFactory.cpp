@@ -13,6 +13,8 @@
 #include "IParticleSystemSceneNode.h"
 #include "ILightSceneNode.h"
 #include "IMeshSceneNode.h"
+#include "ILODMeshSceneNode.h"
+#include "IInstancedMeshSceneNode.h"
 
 namespace irr
 {
@@ -42,6 +44,8 @@ CDefaultSceneNodeFactory::CDefaultSceneNodeFactory(ISceneManager* mgr)
 	// Legacy support
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_OCTREE, "octTree"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_MESH, "mesh"));
+	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_LOD_MESH, "lodMesh"));
+	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_INSTANCED_MESH, "instancedMesh"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_LIGHT, "light"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_EMPTY, "empty"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_DUMMY_TRANSFORMATION, "dummyTransformation"));
@@ -90,6 +94,12 @@ ISceneNode* CDefaultSceneNodeFactory::addSceneNode(ESCENE_NODE_TYPE type, IScene
 	case ESNT_MESH:
 		return Manager->addMeshSceneNode(0, parent, -1, core::vector3df(),
 										 core::vector3df(), core::vector3df(1,1,1), true);
+	case ESNT_LOD_MESH:
+		return Manager->addLODMeshSceneNode(0, 4, 0.5f, parent, -1, core::vector3df(),
+										 core::vector3df(), core::vector3df(1,1,1), true);
+	case ESNT_INSTANCED_MESH:
+		return Manager->addInstancedMeshSceneNode(0, parent, -1, core::vector3df(),
+										 core::vector3df(), core::vector3df(1,1,1), true);
 	case ESNT_LIGHT:
 		return Manager->addLightSceneNode(parent);
 	case ESNT_EMPTY:
@@ -16,6 +16,37 @@ namespace io
 
 static const io::path emptyFileListEntry;
 
+namespace
+{
+	//! name searched by findFile, a range of the searched path
+	struct SFileKey
+	{
+		const fschar_t* Begin;
+		const fschar_t* End;
+		bool IsDirectory;
+	};
+
+	//! compares like SFileListEntry::operator<, treating backslashes in the key as slashes
+	s32 compareFileEntry(const SFileListEntry& entry, const SFileKey& key)
+	{
+		if (entry.IsDirectory != key.IsDirectory)
+			return entry.IsDirectory ? -1 : 1;
+
+		const fschar_t* name = entry.FullName.c_str();
+		for (const fschar_t* p = key.Begin; ; ++name, ++p)
+		{
+			// a shorter name sorts first
+			if (!*name || p == key.End)
+				return (*name ? 1 : 0) - (p != key.End ? 1 : 0);
+
+			const fschar_t c = (*p == '\\') ? '/' : *p;
+			const s32 diff = (s32)core::locale_lower(*name) - (s32)core::locale_lower(c);
+			if (diff)
+				return diff;
+		}
+	}
+}
+
 CFileList::CFileList(const io::path& path, bool ignoreCase, bool ignorePaths)
  : IgnorePaths(ignorePaths), IgnoreCase(ignoreCase), Path(path)
 {
@@ -127,29 +158,39 @@ u32 CFileList::getFileOffset(u32 index) const
 //! Searches for a file or folder within the list, returns the index
 s32 CFileList::findFile(const io::path& filename, bool isDirectory = false) const
 {
-	SFileListEntry entry;
-	// we only need FullName to be set for the search
-	entry.FullName = filename;
-	entry.IsDirectory = isDirectory;
+	return findFile(filename.c_str(), isDirectory);
+}
+
 
-	// exchange
-	entry.FullName.replace('\\', '/');
+//! Searches for a file or folder within the list, without creating a path
+s32 CFileList::findFile(const fschar_t* filename, bool isDirectory = false) const
+{
+	if (!filename)
+		return -1;
+
+	// the names are compared ignoring case, so only the range of the name is needed
+	SFileKey key;
+	key.Begin = filename;
+	key.End = filename;
+	while (*key.End)
+		++key.End;
+	key.IsDirectory = isDirectory;
 
 	// remove trailing slash
-	if (entry.FullName.lastChar() == '/')
+	if (key.End != key.Begin && (key.End[-1] == '/' || key.End[-1] == '\\'))
 	{
-		entry.IsDirectory = true;
-		entry.FullName[entry.FullName.size()-1] = 0;
-		entry.FullName.validate();
+		key.IsDirectory = true;
+		--key.End;
 	}
 
-	if (IgnoreCase)
-		entry.FullName.make_lower();
-
 	if (IgnorePaths)
-		core::deletePathFromFilename(entry.FullName);
+	{
+		for (const fschar_t* p = key.Begin; p != key.End; ++p)
+			if (*p == '/' || *p == '\\')
+				key.Begin = p + 1;
+	}
 
-	return Files.binary_search(entry);
+	return Files.binary_search_key(key, compareFileEntry);
 }
 
 
@@ -111,6 +111,9 @@ public:
 	//! Searches for a file or folder within the list, returns the index
 	virtual s32 findFile(const io::path& filename, bool isFolder) const;
 
+	//! Searches for a file or folder in the list, without creating a path
+	virtual s32 findFile(const fschar_t* filename, bool isFolder) const;
+
 	//! Returns the base path of the file list
 	virtual const io::path& getPath() const;
 
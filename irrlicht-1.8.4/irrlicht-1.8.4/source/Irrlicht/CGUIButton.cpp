@@ -61,6 +61,7 @@ CGUIButton::~CGUIButton()
 void CGUIButton::setScaleImage(bool scaleImage)
 {
 	ScaleImage = scaleImage;
+	setDirty();
 }
 
 
@@ -76,6 +77,7 @@ bool CGUIButton::isScalingImage() const
 void CGUIButton::setDrawBorder(bool border)
 {
 	DrawBorder = border;
+	setDirty();
 }
 
 
@@ -88,6 +90,7 @@ void CGUIButton::setSpriteBank(IGUISpriteBank* sprites)
 		SpriteBank->drop();
 
 	SpriteBank = sprites;
+	setDirty();
 }
 
 
@@ -103,6 +106,24 @@ void CGUIButton::setSprite(EGUI_BUTTON_STATE state, s32 index, video::SColor col
 	{
 		ButtonSprites[(u32)state].Index = -1;
 	}
+	setDirty();
+}
+
+
+//! returns true if one of the sprites of the button is animated
+bool CGUIButton::isAnimated() const
+{
+	if (!SpriteBank)
+		return false;
+
+	const core::array<SGUISprite>& sprites = SpriteBank->getSprites();
+	for (u32 i=0; i<EGBS_COUNT; ++i)
+	{
+		const s32 index = ButtonSprites[i].Index;
+		if (index >= 0 && (u32)index < sprites.size() && sprites[index].Frames.size() > 1)
+			return true;
+	}
+	return false;
 }
 
 
@@ -166,6 +187,11 @@ bool CGUIButton::OnEvent(const SEvent& event)
 			else if (event.GUIEvent.EventType == EGET_ELEMENT_HOVERED || event.GUIEvent.EventType == EGET_ELEMENT_LEFT)
 			{
 				HoverTime = os::Timer::getTime();
+
+				// only the sprites show if the mouse is over the button
+				if (SpriteBank && (ButtonSprites[EGBS_BUTTON_MOUSE_OVER].Index != -1 ||
+					ButtonSprites[EGBS_BUTTON_MOUSE_OFF].Index != -1))
+					setDirty();
 			}
 		}
 		break;
@@ -347,6 +373,8 @@ void CGUIButton::setOverrideFont(IGUIFont* font)
 
 	if (OverrideFont)
 		OverrideFont->grab();
+
+	setDirty();
 }
 
 //! Gets the override font (if any)
@@ -369,6 +397,7 @@ IGUIFont* CGUIButton::getActiveFont() const
 //! Sets an image which should be displayed on the button when it is in normal state.
 void CGUIButton::setImage(video::ITexture* image)
 {
+	setDirty();
 	if (image)
 		image->grab();
 	if (Image)
@@ -388,12 +417,14 @@ void CGUIButton::setImage(video::ITexture* image, const core::rect<s32>& pos)
 {
 	setImage(image);
 	ImageRect = pos;
+	setDirty();
 }
 
 
 //! Sets an image which should be displayed on the button when it is in pressed state.
 void CGUIButton::setPressedImage(video::ITexture* image)
 {
+	setDirty();
 	if (image)
 		image->grab();
 
@@ -411,6 +442,7 @@ void CGUIButton::setPressedImage(video::ITexture* image, const core::rect<s32>&
 {
 	setPressedImage(image);
 	PressedImageRect = pos;
+	setDirty();
 }
 
 
@@ -420,6 +452,7 @@ void CGUIButton::setPressedImage(video::ITexture* image, const core::rect<s32>&
 void CGUIButton::setIsPushButton(bool isPushButton)
 {
 	IsPushButton = isPushButton;
+	setDirty();
 }
 
 
@@ -438,6 +471,7 @@ void CGUIButton::setPressed(bool pressed)
 	{
 		ClickTime = os::Timer::getTime();
 		Pressed = pressed;
+		setDirty();
 	}
 }
 
@@ -454,6 +488,7 @@ bool CGUIButton::isPushButton() const
 void CGUIButton::setUseAlphaChannel(bool useAlphaChannel)
 {
 	UseAlphaChannel = useAlphaChannel;
+	setDirty();
 }
 
 
@@ -501,6 +536,7 @@ void CGUIButton::deserializeAttributes(io::IAttributes* in, io::SAttributeReadWr
 
 	IsPushButton	= in->getAttributeAsBool("PushButton");
 	Pressed		= IsPushButton ? in->getAttributeAsBool("Pressed") : false;
+	setDirty();
 
 	core::rect<s32> rec = in->getAttributeAsRect("ImageRect");
 	if (rec.isValid())
@@ -67,6 +67,9 @@ namespace gui
 		virtual void setSprite(EGUI_BUTTON_STATE state, s32 index,
 				video::SColor color=video::SColor(255,255,255,255), bool loop=false);
 
+		//! Returns true if one of the sprites of the button is animated
+		virtual bool isAnimated() const;
+
 		//! Sets if the button should behave like a push button. Which means it
 		//! can be in two states: Normal or Pressed. With a click on the button,
 		//! the user can change the state of the button.
@@ -10,6 +10,7 @@
 #include "IGUIEnvironment.h"
 #include "IVideoDriver.h"
 #include "IGUIFont.h"
+#include "IGUISpriteBank.h"
 #include "os.h"
 
 namespace irr
@@ -31,6 +32,23 @@ CGUICheckBox::CGUICheckBox(bool checked, IGUIEnvironment* environment, IGUIEleme
 }
 
 
+//! returns true if the check mark icon of the skin is animated
+bool CGUICheckBox::isAnimated() const
+{
+	if (!Checked)
+		return false;
+
+	IGUISkin* skin = Environment->getSkin();
+	IGUISpriteBank* bank = skin ? skin->getSpriteBank() : 0;
+	if (!bank)
+		return false;
+
+	const u32 index = skin->getIcon(EGDI_CHECK_BOX_CHECKED);
+	return index < bank->getSprites().size() &&
+		bank->getSprites()[index].Frames.size() > 1;
+}
+
+
 //! called if an event happened.
 bool CGUICheckBox::OnEvent(const SEvent& event)
 {
@@ -43,12 +61,14 @@ bool CGUICheckBox::OnEvent(const SEvent& event)
 				(event.KeyInput.Key == KEY_RETURN || event.KeyInput.Key == KEY_SPACE))
 			{
 				Pressed = true;
+				setDirty();
 				return true;
 			}
 			else
 			if (Pressed && event.KeyInput.PressedDown && event.KeyInput.Key == KEY_ESCAPE)
 			{
 				Pressed = false;
+				setDirty();
 				return true;
 			}
 			else
@@ -56,6 +76,7 @@ bool CGUICheckBox::OnEvent(const SEvent& event)
 				(event.KeyInput.Key == KEY_RETURN || event.KeyInput.Key == KEY_SPACE))
 			{
 				Pressed = false;
+				setDirty();
 				if (Parent)
 				{
 					SEvent newEvent;
@@ -72,14 +93,18 @@ bool CGUICheckBox::OnEvent(const SEvent& event)
 		case EET_GUI_EVENT:
 			if (event.GUIEvent.EventType == EGET_ELEMENT_FOCUS_LOST)
 			{
-				if (event.GUIEvent.Caller == this)
+				if (event.GUIEvent.Caller == this && Pressed)
+				{
 					Pressed = false;
+					setDirty();
+				}
 			}
 			break;
 		case EET_MOUSE_INPUT_EVENT:
 			if (event.MouseInput.Event == EMIE_LMOUSE_PRESSED_DOWN)
 			{
 				Pressed = true;
+				setDirty();
 				checkTime = os::Timer::getTime();
 				Environment->setFocus(this);
 				return true;
@@ -90,6 +115,7 @@ bool CGUICheckBox::OnEvent(const SEvent& event)
 				bool wasPressed = Pressed;
 				Environment->removeFocus(this);
 				Pressed = false;
+				setDirty();
 
 				if (wasPressed && Parent)
 				{
@@ -169,6 +195,7 @@ void CGUICheckBox::draw()
 //! set if box is checked
 void CGUICheckBox::setChecked(bool checked)
 {
+	setDirty();
 	Checked = checked;
 }
 
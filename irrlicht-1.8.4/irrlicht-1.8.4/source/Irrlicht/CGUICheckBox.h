@@ -34,6 +34,9 @@ namespace gui
 		//! draws the element and its children
 		virtual void draw();
 
+		//! Returns true if the check mark icon of the skin is animated
+		virtual bool isAnimated() const;
+
 		//! Writes attributes of the element.
 		virtual void serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const;
 
@@ -141,6 +141,7 @@ s32 CGUIComboBox::getIndexForItemData(u32 data ) const
 //! Removes an item from the combo box.
 void CGUIComboBox::removeItem(u32 idx)
 {
+	setDirty();
 	if (idx >= Items.size())
 		return;
 
@@ -161,6 +162,7 @@ const wchar_t* CGUIComboBox::getText() const
 //! adds an item and returns the index of it
 u32 CGUIComboBox::addItem(const wchar_t* text, u32 data)
 {
+	setDirty();
 	Items.push_back( SComboData ( text, data ) );
 
 	if (Selected == -1)
@@ -173,6 +175,7 @@ u32 CGUIComboBox::addItem(const wchar_t* text, u32 data)
 //! deletes all items in the combo box
 void CGUIComboBox::clear()
 {
+	setDirty();
 	Items.clear();
 	setSelected(-1);
 }
@@ -188,6 +191,7 @@ s32 CGUIComboBox::getSelected() const
 //! sets the selected item. Set this to -1 if no item should be selected
 void CGUIComboBox::setSelected(s32 idx)
 {
+	setDirty();
 	if (idx < -1 || idx >= (s32)Items.size())
 		return;
 
@@ -87,6 +87,7 @@ void CGUIEditBox::setOverrideFont(IGUIFont* font)
 	if (OverrideFont)
 		OverrideFont->grab();
 
+	setDirty();
 	breakText();
 }
 
@@ -107,9 +108,16 @@ IGUIFont* CGUIEditBox::getActiveFont() const
 	return 0;
 }
 
+//! returns true while the edit box has the focus, as the cursor blinks
+bool CGUIEditBox::isAnimated() const
+{
+	return Environment->hasFocus(const_cast<CGUIEditBox*>(this));
+}
+
 //! Sets another color for the text.
 void CGUIEditBox::setOverrideColor(video::SColor color)
 {
+	setDirty();
 	OverrideColor = color;
 	OverrideColorEnabled = true;
 }
@@ -124,18 +132,21 @@ video::SColor CGUIEditBox::getOverrideColor() const
 //! Turns the border on or off
 void CGUIEditBox::setDrawBorder(bool border)
 {
+	setDirty();
 	Border = border;
 }
 
 //! Sets whether to draw the background
 void CGUIEditBox::setDrawBackground(bool draw)
 {
+	setDirty();
 	Background = draw;
 }
 
 //! Sets if the text should use the overide color or the color in the gui skin.
 void CGUIEditBox::enableOverrideColor(bool enable)
 {
+	setDirty();
 	OverrideColorEnabled = enable;
 }
 
@@ -148,6 +159,7 @@ bool CGUIEditBox::isOverrideColorEnabled() const
 //! Enables or disables word wrap
 void CGUIEditBox::setWordWrap(bool enable)
 {
+	setDirty();
 	WordWrap = enable;
 	breakText();
 }
@@ -177,6 +189,7 @@ bool CGUIEditBox::isWordWrapEnabled() const
 //! Enables or disables newlines.
 void CGUIEditBox::setMultiLine(bool enable)
 {
+	setDirty();
 	MultiLine = enable;
 	breakText();
 }
@@ -192,6 +205,7 @@ bool CGUIEditBox::isMultiLineEnabled() const
 
 void CGUIEditBox::setPasswordBox(bool passwordBox, wchar_t passwordChar)
 {
+	setDirty();
 	PasswordBox = passwordBox;
 	if (PasswordBox)
 	{
@@ -213,6 +227,7 @@ bool CGUIEditBox::isPasswordBox() const
 //! Sets text justification
 void CGUIEditBox::setTextAlignment(EGUI_ALIGNMENT horizontal, EGUI_ALIGNMENT vertical)
 {
+	setDirty();
 	HAlign = horizontal;
 	VAlign = vertical;
 }
@@ -915,6 +930,7 @@ void CGUIEditBox::draw()
 //! Sets the new caption of this element.
 void CGUIEditBox::setText(const wchar_t* text)
 {
+	setDirty();
 	Text = text;
 	if (u32(CursorPos) > Text.size())
 		CursorPos = Text.size();
@@ -927,6 +943,7 @@ void CGUIEditBox::setText(const wchar_t* text)
 //! \param enable: If set to true, the text will move around with the cursor position
 void CGUIEditBox::setAutoScroll(bool enable)
 {
+	setDirty();
 	AutoScroll = enable;
 }
 
@@ -965,6 +982,7 @@ core::dimension2du CGUIEditBox::getTextDimension()
 //! infinity.
 void CGUIEditBox::setMax(u32 max)
 {
+	setDirty();
 	Max = max;
 
 	if (Text.size() > Max && Max != 0)
@@ -1482,6 +1500,7 @@ void CGUIEditBox::calculateFrameRect()
 //! set text markers
 void CGUIEditBox::setTextMarkers(s32 begin, s32 end)
 {
+	setDirty();
 	if ( begin != MarkBegin || end != MarkEnd )
 	{
 		MarkBegin = begin;
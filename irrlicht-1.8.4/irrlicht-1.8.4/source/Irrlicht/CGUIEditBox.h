@@ -39,6 +39,9 @@ namespace gui
 		font of the active skin otherwise */
 		virtual IGUIFont* getActiveFont() const;
 
+		//! returns true while the edit box has the focus, as the cursor blinks
+		virtual bool isAnimated() const;
+
 		//! Sets another color for the text.
 		virtual void setOverrideColor(video::SColor color);
 
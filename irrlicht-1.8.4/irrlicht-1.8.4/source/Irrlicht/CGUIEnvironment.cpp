@@ -54,9 +54,17 @@ const wchar_t* IRR_XML_FORMAT_GUI_ELEMENT_ATTR_TYPE	= L"type";
 
 const io::path CGUIEnvironment::DefaultFontName = "#DefaultFont";
 
+namespace
+{
+	//! width and height of the cells of the hit grid in pixels
+	const s32 HIT_GRID_CELL_SIZE = 64;
+}
+
 //! constructor
 CGUIEnvironment::CGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* driver, IOSOperator* op)
 : IGUIElement(EGUIET_ROOT, 0, 0, 0, core::rect<s32>(core::position2d<s32>(0,0), driver ? core::dimension2d<s32>(driver->getScreenSize()) : core::dimension2d<s32>(0,0))),
+	HitGridRect(0,0,0,0), HitGridWidth(0),
+	CacheTarget(0), CacheTextureCount(0), CachedComposition(false),
 	Driver(driver), Hovered(0), HoveredNoSubelement(0), Focus(0), LastHoveredMousePos(0,0), CurrentSkin(0),
 	FileSystem(fs), UserReceiver(0), Operator(op)
 {
@@ -124,6 +132,8 @@ CGUIEnvironment::~CGUIEnvironment()
 		ToolTip.Element = 0;
 	}
 
+	clearCache();
+
 	// drop skin
 	if (CurrentSkin)
 	{
@@ -209,11 +219,294 @@ void CGUIEnvironment::drawAll()
 	if (ToolTip.Element)
 		bringToFront(ToolTip.Element);
 
-	draw();
+	if (CachedComposition && Driver && Driver->queryFeature(video::EVDF_RENDER_TO_TARGET) &&
+		Driver->getCurrentRenderTargetSize() == Driver->getScreenSize())
+		drawCached();
+	else
+		draw();
 	OnPostRender ( os::Timer::getTime () );
 }
 
 
+//! enables drawing unchanged top-level elements from cached images
+void CGUIEnvironment::setCachedComposition(bool enable)
+{
+	CachedComposition = enable;
+	if (!enable)
+		clearCache();
+}
+
+
+//! returns if unchanged top-level elements are drawn from cached images
+bool CGUIEnvironment::getCachedComposition() const
+{
+	return CachedComposition;
+}
+
+
+//! draws the children of the root, unchanged ones from their cached images
+void CGUIEnvironment::drawCached()
+{
+	if (!isVisible())
+		return;
+
+	u32 i;
+	for (i=0; i<CachedElements.size(); ++i)
+		CachedElements[i].Used = false;
+
+	core::list<IGUIElement*>::Iterator it = Children.begin();
+	for (; it != Children.end(); ++it)
+	{
+		IGUIElement* element = *it;
+		if (!element->isVisible())
+			continue;
+
+		SCachedElement* entry = 0;
+		for (i=0; i<CachedElements.size(); ++i)
+		{
+			if (CachedElements[i].Element == element)
+			{
+				entry = &CachedElements[i];
+				break;
+			}
+		}
+
+		if (!entry)
+		{
+			SCachedElement e;
+			e.Element = element;
+			e.Texture = 0;
+			e.Cacheable = true;
+			e.Used = false;
+			element->grab();
+			element->setDirty();
+			CachedElements.push_back(e);
+			entry = &CachedElements.getLast();
+		}
+		entry->Used = true;
+
+		const core::rect<s32>& clip = element->getAbsoluteClippingRect();
+		if (element->isDirty() || !entry->Cacheable ||
+			entry->Size != core::dimension2du(clip.getSize()))
+		{
+			entry->Cacheable = isCacheable(element);
+			if (!entry->Cacheable || !updateCache(*entry))
+			{
+				if (entry->Texture)
+				{
+					Driver->removeTexture(entry->Texture);
+					entry->Texture = 0;
+				}
+				entry->Size = core::dimension2du(0,0);
+			}
+			element->clearDirty();
+		}
+
+		if (entry->Texture)
+			Driver->draw2DImage(entry->Texture, clip.UpperLeftCorner,
+				core::rect<s32>(core::position2d<s32>(0,0), entry->Size), 0,
+				video::SColor(255,255,255,255), true);
+		else
+			element->draw();
+	}
+
+	// forget removed and hidden elements
+	for (i=0; i<CachedElements.size();)
+	{
+		if (!CachedElements[i].Used)
+		{
+			if (CachedElements[i].Texture)
+				Driver->removeTexture(CachedElements[i].Texture);
+			CachedElements[i].Element->drop();
+			CachedElements.erase(i);
+		}
+		else
+			++i;
+	}
+}
+
+
+//! returns if the element and its children can be drawn from a cached image
+bool CGUIEnvironment::isCacheable(IGUIElement* element) const
+{
+	if (!element->isVisible())
+		return true;
+
+	// elements drawing outside of their parent would be cut off, others animate
+	// on their own, and custom elements might not report their changes
+	const EGUI_ELEMENT_TYPE type = element->getType();
+	if (element->isNotClipped() || element->isAnimated() || element == ToolTip.Element ||
+		type == EGUIET_MENU || type == EGUIET_CONTEXT_MENU ||
+		type == EGUIET_MODAL_SCREEN || type == EGUIET_IN_OUT_FADER ||
+		type == EGUIET_MESH_VIEWER || type >= EGUIET_COUNT)
+		return false;
+
+	const core::list<IGUIElement*>& children = element->getChildren();
+	core::list<IGUIElement*>::ConstIterator it = children.begin();
+	for (; it != children.end(); ++it)
+		if (!isCacheable(*it))
+			return false;
+
+	return true;
+}
+
+
+//! draws an element into its cached image
+/** The element is drawn twice, once over black and once over white. The
+difference of both results is the coverage of each pixel, so the image
+can be blended over anything behind it just like the element itself, also
+with semi-transparent skins. Elements are only redrawn after they changed,
+so the read back of the render target is rare. */
+bool CGUIEnvironment::updateCache(SCachedElement& entry)
+{
+	const core::rect<s32> clip = entry.Element->getAbsoluteClippingRect();
+	if (!clip.isValid() || clip.getArea() == 0)
+		return false;
+
+	const core::dimension2du screenSize(Driver->getScreenSize());
+	if (!CacheTarget || CacheTarget->getSize().Width < screenSize.Width ||
+		CacheTarget->getSize().Height < screenSize.Height)
+	{
+		if (CacheTarget)
+			Driver->removeTexture(CacheTarget);
+		CacheTarget = Driver->addRenderTargetTexture(screenSize, "GUICompositionTarget", video::ECF_A8R8G8B8);
+		if (!CacheTarget)
+			return false;
+	}
+
+	const core::dimension2du size(clip.getSize());
+	const core::rect<s32> viewPort(Driver->getViewPort());
+	video::IImage* layer[2] = { 0, 0 };
+	for (u32 i=0; i<2; ++i)
+	{
+		const video::SColor background = i ? video::SColor(255,255,255,255) : video::SColor(255,0,0,0);
+		if (!Driver->setRenderTarget(CacheTarget, true, false, background))
+			break;
+		entry.Element->draw();
+		Driver->setRenderTarget(0, false, false);
+		layer[i] = Driver->createImage(CacheTarget, clip.UpperLeftCorner, size);
+	}
+	Driver->setViewPort(viewPort);
+
+	video::IImage* image = 0;
+	if (layer[0] && layer[1] && layer[0]->getDimension() == size && layer[1]->getDimension() == size)
+	{
+		// work on the raw pixels, the layers are usually in this format already
+		for (u32 i=0; i<2; ++i)
+		{
+			if (layer[i]->getColorFormat() != video::ECF_A8R8G8B8)
+			{
+				video::IImage* converted = Driver->createImage(video::ECF_A8R8G8B8, size);
+				layer[i]->copyTo(converted);
+				layer[i]->drop();
+				layer[i] = converted;
+			}
+		}
+
+		image = Driver->createImage(video::ECF_A8R8G8B8, size);
+		const u32* black = (const u32*)layer[0]->lock();
+		const u32* white = (const u32*)layer[1]->lock();
+		u32* dest = (u32*)image->lock();
+		const u32 count = size.Width * size.Height;
+		for (u32 p=0; p<count; ++p)
+		{
+			const u32 b = black[p];
+			const u32 w = white[p];
+			if (b == w)
+			{
+				// opaque, the common case
+				dest[p] = b | 0xff000000;
+				continue;
+			}
+
+			const s32 br = (b>>16) & 0xff;
+			const s32 bg = (b>>8) & 0xff;
+			const s32 bb = b & 0xff;
+			const s32 shine = ((s32)((w>>16) & 0xff) - br +
+				(s32)((w>>8) & 0xff) - bg + (s32)(w & 0xff) - bb) / 3;
+			const s32 alpha = 255 - core::s32_clamp(shine, 0, 255);
+			if (alpha == 0)
+			{
+				dest[p] = 0;
+				continue;
+			}
+
+			// the black layer holds the color already multiplied with the coverage
+			dest[p] = ((u32)alpha << 24) |
+				((u32)core::s32_min(br * 255 / alpha, 255) << 16) |
+				((u32)core::s32_min(bg * 255 / alpha, 255) << 8) |
+				(u32)core::s32_min(bb * 255 / alpha, 255);
+		}
+		image->unlock();
+		layer[1]->unlock();
+		layer[0]->unlock();
+	}
+
+	for (u32 i=0; i<2; ++i)
+		if (layer[i])
+			layer[i]->drop();
+
+	if (!image)
+		return false;
+
+	bool updated = false;
+	if (entry.Texture && entry.Texture->getOriginalSize() == size)
+	{
+		void* data = entry.Texture->lock(video::ETLM_WRITE_ONLY);
+		if (data)
+		{
+			image->copyToScaling(data, size.Width, size.Height,
+				entry.Texture->getColorFormat(), entry.Texture->getPitch());
+			entry.Texture->unlock();
+			updated = true;
+		}
+	}
+
+	if (!updated)
+	{
+		if (entry.Texture)
+			Driver->removeTexture(entry.Texture);
+
+		const bool mipmaps = Driver->getTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS);
+		const bool always32 = Driver->getTextureCreationFlag(video::ETCF_ALWAYS_32_BIT);
+		const bool nonPower2 = Driver->getTextureCreationFlag(video::ETCF_ALLOW_NON_POWER_2);
+		Driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS, false);
+		Driver->setTextureCreationFlag(video::ETCF_ALWAYS_32_BIT, true);
+		// the image is drawn unscaled, drivers rescaling it would shrink it
+		Driver->setTextureCreationFlag(video::ETCF_ALLOW_NON_POWER_2, true);
+
+		io::path name("GUICompositionCache");
+		name += CacheTextureCount++;
+		entry.Texture = Driver->addTexture(name, image);
+
+		Driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS, mipmaps);
+		Driver->setTextureCreationFlag(video::ETCF_ALWAYS_32_BIT, always32);
+		Driver->setTextureCreationFlag(video::ETCF_ALLOW_NON_POWER_2, nonPower2);
+	}
+
+	image->drop();
+	entry.Size = size;
+	return entry.Texture != 0;
+}
+
+
+//! removes all cached images
+void CGUIEnvironment::clearCache()
+{
+	for (u32 i=0; i<CachedElements.size(); ++i)
+	{
+		if (CachedElements[i].Texture && Driver)
+			Driver->removeTexture(CachedElements[i].Texture);
+		CachedElements[i].Element->drop();
+	}
+	CachedElements.clear();
+
+	if (CacheTarget && Driver)
+		Driver->removeTexture(CacheTarget);
+	CacheTarget = 0;
+}
+
+
 //! sets the focus to an element
 bool CGUIEnvironment::setFocus(IGUIElement* element)
 {
@@ -281,10 +574,15 @@ bool CGUIEnvironment::setFocus(IGUIElement* element)
 		currentFocus->drop();
 
 	if (Focus)
+	{
+		Focus->setDirty();
 		Focus->drop();
+	}
 
 	// element is the new focus so it doesn't have to be dropped
 	Focus = element;
+	if (Focus)
+		Focus->setDirty();
 
 	return true;
 }
@@ -321,6 +619,7 @@ bool CGUIEnvironment::removeFocus(IGUIElement* element)
 	}
 	if (Focus)
 	{
+		Focus->setDirty();
 		Focus->drop();
 		Focus = 0;
 	}
@@ -469,7 +768,7 @@ void CGUIEnvironment::updateHoveredElement(core::position2d<s32> mousePos)
 	IGUIElement* lastHoveredNoSubelement = HoveredNoSubelement;
 	LastHoveredMousePos = mousePos;
 
-	Hovered = getElementFromPoint(mousePos);
+	Hovered = getHitElement(mousePos);
 
 	if ( ToolTip.Element && Hovered == ToolTip.Element )
 	{
@@ -480,7 +779,7 @@ void CGUIEnvironment::updateHoveredElement(core::position2d<s32> mousePos)
 		ToolTip.Element = 0;
 
 		// Get the real Hovered
-		Hovered = getElementFromPoint(mousePos);
+		Hovered = getHitElement(mousePos);
 	}
 
 	// for tooltips we want the element itself and not some of it's subelements
@@ -540,6 +839,114 @@ void CGUIEnvironment::updateHoveredElement(core::position2d<s32> mousePos)
 }
 
 
+//! returns the same element as getElementFromPoint(), but uses the hit grid
+/** getElementFromPoint() returns the last element in drawing order which
+contains the point, so only the elements covering the cell of the point
+have to be checked from back to front. */
+IGUIElement* CGUIEnvironment::getHitElement(const core::position2d<s32>& point)
+{
+	if (isLayoutDirty() || HitGridRect != AbsoluteRect)
+		updateHitGrid();
+
+	if (!HitGridWidth || !HitGridRect.isPointInside(point))
+		return getElementFromPoint(point);
+
+	const u32 cell = ((point.Y - HitGridRect.UpperLeftCorner.Y) / HIT_GRID_CELL_SIZE) * HitGridWidth +
+		(point.X - HitGridRect.UpperLeftCorner.X) / HIT_GRID_CELL_SIZE;
+
+	for (u32 i=HitCellStart[cell+1]; i>HitCellStart[cell]; --i)
+	{
+		IGUIElement* element = HitElements[HitCellElements[i-1]];
+		if (element->isPointInside(point))
+			return element;
+	}
+
+	return 0;
+}
+
+
+//! rebuilds the hit grid from the visible elements
+void CGUIEnvironment::updateHitGrid()
+{
+	clearLayoutDirty();
+
+	HitElements.set_used(0);
+	HitCellElements.set_used(0);
+	HitGridRect = AbsoluteRect;
+	HitGridWidth = 0;
+
+	if (!HitGridRect.isValid())
+		return;
+
+	collectHitElements(this);
+
+	const u32 width = HitGridRect.getWidth() / HIT_GRID_CELL_SIZE + 1;
+	const u32 height = HitGridRect.getHeight() / HIT_GRID_CELL_SIZE + 1;
+	const u32 cellCount = width * height;
+
+	// cell range of each element, modal screens catch the mouse everywhere
+	core::array<core::rect<s32> > ranges;
+	ranges.set_used(HitElements.size());
+	u32 i;
+	for (i=0; i<HitElements.size(); ++i)
+	{
+		core::rect<s32> r(0, 0, width-1, height-1);
+		if (HitElements[i]->getType() != EGUIET_MODAL_SCREEN)
+		{
+			core::rect<s32> area(HitElements[i]->getAbsoluteClippingRect());
+			area.clipAgainst(HitGridRect);
+			if (!area.isValid() || !HitElements[i]->getAbsoluteClippingRect().isValid())
+			{
+				ranges[i] = core::rect<s32>(0, 0, -1, -1);
+				continue;
+			}
+
+			area -= HitGridRect.UpperLeftCorner;
+			r.UpperLeftCorner = area.UpperLeftCorner / HIT_GRID_CELL_SIZE;
+			r.LowerRightCorner = area.LowerRightCorner / HIT_GRID_CELL_SIZE;
+		}
+		ranges[i] = r;
+	}
+
+	// count the elements per cell, then fill the cells in drawing order
+	HitCellStart.set_used(cellCount+1);
+	for (i=0; i<=cellCount; ++i)
+		HitCellStart[i] = 0;
+
+	for (i=0; i<ranges.size(); ++i)
+		for (s32 y=ranges[i].UpperLeftCorner.Y; y<=ranges[i].LowerRightCorner.Y; ++y)
+			for (s32 x=ranges[i].UpperLeftCorner.X; x<=ranges[i].LowerRightCorner.X; ++x)
+				++HitCellStart[y*width + x + 1];
+
+	for (i=0; i<cellCount; ++i)
+		HitCellStart[i+1] += HitCellStart[i];
+
+	core::array<u32> fill(HitCellStart);
+	HitCellElements.set_used(HitCellStart[cellCount]);
+	for (i=0; i<ranges.size(); ++i)
+		for (s32 y=ranges[i].UpperLeftCorner.Y; y<=ranges[i].LowerRightCorner.Y; ++y)
+			for (s32 x=ranges[i].UpperLeftCorner.X; x<=ranges[i].LowerRightCorner.X; ++x)
+				HitCellElements[fill[y*width + x]++] = i;
+
+	HitGridWidth = width;
+}
+
+
+//! adds the visible elements of a subtree in drawing order
+void CGUIEnvironment::collectHitElements(IGUIElement* element)
+{
+	if (!element->isVisible())
+		return;
+
+	HitElements.push_back(element);
+
+	const core::list<IGUIElement*>& children = element->getChildren();
+	core::list<IGUIElement*>::ConstIterator it = children.begin();
+	for (; it != children.end(); ++it)
+		collectHitElements(*it);
+}
+
+
 //! This sets a new event receiver for gui events. Usually you do not have to
 //! use this method, it is used by the internal engine.
 void CGUIEnvironment::setUserEventReceiver(IEventReceiver* evr)
@@ -628,6 +1035,11 @@ void CGUIEnvironment::setSkin(IGUISkin* skin)
 
 	if (CurrentSkin)
 		CurrentSkin->grab();
+
+	// all elements look different now
+	core::list<IGUIElement*>::Iterator it = Children.begin();
+	for (; it != Children.end(); ++it)
+		(*it)->setDirty();
 }
 
 
@@ -36,6 +36,12 @@ public:
 	//! draws all gui elements
 	virtual void drawAll();
 
+	//! enables drawing unchanged top-level elements from cached images
+	virtual void setCachedComposition(bool enable);
+
+	//! returns if unchanged top-level elements are drawn from cached images
+	virtual bool getCachedComposition() const;
+
 	//! returns the current video driver
 	virtual video::IVideoDriver* getVideoDriver() const;
 
@@ -258,12 +264,43 @@ public:
 
 private:
 
+	//! cached image of a top-level element
+	struct SCachedElement
+	{
+		IGUIElement* Element;
+		video::ITexture* Texture;
+		core::dimension2du Size;
+		bool Cacheable;
+		bool Used;
+	};
+
 	IGUIElement* getNextElement(bool reverse=false, bool group=false);
 
 	void updateHoveredElement(core::position2d<s32> mousePos);
 
+	//! returns the same element as getElementFromPoint(), but uses the hit grid
+	IGUIElement* getHitElement(const core::position2d<s32>& point);
+
+	//! rebuilds the hit grid from the visible elements
+	void updateHitGrid();
+
+	//! adds the visible elements of a subtree in drawing order
+	void collectHitElements(IGUIElement* element);
+
 	void loadBuiltInFont();
 
+	//! draws the children of the root, unchanged ones from their cached images
+	void drawCached();
+
+	//! returns if the element and its children can be drawn from a cached image
+	bool isCacheable(IGUIElement* element) const;
+
+	//! draws an element into its cached image
+	bool updateCache(SCachedElement& entry);
+
+	//! removes all cached images
+	void clearCache();
+
 	struct SFont
 	{
 		io::SNamedPath NamedPath;
@@ -297,6 +334,18 @@ private:
 
 	SToolTip ToolTip;
 
+	//! uniform grid over the screen listing the elements covering each cell
+	core::array<IGUIElement*> HitElements;
+	core::array<u32> HitCellStart;
+	core::array<u32> HitCellElements;
+	core::rect<s32> HitGridRect;
+	u32 HitGridWidth;
+
+	core::array<SCachedElement> CachedElements;
+	video::ITexture* CacheTarget;
+	u32 CacheTextureCount;
+	bool CachedComposition;
+
 	core::array<IGUIElementFactory*> GUIElementFactoryList;
 
 	core::array<SFont> Fonts;
@@ -17,9 +17,19 @@ namespace irr
 namespace gui
 {
 
+namespace
+{
+	//! Amount of texts each font keeps laid out
+	const u32 LAYOUT_CACHE_SIZE = 64;
+
+	//! Characters above this are always looked up in the map
+	const u32 GLYPH_TABLE_LIMIT = 0x10000;
+}
+
 //! constructor
 CGUIFont::CGUIFont(IGUIEnvironment *env, const io::path& filename)
-: Driver(0), SpriteBank(0), Environment(env), WrongCharacter(0),
+: LayoutRectangleCount(0), LayoutTextureCount(0), Driver(0), SpriteBank(0),
+	Environment(env), WrongCharacter(0),
 	MaxHeight(0), GlobalKerningWidth(0), GlobalKerningHeight(0)
 {
 	#ifdef _DEBUG
@@ -189,9 +199,7 @@ bool CGUIFont::load(io::IXMLReader* xml)
 		}
 	}
 
-	// set bad character
-	WrongCharacter = getAreaFromCharacter(L' ');
-
+	updateGlyphTable();
 	setMaxHeight();
 
 	return true;
@@ -271,7 +279,7 @@ bool CGUIFont::loadTexture(video::IImage* image, const io::path& name)
 	}
 	readPositions(tmpImage, lowerRightPositions);
 
-	WrongCharacter = getAreaFromCharacter(L' ');
+	updateGlyphTable();
 
 	// output warnings
 	if (!lowerRightPositions || !SpriteBank->getSprites().size())
@@ -380,6 +388,7 @@ void CGUIFont::readPositions(video::IImage* image, s32& lowerRightPositions)
 void CGUIFont::setKerningWidth(s32 kerning)
 {
 	GlobalKerningWidth = kerning;
+	clearLayoutCache();
 }
 
 
@@ -406,6 +415,7 @@ s32 CGUIFont::getKerningWidth(const wchar_t* thisLetter, const wchar_t* previous
 void CGUIFont::setKerningHeight(s32 kerning)
 {
 	GlobalKerningHeight = kerning;
+	clearLayoutCache();
 }
 
 
@@ -425,16 +435,63 @@ u32 CGUIFont::getSpriteNoFromChar(const wchar_t *c) const
 
 s32 CGUIFont::getAreaFromCharacter(const wchar_t c) const
 {
-	core::map<wchar_t, s32>::Node* n = CharacterMap.find(c);
+	if ((u32)c < GlyphTable.size())
+		return GlyphTable[(u32)c];
+
+	core::hash_map<wchar_t, s32>::Node* n = CharacterMap.find(c);
 	if (n)
 		return n->getValue();
 	else
 		return WrongCharacter;
 }
 
+
+void CGUIFont::updateGlyphTable()
+{
+	GlyphTable.clear();
+	clearLayoutCache();
+
+	// set bad character, looked up in the character map while the
+	// table is empty, so it never comes from an outdated table
+	WrongCharacter = getAreaFromCharacter(L' ');
+
+	// 0xffff is left free, so a table entry can hold every area
+	if (Areas.size() >= 0xffff)
+		return;
+
+	u32 size = 0;
+	core::hash_map<wchar_t, s32>::ConstIterator it = CharacterMap.getConstIterator();
+	for (; !it.atEnd(); it++)
+	{
+		const u32 c = (u32)it->getKey();
+		if (c < GLYPH_TABLE_LIMIT && c >= size)
+			size = c+1;
+	}
+
+	GlyphTable.set_used(size);
+	for (u32 i=0; i<size; ++i)
+		GlyphTable[i] = (u16)WrongCharacter;
+
+	for (it = CharacterMap.getConstIterator(); !it.atEnd(); it++)
+	{
+		const u32 c = (u32)it->getKey();
+		if (c < size)
+			GlyphTable[c] = (u16)it->getValue();
+	}
+}
+
+
+void CGUIFont::clearLayoutCache()
+{
+	for (u32 i=0; i<LayoutCache.size(); ++i)
+		LayoutCache[i].Valid = false;
+}
+
+
 void CGUIFont::setInvisibleCharacters( const wchar_t *s )
 {
 	Invisible = s;
+	clearLayoutCache();
 }
 
 
@@ -479,20 +536,62 @@ core::dimension2d<u32> CGUIFont::getDimension(const wchar_t* text) const
 	return dim;
 }
 
-//! draws some text and clips it to the specified rectangle if wanted
-void CGUIFont::draw(const core::stringw& text, const core::rect<s32>& position,
-					video::SColor color,
-					bool hcenter, bool vcenter, const core::rect<s32>* clip
-				)
+//! returns the cached layout of a text, lays it out if necessary
+const CGUIFont::SLayoutEntry& CGUIFont::getLayout(const core::stringw& text,
+		const core::rect<s32>& position, bool hcenter, bool vcenter)
 {
-	if (!Driver || !SpriteBank)
-		return;
+	// a changed sprite bank makes the cached source rectangles invalid
+	if (LayoutRectangleCount != SpriteBank->getPositions().size() ||
+		LayoutTextureCount != SpriteBank->getTextureCount())
+	{
+		clearLayoutCache();
+		LayoutRectangleCount = SpriteBank->getPositions().size();
+		LayoutTextureCount = SpriteBank->getTextureCount();
+	}
+
+	u32 hash = 2166136261u;
+	for (u32 i=0; i<text.size(); ++i)
+		hash = (hash ^ (u32)text[i]) * 16777619u;
+	hash = (hash ^ (u32)position.UpperLeftCorner.X) * 16777619u;
+	hash = (hash ^ (u32)position.UpperLeftCorner.Y) * 16777619u;
+	hash = (hash ^ (u32)position.LowerRightCorner.X) * 16777619u;
+	hash = (hash ^ (u32)position.LowerRightCorner.Y) * 16777619u;
+	hash = (hash ^ (hcenter ? 1u : 0u) ^ (vcenter ? 2u : 0u)) * 16777619u;
+
+	if (LayoutCache.empty())
+	{
+		LayoutCache.reallocate(LAYOUT_CACHE_SIZE);
+		for (u32 i=0; i<LAYOUT_CACHE_SIZE; ++i)
+			LayoutCache.push_back(SLayoutEntry());
+	}
+
+	SLayoutEntry& entry = LayoutCache[(hash ^ (hash >> 16)) & (LAYOUT_CACHE_SIZE-1)];
+	if (entry.Valid && entry.Hash == hash && entry.HCenter == hcenter &&
+		entry.VCenter == vcenter && entry.Position == position && entry.Text == text)
+		return entry;
+
+	entry.Text = text;
+	entry.Position = position;
+	entry.Hash = hash;
+	entry.HCenter = hcenter;
+	entry.VCenter = vcenter;
+	entry.Valid = true;
+
+	// keep the arrays of the old text, so their memory is reused
+	const u32 textureCount = SpriteBank->getTextureCount();
+	while (entry.Batches.size() < textureCount)
+		entry.Batches.push_back(SLayoutBatch());
+	for (u32 i=0; i<entry.Batches.size(); ++i)
+	{
+		entry.Batches[i].Texture = i;
+		entry.Batches[i].Positions.set_used(0);
+		entry.Batches[i].SourceRects.set_used(0);
+	}
 
 	core::dimension2d<s32> textDimension;	// NOTE: don't make this u32 or the >> later on can fail when the dimension width is < position width
 	core::position2d<s32> offset = position.UpperLeftCorner;
 
-	if (hcenter || vcenter || clip)
-		textDimension = getDimension(text.c_str());
+	textDimension = getDimension(text.c_str());
 
 	if (hcenter)
 		offset.X += (position.getWidth() - textDimension.Width) >> 1;
@@ -500,16 +599,10 @@ void CGUIFont::draw(const core::stringw& text, const core::rect<s32>& position,
 	if (vcenter)
 		offset.Y += (position.getHeight() - textDimension.Height) >> 1;
 
-	if (clip)
-	{
-		core::rect<s32> clippedRect(offset, textDimension);
-		clippedRect.clipAgainst(*clip);
-		if (!clippedRect.isValid())
-			return;
-	}
+	entry.TextRect = core::rect<s32>(offset, textDimension);
 
-	core::array<u32> indices(text.size());
-	core::array<core::position2di> offsets(text.size());
+	const core::array<SGUISprite>& sprites = SpriteBank->getSprites();
+	const core::array< core::rect<s32> >& rectangles = SpriteBank->getPositions();
 
 	for(u32 i = 0;i < text.size();i++)
 	{
@@ -542,16 +635,53 @@ void CGUIFont::draw(const core::stringw& text, const core::rect<s32>& position,
 		SFontArea& area = Areas[getAreaFromCharacter(c)];
 
 		offset.X += area.underhang;
-		if ( Invisible.findFirst ( c ) < 0 )
+		if ( Invisible.findFirst ( c ) < 0 && area.spriteno < sprites.size() &&
+			!sprites[area.spriteno].Frames.empty() )
 		{
-			indices.push_back(area.spriteno);
-			offsets.push_back(offset);
+			// font sprites are not animated, so the first frame is used
+			const SGUISpriteFrame& frame = sprites[area.spriteno].Frames[0];
+			if (frame.textureNumber < entry.Batches.size() && frame.rectNumber < rectangles.size())
+			{
+				entry.Batches[frame.textureNumber].Positions.push_back(offset);
+				entry.Batches[frame.textureNumber].SourceRects.push_back(rectangles[frame.rectNumber]);
+			}
 		}
 
 		offset.X += area.width + area.overhang + GlobalKerningWidth;
 	}
 
-	SpriteBank->draw2DSpriteBatch(indices, offsets, clip, color);
+	return entry;
+}
+
+
+//! draws some text and clips it to the specified rectangle if wanted
+/** Laid out texts are cached, so drawing the same text at the same place
+again only costs one draw2DImageBatch() call per font texture. */
+void CGUIFont::draw(const core::stringw& text, const core::rect<s32>& position,
+					video::SColor color,
+					bool hcenter, bool vcenter, const core::rect<s32>* clip
+				)
+{
+	if (!Driver || !SpriteBank)
+		return;
+
+	const SLayoutEntry& layout = getLayout(text, position, hcenter, vcenter);
+
+	if (clip)
+	{
+		core::rect<s32> clippedRect(layout.TextRect);
+		clippedRect.clipAgainst(*clip);
+		if (!clippedRect.isValid())
+			return;
+	}
+
+	for (u32 i=0; i<layout.Batches.size(); ++i)
+	{
+		const SLayoutBatch& batch = layout.Batches[i];
+		if (!batch.Positions.empty())
+			Driver->draw2DImageBatch(SpriteBank->getTexture(batch.Texture), batch.Positions,
+				batch.SourceRects, clip, color, true);
+	}
 }
 
 
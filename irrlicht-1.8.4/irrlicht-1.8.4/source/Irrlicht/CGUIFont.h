@@ -10,7 +10,7 @@
 
 #include "IGUIFontBitmap.h"
 #include "irrString.h"
-#include "irrMap.h"
+#include "irrHashMap.h"
 #include "IXMLReader.h"
 #include "IReadFile.h"
 #include "irrArray.h"
@@ -89,6 +89,31 @@ private:
 		u32				spriteno;
 	};
 
+	//! Glyphs of a text using the same texture, ready for draw2DImageBatch
+	struct SLayoutBatch
+	{
+		u32 Texture;
+		core::array<core::position2di> Positions;
+		core::array<core::recti> SourceRects;
+	};
+
+	//! A laid out text, cached by draw()
+	struct SLayoutEntry
+	{
+		SLayoutEntry() : Hash(0), HCenter(false), VCenter(false), Valid(false) {}
+
+		core::stringw Text;
+		core::rect<s32> Position;
+		u32 Hash;
+		bool HCenter;
+		bool VCenter;
+		bool Valid;
+
+		//! area covered by the text, for clipping
+		core::rect<s32> TextRect;
+		core::array<SLayoutBatch> Batches;
+	};
+
 	//! load & prepare font from ITexture
 	bool loadTexture(video::IImage * image, const io::path& name);
 
@@ -97,8 +122,24 @@ private:
 	s32 getAreaFromCharacter (const wchar_t c) const;
 	void setMaxHeight();
 
+	//! sets WrongCharacter, fills GlyphTable from CharacterMap and clears the layout cache
+	void updateGlyphTable();
+
+	//! returns the cached layout of a text, lays it out if necessary
+	const SLayoutEntry& getLayout(const core::stringw& text, const core::rect<s32>& position,
+			bool hcenter, bool vcenter);
+
+	void clearLayoutCache();
+
 	core::array<SFontArea>		Areas;
-	core::map<wchar_t, s32>		CharacterMap;
+	core::hash_map<wchar_t, s32>		CharacterMap;
+	//! area of each character below its size, faster than CharacterMap
+	core::array<u16>		GlyphTable;
+	//! direct mapped cache of laid out texts
+	core::array<SLayoutEntry>	LayoutCache;
+	//! sprite bank sizes the layout cache was made for
+	u32				LayoutRectangleCount;
+	u32				LayoutTextureCount;
 	video::IVideoDriver*		Driver;
 	IGUISpriteBank*			SpriteBank;
 	IGUIEnvironment*		Environment;
@@ -17,7 +17,7 @@ namespace gui
 
 //! constructor
 CGUIImage::CGUIImage(IGUIEnvironment* environment, IGUIElement* parent, s32 id, core::rect<s32> rectangle)
-: IGUIImage(environment, parent, id, rectangle), Texture(0), Color(255,255,255,255),
+: IGUIImage(environment, parent, id, rectangle), Texture(0), SourceRect(0,0,0,0), Color(255,255,255,255),
 	UseAlphaChannel(false), ScaleImage(false)
 {
 	#ifdef _DEBUG
@@ -37,6 +37,7 @@ CGUIImage::~CGUIImage()
 //! sets an image
 void CGUIImage::setImage(video::ITexture* image)
 {
+	setDirty();
 	if (image == Texture)
 		return;
 
@@ -58,6 +59,7 @@ video::ITexture* CGUIImage::getImage() const
 //! sets the color of the image
 void CGUIImage::setColor(video::SColor color)
 {
+	setDirty();
 	Color = color;
 }
 
@@ -78,18 +80,19 @@ void CGUIImage::draw()
 
 	if (Texture)
 	{
+		const core::rect<s32> sourceRect(SourceRect.getArea() ? SourceRect :
+			core::rect<s32>(core::position2d<s32>(0,0), core::dimension2di(Texture->getOriginalSize())));
+
 		if (ScaleImage)
 		{
 			const video::SColor Colors[] = {Color,Color,Color,Color};
 
-			driver->draw2DImage(Texture, AbsoluteRect,
-				core::rect<s32>(core::position2d<s32>(0,0), core::dimension2di(Texture->getOriginalSize())),
+			driver->draw2DImage(Texture, AbsoluteRect, sourceRect,
 				&AbsoluteClippingRect, Colors, UseAlphaChannel);
 		}
 		else
 		{
-			driver->draw2DImage(Texture, AbsoluteRect.UpperLeftCorner,
-				core::rect<s32>(core::position2d<s32>(0,0), core::dimension2di(Texture->getOriginalSize())),
+			driver->draw2DImage(Texture, AbsoluteRect.UpperLeftCorner, sourceRect,
 				&AbsoluteClippingRect, Color, UseAlphaChannel);
 		}
 	}
@@ -105,6 +108,7 @@ void CGUIImage::draw()
 //! sets if the image should use its alpha channel to draw itself
 void CGUIImage::setUseAlphaChannel(bool use)
 {
+	setDirty();
 	UseAlphaChannel = use;
 }
 
@@ -112,6 +116,7 @@ void CGUIImage::setUseAlphaChannel(bool use)
 //! sets if the image should use its alpha channel to draw itself
 void CGUIImage::setScaleImage(bool scale)
 {
+	setDirty();
 	ScaleImage = scale;
 }
 
@@ -131,6 +136,21 @@ bool CGUIImage::isAlphaChannelUsed() const
 }
 
 
+//! Sets the part of the texture which is drawn
+void CGUIImage::setSourceRect(const core::rect<s32>& sourceRect)
+{
+	SourceRect = sourceRect;
+	setDirty();
+}
+
+
+//! Returns the part of the texture which is drawn, empty for the whole texture
+const core::rect<s32>& CGUIImage::getSourceRect() const
+{
+	return SourceRect;
+}
+
+
 //! Writes attributes of the element.
 void CGUIImage::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options=0) const
 {
@@ -140,6 +160,7 @@ void CGUIImage::serializeAttributes(io::IAttributes* out, io::SAttributeReadWrit
 	out->addBool	("UseAlphaChannel", UseAlphaChannel);
 	out->addColor	("Color", Color);
 	out->addBool	("ScaleImage", ScaleImage);
+	out->addRect	("SourceRect", SourceRect);
 
 }
 
@@ -153,6 +174,7 @@ void CGUIImage::deserializeAttributes(io::IAttributes* in, io::SAttributeReadWri
 	setUseAlphaChannel(in->getAttributeAsBool("UseAlphaChannel"));
 	setColor(in->getAttributeAsColor("Color"));
 	setScaleImage(in->getAttributeAsBool("ScaleImage"));
+	setSourceRect(in->getAttributeAsRect("SourceRect"));
 }
 
 
@@ -52,6 +52,12 @@ namespace gui
 		//! Returns true if the image is using the alpha channel, false if not
 		virtual bool isAlphaChannelUsed() const;
 
+		//! Sets the part of the texture which is drawn
+		virtual void setSourceRect(const core::rect<s32>& sourceRect);
+
+		//! Returns the part of the texture which is drawn, empty for the whole texture
+		virtual const core::rect<s32>& getSourceRect() const;
+
 		//! Writes attributes of the element.
 		virtual void serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const;
 
@@ -60,6 +66,7 @@ namespace gui
 
 	private:
 		video::ITexture* Texture;
+		core::rect<s32> SourceRect;
 		video::SColor Color;
 		bool UseAlphaChannel;
 		bool ScaleImage;
@@ -26,7 +26,7 @@ CGUIListBox::CGUIListBox(IGUIEnvironment* environment, IGUIElement* parent,
 : IGUIListBox(environment, parent, id, rectangle), Selected(-1),
 	ItemHeight(0),ItemHeightOverride(0),
 	TotalItemHeight(0), ItemsIconWidth(0), Font(0), IconBank(0),
-	ScrollBar(0), selectTime(0), LastKeyTime(0), Selecting(false), DrawBack(drawBack),
+	ScrollBar(0), RowSource(0), selectTime(0), LastKeyTime(0), Selecting(false), DrawBack(drawBack),
 	MoveOverSelect(moveOverSelect), AutoScroll(true), HighlightWhenNotFocused(true)
 {
 	#ifdef _DEBUG
@@ -66,19 +66,25 @@ CGUIListBox::~CGUIListBox()
 
 	if (IconBank)
 		IconBank->drop();
+
+	if (RowSource)
+		RowSource->drop();
 }
 
 
 //! returns amount of list items
 u32 CGUIListBox::getItemCount() const
 {
-	return Items.size();
+	return RowSource ? RowSource->getRowCount() : Items.size();
 }
 
 
 //! returns string of a list item. the may be a value from 0 to itemCount-1
 const wchar_t* CGUIListBox::getListItem(u32 id) const
 {
+	if (RowSource)
+		return id < RowSource->getRowCount() ? RowSource->getCellText(id, 0) : 0;
+
 	if (id>=Items.size())
 		return 0;
 
@@ -89,6 +95,9 @@ const wchar_t* CGUIListBox::getListItem(u32 id) const
 //! Returns the icon of an item
 s32 CGUIListBox::getIcon(u32 id) const
 {
+	if (RowSource)
+		return id < RowSource->getRowCount() ? RowSource->getRowIcon(id) : -1;
+
 	if (id>=Items.size())
 		return -1;
 
@@ -99,6 +108,7 @@ s32 CGUIListBox::getIcon(u32 id) const
 //! adds a list item, returns id of item
 u32 CGUIListBox::addItem(const wchar_t* text)
 {
+	setDirty();
 	return addItem(text, -1);
 }
 
@@ -106,6 +116,7 @@ u32 CGUIListBox::addItem(const wchar_t* text)
 //! adds a list item, returns id of item
 void CGUIListBox::removeItem(u32 id)
 {
+	setDirty();
 	if (id >= Items.size())
 		return;
 
@@ -136,7 +147,7 @@ s32 CGUIListBox::getItemAt(s32 xpos, s32 ypos) const
 		return -1;
 
 	s32 item = ((ypos - AbsoluteRect.UpperLeftCorner.Y - 1) + ScrollBar->getPos()) / ItemHeight;
-	if ( item < 0 || item >= (s32)Items.size())
+	if ( item < 0 || item >= (s32)getItemCount())
 		return -1;
 
 	return item;
@@ -145,6 +156,7 @@ s32 CGUIListBox::getItemAt(s32 xpos, s32 ypos) const
 //! clears the list
 void CGUIListBox::clear()
 {
+	setDirty();
 	Items.clear();
 	ItemsIconWidth = 0;
 	Selected = -1;
@@ -178,7 +190,8 @@ void CGUIListBox::recalculateItemHeight()
 		}
 	}
 
-	TotalItemHeight = ItemHeight * Items.size();
+	// row sources can have more rows than the scroll range can hold
+	TotalItemHeight = (s32)core::min_((s64)ItemHeight * getItemCount(), (s64)0x7fffffff);
 	ScrollBar->setMax( core::max_(0, TotalItemHeight - AbsoluteRect.getHeight()) );
 	s32 minItemHeight = ItemHeight > 0 ? ItemHeight : 1;
 	ScrollBar->setSmallStep ( minItemHeight );
@@ -201,7 +214,8 @@ s32 CGUIListBox::getSelected() const
 //! sets the selected item. Set this to -1 if no item should be selected
 void CGUIListBox::setSelected(s32 id)
 {
-	if ((u32)id>=Items.size())
+	setDirty();
+	if ((u32)id>=getItemCount())
 		Selected = -1;
 	else
 		Selected = id;
@@ -214,19 +228,37 @@ void CGUIListBox::setSelected(s32 id)
 //! sets the selected item. Set this to -1 if no item should be selected
 void CGUIListBox::setSelected(const wchar_t *item)
 {
+	setDirty();
 	s32 index = -1;
 
 	if ( item )
 	{
-		for ( index = 0; index < (s32) Items.size(); ++index )
+		const core::stringw text(item);
+		const s32 count = (s32)getItemCount();
+		for ( index = 0; index < count; ++index )
 		{
-			if ( Items[index].text == item )
+			if ( RowSource ? text == getListItem(index) : Items[index].text == text )
 				break;
 		}
 	}
 	setSelected ( index );
 }
 
+//! returns true if the sprite bank holds animated item icons
+bool CGUIListBox::isAnimated() const
+{
+	if (!IconBank)
+		return false;
+
+	// rows might come from a row source, so check the sprites instead of the items
+	const core::array<SGUISprite>& sprites = IconBank->getSprites();
+	for (u32 i=0; i<sprites.size(); ++i)
+		if (sprites[i].Frames.size() > 1)
+			return true;
+	return false;
+}
+
+
 //! called if an event happened.
 bool CGUIListBox::OnEvent(const SEvent& event)
 {
@@ -256,7 +288,7 @@ bool CGUIListBox::OnEvent(const SEvent& event)
 						Selected = 0;
 						break;
 					case KEY_END:
-						Selected = (s32)Items.size()-1;
+						Selected = (s32)getItemCount()-1;
 						break;
 					case KEY_NEXT:
 						Selected += AbsoluteRect.getHeight() / ItemHeight;
@@ -269,9 +301,11 @@ bool CGUIListBox::OnEvent(const SEvent& event)
 				}
 				if (Selected<0)
 					Selected = 0;
-				if (Selected >= (s32)Items.size())
-					Selected = Items.size() - 1;	// will set Selected to -1 for empty listboxes which is correct
+				if (Selected >= (s32)getItemCount())
+					Selected = getItemCount() - 1;	// will set Selected to -1 for empty listboxes which is correct
 				
+				if (oldSelected != Selected)
+					setDirty();
 
 				recalculateScrollPos();
 
@@ -329,51 +363,44 @@ bool CGUIListBox::OnEvent(const SEvent& event)
 				// dont change selection if the key buffer matches the current item
 				if (Selected > -1 && KeyBuffer.size() > 1)
 				{
-					if (Items[Selected].text.size() >= KeyBuffer.size() &&
-						KeyBuffer.equals_ignore_case(Items[Selected].text.subString(0,KeyBuffer.size())))
+					if (itemStartsWith(Selected, KeyBuffer))
 						return true;
 				}
 
 				s32 current;
-				for (current = start+1; current < (s32)Items.size(); ++current)
+				for (current = start+1; current < (s32)getItemCount(); ++current)
 				{
-					if (Items[current].text.size() >= KeyBuffer.size())
+					if (itemStartsWith(current, KeyBuffer))
 					{
-						if (KeyBuffer.equals_ignore_case(Items[current].text.subString(0,KeyBuffer.size())))
+						if (Parent && Selected != current && !Selecting && !MoveOverSelect)
 						{
-							if (Parent && Selected != current && !Selecting && !MoveOverSelect)
-							{
-								SEvent e;
-								e.EventType = EET_GUI_EVENT;
-								e.GUIEvent.Caller = this;
-								e.GUIEvent.Element = 0;
-								e.GUIEvent.EventType = EGET_LISTBOX_CHANGED;
-								Parent->OnEvent(e);
-							}
-							setSelected(current);
-							return true;
+							SEvent e;
+							e.EventType = EET_GUI_EVENT;
+							e.GUIEvent.Caller = this;
+							e.GUIEvent.Element = 0;
+							e.GUIEvent.EventType = EGET_LISTBOX_CHANGED;
+							Parent->OnEvent(e);
 						}
+						setSelected(current);
+						return true;
 					}
 				}
 				for (current = 0; current <= start; ++current)
 				{
-					if (Items[current].text.size() >= KeyBuffer.size())
+					if (itemStartsWith(current, KeyBuffer))
 					{
-						if (KeyBuffer.equals_ignore_case(Items[current].text.subString(0,KeyBuffer.size())))
+						if (Parent && Selected != current && !Selecting && !MoveOverSelect)
 						{
-							if (Parent && Selected != current && !Selecting && !MoveOverSelect)
-							{
-								Selected = current;
-								SEvent e;
-								e.EventType = EET_GUI_EVENT;
-								e.GUIEvent.Caller = this;
-								e.GUIEvent.Element = 0;
-								e.GUIEvent.EventType = EGET_LISTBOX_CHANGED;
-								Parent->OnEvent(e);
-							}
-							setSelected(current);
-							return true;
+							Selected = current;
+							SEvent e;
+							e.EventType = EET_GUI_EVENT;
+							e.GUIEvent.Caller = this;
+							e.GUIEvent.Element = 0;
+							e.GUIEvent.EventType = EGET_LISTBOX_CHANGED;
+							Parent->OnEvent(e);
 						}
+						setSelected(current);
+						return true;
 					}
 				}
 
@@ -456,9 +483,12 @@ void CGUIListBox::selectNew(s32 ypos, bool onlyHover)
 	s32 oldSelected = Selected;
 
 	Selected = getItemAt(AbsoluteRect.UpperLeftCorner.X, ypos);
-	if (Selected<0 && !Items.empty())
+	if (Selected<0 && getItemCount())
 		Selected = 0;
 
+	if (Selected != oldSelected)
+		setDirty();
+
 	recalculateScrollPos();
 
 	gui::EGUI_EVENT_TYPE eventType = (Selected == oldSelected && now < selectTime + 500) ? EGET_LISTBOX_SELECTED_AGAIN : EGET_LISTBOX_CHANGED;
@@ -528,11 +558,25 @@ void CGUIListBox::draw()
 
 	bool hl = (HighlightWhenNotFocused || Environment->hasFocus(this) || Environment->hasFocus(ScrollBar));
 
-	for (s32 i=0; i<(s32)Items.size(); ++i)
+	// skip the items above the visible area, the first drawn one may be partly hidden
+	const s32 count = (s32)getItemCount();
+	s32 i = 0;
+	if (ItemHeight > 0 && ScrollBar->getPos() > 0)
+	{
+		i = (ScrollBar->getPos() + ItemHeight - 1) / ItemHeight - 1;
+		frameRect.UpperLeftCorner.Y += i * ItemHeight;
+		frameRect.LowerRightCorner.Y += i * ItemHeight;
+	}
+
+	for (; i<count && frameRect.UpperLeftCorner.Y <= AbsoluteRect.LowerRightCorner.Y; ++i)
 	{
-		if (frameRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y &&
-			frameRect.UpperLeftCorner.Y <= AbsoluteRect.LowerRightCorner.Y)
+		if (frameRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y)
 		{
+			const wchar_t* text = getListItem(i);
+			const s32 icon = getIcon(i);
+			if (RowSource)
+				recalculateItemWidth(icon);
+
 			if (i == Selected && hl)
 				skin->draw2DRectangle(this, skin->getColor(EGDC_HIGH_LIGHT), frameRect, &clientClip);
 
@@ -541,7 +585,7 @@ void CGUIListBox::draw()
 
 			if (Font)
 			{
-				if (IconBank && (Items[i].icon > -1))
+				if (IconBank && (icon > -1))
 				{
 					core::position2di iconPos = textRect.UpperLeftCorner;
 					iconPos.Y += textRect.getHeight() / 2;
@@ -549,14 +593,14 @@ void CGUIListBox::draw()
 
 					if ( i==Selected && hl )
 					{
-						IconBank->draw2DSprite( (u32)Items[i].icon, iconPos, &clientClip,
+						IconBank->draw2DSprite( (u32)icon, iconPos, &clientClip,
 							hasItemOverrideColor(i, EGUI_LBC_ICON_HIGHLIGHT) ?
 							getItemOverrideColor(i, EGUI_LBC_ICON_HIGHLIGHT) : getItemDefaultColor(EGUI_LBC_ICON_HIGHLIGHT),
 							selectTime, os::Timer::getTime(), false, true);
 					}
 					else
 					{
-						IconBank->draw2DSprite( (u32)Items[i].icon, iconPos, &clientClip,
+						IconBank->draw2DSprite( (u32)icon, iconPos, &clientClip,
 							hasItemOverrideColor(i, EGUI_LBC_ICON) ? getItemOverrideColor(i, EGUI_LBC_ICON) : getItemDefaultColor(EGUI_LBC_ICON),
 							0 , (i==Selected) ? os::Timer::getTime() : 0, false, true);
 					}
@@ -566,16 +610,18 @@ void CGUIListBox::draw()
 
 				if ( i==Selected && hl )
 				{
-					Font->draw(Items[i].text.c_str(), textRect,
+					Font->draw(text, textRect,
 						hasItemOverrideColor(i, EGUI_LBC_TEXT_HIGHLIGHT) ?
 						getItemOverrideColor(i, EGUI_LBC_TEXT_HIGHLIGHT) : getItemDefaultColor(EGUI_LBC_TEXT_HIGHLIGHT),
 						false, true, &clientClip);
 				}
 				else
 				{
-					Font->draw(Items[i].text.c_str(), textRect,
-						hasItemOverrideColor(i, EGUI_LBC_TEXT) ? getItemOverrideColor(i, EGUI_LBC_TEXT) : getItemDefaultColor(EGUI_LBC_TEXT),
-						false, true, &clientClip);
+					video::SColor color(hasItemOverrideColor(i, EGUI_LBC_TEXT) ? getItemOverrideColor(i, EGUI_LBC_TEXT) : getItemDefaultColor(EGUI_LBC_TEXT));
+					video::SColor sourceColor;
+					if (RowSource && RowSource->getCellColor(i, 0, sourceColor))
+						color = sourceColor;
+					Font->draw(text, textRect, color, false, true, &clientClip);
 				}
 
 				textRect.UpperLeftCorner.X -= ItemsIconWidth+3;
@@ -593,6 +639,7 @@ void CGUIListBox::draw()
 //! adds an list item with an icon
 u32 CGUIListBox::addItem(const wchar_t* text, s32 icon)
 {
+	setDirty();
 	ListItem i;
 	i.text = text;
 	i.icon = icon;
@@ -615,6 +662,8 @@ void CGUIListBox::setSpriteBank(IGUISpriteBank* bank)
 	IconBank = bank;
 	if (IconBank)
 		IconBank->grab();
+
+	setDirty();
 }
 
 
@@ -623,7 +672,8 @@ void CGUIListBox::recalculateScrollPos()
 	if (!AutoScroll)
 		return;
 
-	const s32 selPos = (Selected == -1 ? TotalItemHeight : Selected * ItemHeight) - ScrollBar->getPos();
+	const s64 itemPos = Selected == -1 ? TotalItemHeight : core::min_((s64)Selected * ItemHeight, (s64)0x7fffffff);
+	const s32 selPos = (s32)(itemPos - ScrollBar->getPos());
 
 	if (selPos < 0)
 	{
@@ -773,6 +823,7 @@ void CGUIListBox::recalculateItemWidth(s32 icon)
 
 void CGUIListBox::setItem(u32 index, const wchar_t* text, s32 icon)
 {
+	setDirty();
 	if ( index >= Items.size() )
 		return;
 
@@ -788,6 +839,7 @@ void CGUIListBox::setItem(u32 index, const wchar_t* text, s32 icon)
 //! Return the index on success or -1 on failure.
 s32 CGUIListBox::insertItem(u32 index, const wchar_t* text, s32 icon)
 {
+	setDirty();
 	ListItem i;
 	i.text = text;
 	i.icon = icon;
@@ -802,6 +854,7 @@ s32 CGUIListBox::insertItem(u32 index, const wchar_t* text, s32 icon)
 
 void CGUIListBox::swapItems(u32 index1, u32 index2)
 {
+	setDirty();
 	if ( index1 >= Items.size() || index2 >= Items.size() )
 		return;
 
@@ -813,6 +866,7 @@ void CGUIListBox::swapItems(u32 index1, u32 index2)
 
 void CGUIListBox::setItemOverrideColor(u32 index, video::SColor color)
 {
+	setDirty();
 	for ( u32 c=0; c < EGUI_LBC_COUNT; ++c )
 	{
 		Items[index].OverrideColors[c].Use = true;
@@ -823,6 +877,7 @@ void CGUIListBox::setItemOverrideColor(u32 index, video::SColor color)
 
 void CGUIListBox::setItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType, video::SColor color)
 {
+	setDirty();
 	if ( index >= Items.size() || colorType < 0 || colorType >= EGUI_LBC_COUNT )
 		return;
 
@@ -833,6 +888,7 @@ void CGUIListBox::setItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType,
 
 void CGUIListBox::clearItemOverrideColor(u32 index)
 {
+	setDirty();
 	for (u32 c=0; c < (u32)EGUI_LBC_COUNT; ++c )
 	{
 		Items[index].OverrideColors[c].Use = false;
@@ -842,6 +898,7 @@ void CGUIListBox::clearItemOverrideColor(u32 index)
 
 void CGUIListBox::clearItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType)
 {
+	setDirty();
 	if ( index >= Items.size() || colorType < 0 || colorType >= EGUI_LBC_COUNT )
 		return;
 
@@ -891,6 +948,7 @@ video::SColor CGUIListBox::getItemDefaultColor(EGUI_LISTBOX_COLOR colorType) con
 //! set global itemHeight
 void CGUIListBox::setItemHeight( s32 height )
 {
+	setDirty();
 	ItemHeight = height;
 	ItemHeightOverride = 1;
 }
@@ -899,10 +957,52 @@ void CGUIListBox::setItemHeight( s32 height )
 //! Sets whether to draw the background
 void CGUIListBox::setDrawBackground(bool draw)
 {
+	setDirty();
     DrawBack = draw;
 }
 
 
+//! Lets the list box ask a row source for its items
+void CGUIListBox::setRowSource(IGUIRowSource* source)
+{
+	setDirty();
+	if (source)
+		source->grab();
+	if (RowSource)
+		RowSource->drop();
+	RowSource = source;
+
+	Selected = -1;
+	if (ScrollBar)
+		ScrollBar->setPos(0);
+
+	recalculateItemHeight();
+}
+
+
+//! Returns the row source, or 0 if there is none
+IGUIRowSource* CGUIListBox::getRowSource() const
+{
+	return RowSource;
+}
+
+
+//! returns true if the text of an item starts with the text, ignoring case
+bool CGUIListBox::itemStartsWith(u32 index, const core::stringw& text) const
+{
+	const wchar_t* item = getListItem(index);
+	if (!item)
+		return false;
+
+	for (u32 i=0; i<text.size(); ++i)
+	{
+		if (!item[i] || core::locale_lower(item[i]) != core::locale_lower(text[i]))
+			return false;
+	}
+	return true;
+}
+
+
 } // end namespace gui
 } // end namespace irr
 
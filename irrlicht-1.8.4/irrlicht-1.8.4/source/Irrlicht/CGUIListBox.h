@@ -57,6 +57,9 @@ namespace gui
 		//! draws the element and its children
 		virtual void draw();
 
+		//! Returns true if the sprite bank holds animated item icons
+		virtual bool isAnimated() const;
+
 		//! adds an list item with an icon
 		//! \param text Text of list entry
 		//! \param icon Sprite index of the Icon within the current sprite bank. Set it to -1 if you want no icon
@@ -131,6 +134,12 @@ namespace gui
         //! Sets whether to draw the background
         virtual void setDrawBackground(bool draw);
 
+		//! Lets the list box ask a row source for its items
+		virtual void setRowSource(IGUIRowSource* source);
+
+		//! Returns the row source, or 0 if there is none
+		virtual IGUIRowSource* getRowSource() const;
+
 
 	private:
 
@@ -156,6 +165,9 @@ namespace gui
 		void selectNew(s32 ypos, bool onlyHover=false);
 		void recalculateScrollPos();
 
+		//! returns true if the text of an item starts with the text, ignoring case
+		bool itemStartsWith(u32 index, const core::stringw& text) const;
+
 		// extracted that function to avoid copy&paste code
 		void recalculateItemWidth(s32 icon);
 
@@ -171,6 +183,7 @@ namespace gui
 		gui::IGUIFont* Font;
 		gui::IGUISpriteBank* IconBank;
 		gui::IGUIScrollBar* ScrollBar;
+		gui::IGUIRowSource* RowSource;
 		u32 selectTime;
 		u32 LastKeyTime;
 		core::stringw KeyBuffer;
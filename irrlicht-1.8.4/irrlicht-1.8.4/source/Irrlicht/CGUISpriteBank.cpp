@@ -131,6 +131,36 @@ s32 CGUISpriteBank::addTextureAsSprite(video::ITexture* texture)
 	return Sprites.size() - 1;
 }
 
+//! Add a part of a texture and use it for a single non-animated sprite.
+s32 CGUISpriteBank::addTextureAsSprite(video::ITexture* texture, const core::rect<s32>& sourceRect)
+{
+	if ( !texture || !sourceRect.isValid() )
+		return -1;
+
+	// sprites from an atlas share its pages
+	s32 textureIndex = Textures.linear_search(texture);
+	if ( textureIndex < 0 )
+	{
+		addTexture(texture);
+		textureIndex = getTextureCount() - 1;
+	}
+
+	u32 rectangleIndex = Rectangles.size();
+	Rectangles.push_back( sourceRect );
+
+	SGUISprite sprite;
+	sprite.frameTime = 0;
+
+	SGUISpriteFrame frame;
+	frame.textureNumber = textureIndex;
+	frame.rectNumber = rectangleIndex;
+	sprite.Frames.push_back( frame );
+
+	Sprites.push_back( sprite );
+
+	return Sprites.size() - 1;
+}
+
 //! draws a sprite in 2d with scale and color
 void CGUISpriteBank::draw2DSprite(u32 index, const core::position2di& pos,
 		const core::rect<s32>* clip, const video::SColor& color,
@@ -184,12 +214,19 @@ void CGUISpriteBank::draw2DSpriteBatch(	const core::array<u32>& indices,
 
 	if( Textures.empty() )
 		return;
-	core::array<SDrawBatch> drawBatches(Textures.size());
+	// reuse the batches of the last call, so drawing does not allocate
+	core::array<SDrawBatch>& drawBatches = DrawBatches;
+	while (drawBatches.size() < Textures.size())
+		drawBatches.push_back(SDrawBatch());
 	for(u32 i = 0;i < Textures.size();i++)
 	{
-		drawBatches.push_back(SDrawBatch());
-		drawBatches[i].positions.reallocate(drawCount);
-		drawBatches[i].sourceRects.reallocate(drawCount);
+		drawBatches[i].positions.set_used(0);
+		drawBatches[i].sourceRects.set_used(0);
+		if (drawBatches[i].positions.allocated_size() < drawCount)
+		{
+			drawBatches[i].positions.reallocate(drawCount);
+			drawBatches[i].sourceRects.reallocate(drawCount);
+		}
 	}
 
 	for(u32 i = 0;i < drawCount;i++)
@@ -235,7 +272,7 @@ void CGUISpriteBank::draw2DSpriteBatch(	const core::array<u32>& indices,
 		}
 	}
 
-	for(u32 i = 0;i < drawBatches.size();i++)
+	for(u32 i = 0;i < Textures.size();i++)
 	{
 		if(!drawBatches[i].positions.empty() && !drawBatches[i].sourceRects.empty())
 			Driver->draw2DImageBatch(Textures[i], drawBatches[i].positions,
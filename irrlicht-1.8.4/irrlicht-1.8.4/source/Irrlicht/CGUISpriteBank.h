@@ -43,6 +43,9 @@ public:
 	//! Add the texture and use it for a single non-animated sprite.
 	virtual s32 addTextureAsSprite(video::ITexture* texture);
 
+	//! Add a part of a texture and use it for a single non-animated sprite.
+	virtual s32 addTextureAsSprite(video::ITexture* texture, const core::rect<s32>& sourceRect);
+
 	//! clears sprites, rectangles and textures
 	virtual void clear();
 
@@ -69,6 +72,8 @@ protected:
 
 	core::array<SGUISprite> Sprites;
 	core::array< core::rect<s32> > Rectangles;
+	//! batches of draw2DSpriteBatch, kept to reuse their memory
+	core::array<SDrawBatch> DrawBatches;
 	core::array<video::ITexture*> Textures;
 	IGUIEnvironment* Environment;
 	video::IVideoDriver* Driver;
@@ -157,6 +157,7 @@ void CGUIStaticText::setOverrideFont(IGUIFont* font)
 	if (OverrideFont)
 		OverrideFont->grab();
 
+	setDirty();
 	breakText();
 }
 
@@ -180,6 +181,7 @@ IGUIFont* CGUIStaticText::getActiveFont() const
 //! Sets another color for the text.
 void CGUIStaticText::setOverrideColor(video::SColor color)
 {
+	setDirty();
 	OverrideColor = color;
 	OverrideColorEnabled = true;
 }
@@ -188,6 +190,7 @@ void CGUIStaticText::setOverrideColor(video::SColor color)
 //! Sets another color for the text.
 void CGUIStaticText::setBackgroundColor(video::SColor color)
 {
+	setDirty();
 	BGColor = color;
 	OverrideBGColorEnabled = true;
 	Background = true;
@@ -197,6 +200,7 @@ void CGUIStaticText::setBackgroundColor(video::SColor color)
 //! Sets whether to draw the background
 void CGUIStaticText::setDrawBackground(bool draw)
 {
+	setDirty();
 	Background = draw;
 }
 
@@ -219,6 +223,7 @@ bool CGUIStaticText::isDrawBackgroundEnabled() const
 //! Sets whether to draw the border
 void CGUIStaticText::setDrawBorder(bool draw)
 {
+	setDirty();
 	Border = draw;
 }
 
@@ -233,6 +238,7 @@ bool CGUIStaticText::isDrawBorderEnabled() const
 
 void CGUIStaticText::setTextRestrainedInside(bool restrainTextInside)
 {
+	setDirty();
 	RestrainTextInside = restrainTextInside;
 }
 
@@ -245,6 +251,7 @@ bool CGUIStaticText::isTextRestrainedInside() const
 
 void CGUIStaticText::setTextAlignment(EGUI_ALIGNMENT horizontal, EGUI_ALIGNMENT vertical)
 {
+	setDirty();
 	HAlign = horizontal;
 	VAlign = vertical;
 }
@@ -260,6 +267,7 @@ video::SColor CGUIStaticText::getOverrideColor() const
 //! color in the gui skin.
 void CGUIStaticText::enableOverrideColor(bool enable)
 {
+	setDirty();
 	OverrideColorEnabled = enable;
 }
 
@@ -275,6 +283,7 @@ bool CGUIStaticText::isOverrideColorEnabled() const
 //! multiline text control.
 void CGUIStaticText::setWordWrap(bool enable)
 {
+	setDirty();
 	WordWrap = enable;
 	breakText();
 }
@@ -292,6 +301,7 @@ void CGUIStaticText::setRightToLeft(bool rtl)
 	if (RightToLeft != rtl)
 	{
 		RightToLeft = rtl;
+		setDirty();
 		breakText();
 	}
 }
@@ -80,6 +80,7 @@ void CGUITab::draw()
 //! sets if the tab should draw its background
 void CGUITab::setDrawBackground(bool draw)
 {
+	setDirty();
 	DrawBackground = draw;
 }
 
@@ -87,6 +88,7 @@ void CGUITab::setDrawBackground(bool draw)
 //! sets the color of the background, if it should be drawn.
 void CGUITab::setBackgroundColor(video::SColor c)
 {
+	setDirty();
 	BackColor = c;
 }
 
@@ -94,6 +96,7 @@ void CGUITab::setBackgroundColor(video::SColor c)
 //! sets the color of the text
 void CGUITab::setTextColor(video::SColor c)
 {
+	setDirty();
 	OverrideTextColorEnabled = true;
 	TextColor = c;
 }
@@ -343,6 +346,7 @@ IGUITab* CGUITabControl::insertTab(s32 idx, const wchar_t* caption, s32 id)
 //! Removes a tab from the tabcontrol
 void CGUITabControl::removeTab(s32 idx)
 {
+	setDirty();
 	if ( idx < 0 || idx >= (s32)Tabs.size() )
 		return;
 
@@ -357,6 +361,7 @@ void CGUITabControl::removeTab(s32 idx)
 //! Clears the tabcontrol removing all tabs
 void CGUITabControl::clear()
 {
+	setDirty();
 	for (u32 i=0; i<Tabs.size(); ++i)
 	{
 		if (Tabs[i])
@@ -441,6 +446,7 @@ bool CGUITabControl::OnEvent(const SEvent& event)
 
 void CGUITabControl::scrollLeft()
 {
+	setDirty();
 	if ( CurrentScrollTabIndex > 0 )
 		--CurrentScrollTabIndex;
 	recalculateScrollBar();
@@ -449,6 +455,7 @@ void CGUITabControl::scrollLeft()
 
 void CGUITabControl::scrollRight()
 {
+	setDirty();
 	if ( CurrentScrollTabIndex < (s32)(Tabs.size()) - 1 )
 	{
 		if ( needScrollControl(CurrentScrollTabIndex, true) )
@@ -742,6 +749,7 @@ void CGUITabControl::draw()
 //! Set the height of the tabs
 void CGUITabControl::setTabHeight( s32 height )
 {
+	setDirty();
 	if ( height < 0 )
 		height = 0;
 
@@ -761,6 +769,7 @@ s32 CGUITabControl::getTabHeight() const
 //! set the maximal width of a tab. Per default width is 0 which means "no width restriction".
 void CGUITabControl::setTabMaxWidth(s32 width )
 {
+	setDirty();
 	TabMaxWidth = width;
 }
 
@@ -774,6 +783,7 @@ s32 CGUITabControl::getTabMaxWidth() const
 //! Set the extra width added to tabs on each side of the text
 void CGUITabControl::setTabExtraWidth( s32 extraWidth )
 {
+	setDirty();
 	if ( extraWidth < 0 )
 		extraWidth = 0;
 
@@ -815,6 +825,7 @@ void CGUITabControl::recalculateScrollBar()
 //! Set the alignment of the tabs
 void CGUITabControl::setTabVerticalAlignment( EGUI_ALIGNMENT alignment )
 {
+	setDirty();
 	VerticalAlignment = alignment;
 
 	recalculateScrollButtonPlacement();
@@ -927,6 +938,7 @@ s32 CGUITabControl::getActiveTab() const
 //! Brings a tab to front.
 bool CGUITabControl::setActiveTab(s32 idx)
 {
+	setDirty();
 	if ((u32)idx >= Tabs.size())
 		return false;
 
@@ -22,11 +22,29 @@ namespace irr
 namespace gui
 {
 
+namespace
+{
+	//! sort key of a table row, rows with equal text keep their order
+	struct RowOrder
+	{
+		const core::stringw* Text;
+		u32 Index;
+		bool Descending;
+
+		bool operator<(const RowOrder& other) const
+		{
+			if ( *Text == *other.Text )
+				return Index < other.Index;
+			return Descending ? *other.Text < *Text : *Text < *other.Text;
+		}
+	};
+}
+
 //! constructor
 CGUITable::CGUITable(IGUIEnvironment* environment, IGUIElement* parent,
 						s32 id, const core::rect<s32>& rectangle, bool clip,
 						bool drawBack, bool moveOverSelect)
-: IGUITable(environment, parent, id, rectangle), Font(0),
+: IGUITable(environment, parent, id, rectangle), RowSource(0), Font(0),
 	VerticalScrollBar(0), HorizontalScrollBar(0),
 	Clip(clip), DrawBack(drawBack), MoveOverSelect(moveOverSelect),
 	Selecting(false), CurrentResizedColumn(-1), ResizeStart(0), ResizableColumns(true),
@@ -68,11 +86,15 @@ CGUITable::~CGUITable()
 
 	if (Font)
 		Font->drop();
+
+	if (RowSource)
+		RowSource->drop();
 }
 
 
 void CGUITable::addColumn(const wchar_t* caption, s32 columnIndex)
 {
+	setDirty();
 	Column tabHeader;
 	tabHeader.Name = caption;
 	tabHeader.Width = Font->getDimension(caption).Width + (CellWidthPadding * 2) + ARROW_PAD;
@@ -107,6 +129,7 @@ void CGUITable::addColumn(const wchar_t* caption, s32 columnIndex)
 //! remove a column from the table
 void CGUITable::removeColumn(u32 columnIndex)
 {
+	setDirty();
 	if ( columnIndex < Columns.size() )
 	{
 		Columns.erase(columnIndex);
@@ -130,12 +153,13 @@ s32 CGUITable::getColumnCount() const
 
 s32 CGUITable::getRowCount() const
 {
-	return Rows.size();
+	return RowSource ? RowSource->getRowCount() : Rows.size();
 }
 
 
 bool CGUITable::setActiveColumn(s32 idx, bool doOrder )
 {
+	setDirty();
 	if (idx < 0 || idx >= (s32)Columns.size())
 		return false;
 
@@ -213,6 +237,7 @@ EGUI_ORDERING_MODE CGUITable::getActiveColumnOrdering() const
 
 void CGUITable::setColumnWidth(u32 columnIndex, u32 width)
 {
+	setDirty();
 	if ( columnIndex < Columns.size() )
 	{
 		const u32 MIN_WIDTH = Font->getDimension(Columns[columnIndex].Name.c_str() ).Width + (CellWidthPadding * 2);
@@ -252,6 +277,7 @@ bool CGUITable::hasResizableColumns() const
 
 u32 CGUITable::addRow(u32 rowIndex)
 {
+	setDirty();
 	if ( rowIndex > Rows.size() )
 	{
 		rowIndex = Rows.size();
@@ -277,6 +303,7 @@ u32 CGUITable::addRow(u32 rowIndex)
 
 void CGUITable::removeRow(u32 rowIndex)
 {
+	setDirty();
 	if ( rowIndex > Rows.size() )
 		return;
 
@@ -292,6 +319,7 @@ void CGUITable::removeRow(u32 rowIndex)
 //! adds an list item, returns id of item
 void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw& text)
 {
+	setDirty();
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		Rows[rowIndex].Items[columnIndex].Text = text;
@@ -305,6 +333,7 @@ void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw&
 
 void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw& text, video::SColor color)
 {
+	setDirty();
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		Rows[rowIndex].Items[columnIndex].Text = text;
@@ -317,6 +346,7 @@ void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw&
 
 void CGUITable::setCellColor(u32 rowIndex, u32 columnIndex, video::SColor color)
 {
+	setDirty();
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		Rows[rowIndex].Items[columnIndex].Color = color;
@@ -336,6 +366,9 @@ void CGUITable::setCellData(u32 rowIndex, u32 columnIndex, void *data)
 
 const wchar_t* CGUITable::getCellText(u32 rowIndex, u32 columnIndex ) const
 {
+	if ( RowSource )
+		return rowIndex < RowSource->getRowCount() && columnIndex < Columns.size() ? RowSource->getCellText(rowIndex, columnIndex) : 0;
+
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		return Rows[rowIndex].Items[columnIndex].Text.c_str();
@@ -359,6 +392,7 @@ void* CGUITable::getCellData(u32 rowIndex, u32 columnIndex ) const
 //! clears the list
 void CGUITable::clear()
 {
+	setDirty();
     Selected = -1;
 	Rows.clear();
 	Columns.clear();
@@ -375,6 +409,7 @@ void CGUITable::clear()
 
 void CGUITable::clearRows()
 {
+	setDirty();
     Selected = -1;
 	Rows.clear();
 
@@ -395,8 +430,9 @@ s32 CGUITable::getSelected() const
 //! set wich row is currently selected
 void CGUITable::setSelected( s32 index )
 {
+	setDirty();
 	Selected = -1;
-	if ( index >= 0 && index < (s32) Rows.size() )
+	if ( index >= 0 && index < getRowCount() )
 		Selected = index;
 }
 
@@ -424,6 +460,7 @@ void CGUITable::recalculateHeights()
 		Font = skin->getFont();
 
 		ItemHeight = 0;
+		SourceCells.clear();
 
 		if(Font)
 		{
@@ -431,7 +468,8 @@ void CGUITable::recalculateHeights()
 			Font->grab();
 		}
 	}
-	TotalItemHeight = ItemHeight * Rows.size();		//  header is not counted, because we only want items
+	//  header is not counted, because we only want items. Row sources can have more rows than the scroll range can hold
+	TotalItemHeight = (s32)core::min_((s64)ItemHeight * getRowCount(), (s64)0x7fffffff);
 	checkScrollbars();
 }
 
@@ -681,6 +719,7 @@ void CGUITable::setColumnOrdering(u32 columnIndex, EGUI_COLUMN_ORDERING mode)
 
 void CGUITable::swapRows(u32 rowIndexA, u32 rowIndexB)
 {
+	setDirty();
 	if ( rowIndexA >= Rows.size() )
 		return;
 
@@ -782,53 +821,44 @@ bool CGUITable::selectColumnHeader(s32 xpos, s32 ypos)
 
 void CGUITable::orderRows(s32 columnIndex, EGUI_ORDERING_MODE mode)
 {
-	Row swap;
+	setDirty();
+
+	// rows of a source are sorted by the source
+	if ( RowSource )
+		return;
 
 	if ( columnIndex == -1 )
 		columnIndex = getActiveColumn();
 	if ( columnIndex < 0 )
 		return;
 
-	if ( mode == EGOM_ASCENDING )
+	if ( mode != EGOM_ASCENDING && mode != EGOM_DESCENDING )
+		return;
+
+	// sort the row indices and move every row only once
+	core::array<RowOrder> order;
+	order.reallocate(Rows.size());
+	for ( u32 i = 0 ; i < Rows.size() ; ++i )
 	{
-		for ( s32 i = 0 ; i < s32(Rows.size()) - 1 ; ++i )
-		{
-			for ( s32 j = 0 ; j < s32(Rows.size()) - i - 1 ; ++j )
-			{
-				if ( Rows[j+1].Items[columnIndex].Text < Rows[j].Items[columnIndex].Text )
-				{
-					swap = Rows[j];
-					Rows[j] = Rows[j+1];
-					Rows[j+1] = swap;
-
-					if ( Selected == j )
-						Selected = j+1;
-					else if( Selected == j+1 )
-						Selected = j;
-				}
-			}
-		}
+		RowOrder key;
+		key.Text = &Rows[i].Items[columnIndex].Text;
+		key.Index = i;
+		key.Descending = mode == EGOM_DESCENDING;
+		order.push_back(key);
 	}
-	else if ( mode == EGOM_DESCENDING )
+	order.sort();
+
+	core::array< Row > sorted;
+	sorted.reallocate(Rows.size());
+	s32 selected = -1;
+	for ( u32 i = 0 ; i < order.size() ; ++i )
 	{
-		for ( s32 i = 0 ; i < s32(Rows.size()) - 1 ; ++i )
-		{
-			for ( s32 j = 0 ; j < s32(Rows.size()) - i - 1 ; ++j )
-			{
-				if ( Rows[j].Items[columnIndex].Text < Rows[j+1].Items[columnIndex].Text)
-				{
-					swap = Rows[j];
-					Rows[j] = Rows[j+1];
-					Rows[j+1] = swap;
-
-					if ( Selected == j )
-						Selected = j+1;
-					else if( Selected == j+1 )
-						Selected = j;
-				}
-			}
-		}
+		sorted.push_back(Rows[order[i].Index]);
+		if ( (s32)order[i].Index == Selected )
+			selected = i;
 	}
+	Rows.swap(sorted);
+	Selected = selected;
 }
 
 
@@ -847,11 +877,14 @@ void CGUITable::selectNew(s32 ypos, bool onlyHover)
 	if (ItemHeight!=0)
 		Selected = ((ypos - AbsoluteRect.UpperLeftCorner.Y - ItemHeight - 1) + VerticalScrollBar->getPos()) / ItemHeight;
 
-	if (Selected >= (s32)Rows.size())
-		Selected = Rows.size() - 1;
+	if (Selected >= getRowCount())
+		Selected = getRowCount() - 1;
 	else if (Selected<0)
 		Selected = 0;
 
+	if (Selected != oldSelected)
+		setDirty();
+
 	// post the news
 	if (Parent && !onlyHover)
 	{
@@ -881,6 +914,10 @@ void CGUITable::draw()
 	if (!font)
 		return;
 
+	// the amount of rows of a source can change at any time
+	if ( RowSource && TotalItemHeight != (s32)core::min_((s64)ItemHeight * getRowCount(), (s64)0x7fffffff) )
+		recalculateHeights();
+
 	// CAREFUL: near identical calculations for tableRect and clientClip are also done in checkScrollbars and selectColumnHeader
 	// Area of table used for drawing without scrollbars
 	core::rect<s32> tableRect(AbsoluteRect);
@@ -921,11 +958,20 @@ void CGUITable::draw()
 	core::rect<s32> rowRect(scrolledTableClient);
 	rowRect.LowerRightCorner.Y = rowRect.UpperLeftCorner.Y + ItemHeight;
 
+	// skip the rows above the visible area, the first drawn one may be partly hidden
+	const s32 rowCount = getRowCount();
+	s32 i = 0;
+	if ( ItemHeight > 0 && rowRect.LowerRightCorner.Y < AbsoluteRect.UpperLeftCorner.Y )
+	{
+		i = (AbsoluteRect.UpperLeftCorner.Y - rowRect.LowerRightCorner.Y + ItemHeight - 1) / ItemHeight;
+		rowRect.UpperLeftCorner.Y += i * ItemHeight;
+		rowRect.LowerRightCorner.Y += i * ItemHeight;
+	}
+
 	u32 pos;
-	for ( u32 i = 0 ; i < Rows.size() ; ++i )
+	for ( ; i < rowCount && rowRect.UpperLeftCorner.Y <= AbsoluteRect.LowerRightCorner.Y ; ++i )
 	{
-		if (rowRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y &&
-			rowRect.UpperLeftCorner.Y <= AbsoluteRect.LowerRightCorner.Y)
+		if (rowRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y)
 		{
 			// draw row seperator
 			if ( DrawFlags & EGTDF_ROWS )
@@ -939,7 +985,7 @@ void CGUITable::draw()
 			pos = rowRect.UpperLeftCorner.X;
 
 			// draw selected row background highlighted
-			if ((s32)i == Selected && DrawFlags & EGTDF_ACTIVE_ROW )
+			if (i == Selected && DrawFlags & EGTDF_ACTIVE_ROW )
 				driver->draw2DRectangle(skin->getColor(EGDC_HIGH_LIGHT), rowRect, &clientClip);
 
 			for ( u32 j = 0 ; j < Columns.size() ; ++j )
@@ -948,15 +994,27 @@ void CGUITable::draw()
 				textRect.LowerRightCorner.X = pos + Columns[j].Width - CellWidthPadding;
 
 				// draw item text
-				if ((s32)i == Selected)
+				const core::stringw& text = RowSource ? getSourceCellText(i, j) : Rows[i].Items[j].BrokenText;
+				if (i == Selected)
 				{
-					font->draw(Rows[i].Items[j].BrokenText.c_str(), textRect, skin->getColor(isEnabled() ? EGDC_HIGH_LIGHT_TEXT : EGDC_GRAY_TEXT), false, true, &clientClip);
+					font->draw(text, textRect, skin->getColor(isEnabled() ? EGDC_HIGH_LIGHT_TEXT : EGDC_GRAY_TEXT), false, true, &clientClip);
 				}
 				else
 				{
-					if ( !Rows[i].Items[j].IsOverrideColor )	// skin-colors can change
-						Rows[i].Items[j].Color = skin->getColor(EGDC_BUTTON_TEXT);
-					font->draw(Rows[i].Items[j].BrokenText.c_str(), textRect, isEnabled() ? Rows[i].Items[j].Color : skin->getColor(EGDC_GRAY_TEXT), false, true, &clientClip);
+					video::SColor color(skin->getColor(EGDC_BUTTON_TEXT));
+					if ( RowSource )
+					{
+						video::SColor sourceColor;
+						if ( RowSource->getCellColor(i, j, sourceColor) )
+							color = sourceColor;
+					}
+					else
+					{
+						if ( !Rows[i].Items[j].IsOverrideColor )	// skin-colors can change
+							Rows[i].Items[j].Color = color;
+						color = Rows[i].Items[j].Color;
+					}
+					font->draw(text, textRect, isEnabled() ? color : skin->getColor(EGDC_GRAY_TEXT), false, true, &clientClip);
 				}
 
 				pos += Columns[j].Width;
@@ -1077,6 +1135,7 @@ void CGUITable::breakText(const core::stringw& text, core::stringw& brokenText,
 //! Set some flags influencing the layout of the table
 void CGUITable::setDrawFlags(s32 flags)
 {
+	setDirty();
 	DrawFlags = flags;
 }
 
@@ -1249,6 +1308,65 @@ void CGUITable::deserializeAttributes(io::IAttributes* in, io::SAttributeReadWri
 	refreshControls();
 }
 
+//! Lets the table ask a row source for the text of its cells
+void CGUITable::setRowSource(IGUIRowSource* source)
+{
+	setDirty();
+	if ( source )
+		source->grab();
+	if ( RowSource )
+		RowSource->drop();
+	RowSource = source;
+
+	SourceCells.clear();
+	Selected = -1;
+	if ( VerticalScrollBar )
+		VerticalScrollBar->setPos(0);
+
+	recalculateHeights();
+}
+
+
+//! Returns the row source, or 0 if there is none
+IGUIRowSource* CGUITable::getRowSource() const
+{
+	return RowSource;
+}
+
+
+//! returns the shortened text of a cell of the row source
+/** Shortening is slow, so the results for the visible cells are kept in
+a small direct mapped cache. */
+const core::stringw& CGUITable::getSourceCellText(u32 rowIndex, u32 columnIndex)
+{
+	const u32 CACHE_SIZE = 512;
+	if ( SourceCells.empty() )
+	{
+		SourceCells.reallocate(CACHE_SIZE);
+		for ( u32 i=0; i<CACHE_SIZE; ++i )
+			SourceCells.push_back(SourceCell());
+	}
+
+	SourceCell& cell = SourceCells[(rowIndex * Columns.size() + columnIndex) & (CACHE_SIZE-1)];
+	const wchar_t* text = RowSource->getCellText(rowIndex, columnIndex);
+	if ( !text )
+		text = L"";
+
+	if ( !cell.Valid || cell.Row != rowIndex || cell.Column != columnIndex ||
+		cell.Width != Columns[columnIndex].Width || cell.Text != text )
+	{
+		cell.Row = rowIndex;
+		cell.Column = columnIndex;
+		cell.Width = Columns[columnIndex].Width;
+		cell.Text = text;
+		cell.Valid = true;
+		breakText(cell.Text, cell.BrokenText, cell.Width);
+	}
+
+	return cell.BrokenText;
+}
+
+
 } // end namespace gui
 } // end namespace irr
 
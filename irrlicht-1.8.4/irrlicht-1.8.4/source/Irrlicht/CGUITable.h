@@ -143,6 +143,12 @@ namespace gui
 		//! Get the flags, as defined in EGUI_TABLE_DRAW_FLAGS, which influence the layout
 		virtual s32 getDrawFlags() const;
 
+		//! Lets the table ask a row source for the text of its cells
+		virtual void setRowSource(IGUIRowSource* source);
+
+		//! Returns the row source, or 0 if there is none
+		virtual IGUIRowSource* getRowSource() const;
+
 		//! Writes attributes of the object.
 		//! Implement this to expose the attributes of your scene node animator for
 		//! scripting languages, editors, debuggers or xml serialization purposes.
@@ -175,6 +181,18 @@ namespace gui
 			core::array<Cell> Items;
 		};
 
+		//! shortened text of a cell of the row source
+		struct SourceCell
+		{
+			SourceCell() : Row(0), Column(0), Width(0), Valid(false) {}
+			u32 Row;
+			u32 Column;
+			u32 Width;
+			core::stringw Text;
+			core::stringw BrokenText;
+			bool Valid;
+		};
+
 		struct Column
 		{
 			Column() : Width(0), OrderingMode(EGCO_NONE) {}
@@ -191,8 +209,13 @@ namespace gui
 		void recalculateHeights();
 		void recalculateWidths();
 
+		//! returns the shortened text of a cell of the row source
+		const core::stringw& getSourceCellText(u32 rowIndex, u32 columnIndex);
+
 		core::array< Column > Columns;
 		core::array< Row > Rows;
+		gui::IGUIRowSource* RowSource;
+		core::array< SourceCell > SourceCells;
 		gui::IGUIFont* Font;
 		gui::IGUIScrollBar* VerticalScrollBar;
 		gui::IGUIScrollBar* HorizontalScrollBar;
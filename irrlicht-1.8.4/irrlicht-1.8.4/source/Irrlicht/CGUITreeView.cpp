@@ -54,16 +54,25 @@ IGUITreeViewNode* CGUITreeViewNode::getParent() const
 
 void CGUITreeViewNode::setText( const wchar_t* text )
 {
+	if (Owner)
+		Owner->setDirty();
+
 	Text = text;
 }
 
 void CGUITreeViewNode::setIcon( const wchar_t* icon )
 {
+	if (Owner)
+		Owner->setDirty();
+
 	Icon = icon;
 }
 
 void CGUITreeViewNode::clearChildren()
 {
+	if (Owner)
+		Owner->setVisibleNodesDirty();
+
 	core::list<CGUITreeViewNode*>::Iterator	it;
 
 	for( it = Children.begin(); it != Children.end(); it++ )
@@ -81,6 +90,9 @@ IGUITreeViewNode* CGUITreeViewNode::addChildBack(
 	void*					data /*= 0*/,
 	IReferenceCounted*			data2 /*= 0*/ )
 {
+	if (Owner)
+		Owner->setVisibleNodesDirty();
+
 	CGUITreeViewNode*	newChild = new CGUITreeViewNode( Owner, this );
 
 	Children.push_back( newChild );
@@ -105,6 +117,9 @@ IGUITreeViewNode* CGUITreeViewNode::addChildFront(
 	void*					data /*= 0*/,
 	IReferenceCounted*			data2 /*= 0*/ )
 {
+	if (Owner)
+		Owner->setVisibleNodesDirty();
+
 	CGUITreeViewNode*	newChild = new CGUITreeViewNode( Owner, this );
 
 	Children.push_front( newChild );
@@ -130,6 +145,9 @@ IGUITreeViewNode* CGUITreeViewNode::insertChildAfter(
 	void*					data /*= 0*/,
 	IReferenceCounted*			data2/* = 0*/ )
 {
+	if (Owner)
+		Owner->setVisibleNodesDirty();
+
 	core::list<CGUITreeViewNode*>::Iterator	itOther;
 	CGUITreeViewNode*									newChild = 0;
 
@@ -164,6 +182,9 @@ IGUITreeViewNode* CGUITreeViewNode::insertChildBefore(
 	void*					data /*= 0*/,
 	IReferenceCounted*			data2/* = 0*/ )
 {
+	if (Owner)
+		Owner->setVisibleNodesDirty();
+
 	core::list<CGUITreeViewNode*>::Iterator	itOther;
 	CGUITreeViewNode*									newChild = 0;
 
@@ -288,6 +309,9 @@ IGUITreeViewNode* CGUITreeViewNode::getNextVisible() const
 
 bool CGUITreeViewNode::deleteChild( IGUITreeViewNode* child )
 {
+	if (Owner)
+		Owner->setVisibleNodesDirty();
+
 	core::list<CGUITreeViewNode*>::Iterator	itChild;
 	bool	deleted = false;
 
@@ -306,6 +330,9 @@ bool CGUITreeViewNode::deleteChild( IGUITreeViewNode* child )
 
 bool CGUITreeViewNode::moveChildUp( IGUITreeViewNode* child )
 {
+	if (Owner)
+		Owner->setVisibleNodesDirty();
+
 	core::list<CGUITreeViewNode*>::Iterator	itChild;
 	core::list<CGUITreeViewNode*>::Iterator	itOther;
 	CGUITreeViewNode*									nodeTmp;
@@ -331,6 +358,9 @@ bool CGUITreeViewNode::moveChildUp( IGUITreeViewNode* child )
 
 bool CGUITreeViewNode::moveChildDown( IGUITreeViewNode* child )
 {
+	if (Owner)
+		Owner->setVisibleNodesDirty();
+
 	core::list<CGUITreeViewNode*>::Iterator	itChild;
 	core::list<CGUITreeViewNode*>::Iterator	itOther;
 	CGUITreeViewNode*									nodeTmp;
@@ -357,11 +387,17 @@ bool CGUITreeViewNode::moveChildDown( IGUITreeViewNode* child )
 
 void CGUITreeViewNode::setExpanded( bool expanded )
 {
+	if (Owner)
+		Owner->setVisibleNodesDirty();
+
 	Expanded = expanded;
 }
 
 void CGUITreeViewNode::setSelected( bool selected )
 {
+	if (Owner)
+		Owner->setDirty();
+
 	if( Owner )
 	{
 		if( selected )
@@ -436,6 +472,7 @@ CGUITreeView::CGUITreeView(IGUIEnvironment* environment, IGUIElement* parent,
 	ScrollBarV( 0 ),
 	ImageList( 0 ),
 	LastEventNode( 0 ),
+	VisibleNodesDirty( true ),
 	LinesVisible( true ),
 	Selecting( false ),
 	Clip( clip ),
@@ -521,7 +558,6 @@ CGUITreeView::~CGUITreeView()
 void CGUITreeView::recalculateItemHeight()
 {
 	IGUISkin*		skin = Environment->getSkin();
-	IGUITreeViewNode*	node;
 
 	if( Font != skin->getFont() )
 	{
@@ -573,14 +609,9 @@ void CGUITreeView::recalculateItemHeight()
 		}
 	}
 
-	TotalItemHeight = 0;
+	updateVisibleNodes();
+	TotalItemHeight = (s32)core::min_((s64)ItemHeight * VisibleNodes.size(), (s64)0x7fffffff);
 	TotalItemWidth = AbsoluteRect.getWidth() * 2;
-	node = Root->getFirstChild();
-	while( node )
-	{
-		TotalItemHeight += ItemHeight;
-		node = node->getNextVisible();
-	}
 
 	if ( ScrollBarV )
 		ScrollBarV->setMax( core::max_(0,TotalItemHeight - AbsoluteRect.getHeight()) );
@@ -590,6 +621,33 @@ void CGUITreeView::recalculateItemHeight()
 
 }
 
+//! called by the nodes when nodes were added, removed, moved, expanded or collapsed
+void CGUITreeView::setVisibleNodesDirty()
+{
+	VisibleNodesDirty = true;
+	setDirty();
+}
+
+//! collects the visible nodes again if they changed
+/** Keeps the nodes in drawing order, so drawing and picking can directly
+jump to the nodes in the visible area. */
+void CGUITreeView::updateVisibleNodes()
+{
+	if( !VisibleNodesDirty )
+	{
+		return;
+	}
+
+	VisibleNodes.set_used( 0 );
+	IGUITreeViewNode* node = Root->getFirstChild();
+	while( node )
+	{
+		VisibleNodes.push_back( node );
+		node = node->getNextVisible();
+	}
+	VisibleNodesDirty = false;
+}
+
 //! called if an event happened.
 bool CGUITreeView::OnEvent( const SEvent &event )
 {
@@ -697,8 +755,6 @@ void CGUITreeView::mouseAction( s32 xpos, s32 ypos, bool onlyHover /*= false*/ )
 	IGUITreeViewNode*		oldSelected = Selected;
 	IGUITreeViewNode*		hitNode = 0;
 	s32						selIdx=-1;
-	s32						n;
-	IGUITreeViewNode*		node;
 	SEvent					event;
 
 	event.EventType			= EET_GUI_EVENT;
@@ -714,18 +770,11 @@ void CGUITreeView::mouseAction( s32 xpos, s32 ypos, bool onlyHover /*= false*/ )
 		selIdx = ( ( ypos - 1 ) + ScrollBarV->getPos() ) / ItemHeight;
 	}
 
+	updateVisibleNodes();
 	hitNode = 0;
-	node = Root->getFirstChild();
-	n = 0;
-	while( node )
+	if( selIdx >= 0 && selIdx < (s32)VisibleNodes.size() )
 	{
-		if( selIdx == n )
-		{
-			hitNode = node;
-			break;
-		}
-		node = node->getNextVisible();
-		++n;
+		hitNode = VisibleNodes[selIdx];
 	}
 
 	if( hitNode && xpos > hitNode->getLevel() * IndentWidth )
@@ -759,6 +808,11 @@ void CGUITreeView::mouseAction( s32 xpos, s32 ypos, bool onlyHover /*= false*/ )
 		Selected = 0;
 	}
 
+	if( Selected != oldSelected )
+	{
+		setDirty();
+	}
+
 	// post selection news
 
 	if( Parent && !onlyHover && Selected != oldSelected )
@@ -865,13 +919,21 @@ void CGUITreeView::draw()
 		frameRect.LowerRightCorner.X -= ScrollBarH->getPos();
 	}
 
-	IGUITreeViewNode* node = Root->getFirstChild();
-	while( node )
+	// skip the nodes above the visible area, the first drawn one may be partly hidden
+	u32 n = 0;
+	if( ItemHeight > 0 && frameRect.LowerRightCorner.Y < AbsoluteRect.UpperLeftCorner.Y )
 	{
+		n = ( AbsoluteRect.UpperLeftCorner.Y - frameRect.LowerRightCorner.Y + ItemHeight - 1 ) / ItemHeight;
+		frameRect.UpperLeftCorner.Y += n * ItemHeight;
+		frameRect.LowerRightCorner.Y += n * ItemHeight;
+	}
+
+	for( ; n < VisibleNodes.size() && frameRect.UpperLeftCorner.Y <= AbsoluteRect.LowerRightCorner.Y; ++n )
+	{
+		IGUITreeViewNode* node = VisibleNodes[n];
 		frameRect.UpperLeftCorner.X = AbsoluteRect.UpperLeftCorner.X + 1 + node->getLevel() * IndentWidth;
 
-		if( frameRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y
-			&& frameRect.UpperLeftCorner.Y <= AbsoluteRect.LowerRightCorner.Y )
+		if( frameRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y )
 		{
 			if( node == Selected )
 			{
@@ -1040,8 +1102,6 @@ void CGUITreeView::draw()
 
 		frameRect.UpperLeftCorner.Y += ItemHeight;
 		frameRect.LowerRightCorner.Y += ItemHeight;
-
-		node = node->getNextVisible();
 	}
 
 	IGUIElement::draw();
@@ -1053,6 +1113,7 @@ void CGUITreeView::draw()
 //! Irrlicht engine as icon font, the icon strings defined in GUIIcons.h can be used.
 void CGUITreeView::setIconFont( IGUIFont* font )
 {
+	setDirty();
 	s32	height;
 
 	if ( font )
@@ -1077,6 +1138,7 @@ void CGUITreeView::setIconFont( IGUIFont* font )
 //! The default is 0 (no images).
 void CGUITreeView::setImageList( IGUIImageList* imageList )
 {
+	setDirty();
 	if (imageList )
 		imageList->grab();
 	if( ImageList )
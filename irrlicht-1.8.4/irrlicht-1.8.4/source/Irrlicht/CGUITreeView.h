@@ -304,6 +304,12 @@ namespace gui
 		//! executes an mouse action (like selectNew of CGUIListBox)
 		void mouseAction( s32 xpos, s32 ypos, bool onlyHover = false );
 
+		//! called by the nodes when nodes were added, removed, moved, expanded or collapsed
+		void setVisibleNodesDirty();
+
+		//! collects the visible nodes again if they changed
+		void updateVisibleNodes();
+
 		CGUITreeViewNode*	Root;
 		IGUITreeViewNode*	Selected;
 		s32			ItemHeight;
@@ -316,6 +322,8 @@ namespace gui
 		IGUIScrollBar*		ScrollBarV;
 		IGUIImageList*		ImageList;
 		IGUITreeViewNode*	LastEventNode;
+		core::array<IGUITreeViewNode*>	VisibleNodes;
+		bool			VisibleNodesDirty;
 		bool			LinesVisible;
 		bool			Selecting;
 		bool			Clip;
@@ -129,6 +129,8 @@ bool CGUIWindow::OnEvent(const SEvent& event)
 			if (event.GUIEvent.EventType == EGET_ELEMENT_FOCUS_LOST)
 			{
 				Dragging = false;
+				if (IsActive)
+					setDirty();
 				IsActive = false;
 			}
 			else
@@ -137,10 +139,14 @@ bool CGUIWindow::OnEvent(const SEvent& event)
 				if (Parent && ((event.GUIEvent.Caller == this) || isMyChild(event.GUIEvent.Caller)))
 				{
 					Parent->bringToFront(this);
+					if (!IsActive)
+						setDirty();
 					IsActive = true;
 				}
 				else
 				{
+					if (IsActive)
+						setDirty();
 					IsActive = false;
 				}
 			}
@@ -310,6 +316,7 @@ void CGUIWindow::setDraggable(bool draggable)
 //! Set if the window background will be drawn
 void CGUIWindow::setDrawBackground(bool draw)
 {
+	setDirty();
 	DrawBackground = draw;
 }
 
@@ -324,6 +331,7 @@ bool CGUIWindow::getDrawBackground() const
 //! Set if the window titlebar will be drawn
 void CGUIWindow::setDrawTitlebar(bool draw)
 {
+	setDirty();
 	DrawTitlebar = draw;
 }
 
@@ -35,7 +35,7 @@ CImage::CImage(ECOLOR_FORMAT format, const core::dimension2d<u32>& size, void* d
 	{
 		Data = 0;
 		initData();
-		memcpy(Data, data, Size.Height * Pitch);
+		memcpy(Data, data, getImageDataSizeInBytes());
 	}
 }
 
@@ -49,12 +49,16 @@ void CImage::initData()
 	BytesPerPixel = getBitsPerPixelFromFormat(Format) / 8;
 
 	// Pitch should be aligned...
-	Pitch = BytesPerPixel * Size.Width;
+	// compressed formats have one row of 4x4 blocks per pitch
+	if (isCompressedFormat(Format))
+		Pitch = getBlockSizeFromFormat(Format) * ((Size.Width + 3) / 4);
+	else
+		Pitch = BytesPerPixel * Size.Width;
 
 	if (!Data)
 	{
 		DeleteMemory=true;
-		Data = new u8[Size.Height * Pitch];
+		Data = new u8[getImageDataSizeInBytes()];
 	}
 }
 
@@ -91,6 +95,9 @@ u32 CImage::getBytesPerPixel() const
 //! Returns image data size in bytes
 u32 CImage::getImageDataSizeInBytes() const
 {
+	if (isCompressedFormat(Format))
+		return Pitch * ((Size.Height + 3) / 4);
+
 	return Pitch * Size.Height;
 }
 
@@ -211,6 +218,11 @@ void CImage::setPixel(u32 x, u32 y, const SColor &color, bool blend)
 			u32 * dest = (u32*) (Data + ( y * Pitch ) + ( x << 2 ));
 			*dest = blend ? PixelBlend32 ( *dest, color.color ) : color.color;
 		} break;
+
+		case ECF_DXT1:
+		case ECF_DXT5:
+			// a pixel of a compressed block can't be changed on its own
+			break;
 #ifndef _DEBUG
 		default:
 			break;
@@ -238,6 +250,16 @@ SColor CImage::getPixel(u32 x, u32 y) const
 			u8* p = Data+(y*3)*Size.Width + (x*3);
 			return SColor(255,p[0],p[1],p[2]);
 		}
+	case ECF_DXT1:
+	case ECF_DXT5:
+		{
+			// decodes the block of 4x4 pixels holding the pixel
+			const u32 blocksPerRow = (Size.Width + 3) / 4;
+			const u8* block = Data + ((y/4) * blocksPerRow + x/4) * getBlockSizeFromFormat(Format);
+			u32 texel[16];
+			CColorConverter::convert_DXTtoA8R8G8B8(block, Format, 4, 4, texel);
+			return texel[(y%4)*4 + x%4];
+		}
 #ifndef _DEBUG
 	default:
 		break;
@@ -424,6 +446,24 @@ void CImage::fill(const SColor &color)
 }
 
 
+//! copies a row of pixels into the image, converting them like copyTo() does
+void CImage::setRow(u32 y, const void* data, ECOLOR_FORMAT format)
+{
+	u8* dest = Data + y * Pitch;
+	if (format == Format)
+	{
+		memcpy(dest, data, Size.Width * BytesPerPixel);
+		return;
+	}
+
+	// textures were converted with copyTo() before, keep their look
+	CImage row(format, core::dimension2d<u32>(Size.Width, 1), const_cast<void*>(data), true, false);
+	const core::position2d<s32> pos(0, y);
+	if (!Blit(BLITTER_TEXTURE, this, 0, &pos, &row, 0, 0))
+		CColorConverter::convert_viaFormat(data, format, Size.Width, dest, Format);
+}
+
+
 //! get a filtered pixel
 inline SColor CImage::getPixelBox( s32 x, s32 y, s32 fx, s32 fy, s32 bias ) const
 {
@@ -103,6 +103,13 @@ public:
 	//! fills the surface with given color
 	virtual void fill(const SColor &color);
 
+	//! copies a row of pixels into the image, converting them like copyTo() does
+	/** Lets image loaders decode row by row into the final format.
+	\param y Row of the image to write.
+	\param data Pixels for the whole width of the image.
+	\param format Color format of the pixels. */
+	void setRow(u32 y, const void* data, ECOLOR_FORMAT format);
+
 private:
 
 	//! assumes format and size has been set and creates the rest
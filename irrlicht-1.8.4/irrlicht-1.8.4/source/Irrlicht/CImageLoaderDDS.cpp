@@ -112,7 +112,7 @@ void DDSGetColorBlockColors( ddsColorBlock *block, ddsColor colors[ 4 ] )
 	word >>= 5;
 	colors[ 0 ].g = (u8) word;
 	colors[ 0 ].g <<= 2;
-	colors[ 0 ].g |= (colors[ 0 ].g >> 5);
+	colors[ 0 ].g |= (colors[ 0 ].g >> 6);
 	word >>= 6;
 	colors[ 0 ].r = (u8) word;
 	colors[ 0 ].r <<= 3;
@@ -129,7 +129,7 @@ void DDSGetColorBlockColors( ddsColorBlock *block, ddsColor colors[ 4 ] )
 	word >>= 5;
 	colors[ 1 ].g = (u8) word;
 	colors[ 1 ].g <<= 2;
-	colors[ 1 ].g |= (colors[ 1 ].g >> 5);
+	colors[ 1 ].g |= (colors[ 1 ].g >> 6);
 	word >>= 6;
 	colors[ 1 ].r = (u8) word;
 	colors[ 1 ].r <<= 3;
@@ -680,13 +680,32 @@ IImage* CImageLoaderDDS::loadImage(io::IReadFile* file) const
 
 	if ( 0 == DDSGetInfo( header, &width, &height, &pixelFormat) )
 	{
-		image = new CImage(ECF_A8R8G8B8, core::dimension2d<u32>(width, height));
-
-		if ( DDSDecompress( header, (u8*) image->lock() ) == -1)
+		if ( pixelFormat == DDS_PF_DXT1 || pixelFormat == DDS_PF_DXT5 )
+		{
+			// keep the blocks, the driver decides whether it can use them
+			image = new CImage(pixelFormat == DDS_PF_DXT1 ? ECF_DXT1 : ECF_DXT5,
+				core::dimension2d<u32>(width, height));
+
+			const u32 dataSize = image->getImageDataSizeInBytes();
+			if ( (u32) file->getSize() >= sizeof(ddsBuffer) - 4 + dataSize )
+				memcpy ( image->lock(), header->data, dataSize );
+			else
+			{
+				os::Printer::log("DDS file is too small for its size", file->getFileName(), ELL_ERROR);
+				image->drop();
+				image = 0;
+			}
+		}
+		else
 		{
-			image->unlock();
-			image->drop();
-			image = 0;
+			image = new CImage(ECF_A8R8G8B8, core::dimension2d<u32>(width, height));
+
+			if ( DDSDecompress( header, (u8*) image->lock() ) == -1)
+			{
+				image->unlock();
+				image->drop();
+				image = 0;
+			}
 		}
 	}
 
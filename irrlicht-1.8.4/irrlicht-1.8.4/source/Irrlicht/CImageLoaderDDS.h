@@ -136,7 +136,7 @@ struct ddsBuffer
 	};
 	u32		alphaBitDepth;
 	u32		reserved;
-	void				*surface;
+	u32		surface;
 	union
 	{
 		ddsColorKey	ckDestOverlay;
@@ -179,9 +179,10 @@ struct ddsAlphaBlock3BitLinear
 } PACK_STRUCT;
 
 
+/* in the byte order of A8R8G8B8 */
 struct ddsColor
 {
-	u8		r, g, b, a;
+	u8		b, g, r, a;
 } PACK_STRUCT;
 
 // Default alignment
@@ -8,6 +8,7 @@
 
 #include "IReadFile.h"
 #include "CImage.h"
+#include "CColorConverter.h"
 #include "os.h"
 #include "irrString.h"
 
@@ -16,11 +17,6 @@ namespace irr
 namespace video
 {
 
-#ifdef _IRR_COMPILE_WITH_LIBJPEG_
-// Static members
-io::path CImageLoaderJPG::Filename;
-#endif
-
 //! constructor
 CImageLoaderJPG::CImageLoaderJPG()
 {
@@ -56,6 +52,9 @@ bool CImageLoaderJPG::isALoadableFileExtension(const io::path& filename) const
 
         // for longjmp, to return to caller on a fatal error
         jmp_buf setjmp_buffer;
+
+        // filename for error-messages, per image so images can be loaded on several threads
+        const io::path* Filename;
     };
 
 void CImageLoaderJPG::init_source (j_decompress_ptr cinfo)
@@ -113,7 +112,7 @@ void CImageLoaderJPG::output_message(j_common_ptr cinfo)
 	c8 temp1[JMSG_LENGTH_MAX];
 	(*cinfo->err->format_message)(cinfo, temp1);
 	core::stringc errMsg("JPEG FATAL ERROR in ");
-	errMsg += core::stringc(Filename);
+	errMsg += core::stringc(*((irr_jpeg_error_mgr*) cinfo->err)->Filename);
 	os::Printer::log(errMsg.c_str(),temp1, ELL_ERROR);
 }
 #endif // _IRR_COMPILE_WITH_LIBJPEG_
@@ -138,6 +137,22 @@ bool CImageLoaderJPG::isALoadableFileFormat(io::IReadFile* file) const
 
 //! creates a surface from the file
 IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
+{
+	return decodeImage(file, ECF_R8G8B8);
+}
+
+
+//! creates a surface from the file, in the color format of a texture
+IImage* CImageLoaderJPG::loadTextureImage(io::IReadFile* file,
+		ECOLOR_FORMAT opaqueFormat, ECOLOR_FORMAT alphaFormat) const
+{
+	// jpeg files have no alpha channel
+	return decodeImage(file, CColorConverter::canConvertFormat(opaqueFormat) ? opaqueFormat : ECF_R8G8B8);
+}
+
+
+//! decodes the file row by row into an image of the given format
+IImage* CImageLoaderJPG::decodeImage(io::IReadFile* file, ECOLOR_FORMAT format) const
 {
 	#ifndef _IRR_COMPILE_WITH_LIBJPEG_
 	os::Printer::log("Can't load as not compiled with _IRR_COMPILE_WITH_LIBJPEG_:", file->getFileName(), ELL_DEBUG);
@@ -147,9 +162,10 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 	if (!file)
 		return 0;
 
-	Filename = file->getFileName();
-
-	u8 **rowPtr=0;
+	// volatile, as they change between setjmp and longjmp
+	u8** volatile rowPtr=0;
+	u8* volatile rows=0;
+	CImage* volatile image=0;
 	u8* input = new u8[file->getSize()];
 	file->read(input, file->getSize());
 
@@ -165,6 +181,7 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 	cinfo.err = jpeg_std_error(&jerr.pub);
 	cinfo.err->error_exit = error_exit;
 	cinfo.err->output_message = output_message;
+	jerr.Filename = &file->getFileName();
 
 	// compatibility fudge:
 	// we need to use setjmp/longjmp for error handling as gcc-linux
@@ -180,6 +197,9 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 		// if the row pointer was created, we delete it.
 		if (rowPtr)
 			delete [] rowPtr;
+		delete [] rows;
+		if (image)
+			image->drop();
 
 		// return null pointer
 		return 0;
@@ -229,27 +249,77 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 	jpeg_start_decompress(&cinfo);
 
 	// Get image data
-	u16 rowspan = cinfo.image_width * cinfo.out_color_components;
-	u32 width = cinfo.image_width;
-	u32 height = cinfo.image_height;
-
-	// Allocate memory for buffer
-	u8* output = new u8[rowspan * height];
+	const u32 rowspan = cinfo.image_width * cinfo.out_color_components;
+	const u32 width = cinfo.image_width;
+	const u32 height = cinfo.image_height;
+
+	// The decoded rows go right into the image if it has the format of the
+	// file. Otherwise a few rows at a time are decoded into a buffer and
+	// converted from there, so there's no second image.
+	image = new CImage(format, core::dimension2d<u32>(width, height));
+	u8* data = (u8*)image->lock();
+	const u32 pitch = image->getPitch();
+	const bool direct = !useCMYK && format == ECF_R8G8B8;
+	const u32 batch = direct ? height : (u32)cinfo.rec_outbuf_height;
 
 	// Here we use the library's state variable cinfo.output_scanline as the
 	// loop counter, so that we don't have to keep track ourselves.
 	// Create array of row pointers for lib
-	rowPtr = new u8* [height];
-
-	for( u32 i = 0; i < height; i++ )
-		rowPtr[i] = &output[ i * rowspan ];
+	rowPtr = new u8* [batch];
 
-	u32 rowsRead = 0;
+	if (direct)
+	{
+		for( u32 i = 0; i < height; i++ )
+			rowPtr[i] = data + i * pitch;
+	}
+	else
+	{
+		// one more row for the colors of cmyk rows
+		rows = new u8[rowspan * (batch + 1)];
+		for( u32 i = 0; i < batch; i++ )
+			rowPtr[i] = rows + i * rowspan;
+	}
+	u8* rgb = rows ? rows + rowspan * batch : 0;
 
 	while( cinfo.output_scanline < cinfo.output_height )
-		rowsRead += jpeg_read_scanlines( &cinfo, &rowPtr[rowsRead], cinfo.output_height - rowsRead );
+	{
+		const u32 first = cinfo.output_scanline;
+		const u32 count = direct ?
+			jpeg_read_scanlines( &cinfo, &rowPtr[first], height - first ) :
+			jpeg_read_scanlines( &cinfo, rowPtr, batch );
+
+		if (direct)
+			continue;
+
+		for (u32 r = 0; r < count; ++r)
+		{
+			const u8* src = rowPtr[r];
+			u8* dest = data + (first + r) * pitch;
 
+			if (useCMYK)
+			{
+				u8* out = (format == ECF_R8G8B8) ? dest : rgb;
+				for (u32 i=0,j=0; i<3*width; i+=3, j+=4)
+				{
+					// Also works without K, but has more contrast with K multiplied in
+//					out[i+0] = src[j+2];
+//					out[i+1] = src[j+1];
+//					out[i+2] = src[j+0];
+					out[i+0] = (char)(src[j+2]*(src[j+3]/255.f));
+					out[i+1] = (char)(src[j+1]*(src[j+3]/255.f));
+					out[i+2] = (char)(src[j+0]*(src[j+3]/255.f));
+				}
+				src = out;
+			}
+
+			if (src != dest)
+				image->setRow(first + r, src, ECF_R8G8B8);
+		}
+	}
+
+	image->unlock();
 	delete [] rowPtr;
+	delete [] rows;
 	// Finish decompression
 
 	jpeg_finish_decompress(&cinfo);
@@ -258,34 +328,6 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 	// This is an important step since it will release a good deal of memory.
 	jpeg_destroy_decompress(&cinfo);
 
-	// convert image
-	IImage* image = 0;
-	if (useCMYK)
-	{
-		image = new CImage(ECF_R8G8B8,
-				core::dimension2d<u32>(width, height));
-		const u32 size = 3*width*height;
-		u8* data = (u8*)image->lock();
-		if (data)
-		{
-			for (u32 i=0,j=0; i<size; i+=3, j+=4)
-			{
-				// Also works without K, but has more contrast with K multiplied in
-//				data[i+0] = output[j+2];
-//				data[i+1] = output[j+1];
-//				data[i+2] = output[j+0];
-				data[i+0] = (char)(output[j+2]*(output[j+3]/255.f));
-				data[i+1] = (char)(output[j+1]*(output[j+3]/255.f));
-				data[i+2] = (char)(output[j+0]*(output[j+3]/255.f));
-			}
-		}
-		image->unlock();
-		delete [] output;
-	}
-	else
-		image = new CImage(ECF_R8G8B8,
-				core::dimension2d<u32>(width, height), output);
-
 	delete [] input;
 
 	return image;
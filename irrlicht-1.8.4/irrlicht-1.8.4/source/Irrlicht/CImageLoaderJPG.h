@@ -51,8 +51,15 @@ public:
 	//! creates a surface from the file
 	virtual IImage* loadImage(io::IReadFile* file) const;
 
+	//! creates a surface from the file, in the color format of a texture
+	virtual IImage* loadTextureImage(io::IReadFile* file,
+		ECOLOR_FORMAT opaqueFormat, ECOLOR_FORMAT alphaFormat) const;
+
 private:
 
+	//! decodes the file row by row into an image of the given format
+	IImage* decodeImage(io::IReadFile* file, ECOLOR_FORMAT format) const;
+
     #ifdef _IRR_COMPILE_WITH_LIBJPEG_
 	// several methods used via function pointers by jpeglib
 
@@ -100,9 +107,6 @@ private:
 	data has been read.  Often a no-op. */
 	static void term_source (j_decompress_ptr cinfo);
 
-	// Copy filename to have it around for error-messages
-	static io::path Filename;
-
 	#endif // _IRR_COMPILE_WITH_LIBJPEG_
 };
 
@@ -15,6 +15,7 @@
 #endif // _IRR_COMPILE_WITH_LIBPNG_
 
 #include "CImage.h"
+#include "CColorConverter.h"
 #include "CReadFile.h"
 #include "os.h"
 
@@ -87,14 +88,37 @@ bool CImageLoaderPng::isALoadableFileFormat(io::IReadFile* file) const
 
 // load in the image data
 IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
+{
+	return decodeImage(file, ECF_R8G8B8, ECF_A8R8G8B8);
+}
+
+
+//! creates a surface from the file, in the color format of a texture
+IImage* CImageLoaderPng::loadTextureImage(io::IReadFile* file,
+		ECOLOR_FORMAT opaqueFormat, ECOLOR_FORMAT alphaFormat) const
+{
+	if (!CColorConverter::canConvertFormat(opaqueFormat))
+		opaqueFormat = ECF_R8G8B8;
+	if (!CColorConverter::canConvertFormat(alphaFormat))
+		alphaFormat = ECF_A8R8G8B8;
+	return decodeImage(file, opaqueFormat, alphaFormat);
+}
+
+
+//! decodes the file row by row into an image of the given formats
+IImage* CImageLoaderPng::decodeImage(io::IReadFile* file,
+		ECOLOR_FORMAT opaqueFormat, ECOLOR_FORMAT alphaFormat) const
 {
 #ifdef _IRR_COMPILE_WITH_LIBPNG_
 	if (!file)
 		return 0;
 
-	video::IImage* image = 0;
+	// volatile, as they change between setjmp and longjmp
+	CImage* volatile image = 0;
 	//Used to point to image rows
-	u8** RowPointers = 0;
+	u8** volatile RowPointers = 0;
+	// decoded rows which are converted into the image
+	u8* volatile Rows = 0;
 
 	png_byte buffer[8];
 	// Read the first few bytes of the PNG file
@@ -135,6 +159,9 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
 		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
 		if (RowPointers)
 			delete [] RowPointers;
+		delete [] Rows;
+		if (image)
+			image->drop();
 		return 0;
 	}
 
@@ -149,17 +176,22 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
 	u32 Height;
 	s32 BitDepth;
 	s32 ColorType;
+	s32 Interlace;
 	{
 		// Use temporary variables to avoid passing casted pointers
 		png_uint_32 w,h;
 		// Extract info
 		png_get_IHDR(png_ptr, info_ptr,
 			&w, &h,
-			&BitDepth, &ColorType, NULL, NULL, NULL);
+			&BitDepth, &ColorType, &Interlace, NULL, NULL);
 		Width=w;
 		Height=h;
 	}
 
+	// all images are expanded to 8 bit rgb, with alpha if they have any
+	const bool hasAlpha = (ColorType & PNG_COLOR_MASK_ALPHA) ||
+		png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS);
+
 	// Convert palette color to true color
 	if (ColorType==PNG_COLOR_TYPE_PALETTE)
 		png_set_palette_to_rgb(png_ptr);
@@ -198,75 +230,83 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
 			png_set_gamma(png_ptr, screen_gamma, 0.45455);
 	}
 
-	// Update the changes in between, as we need to get the new color type
-	// for proper processing of the RGBA type
-	png_read_update_info(png_ptr, info_ptr);
+	// libpng writes ECF_R8G8B8 rows, and with the alpha channel or a
+	// filler byte also ECF_A8R8G8B8 rows. Other formats are converted
+	// row by row.
+	const ECOLOR_FORMAT format = hasAlpha ? alphaFormat : opaqueFormat;
+	ECOLOR_FORMAT rowFormat = hasAlpha ? ECF_A8R8G8B8 : ECF_R8G8B8;
+	if (!hasAlpha && format == ECF_A8R8G8B8)
 	{
-		// Use temporary variables to avoid passing casted pointers
-		png_uint_32 w,h;
-		// Extract info
-		png_get_IHDR(png_ptr, info_ptr,
-			&w, &h,
-			&BitDepth, &ColorType, NULL, NULL, NULL);
-		Width=w;
-		Height=h;
+		rowFormat = ECF_A8R8G8B8;
+#ifdef __BIG_ENDIAN__
+		png_set_filler(png_ptr, 0xff, PNG_FILLER_BEFORE);
+#else
+		png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
+#endif
 	}
 
 	// Convert RGBA to BGRA
-	if (ColorType==PNG_COLOR_TYPE_RGB_ALPHA)
+	if (rowFormat == ECF_A8R8G8B8)
 	{
 #ifdef __BIG_ENDIAN__
-		png_set_swap_alpha(png_ptr);
+		if (hasAlpha)
+			png_set_swap_alpha(png_ptr);
 #else
 		png_set_bgr(png_ptr);
 #endif
 	}
 
-	// Create the image structure to be filled by png data
-	if (ColorType==PNG_COLOR_TYPE_RGB_ALPHA)
-		image = new CImage(ECF_A8R8G8B8, core::dimension2d<u32>(Width, Height));
-	else
-		image = new CImage(ECF_R8G8B8, core::dimension2d<u32>(Width, Height));
-	if (!image)
-	{
-		os::Printer::log("LOAD PNG: Internal PNG create image struct failure\n", file->getFileName(), ELL_ERROR);
-		png_destroy_read_struct(&png_ptr, NULL, NULL);
-		return 0;
-	}
+	// Update the changes in between
+	png_read_update_info(png_ptr, info_ptr);
 
-	// Create array of pointers to rows in image data
-	RowPointers = new png_bytep[Height];
-	if (!RowPointers)
-	{
-		os::Printer::log("LOAD PNG: Internal PNG create row pointers failure\n", file->getFileName(), ELL_ERROR);
-		png_destroy_read_struct(&png_ptr, NULL, NULL);
-		delete image;
-		return 0;
-	}
+	// Create the image structure to be filled by png data
+	image = new CImage(format, core::dimension2d<u32>(Width, Height));
 
-	// Fill array of pointers to rows in image data
 	unsigned char* data = (unsigned char*)image->lock();
-	for (u32 i=0; i<Height; ++i)
+	const u32 pitch = image->getPitch();
+	const u32 rowPitch = Width * IImage::getBitsPerPixelFromFormat(rowFormat) / 8;
+
+	if (rowFormat == format)
 	{
-		RowPointers[i]=data;
-		data += image->getPitch();
+		// Create array of pointers to rows in image data
+		RowPointers = new png_bytep[Height];
+
+		// Fill array of pointers to rows in image data
+		for (u32 i=0; i<Height; ++i)
+		{
+			RowPointers[i]=data;
+			data += pitch;
+		}
+
+		// Read data using the library function that handles all transformations including interlacing
+		png_read_image(png_ptr, RowPointers);
 	}
+	else if (Interlace != PNG_INTERLACE_NONE)
+	{
+		// the passes of interlaced images need all rows
+		Rows = new u8[rowPitch * Height];
+		RowPointers = new png_bytep[Height];
+		for (u32 i=0; i<Height; ++i)
+			RowPointers[i] = Rows + i * rowPitch;
 
-	// for proper error handling
-	if (setjmp(png_jmpbuf(png_ptr)))
+		png_read_image(png_ptr, RowPointers);
+
+		for (u32 i=0; i<Height; ++i)
+			image->setRow(i, RowPointers[i], rowFormat);
+	}
+	else
 	{
-		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-		delete [] RowPointers;
-		image->unlock();
-		delete image;
-		return 0;
+		Rows = new u8[rowPitch];
+		for (u32 i=0; i<Height; ++i)
+		{
+			png_read_row(png_ptr, Rows, NULL);
+			image->setRow(i, Rows, rowFormat);
+		}
 	}
 
-	// Read data using the library function that handles all transformations including interlacing
-	png_read_image(png_ptr, RowPointers);
-
 	png_read_end(png_ptr, NULL);
 	delete [] RowPointers;
+	delete [] Rows;
 	image->unlock();
 	png_destroy_read_struct(&png_ptr,&info_ptr, 0); // Clean up memory
 
@@ -34,6 +34,16 @@ public:
 
    //! creates a surface from the file
    virtual IImage* loadImage(io::IReadFile* file) const;
+
+   //! creates a surface from the file, in the color format of a texture
+   virtual IImage* loadTextureImage(io::IReadFile* file,
+      ECOLOR_FORMAT opaqueFormat, ECOLOR_FORMAT alphaFormat) const;
+
+private:
+
+   //! decodes the file row by row into an image of the given formats
+   IImage* decodeImage(io::IReadFile* file,
+      ECOLOR_FORMAT opaqueFormat, ECOLOR_FORMAT alphaFormat) const;
 };
 
 
@@ -214,6 +214,10 @@ IImage* CImageLoaderWAL2::loadImage(irr::io::IReadFile* file) const
 	case ECF_A8R8G8B8:
 		CColorConverter::convert8BitTo32Bit(rawtex, (u8*)image->lock(), header.width, header.height, (u8*) pal + 768, 0, false);
 		break;
+	case ECF_DXT1:
+	case ECF_DXT5:
+		// the palette images are never block compressed
+		break;
 	}
 
 	image->unlock();
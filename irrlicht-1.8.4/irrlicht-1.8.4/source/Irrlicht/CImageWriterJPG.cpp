@@ -10,6 +10,7 @@
 #include "IWriteFile.h"
 #include "CImage.h"
 #include "irrString.h"
+#include "os.h"
 
 #ifdef _IRR_COMPILE_WITH_LIBJPEG_
 #include <stdio.h> // required for jpeglib.h
@@ -121,6 +122,10 @@ static bool writeJPEGFile(io::IWriteFile* file, IImage* image, u32 quality)
 		case ECF_R5G6B5:
 			format = CColorConverter::convert_R5G6B5toR8G8B8;
 			break;
+		case ECF_DXT1:
+		case ECF_DXT5:
+			os::Printer::log("JPGWriter: Can't write block compressed images", file->getFileName(), ELL_ERROR);
+			return false;
 #ifndef _DEBUG
 		default:
 			break;
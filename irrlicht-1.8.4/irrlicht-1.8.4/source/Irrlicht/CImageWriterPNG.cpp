@@ -161,6 +161,13 @@ bool CImageWriterPNG::writeImage(io::IWriteFile* file, IImage* image,u32 param)
 	case ECF_A1R5G5B5:
 		CColorConverter::convert_A1R5G5B5toA8R8G8B8(data,image->getDimension().Height*image->getDimension().Width,tmpImage);
 		break;
+	case ECF_DXT1:
+	case ECF_DXT5:
+		os::Printer::log("PNGWriter: Can't write block compressed images", file->getFileName(), ELL_ERROR);
+		image->unlock();
+		delete [] tmpImage;
+		png_destroy_write_struct(&png_ptr, &info_ptr);
+		return false;
 #ifndef _DEBUG
 		// TODO: Error handling in case of unsupported color format
 	default:
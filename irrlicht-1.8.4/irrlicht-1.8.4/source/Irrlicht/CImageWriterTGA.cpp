@@ -10,6 +10,7 @@
 #include "IWriteFile.h"
 #include "CColorConverter.h"
 #include "irrString.h"
+#include "os.h"
 
 namespace irr
 {
@@ -84,6 +85,10 @@ bool CImageWriterTGA::writeImage(io::IWriteFile *file, IImage *image,u32 param)
 		imageHeader.PixelDepth = 24;
 		imageHeader.ImageDescriptor |= 0;
 		break;
+	case ECF_DXT1:
+	case ECF_DXT5:
+		os::Printer::log("TGAWriter: Can't write block compressed images", file->getFileName(), ELL_ERROR);
+		return false;
 #ifndef _DEBUG
 	default:
 		break;
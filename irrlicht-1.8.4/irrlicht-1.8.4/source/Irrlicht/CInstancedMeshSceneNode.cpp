@@ -0,0 +1,474 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CInstancedMeshSceneNode.h"
+#include "IVideoDriver.h"
+#include "ISceneManager.h"
+#include "ICameraSceneNode.h"
+#include "IMeshCache.h"
+#include "IAnimatedMesh.h"
+#include "IMaterialRenderer.h"
+#include "IFileSystem.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+
+
+//! constructor
+CInstancedMeshSceneNode::CInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent,
+			ISceneManager* mgr, s32 id, const core::vector3df& position,
+			const core::vector3df& rotation, const core::vector3df& scale)
+: IInstancedMeshSceneNode(parent, mgr, id, position, rotation, scale), Mesh(0),
+	BoundsRevision(0), BoundsDirty(true), UseColors(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CInstancedMeshSceneNode");
+	#endif
+
+	setMesh(mesh);
+}
+
+
+//! destructor
+CInstancedMeshSceneNode::~CInstancedMeshSceneNode()
+{
+	if (Mesh)
+		Mesh->drop();
+}
+
+
+//! frame
+void CInstancedMeshSceneNode::OnRegisterSceneNode()
+{
+	if (IsVisible && Mesh && Transforms.size())
+	{
+		cullInstances();
+
+		if (VisibleTransforms.size())
+		{
+			video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+			int transparentCount = 0;
+			int solidCount = 0;
+
+			for (u32 i=0; i<Materials.size(); ++i)
+			{
+				video::IMaterialRenderer* rnd =
+					driver->getMaterialRenderer(Materials[i].MaterialType);
+
+				if (rnd && rnd->isTransparent())
+					++transparentCount;
+				else
+					++solidCount;
+
+				if (solidCount && transparentCount)
+					break;
+			}
+
+			if (solidCount)
+				SceneManager->registerNodeForRendering(this, scene::ESNRP_SOLID);
+
+			if (transparentCount)
+				SceneManager->registerNodeForRendering(this, scene::ESNRP_TRANSPARENT);
+		}
+	}
+
+	ISceneNode::OnRegisterSceneNode();
+}
+
+
+//! recalculates the world space transformations and bounding spheres
+void CInstancedMeshSceneNode::updateBounds()
+{
+	if (!BoundsDirty && BoundsRevision == getTransformRevision())
+		return;
+
+	const u32 count = Transforms.size();
+	WorldTransforms.set_used(count);
+	CenterX.set_used(count);
+	CenterY.set_used(count);
+	CenterZ.set_used(count);
+	Radius.set_used(count);
+
+	const core::aabbox3d<f32>& meshBox = Mesh ? Mesh->getBoundingBox() : Box;
+	const core::vector3df meshCenter = meshBox.getCenter();
+	const f32 meshRadius = meshBox.getExtent().getLength() * 0.5f;
+
+	if (BoundsDirty)
+	{
+		Box.reset(0,0,0);
+		for (u32 i=0; i<count; ++i)
+		{
+			core::aabbox3d<f32> box = meshBox;
+			Transforms[i].transformBoxEx(box);
+			if (i)
+				Box.addInternalBox(box);
+			else
+				Box = box;
+		}
+	}
+
+	for (u32 i=0; i<count; ++i)
+	{
+		WorldTransforms[i] = AbsoluteTransformation * Transforms[i];
+
+		core::vector3df center;
+		WorldTransforms[i].transformVect(center, meshCenter);
+		const core::vector3df scale = WorldTransforms[i].getScale();
+
+		CenterX[i] = center.X;
+		CenterY[i] = center.Y;
+		CenterZ[i] = center.Z;
+		Radius[i] = meshRadius * core::max_(scale.X, scale.Y, scale.Z);
+	}
+
+	BoundsRevision = getTransformRevision();
+	BoundsDirty = false;
+}
+
+
+//! collects the instances inside the view frustum
+void CInstancedMeshSceneNode::cullInstances()
+{
+	updateBounds();
+
+	const u32 count = Transforms.size();
+	Visible.set_used(count);
+
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	if (camera && AutomaticCullingState != EAC_OFF)
+	{
+		// planes are copied into plain arrays, so the loop below has
+		// no branches and can be vectorized by the compiler
+		const SViewFrustum* frustum = camera->getViewFrustum();
+		f32 nx[SViewFrustum::VF_PLANE_COUNT];
+		f32 ny[SViewFrustum::VF_PLANE_COUNT];
+		f32 nz[SViewFrustum::VF_PLANE_COUNT];
+		f32 nd[SViewFrustum::VF_PLANE_COUNT];
+		for (u32 p=0; p<SViewFrustum::VF_PLANE_COUNT; ++p)
+		{
+			nx[p] = frustum->planes[p].Normal.X;
+			ny[p] = frustum->planes[p].Normal.Y;
+			nz[p] = frustum->planes[p].Normal.Z;
+			nd[p] = frustum->planes[p].D;
+		}
+
+		const f32* cx = CenterX.const_pointer();
+		const f32* cy = CenterY.const_pointer();
+		const f32* cz = CenterZ.const_pointer();
+		const f32* r = Radius.const_pointer();
+		u8* visible = Visible.pointer();
+
+		// frustum plane normals point outwards
+		for (u32 i=0; i<count; ++i)
+		{
+			u8 inside = 1;
+			for (u32 p=0; p<SViewFrustum::VF_PLANE_COUNT; ++p)
+				inside &= (u8)(nx[p]*cx[i] + ny[p]*cy[i] + nz[p]*cz[i] + nd[p] <= r[i]);
+			visible[i] = inside;
+		}
+	}
+	else
+	{
+		for (u32 i=0; i<count; ++i)
+			Visible[i] = 1;
+	}
+
+	VisibleTransforms.set_used(0);
+	VisibleColors.set_used(0);
+	UseColors = false;
+	for (u32 i=0; i<count; ++i)
+	{
+		if (!Visible[i])
+			continue;
+
+		VisibleTransforms.push_back(WorldTransforms[i]);
+		VisibleColors.push_back(Colors[i]);
+		if (Colors[i].color != 0xffffffff)
+			UseColors = true;
+	}
+}
+
+
+//! renders the node.
+void CInstancedMeshSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+	if (!Mesh || !driver || VisibleTransforms.empty())
+		return;
+
+	const bool isTransparentPass =
+		SceneManager->getSceneNodeRenderPass() == scene::ESNRP_TRANSPARENT;
+
+	const u32 count = core::min_(Mesh->getMeshBufferCount(), Materials.size());
+	for (u32 i=0; i<count; ++i)
+	{
+		const IMeshBuffer* mb = Mesh->getMeshBuffer(i);
+		if (!mb)
+			continue;
+
+		video::IMaterialRenderer* rnd = driver->getMaterialRenderer(Materials[i].MaterialType);
+		const bool transparent = (rnd && rnd->isTransparent());
+
+		// only render transparent buffer if this is the transparent render pass
+		// and solid only in solid pass
+		if (transparent == isTransparentPass)
+		{
+			driver->setMaterial(Materials[i]);
+			driver->drawMeshBufferInstanced(mb, VisibleTransforms.const_pointer(),
+				UseColors ? VisibleColors.const_pointer() : 0, VisibleTransforms.size());
+		}
+	}
+
+	// for debug purposes only:
+	if (DebugDataVisible & scene::EDS_BBOX)
+	{
+		video::SMaterial m;
+		m.Lighting = false;
+		driver->setMaterial(m);
+		driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+		driver->draw3DBox(Box, video::SColor(255,255,255,255));
+	}
+}
+
+
+//! returns the axis aligned bounding box of this node
+const core::aabbox3d<f32>& CInstancedMeshSceneNode::getBoundingBox() const
+{
+	if (BoundsDirty)
+		const_cast<CInstancedMeshSceneNode*>(this)->updateBounds();
+	return Box;
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CInstancedMeshSceneNode::getMaterial(u32 i)
+{
+	if (i >= Materials.size())
+		return ISceneNode::getMaterial(i);
+
+	return Materials[i];
+}
+
+
+//! returns amount of materials used by this scene node.
+u32 CInstancedMeshSceneNode::getMaterialCount() const
+{
+	return Materials.size();
+}
+
+
+//! Sets the mesh drawn by all instances
+void CInstancedMeshSceneNode::setMesh(IMesh* mesh)
+{
+	if (mesh)
+	{
+		mesh->grab();
+		if (Mesh)
+			Mesh->drop();
+
+		Mesh = mesh;
+		copyMaterials();
+		BoundsDirty = true;
+	}
+}
+
+
+//! Adds an instance
+u32 CInstancedMeshSceneNode::addInstance(const core::matrix4& transform, video::SColor color)
+{
+	Transforms.push_back(transform);
+	Colors.push_back(color);
+	BoundsDirty = true;
+	return Transforms.size()-1;
+}
+
+
+//! Adds an instance
+u32 CInstancedMeshSceneNode::addInstance(const core::vector3df& position,
+		const core::vector3df& rotation, const core::vector3df& scale, video::SColor color)
+{
+	core::matrix4 transform;
+	transform.setRotationDegrees(rotation);
+	transform.setTranslation(position);
+
+	if (scale != core::vector3df(1.f,1.f,1.f))
+	{
+		core::matrix4 smat;
+		smat.setScale(scale);
+		transform *= smat;
+	}
+
+	return addInstance(transform, color);
+}
+
+
+//! Removes an instance
+void CInstancedMeshSceneNode::removeInstance(u32 index)
+{
+	if (index >= Transforms.size())
+		return;
+
+	Transforms[index] = Transforms.getLast();
+	Transforms.erase(Transforms.size()-1);
+	Colors[index] = Colors.getLast();
+	Colors.erase(Colors.size()-1);
+	BoundsDirty = true;
+}
+
+
+//! Removes all instances
+void CInstancedMeshSceneNode::clearInstances()
+{
+	Transforms.clear();
+	Colors.clear();
+	VisibleTransforms.clear();
+	VisibleColors.clear();
+	BoundsDirty = true;
+}
+
+
+//! Sets the transformation of an instance relative to the node
+void CInstancedMeshSceneNode::setInstanceTransform(u32 index, const core::matrix4& transform)
+{
+	if (index < Transforms.size())
+	{
+		Transforms[index] = transform;
+		BoundsDirty = true;
+	}
+}
+
+
+//! Get the transformation of an instance relative to the node
+const core::matrix4& CInstancedMeshSceneNode::getInstanceTransform(u32 index) const
+{
+	return index < Transforms.size() ? Transforms[index] : core::IdentityMatrix;
+}
+
+
+//! Sets the color of an instance
+void CInstancedMeshSceneNode::setInstanceColor(u32 index, video::SColor color)
+{
+	if (index < Colors.size())
+		Colors[index] = color;
+}
+
+
+//! Get the color of an instance
+video::SColor CInstancedMeshSceneNode::getInstanceColor(u32 index) const
+{
+	return index < Colors.size() ? Colors[index] : video::SColor(255,255,255,255);
+}
+
+
+void CInstancedMeshSceneNode::copyMaterials()
+{
+	Materials.clear();
+
+	if (Mesh)
+	{
+		video::SMaterial mat;
+
+		for (u32 i=0; i<Mesh->getMeshBufferCount(); ++i)
+		{
+			IMeshBuffer* mb = Mesh->getMeshBuffer(i);
+			if (mb)
+				mat = mb->getMaterial();
+
+			Materials.push_back(mat);
+		}
+	}
+}
+
+
+//! Writes attributes of the scene node.
+void CInstancedMeshSceneNode::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
+{
+	IInstancedMeshSceneNode::serializeAttributes(out, options);
+
+	if (options && (options->Flags&io::EARWF_USE_RELATIVE_PATHS) && options->Filename)
+	{
+		const io::path path = SceneManager->getFileSystem()->getRelativeFilename(
+				SceneManager->getFileSystem()->getAbsolutePath(SceneManager->getMeshCache()->getMeshName(Mesh).getPath()),
+				options->Filename);
+		out->addString("Mesh", path.c_str());
+	}
+	else
+		out->addString("Mesh", SceneManager->getMeshCache()->getMeshName(Mesh).getPath().c_str());
+
+	out->addInt("InstanceCount", Transforms.size());
+	for (u32 i=0; i<Transforms.size(); ++i)
+	{
+		core::stringc name = "Instance";
+		name += i;
+		out->addMatrix(name.c_str(), Transforms[i]);
+		name += "Color";
+		out->addColor(name.c_str(), Colors[i]);
+	}
+}
+
+
+//! Reads attributes of the scene node.
+void CInstancedMeshSceneNode::deserializeAttributes(io::IAttributes* in, io::SAttributeReadWriteOptions* options)
+{
+	io::path oldMeshStr = SceneManager->getMeshCache()->getMeshName(Mesh);
+	io::path newMeshStr = in->getAttributeAsString("Mesh");
+
+	if (newMeshStr != "" && oldMeshStr != newMeshStr)
+	{
+		IAnimatedMesh* newAnimatedMesh = SceneManager->getMesh(newMeshStr.c_str());
+
+		if (newAnimatedMesh && newAnimatedMesh->getMesh(0))
+			setMesh(newAnimatedMesh->getMesh(0));
+	}
+
+	if (in->existsAttribute("InstanceCount"))
+	{
+		clearInstances();
+
+		const s32 count = in->getAttributeAsInt("InstanceCount");
+		for (s32 i=0; i<count; ++i)
+		{
+			core::stringc name = "Instance";
+			name += i;
+			const core::matrix4 transform = in->getAttributeAsMatrix(name.c_str());
+			name += "Color";
+			addInstance(transform, in->existsAttribute(name.c_str()) ?
+				in->getAttributeAsColor(name.c_str()) : video::SColor(255,255,255,255));
+		}
+	}
+
+	IInstancedMeshSceneNode::deserializeAttributes(in, options);
+}
+
+
+//! Creates a clone of this scene node and its children.
+ISceneNode* CInstancedMeshSceneNode::clone(ISceneNode* newParent, ISceneManager* newManager)
+{
+	if (!newParent)
+		newParent = Parent;
+	if (!newManager)
+		newManager = SceneManager;
+
+	CInstancedMeshSceneNode* nb = new CInstancedMeshSceneNode(Mesh, newParent,
+		newManager, ID, RelativeTranslation, RelativeRotation, RelativeScale);
+
+	nb->cloneMembers(this, newManager);
+	nb->Materials = Materials;
+	nb->Transforms = Transforms;
+	nb->Colors = Colors;
+
+	if (newParent)
+		nb->drop();
+	return nb;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,646 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+
+#include "CIrrBinaryMeshFileLoader.h"
+#include "IrrBinaryMeshFormat.h"
+#include "os.h"
+#include "IReadFile.h"
+#include "IVideoDriver.h"
+#include "SMesh.h"
+#include "SAnimatedMesh.h"
+#include "CDynamicMeshBuffer.h"
+
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	#ifndef _IRR_USE_NON_SYSTEM_ZLIB_
+	#include <zlib.h> // use system lib
+	#else
+	#include "zlib/zlib.h"
+	#endif
+#endif
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	inline u16 getU16(const u8* in)
+	{
+		return (u16)(in[0] | (in[1] << 8));
+	}
+
+	inline u32 getU32(const u8* in)
+	{
+		return (u32)in[0] | ((u32)in[1] << 8) | ((u32)in[2] << 16) | ((u32)in[3] << 24);
+	}
+
+	// smallest number of bytes a vertex takes in the file
+	const u32 MIN_VERTEX_SIZE = 18;
+}
+
+
+u8 CIrrBinaryMeshFileLoader::SReader::readU8()
+{
+	const u8* p = read(1);
+	return p ? p[0] : 0;
+}
+
+
+u16 CIrrBinaryMeshFileLoader::SReader::readU16()
+{
+	const u8* p = read(2);
+	return p ? getU16(p) : 0;
+}
+
+
+u32 CIrrBinaryMeshFileLoader::SReader::readU32()
+{
+	const u8* p = read(4);
+	return p ? getU32(p) : 0;
+}
+
+
+f32 CIrrBinaryMeshFileLoader::SReader::readF32()
+{
+	u32 value = readU32();
+	return FR(value);
+}
+
+
+u32 CIrrBinaryMeshFileLoader::SReader::readVarInt()
+{
+	u32 value = 0;
+	for (u32 shift=0; shift<35; shift+=7)
+	{
+		const u8 byte = readU8();
+		value |= (u32)(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return value;
+	}
+	Failed = true;
+	return 0;
+}
+
+
+core::stringc CIrrBinaryMeshFileLoader::SReader::readString()
+{
+	const u32 size = readVarInt();
+	const u8* p = read(size);
+	if (!p)
+		return core::stringc();
+	return core::stringc((const c8*)p, size);
+}
+
+
+core::vector3df CIrrBinaryMeshFileLoader::SReader::readVector()
+{
+	core::vector3df v;
+	v.X = readF32();
+	v.Y = readF32();
+	v.Z = readF32();
+	return v;
+}
+
+
+core::matrix4 CIrrBinaryMeshFileLoader::SReader::readMatrix()
+{
+	core::matrix4 m(core::matrix4::EM4CONST_NOTHING);
+	for (u32 i=0; i<16; ++i)
+		m[i] = readF32();
+	return m;
+}
+
+
+//! Constructor
+CIrrBinaryMeshFileLoader::CIrrBinaryMeshFileLoader(scene::ISceneManager* smgr,
+		io::IFileSystem* fs)
+	: SceneManager(smgr), FileSystem(fs)
+{
+
+	#ifdef _DEBUG
+	setDebugName("CIrrBinaryMeshFileLoader");
+	#endif
+
+}
+
+
+//! Returns true if the file maybe is able to be loaded by this class.
+/** This decision should be based only on the file extension (e.g. ".cob") */
+bool CIrrBinaryMeshFileLoader::isALoadableFileExtension(const io::path& filename) const
+{
+	return core::hasFileExtension ( filename, "irrbmesh" );
+}
+
+
+//! creates/loads an animated mesh from the file.
+//! \return Pointer to the created mesh. Returns 0 if loading failed.
+//! If you no longer need the mesh, you should call IAnimatedMesh::drop().
+//! See IReferenceCounted::drop() for more information.
+IAnimatedMesh* CIrrBinaryMeshFileLoader::createMesh(io::IReadFile* file)
+{
+	if (!file)
+		return 0;
+
+	// read and check the header
+
+	u8 header[binarymesh::IRR_BINARY_MESH_HEADER_SIZE];
+	if (file->read(header, sizeof(header)) != (s32)sizeof(header) ||
+		header[0] != 'I' || header[1] != 'R' || header[2] != 'B' || header[3] != 'M')
+	{
+		os::Printer::log("Not a binary Irrlicht mesh", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	const u16 version = getU16(header+4);
+	const u16 flags = getU16(header+6);
+	const u32 dataSize = getU32(header+8);
+	const u32 storedSize = getU32(header+12);
+
+	if (version > binarymesh::IRR_BINARY_MESH_VERSION)
+	{
+		os::Printer::log("Unsupported version of binary Irrlicht mesh", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	if (storedSize > (u32)(file->getSize() - file->getPos()) ||
+		(!(flags & binarymesh::EIBMF_COMPRESSED) && dataSize != storedSize))
+	{
+		os::Printer::log("Binary Irrlicht mesh is truncated", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	// read the mesh data, uncompressed
+
+	core::array<u8> stored;
+	stored.set_used(storedSize);
+	if (file->read(stored.pointer(), storedSize) != (s32)storedSize)
+	{
+		os::Printer::log("Could not read binary Irrlicht mesh", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	if (flags & binarymesh::EIBMF_COMPRESSED)
+	{
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+		core::array<u8> data;
+		uLongf size = dataSize;
+		// zlib doesn't compress better than about 1:1000
+		bool success = (dataSize/1024 <= storedSize);
+		if (success)
+		{
+			data.set_used(dataSize);
+			success = (uncompress(data.pointer(), &size, stored.const_pointer(), storedSize) == Z_OK) && (size == dataSize);
+		}
+		if (!success)
+		{
+			os::Printer::log("Could not uncompress binary Irrlicht mesh", file->getFileName(), ELL_ERROR);
+			return 0;
+		}
+		stored.swap(data);
+#else
+		os::Printer::log("Compiled without zlib, can't load compressed binary Irrlicht mesh", file->getFileName(), ELL_ERROR);
+		return 0;
+#endif
+	}
+
+	SReader reader(stored.const_pointer(), stored.size());
+	const io::path meshDir = FileSystem->getFileDir(file->getFileName());
+
+	const u32 bufferCount = reader.readU32();
+	if (bufferCount > reader.remaining())
+		reader.Failed = true;
+
+	IAnimatedMesh* result = 0;
+
+	if (flags & binarymesh::EIBMF_SKINNED)
+	{
+		ISkinnedMesh* mesh = SceneManager->createSkinnedMesh();
+		if (!mesh)
+		{
+			os::Printer::log("Compiled without skinned meshes, can't load", file->getFileName(), ELL_ERROR);
+			return 0;
+		}
+
+		for (u32 i=0; i<bufferCount && !reader.Failed; ++i)
+		{
+			if (!readMeshBuffer(reader, mesh, meshDir))
+				reader.Failed = true;
+		}
+
+		if (!reader.Failed && readJoints(reader, mesh))
+		{
+			mesh->finalize();
+			result = mesh;
+		}
+		else
+			mesh->drop();
+	}
+	else
+	{
+		SMesh* mesh = new SMesh();
+
+		for (u32 i=0; i<bufferCount && !reader.Failed; ++i)
+		{
+			IMeshBuffer* buffer = readMeshBuffer(reader, 0, meshDir);
+			if (buffer)
+			{
+				mesh->addMeshBuffer(buffer);
+				buffer->drop();
+			}
+			else
+				reader.Failed = true;
+		}
+
+		if (!reader.Failed)
+		{
+			mesh->recalculateBoundingBox();
+
+			SAnimatedMesh* animatedMesh = new SAnimatedMesh(mesh);
+			animatedMesh->recalculateBoundingBox();
+			result = animatedMesh;
+		}
+		mesh->drop();
+	}
+
+	if (!result)
+		os::Printer::log("Binary Irrlicht mesh is corrupt", file->getFileName(), ELL_ERROR);
+
+	return result;
+}
+
+
+//! reads a mesh buffer, added to skinnedMesh if given
+IMeshBuffer* CIrrBinaryMeshFileLoader::readMeshBuffer(SReader& reader,
+		ISkinnedMesh* skinnedMesh, const io::path& meshDir)
+{
+	video::SMaterial material;
+	readMaterial(reader, material, meshDir);
+
+	const u32 vertexType = reader.readU8();
+	const u32 indexType = reader.readU8();
+	const u32 vertexCount = reader.readVarInt();
+	const u32 indexCount = reader.readVarInt();
+
+	// skinned mesh buffers only have 16 bit indices
+	if (reader.Failed ||
+		vertexType > video::EVT_TANGENTS || indexType > video::EIT_32BIT ||
+		(skinnedMesh && indexType != video::EIT_16BIT) ||
+		vertexCount > reader.remaining()/MIN_VERTEX_SIZE ||
+		indexCount > reader.remaining() - vertexCount*MIN_VERTEX_SIZE)
+		return 0;
+
+	core::aabbox3df box;
+	box.MinEdge = reader.readVector();
+	box.MaxEdge = reader.readVector();
+	const core::vector3df extent = box.getExtent();
+
+	const u32 texCoordSets = (vertexType == video::EVT_2TCOORDS) ? 2 : 1;
+	core::vector2df texCoordMin[2];
+	core::vector2df texCoordExtent[2];
+	for (u32 t=0; t<texCoordSets; ++t)
+	{
+		texCoordMin[t].X = reader.readF32();
+		texCoordMin[t].Y = reader.readF32();
+		texCoordExtent[t].X = reader.readF32();
+		texCoordExtent[t].Y = reader.readF32();
+	}
+
+	// check the size of the vertex data, the indices are checked while reading them
+
+	const u32 vertexSize = 6 + 4 + 4 + texCoordSets*4 + (vertexType == video::EVT_TANGENTS ? 8 : 0);
+	if (reader.Failed || vertexCount > reader.remaining()/vertexSize)
+		return 0;
+
+	// create the buffer
+
+	IMeshBuffer* buffer = 0;
+	u8* vertices = 0;
+	void* indices = 0;
+
+	if (skinnedMesh)
+	{
+		SSkinMeshBuffer* skinBuffer = skinnedMesh->addMeshBuffer();
+		skinBuffer->VertexType = (video::E_VERTEX_TYPE)vertexType;
+		switch (vertexType)
+		{
+		case video::EVT_STANDARD:
+			skinBuffer->Vertices_Standard.set_used(vertexCount);
+			break;
+		case video::EVT_2TCOORDS:
+			skinBuffer->Vertices_2TCoords.set_used(vertexCount);
+			break;
+		case video::EVT_TANGENTS:
+			skinBuffer->Vertices_Tangents.set_used(vertexCount);
+			break;
+		}
+		skinBuffer->Indices.set_used(indexCount);
+		buffer = skinBuffer;
+	}
+	else
+	{
+		CDynamicMeshBuffer* dynamicBuffer = new CDynamicMeshBuffer((video::E_VERTEX_TYPE)vertexType, (video::E_INDEX_TYPE)indexType);
+		dynamicBuffer->getVertexBuffer().set_used(vertexCount);
+		dynamicBuffer->getIndexBuffer().set_used(indexCount);
+		buffer = dynamicBuffer;
+	}
+
+	buffer->getMaterial() = material;
+	vertices = (u8*)buffer->getVertices();
+	indices = buffer->getIndices();
+	const u32 pitch = video::getVertexPitchFromType((video::E_VERTEX_TYPE)vertexType);
+
+	// decode the vertex attributes
+
+	const u8* in = reader.read(vertexCount*6);
+	for (u32 i=0; i<vertexCount; ++i, in+=6)
+	{
+		video::S3DVertex& vtx = *(video::S3DVertex*)(vertices + i*pitch);
+		vtx.Pos.X = binarymesh::dequantize(getU16(in), box.MinEdge.X, extent.X);
+		vtx.Pos.Y = binarymesh::dequantize(getU16(in+2), box.MinEdge.Y, extent.Y);
+		vtx.Pos.Z = binarymesh::dequantize(getU16(in+4), box.MinEdge.Z, extent.Z);
+	}
+
+	in = reader.read(vertexCount*4);
+	for (u32 i=0; i<vertexCount; ++i, in+=4)
+		((video::S3DVertex*)(vertices + i*pitch))->Normal = binarymesh::decodeDirection(getU16(in), getU16(in+2));
+
+	in = reader.read(vertexCount*4);
+	for (u32 i=0; i<vertexCount; ++i, in+=4)
+		((video::S3DVertex*)(vertices + i*pitch))->Color.color = getU32(in);
+
+	for (u32 t=0; t<texCoordSets; ++t)
+	{
+		in = reader.read(vertexCount*4);
+		for (u32 i=0; i<vertexCount; ++i, in+=4)
+		{
+			core::vector2df& tc = (t == 0) ? ((video::S3DVertex*)(vertices + i*pitch))->TCoords :
+				((video::S3DVertex2TCoords*)(vertices + i*pitch))->TCoords2;
+			tc.X = binarymesh::dequantize(getU16(in), texCoordMin[t].X, texCoordExtent[t].X);
+			tc.Y = binarymesh::dequantize(getU16(in+2), texCoordMin[t].Y, texCoordExtent[t].Y);
+		}
+	}
+
+	if (vertexType == video::EVT_TANGENTS)
+	{
+		in = reader.read(vertexCount*8);
+		for (u32 i=0; i<vertexCount; ++i, in+=4)
+		{
+			video::S3DVertexTangents& vtx = *(video::S3DVertexTangents*)(vertices + i*pitch);
+			vtx.Tangent = binarymesh::decodeDirection(getU16(in), getU16(in+2));
+			vtx.Binormal = binarymesh::decodeDirection(getU16(in+vertexCount*4), getU16(in+vertexCount*4+2));
+		}
+	}
+
+	// indices, as difference to the previous index
+
+	u32 last = 0;
+	for (u32 i=0; i<indexCount; ++i)
+	{
+		const u32 zigzag = reader.readVarInt();
+		last += (zigzag >> 1) ^ (0u - (zigzag & 1));
+		if (last >= vertexCount)
+		{
+			reader.Failed = true;
+			break;
+		}
+		if (indexType == video::EIT_32BIT)
+			((u32*)indices)[i] = last;
+		else
+			((u16*)indices)[i] = (u16)last;
+	}
+
+	if (reader.Failed)
+	{
+		// buffers of skinned meshes are released with the mesh
+		if (!skinnedMesh)
+			buffer->drop();
+		return 0;
+	}
+
+	buffer->recalculateBoundingBox();
+	return buffer;
+}
+
+
+void CIrrBinaryMeshFileLoader::readMaterial(SReader& reader, video::SMaterial& material, const io::path& meshDir)
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+	const core::stringc typeName = reader.readString();
+	material.MaterialType = video::EMT_SOLID;
+	for (u32 i=0; i<driver->getMaterialRendererCount(); ++i)
+	{
+		if (typeName == driver->getMaterialRendererName(i))
+		{
+			material.MaterialType = (video::E_MATERIAL_TYPE)i;
+			break;
+		}
+	}
+
+	material.AmbientColor.color = reader.readU32();
+	material.DiffuseColor.color = reader.readU32();
+	material.EmissiveColor.color = reader.readU32();
+	material.SpecularColor.color = reader.readU32();
+	material.Shininess = reader.readF32();
+	material.MaterialTypeParam = reader.readF32();
+	material.MaterialTypeParam2 = reader.readF32();
+	material.Thickness = reader.readF32();
+
+	material.ZBuffer = reader.readU8();
+	material.AntiAliasing = reader.readU8();
+	material.ColorMask = reader.readU8();
+	material.ColorMaterial = reader.readU8();
+	material.BlendOperation = (video::E_BLEND_OPERATION)reader.readU8();
+	material.PolygonOffsetFactor = reader.readU8();
+	material.PolygonOffsetDirection = (video::E_POLYGON_OFFSET)reader.readU8();
+
+	const u16 flags = reader.readU16();
+	material.Wireframe = (flags & 0x1) != 0;
+	material.PointCloud = (flags & 0x2) != 0;
+	material.GouraudShading = (flags & 0x4) != 0;
+	material.Lighting = (flags & 0x8) != 0;
+	material.ZWriteEnable = (flags & 0x10) != 0;
+	material.BackfaceCulling = (flags & 0x20) != 0;
+	material.FrontfaceCulling = (flags & 0x40) != 0;
+	material.FogEnable = (flags & 0x80) != 0;
+	material.NormalizeNormals = (flags & 0x100) != 0;
+	material.UseMipMaps = (flags & 0x200) != 0;
+
+	// files written with more texture layers than this engine has keep the first ones
+	const u32 layerCount = reader.readU8();
+	for (u32 i=0; i<layerCount && !reader.Failed; ++i)
+	{
+		const core::stringc textureName = reader.readString();
+		const u8 wrap = reader.readU8();
+		const u8 layerFlags = reader.readU8();
+		const u8 anisotropicFilter = reader.readU8();
+		const s8 lodBias = (s8)reader.readU8();
+		core::matrix4 textureMatrix;
+		if (layerFlags & binarymesh::EIBMLF_TEXTURE_MATRIX)
+			textureMatrix = reader.readMatrix();
+
+		if (i >= video::MATERIAL_MAX_TEXTURES)
+			continue;
+
+		video::SMaterialLayer& layer = material.TextureLayer[i];
+		layer.TextureWrapU = wrap & 0xf;
+		layer.TextureWrapV = wrap >> 4;
+		layer.BilinearFilter = (layerFlags & binarymesh::EIBMLF_BILINEAR) != 0;
+		layer.TrilinearFilter = (layerFlags & binarymesh::EIBMLF_TRILINEAR) != 0;
+		layer.AnisotropicFilter = anisotropicFilter;
+		layer.LODBias = lodBias;
+		if (layerFlags & binarymesh::EIBMLF_TEXTURE_MATRIX)
+			material.setTextureMatrix(i, textureMatrix);
+
+		// texture names are relative to the mesh file
+		if (textureName.size())
+		{
+			io::path texturePath = meshDir + "/" + textureName;
+			if (!FileSystem->existFile(texturePath))
+				texturePath = textureName;
+			material.setTexture(i, driver->getTexture(texturePath));
+		}
+	}
+}
+
+
+bool CIrrBinaryMeshFileLoader::readJoints(SReader& reader, ISkinnedMesh* mesh)
+{
+	const f32 animationSpeed = reader.readF32();
+	const u32 jointCount = reader.readVarInt();
+	if (reader.Failed || jointCount > reader.remaining())
+		return false;
+
+	// create all joints first, so that children can be linked by number
+	u32 i;
+	for (i=0; i<jointCount; ++i)
+		mesh->addJoint(0);
+
+	core::array<ISkinnedMesh::SJoint*>& joints = mesh->getAllJoints();
+	const core::array<SSkinMeshBuffer*>& buffers = mesh->getMeshBuffers();
+
+	core::array<bool> hasParent;
+	hasParent.set_used(jointCount);
+	for (i=0; i<jointCount; ++i)
+		hasParent[i] = false;
+
+	for (i=0; i<jointCount && !reader.Failed; ++i)
+	{
+		ISkinnedMesh::SJoint* joint = joints[i];
+
+		joint->Name = reader.readString();
+		joint->LocalMatrix = reader.readMatrix();
+		joint->GlobalInversedMatrix = reader.readMatrix();
+
+		u32 j;
+		u32 count = reader.readVarInt();
+		for (j=0; j<count && !reader.Failed; ++j)
+		{
+			// a joint may only be the child of one other joint
+			const u32 child = reader.readVarInt();
+			if (child >= jointCount || child == i || hasParent[child])
+				return false;
+			hasParent[child] = true;
+			joint->Children.push_back(joints[child]);
+		}
+
+		count = reader.readVarInt();
+		for (j=0; j<count && !reader.Failed; ++j)
+		{
+			const u32 bufferIndex = reader.readVarInt();
+			if (bufferIndex >= buffers.size())
+				return false;
+			joint->AttachedMeshes.push_back(bufferIndex);
+		}
+
+		count = reader.readVarInt();
+		if (count > reader.remaining()/16)
+			return false;
+		joint->PositionKeys.set_used(count);
+		for (j=0; j<count; ++j)
+		{
+			joint->PositionKeys[j].frame = reader.readF32();
+			joint->PositionKeys[j].position = reader.readVector();
+		}
+
+		count = reader.readVarInt();
+		if (count > reader.remaining()/16)
+			return false;
+		joint->ScaleKeys.set_used(count);
+		for (j=0; j<count; ++j)
+		{
+			joint->ScaleKeys[j].frame = reader.readF32();
+			joint->ScaleKeys[j].scale = reader.readVector();
+		}
+
+		count = reader.readVarInt();
+		if (count > reader.remaining()/20)
+			return false;
+		joint->RotationKeys.set_used(count);
+		for (j=0; j<count; ++j)
+		{
+			joint->RotationKeys[j].frame = reader.readF32();
+			core::quaternion& rotation = joint->RotationKeys[j].rotation;
+			rotation.X = reader.readF32();
+			rotation.Y = reader.readF32();
+			rotation.Z = reader.readF32();
+			rotation.W = reader.readF32();
+		}
+
+		count = reader.readVarInt();
+		if (count > reader.remaining()/6)
+			return false;
+		joint->Weights.reallocate(count);
+		for (j=0; j<count && !reader.Failed; ++j)
+		{
+			ISkinnedMesh::SWeight* weight = mesh->addWeight(joint);
+			const u32 bufferIndex = reader.readVarInt();
+			weight->vertex_id = reader.readVarInt();
+			weight->strength = reader.readF32();
+			if (bufferIndex >= buffers.size() || weight->vertex_id >= buffers[bufferIndex]->getVertexCount())
+				return false;
+			weight->buffer_id = (u16)bufferIndex;
+		}
+	}
+
+	if (reader.Failed)
+		return false;
+
+	// each joint has one parent at most, so the hierarchy has no cycles
+	// if all joints are reached from the joints without parent
+	core::array<ISkinnedMesh::SJoint*> pending;
+	for (i=0; i<jointCount; ++i)
+	{
+		if (!hasParent[i])
+			pending.push_back(joints[i]);
+	}
+
+	u32 reached = 0;
+	while (pending.size())
+	{
+		ISkinnedMesh::SJoint* joint = pending.getLast();
+		pending.set_used(pending.size()-1);
+		++reached;
+
+		for (u32 j=0; j<joint->Children.size(); ++j)
+			pending.push_back(joint->Children[j]);
+	}
+
+	if (reached != jointCount)
+		return false;
+
+	mesh->setAnimationSpeed(animationSpeed);
+	return true;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+
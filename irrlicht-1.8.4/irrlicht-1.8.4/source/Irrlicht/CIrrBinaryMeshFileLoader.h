@@ -0,0 +1,92 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_IRR_BINARY_MESH_FILE_LOADER_H_INCLUDED__
+#define __C_IRR_BINARY_MESH_FILE_LOADER_H_INCLUDED__
+
+#include "IMeshLoader.h"
+#include "IFileSystem.h"
+#include "ISceneManager.h"
+#include "ISkinnedMesh.h"
+
+namespace irr
+{
+namespace scene
+{
+
+
+//! Meshloader capable of loading .irrbmesh meshes, the binary Irrlicht Engine mesh format
+/** Loads the static and skinned meshes written by CIrrBinaryMeshWriter, see
+IrrBinaryMeshFormat.h for the layout of the files. */
+class CIrrBinaryMeshFileLoader : public IMeshLoader
+{
+public:
+
+	//! Constructor
+	CIrrBinaryMeshFileLoader(scene::ISceneManager* smgr, io::IFileSystem* fs);
+
+	//! returns true if the file maybe is able to be loaded by this class
+	//! based on the file extension (e.g. ".irrbmesh")
+	virtual bool isALoadableFileExtension(const io::path& filename) const;
+
+	//! creates/loads an animated mesh from the file.
+	//! \return Pointer to the created mesh. Returns 0 if loading failed.
+	//! If you no longer need the mesh, you should call IAnimatedMesh::drop().
+	//! See IReferenceCounted::drop() for more information.
+	virtual IAnimatedMesh* createMesh(io::IReadFile* file);
+
+private:
+
+	//! reads little endian values from the mesh data, and notes reading past its end
+	struct SReader
+	{
+		SReader(const u8* data, u32 size) : Pos(data), End(data+size), Failed(false) {}
+
+		//! returns the next n bytes, or 0 if there are not enough left
+		const u8* read(u32 n)
+		{
+			if ((u32)(End-Pos) < n)
+			{
+				Failed = true;
+				Pos = End;
+				return 0;
+			}
+			const u8* p = Pos;
+			Pos += n;
+			return p;
+		}
+
+		u32 remaining() const { return (u32)(End-Pos); }
+
+		u8 readU8();
+		u16 readU16();
+		u32 readU32();
+		f32 readF32();
+		u32 readVarInt();
+		core::stringc readString();
+		core::vector3df readVector();
+		core::matrix4 readMatrix();
+
+		const u8* Pos;
+		const u8* End;
+		bool Failed;
+	};
+
+	//! reads a mesh buffer, added to skinnedMesh if given
+	IMeshBuffer* readMeshBuffer(SReader& reader, ISkinnedMesh* skinnedMesh, const io::path& meshDir);
+
+	void readMaterial(SReader& reader, video::SMaterial& material, const io::path& meshDir);
+
+	bool readJoints(SReader& reader, ISkinnedMesh* mesh);
+
+	scene::ISceneManager* SceneManager;
+	io::IFileSystem* FileSystem;
+};
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -0,0 +1,536 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_WRITER_
+
+#include "CIrrBinaryMeshWriter.h"
+#include "IrrBinaryMeshFormat.h"
+#include "os.h"
+#include "IWriteFile.h"
+#include "IMesh.h"
+
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	#ifndef _IRR_USE_NON_SYSTEM_ZLIB_
+	#include <zlib.h> // use system lib
+	#else
+	#include "zlib/zlib.h"
+	#endif
+#endif
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	inline const video::S3DVertex& vertexAt(const u8* vertices, u32 pitch, u32 i)
+	{
+		return *(const video::S3DVertex*)(vertices + i*pitch);
+	}
+
+	inline void putU16(u8* out, u16 value)
+	{
+		out[0] = (u8)value;
+		out[1] = (u8)(value >> 8);
+	}
+
+	inline void putU32(u8* out, u32 value)
+	{
+		out[0] = (u8)value;
+		out[1] = (u8)(value >> 8);
+		out[2] = (u8)(value >> 16);
+		out[3] = (u8)(value >> 24);
+	}
+}
+
+
+CIrrBinaryMeshWriter::CIrrBinaryMeshWriter(video::IVideoDriver* driver,
+				io::IFileSystem* fs)
+	: FileSystem(fs), VideoDriver(driver)
+{
+	#ifdef _DEBUG
+	setDebugName("CIrrBinaryMeshWriter");
+	#endif
+
+	if (VideoDriver)
+		VideoDriver->grab();
+
+	if (FileSystem)
+		FileSystem->grab();
+}
+
+
+CIrrBinaryMeshWriter::~CIrrBinaryMeshWriter()
+{
+	if (VideoDriver)
+		VideoDriver->drop();
+
+	if (FileSystem)
+		FileSystem->drop();
+}
+
+
+//! Returns the type of the mesh writer
+EMESH_WRITER_TYPE CIrrBinaryMeshWriter::getType() const
+{
+	return EMWT_IRR_BINARY_MESH;
+}
+
+
+//! writes a mesh
+bool CIrrBinaryMeshWriter::writeMesh(io::IWriteFile* file, scene::IMesh* mesh, s32 flags)
+{
+	return writeFile(file, mesh, 0, flags);
+}
+
+
+//! writes an animated mesh, with joints and animation if it is skinned
+bool CIrrBinaryMeshWriter::writeAnimatedMesh(io::IWriteFile* file, scene::IAnimatedMesh* mesh, s32 flags)
+{
+	if (!mesh)
+		return false;
+
+	if (mesh->getMeshType() == EAMT_SKINNED)
+		return writeFile(file, mesh, (ISkinnedMesh*)mesh, flags);
+
+	return writeFile(file, mesh->getMesh(0), 0, flags);
+}
+
+
+bool CIrrBinaryMeshWriter::writeFile(io::IWriteFile* file, scene::IMesh* mesh,
+		ISkinnedMesh* skinnedMesh, s32 flags)
+{
+	if (!file || !mesh)
+		return false;
+
+	os::Printer::log("Writing mesh", file->getFileName());
+
+	MeshDir = FileSystem->getFileDir(file->getFileName());
+	Data.set_used(0);
+
+	const u32 bufferCount = mesh->getMeshBufferCount();
+
+	// The buffers of skinned meshes contain the vertices of the last
+	// animated frame, the weights still know where they were before.
+	core::array<core::array<core::vector3df> > staticPositions;
+	core::array<core::array<core::vector3df> > staticNormals;
+	if (skinnedMesh)
+	{
+		staticPositions.reallocate(bufferCount);
+		staticNormals.reallocate(bufferCount);
+		for (u32 i=0; i<bufferCount; ++i)
+		{
+			const IMeshBuffer* buffer = mesh->getMeshBuffer(i);
+			const u32 vertexCount = buffer->getVertexCount();
+			staticPositions.push_back(core::array<core::vector3df>());
+			staticNormals.push_back(core::array<core::vector3df>());
+			staticPositions[i].set_used(vertexCount);
+			staticNormals[i].set_used(vertexCount);
+			for (u32 j=0; j<vertexCount; ++j)
+			{
+				staticPositions[i][j] = buffer->getPosition(j);
+				staticNormals[i][j] = buffer->getNormal(j);
+			}
+		}
+
+		const core::array<ISkinnedMesh::SJoint*>& joints = skinnedMesh->getAllJoints();
+		for (u32 i=0; i<joints.size(); ++i)
+		{
+			for (u32 j=0; j<joints[i]->Weights.size(); ++j)
+			{
+				const ISkinnedMesh::SWeight& weight = joints[i]->Weights[j];
+				if (weight.buffer_id < bufferCount && weight.vertex_id < staticPositions[weight.buffer_id].size())
+				{
+					staticPositions[weight.buffer_id][weight.vertex_id] = weight.getStaticPos();
+					staticNormals[weight.buffer_id][weight.vertex_id] = weight.getStaticNormal();
+				}
+			}
+		}
+	}
+
+	// write mesh buffers
+
+	writeU32(bufferCount);
+	for (u32 i=0; i<bufferCount; ++i)
+	{
+		writeMeshBuffer(mesh->getMeshBuffer(i),
+			skinnedMesh ? &staticPositions[i] : 0,
+			skinnedMesh ? &staticNormals[i] : 0);
+	}
+
+	if (skinnedMesh)
+		writeJoints(skinnedMesh);
+
+	// compress the data if wanted
+
+	u16 headerFlags = skinnedMesh ? binarymesh::EIBMF_SKINNED : 0;
+	const u8* storedData = Data.const_pointer();
+	u32 storedSize = Data.size();
+
+	core::array<u8> compressed;
+	if (flags & EMWF_WRITE_COMPRESSED)
+	{
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+		uLongf compressedSize = compressBound(Data.size());
+		compressed.set_used(compressedSize);
+		if (compress2(compressed.pointer(), &compressedSize, Data.const_pointer(), Data.size(), Z_BEST_COMPRESSION) == Z_OK)
+		{
+			headerFlags |= binarymesh::EIBMF_COMPRESSED;
+			storedData = compressed.const_pointer();
+			storedSize = compressedSize;
+		}
+		else
+			os::Printer::log("Could not compress mesh, writing it uncompressed", file->getFileName(), ELL_WARNING);
+#else
+		os::Printer::log("Compiled without zlib, writing mesh uncompressed", file->getFileName(), ELL_WARNING);
+#endif
+	}
+
+	// write header and data
+
+	u8 header[binarymesh::IRR_BINARY_MESH_HEADER_SIZE];
+	header[0] = 'I';
+	header[1] = 'R';
+	header[2] = 'B';
+	header[3] = 'M';
+	putU16(header+4, binarymesh::IRR_BINARY_MESH_VERSION);
+	putU16(header+6, headerFlags);
+	putU32(header+8, Data.size());
+	putU32(header+12, storedSize);
+
+	const bool success = file->write(header, sizeof(header)) == (s32)sizeof(header) &&
+		file->write(storedData, storedSize) == (s32)storedSize;
+
+	Data.clear();
+
+	if (!success)
+		os::Printer::log("Could not write file", file->getFileName(), ELL_ERROR);
+
+	return success;
+}
+
+
+void CIrrBinaryMeshWriter::writeMeshBuffer(const scene::IMeshBuffer* buffer,
+		const core::array<core::vector3df>* staticPositions,
+		const core::array<core::vector3df>* staticNormals)
+{
+	writeMaterial(buffer->getMaterial());
+
+	const video::E_VERTEX_TYPE vertexType = buffer->getVertexType();
+	const u32 pitch = video::getVertexPitchFromType(vertexType);
+	const u8* vertices = (const u8*)buffer->getVertices();
+	const u32 vertexCount = buffer->getVertexCount();
+	const u32 indexCount = buffer->getIndexCount();
+
+	writeU8((u8)vertexType);
+	writeU8((u8)buffer->getIndexType());
+	writeVarInt(vertexCount);
+	writeVarInt(indexCount);
+
+	// the bounding box is the range of the quantized positions, so
+	// it is recalculated instead of trusting the one of the buffer
+	core::aabbox3df box(0,0,0, 0,0,0);
+	for (u32 i=0; i<vertexCount; ++i)
+	{
+		const core::vector3df& pos = staticPositions ? (*staticPositions)[i] : vertexAt(vertices, pitch, i).Pos;
+		if (i == 0)
+			box.reset(pos);
+		else
+			box.addInternalPoint(pos);
+	}
+	writeVector(box.MinEdge);
+	writeVector(box.MaxEdge);
+	const core::vector3df extent = box.getExtent();
+
+	// ranges of the texture coordinates
+	const u32 texCoordSets = (vertexType == video::EVT_2TCOORDS) ? 2 : 1;
+	core::rectf texCoordRange[2];
+	for (u32 t=0; t<texCoordSets; ++t)
+	{
+		for (u32 i=0; i<vertexCount; ++i)
+		{
+			const core::vector2df& tc = (t == 0) ? vertexAt(vertices, pitch, i).TCoords :
+				((const video::S3DVertex2TCoords*)(vertices + i*pitch))->TCoords2;
+			if (i == 0)
+				texCoordRange[t] = core::rectf(tc, tc);
+			else
+				texCoordRange[t].addInternalPoint(tc);
+		}
+		writeF32(texCoordRange[t].UpperLeftCorner.X);
+		writeF32(texCoordRange[t].UpperLeftCorner.Y);
+		writeF32(texCoordRange[t].getWidth());
+		writeF32(texCoordRange[t].getHeight());
+	}
+
+	// each attribute of all vertices after another
+
+	u8* out = grow(vertexCount*6);
+	for (u32 i=0; i<vertexCount; ++i, out+=6)
+	{
+		const core::vector3df& pos = staticPositions ? (*staticPositions)[i] : vertexAt(vertices, pitch, i).Pos;
+		putU16(out, binarymesh::quantize(pos.X, box.MinEdge.X, extent.X));
+		putU16(out+2, binarymesh::quantize(pos.Y, box.MinEdge.Y, extent.Y));
+		putU16(out+4, binarymesh::quantize(pos.Z, box.MinEdge.Z, extent.Z));
+	}
+
+	out = grow(vertexCount*4);
+	for (u32 i=0; i<vertexCount; ++i, out+=4)
+	{
+		u16 u, v;
+		binarymesh::encodeDirection(staticNormals ? (*staticNormals)[i] : vertexAt(vertices, pitch, i).Normal, u, v);
+		putU16(out, u);
+		putU16(out+2, v);
+	}
+
+	out = grow(vertexCount*4);
+	for (u32 i=0; i<vertexCount; ++i, out+=4)
+		putU32(out, vertexAt(vertices, pitch, i).Color.color);
+
+	for (u32 t=0; t<texCoordSets; ++t)
+	{
+		out = grow(vertexCount*4);
+		for (u32 i=0; i<vertexCount; ++i, out+=4)
+		{
+			const core::vector2df& tc = (t == 0) ? vertexAt(vertices, pitch, i).TCoords :
+				((const video::S3DVertex2TCoords*)(vertices + i*pitch))->TCoords2;
+			putU16(out, binarymesh::quantize(tc.X, texCoordRange[t].UpperLeftCorner.X, texCoordRange[t].getWidth()));
+			putU16(out+2, binarymesh::quantize(tc.Y, texCoordRange[t].UpperLeftCorner.Y, texCoordRange[t].getHeight()));
+		}
+	}
+
+	if (vertexType == video::EVT_TANGENTS)
+	{
+		out = grow(vertexCount*8);
+		for (u32 i=0; i<vertexCount; ++i, out+=4)
+		{
+			const video::S3DVertexTangents& vtx = *(const video::S3DVertexTangents*)(vertices + i*pitch);
+			u16 u, v;
+			binarymesh::encodeDirection(vtx.Tangent, u, v);
+			putU16(out, u);
+			putU16(out+2, v);
+			binarymesh::encodeDirection(vtx.Binormal, u, v);
+			putU16(out+vertexCount*4, u);
+			putU16(out+vertexCount*4+2, v);
+		}
+	}
+
+	// indices as difference to the previous index
+
+	const u16* indices16 = buffer->getIndices();
+	const u32* indices32 = (const u32*)buffer->getIndices();
+	const bool is32Bit = (buffer->getIndexType() == video::EIT_32BIT);
+	u32 last = 0;
+	for (u32 i=0; i<indexCount; ++i)
+	{
+		const u32 index = is32Bit ? indices32[i] : indices16[i];
+		const s32 delta = (s32)(index - last);
+		writeVarInt(((u32)delta << 1) ^ (u32)(delta >> 31));
+		last = index;
+	}
+}
+
+
+void CIrrBinaryMeshWriter::writeMaterial(const video::SMaterial& material)
+{
+	const c8* typeName = VideoDriver ? VideoDriver->getMaterialRendererName(material.MaterialType) : 0;
+	writeString(typeName ? typeName : "");
+
+	writeU32(material.AmbientColor.color);
+	writeU32(material.DiffuseColor.color);
+	writeU32(material.EmissiveColor.color);
+	writeU32(material.SpecularColor.color);
+	writeF32(material.Shininess);
+	writeF32(material.MaterialTypeParam);
+	writeF32(material.MaterialTypeParam2);
+	writeF32(material.Thickness);
+
+	writeU8(material.ZBuffer);
+	writeU8(material.AntiAliasing);
+	writeU8(material.ColorMask);
+	writeU8(material.ColorMaterial);
+	writeU8((u8)material.BlendOperation);
+	writeU8(material.PolygonOffsetFactor);
+	writeU8((u8)material.PolygonOffsetDirection);
+
+	u16 flags = 0;
+	flags |= material.Wireframe ? 0x1 : 0;
+	flags |= material.PointCloud ? 0x2 : 0;
+	flags |= material.GouraudShading ? 0x4 : 0;
+	flags |= material.Lighting ? 0x8 : 0;
+	flags |= material.ZWriteEnable ? 0x10 : 0;
+	flags |= material.BackfaceCulling ? 0x20 : 0;
+	flags |= material.FrontfaceCulling ? 0x40 : 0;
+	flags |= material.FogEnable ? 0x80 : 0;
+	flags |= material.NormalizeNormals ? 0x100 : 0;
+	flags |= material.UseMipMaps ? 0x200 : 0;
+	writeU16(flags);
+
+	writeU8(video::MATERIAL_MAX_TEXTURES);
+	for (u32 i=0; i<video::MATERIAL_MAX_TEXTURES; ++i)
+	{
+		const video::SMaterialLayer& layer = material.TextureLayer[i];
+
+		// names of textures which are files are stored relative to the mesh,
+		// others like lightmaps created by loaders keep their name
+		io::path textureName;
+		if (layer.Texture)
+		{
+			textureName = layer.Texture->getName().getPath();
+			if (FileSystem->existFile(textureName))
+				textureName = FileSystem->getRelativeFilename(textureName, MeshDir);
+		}
+		writeString(core::stringc(textureName));
+
+		const bool hasMatrix = !material.getTextureMatrix(i).isIdentity();
+		u8 layerFlags = 0;
+		layerFlags |= layer.BilinearFilter ? binarymesh::EIBMLF_BILINEAR : 0;
+		layerFlags |= layer.TrilinearFilter ? binarymesh::EIBMLF_TRILINEAR : 0;
+		layerFlags |= hasMatrix ? binarymesh::EIBMLF_TEXTURE_MATRIX : 0;
+
+		writeU8((u8)(layer.TextureWrapU | (layer.TextureWrapV << 4)));
+		writeU8(layerFlags);
+		writeU8(layer.AnisotropicFilter);
+		writeU8((u8)layer.LODBias);
+		if (hasMatrix)
+			writeMatrix(material.getTextureMatrix(i));
+	}
+}
+
+
+void CIrrBinaryMeshWriter::writeJoints(const ISkinnedMesh* mesh)
+{
+	const core::array<ISkinnedMesh::SJoint*>& joints = mesh->getAllJoints();
+
+	writeF32(mesh->getAnimationSpeed());
+	writeVarInt(joints.size());
+
+	for (u32 i=0; i<joints.size(); ++i)
+	{
+		const ISkinnedMesh::SJoint* joint = joints[i];
+
+		writeString(joint->Name);
+		writeMatrix(joint->LocalMatrix);
+		writeMatrix(joint->GlobalInversedMatrix);
+
+		u32 j;
+		writeVarInt(joint->Children.size());
+		for (j=0; j<joint->Children.size(); ++j)
+			writeVarInt((u32)joints.linear_search(joint->Children[j]));
+
+		writeVarInt(joint->AttachedMeshes.size());
+		for (j=0; j<joint->AttachedMeshes.size(); ++j)
+			writeVarInt(joint->AttachedMeshes[j]);
+
+		writeVarInt(joint->PositionKeys.size());
+		for (j=0; j<joint->PositionKeys.size(); ++j)
+		{
+			writeF32(joint->PositionKeys[j].frame);
+			writeVector(joint->PositionKeys[j].position);
+		}
+
+		writeVarInt(joint->ScaleKeys.size());
+		for (j=0; j<joint->ScaleKeys.size(); ++j)
+		{
+			writeF32(joint->ScaleKeys[j].frame);
+			writeVector(joint->ScaleKeys[j].scale);
+		}
+
+		writeVarInt(joint->RotationKeys.size());
+		for (j=0; j<joint->RotationKeys.size(); ++j)
+		{
+			const core::quaternion& rotation = joint->RotationKeys[j].rotation;
+			writeF32(joint->RotationKeys[j].frame);
+			writeF32(rotation.X);
+			writeF32(rotation.Y);
+			writeF32(rotation.Z);
+			writeF32(rotation.W);
+		}
+
+		writeVarInt(joint->Weights.size());
+		for (j=0; j<joint->Weights.size(); ++j)
+		{
+			writeVarInt(joint->Weights[j].buffer_id);
+			writeVarInt(joint->Weights[j].vertex_id);
+			writeF32(joint->Weights[j].strength);
+		}
+	}
+}
+
+
+u8* CIrrBinaryMeshWriter::grow(u32 n)
+{
+	const u32 size = Data.size();
+	if (Data.allocated_size() < size+n)
+		Data.reallocate((size+n)*2);
+	Data.set_used(size+n);
+	return Data.pointer() + size;
+}
+
+
+void CIrrBinaryMeshWriter::writeU8(u8 value)
+{
+	*grow(1) = value;
+}
+
+
+void CIrrBinaryMeshWriter::writeU16(u16 value)
+{
+	putU16(grow(2), value);
+}
+
+
+void CIrrBinaryMeshWriter::writeU32(u32 value)
+{
+	putU32(grow(4), value);
+}
+
+
+void CIrrBinaryMeshWriter::writeF32(f32 value)
+{
+	writeU32(IR(value));
+}
+
+
+void CIrrBinaryMeshWriter::writeVarInt(u32 value)
+{
+	while (value >= 0x80)
+	{
+		writeU8((u8)(value | 0x80));
+		value >>= 7;
+	}
+	writeU8((u8)value);
+}
+
+
+void CIrrBinaryMeshWriter::writeString(const core::stringc& str)
+{
+	writeVarInt(str.size());
+	if (str.size())
+		memcpy(grow(str.size()), str.c_str(), str.size());
+}
+
+
+void CIrrBinaryMeshWriter::writeVector(const core::vector3df& v)
+{
+	writeF32(v.X);
+	writeF32(v.Y);
+	writeF32(v.Z);
+}
+
+
+void CIrrBinaryMeshWriter::writeMatrix(const core::matrix4& m)
+{
+	for (u32 i=0; i<16; ++i)
+		writeF32(m[i]);
+}
+
+
+} // end namespace
+} // end namespace
+
+#endif
+
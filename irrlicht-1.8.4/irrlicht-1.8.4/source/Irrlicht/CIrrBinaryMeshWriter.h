@@ -0,0 +1,81 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __IRR_IRR_BINARY_MESH_WRITER_H_INCLUDED__
+#define __IRR_IRR_BINARY_MESH_WRITER_H_INCLUDED__
+
+#include "IMeshWriter.h"
+#include "IVideoDriver.h"
+#include "IFileSystem.h"
+#include "ISkinnedMesh.h"
+
+namespace irr
+{
+namespace scene
+{
+	class IMeshBuffer;
+
+
+	//! class to write meshes, implementing a binary IrrMesh (.irrbmesh) writer
+	/** Vertices are quantized and indices delta coded, see IrrBinaryMeshFormat.h.
+	With EMWF_WRITE_COMPRESSED, the data is compressed with zlib in addition.
+	writeAnimatedMesh() also writes the joints and animation of skinned meshes. */
+	class CIrrBinaryMeshWriter : public IMeshWriter
+	{
+	public:
+
+		CIrrBinaryMeshWriter(video::IVideoDriver* driver, io::IFileSystem* fs);
+		virtual ~CIrrBinaryMeshWriter();
+
+		//! Returns the type of the mesh writer
+		virtual EMESH_WRITER_TYPE getType() const;
+
+		//! writes a mesh
+		virtual bool writeMesh(io::IWriteFile* file, scene::IMesh* mesh, s32 flags=EMWF_NONE);
+
+		//! writes an animated mesh, with joints and animation if it is skinned
+		virtual bool writeAnimatedMesh(io::IWriteFile* file, scene::IAnimatedMesh* mesh, s32 flags=EMWF_NONE);
+
+	protected:
+
+		bool writeFile(io::IWriteFile* file, scene::IMesh* mesh, ISkinnedMesh* skinnedMesh, s32 flags);
+
+		//! writes a buffer, with the vertex positions and normals of skinned meshes before skinning
+		void writeMeshBuffer(const scene::IMeshBuffer* buffer,
+			const core::array<core::vector3df>* staticPositions,
+			const core::array<core::vector3df>* staticNormals);
+
+		void writeMaterial(const video::SMaterial& material);
+
+		void writeJoints(const ISkinnedMesh* mesh);
+
+		// appends n bytes to the data and returns them
+		u8* grow(u32 n);
+
+		void writeU8(u8 value);
+		void writeU16(u16 value);
+		void writeU32(u32 value);
+		void writeF32(f32 value);
+		void writeVarInt(u32 value);
+		void writeString(const core::stringc& str);
+		void writeVector(const core::vector3df& v);
+		void writeMatrix(const core::matrix4& m);
+
+		// member variables:
+
+		io::IFileSystem* FileSystem;
+		video::IVideoDriver* VideoDriver;
+
+		//! the mesh data as written to the file, before compression
+		core::array<u8> Data;
+
+		//! directory of the written file, texture names are stored relative to it
+		io::path MeshDir;
+	};
+
+} // end namespace
+} // end namespace
+
+#endif
+
@@ -13,6 +13,7 @@
 #include "CLogger.h"
 #include "irrString.h"
 #include "IRandomizer.h"
+#include "CThreadPool.h"
 
 namespace irr
 {
@@ -41,6 +42,8 @@ CIrrDeviceStub::CIrrDeviceStub(const SIrrlichtCreationParameters& params)
 	os::Printer::Logger = Logger;
 	Randomizer = createDefaultRandomizer();
 
+	CThreadPool::grabSharedPool();
+
 	FileSystem = io::createFileSystem();
 	VideoModeList = new video::CVideoModeList();
 
@@ -78,6 +81,8 @@ CIrrDeviceStub::~CIrrDeviceStub()
 	if (Randomizer)
 		Randomizer->drop();
 
+	CThreadPool::dropSharedPool();
+
 	CursorControl = 0;
 
 	if (Timer)
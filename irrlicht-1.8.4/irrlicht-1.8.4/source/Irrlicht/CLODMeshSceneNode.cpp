@@ -0,0 +1,557 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CLODMeshSceneNode.h"
+#include "IVideoDriver.h"
+#include "ISceneManager.h"
+#include "ICameraSceneNode.h"
+#include "IMeshCache.h"
+#include "IMeshManipulator.h"
+#include "IAnimatedMesh.h"
+#include "IMaterialRenderer.h"
+#include "IFileSystem.h"
+#include "SAnimatedMesh.h"
+#include "CShadowVolumeSceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+
+
+//! constructor
+CLODMeshSceneNode::CLODMeshSceneNode(IMesh* mesh, u32 levelCount, f32 reduction,
+			ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position, const core::vector3df& rotation,
+			const core::vector3df& scale)
+: ILODMeshSceneNode(parent, mgr, id, position, rotation, scale), Shadow(0),
+	LevelCount(levelCount), Reduction(reduction), LODScreenSize(256.f),
+	ScreenSize(0.f), ForcedLOD(-1), CurrentLOD(0), PassCount(0), ReadOnlyMaterials(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CLODMeshSceneNode");
+	#endif
+
+	setMesh(mesh);
+}
+
+
+//! destructor
+CLODMeshSceneNode::~CLODMeshSceneNode()
+{
+	if (Shadow)
+		Shadow->drop();
+	for (u32 i=0; i<Levels.size(); ++i)
+		Levels[i]->drop();
+}
+
+
+//! frame
+void CLODMeshSceneNode::OnRegisterSceneNode()
+{
+	if (IsVisible)
+	{
+		updateLOD();
+
+		// register for the solid and the transparent pass as needed,
+		// all levels share the materials of the first one
+		video::IVideoDriver* driver = SceneManager->getVideoDriver();
+		IMesh* mesh = getLODMesh(0);
+
+		PassCount = 0;
+		int transparentCount = 0;
+		int solidCount = 0;
+
+		const u32 count = (ReadOnlyMaterials && mesh) ? mesh->getMeshBufferCount() : Materials.size();
+		for (u32 i=0; i<count; ++i)
+		{
+			const video::SMaterial& material = (ReadOnlyMaterials && mesh) ?
+				mesh->getMeshBuffer(i)->getMaterial() : Materials[i];
+			video::IMaterialRenderer* rnd = driver->getMaterialRenderer(material.MaterialType);
+
+			if (rnd && rnd->isTransparent())
+				++transparentCount;
+			else
+				++solidCount;
+
+			if (solidCount && transparentCount)
+				break;
+		}
+
+		if (solidCount)
+			SceneManager->registerNodeForRendering(this, scene::ESNRP_SOLID);
+
+		if (transparentCount)
+			SceneManager->registerNodeForRendering(this, scene::ESNRP_TRANSPARENT);
+
+		ISceneNode::OnRegisterSceneNode();
+	}
+}
+
+
+//! chooses the level of detail from the size on screen
+void CLODMeshSceneNode::updateLOD()
+{
+	CurrentLOD = 0;
+	ScreenSize = 0.f;
+
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	if (Levels.empty() || !camera)
+		return;
+
+	// diameter of the bounding sphere in pixels
+	const core::aabbox3d<f32> box = getTransformedBoundingBox();
+	const f32 radius = box.getExtent().getLength() * 0.5f;
+	const f32 scale = camera->getProjectionMatrix()[5] *
+		(f32)SceneManager->getVideoDriver()->getCurrentRenderTargetSize().Height;
+
+	if (camera->isOrthogonal())
+		ScreenSize = radius * scale;
+	else
+	{
+		const f32 distance = box.getCenter().getDistanceFrom(camera->getAbsolutePosition());
+		ScreenSize = distance > radius ? radius * scale / distance : FLT_MAX;
+	}
+
+	if (ForcedLOD >= 0)
+	{
+		CurrentLOD = core::min_((u32)ForcedLOD, Levels.size()-1);
+		return;
+	}
+
+	f32 size = LODScreenSize * 0.5f;
+	while (ScreenSize < size && CurrentLOD+1 < Levels.size())
+	{
+		++CurrentLOD;
+		size *= 0.5f;
+	}
+}
+
+
+//! renders the node.
+void CLODMeshSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	IMesh* mesh = getLODMesh(CurrentLOD);
+
+	if (!mesh || !driver)
+		return;
+
+	bool isTransparentPass =
+		SceneManager->getSceneNodeRenderPass() == scene::ESNRP_TRANSPARENT;
+
+	++PassCount;
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+	Box = Levels[0]->getBoundingBox();
+
+	if (Shadow && PassCount==1)
+		Shadow->updateShadowVolumes();
+
+	// for debug purposes only:
+
+	bool renderMeshes = true;
+	video::SMaterial mat;
+	if (DebugDataVisible && PassCount==1)
+	{
+		// overwrite half transparency
+		if (DebugDataVisible & scene::EDS_HALF_TRANSPARENCY)
+		{
+			for (u32 g=0; g<mesh->getMeshBufferCount(); ++g)
+			{
+				mat = Materials[g];
+				mat.MaterialType = video::EMT_TRANSPARENT_ADD_COLOR;
+				driver->setMaterial(mat);
+				driver->drawMeshBuffer(mesh->getMeshBuffer(g));
+			}
+			renderMeshes = false;
+		}
+	}
+
+	// render the current level
+	if (renderMeshes)
+	{
+		const u32 count = core::min_(mesh->getMeshBufferCount(), Materials.size());
+		for (u32 i=0; i<count; ++i)
+		{
+			scene::IMeshBuffer* mb = mesh->getMeshBuffer(i);
+			if (mb && mb->getIndexCount())
+			{
+				const video::SMaterial& material = ReadOnlyMaterials ? mb->getMaterial() : Materials[i];
+
+				video::IMaterialRenderer* rnd = driver->getMaterialRenderer(material.MaterialType);
+				bool transparent = (rnd && rnd->isTransparent());
+
+				// only render transparent buffer if this is the transparent render pass
+				// and solid only in solid pass
+				if (transparent == isTransparentPass)
+				{
+					driver->setMaterial(material);
+					driver->drawMeshBuffer(mb);
+				}
+			}
+		}
+	}
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+	// for debug purposes only:
+	if (DebugDataVisible && PassCount==1)
+	{
+		video::SMaterial m;
+		m.Lighting = false;
+		m.AntiAliasing=0;
+		driver->setMaterial(m);
+
+		if (DebugDataVisible & scene::EDS_BBOX)
+		{
+			driver->draw3DBox(Box, video::SColor(255,255,255,255));
+		}
+		if (DebugDataVisible & scene::EDS_BBOX_BUFFERS)
+		{
+			for (u32 g=0; g<mesh->getMeshBufferCount(); ++g)
+			{
+				driver->draw3DBox(
+					mesh->getMeshBuffer(g)->getBoundingBox(),
+					video::SColor(255,190,128,128));
+			}
+		}
+
+		if (DebugDataVisible & scene::EDS_NORMALS)
+		{
+			// draw normals
+			const f32 debugNormalLength = SceneManager->getParameters()->getAttributeAsFloat(DEBUG_NORMAL_LENGTH);
+			const video::SColor debugNormalColor = SceneManager->getParameters()->getAttributeAsColor(DEBUG_NORMAL_COLOR);
+			const u32 count = mesh->getMeshBufferCount();
+
+			for (u32 i=0; i != count; ++i)
+			{
+				driver->drawMeshBufferNormals(mesh->getMeshBuffer(i), debugNormalLength, debugNormalColor);
+			}
+		}
+
+		// show mesh
+		if (DebugDataVisible & scene::EDS_MESH_WIRE_OVERLAY)
+		{
+			m.Wireframe = true;
+			driver->setMaterial(m);
+
+			for (u32 g=0; g<mesh->getMeshBufferCount(); ++g)
+			{
+				driver->drawMeshBuffer(mesh->getMeshBuffer(g));
+			}
+		}
+	}
+}
+
+
+//! Removes a child from this scene node.
+bool CLODMeshSceneNode::removeChild(ISceneNode* child)
+{
+	if (child && Shadow == child)
+	{
+		Shadow->drop();
+		Shadow = 0;
+	}
+
+	return ISceneNode::removeChild(child);
+}
+
+
+//! returns the axis aligned bounding box of this node
+const core::aabbox3d<f32>& CLODMeshSceneNode::getBoundingBox() const
+{
+	return Levels.size() ? Levels[0]->getBoundingBox() : Box;
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CLODMeshSceneNode::getMaterial(u32 i)
+{
+	IMesh* mesh = getLODMesh(0);
+	if (mesh && ReadOnlyMaterials && i<mesh->getMeshBufferCount())
+	{
+		ReadOnlyMaterial = mesh->getMeshBuffer(i)->getMaterial();
+		return ReadOnlyMaterial;
+	}
+
+	if (i >= Materials.size())
+		return ISceneNode::getMaterial(i);
+
+	return Materials[i];
+}
+
+
+//! returns amount of materials used by this scene node.
+u32 CLODMeshSceneNode::getMaterialCount() const
+{
+	if (Levels.size() && ReadOnlyMaterials)
+		return Levels[0]->getMeshBufferCount();
+
+	return Materials.size();
+}
+
+
+//! Sets a new mesh and creates its levels of detail
+void CLODMeshSceneNode::setMesh(IMesh* mesh)
+{
+	if (!mesh)
+		return;
+
+	core::array<IMesh*> lods;
+	createLODChain(SceneManager, mesh, LevelCount, Reduction, lods);
+	setLODMeshes(lods);
+
+	for (u32 i=0; i<lods.size(); ++i)
+		lods[i]->drop();
+}
+
+
+//! Replaces all levels of detail
+void CLODMeshSceneNode::setLODMeshes(const core::array<IMesh*>& lods)
+{
+	for (u32 i=0; i<lods.size(); ++i)
+		lods[i]->grab();
+	for (u32 i=0; i<Levels.size(); ++i)
+		Levels[i]->drop();
+
+	Levels = lods;
+	LevelCount = core::max_(LevelCount, Levels.size());
+
+	TriangleCounts.set_used(Levels.size());
+	for (u32 i=0; i<Levels.size(); ++i)
+	{
+		u32 triangles = 0;
+		for (u32 b=0; b<Levels[i]->getMeshBufferCount(); ++b)
+			triangles += Levels[i]->getMeshBuffer(b)->getIndexCount() / 3;
+		TriangleCounts[i] = triangles;
+	}
+
+	if (CurrentLOD >= Levels.size())
+		CurrentLOD = 0;
+
+	copyMaterials();
+}
+
+
+//! Get the mesh of a level of detail
+IMesh* CLODMeshSceneNode::getLODMesh(u32 level) const
+{
+	return level < Levels.size() ? Levels[level] : 0;
+}
+
+
+//! Get the amount of triangles of a level of detail
+u32 CLODMeshSceneNode::getLODTriangleCount(u32 level) const
+{
+	return level < TriangleCounts.size() ? TriangleCounts[level] : 0;
+}
+
+
+//! Set the level of detail used in the current frame
+void CLODMeshSceneNode::setCurrentLOD(u32 level)
+{
+	if (level < Levels.size())
+		CurrentLOD = level;
+}
+
+
+//! Creates the levels of detail of a mesh
+void CLODMeshSceneNode::createLODChain(ISceneManager* smgr, IMesh* mesh,
+		u32 levelCount, f32 reduction, core::array<IMesh*>& lods)
+{
+	lods.clear();
+	if (!mesh)
+		return;
+
+	mesh->grab();
+	lods.push_back(mesh);
+
+	IMeshCache* cache = smgr->getMeshCache();
+	const io::path& name = cache->getMeshName(mesh).getPath();
+
+	while (lods.size() < levelCount)
+	{
+		io::path lodName;
+		if (name.size())
+		{
+			lodName = name;
+			lodName += "#lod";
+			lodName += (u32)(reduction * 1000.f);
+			lodName += "_";
+			lodName += lods.size();
+		}
+
+		IAnimatedMesh* cached = lodName.size() ? cache->getMeshByName(lodName) : 0;
+		if (cached && cached->getMesh(0))
+		{
+			lods.push_back(cached->getMesh(0));
+			lods.getLast()->grab();
+			continue;
+		}
+
+		core::array<IMesh*> step;
+		const u32 created = smgr->getMeshManipulator()->createMeshLODChain(lods.getLast(), step, 2, reduction);
+		// step[0] is the previous level, grabbed once more by the chain
+		for (u32 i=0; i<created; ++i)
+		{
+			if (i != 1)
+				step[i]->drop();
+		}
+
+		// no further simplification possible
+		if (created < 2)
+			break;
+
+		lods.push_back(step[1]);
+
+		if (lodName.size())
+		{
+			SAnimatedMesh* animatedMesh = new SAnimatedMesh(step[1]);
+			cache->addMesh(lodName, animatedMesh);
+			animatedMesh->drop();
+		}
+	}
+}
+
+
+//! Creates shadow volume scene node as child of this node
+//! and returns a pointer to it.
+IShadowVolumeSceneNode* CLODMeshSceneNode::addShadowVolumeSceneNode(
+		const IMesh* shadowMesh, s32 id, bool zfailmethod, f32 infinity)
+{
+	if (!SceneManager->getVideoDriver()->queryFeature(video::EVDF_STENCIL_BUFFER))
+		return 0;
+
+	if (!shadowMesh)
+		shadowMesh = getLODMesh(0); // if null is given, use the most detailed mesh of node
+
+	if (Shadow)
+		Shadow->drop();
+
+	Shadow = new CShadowVolumeSceneNode(shadowMesh, this, SceneManager, id,  zfailmethod, infinity);
+	return Shadow;
+}
+
+
+void CLODMeshSceneNode::copyMaterials()
+{
+	Materials.clear();
+
+	IMesh* mesh = getLODMesh(0);
+	if (mesh)
+	{
+		video::SMaterial mat;
+
+		for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+		{
+			IMeshBuffer* mb = mesh->getMeshBuffer(i);
+			if (mb)
+				mat = mb->getMaterial();
+
+			Materials.push_back(mat);
+		}
+	}
+}
+
+
+//! Writes attributes of the scene node.
+void CLODMeshSceneNode::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
+{
+	ILODMeshSceneNode::serializeAttributes(out, options);
+
+	const IMesh* mesh = getLODMesh(0);
+	if (options && (options->Flags&io::EARWF_USE_RELATIVE_PATHS) && options->Filename)
+	{
+		const io::path path = SceneManager->getFileSystem()->getRelativeFilename(
+				SceneManager->getFileSystem()->getAbsolutePath(SceneManager->getMeshCache()->getMeshName(mesh).getPath()),
+				options->Filename);
+		out->addString("Mesh", path.c_str());
+	}
+	else
+		out->addString("Mesh", SceneManager->getMeshCache()->getMeshName(mesh).getPath().c_str());
+	out->addBool("ReadOnlyMaterials", ReadOnlyMaterials);
+	out->addInt("LODLevels", LevelCount);
+	out->addFloat("LODReduction", Reduction);
+	out->addFloat("LODScreenSize", LODScreenSize);
+	out->addInt("ForcedLOD", ForcedLOD);
+}
+
+
+//! Reads attributes of the scene node.
+void CLODMeshSceneNode::deserializeAttributes(io::IAttributes* in, io::SAttributeReadWriteOptions* options)
+{
+	io::path oldMeshStr = SceneManager->getMeshCache()->getMeshName(getLODMesh(0));
+	io::path newMeshStr = in->getAttributeAsString("Mesh");
+	ReadOnlyMaterials = in->getAttributeAsBool("ReadOnlyMaterials");
+
+	const u32 oldLevelCount = LevelCount;
+	const f32 oldReduction = Reduction;
+	if (in->existsAttribute("LODLevels"))
+		LevelCount = core::max_(in->getAttributeAsInt("LODLevels"), 1);
+	if (in->existsAttribute("LODReduction"))
+		Reduction = in->getAttributeAsFloat("LODReduction");
+	if (in->existsAttribute("LODScreenSize"))
+		LODScreenSize = in->getAttributeAsFloat("LODScreenSize");
+	if (in->existsAttribute("ForcedLOD"))
+		ForcedLOD = in->getAttributeAsInt("ForcedLOD");
+
+	if (newMeshStr != "" && oldMeshStr != newMeshStr)
+	{
+		IAnimatedMesh* newAnimatedMesh = SceneManager->getMesh(newMeshStr.c_str());
+
+		if (newAnimatedMesh && newAnimatedMesh->getMesh(0))
+			setMesh(newAnimatedMesh->getMesh(0));
+	}
+	else if (Levels.size() && (LevelCount != oldLevelCount || Reduction != oldReduction))
+		setMesh(Levels[0]);
+
+	ILODMeshSceneNode::deserializeAttributes(in, options);
+}
+
+
+//! Sets if the scene node should not copy the materials of the mesh but use them in a read only style.
+void CLODMeshSceneNode::setReadOnlyMaterials(bool readonly)
+{
+	ReadOnlyMaterials = readonly;
+}
+
+
+//! Returns if the scene node should not copy the materials of the mesh but use them in a read only style
+bool CLODMeshSceneNode::isReadOnlyMaterials() const
+{
+	return ReadOnlyMaterials;
+}
+
+
+//! Creates a clone of this scene node and its children.
+ISceneNode* CLODMeshSceneNode::clone(ISceneNode* newParent, ISceneManager* newManager)
+{
+	if (!newParent)
+		newParent = Parent;
+	if (!newManager)
+		newManager = SceneManager;
+
+	CLODMeshSceneNode* nb = new CLODMeshSceneNode(0, LevelCount, Reduction, newParent,
+		newManager, ID, RelativeTranslation, RelativeRotation, RelativeScale);
+
+	nb->cloneMembers(this, newManager);
+	nb->setLODMeshes(Levels);
+	nb->ReadOnlyMaterials = ReadOnlyMaterials;
+	nb->Materials = Materials;
+	nb->LODScreenSize = LODScreenSize;
+	nb->ForcedLOD = ForcedLOD;
+	nb->Shadow = Shadow;
+	if ( nb->Shadow )
+		nb->Shadow->grab();
+
+	if (newParent)
+		nb->drop();
+	return nb;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,146 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_LOD_MESH_SCENE_NODE_H_INCLUDED__
+#define __C_LOD_MESH_SCENE_NODE_H_INCLUDED__
+
+#include "ILODMeshSceneNode.h"
+#include "IMesh.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	class CLODMeshSceneNode : public ILODMeshSceneNode
+	{
+	public:
+
+		//! constructor
+		CLODMeshSceneNode(IMesh* mesh, u32 levelCount, f32 reduction,
+			ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f));
+
+		//! destructor
+		virtual ~CLODMeshSceneNode();
+
+		//! frame
+		virtual void OnRegisterSceneNode();
+
+		//! renders the node.
+		virtual void render();
+
+		//! returns the axis aligned bounding box of this node
+		virtual const core::aabbox3d<f32>& getBoundingBox() const;
+
+		//! returns the material based on the zero based index i.
+		virtual video::SMaterial& getMaterial(u32 i);
+
+		//! returns amount of materials used by this scene node.
+		virtual u32 getMaterialCount() const;
+
+		//! Writes attributes of the scene node.
+		virtual void serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options=0) const;
+
+		//! Reads attributes of the scene node.
+		virtual void deserializeAttributes(io::IAttributes* in, io::SAttributeReadWriteOptions* options=0);
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const { return ESNT_LOD_MESH; }
+
+		//! Sets a new mesh and creates its levels of detail
+		virtual void setMesh(IMesh* mesh);
+
+		//! Returns the most detailed mesh
+		virtual IMesh* getMesh(void) { return getLODMesh(0); }
+
+		//! Creates shadow volume scene node as child of this node
+		//! and returns a pointer to it.
+		virtual IShadowVolumeSceneNode* addShadowVolumeSceneNode(const IMesh* shadowMesh,
+			s32 id, bool zfailmethod=true, f32 infinity=10000.0f);
+
+		//! Sets if the scene node should not copy the materials of the mesh but use them in a read only style.
+		virtual void setReadOnlyMaterials(bool readonly);
+
+		//! Returns if the scene node should not copy the materials of the mesh but use them in a read only style
+		virtual bool isReadOnlyMaterials() const;
+
+		//! Creates a clone of this scene node and its children.
+		virtual ISceneNode* clone(ISceneNode* newParent=0, ISceneManager* newManager=0);
+
+		//! Removes a child from this scene node.
+		virtual bool removeChild(ISceneNode* child);
+
+		//! Replaces all levels of detail
+		virtual void setLODMeshes(const core::array<IMesh*>& lods);
+
+		//! Get the amount of levels of detail
+		virtual u32 getLODCount() const { return Levels.size(); }
+
+		//! Get the mesh of a level of detail
+		virtual IMesh* getLODMesh(u32 level) const;
+
+		//! Get the amount of triangles of a level of detail
+		virtual u32 getLODTriangleCount(u32 level) const;
+
+		//! Set the size on screen down to which the full detail is shown
+		virtual void setLODScreenSize(f32 pixels) { LODScreenSize = pixels; }
+
+		//! Get the size on screen down to which the full detail is shown
+		virtual f32 getLODScreenSize() const { return LODScreenSize; }
+
+		//! Forces a level of detail
+		virtual void setForcedLOD(s32 level) { ForcedLOD = level; }
+
+		//! Get the forced level of detail
+		virtual s32 getForcedLOD() const { return ForcedLOD; }
+
+		//! Get the size of the node on the screen in pixels
+		virtual f32 getScreenSize() const { return ScreenSize; }
+
+		//! Get the level of detail used in the current frame
+		virtual u32 getCurrentLOD() const { return CurrentLOD; }
+
+		//! Set the level of detail used in the current frame
+		virtual void setCurrentLOD(u32 level);
+
+		//! Creates the levels of detail of a mesh
+		/** Levels of meshes in the mesh cache are stored in the cache as
+		well, so nodes showing the same mesh share them.
+		\param lods Receives the grabbed levels, starting with mesh. */
+		static void createLODChain(ISceneManager* smgr, IMesh* mesh,
+			u32 levelCount, f32 reduction, core::array<IMesh*>& lods);
+
+	private:
+
+		void copyMaterials();
+		void updateLOD();
+
+		core::array<IMesh*> Levels;
+		core::array<u32> TriangleCounts;
+
+		core::array<video::SMaterial> Materials;
+		core::aabbox3d<f32> Box;
+		video::SMaterial ReadOnlyMaterial;
+
+		IShadowVolumeSceneNode* Shadow;
+
+		u32 LevelCount;
+		f32 Reduction;
+		f32 LODScreenSize;
+		f32 ScreenSize;
+		s32 ForcedLOD;
+		u32 CurrentLOD;
+
+		s32 PassCount;
+		bool ReadOnlyMaterials;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -32,6 +32,9 @@ public:
 	//! See IReferenceCounted::drop() for more information.
 	virtual IAnimatedMesh* createMesh(io::IReadFile* file);
 
+	//! the loader keeps no state, so meshes can be loaded on worker threads
+	virtual bool isThreadSafe() const { return true; }
+
 private:
 	//! Loads the file data into the mesh
 	bool loadFile(io::IReadFile* file, CAnimatedMeshMD2* mesh);
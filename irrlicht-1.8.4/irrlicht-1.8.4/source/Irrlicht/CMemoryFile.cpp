@@ -72,14 +72,14 @@ bool CMemoryFile::seek(long finalPos, bool relativeMovement)
 {
 	if (relativeMovement)
 	{
-		if (Pos + finalPos > Len)
+		if (Pos + finalPos > Len || Pos + finalPos < 0)
 			return false;
 
 		Pos += finalPos;
 	}
 	else
 	{
-		if (finalPos > Len)
+		if (finalPos > Len || finalPos < 0)
 			return false;
 
 		Pos = finalPos;
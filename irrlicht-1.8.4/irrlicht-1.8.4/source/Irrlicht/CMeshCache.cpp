@@ -82,8 +82,18 @@ IAnimatedMesh* CMeshCache::getMeshByIndex(u32 number)
 //! Returns a mesh based on its name.
 IAnimatedMesh* CMeshCache::getMeshByName(const io::path& name)
 {
-	MeshEntry e ( name );
-	s32 id = Meshes.binary_search(e);
+	return getMeshByName(name.c_str());
+}
+
+
+//! Returns a mesh based on its name, without creating a path.
+IAnimatedMesh* CMeshCache::getMeshByName(const fschar_t* name)
+{
+	if (!name)
+		return 0;
+
+	Meshes.sort();
+	s32 id = Meshes.binary_search_key(name, MeshEntry::compareName);
 	return (id != -1) ? Meshes[id].Mesh : 0;
 }
 
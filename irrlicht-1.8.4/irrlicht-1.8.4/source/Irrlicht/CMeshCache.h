@@ -57,6 +57,9 @@ namespace scene
 		\return Pointer to the mesh or 0 if there is none with this number. */
 		virtual IAnimatedMesh* getMeshByName(const io::path& name);
 
+		//! Returns a mesh based on its name, without creating a path.
+		virtual IAnimatedMesh* getMeshByName(const fschar_t* name);
+
 		//! Get the name of a loaded mesh, based on its index.
 		/** \param index: Index of the mesh, number between 0 and getMeshCount()-1.
 		\return The name if mesh was found and has a name, else	the path is empty. */
@@ -109,6 +112,12 @@ namespace scene
 			{
 				return (NamedPath < other.NamedPath);
 			}
+
+			//! compares the name with a searched path, for binary_search_key
+			static s32 compareName(const MeshEntry& entry, const fschar_t* name)
+			{
+				return entry.NamedPath.compareName(name);
+			}
 		};
 
 		//! loaded meshes
@@ -5,8 +5,10 @@
 #include "CMeshManipulator.h"
 #include "SMesh.h"
 #include "CMeshBuffer.h"
+#include "CDynamicMeshBuffer.h"
 #include "SAnimatedMesh.h"
 #include "os.h"
+#include "CThreadPool.h"
 #include "irrMap.h"
 
 namespace irr
@@ -74,52 +76,211 @@ void CMeshManipulator::flipSurfaces(scene::IMesh* mesh) const
 
 namespace
 {
+
+//! amount of triangles from which normal and tangent calculation is spread over threads
+const u32 NORMALS_PARALLEL_TRIANGLES = 8192;
+
+//! Vertices are accessed by pitch, all vertex types start with S3DVertex
+inline video::S3DVertex& getVertex(u8* vertices, u32 pitch, u32 i)
+{
+	return *reinterpret_cast<video::S3DVertex*>(vertices + i*pitch);
+}
+
+//! Hash of the exact bits of a position, 0 and -0 are treated as equal
+inline u32 getPositionHash(const core::vector3df& pos)
+{
+	u32 x, y, z;
+	const f32 px = pos.X + 0.f;
+	const f32 py = pos.Y + 0.f;
+	const f32 pz = pos.Z + 0.f;
+	memcpy(&x, &px, 4);
+	memcpy(&y, &py, 4);
+	memcpy(&z, &pz, 4);
+	return (x * 73856093u) ^ (y * 19349663u) ^ (z * 83492791u);
+}
+
+//! Finds for each vertex the first vertex with the same position
+/** Uses a hash table with linear probing, so this is linear in the
+amount of vertices instead of comparing all pairs. */
+void getPositionGroups(u8* vertices, u32 pitch, u32 count, core::array<u32>& groups)
+{
+	const u32 empty = 0xffffffff;
+	u32 size = 16;
+	while (size < count*2)
+		size <<= 1;
+
+	core::array<u32> table;
+	table.set_used(size);
+	for (u32 i=0; i<size; ++i)
+		table[i] = empty;
+
+	groups.set_used(count);
+	for (u32 i=0; i<count; ++i)
+	{
+		const core::vector3df& pos = getVertex(vertices, pitch, i).Pos;
+		u32 slot = getPositionHash(pos) & (size-1);
+		while (table[slot] != empty && getVertex(vertices, pitch, table[slot]).Pos != pos)
+			slot = (slot+1) & (size-1);
+
+		if (table[slot] == empty)
+			table[slot] = i;
+		groups[i] = table[slot];
+	}
+}
+
+//! Weighted face normals for each triangle corner, stored as separate components
+template <typename T>
+class CCornerNormals
+{
+public:
+
+	CCornerNormals(u8* vertices, u32 pitch, const T* indices, bool angleWeighted,
+			f32* x, f32* y, f32* z)
+		: Vertices(vertices), Pitch(pitch), Indices(indices), AngleWeighted(angleWeighted),
+		X(x), Y(y), Z(z) {}
+
+	//! calculates the corners of the triangles [begin,end)
+	void operator()(u32 begin, u32 end)
+	{
+		for (u32 t=begin; t<end; ++t)
+		{
+			const u32 i = t*3;
+			const core::vector3df& v1 = getVertex(Vertices, Pitch, Indices[i+0]).Pos;
+			const core::vector3df& v2 = getVertex(Vertices, Pitch, Indices[i+1]).Pos;
+			const core::vector3df& v3 = getVertex(Vertices, Pitch, Indices[i+2]).Pos;
+			const core::vector3df normal = core::plane3d<f32>(v1, v2, v3).Normal;
+
+			core::vector3df weight(1.f,1.f,1.f);
+			if (AngleWeighted)
+				weight = irr::scene::getAngleWeight(v1,v2,v3); // writing irr::scene:: necessary for borland
+
+			X[i+0] = normal.X * weight.X; Y[i+0] = normal.Y * weight.X; Z[i+0] = normal.Z * weight.X;
+			X[i+1] = normal.X * weight.Y; Y[i+1] = normal.Y * weight.Y; Z[i+1] = normal.Z * weight.Y;
+			X[i+2] = normal.X * weight.Z; Y[i+2] = normal.Y * weight.Z; Z[i+2] = normal.Z * weight.Z;
+		}
+	}
+
+private:
+
+	u8* Vertices;
+	u32 Pitch;
+	const T* Indices;
+	bool AngleWeighted;
+	f32* X;
+	f32* Y;
+	f32* Z;
+};
+
+//! Normalizes summed normals and writes them into the vertices
+class CNormalWriter
+{
+public:
+
+	CNormalWriter(u8* vertices, u32 pitch, const u32* groups,
+			const f32* x, const f32* y, const f32* z)
+		: Vertices(vertices), Pitch(pitch), Groups(groups), X(x), Y(y), Z(z) {}
+
+	void operator()(u32 begin, u32 end)
+	{
+		for (u32 i=begin; i<end; ++i)
+		{
+			const u32 g = Groups ? Groups[i] : i;
+			core::vector3df& normal = getVertex(Vertices, Pitch, i).Normal;
+			normal.set(X[g], Y[g], Z[g]);
+			normal.normalize();
+		}
+	}
+
+private:
+
+	u8* Vertices;
+	u32 Pitch;
+	const u32* Groups;
+	const f32* X;
+	const f32* Y;
+	const f32* Z;
+};
+
+//! Works directly on the vertex array instead of the virtual accessors of the buffer
 template <typename T>
-void recalculateNormalsT(IMeshBuffer* buffer, bool smooth, bool angleWeighted)
+void recalculateNormalsT(IMeshBuffer* buffer, bool smooth, bool angleWeighted, bool acrossSeams)
 {
 	const u32 vtxcnt = buffer->getVertexCount();
-	const u32 idxcnt = buffer->getIndexCount();
+	const u32 idxcnt = buffer->getIndexCount() - buffer->getIndexCount() % 3;
 	const T* idx = reinterpret_cast<T*>(buffer->getIndices());
+	u8* vertices = static_cast<u8*>(buffer->getVertices());
+	const u32 pitch = video::getVertexPitchFromType(buffer->getVertexType());
+
+	if (!vtxcnt || !idxcnt)
+		return;
 
 	if (!smooth)
 	{
+		// shared vertices get the normal of their last triangle, so this stays serial
 		for (u32 i=0; i<idxcnt; i+=3)
 		{
-			const core::vector3df& v1 = buffer->getPosition(idx[i+0]);
-			const core::vector3df& v2 = buffer->getPosition(idx[i+1]);
-			const core::vector3df& v3 = buffer->getPosition(idx[i+2]);
+			const core::vector3df& v1 = getVertex(vertices, pitch, idx[i+0]).Pos;
+			const core::vector3df& v2 = getVertex(vertices, pitch, idx[i+1]).Pos;
+			const core::vector3df& v3 = getVertex(vertices, pitch, idx[i+2]).Pos;
 			const core::vector3df normal = core::plane3d<f32>(v1, v2, v3).Normal;
-			buffer->getNormal(idx[i+0]) = normal;
-			buffer->getNormal(idx[i+1]) = normal;
-			buffer->getNormal(idx[i+2]) = normal;
+			getVertex(vertices, pitch, idx[i+0]).Normal = normal;
+			getVertex(vertices, pitch, idx[i+1]).Normal = normal;
+			getVertex(vertices, pitch, idx[i+2]).Normal = normal;
 		}
+		return;
 	}
-	else
-	{
-		u32 i;
 
-		for ( i = 0; i!= vtxcnt; ++i )
-			buffer->getNormal(i).set(0.f, 0.f, 0.f);
+	// weighted face normals per corner, calculated in parallel
+	core::array<f32> corners;
+	corners.set_used(idxcnt*3);
+	f32* cx = corners.pointer();
+	f32* cy = cx + idxcnt;
+	f32* cz = cy + idxcnt;
 
-		for ( i=0; i<idxcnt; i+=3)
-		{
-			const core::vector3df& v1 = buffer->getPosition(idx[i+0]);
-			const core::vector3df& v2 = buffer->getPosition(idx[i+1]);
-			const core::vector3df& v3 = buffer->getPosition(idx[i+2]);
-			const core::vector3df normal = core::plane3d<f32>(v1, v2, v3).Normal;
+	CCornerNormals<T> cornerJob(vertices, pitch, idx, angleWeighted, cx, cy, cz);
+	if (idxcnt/3 >= NORMALS_PARALLEL_TRIANGLES)
+		parallelFor(idxcnt/3, NORMALS_PARALLEL_TRIANGLES/4, cornerJob);
+	else
+		cornerJob(0, idxcnt/3);
 
-			core::vector3df weight(1.f,1.f,1.f);
-			if (angleWeighted)
-				weight = irr::scene::getAngleWeight(v1,v2,v3); // writing irr::scene:: necessary for borland
+	core::array<u32> groups;
+	if (acrossSeams)
+		getPositionGroups(vertices, pitch, vtxcnt, groups);
 
-			buffer->getNormal(idx[i+0]) += weight.X*normal;
-			buffer->getNormal(idx[i+1]) += weight.Y*normal;
-			buffer->getNormal(idx[i+2]) += weight.Z*normal;
-		}
+	// summing up is cheap and done in order, so results don't depend on the threads
+	core::array<f32> sums;
+	sums.set_used(vtxcnt*3);
+	f32* nx = sums.pointer();
+	f32* ny = nx + vtxcnt;
+	f32* nz = ny + vtxcnt;
+	memset(nx, 0, vtxcnt*3*sizeof(f32));
 
-		for ( i = 0; i!= vtxcnt; ++i )
-			buffer->getNormal(i).normalize();
+	if (acrossSeams)
+	{
+		for (u32 i=0; i<idxcnt; ++i)
+		{
+			const u32 v = groups[idx[i]];
+			nx[v] += cx[i];
+			ny[v] += cy[i];
+			nz[v] += cz[i];
+		}
+	}
+	else
+	{
+		for (u32 i=0; i<idxcnt; ++i)
+		{
+			const u32 v = idx[i];
+			nx[v] += cx[i];
+			ny[v] += cy[i];
+			nz[v] += cz[i];
+		}
 	}
+
+	CNormalWriter writeJob(vertices, pitch, acrossSeams ? groups.const_pointer() : 0, nx, ny, nz);
+	if (vtxcnt >= NORMALS_PARALLEL_TRIANGLES)
+		parallelFor(vtxcnt, NORMALS_PARALLEL_TRIANGLES/4, writeJob);
+	else
+		writeJob(0, vtxcnt);
 }
 }
 
@@ -132,9 +293,9 @@ void CMeshManipulator::recalculateNormals(IMeshBuffer* buffer, bool smooth, bool
 		return;
 
 	if (buffer->getIndexType()==video::EIT_16BIT)
-		recalculateNormalsT<u16>(buffer, smooth, angleWeighted);
+		recalculateNormalsT<u16>(buffer, smooth, angleWeighted, false);
 	else
-		recalculateNormalsT<u32>(buffer, smooth, angleWeighted);
+		recalculateNormalsT<u32>(buffer, smooth, angleWeighted, false);
 }
 
 
@@ -151,6 +312,31 @@ void CMeshManipulator::recalculateNormals(scene::IMesh* mesh, bool smooth, bool
 }
 
 
+//! Recalculates smooth normals of the mesh buffer, also across vertices sharing a position.
+void CMeshManipulator::recalculateNormalsAcrossSeams(IMeshBuffer* buffer, bool angleWeighted) const
+{
+	if (!buffer)
+		return;
+
+	if (buffer->getIndexType()==video::EIT_16BIT)
+		recalculateNormalsT<u16>(buffer, true, angleWeighted, true);
+	else
+		recalculateNormalsT<u32>(buffer, true, angleWeighted, true);
+}
+
+
+//! Recalculates smooth normals of the mesh, also across vertices sharing a position.
+void CMeshManipulator::recalculateNormalsAcrossSeams(IMesh* mesh, bool angleWeighted) const
+{
+	if (!mesh)
+		return;
+
+	const u32 bcount = mesh->getMeshBufferCount();
+	for ( u32 b=0; b<bcount; ++b)
+		recalculateNormalsAcrossSeams(mesh->getMeshBuffer(b), angleWeighted);
+}
+
+
 namespace
 {
 void calculateTangents(
@@ -249,6 +435,85 @@ void calculateTangents(
 }
 
 
+//! Per triangle result of the tangent calculation
+struct STangentFace
+{
+	core::vector3df Normal;
+	core::vector3df Tangent;
+	core::vector3df Binormal;
+	//! weights of the three corners
+	core::vector3df Weight;
+	bool Degenerated;
+};
+
+//! Calculates normal, tangent and binormal of triangles
+/** The results of calculateTangents() don't depend on which corner is
+passed first, so they are calculated only once per triangle. */
+template <typename T>
+class CTangentFaces
+{
+public:
+
+	CTangentFaces(const video::S3DVertexTangents* vertices, const T* indices,
+			bool angleWeighted, STangentFace* faces)
+		: Vertices(vertices), Indices(indices), AngleWeighted(angleWeighted), Faces(faces) {}
+
+	void operator()(u32 begin, u32 end)
+	{
+		for (u32 t=begin; t<end; ++t)
+		{
+			const video::S3DVertexTangents& v1 = Vertices[Indices[t*3+0]];
+			const video::S3DVertexTangents& v2 = Vertices[Indices[t*3+1]];
+			const video::S3DVertexTangents& v3 = Vertices[Indices[t*3+2]];
+			STangentFace& face = Faces[t];
+
+			calculateTangents(face.Normal, face.Tangent, face.Binormal,
+				v1.Pos, v2.Pos, v3.Pos, v1.TCoords, v2.TCoords, v3.TCoords);
+
+			face.Degenerated = (v1.Pos == v2.Pos || v1.Pos == v3.Pos || v2.Pos == v3.Pos);
+
+			//Angle-weighted normals look better, but are slightly more CPU intensive to calculate
+			if (AngleWeighted && !face.Degenerated)
+				face.Weight = irr::scene::getAngleWeight(v1.Pos, v2.Pos, v3.Pos);	// writing irr::scene:: necessary for borland
+			else
+				face.Weight.set(1.f, 1.f, 1.f);
+		}
+	}
+
+private:
+
+	const video::S3DVertexTangents* Vertices;
+	const T* Indices;
+	bool AngleWeighted;
+	STangentFace* Faces;
+};
+
+//! Normalizes the summed up normals, tangents and binormals
+class CTangentNormalizer
+{
+public:
+
+	CTangentNormalizer(video::S3DVertexTangents* vertices, bool normals)
+		: Vertices(vertices), Normals(normals) {}
+
+	void operator()(u32 begin, u32 end)
+	{
+		for (u32 i=begin; i<end; ++i)
+		{
+			if (Normals)
+				Vertices[i].Normal.normalize();
+			Vertices[i].Tangent.normalize();
+			Vertices[i].Binormal.normalize();
+		}
+	}
+
+private:
+
+	video::S3DVertexTangents* Vertices;
+	bool Normals;
+};
+
+
 //! Recalculates tangents for a tangent mesh buffer
 template <typename T>
 void recalculateTangentsT(IMeshBuffer* buffer, bool recalculateNormals, bool smooth, bool angleWeighted)
@@ -257,12 +522,24 @@ void recalculateTangentsT(IMeshBuffer* buffer, bool recalculateNormals, bool smo
 		return;
 
 	const u32 vtxCnt = buffer->getVertexCount();
-	const u32 idxCnt = buffer->getIndexCount();
+	const u32 triCnt = buffer->getIndexCount() / 3;
 
-	T* idx = reinterpret_cast<T*>(buffer->getIndices());
+	const T* idx = reinterpret_cast<T*>(buffer->getIndices());
 	video::S3DVertexTangents* v =
 		(video::S3DVertexTangents*)buffer->getVertices();
 
+	if (!vtxCnt || !triCnt)
+		return;
+
+	core::array<STangentFace> faces;
+	faces.set_used(triCnt);
+
+	CTangentFaces<T> faceJob(v, idx, angleWeighted, faces.pointer());
+	if (triCnt >= NORMALS_PARALLEL_TRIANGLES)
+		parallelFor(triCnt, NORMALS_PARALLEL_TRIANGLES/4, faceJob);
+	else
+		faceJob(0, triCnt);
+
 	if (smooth)
 	{
 		u32 i;
@@ -276,131 +553,45 @@ void recalculateTangentsT(IMeshBuffer* buffer, bool recalculateNormals, bool smo
 		}
 
 		//Each vertex gets the sum of the tangents and binormals from the faces around it
-		for ( i=0; i<idxCnt; i+=3)
+		for ( i=0; i<triCnt; ++i)
 		{
+			const STangentFace& face = faces[i];
 			// if this triangle is degenerate, skip it!
-			if (v[idx[i+0]].Pos == v[idx[i+1]].Pos || 
-				v[idx[i+0]].Pos == v[idx[i+2]].Pos || 
-				v[idx[i+1]].Pos == v[idx[i+2]].Pos 
-				/*||
-				v[idx[i+0]].TCoords == v[idx[i+1]].TCoords || 
-				v[idx[i+0]].TCoords == v[idx[i+2]].TCoords || 
-				v[idx[i+1]].TCoords == v[idx[i+2]].TCoords */
-				) 
+			if (face.Degenerated)
 				continue;
 
-			//Angle-weighted normals look better, but are slightly more CPU intensive to calculate
-			core::vector3df weight(1.f,1.f,1.f);
-			if (angleWeighted)
-				weight = irr::scene::getAngleWeight(v[i+0].Pos,v[i+1].Pos,v[i+2].Pos);	// writing irr::scene:: necessary for borland
-			core::vector3df localNormal; 
-			core::vector3df localTangent;
-			core::vector3df localBinormal;
-
-			calculateTangents(
-				localNormal,
-				localTangent,
-				localBinormal,
-				v[idx[i+0]].Pos,
-				v[idx[i+1]].Pos,
-				v[idx[i+2]].Pos,
-				v[idx[i+0]].TCoords,
-				v[idx[i+1]].TCoords,
-				v[idx[i+2]].TCoords);
-
-			if (recalculateNormals)
-				v[idx[i+0]].Normal += localNormal * weight.X;
-			v[idx[i+0]].Tangent += localTangent * weight.X;
-			v[idx[i+0]].Binormal += localBinormal * weight.X;
-			
-			calculateTangents(
-				localNormal,
-				localTangent,
-				localBinormal,
-				v[idx[i+1]].Pos,
-				v[idx[i+2]].Pos,
-				v[idx[i+0]].Pos,
-				v[idx[i+1]].TCoords,
-				v[idx[i+2]].TCoords,
-				v[idx[i+0]].TCoords);
-
-			if (recalculateNormals)
-				v[idx[i+1]].Normal += localNormal * weight.Y;
-			v[idx[i+1]].Tangent += localTangent * weight.Y;
-			v[idx[i+1]].Binormal += localBinormal * weight.Y;
-
-			calculateTangents(
-				localNormal,
-				localTangent,
-				localBinormal,
-				v[idx[i+2]].Pos,
-				v[idx[i+0]].Pos,
-				v[idx[i+1]].Pos,
-				v[idx[i+2]].TCoords,
-				v[idx[i+0]].TCoords,
-				v[idx[i+1]].TCoords);
-
-			if (recalculateNormals)
-				v[idx[i+2]].Normal += localNormal * weight.Z;
-			v[idx[i+2]].Tangent += localTangent * weight.Z;
-			v[idx[i+2]].Binormal += localBinormal * weight.Z;
+			const f32 weight[3] = { face.Weight.X, face.Weight.Y, face.Weight.Z };
+			for (u32 c=0; c<3; ++c)
+			{
+				video::S3DVertexTangents& vertex = v[idx[i*3+c]];
+				if (recalculateNormals)
+					vertex.Normal += face.Normal * weight[c];
+				vertex.Tangent += face.Tangent * weight[c];
+				vertex.Binormal += face.Binormal * weight[c];
+			}
 		}
 
 		// Normalize the tangents and binormals
-		if (recalculateNormals)
-		{
-			for ( i = 0; i!= vtxCnt; ++i )
-				v[i].Normal.normalize();
-		}
-		for ( i = 0; i!= vtxCnt; ++i )
-		{
-			v[i].Tangent.normalize();
-			v[i].Binormal.normalize();
-		}
+		CTangentNormalizer normalizeJob(v, recalculateNormals);
+		if (vtxCnt >= NORMALS_PARALLEL_TRIANGLES)
+			parallelFor(vtxCnt, NORMALS_PARALLEL_TRIANGLES/4, normalizeJob);
+		else
+			normalizeJob(0, vtxCnt);
 	}
 	else
 	{
-		core::vector3df localNormal; 
-		for (u32 i=0; i<idxCnt; i+=3)
-		{
-			calculateTangents(
-				localNormal,
-				v[idx[i+0]].Tangent,
-				v[idx[i+0]].Binormal,
-				v[idx[i+0]].Pos,
-				v[idx[i+1]].Pos,
-				v[idx[i+2]].Pos,
-				v[idx[i+0]].TCoords,
-				v[idx[i+1]].TCoords,
-				v[idx[i+2]].TCoords);
-			if (recalculateNormals)
-				v[idx[i+0]].Normal=localNormal;
-
-			calculateTangents(
-				localNormal,
-				v[idx[i+1]].Tangent,
-				v[idx[i+1]].Binormal,
-				v[idx[i+1]].Pos,
-				v[idx[i+2]].Pos,
-				v[idx[i+0]].Pos,
-				v[idx[i+1]].TCoords,
-				v[idx[i+2]].TCoords,
-				v[idx[i+0]].TCoords);
-			if (recalculateNormals)
-				v[idx[i+1]].Normal=localNormal;
-
-			calculateTangents(
-				localNormal,
-				v[idx[i+2]].Tangent,
-				v[idx[i+2]].Binormal,
-				v[idx[i+2]].Pos,
-				v[idx[i+0]].Pos,
-				v[idx[i+1]].Pos,
-				v[idx[i+2]].TCoords,
-				v[idx[i+0]].TCoords,
-				v[idx[i+1]].TCoords);
-			if (recalculateNormals)
-				v[idx[i+2]].Normal=localNormal;
+		// shared vertices get the values of their last triangle
+		for (u32 i=0; i<triCnt; ++i)
+		{
+			const STangentFace& face = faces[i];
+			for (u32 c=0; c<3; ++c)
+			{
+				video::S3DVertexTangents& vertex = v[idx[i*3+c]];
+				vertex.Tangent = face.Tangent;
+				vertex.Binormal = face.Binormal;
+				if (recalculateNormals)
+					vertex.Normal = face.Normal;
+			}
 		}
 	}
 }
@@ -1815,6 +2006,1162 @@ IMesh* CMeshManipulator::createForsythOptimizedMesh(const IMesh *mesh) const
 	return newmesh;
 }
 
+namespace
+{
+
+//! Size of the simulated vertex cache for optimizeMeshBuffer
+const u32 OPTIMIZE_CACHE_SIZE = 32;
+//! Valences up to this size are looked up in a table
+const u32 OPTIMIZE_VALENCE_TABLE_SIZE = 64;
+//! Size of the FIFO cache used for finding cluster borders for overdraw optimization
+const u32 OPTIMIZE_OVERDRAW_CACHE_SIZE = 16;
+
+//! Vertex scores of the Forsyth algorithm, same constants as above
+class CVertexScores
+{
+public:
+
+	CVertexScores()
+	{
+		const f32 CacheDecayPower = 1.5f;
+		const f32 LastTriScore = 0.75f;
+		const f32 ValenceBoostScale = 2.0f;
+		const f32 ValenceBoostPower = 0.5f;
+
+		for (u32 i=0; i<OPTIMIZE_CACHE_SIZE; ++i)
+		{
+			if (i < 3)
+				Cache[i] = LastTriScore;
+			else
+				Cache[i] = powf(1.f - (i - 3) * (1.f / (OPTIMIZE_CACHE_SIZE - 3)), CacheDecayPower);
+		}
+
+		Valence[0] = 0.f;
+		for (u32 i=1; i<OPTIMIZE_VALENCE_TABLE_SIZE; ++i)
+			Valence[i] = ValenceBoostScale * powf((f32)i, -ValenceBoostPower);
+	}
+
+	//! score of a vertex at cachePos (negative if not cached) with live triangles left
+	f32 get(s32 cachePos, u32 live) const
+	{
+		// No tri needs this vertex!
+		if (!live)
+			return -1.f;
+
+		f32 score = (cachePos >= 0) ? Cache[cachePos] : 0.f;
+		if (live < OPTIMIZE_VALENCE_TABLE_SIZE)
+			score += Valence[live];
+		else
+			score += 2.0f * powf((f32)live, -0.5f);
+		return score;
+	}
+
+private:
+
+	f32 Cache[OPTIMIZE_CACHE_SIZE];
+	f32 Valence[OPTIMIZE_VALENCE_TABLE_SIZE];
+};
+
+
+//! Reorders triangles for the post transform vertex cache, see createForsythOptimizedMesh
+/** Unlike the version above this one only looks at triangles of cached
+vertices, so it runs in linear time. When no cached vertex has triangles
+left, the next triangle in input order is taken. */
+template <typename T>
+void optimizeVertexCacheT(T* indices, u32 indexCount, u32 vertexCount)
+{
+	const u32 triCount = indexCount / 3;
+	const CVertexScores scores;
+
+	// triangles of each vertex, the live ones are kept at the front
+	core::array<u32> offsets;
+	offsets.set_used(vertexCount+1);
+	memset(offsets.pointer(), 0, (vertexCount+1)*sizeof(u32));
+	for (u32 i=0; i<triCount*3; ++i)
+		++offsets[indices[i]+1];
+	for (u32 v=0; v<vertexCount; ++v)
+		offsets[v+1] += offsets[v];
+
+	core::array<u32> live;
+	live.set_used(vertexCount);
+	for (u32 v=0; v<vertexCount; ++v)
+		live[v] = offsets[v+1] - offsets[v];
+
+	core::array<u32> adjacency;
+	adjacency.set_used(triCount*3);
+	{
+		core::array<u32> fill(offsets);
+		for (u32 i=0; i<triCount*3; ++i)
+			adjacency[fill[indices[i]]++] = i/3;
+	}
+
+	core::array<s32> cachePos;
+	core::array<f32> vertexScore;
+	cachePos.set_used(vertexCount);
+	vertexScore.set_used(vertexCount);
+	for (u32 v=0; v<vertexCount; ++v)
+	{
+		cachePos[v] = -1;
+		vertexScore[v] = scores.get(-1, live[v]);
+	}
+
+	core::array<u8> emitted;
+	emitted.set_used(triCount);
+	memset(emitted.pointer(), 0, triCount);
+
+	core::array<T> output;
+	output.set_used(triCount*3);
+
+	u32 cache[OPTIMIZE_CACHE_SIZE+3];
+	u32 newCache[OPTIMIZE_CACHE_SIZE+3];
+	u32 cacheSize = 0;
+	u32 nextTriangle = 0;
+	s32 best = -1;
+
+	for (u32 n=0; n<triCount; ++n)
+	{
+		if (best < 0)
+		{
+			while (emitted[nextTriangle])
+				++nextTriangle;
+			best = nextTriangle;
+		}
+
+		const T* tri = indices + best*3;
+		output[n*3+0] = tri[0];
+		output[n*3+1] = tri[1];
+		output[n*3+2] = tri[2];
+		emitted[best] = 1;
+
+		// remove the triangle from its vertices
+		u32 newCacheSize = 0;
+		for (u32 j=0; j<3; ++j)
+		{
+			const u32 v = tri[j];
+			u32* list = adjacency.pointer() + offsets[v];
+			for (u32 k=0; k<live[v]; ++k)
+			{
+				if (list[k] == (u32)best)
+				{
+					list[k] = list[live[v]-1];
+					list[live[v]-1] = best;
+					--live[v];
+					break;
+				}
+			}
+			newCache[newCacheSize++] = v;
+		}
+
+		// the vertices of the triangle move to the front of the cache
+		for (u32 i=0; i<cacheSize; ++i)
+		{
+			const u32 v = cache[i];
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+				newCache[newCacheSize++] = v;
+		}
+
+		for (u32 i=0; i<newCacheSize; ++i)
+		{
+			const u32 v = newCache[i];
+			cachePos[v] = (i < OPTIMIZE_CACHE_SIZE) ? (s32)i : -1;
+			vertexScore[v] = scores.get(cachePos[v], live[v]);
+		}
+
+		cacheSize = core::min_(newCacheSize, OPTIMIZE_CACHE_SIZE);
+		memcpy(cache, newCache, cacheSize*sizeof(u32));
+
+		// find the best triangle using a cached vertex
+		best = -1;
+		f32 bestScore = -1.f;
+		for (u32 i=0; i<cacheSize; ++i)
+		{
+			const u32 v = cache[i];
+			const u32* list = adjacency.const_pointer() + offsets[v];
+			for (u32 k=0; k<live[v]; ++k)
+			{
+				const u32 t = list[k];
+				const f32 score = vertexScore[indices[t*3]] + vertexScore[indices[t*3+1]] + vertexScore[indices[t*3+2]];
+				if (score > bestScore)
+				{
+					best = t;
+					bestScore = score;
+				}
+			}
+		}
+	}
+
+	memcpy(indices, output.const_pointer(), triCount*3*sizeof(T));
+}
+
+
+//! Group of triangles which is drawn in one piece by the overdraw optimization
+struct SOverdrawCluster
+{
+	u32 Begin;
+	u32 End;
+	f32 Sort;
+
+	bool operator<(const SOverdrawCluster& other) const
+	{
+		// front facing clusters on the outside are drawn first
+		return Sort > other.Sort || (Sort == other.Sort && Begin < other.Begin);
+	}
+};
+
+
+//! Sorts clusters of a cache optimized triangle list to reduce overdraw
+/** Clusters end where the vertex cache gets cold anyway, so the cache
+efficiency is mostly kept. Clusters facing away from the center of the
+buffer are likely to cover others and get drawn first. */
+template <typename T>
+void optimizeOverdrawT(T* indices, u32 indexCount, const u8* vertices, u32 pitch, u32 vertexCount)
+{
+	const u32 triCount = indexCount / 3;
+	if (triCount < 2)
+		return;
+
+	core::vector3df center;
+	for (u32 v=0; v<vertexCount; ++v)
+		center += reinterpret_cast<const video::S3DVertex*>(vertices + v*pitch)->Pos;
+	center /= (f32)vertexCount;
+
+	// simulate a FIFO cache, a triangle without any hits starts a new cluster
+	core::array<u32> cacheTime;
+	cacheTime.set_used(vertexCount);
+	for (u32 v=0; v<vertexCount; ++v)
+		cacheTime[v] = 0;
+	u32 time = OPTIMIZE_OVERDRAW_CACHE_SIZE + 1;
+
+	core::array<SOverdrawCluster> clusters;
+	SOverdrawCluster cluster;
+	cluster.Begin = 0;
+	for (u32 t=0; t<triCount; ++t)
+	{
+		u32 misses = 0;
+		for (u32 j=0; j<3; ++j)
+		{
+			const u32 v = indices[t*3+j];
+			if (time - cacheTime[v] > OPTIMIZE_OVERDRAW_CACHE_SIZE)
+			{
+				cacheTime[v] = time++;
+				++misses;
+			}
+		}
+
+		if (misses == 3 && t != cluster.Begin)
+		{
+			cluster.End = t;
+			clusters.push_back(cluster);
+			cluster.Begin = t;
+		}
+	}
+	cluster.End = triCount;
+	clusters.push_back(cluster);
+
+	if (clusters.size() < 2)
+		return;
+
+	for (u32 c=0; c<clusters.size(); ++c)
+	{
+		core::vector3df normal;
+		core::vector3df centroid;
+		f32 area = 0.f;
+		for (u32 t=clusters[c].Begin; t<clusters[c].End; ++t)
+		{
+			const core::vector3df& a = reinterpret_cast<const video::S3DVertex*>(vertices + indices[t*3+0]*pitch)->Pos;
+			const core::vector3df& b = reinterpret_cast<const video::S3DVertex*>(vertices + indices[t*3+1]*pitch)->Pos;
+			const core::vector3df& d = reinterpret_cast<const video::S3DVertex*>(vertices + indices[t*3+2]*pitch)->Pos;
+			const core::vector3df n = (b-a).crossProduct(d-a);
+			const f32 triArea = n.getLength();
+			normal += n;
+			centroid += (a+b+d) * triArea;
+			area += triArea;
+		}
+
+		if (area > 0.f)
+			centroid /= area;
+		normal.normalize();
+		clusters[c].Sort = (centroid - center).dotProduct(normal);
+	}
+
+	clusters.sort();
+
+	core::array<T> output;
+	output.set_used(triCount*3);
+	u32 n = 0;
+	for (u32 c=0; c<clusters.size(); ++c)
+	{
+		const u32 count = (clusters[c].End - clusters[c].Begin) * 3;
+		memcpy(output.pointer() + n, indices + clusters[c].Begin*3, count*sizeof(T));
+		n += count;
+	}
+	memcpy(indices, output.const_pointer(), triCount*3*sizeof(T));
+}
+
+
+//! Sorts vertices by their first use in the index list
+/** Vertices which are not used at all are moved to the end. */
+template <typename T>
+void optimizeVertexFetchT(T* indices, u32 indexCount, u8* vertices, u32 pitch, u32 vertexCount)
+{
+	const u32 unused = 0xffffffff;
+	core::array<u32> remap;
+	remap.set_used(vertexCount);
+	for (u32 v=0; v<vertexCount; ++v)
+		remap[v] = unused;
+
+	u32 next = 0;
+	for (u32 i=0; i<indexCount; ++i)
+	{
+		const u32 v = indices[i];
+		if (remap[v] == unused)
+			remap[v] = next++;
+		indices[i] = (T)remap[v];
+	}
+
+	for (u32 v=0; v<vertexCount; ++v)
+	{
+		if (remap[v] == unused)
+			remap[v] = next++;
+	}
+
+	core::array<u8> copy;
+	copy.set_used(vertexCount*pitch);
+	memcpy(copy.pointer(), vertices, vertexCount*pitch);
+	for (u32 v=0; v<vertexCount; ++v)
+		memcpy(vertices + remap[v]*pitch, copy.const_pointer() + v*pitch, pitch);
+}
+
+
+template <typename T>
+void optimizeMeshBufferT(IMeshBuffer* buffer, u32 flags)
+{
+	T* indices = reinterpret_cast<T*>(buffer->getIndices());
+	const u32 indexCount = buffer->getIndexCount() - buffer->getIndexCount() % 3;
+	u8* vertices = static_cast<u8*>(buffer->getVertices());
+	const u32 vertexCount = buffer->getVertexCount();
+	const u32 pitch = video::getVertexPitchFromType(buffer->getVertexType());
+
+	if (flags & EMO_VERTEX_CACHE)
+		optimizeVertexCacheT<T>(indices, indexCount, vertexCount);
+	if (flags & EMO_OVERDRAW)
+		optimizeOverdrawT<T>(indices, indexCount, vertices, pitch, vertexCount);
+	if (flags & EMO_VERTEX_FETCH)
+		optimizeVertexFetchT<T>(indices, indexCount, vertices, pitch, vertexCount);
+}
+
+} // end anonymous namespace
+
+
+//! Optimizes the order of triangles and vertices of a meshbuffer in place
+void CMeshManipulator::optimizeMeshBuffer(IMeshBuffer* buffer, u32 flags) const
+{
+	if (!buffer || buffer->getIndexCount() < 3 || !buffer->getVertexCount())
+		return;
+
+	if (buffer->getIndexType() == video::EIT_16BIT)
+		optimizeMeshBufferT<u16>(buffer, flags);
+	else
+		optimizeMeshBufferT<u32>(buffer, flags);
+
+	buffer->setDirty();
+}
+
+
+//! Optimizes the order of triangles and vertices of all meshbuffers in place
+void CMeshManipulator::optimizeMesh(IMesh* mesh, u32 flags) const
+{
+	if (!mesh)
+		return;
+
+	const u32 bcount = mesh->getMeshBufferCount();
+	for (u32 b=0; b<bcount; ++b)
+		optimizeMeshBuffer(mesh->getMeshBuffer(b), flags);
+}
+
+namespace
+{
+
+//! Symmetric 4x4 error quadric, only the upper triangle is stored
+struct SQuadric
+{
+	void reset()
+	{
+		A00 = A01 = A02 = A03 = A11 = A12 = A13 = A22 = A23 = A33 = Weight = 0.0;
+	}
+
+	//! Quadric measuring the squared distance to the plane ax+by+cz+d=0
+	void setPlane(f64 a, f64 b, f64 c, f64 d, f64 weight)
+	{
+		A00 = a*a*weight; A01 = a*b*weight; A02 = a*c*weight; A03 = a*d*weight;
+		A11 = b*b*weight; A12 = b*c*weight; A13 = b*d*weight;
+		A22 = c*c*weight; A23 = c*d*weight;
+		A33 = d*d*weight;
+		Weight = weight;
+	}
+
+	void add(const SQuadric& other)
+	{
+		A00 += other.A00; A01 += other.A01; A02 += other.A02; A03 += other.A03;
+		A11 += other.A11; A12 += other.A12; A13 += other.A13;
+		A22 += other.A22; A23 += other.A23;
+		A33 += other.A33;
+		Weight += other.Weight;
+	}
+
+	f64 evaluate(const core::vector3df& p) const
+	{
+		const f64 x = p.X;
+		const f64 y = p.Y;
+		const f64 z = p.Z;
+		return x*(A00*x + 2.0*(A01*y + A02*z + A03)) +
+			y*(A11*y + 2.0*(A12*z + A13)) +
+			z*(A22*z + 2.0*A23) + A33;
+	}
+
+	f64 A00, A01, A02, A03, A11, A12, A13, A22, A23, A33;
+	//! summed plane weights, turns the error into a mean squared distance
+	f64 Weight;
+};
+
+//! How a vertex may be moved by the simplifier
+enum E_SIMPLIFY_VERTEX
+{
+	//! inner vertex, may collapse into any neighbour
+	ESV_MANIFOLD = 0,
+	//! vertex on an open border or texture seam, may only slide along it
+	ESV_BORDER
+};
+
+struct SEdgeCollapse
+{
+	f64 Cost;
+	u32 From;
+	u32 To;
+	u32 FromStamp;
+	u32 ToStamp;
+};
+
+struct SSimplifyEdge
+{
+	SSimplifyEdge() {}
+	SSimplifyEdge(u32 a, u32 b, u32 triangle)
+		: A(core::min_(a,b)), B(core::max_(a,b)), Triangle(triangle) {}
+
+	bool operator<(const SSimplifyEdge& other) const
+	{
+		return A < other.A || (A == other.A && B < other.B);
+	}
+
+	bool operator==(const SSimplifyEdge& other) const
+	{
+		return A == other.A && B == other.B;
+	}
+
+	u32 A;
+	u32 B;
+	//! triangle using the edge, not compared
+	u32 Triangle;
+};
+
+struct SWedgePair
+{
+	u32 From;
+	u32 To;
+};
+
+//! Quadric error edge collapse simplifier after Garland and Heckbert.
+/** Vertices are only collapsed into their neighbours and never moved,
+so all vertex attributes stay valid and no new vertices are created. */
+class CMeshSimplifier
+{
+public:
+
+	CMeshSimplifier(const IMeshBuffer* mb)
+		: Vertices((const u8*)mb->getVertices()),
+		Pitch(video::getVertexPitchFromType(mb->getVertexType())),
+		VertexType(mb->getVertexType()), LiveTriangles(0)
+	{
+		const u32 vcount = mb->getVertexCount();
+		const u32 icount = mb->getIndexCount() - mb->getIndexCount() % 3;
+
+		Positions.set_used(vcount);
+		for (u32 i=0; i<vcount; ++i)
+			Positions[i] = mb->getPosition(i);
+
+		Corners.set_used(icount);
+		if (mb->getIndexType() == video::EIT_32BIT)
+		{
+			const u32* ind = (const u32*)mb->getIndices();
+			for (u32 i=0; i<icount; ++i)
+				Corners[i] = ind[i];
+		}
+		else
+		{
+			const u16* ind = mb->getIndices();
+			for (u32 i=0; i<icount; ++i)
+				Corners[i] = ind[i];
+		}
+
+		// Vertices at the same position are welded, so flat shaded meshes
+		// and texture seams don't tear apart. Vertices of a position which
+		// also share their texture coordinates and color form a wedge.
+		getPositionGroups((u8*)Vertices, Pitch, vcount, Groups);
+		GroupNext.set_used(vcount);
+		Wedges.set_used(vcount);
+		core::array<u32> groupLast;
+		groupLast.set_used(vcount);
+		for (u32 i=0; i<vcount; ++i)
+		{
+			const u32 g = Groups[i];
+			GroupNext[i] = NONE;
+			Wedges[i] = i;
+			if (g != i)
+			{
+				for (u32 j=g; j!=NONE; j=GroupNext[j])
+				{
+					if (haveSameAttributes(i, j))
+					{
+						Wedges[i] = Wedges[j];
+						break;
+					}
+				}
+				GroupNext[groupLast[g]] = i;
+			}
+			groupLast[g] = i;
+		}
+
+		// drop degenerated triangles and those with invalid indices right away
+		const u32 tcount = icount / 3;
+		Indices.set_used(icount);
+		TriangleAlive.set_used(tcount);
+		for (u32 t=0; t<tcount; ++t)
+		{
+			const u32* corner = &Corners[t*3];
+			u32* tri = &Indices[t*3];
+			TriangleAlive[t] = corner[0] < vcount && corner[1] < vcount && corner[2] < vcount;
+			for (u32 k=0; k<3; ++k)
+				tri[k] = TriangleAlive[t] ? Groups[corner[k]] : 0;
+			TriangleAlive[t] = TriangleAlive[t] &&
+				tri[0] != tri[1] && tri[1] != tri[2] && tri[0] != tri[2];
+			if (TriangleAlive[t])
+				++LiveTriangles;
+		}
+	}
+
+	u32 getTriangleCount() const
+	{
+		return LiveTriangles;
+	}
+
+	//! Collapses edges until the target triangle count or the error limit is reached
+	/** \param maxError Maximal mean distance between the simplified and the
+	original surface, 0 for no limit. */
+	void simplify(u32 targetTriangles, f64 maxError)
+	{
+		if (LiveTriangles <= targetTriangles)
+			return;
+
+		init();
+
+		const f64 maxCost = maxError > 0.0 ? maxError*maxError : -1.0;
+
+		while (LiveTriangles > targetTriangles && Heap.size())
+		{
+			const SEdgeCollapse c = Heap[0];
+			popHeap();
+
+			if (Removed[c.From] || Removed[c.To] ||
+				Stamp[c.From] != c.FromStamp || Stamp[c.To] != c.ToStamp)
+				continue;
+
+			if (maxCost >= 0.0 && c.Cost > maxCost)
+				break;
+
+			if (flipsTriangles(c.From, c.To) || !mapWedges(c.From, c.To))
+				continue;
+
+			collapse(c.From, c.To);
+		}
+	}
+
+	//! Returns the remaining triangles and the vertices they use.
+	/** \param vertices Receives the original index of each used vertex.
+	\param indices Receives the triangles, indexing into vertices. */
+	void getResult(core::array<u32>& vertices, core::array<u32>& indices) const
+	{
+		core::array<u32> remap;
+		remap.set_used(Positions.size());
+		for (u32 i=0; i<remap.size(); ++i)
+			remap[i] = 0xffffffff;
+
+		for (u32 t=0; t<TriangleAlive.size(); ++t)
+		{
+			if (!TriangleAlive[t])
+				continue;
+			for (u32 k=0; k<3; ++k)
+				remap[Corners[t*3+k]] = 0;
+		}
+
+		// keep the original vertex order, it is usually cache friendly
+		vertices.set_used(0);
+		for (u32 i=0; i<remap.size(); ++i)
+		{
+			if (remap[i] == 0xffffffff)
+				continue;
+			remap[i] = vertices.size();
+			vertices.push_back(i);
+		}
+
+		indices.set_used(0);
+		indices.reallocate(LiveTriangles*3);
+		for (u32 t=0; t<TriangleAlive.size(); ++t)
+		{
+			if (!TriangleAlive[t])
+				continue;
+			for (u32 k=0; k<3; ++k)
+				indices.push_back(remap[Corners[t*3+k]]);
+		}
+	}
+
+private:
+
+	static const u32 NONE = 0xffffffff;
+
+	bool haveSameAttributes(u32 a, u32 b) const
+	{
+		const video::S3DVertex& va = *(const video::S3DVertex*)(Vertices + a*Pitch);
+		const video::S3DVertex& vb = *(const video::S3DVertex*)(Vertices + b*Pitch);
+		if (va.TCoords != vb.TCoords || va.Color != vb.Color)
+			return false;
+		if (VertexType == video::EVT_2TCOORDS)
+			return ((const video::S3DVertex2TCoords&)va).TCoords2 == ((const video::S3DVertex2TCoords&)vb).TCoords2;
+		return true;
+	}
+
+	//! returns the vertex a triangle uses at a welded position
+	u32 getCorner(u32 t, u32 v) const
+	{
+		const u32* tri = &Indices[t*3];
+		return Corners[t*3 + (tri[0] == v ? 0 : (tri[1] == v ? 1 : 2))];
+	}
+
+	bool containsVertex(u32 t, u32 v) const
+	{
+		const u32* tri = &Indices[t*3];
+		return tri[0] == v || tri[1] == v || tri[2] == v;
+	}
+
+	//! Finds the wedge at to for each wedge around from.
+	/** The triangles of the collapsed edge tell which wedges belong
+	together. Fails if a wedge has no or no unique counterpart, which
+	keeps texture seams from being moved across the surface. */
+	bool mapWedges(u32 from, u32 to)
+	{
+		WedgeMap.set_used(0);
+
+		const core::array<u32>& tris = VertexTriangles[from];
+		for (u32 i=0; i<tris.size(); ++i)
+		{
+			const u32 t = tris[i];
+			if (!TriangleAlive[t] || !containsVertex(t, to))
+				continue;
+
+			SWedgePair pair;
+			pair.From = Wedges[getCorner(t, from)];
+			pair.To = Wedges[getCorner(t, to)];
+
+			u32 j = 0;
+			while (j<WedgeMap.size() && WedgeMap[j].From != pair.From)
+				++j;
+			if (j == WedgeMap.size())
+				WedgeMap.push_back(pair);
+			else if (WedgeMap[j].To != pair.To)
+				return false;
+		}
+
+		for (u32 i=0; i<tris.size(); ++i)
+		{
+			const u32 t = tris[i];
+			if (!TriangleAlive[t] || containsVertex(t, to))
+				continue;
+
+			if (findWedge(Wedges[getCorner(t, from)]) == NONE)
+				return false;
+		}
+		return true;
+	}
+
+	//! returns the wedge at the target of the collapse
+	u32 findWedge(u32 wedge) const
+	{
+		for (u32 i=0; i<WedgeMap.size(); ++i)
+		{
+			if (WedgeMap[i].From == wedge)
+				return WedgeMap[i].To;
+		}
+		return NONE;
+	}
+
+	//! Picks the vertex of a wedge at the welded position to.
+	/** Flat shaded wedges have one vertex per face normal, the one
+	closest to the normal of the replaced vertex is taken. */
+	u32 getWedgeVertex(u32 to, u32 wedge, u32 replaced) const
+	{
+		const core::vector3df& normal = getNormalOf(replaced);
+		u32 best = wedge;
+		f32 bestDot = -2.f;
+		for (u32 j=to; j!=NONE; j=GroupNext[j])
+		{
+			if (Wedges[j] != wedge)
+				continue;
+			const f32 d = getNormalOf(j).dotProduct(normal);
+			if (d > bestDot)
+			{
+				best = j;
+				bestDot = d;
+			}
+		}
+		return best;
+	}
+
+	const core::vector3df& getNormalOf(u32 v) const
+	{
+		return ((const video::S3DVertex*)(Vertices + v*Pitch))->Normal;
+	}
+
+	void init()
+	{
+		const u32 vcount = Positions.size();
+		const u32 tcount = TriangleAlive.size();
+
+		Quadrics.set_used(vcount);
+		Kind.set_used(vcount);
+		Stamp.set_used(vcount);
+		Removed.set_used(vcount);
+		// set_used does not construct the elements
+		VertexTriangles.clear();
+		VertexTriangles.reallocate(vcount);
+		BorderNeighbours.clear();
+		BorderNeighbours.reallocate(vcount);
+		for (u32 i=0; i<vcount; ++i)
+		{
+			VertexTriangles.push_back(core::array<u32>());
+			BorderNeighbours.push_back(core::array<u32>());
+			Quadrics[i].reset();
+			Kind[i] = ESV_MANIFOLD;
+			Stamp[i] = 0;
+			Removed[i] = false;
+		}
+
+		// face quadrics, weighted by area
+		core::array<SSimplifyEdge> edges;
+		edges.reallocate(LiveTriangles*3);
+		for (u32 t=0; t<tcount; ++t)
+		{
+			if (!TriangleAlive[t])
+				continue;
+
+			const u32* tri = &Indices[t*3];
+			core::vector3df normal = getNormal(tri[0], tri[1], tri[2]);
+			const f64 area = normal.getLength();
+			if (area > 0.0)
+			{
+				normal /= (f32)area;
+				SQuadric q;
+				q.setPlane(normal.X, normal.Y, normal.Z, -normal.dotProduct(Positions[tri[0]]), area*0.5);
+				for (u32 k=0; k<3; ++k)
+					Quadrics[tri[k]].add(q);
+			}
+
+			for (u32 k=0; k<3; ++k)
+			{
+				VertexTriangles[tri[k]].push_back(t);
+				edges.push_back(SSimplifyEdge(tri[k], tri[(k+1)%3], t));
+			}
+		}
+
+		// edges used by a single triangle form the open border, they get
+		// constraint planes keeping the outline in shape. Texture seams,
+		// where the wedges on both sides differ, are treated the same.
+		edges.sort();
+		for (u32 i=0; i<edges.size(); )
+		{
+			u32 j = i+1;
+			while (j<edges.size() && edges[j] == edges[i])
+				++j;
+
+			if (j-i == 1 || (j-i == 2 && isSeam(edges[i], edges[i+1].Triangle)))
+				addBorderEdge(edges[i].A, edges[i].B);
+			i = j;
+		}
+
+		// initial candidates, one per direction of each edge
+		Heap.set_used(0);
+		Heap.reallocate(edges.size());
+		for (u32 i=0; i<edges.size(); ++i)
+		{
+			if (i && edges[i] == edges[i-1])
+				continue;
+			addCandidate(edges[i].A, edges[i].B);
+			addCandidate(edges[i].B, edges[i].A);
+		}
+	}
+
+	core::vector3df getNormal(u32 a, u32 b, u32 c) const
+	{
+		return (Positions[b] - Positions[a]).crossProduct(Positions[c] - Positions[a]);
+	}
+
+	bool isSeam(const SSimplifyEdge& edge, u32 other) const
+	{
+		return Wedges[getCorner(edge.Triangle, edge.A)] != Wedges[getCorner(other, edge.A)] ||
+			Wedges[getCorner(edge.Triangle, edge.B)] != Wedges[getCorner(other, edge.B)];
+	}
+
+	void addBorderEdge(u32 a, u32 b)
+	{
+		Kind[a] = ESV_BORDER;
+		Kind[b] = ESV_BORDER;
+		BorderNeighbours[a].push_back(b);
+		BorderNeighbours[b].push_back(a);
+
+		// find the triangle of this edge for the plane orientation
+		const core::array<u32>& tris = VertexTriangles[a];
+		for (u32 i=0; i<tris.size(); ++i)
+		{
+			const u32* tri = &Indices[tris[i]*3];
+			if (tri[0] != b && tri[1] != b && tri[2] != b)
+				continue;
+
+			const core::vector3df edge = Positions[b] - Positions[a];
+			core::vector3df normal = edge.crossProduct(getNormal(tri[0], tri[1], tri[2]));
+			const f64 length = normal.getLength();
+			if (length <= 0.0)
+				return;
+			normal /= (f32)length;
+
+			SQuadric q;
+			q.setPlane(normal.X, normal.Y, normal.Z, -normal.dotProduct(Positions[a]),
+				edge.getLengthSQ() * BORDER_WEIGHT);
+			Quadrics[a].add(q);
+			Quadrics[b].add(q);
+			return;
+		}
+	}
+
+	bool isBorderEdge(u32 a, u32 b) const
+	{
+		return BorderNeighbours[a].linear_search(b) != -1;
+	}
+
+	void addCandidate(u32 from, u32 to)
+	{
+		if (Kind[from] == ESV_BORDER && !isBorderEdge(from, to))
+			return;
+
+		SQuadric q = Quadrics[from];
+		q.add(Quadrics[to]);
+
+		SEdgeCollapse c;
+		c.Cost = q.Weight > 0.0 ? q.evaluate(Positions[to]) / q.Weight : 0.0;
+		c.From = from;
+		c.To = to;
+		c.FromStamp = Stamp[from];
+		c.ToStamp = Stamp[to];
+		pushHeap(c);
+	}
+
+	//! checks if moving from onto to would turn a triangle over
+	bool flipsTriangles(u32 from, u32 to) const
+	{
+		const core::array<u32>& tris = VertexTriangles[from];
+		for (u32 i=0; i<tris.size(); ++i)
+		{
+			if (!TriangleAlive[tris[i]])
+				continue;
+
+			const u32* tri = &Indices[tris[i]*3];
+			if (tri[0] == to || tri[1] == to || tri[2] == to)
+				continue;
+
+			const core::vector3df before = getNormal(tri[0], tri[1], tri[2]);
+			const core::vector3df after = getNormal(
+				tri[0] == from ? to : tri[0],
+				tri[1] == from ? to : tri[1],
+				tri[2] == from ? to : tri[2]);
+
+			// reject flipped and nearly folded triangles
+			const f64 d = before.dotProduct(after);
+			if (d <= 0.0 || d*d < 0.04 * before.getLengthSQ() * after.getLengthSQ())
+				return true;
+		}
+		return false;
+	}
+
+	void collapse(u32 from, u32 to)
+	{
+		Quadrics[to].add(Quadrics[from]);
+		Removed[from] = true;
+
+		core::array<u32>& tris = VertexTriangles[from];
+		for (u32 i=0; i<tris.size(); ++i)
+		{
+			const u32 t = tris[i];
+			if (!TriangleAlive[t])
+				continue;
+
+			u32* tri = &Indices[t*3];
+			bool degenerate = false;
+			for (u32 k=0; k<3; ++k)
+			{
+				if (tri[k] == to)
+					degenerate = true;
+				else if (tri[k] == from)
+				{
+					tri[k] = to;
+					u32& corner = Corners[t*3+k];
+					corner = getWedgeVertex(to, findWedge(Wedges[corner]), corner);
+				}
+			}
+
+			if (degenerate)
+			{
+				TriangleAlive[t] = false;
+				--LiveTriangles;
+			}
+			else
+				VertexTriangles[to].push_back(t);
+		}
+		tris.clear();
+
+		// the border now continues at the target vertex
+		core::array<u32>& border = BorderNeighbours[from];
+		for (u32 i=0; i<border.size(); ++i)
+		{
+			const u32 n = border[i];
+			core::array<u32>& other = BorderNeighbours[n];
+			const s32 pos = other.linear_search(from);
+			if (pos != -1)
+				other.erase(pos);
+			if (n != to)
+			{
+				if (other.linear_search(to) == -1)
+					other.push_back(to);
+				if (BorderNeighbours[to].linear_search(n) == -1)
+					BorderNeighbours[to].push_back(n);
+			}
+		}
+		border.clear();
+
+		// costs of all edges around the target changed
+		++Stamp[to];
+		core::array<u32>& targetTris = VertexTriangles[to];
+		u32 used = 0;
+		for (u32 i=0; i<targetTris.size(); ++i)
+		{
+			const u32 t = targetTris[i];
+			if (!TriangleAlive[t])
+				continue;
+			targetTris[used++] = t;
+
+			const u32* tri = &Indices[t*3];
+			for (u32 k=0; k<3; ++k)
+			{
+				if (tri[k] == to)
+					continue;
+				addCandidate(to, tri[k]);
+				addCandidate(tri[k], to);
+			}
+		}
+		targetTris.set_used(used);
+	}
+
+	void pushHeap(const SEdgeCollapse& c)
+	{
+		u32 i = Heap.size();
+		Heap.push_back(c);
+		while (i)
+		{
+			const u32 parent = (i-1) / 2;
+			if (Heap[parent].Cost <= c.Cost)
+				break;
+			Heap[i] = Heap[parent];
+			i = parent;
+		}
+		Heap[i] = c;
+	}
+
+	void popHeap()
+	{
+		const SEdgeCollapse last = Heap.getLast();
+		Heap.set_used(Heap.size()-1);
+		const u32 size = Heap.size();
+		if (!size)
+			return;
+
+		u32 i = 0;
+		for (;;)
+		{
+			u32 child = i*2 + 1;
+			if (child >= size)
+				break;
+			if (child+1 < size && Heap[child+1].Cost < Heap[child].Cost)
+				++child;
+			if (last.Cost <= Heap[child].Cost)
+				break;
+			Heap[i] = Heap[child];
+			i = child;
+		}
+		Heap[i] = last;
+	}
+
+	//! weight of the border constraint planes relative to the faces
+	static const f64 BORDER_WEIGHT;
+
+	const u8* Vertices;
+	u32 Pitch;
+	video::E_VERTEX_TYPE VertexType;
+
+	core::array<core::vector3df> Positions;
+	//! welded triangles, using the first vertex of each position
+	core::array<u32> Indices;
+	//! vertices used by the triangle corners
+	core::array<u32> Corners;
+	//! first vertex of each position, next vertex at the same position and wedge
+	core::array<u32> Groups;
+	core::array<u32> GroupNext;
+	core::array<u32> Wedges;
+	core::array<SWedgePair> WedgeMap;
+	core::array<bool> TriangleAlive;
+	core::array<SQuadric> Quadrics;
+	core::array<u8> Kind;
+	core::array<u32> Stamp;
+	core::array<bool> Removed;
+	core::array< core::array<u32> > VertexTriangles;
+	core::array< core::array<u32> > BorderNeighbours;
+	core::array<SEdgeCollapse> Heap;
+	u32 LiveTriangles;
+};
+
+const f64 CMeshSimplifier::BORDER_WEIGHT = 10.0;
+
+
+template <class T>
+IMeshBuffer* createSimplifiedBuffer(const IMeshBuffer* mb,
+		const core::array<u32>& vertices, const core::array<u32>& indices)
+{
+	const T* src = (const T*)mb->getVertices();
+
+	if (vertices.size() > 65536)
+	{
+		CDynamicMeshBuffer* buffer = new CDynamicMeshBuffer(mb->getVertexType(), video::EIT_32BIT);
+		buffer->getVertexBuffer().reallocate(vertices.size());
+		for (u32 i=0; i<vertices.size(); ++i)
+			buffer->getVertexBuffer().push_back((const video::S3DVertex&)src[vertices[i]]);
+		buffer->getIndexBuffer().reallocate(indices.size());
+		for (u32 i=0; i<indices.size(); ++i)
+			buffer->getIndexBuffer().push_back(indices[i]);
+		return buffer;
+	}
+
+	CMeshBuffer<T>* buffer = new CMeshBuffer<T>();
+	buffer->Vertices.reallocate(vertices.size());
+	for (u32 i=0; i<vertices.size(); ++i)
+		buffer->Vertices.push_back(src[vertices[i]]);
+	buffer->Indices.reallocate(indices.size());
+	for (u32 i=0; i<indices.size(); ++i)
+		buffer->Indices.push_back((u16)indices[i]);
+	return buffer;
+}
+
+} // end anonymous namespace
+
+
+//! Creates a mesh with a reduced amount of triangles
+IMesh* CMeshManipulator::createMeshSimplified(IMesh* mesh, f32 triangleRatio, f32 maxError) const
+{
+	if (!mesh)
+		return 0;
+
+	triangleRatio = core::clamp(triangleRatio, 0.f, 1.f);
+
+	SMesh* clone = new SMesh();
+	core::array<u32> vertices;
+	core::array<u32> indices;
+
+	const u32 bcount = mesh->getMeshBufferCount();
+	for (u32 b=0; b<bcount; ++b)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(b);
+
+		CMeshSimplifier simplifier(mb);
+		simplifier.simplify(core::floor32(simplifier.getTriangleCount() * triangleRatio), maxError);
+		simplifier.getResult(vertices, indices);
+
+		IMeshBuffer* buffer = 0;
+		switch (mb->getVertexType())
+		{
+		case video::EVT_STANDARD:
+			buffer = createSimplifiedBuffer<video::S3DVertex>(mb, vertices, indices);
+			break;
+		case video::EVT_2TCOORDS:
+			buffer = createSimplifiedBuffer<video::S3DVertex2TCoords>(mb, vertices, indices);
+			break;
+		case video::EVT_TANGENTS:
+			buffer = createSimplifiedBuffer<video::S3DVertexTangents>(mb, vertices, indices);
+			break;
+		}
+
+		// empty buffers are kept, so that materials still match the source
+		buffer->getMaterial() = mb->getMaterial();
+		buffer->setHardwareMappingHint(mb->getHardwareMappingHint_Vertex(), EBT_VERTEX);
+		buffer->setHardwareMappingHint(mb->getHardwareMappingHint_Index(), EBT_INDEX);
+		buffer->recalculateBoundingBox();
+		clone->addMeshBuffer(buffer);
+		buffer->drop();
+	}
+
+	clone->recalculateBoundingBox();
+	return clone;
+}
+
+
+//! Creates a chain of increasingly simplified meshes
+u32 CMeshManipulator::createMeshLODChain(IMesh* mesh, core::array<IMesh*>& lods,
+		u32 levelCount, f32 reduction) const
+{
+	lods.clear();
+	if (!mesh || !levelCount)
+		return 0;
+
+	mesh->grab();
+	lods.push_back(mesh);
+
+	s32 polyCount = getPolyCount(mesh);
+	while (lods.size() < levelCount)
+	{
+		// each level starts from the previous one, which keeps the
+		// levels nested and is much faster than starting over
+		IMesh* lod = createMeshSimplified(lods.getLast(), reduction);
+		if (!lod)
+			break;
+
+		const s32 lodPolyCount = getPolyCount(lod);
+		if (lodPolyCount >= polyCount)
+		{
+			// nothing left to simplify
+			lod->drop();
+			break;
+		}
+
+		polyCount = lodPolyCount;
+		lods.push_back(lod);
+	}
+
+	return lods.size();
+}
+
 } // end namespace scene
 } // end namespace irr
 
@@ -35,6 +35,12 @@ public:
 	    \param smooth: Whether to use smoothed normals. */
 	virtual void recalculateNormals(IMeshBuffer* buffer, bool smooth = false, bool angleWeighted = false) const;
 
+	//! Recalculates smooth normals of the mesh, also across vertices sharing a position.
+	virtual void recalculateNormalsAcrossSeams(IMesh* mesh, bool angleWeighted = false) const;
+
+	//! Recalculates smooth normals of the mesh buffer, also across vertices sharing a position.
+	virtual void recalculateNormalsAcrossSeams(IMeshBuffer* buffer, bool angleWeighted = false) const;
+
 	//! Clones a static IMesh into a modifiable SMesh.
 	virtual SMesh* createMeshCopy(scene::IMesh* mesh) const;
 
@@ -86,6 +92,19 @@ public:
 
 	//! create a mesh optimized for the vertex cache
 	virtual IMesh* createForsythOptimizedMesh(const scene::IMesh *mesh) const;
+
+	//! Optimizes the order of triangles and vertices of a meshbuffer in place
+	virtual void optimizeMeshBuffer(IMeshBuffer* buffer, u32 flags=EMO_VERTEX_CACHE|EMO_VERTEX_FETCH) const;
+
+	//! Optimizes the order of triangles and vertices of all meshbuffers in place
+	virtual void optimizeMesh(IMesh* mesh, u32 flags=EMO_VERTEX_CACHE|EMO_VERTEX_FETCH) const;
+
+	//! Creates a mesh with a reduced amount of triangles
+	virtual IMesh* createMeshSimplified(IMesh* mesh, f32 triangleRatio, f32 maxError=0.f) const;
+
+	//! Creates a chain of increasingly simplified meshes
+	virtual u32 createMeshLODChain(IMesh* mesh, core::array<IMesh*>& lods,
+		u32 levelCount=4, f32 reduction=0.5f) const;
 };
 
 } // end namespace scene
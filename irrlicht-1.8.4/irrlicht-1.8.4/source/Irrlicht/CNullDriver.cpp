@@ -14,6 +14,8 @@
 #include "IAnimatedMeshSceneNode.h"
 #include "CMeshManipulator.h"
 #include "CColorConverter.h"
+#include "CTextureAtlas.h"
+#include "CTextureImageJob.h"
 #include "IAttributeExchangingObject.h"
 
 
@@ -401,6 +403,38 @@ u32 CNullDriver::getTextureCount() const
 }
 
 
+//! Returns the memory used by the textures in a color format
+u32 CNullDriver::getTextureMemory(ECOLOR_FORMAT format) const
+{
+	u32 size = 0;
+	for (u32 i=0; i<Textures.size(); ++i)
+		size += getTextureDataSize(Textures[i].Surface, format);
+
+	return size;
+}
+
+
+//! returns the memory used by the texture data in a color format
+u32 CNullDriver::getTextureDataSize(const ITexture* texture, ECOLOR_FORMAT format) const
+{
+	if (texture->getColorFormat() != format)
+		return 0;
+
+	const core::dimension2d<u32>& size = texture->getSize();
+	u32 bytes;
+	if (IImage::isCompressedFormat(format))
+		bytes = ((size.Width+3)/4) * ((size.Height+3)/4) * IImage::getBlockSizeFromFormat(format);
+	else
+		bytes = size.getArea() * IImage::getBitsPerPixelFromFormat(format) / 8;
+
+	// a full chain of mip map levels adds a third
+	if (texture->hasMipMaps())
+		bytes += bytes / 3;
+
+	return bytes;
+}
+
+
 //! Renames a texture
 void CNullDriver::renameTexture(ITexture* texture, const io::path& newName)
 {
@@ -497,20 +531,109 @@ ITexture* CNullDriver::getTexture(io::IReadFile* file)
 }
 
 
+//! loads many Textures, decoding them on the thread pool
+u32 CNullDriver::getTextures(const core::array<io::path>& filenames,
+	core::array<ITexture*>& outTextures)
+{
+	outTextures.set_used(filenames.size());
+	u32 loaded = 0;
+
+	CThreadPool* pool = CThreadPool::getSharedPool();
+	if (!pool || !pool->getThreadCount())
+	{
+		for (u32 i=0; i<filenames.size(); ++i)
+		{
+			outTextures[i] = getTexture(filenames[i]);
+			if (outTextures[i])
+				++loaded;
+		}
+		return loaded;
+	}
+
+	// one job per file which isn't loaded yet
+	core::array<CTextureImageJob> jobs;
+	core::array<s32> jobIndex;
+	jobIndex.set_used(filenames.size());
+	core::map<io::path, s32> queued;
+
+	for (u32 i=0; i<filenames.size(); ++i)
+	{
+		jobIndex[i] = -1;
+
+		CTextureImageJob job;
+		outTextures[i] = job.setFile(this, FileSystem, filenames[i]);
+		if (outTextures[i])
+			continue;
+
+		core::map<io::path, s32>::Node* node = queued.find(job.getAbsolutePath());
+		if (node)
+		{
+			jobIndex[i] = node->getValue();
+			continue;
+		}
+
+		jobIndex[i] = jobs.size();
+		queued.insert(job.getAbsolutePath(), jobs.size());
+		jobs.push_back(job);
+	}
+
+	// the jobs array doesn't grow anymore, so the jobs stay where they are
+	for (u32 j=0; j<jobs.size(); ++j)
+	{
+		if (jobs[j].prepare())
+			pool->addJob(&jobs[j], jobs[j].Group);
+	}
+
+	// the textures are created in the order of the files, each as soon as
+	// its image is decoded
+	for (u32 j=0; j<jobs.size(); ++j)
+	{
+		pool->waitForJobs(jobs[j].Group);
+		jobs[j].createTexture();
+	}
+
+	for (u32 i=0; i<filenames.size(); ++i)
+	{
+		if (jobIndex[i] != -1)
+			outTextures[i] = jobs[jobIndex[i]].getTexture();
+		if (outTextures[i])
+			++loaded;
+	}
+
+	return loaded;
+}
+
+
 //! opens the file and loads it into the surface
 video::ITexture* CNullDriver::loadTextureFromFile(io::IReadFile* file, const io::path& hashName )
 {
-	ITexture* texture = 0;
-	IImage* image = createImageFromFile(file);
+	IImage* image = loadImageFromFile(file, true);
+	if (!image)
+		return 0;
+
+	// create texture from surface
+	ITexture* texture = createLoadedTexture(image, hashName.size() ? hashName : file->getFileName() );
+	os::Printer::log("Loaded texture", file->getFileName());
 
-	if (image)
+	return texture;
+}
+
+
+//! creates a texture from an image loaded for it, and drops the image
+ITexture* CNullDriver::createLoadedTexture(IImage* image, const io::path& name)
+{
+	// drivers without compressed textures get the pixels
+	if (IImage::isCompressedFormat(image->getColorFormat()) &&
+		!queryFeature(EVDF_TEXTURE_COMPRESSED_DXT))
 	{
-		// create texture from surface
-		texture = createDeviceDependentTexture(image, hashName.size() ? hashName : file->getFileName() );
-		os::Printer::log("Loaded texture", file->getFileName());
+		IImage* pixels = createDecompressedImage(image);
 		image->drop();
+		image = pixels;
 	}
 
+	ITexture* texture = createDeviceDependentTexture(image, name);
+	image->drop();
+
 	return texture;
 }
 
@@ -539,11 +662,18 @@ void CNullDriver::addTexture(video::ITexture* texture)
 //! looks if the image is already loaded
 video::ITexture* CNullDriver::findTexture(const io::path& filename)
 {
-	SSurface s;
-	SDummyTexture dummy(filename);
-	s.Surface = &dummy;
+	return findTexture(filename.c_str());
+}
+
 
-	s32 index = Textures.binary_search(s);
+//! looks if the image is already loaded, without creating a path
+video::ITexture* CNullDriver::findTexture(const fschar_t* filename)
+{
+	if (!filename)
+		return 0;
+
+	Textures.sort();
+	s32 index = Textures.binary_search_key(filename, SSurface::compareName);
 	if (index != -1)
 		return Textures[index].Surface;
 
@@ -557,6 +687,16 @@ ITexture* CNullDriver::addTexture(const io::path& name, IImage* image, void* mip
 	if ( 0 == name.size() || !image)
 		return 0;
 
+	// drivers without compressed textures get the pixels
+	if (IImage::isCompressedFormat(image->getColorFormat()) &&
+		!queryFeature(EVDF_TEXTURE_COMPRESSED_DXT))
+	{
+		IImage* pixels = createDecompressedImage(image);
+		ITexture* t = addTexture(name, pixels);
+		pixels->drop();
+		return t;
+	}
+
 	ITexture* t = createDeviceDependentTexture(image, name, mipmapData);
 	if (t)
 	{
@@ -1313,12 +1453,53 @@ IImage* CNullDriver::createImageFromFile(const io::path& filename)
 
 //! Creates a software image from a file.
 IImage* CNullDriver::createImageFromFile(io::IReadFile* file)
+{
+	IImage* image = loadImageFromFile(file);
+
+	// the images are used per pixel
+	if (image && IImage::isCompressedFormat(image->getColorFormat()))
+	{
+		IImage* pixels = createDecompressedImage(image);
+		image->drop();
+		image = pixels;
+	}
+
+	return image;
+}
+
+
+//! Creates a software image from a file, to become a texture.
+IImage* CNullDriver::createTextureImageFromFile(io::IReadFile* file)
+{
+	return loadImageFromFile(file, true);
+}
+
+
+//! creates an A8R8G8B8 copy of a block compressed image
+IImage* CNullDriver::createDecompressedImage(IImage* image) const
+{
+	const core::dimension2d<u32>& dim = image->getDimension();
+	IImage* pixels = new CImage(ECF_A8R8G8B8, dim);
+	CColorConverter::convert_DXTtoA8R8G8B8(image->lock(), image->getColorFormat(),
+		dim.Width, dim.Height, pixels->lock());
+	image->unlock();
+	pixels->unlock();
+	return pixels;
+}
+
+
+//! loads an image with the image loaders, block compressed images stay compressed
+IImage* CNullDriver::loadImageFromFile(io::IReadFile* file, bool asTexture)
 {
 	if (!file)
 		return 0;
 
 	IImage* image = 0;
 
+	// textures get the pixels in their own format right away
+	const ECOLOR_FORMAT opaqueFormat = asTexture ? getTextureFormat(ECF_R8G8B8) : ECF_R8G8B8;
+	const ECOLOR_FORMAT alphaFormat = asTexture ? getTextureFormat(ECF_A8R8G8B8) : ECF_A8R8G8B8;
+
 	s32 i;
 
 	// try to load file based on file extension
@@ -1328,7 +1509,9 @@ IImage* CNullDriver::createImageFromFile(io::IReadFile* file)
 		{
 			// reset file position which might have changed due to previous loadImage calls
 			file->seek(0);
-			image = SurfaceLoader[i]->loadImage(file);
+			image = asTexture ?
+				SurfaceLoader[i]->loadTextureImage(file, opaqueFormat, alphaFormat) :
+				SurfaceLoader[i]->loadImage(file);
 			if (image)
 				return image;
 		}
@@ -1342,7 +1525,9 @@ IImage* CNullDriver::createImageFromFile(io::IReadFile* file)
 		if (SurfaceLoader[i]->isALoadableFileFormat(file))
 		{
 			file->seek(0);
-			image = SurfaceLoader[i]->loadImage(file);
+			image = asTexture ?
+				SurfaceLoader[i]->loadTextureImage(file, opaqueFormat, alphaFormat) :
+				SurfaceLoader[i]->loadImage(file);
 			if (image)
 				return image;
 		}
@@ -1478,6 +1663,14 @@ IImage* CNullDriver::createImage(ITexture* texture, const core::position2d<s32>&
 }
 
 
+//! Creates a texture atlas which packs images into shared textures.
+ITextureAtlas* CNullDriver::createTextureAtlas(const io::path& name,
+		const core::dimension2d<u32>& pageSize, u32 padding)
+{
+	return new CTextureAtlas(this, name, pageSize, padding);
+}
+
+
 //! Sets the fog mode.
 void CNullDriver::setFog(SColor color, E_FOG_TYPE fogType, f32 start, f32 end,
 		f32 density, bool pixelFog, bool rangeFog)
@@ -1520,6 +1713,158 @@ void CNullDriver::drawMeshBuffer(const scene::IMeshBuffer* mb)
 }
 
 
+namespace
+{
+
+inline SColor modulateColor(const SColor& a, const SColor& b)
+{
+	return SColor((a.getAlpha() * b.getAlpha()) / 255,
+		(a.getRed() * b.getRed()) / 255,
+		(a.getGreen() * b.getGreen()) / 255,
+		(a.getBlue() * b.getBlue()) / 255);
+}
+
+//! Transforms the normal with the inverse transpose, tangent and binormal lie
+//! in the surface and are transformed with the matrix itself
+template <class T>
+inline void transformVertexDirections(T& v, const core::matrix4& m,
+		const core::matrix4& normalMatrix, bool normalize)
+{
+	normalMatrix.rotateVect(v.Normal);
+	if (normalize)
+		v.Normal.normalize();
+}
+
+template <>
+inline void transformVertexDirections(S3DVertexTangents& v, const core::matrix4& m,
+		const core::matrix4& normalMatrix, bool normalize)
+{
+	normalMatrix.rotateVect(v.Normal);
+	m.rotateVect(v.Tangent);
+	m.rotateVect(v.Binormal);
+	if (normalize)
+	{
+		v.Normal.normalize();
+		v.Tangent.normalize();
+		v.Binormal.normalize();
+	}
+}
+
+//! writes transformed copies of the vertices of several instances
+template <class T>
+void expandInstances(T* dest, const T* src, u32 vertexCount,
+		const core::matrix4* transforms, const SColor* colors, u32 instanceCount)
+{
+	for (u32 k=0; k<instanceCount; ++k)
+	{
+		const core::matrix4& m = transforms[k];
+		const core::vector3df scale = m.getScale();
+		const bool normalize = !core::equals(scale.X, 1.f) ||
+			!core::equals(scale.Y, 1.f) || !core::equals(scale.Z, 1.f);
+
+		// rotations and uniform scales keep the directions of normals,
+		// other scales need the inverse transpose
+		core::matrix4 normalMatrix(m);
+		if (!core::equals(scale.X, scale.Y) || !core::equals(scale.X, scale.Z))
+		{
+			core::matrix4 inverse(core::matrix4::EM4CONST_NOTHING);
+			if (m.getInverse(inverse))
+				normalMatrix = inverse.getTransposed();
+		}
+
+		for (u32 i=0; i<vertexCount; ++i)
+		{
+			T& v = *dest++;
+			v = src[i];
+			m.transformVect(v.Pos);
+			transformVertexDirections(v, m, normalMatrix, normalize);
+			if (colors)
+				v.Color = modulateColor(v.Color, colors[k]);
+		}
+	}
+}
+
+} // end anonymous namespace
+
+
+//! Draws a mesh buffer several times with different transformations
+void CNullDriver::drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+		const core::matrix4* transforms, const SColor* colors, u32 instanceCount)
+{
+	if (!mb || !transforms || !instanceCount)
+		return;
+
+	const u32 vertexCount = mb->getVertexCount();
+	const u32 indexCount = mb->getIndexCount();
+	if (!vertexCount || !indexCount)
+		return;
+
+	const core::matrix4 world = getTransform(ETS_WORLD);
+
+	// instances are merged as long as two of them fit into 16bit indices,
+	// bigger buffers would not gain much anyway
+	const u32 batchSize = 65536 / vertexCount;
+	if (mb->getIndexType() != EIT_16BIT || batchSize < 2)
+	{
+		for (u32 k=0; k<instanceCount; ++k)
+		{
+			setTransform(ETS_WORLD, transforms[k]);
+			drawMeshBuffer(mb);
+		}
+		setTransform(ETS_WORLD, world);
+		return;
+	}
+
+	const u32 pitch = getVertexPitchFromType(mb->getVertexType());
+	const u16* indices = mb->getIndices();
+
+	// vertices are transformed to world space here
+	setTransform(ETS_WORLD, core::IdentityMatrix);
+
+	for (u32 first=0; first<instanceCount; first+=batchSize)
+	{
+		const u32 count = core::min_(batchSize, instanceCount-first);
+		const SColor* batchColors = colors ? colors+first : 0;
+
+		InstanceVertices.set_used(count*vertexCount*pitch);
+		switch (mb->getVertexType())
+		{
+		case EVT_STANDARD:
+			expandInstances((S3DVertex*)InstanceVertices.pointer(), (const S3DVertex*)mb->getVertices(),
+				vertexCount, transforms+first, batchColors, count);
+			break;
+		case EVT_2TCOORDS:
+			expandInstances((S3DVertex2TCoords*)InstanceVertices.pointer(), (const S3DVertex2TCoords*)mb->getVertices(),
+				vertexCount, transforms+first, batchColors, count);
+			break;
+		case EVT_TANGENTS:
+			expandInstances((S3DVertexTangents*)InstanceVertices.pointer(), (const S3DVertexTangents*)mb->getVertices(),
+				vertexCount, transforms+first, batchColors, count);
+			break;
+		}
+
+		// all batches but the last one have the same indices
+		if (InstanceIndices.size() != count*indexCount || first == 0)
+		{
+			InstanceIndices.set_used(count*indexCount);
+			u16* dest = InstanceIndices.pointer();
+			for (u32 k=0; k<count; ++k)
+			{
+				const u16 offset = (u16)(k*vertexCount);
+				for (u32 i=0; i<indexCount; ++i)
+					*dest++ = indices[i] + offset;
+			}
+		}
+
+		drawVertexPrimitiveList(InstanceVertices.const_pointer(), count*vertexCount,
+			InstanceIndices.const_pointer(), count*indexCount/3,
+			mb->getVertexType(), scene::EPT_TRIANGLES, EIT_16BIT);
+	}
+
+	setTransform(ETS_WORLD, world);
+}
+
+
 //! Draws the normals of a mesh buffer
 void CNullDriver::drawMeshBufferNormals(const scene::IMeshBuffer* mb, f32 length, SColor color)
 {
@@ -1544,7 +1889,7 @@ CNullDriver::SHWBufferLink *CNullDriver::getBufferLink(const scene::IMeshBuffer*
 		return 0;
 
 	//search for hardware links
-	core::map< const scene::IMeshBuffer*,SHWBufferLink* >::Node* node = HWBufferMap.find(mb);
+	core::hash_map< const scene::IMeshBuffer*,SHWBufferLink* >::Node* node = HWBufferMap.find(mb);
 	if (node)
 		return node->getValue();
 
@@ -1555,20 +1900,20 @@ CNullDriver::SHWBufferLink *CNullDriver::getBufferLink(const scene::IMeshBuffer*
 //! Update all hardware buffers, remove unused ones
 void CNullDriver::updateAllHardwareBuffers()
 {
-	core::map<const scene::IMeshBuffer*,SHWBufferLink*>::ParentFirstIterator Iterator=HWBufferMap.getParentFirstIterator();
+	core::hash_map<const scene::IMeshBuffer*,SHWBufferLink*>::Iterator Iterator=HWBufferMap.getIterator();
 
-	for (;!Iterator.atEnd();Iterator++)
+	while (!Iterator.atEnd())
 	{
 		SHWBufferLink *Link=Iterator.getNode()->getValue();
 
 		Link->LastUsed++;
 		if (Link->LastUsed>20000)
 		{
+			// the last link is moved into this place, so don't advance
 			deleteHardwareBuffer(Link);
-
-			// todo: needs better fix
-			Iterator = HWBufferMap.getParentFirstIterator();
 		}
+		else
+			Iterator++;
 	}
 }
 
@@ -1585,7 +1930,7 @@ void CNullDriver::deleteHardwareBuffer(SHWBufferLink *HWBuffer)
 //! Remove hardware buffer
 void CNullDriver::removeHardwareBuffer(const scene::IMeshBuffer* mb)
 {
-	core::map<const scene::IMeshBuffer*,SHWBufferLink*>::Node* node = HWBufferMap.find(mb);
+	core::hash_map<const scene::IMeshBuffer*,SHWBufferLink*>::Node* node = HWBufferMap.find(mb);
 	if (node)
 		deleteHardwareBuffer(node->getValue());
 }
@@ -1595,7 +1940,7 @@ void CNullDriver::removeHardwareBuffer(const scene::IMeshBuffer* mb)
 void CNullDriver::removeAllHardwareBuffers()
 {
 	while (HWBufferMap.size())
-		deleteHardwareBuffer(HWBufferMap.getRoot()->getValue());
+		deleteHardwareBuffer(HWBufferMap.getIterator()->getValue());
 }
 
 
@@ -2425,6 +2770,13 @@ core::dimension2du CNullDriver::getMaxTextureSize() const
 }
 
 
+//! Returns the color format the textures store images of a color format in
+ECOLOR_FORMAT CNullDriver::getTextureFormat(ECOLOR_FORMAT imageFormat) const
+{
+	return imageFormat;
+}
+
+
 //! Color conversion convenience function
 /** Convert an image (as array of pixels) from source to destination
 array, thereby converting the color format. The pixel size is
@@ -12,6 +12,7 @@
 #include "irrArray.h"
 #include "irrString.h"
 #include "irrMap.h"
+#include "irrHashMap.h"
 #include "IAttributes.h"
 #include "IMesh.h"
 #include "IMeshBuffer.h"
@@ -88,12 +89,19 @@ namespace video
 		//! loads a Texture
 		virtual ITexture* getTexture(io::IReadFile* file);
 
+		//! loads many Textures, decoding them on the thread pool
+		virtual u32 getTextures(const core::array<io::path>& filenames,
+			core::array<ITexture*>& outTextures);
+
 		//! Returns a texture by index
 		virtual ITexture* getTextureByIndex(u32 index);
 
 		//! Returns amount of textures currently loaded
 		virtual u32 getTextureCount() const;
 
+		//! Returns the memory used by the textures in a color format
+		virtual u32 getTextureMemory(ECOLOR_FORMAT format) const;
+
 		//! Renames a texture
 		virtual void renameTexture(ITexture* texture, const io::path& newName);
 
@@ -344,6 +352,9 @@ namespace video
 		//! Creates a software image from a file.
 		virtual IImage* createImageFromFile(io::IReadFile* file);
 
+		//! Creates a software image from a file, to become a texture.
+		virtual IImage* createTextureImageFromFile(io::IReadFile* file);
+
 		//! Creates a software image from a byte array.
 		/** \param useForeignMemory: If true, the image will use the data pointer
 		directly and own it from now on, which means it will also try to delete [] the
@@ -369,9 +380,17 @@ namespace video
 				const core::position2d<s32>& pos,
 				const core::dimension2d<u32>& size);
 
+		//! Creates a texture atlas which packs images into shared textures.
+		virtual ITextureAtlas* createTextureAtlas(const io::path& name,
+				const core::dimension2d<u32>& pageSize, u32 padding);
+
 		//! Draws a mesh buffer
 		virtual void drawMeshBuffer(const scene::IMeshBuffer* mb);
 
+		//! Draws a mesh buffer several times with different transformations
+		virtual void drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+			const core::matrix4* transforms, const SColor* colors, u32 instanceCount);
+
 		//! Draws the normals of a mesh buffer
 		virtual void drawMeshBufferNormals(const scene::IMeshBuffer* mb, f32 length=10.f, SColor color=0xffffffff);
 
@@ -604,6 +623,9 @@ namespace video
 		//! looks if the image is already loaded
 		virtual video::ITexture* findTexture(const io::path& filename);
 
+		//! Check if the image is already loaded, without creating a path
+		virtual video::ITexture* findTexture(const fschar_t* filename);
+
 		//! Set/unset a clipping plane.
 		//! There are at least 6 clipping planes available for the user to set at will.
 		//! \param index: The plane index. Must be between 0 and MaxUserClipPlanes.
@@ -643,6 +665,10 @@ namespace video
 		//! Returns the maximum texture size supported.
 		virtual core::dimension2du getMaxTextureSize() const;
 
+		//! Returns the color format the textures store images of a color format in
+		/** The image loaders decode the images of textures right into it. */
+		virtual ECOLOR_FORMAT getTextureFormat(ECOLOR_FORMAT imageFormat) const;
+
 		//! Color conversion convenience function
 		/** Convert an image (as array of pixels) from source to destination
 		array, thereby converting the color format. The pixel size is
@@ -669,6 +695,20 @@ namespace video
 		//! opens the file and loads it into the surface
 		video::ITexture* loadTextureFromFile(io::IReadFile* file, const io::path& hashName = "");
 
+		//! loads an image with the image loaders, block compressed images stay compressed
+		/** \param file File to load.
+		\param asTexture Decode the pixels in the color formats of the textures. */
+		IImage* loadImageFromFile(io::IReadFile* file, bool asTexture=false);
+
+		//! creates a texture from an image loaded for it, and drops the image
+		ITexture* createLoadedTexture(IImage* image, const io::path& name);
+
+		//! creates an A8R8G8B8 copy of a block compressed image
+		IImage* createDecompressedImage(IImage* image) const;
+
+		//! returns the memory used by the texture data in a color format
+		virtual u32 getTextureDataSize(const ITexture* texture, ECOLOR_FORMAT format) const;
+
 		//! adds a surface, not loaded or created by the Irrlicht Engine
 		void addTexture(video::ITexture* surface);
 
@@ -728,6 +768,12 @@ namespace video
 			{
 				return Surface->getName() < other.Surface->getName();
 			}
+
+			//! compares the name with a searched path, for binary_search_key
+			static s32 compareName(const SSurface& surface, const fschar_t* name)
+			{
+				return surface.Surface->getName().compareName(name);
+			}
 		};
 
 		struct SMaterialRenderer
@@ -815,7 +861,11 @@ namespace video
 		core::array<SMaterialRenderer> MaterialRenderers;
 
 		//core::array<SHWBufferLink*> HWBufferLinks;
-		core::map< const scene::IMeshBuffer* , SHWBufferLink* > HWBufferMap;
+		core::hash_map< const scene::IMeshBuffer* , SHWBufferLink* > HWBufferMap;
+
+		//! scratch buffers for merged instances, kept to avoid reallocations
+		core::array<u8> InstanceVertices;
+		core::array<u16> InstanceIndices;
 
 		io::IFileSystem* FileSystem;
 
@@ -236,7 +236,7 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 				}
 
 				int vertLocation;
-				core::map<video::S3DVertex, int>::Node* n = currMtl->VertMap.find(v);
+				core::hash_map<video::S3DVertex, int>::Node* n = currMtl->VertMap.find(v);
 				if (n)
 				{
 					vertLocation = n->getValue();
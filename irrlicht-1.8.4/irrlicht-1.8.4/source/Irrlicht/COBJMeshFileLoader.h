@@ -10,7 +10,7 @@
 #include "ISceneManager.h"
 #include "irrString.h"
 #include "SMeshBuffer.h"
-#include "irrMap.h"
+#include "irrHashMap.h"
 
 namespace irr
 {
@@ -61,7 +61,7 @@ private:
 			Meshbuffer->Material = o.Meshbuffer->Material;
 		}
 
-		core::map<video::S3DVertex, int> VertMap;
+		core::hash_map<video::S3DVertex, int> VertMap;
 		scene::SMeshBuffer *Meshbuffer;
 		core::stringc Name;
 		core::stringc Group;
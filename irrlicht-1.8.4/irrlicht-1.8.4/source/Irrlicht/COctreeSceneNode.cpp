@@ -23,7 +23,8 @@ namespace scene
 COctreeSceneNode::COctreeSceneNode(ISceneNode* parent, ISceneManager* mgr,
 					 s32 id, s32 minimalPolysPerNode)
 	: IMeshSceneNode(parent, mgr, id), StdOctree(0), LightMapOctree(0),
-	TangentsOctree(0), VertexType((video::E_VERTEX_TYPE)-1),
+	TangentsOctree(0), StdOctree32(0), LightMapOctree32(0), TangentsOctree32(0),
+	VertexType((video::E_VERTEX_TYPE)-1), IndexType(video::EIT_16BIT),
 	MinimalPolysPerNode(minimalPolysPerNode), Mesh(0), Shadow(0),
 	UseVBOs(OCTREE_USE_HARDWARE), UseVisibilityAndVBOs(OCTREE_USE_VISIBILITY),
 	BoxBased(OCTREE_BOX_BASED)
@@ -116,172 +117,104 @@ void COctreeSceneNode::render()
 		frust.transform(invTrans);
 	}
 
-	const core::aabbox3d<float> &box = frust.getBoundingBox();
+	const bool large = (IndexType == video::EIT_32BIT);
 
 	switch (VertexType)
 	{
 	case video::EVT_STANDARD:
-		{
-			if (BoxBased)
-				StdOctree->calculatePolys(box);
-			else
-				StdOctree->calculatePolys(frust);
-
-			const Octree<video::S3DVertex>::SIndexData* d = StdOctree->getIndexData();
-
-			for (u32 i=0; i<Materials.size(); ++i)
-			{
-				if ( 0 == d[i].CurrentSize )
-					continue;
-
-				const video::IMaterialRenderer* const rnd = driver->getMaterialRenderer(Materials[i].MaterialType);
-				const bool transparent = (rnd && rnd->isTransparent());
-
-				// only render transparent buffer if this is the transparent render pass
-				// and solid only in solid pass
-				if (transparent == isTransparentPass)
-				{
-					driver->setMaterial(Materials[i]);
-					driver->drawIndexedTriangleList(
-						&StdMeshes[i].Vertices[0], StdMeshes[i].Vertices.size(),
-						d[i].Indices, d[i].CurrentSize / 3);
-				}
-			}
-
-			// for debug purposes only
-			if (DebugDataVisible && !Materials.empty() && PassCount==1)
-			{
-				const core::aabbox3df& box = frust.getBoundingBox();
-				core::array< const core::aabbox3d<f32>* > boxes;
-				video::SMaterial m;
-				m.Lighting = false;
-				driver->setMaterial(m);
-				if ( DebugDataVisible & scene::EDS_BBOX_BUFFERS )
-				{
-					StdOctree->getBoundingBoxes(box, boxes);
-					for (u32 b=0; b!=boxes.size(); ++b)
-						driver->draw3DBox(*boxes[b]);
-				}
-
-				if ( DebugDataVisible & scene::EDS_BBOX )
-					driver->draw3DBox(Box,video::SColor(0,255,0,0));
-			}
-		}
+		if (large)
+			renderTree(StdOctree32, StdMeshes32, frust, isTransparentPass);
+		else
+			renderTree(StdOctree, StdMeshes, frust, isTransparentPass);
 		break;
 	case video::EVT_2TCOORDS:
-		{
-			if (BoxBased)
-				LightMapOctree->calculatePolys(box);
-			else
-				LightMapOctree->calculatePolys(frust);
+		if (large)
+			renderTree(LightMapOctree32, LightMapMeshes32, frust, isTransparentPass);
+		else
+			renderTree(LightMapOctree, LightMapMeshes, frust, isTransparentPass);
+		break;
+	case video::EVT_TANGENTS:
+		if (large)
+			renderTree(TangentsOctree32, TangentsMeshes32, frust, isTransparentPass);
+		else
+			renderTree(TangentsOctree, TangentsMeshes, frust, isTransparentPass);
+		break;
+	}
+}
 
-			const Octree<video::S3DVertex2TCoords>::SIndexData* d = LightMapOctree->getIndexData();
 
-			for (u32 i=0; i<Materials.size(); ++i)
-			{
-				if ( 0 == d[i].CurrentSize )
-					continue;
+//! draws the visible part of the octree
+template <class T, class TIndex>
+void COctreeSceneNode::renderTree(Octree<T, TIndex>* tree,
+		core::array<typename Octree<T, TIndex>::SMeshChunk>& meshes,
+		const SViewFrustum& frust, bool isTransparentPass)
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	const core::aabbox3d<float> &box = frust.getBoundingBox();
 
-				const video::IMaterialRenderer* const rnd = driver->getMaterialRenderer(Materials[i].MaterialType);
-				const bool transparent = (rnd && rnd->isTransparent());
+	if (BoxBased)
+		tree->calculatePolys(box);
+	else
+		tree->calculatePolys(frust);
 
-				// only render transparent buffer if this is the transparent render pass
-				// and solid only in solid pass
-				if (transparent == isTransparentPass)
-				{
-					driver->setMaterial(Materials[i]);
-					if (UseVBOs)
-					{
-						if (UseVisibilityAndVBOs)
-						{
-							u16* oldPointer = LightMapMeshes[i].Indices.pointer();
-							const u32 oldSize = LightMapMeshes[i].Indices.size();
-							LightMapMeshes[i].Indices.set_free_when_destroyed(false);
-							LightMapMeshes[i].Indices.set_pointer(d[i].Indices, d[i].CurrentSize, false, false);
-							LightMapMeshes[i].setDirty(scene::EBT_INDEX);
-							driver->drawMeshBuffer ( &LightMapMeshes[i] );
-							LightMapMeshes[i].Indices.set_pointer(oldPointer, oldSize);
-							LightMapMeshes[i].setDirty(scene::EBT_INDEX);
-						}
-						else
-							driver->drawMeshBuffer ( &LightMapMeshes[i] );
-					}
-					else
-						driver->drawIndexedTriangleList(
-							&LightMapMeshes[i].Vertices[0],
-							LightMapMeshes[i].Vertices.size(),
-							d[i].Indices, d[i].CurrentSize / 3);
-				}
-			}
+	const typename Octree<T, TIndex>::SIndexData* d = tree->getIndexData();
 
-			// for debug purposes only
-			if (DebugDataVisible && !Materials.empty() && PassCount==1)
-			{
-				const core::aabbox3d<float> &box = frust.getBoundingBox();
-				core::array< const core::aabbox3d<f32>* > boxes;
-				video::SMaterial m;
-				m.Lighting = false;
-				driver->setMaterial(m);
-				if ( DebugDataVisible & scene::EDS_BBOX_BUFFERS )
-				{
-					LightMapOctree->getBoundingBoxes(box, boxes);
-					for (u32 b=0; b<boxes.size(); ++b)
-						driver->draw3DBox(*boxes[b]);
-				}
+	// meshbuffers only hold 16 bit indices, so VBOs can't be used for larger trees
+	const bool useVBOs = UseVBOs && (sizeof(TIndex) == sizeof(u16));
 
-				if ( DebugDataVisible & scene::EDS_BBOX )
-					driver->draw3DBox(Box,video::SColor(0,255,0,0));
-			}
-		}
-		break;
-	case video::EVT_TANGENTS:
-		{
-			if (BoxBased)
-				TangentsOctree->calculatePolys(box);
-			else
-				TangentsOctree->calculatePolys(frust);
+	for (u32 i=0; i<Materials.size(); ++i)
+	{
+		if ( 0 == d[i].CurrentSize )
+			continue;
 
-			const Octree<video::S3DVertexTangents>::SIndexData* d =  TangentsOctree->getIndexData();
+		const video::IMaterialRenderer* const rnd = driver->getMaterialRenderer(Materials[i].MaterialType);
+		const bool transparent = (rnd && rnd->isTransparent());
 
-			for (u32 i=0; i<Materials.size(); ++i)
+		// only render transparent buffer if this is the transparent render pass
+		// and solid only in solid pass
+		if (transparent == isTransparentPass)
+		{
+			driver->setMaterial(Materials[i]);
+			if (useVBOs)
 			{
-				if ( 0 == d[i].CurrentSize )
-					continue;
-
-				const video::IMaterialRenderer* const rnd = driver->getMaterialRenderer(Materials[i].MaterialType);
-				const bool transparent = (rnd && rnd->isTransparent());
-
-				// only render transparent buffer if this is the transparent render pass
-				// and solid only in solid pass
-				if (transparent == isTransparentPass)
+				if (UseVisibilityAndVBOs)
 				{
-					driver->setMaterial(Materials[i]);
-					driver->drawIndexedTriangleList(
-						&TangentsMeshes[i].Vertices[0], TangentsMeshes[i].Vertices.size(),
-						d[i].Indices, d[i].CurrentSize / 3);
+					u16* oldPointer = meshes[i].Indices.pointer();
+					const u32 oldSize = meshes[i].Indices.size();
+					meshes[i].Indices.set_free_when_destroyed(false);
+					meshes[i].Indices.set_pointer((u16*)d[i].Indices, d[i].CurrentSize, false, false);
+					meshes[i].setDirty(scene::EBT_INDEX);
+					driver->drawMeshBuffer ( &meshes[i] );
+					meshes[i].Indices.set_pointer(oldPointer, oldSize);
+					meshes[i].setDirty(scene::EBT_INDEX);
 				}
+				else
+					driver->drawMeshBuffer ( &meshes[i] );
 			}
+			else
+				driver->drawVertexPrimitiveList(
+					meshes[i].Vertices.const_pointer(), meshes[i].Vertices.size(),
+					d[i].Indices, d[i].CurrentSize / 3, meshes[i].getVertexType(),
+					scene::EPT_TRIANGLES, IndexType);
+		}
+	}
 
-			// for debug purposes only
-			if (DebugDataVisible && !Materials.empty() && PassCount==1)
-			{
-				const core::aabbox3d<float> &box = frust.getBoundingBox();
-				core::array< const core::aabbox3d<f32>* > boxes;
-				video::SMaterial m;
-				m.Lighting = false;
-				driver->setMaterial(m);
-				if ( DebugDataVisible & scene::EDS_BBOX_BUFFERS )
-				{
-					TangentsOctree->getBoundingBoxes(box, boxes);
-					for (u32 b=0; b<boxes.size(); ++b)
-						driver->draw3DBox(*boxes[b]);
-				}
-
-				if ( DebugDataVisible & scene::EDS_BBOX )
-					driver->draw3DBox(Box,video::SColor(0,255,0,0));
-			}
+	// for debug purposes only
+	if (DebugDataVisible && !Materials.empty() && PassCount==1)
+	{
+		core::array< const core::aabbox3d<f32>* > boxes;
+		video::SMaterial m;
+		m.Lighting = false;
+		driver->setMaterial(m);
+		if ( DebugDataVisible & scene::EDS_BBOX_BUFFERS )
+		{
+			tree->getBoundingBoxes(box, boxes);
+			for (u32 b=0; b!=boxes.size(); ++b)
+				driver->draw3DBox(*boxes[b]);
 		}
-		break;
+
+		if ( DebugDataVisible & scene::EDS_BBOX )
+			driver->draw3DBox(Box,video::SColor(0,255,0,0));
 	}
 }
 
@@ -327,8 +260,142 @@ const core::aabbox3d<f32>& COctreeSceneNode::getBoundingBox() const
 }
 
 
+namespace
+{
+	// copy the vertices of a meshbuffer, converting them to the vertex type of the octree
+	void appendVertices(core::array<video::S3DVertex>& out, const IMeshBuffer* b)
+	{
+		u32 v;
+		switch (b->getVertexType())
+		{
+		case video::EVT_STANDARD:
+			for (v=0; v<b->getVertexCount(); ++v)
+				out.push_back(((video::S3DVertex*)b->getVertices())[v]);
+			break;
+		case video::EVT_2TCOORDS:
+			for (v=0; v<b->getVertexCount(); ++v)
+				out.push_back(((video::S3DVertex2TCoords*)b->getVertices())[v]);
+			break;
+		case video::EVT_TANGENTS:
+			for (v=0; v<b->getVertexCount(); ++v)
+				out.push_back(((video::S3DVertexTangents*)b->getVertices())[v]);
+			break;
+		}
+	}
+
+	void appendVertices(core::array<video::S3DVertex2TCoords>& out, const IMeshBuffer* b)
+	{
+		u32 v;
+		switch (b->getVertexType())
+		{
+		case video::EVT_STANDARD:
+			for (v=0; v<b->getVertexCount(); ++v)
+				out.push_back(((video::S3DVertex*)b->getVertices())[v]);
+			break;
+		case video::EVT_2TCOORDS:
+			for (v=0; v<b->getVertexCount(); ++v)
+				out.push_back(((video::S3DVertex2TCoords*)b->getVertices())[v]);
+			break;
+		case video::EVT_TANGENTS:
+			for (v=0; v<b->getVertexCount(); ++v)
+				out.push_back(((video::S3DVertexTangents*)b->getVertices())[v]);
+			break;
+		}
+	}
+
+	void appendVertices(core::array<video::S3DVertexTangents>& out, const IMeshBuffer* b)
+	{
+		u32 v;
+		switch (b->getVertexType())
+		{
+		case video::EVT_STANDARD:
+			for (v=0; v<b->getVertexCount(); ++v)
+			{
+				const video::S3DVertex& tmpV = ((video::S3DVertex*)b->getVertices())[v];
+				out.push_back(video::S3DVertexTangents(tmpV.Pos, tmpV.Color, tmpV.TCoords));
+			}
+			break;
+		case video::EVT_2TCOORDS:
+			for (v=0; v<b->getVertexCount(); ++v)
+			{
+				const video::S3DVertex2TCoords& tmpV = ((video::S3DVertex2TCoords*)b->getVertices())[v];
+				out.push_back(video::S3DVertexTangents(tmpV.Pos, tmpV.Color, tmpV.TCoords));
+			}
+			break;
+		case video::EVT_TANGENTS:
+			for (v=0; v<b->getVertexCount(); ++v)
+				out.push_back(((video::S3DVertexTangents*)b->getVertices())[v]);
+			break;
+		}
+	}
+}
+
+
+//! fills the chunks from the mesh and builds the octree over them
+template <class T, class TIndex>
+u32 COctreeSceneNode::buildTree(IMesh* mesh, Octree<T, TIndex>*& tree,
+		core::array<typename Octree<T, TIndex>::SMeshChunk>& meshes)
+{
+	u32 polyCount = 0;
+
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+	{
+		IMeshBuffer* b = mesh->getMeshBuffer(i);
+
+		if (!b->getVertexCount() || !b->getIndexCount())
+			continue;
+
+		Materials.push_back(b->getMaterial());
+		meshes.push_back(typename Octree<T, TIndex>::SMeshChunk());
+		typename Octree<T, TIndex>::SMeshChunk& nchunk = meshes.getLast();
+		nchunk.MaterialId = Materials.size() - 1;
+
+		if (UseVisibilityAndVBOs)
+		{
+			nchunk.setHardwareMappingHint(scene::EHM_STATIC, scene::EBT_VERTEX);
+			nchunk.setHardwareMappingHint(scene::EHM_DYNAMIC, scene::EBT_INDEX);
+		}
+		else
+			nchunk.setHardwareMappingHint(scene::EHM_STATIC);
+
+		nchunk.Vertices.reallocate(b->getVertexCount());
+		appendVertices(nchunk.Vertices, b);
+
+		const u32 idxCnt = b->getIndexCount();
+		polyCount += idxCnt;
+
+		if (sizeof(TIndex) == sizeof(u16))
+		{
+			nchunk.Indices.reallocate(idxCnt);
+			for (u32 v=0; v<idxCnt; ++v)
+				nchunk.Indices.push_back(b->getIndices()[v]);
+		}
+		else
+		{
+			nchunk.LargeIndices.reallocate(idxCnt);
+			if (b->getIndexType() == video::EIT_32BIT)
+			{
+				const u32* indices = (const u32*)b->getIndices();
+				for (u32 v=0; v<idxCnt; ++v)
+					nchunk.LargeIndices.push_back(indices[v]);
+			}
+			else
+			{
+				for (u32 v=0; v<idxCnt; ++v)
+					nchunk.LargeIndices.push_back(b->getIndices()[v]);
+			}
+		}
+	}
+
+	tree = new Octree<T, TIndex>(meshes, MinimalPolysPerNode);
+	return polyCount;
+}
+
+
 //! creates the tree
-/* This method has a lot of duplication and overhead. Moreover, the tangents mesh conversion does not really work. I think we need a a proper mesh implementation for octrees, which handle all vertex types internally. Converting all structures to just one vertex type is always problematic.
+/* Meshes with 32 bit index buffers get octrees with 32 bit indices, so
+large merged meshes can be used without splitting them up.
+The tangents mesh conversion does not really work. I think we need a proper mesh implementation for octrees, which handle all vertex types internally. Converting all structures to just one vertex type is always problematic.
 Thanks to Auria for fixing major parts of this method. */
 bool COctreeSceneNode::createTree(IMesh* mesh)
 {
@@ -352,8 +419,9 @@ bool COctreeSceneNode::createTree(IMesh* mesh)
 
 	if (mesh->getMeshBufferCount())
 	{
-		// check for "larger" buffer types
+		// check for "larger" buffer and index types
 		VertexType = video::EVT_STANDARD;
+		IndexType = video::EIT_16BIT;
 		u32 meshReserve = 0;
 		for (i=0; i<mesh->getMeshBufferCount(); ++i)
 		{
@@ -365,156 +433,55 @@ bool COctreeSceneNode::createTree(IMesh* mesh)
 					VertexType = video::EVT_2TCOORDS;
 				else if (b->getVertexType() == video::EVT_TANGENTS)
 					VertexType = video::EVT_TANGENTS;
+				if (b->getIndexType() == video::EIT_32BIT)
+					IndexType = video::EIT_32BIT;
 			}
 		}
 		Materials.reallocate(Materials.size()+meshReserve);
 
+		const bool large = (IndexType == video::EIT_32BIT);
+
 		switch(VertexType)
 		{
 		case video::EVT_STANDARD:
+			if (large)
+			{
+				StdMeshes32.reallocate(StdMeshes32.size() + meshReserve);
+				polyCount = buildTree(mesh, StdOctree32, StdMeshes32);
+				nodeCount = StdOctree32->getNodeCount();
+			}
+			else
 			{
 				StdMeshes.reallocate(StdMeshes.size() + meshReserve);
-				for (i=0; i<mesh->getMeshBufferCount(); ++i)
-				{
-					IMeshBuffer* b = mesh->getMeshBuffer(i);
-
-					if (b->getVertexCount() && b->getIndexCount())
-					{
-						Materials.push_back(b->getMaterial());
-
-						StdMeshes.push_back(Octree<video::S3DVertex>::SMeshChunk());
-						Octree<video::S3DVertex>::SMeshChunk &nchunk = StdMeshes.getLast();
-						nchunk.MaterialId = Materials.size() - 1;
-
-						u32 v;
-						nchunk.Vertices.reallocate(b->getVertexCount());
-						switch (b->getVertexType())
-						{
-						case video::EVT_STANDARD:
-							for (v=0; v<b->getVertexCount(); ++v)
-								nchunk.Vertices.push_back(((video::S3DVertex*)b->getVertices())[v]);
-							break;
-						case video::EVT_2TCOORDS:
-							for (v=0; v<b->getVertexCount(); ++v)
-								nchunk.Vertices.push_back(((video::S3DVertex2TCoords*)b->getVertices())[v]);
-							break;
-						case video::EVT_TANGENTS:
-							for (v=0; v<b->getVertexCount(); ++v)
-								nchunk.Vertices.push_back(((video::S3DVertexTangents*)b->getVertices())[v]);
-							break;
-						}
-
-						polyCount += b->getIndexCount();
-
-						nchunk.Indices.reallocate(b->getIndexCount());
-						for (v=0; v<b->getIndexCount(); ++v)
-							nchunk.Indices.push_back(b->getIndices()[v]);
-					}
-				}
-
-				StdOctree = new Octree<video::S3DVertex>(StdMeshes, MinimalPolysPerNode);
+				polyCount = buildTree(mesh, StdOctree, StdMeshes);
 				nodeCount = StdOctree->getNodeCount();
 			}
 			break;
 		case video::EVT_2TCOORDS:
+			if (large)
+			{
+				LightMapMeshes32.reallocate(LightMapMeshes32.size() + meshReserve);
+				polyCount = buildTree(mesh, LightMapOctree32, LightMapMeshes32);
+				nodeCount = LightMapOctree32->getNodeCount();
+			}
+			else
 			{
 				LightMapMeshes.reallocate(LightMapMeshes.size() + meshReserve);
-
-				for ( i=0; i < mesh->getMeshBufferCount(); ++i)
-				{
-					IMeshBuffer* b = mesh->getMeshBuffer(i);
-
-					if (b->getVertexCount() && b->getIndexCount())
-					{
-						Materials.push_back(b->getMaterial());
-						LightMapMeshes.push_back(Octree<video::S3DVertex2TCoords>::SMeshChunk());
-						Octree<video::S3DVertex2TCoords>::SMeshChunk& nchunk = LightMapMeshes.getLast();
-						nchunk.MaterialId = Materials.size() - 1;
-
-						if (UseVisibilityAndVBOs)
-						{
-							nchunk.setHardwareMappingHint(scene::EHM_STATIC, scene::EBT_VERTEX);
-							nchunk.setHardwareMappingHint(scene::EHM_DYNAMIC, scene::EBT_INDEX);
-						}
-						else
-							nchunk.setHardwareMappingHint(scene::EHM_STATIC);
-
-						u32 v;
-						nchunk.Vertices.reallocate(b->getVertexCount());
-						switch (b->getVertexType())
-						{
-						case video::EVT_STANDARD:
-							for (v=0; v<b->getVertexCount(); ++v)
-								nchunk.Vertices.push_back(((video::S3DVertex*)b->getVertices())[v]);
-							break;
-						case video::EVT_2TCOORDS:
-							for (v=0; v<b->getVertexCount(); ++v)
-								nchunk.Vertices.push_back(((video::S3DVertex2TCoords*)b->getVertices())[v]);
-							break;
-						case video::EVT_TANGENTS:
-							for (v=0; v<b->getVertexCount(); ++v)
-								nchunk.Vertices.push_back(((video::S3DVertexTangents*)b->getVertices())[v]);
-							break;
-						}
-
-						polyCount += b->getIndexCount();
-						nchunk.Indices.reallocate(b->getIndexCount());
-						for (v=0; v<b->getIndexCount(); ++v)
-							nchunk.Indices.push_back(b->getIndices()[v]);
-					}
-				}
-
-				LightMapOctree = new Octree<video::S3DVertex2TCoords>(LightMapMeshes, MinimalPolysPerNode);
+				polyCount = buildTree(mesh, LightMapOctree, LightMapMeshes);
 				nodeCount = LightMapOctree->getNodeCount();
 			}
 			break;
 		case video::EVT_TANGENTS:
+			if (large)
+			{
+				TangentsMeshes32.reallocate(TangentsMeshes32.size() + meshReserve);
+				polyCount = buildTree(mesh, TangentsOctree32, TangentsMeshes32);
+				nodeCount = TangentsOctree32->getNodeCount();
+			}
+			else
 			{
 				TangentsMeshes.reallocate(TangentsMeshes.size() + meshReserve);
-
-				for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
-				{
-					IMeshBuffer* b = mesh->getMeshBuffer(i);
-
-					if (b->getVertexCount() && b->getIndexCount())
-					{
-						Materials.push_back(b->getMaterial());
-						TangentsMeshes.push_back(Octree<video::S3DVertexTangents>::SMeshChunk());
-						Octree<video::S3DVertexTangents>::SMeshChunk& nchunk = TangentsMeshes.getLast();
-						nchunk.MaterialId = Materials.size() - 1;
-
-						u32 v;
-						nchunk.Vertices.reallocate(b->getVertexCount());
-						switch (b->getVertexType())
-						{
-						case video::EVT_STANDARD:
-							for (v=0; v<b->getVertexCount(); ++v)
-							{
-								const video::S3DVertex& tmpV = ((video::S3DVertex*)b->getVertices())[v];
-								nchunk.Vertices.push_back(video::S3DVertexTangents(tmpV.Pos, tmpV.Color, tmpV.TCoords));
-							}
-							break;
-						case video::EVT_2TCOORDS:
-							for (v=0; v<b->getVertexCount(); ++v)
-							{
-								const video::S3DVertex2TCoords& tmpV = ((video::S3DVertex2TCoords*)b->getVertices())[v];
-								nchunk.Vertices.push_back(video::S3DVertexTangents(tmpV.Pos, tmpV.Color, tmpV.TCoords));
-							}
-							break;
-						case video::EVT_TANGENTS:
-							for (v=0; v<b->getVertexCount(); ++v)
-								nchunk.Vertices.push_back(((video::S3DVertexTangents*)b->getVertices())[v]);
-							break;
-						}
-
-						polyCount += b->getIndexCount();
-						nchunk.Indices.reallocate(b->getIndexCount());
-						for (v=0; v<b->getIndexCount(); ++v)
-							nchunk.Indices.push_back(b->getIndices()[v]);
-					}
-				}
-
-				TangentsOctree = new Octree<video::S3DVertexTangents>(TangentsMeshes, MinimalPolysPerNode);
+				polyCount = buildTree(mesh, TangentsOctree, TangentsMeshes);
 				nodeCount = TangentsOctree->getNodeCount();
 			}
 			break;
@@ -604,6 +571,18 @@ void COctreeSceneNode::deleteTree()
 	TangentsOctree = 0;
 	TangentsMeshes.clear();
 
+	delete StdOctree32;
+	StdOctree32 = 0;
+	StdMeshes32.clear();
+
+	delete LightMapOctree32;
+	LightMapOctree32 = 0;
+	LightMapMeshes32.clear();
+
+	delete TangentsOctree32;
+	TangentsOctree32 = 0;
+	TangentsMeshes32.clear();
+
 	Materials.clear();
 
 	if(Mesh)
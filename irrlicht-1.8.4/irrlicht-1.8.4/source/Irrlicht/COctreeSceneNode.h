@@ -80,6 +80,17 @@ namespace scene
 
 		void deleteTree();
 
+		//! fills the chunks from the mesh and builds the octree over them
+		template <class T, class TIndex>
+		u32 buildTree(IMesh* mesh, Octree<T, TIndex>*& tree,
+			core::array<typename Octree<T, TIndex>::SMeshChunk>& meshes);
+
+		//! draws the visible part of the octree
+		template <class T, class TIndex>
+		void renderTree(Octree<T, TIndex>* tree,
+			core::array<typename Octree<T, TIndex>::SMeshChunk>& meshes,
+			const SViewFrustum& frust, bool isTransparentPass);
+
 		core::aabbox3d<f32> Box;
 
 		Octree<video::S3DVertex>* StdOctree;
@@ -91,7 +102,18 @@ namespace scene
 		Octree<video::S3DVertexTangents>* TangentsOctree;
 		core::array< Octree<video::S3DVertexTangents>::SMeshChunk > TangentsMeshes;
 
+		// octrees used when the mesh has buffers with 32 bit indices
+		Octree<video::S3DVertex, u32>* StdOctree32;
+		core::array< Octree<video::S3DVertex, u32>::SMeshChunk > StdMeshes32;
+
+		Octree<video::S3DVertex2TCoords, u32>* LightMapOctree32;
+		core::array< Octree<video::S3DVertex2TCoords, u32>::SMeshChunk > LightMapMeshes32;
+
+		Octree<video::S3DVertexTangents, u32>* TangentsOctree32;
+		core::array< Octree<video::S3DVertexTangents, u32>::SMeshChunk > TangentsMeshes32;
+
 		video::E_VERTEX_TYPE VertexType;
+		video::E_INDEX_TYPE IndexType;
 		core::array< video::SMaterial > Materials;
 
 		core::stringc MeshName;
@@ -134,7 +134,10 @@ void COctreeTriangleSelector::getTriangles(core::triangle3df* triangles,
 
 	if (Root)
 		getTrianglesFromOctree(Root, trianglesWritten,
-			arraySize, invbox, &mat, triangles);
+			arraySize, invbox, triangles);
+
+	// transform all found triangles at once
+	mat.transformTriangles(triangles, triangles, trianglesWritten);
 
 	outTriangleCount = trianglesWritten;
 }
@@ -143,7 +146,7 @@ void COctreeTriangleSelector::getTriangles(core::triangle3df* triangles,
 void COctreeTriangleSelector::getTrianglesFromOctree(
 		SOctreeNode* node, s32& trianglesWritten,
 		s32 maximumSize, const core::aabbox3d<f32>& box,
-		const core::matrix4* mat, core::triangle3df* triangles) const
+		core::triangle3df* triangles) const
 {
 	if (!box.intersectsWithBox(node->Box))
 		return;
@@ -158,10 +161,7 @@ void COctreeTriangleSelector::getTrianglesFromOctree(
 		if (srcTri.isTotalOutsideBox(box))
 			continue;
 
-		core::triangle3df& dstTri = triangles[trianglesWritten];
-		mat->transformVect(dstTri.pointA, srcTri.pointA );
-		mat->transformVect(dstTri.pointB, srcTri.pointB );
-		mat->transformVect(dstTri.pointC, srcTri.pointC );
+		triangles[trianglesWritten] = srcTri;
 		++trianglesWritten;
 
 		// Halt when the out array is full.
@@ -172,7 +172,7 @@ void COctreeTriangleSelector::getTrianglesFromOctree(
 	for (u32 i=0; i<8; ++i)
 		if (node->Child[i])
 			getTrianglesFromOctree(node->Child[i], trianglesWritten,
-			maximumSize, box, mat, triangles);
+			maximumSize, box, triangles);
 }
 
 
@@ -243,14 +243,9 @@ void COctreeTriangleSelector::getTrianglesFromOctree(SOctreeNode* node,
 	}
 	else
 	{
-		for (i=0; i<cnt; ++i)
-		{
-			triangles[trianglesWritten] = node->Triangles[i];
-			transform->transformVect(triangles[trianglesWritten].pointA);
-			transform->transformVect(triangles[trianglesWritten].pointB);
-			transform->transformVect(triangles[trianglesWritten].pointC);
-			++trianglesWritten;
-		}
+		transform->transformTriangles(triangles + trianglesWritten,
+			node->Triangles.const_pointer(), cnt);
+		trianglesWritten += cnt;
 	}
 
 	for (i=0; i<8; ++i)
@@ -59,7 +59,6 @@ private:
 	void deleteEmptyNodes(SOctreeNode* node);
 	void getTrianglesFromOctree(SOctreeNode* node, s32& trianglesWritten,
 			s32 maximumSize, const core::aabbox3d<f32>& box,
-			const core::matrix4* transform,
 			core::triangle3df* triangles) const;
 
 	void getTrianglesFromOctree(SOctreeNode* node, s32& trianglesWritten,
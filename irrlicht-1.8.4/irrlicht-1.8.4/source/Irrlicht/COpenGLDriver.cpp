@@ -4656,6 +4656,51 @@ core::dimension2du COpenGLDriver::getMaxTextureSize() const
 }
 
 
+//! Returns the color format the textures store images of a color format in
+/** Depends on the texture creation flags and the format of the image. */
+ECOLOR_FORMAT COpenGLDriver::getTextureFormat(ECOLOR_FORMAT imageFormat) const
+{
+	ECOLOR_FORMAT destFormat = ECF_A8R8G8B8;
+	switch (imageFormat)
+	{
+		case ECF_A1R5G5B5:
+			if (!getTextureCreationFlag(ETCF_ALWAYS_32_BIT))
+				destFormat = ECF_A1R5G5B5;
+		break;
+		case ECF_R5G6B5:
+			if (!getTextureCreationFlag(ETCF_ALWAYS_32_BIT))
+				destFormat = ECF_A1R5G5B5;
+		break;
+		case ECF_A8R8G8B8:
+			if (getTextureCreationFlag(ETCF_ALWAYS_16_BIT) ||
+					getTextureCreationFlag(ETCF_OPTIMIZED_FOR_SPEED))
+				destFormat = ECF_A1R5G5B5;
+		break;
+		case ECF_R8G8B8:
+			if (getTextureCreationFlag(ETCF_ALWAYS_16_BIT) ||
+					getTextureCreationFlag(ETCF_OPTIMIZED_FOR_SPEED))
+				destFormat = ECF_A1R5G5B5;
+		default:
+		break;
+	}
+	if (getTextureCreationFlag(ETCF_NO_ALPHA_CHANNEL))
+	{
+		switch (destFormat)
+		{
+			case ECF_A1R5G5B5:
+				destFormat = ECF_R5G6B5;
+			break;
+			case ECF_A8R8G8B8:
+				destFormat = ECF_R8G8B8;
+			break;
+			default:
+			break;
+		}
+	}
+	return destFormat;
+}
+
+
 //! Convert E_PRIMITIVE_TYPE to OpenGL equivalent
 GLenum COpenGLDriver::primitiveTypeToGL(scene::E_PRIMITIVE_TYPE type) const
 {
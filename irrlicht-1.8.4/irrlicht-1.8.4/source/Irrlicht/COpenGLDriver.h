@@ -390,6 +390,9 @@ namespace video
 		//! Returns the maximum texture size supported.
 		virtual core::dimension2du getMaxTextureSize() const;
 
+		//! Returns the color format the textures store images of a color format in
+		virtual ECOLOR_FORMAT getTextureFormat(ECOLOR_FORMAT imageFormat) const;
+
 		ITexture* createDepthTexture(ITexture* texture, bool shared=true);
 		void removeDepthTexture(ITexture* texture);
 
@@ -83,44 +83,7 @@ COpenGLTexture::~COpenGLTexture()
 //! Choose best matching color format, based on texture creation flags
 ECOLOR_FORMAT COpenGLTexture::getBestColorFormat(ECOLOR_FORMAT format)
 {
-	ECOLOR_FORMAT destFormat = ECF_A8R8G8B8;
-	switch (format)
-	{
-		case ECF_A1R5G5B5:
-			if (!Driver->getTextureCreationFlag(ETCF_ALWAYS_32_BIT))
-				destFormat = ECF_A1R5G5B5;
-		break;
-		case ECF_R5G6B5:
-			if (!Driver->getTextureCreationFlag(ETCF_ALWAYS_32_BIT))
-				destFormat = ECF_A1R5G5B5;
-		break;
-		case ECF_A8R8G8B8:
-			if (Driver->getTextureCreationFlag(ETCF_ALWAYS_16_BIT) ||
-					Driver->getTextureCreationFlag(ETCF_OPTIMIZED_FOR_SPEED))
-				destFormat = ECF_A1R5G5B5;
-		break;
-		case ECF_R8G8B8:
-			if (Driver->getTextureCreationFlag(ETCF_ALWAYS_16_BIT) ||
-					Driver->getTextureCreationFlag(ETCF_OPTIMIZED_FOR_SPEED))
-				destFormat = ECF_A1R5G5B5;
-		default:
-		break;
-	}
-	if (Driver->getTextureCreationFlag(ETCF_NO_ALPHA_CHANNEL))
-	{
-		switch (destFormat)
-		{
-			case ECF_A1R5G5B5:
-				destFormat = ECF_R5G6B5;
-			break;
-			case ECF_A8R8G8B8:
-				destFormat = ECF_R8G8B8;
-			break;
-			default:
-			break;
-		}
-	}
-	return destFormat;
+	return Driver->getTextureFormat(format);
 }
 
 
@@ -429,14 +429,19 @@ void CParticleSystemSceneNode::doParticleSystem(u32 time)
 			s32 j=Particles.size();
 			if (newParticles > 16250-j)
 				newParticles=16250-j;
+			// grow with some headroom instead of reallocating on each emission
+			if (Particles.allocated_size() < (u32)(j+newParticles))
+				Particles.reallocate(core::min_<u32>(16250, (j+newParticles)*3/2));
 			Particles.set_used(j+newParticles);
 			for (s32 i=j; i<j+newParticles; ++i)
-			{
 				Particles[i]=array[i-j];
-				AbsoluteTransformation.rotateVect(Particles[i].startVector);
-				if (ParticlesAreGlobal)
-					AbsoluteTransformation.transformVect(Particles[i].pos);
-			}
+
+			SParticle* p = Particles.pointer() + j;
+			AbsoluteTransformation.rotateVects(&p->startVector, &p->startVector,
+				newParticles, sizeof(SParticle), sizeof(SParticle));
+			if (ParticlesAreGlobal)
+				AbsoluteTransformation.transformVects(&p->pos, &p->pos,
+					newParticles, sizeof(SParticle), sizeof(SParticle));
 		}
 	}
 
@@ -523,8 +528,11 @@ void CParticleSystemSceneNode::reallocateBuffers()
 	if (Particles.size() * 4 > Buffer->getVertexCount() ||
 			Particles.size() * 6 > Buffer->getIndexCount())
 	{
+		// grow with some headroom, so a growing particle system does not reallocate each frame
+		const u32 count = core::min_<u32>(16250, Particles.size() + Particles.size() / 2);
+
 		u32 oldSize = Buffer->getVertexCount();
-		Buffer->Vertices.set_used(Particles.size() * 4);
+		Buffer->Vertices.set_used(count * 4);
 
 		u32 i;
 
@@ -540,7 +548,7 @@ void CParticleSystemSceneNode::reallocateBuffers()
 		// fill remaining indices
 		u32 oldIdxSize = Buffer->getIndexCount();
 		u32 oldvertices = oldSize;
-		Buffer->Indices.set_used(Particles.size() * 6);
+		Buffer->Indices.set_used(count * 6);
 
 		for (i=oldIdxSize; i<Buffer->Indices.size(); i+=6)
 		{
@@ -162,6 +162,7 @@ bool CQ3LevelMesh::loadFile(io::IReadFile* file)
 
 	cleanMeshes();
 	calcBoundingBoxes();
+	buildVisibility();
 	cleanLoader();
 
 	return true;
@@ -185,6 +186,7 @@ void CQ3LevelMesh::cleanLoader ()
 
 	Lightmap.clear();
 	Tex.clear();
+	FaceBuffers.clear();
 }
 
 //! returns the amount of frames in milliseconds. If the amount is 1, it is a static (=non animated) mesh.
@@ -314,7 +316,22 @@ void CQ3LevelMesh::loadFaces(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadPlanes(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumPlanes = l->length / sizeof(tBSPPlane);
+	if ( !NumPlanes )
+		return;
+	Planes = new tBSPPlane[NumPlanes];
+
+	file->seek(l->offset);
+	file->read(Planes, l->length);
+
+	if ( LoadParam.swapHeader )
+	for (s32 i=0;i<NumPlanes;i++)
+	{
+		Planes[i].vNormal[0] = os::Byteswap::byteswap(Planes[i].vNormal[0]);
+		Planes[i].vNormal[1] = os::Byteswap::byteswap(Planes[i].vNormal[1]);
+		Planes[i].vNormal[2] = os::Byteswap::byteswap(Planes[i].vNormal[2]);
+		Planes[i].d = os::Byteswap::byteswap(Planes[i].d);
+	}
 }
 
 
@@ -322,7 +339,27 @@ void CQ3LevelMesh::loadPlanes(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadNodes(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumNodes = l->length / sizeof(tBSPNode);
+	if ( !NumNodes )
+		return;
+	Nodes = new tBSPNode[NumNodes];
+
+	file->seek(l->offset);
+	file->read(Nodes, l->length);
+
+	if ( LoadParam.swapHeader )
+	for (s32 i=0;i<NumNodes;i++)
+	{
+		Nodes[i].plane = os::Byteswap::byteswap(Nodes[i].plane);
+		Nodes[i].front = os::Byteswap::byteswap(Nodes[i].front);
+		Nodes[i].back = os::Byteswap::byteswap(Nodes[i].back);
+		Nodes[i].mins[0] = os::Byteswap::byteswap(Nodes[i].mins[0]);
+		Nodes[i].mins[1] = os::Byteswap::byteswap(Nodes[i].mins[1]);
+		Nodes[i].mins[2] = os::Byteswap::byteswap(Nodes[i].mins[2]);
+		Nodes[i].maxs[0] = os::Byteswap::byteswap(Nodes[i].maxs[0]);
+		Nodes[i].maxs[1] = os::Byteswap::byteswap(Nodes[i].maxs[1]);
+		Nodes[i].maxs[2] = os::Byteswap::byteswap(Nodes[i].maxs[2]);
+	}
 }
 
 
@@ -330,7 +367,30 @@ void CQ3LevelMesh::loadNodes(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadLeafs(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumLeafs = l->length / sizeof(tBSPLeaf);
+	if ( !NumLeafs )
+		return;
+	Leafs = new tBSPLeaf[NumLeafs];
+
+	file->seek(l->offset);
+	file->read(Leafs, l->length);
+
+	if ( LoadParam.swapHeader )
+	for (s32 i=0;i<NumLeafs;i++)
+	{
+		Leafs[i].cluster = os::Byteswap::byteswap(Leafs[i].cluster);
+		Leafs[i].area = os::Byteswap::byteswap(Leafs[i].area);
+		Leafs[i].mins[0] = os::Byteswap::byteswap(Leafs[i].mins[0]);
+		Leafs[i].mins[1] = os::Byteswap::byteswap(Leafs[i].mins[1]);
+		Leafs[i].mins[2] = os::Byteswap::byteswap(Leafs[i].mins[2]);
+		Leafs[i].maxs[0] = os::Byteswap::byteswap(Leafs[i].maxs[0]);
+		Leafs[i].maxs[1] = os::Byteswap::byteswap(Leafs[i].maxs[1]);
+		Leafs[i].maxs[2] = os::Byteswap::byteswap(Leafs[i].maxs[2]);
+		Leafs[i].leafface = os::Byteswap::byteswap(Leafs[i].leafface);
+		Leafs[i].numOfLeafFaces = os::Byteswap::byteswap(Leafs[i].numOfLeafFaces);
+		Leafs[i].leafBrush = os::Byteswap::byteswap(Leafs[i].leafBrush);
+		Leafs[i].numOfLeafBrushes = os::Byteswap::byteswap(Leafs[i].numOfLeafBrushes);
+	}
 }
 
 
@@ -338,7 +398,19 @@ void CQ3LevelMesh::loadLeafs(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadLeafFaces(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumLeafFaces = l->length / sizeof(s32);
+	if (!NumLeafFaces)
+		return;
+	LeafFaces = new s32[NumLeafFaces];
+
+	file->seek(l->offset);
+	file->read(LeafFaces, l->length);
+
+	if ( LoadParam.swapHeader )
+	{
+		for (s32 i=0;i<NumLeafFaces;i++)
+			LeafFaces[i] = os::Byteswap::byteswap(LeafFaces[i]);
+	}
 }
 
 
@@ -346,7 +418,32 @@ void CQ3LevelMesh::loadLeafFaces(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadVisData(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	Visibility.ClusterCount = 0;
+	Visibility.BytesPerCluster = 0;
+
+	if ( l->length < 2 * (s32) sizeof(s32) )
+		return;
+
+	s32 size[2];
+	file->seek(l->offset);
+	file->read(size, sizeof(size));
+
+	if ( LoadParam.swapHeader )
+	{
+		size[0] = os::Byteswap::byteswap(size[0]);
+		size[1] = os::Byteswap::byteswap(size[1]);
+	}
+
+	// no vis data, or a broken one: all clusters are visible
+	if ( size[0] <= 0 || size[1] < (size[0] + 7) / 8 ||
+		size[1] > ( l->length - (s32) sizeof(size) ) / size[0] )
+		return;
+
+	Visibility.ClusterBits.set_used( size[0] * size[1] );
+	file->read(Visibility.ClusterBits.pointer(), Visibility.ClusterBits.size());
+
+	Visibility.ClusterCount = size[0];
+	Visibility.BytesPerCluster = size[1];
 }
 
 
@@ -964,6 +1061,7 @@ scene::SMesh** CQ3LevelMesh::buildMesh(s32 num)
 				}
 			}
 
+			const u32 firstIndex = buffer->getIndexCount();
 
 			switch(Faces[i].type)
 			{
@@ -1018,6 +1116,14 @@ scene::SMesh** CQ3LevelMesh::buildMesh(s32 num)
 					break;
 
 			} // end switch
+
+			// remember the indices of the face for the visibility tests
+			if ( 0 == num && item[g].index == E_Q3_MESH_GEOMETRY )
+			{
+				FaceBuffers[i] = buffer;
+				Visibility.Faces[i].FirstIndex = firstIndex;
+				Visibility.Faces[i].IndexCount = buffer->getIndexCount() - firstIndex;
+			}
 		}
 	}
 
@@ -1054,6 +1160,17 @@ void CQ3LevelMesh::constructMesh()
 
 	s32 i, j;
 
+	// where buildMesh puts the faces of the main level
+	FaceBuffers.set_used(NumFaces);
+	Visibility.Faces.set_used(NumFaces);
+	for (i = 0; i < NumFaces; i++)
+	{
+		FaceBuffers[i] = 0;
+		Visibility.Faces[i].Buffer = -1;
+		Visibility.Faces[i].FirstIndex = 0;
+		Visibility.Faces[i].IndexCount = 0;
+	}
+
 	// First the main level
 	SMesh **tmp = buildMesh(0);
 
@@ -1523,7 +1640,7 @@ const IShader* CQ3LevelMesh::getShader( const c8 * filename, bool fileNameIsVali
 	s32 index;
 
 	//! is Shader already in cache?
-	index = Shader.linear_search( search );
+	index = findShader( search.name );
 	if ( index >= 0 )
 	{
 		if ( LoadParam.verbose > 1 )
@@ -1589,7 +1706,7 @@ const IShader* CQ3LevelMesh::getShader( const c8 * filename, bool fileNameIsVali
 
 
 	// search again
-	index = Shader.linear_search( search );
+	index = findShader( search.name );
 	return index >= 0 ? &Shader[index] : 0;
 }
 
@@ -1633,6 +1750,7 @@ void CQ3LevelMesh::InitShader()
 	element.VarGroup->VariableGroup.push_back( SVarGroup() );
 	element.name = element.VarGroup->VariableGroup[0].Variable[0].name;
 	element.ID = Shader.size();
+	ShaderIndex.insert( element.name, element.ID );
 	Shader.push_back( element );
 
 	if ( LoadParam.loadAllShaders )
@@ -1679,10 +1797,19 @@ void CQ3LevelMesh::ReleaseShader()
 		Shader[i].VarGroup->drop();
 	}
 	Shader.clear();
+	ShaderIndex.clear();
 	ShaderFile.clear();
 }
 
 
+//! returns the index of a loaded shader, or -1
+s32 CQ3LevelMesh::findShader( const core::stringc& name ) const
+{
+	const core::hash_map < core::stringc, u32 >::Node* n = ShaderIndex.find( name );
+	return n ? (s32) n->getValue() : -1;
+}
+
+
 /*!
 */
 void CQ3LevelMesh::ReleaseEntity()
@@ -1758,6 +1885,7 @@ void CQ3LevelMesh::scriptcallback_shader( SVarGroupList *& grouplist,eToken toke
 	dumpShader ( s, &element );
 	printf ( s.c_str () );
 */
+	ShaderIndex.insert( element.name, element.ID );
 	Shader.push_back( element );
 }
 
@@ -1873,6 +2001,70 @@ void CQ3LevelMesh::cleanMesh(SMesh *m, const bool texture0important)
 }
 
 
+/*!
+	Keeps the BSP tree, the leafs and the vis data in Irrlicht coordinates,
+	and where the faces of the main level ended up in the geometry mesh.
+*/
+void CQ3LevelMesh::buildVisibility()
+{
+	s32 i;
+
+	// faces whose buffer was deleted by cleanMeshes are not drawn
+	core::hash_map<IMeshBuffer*, s32> bufferIndex;
+	const SMesh* geometry = Mesh[E_Q3_MESH_GEOMETRY];
+	bufferIndex.reserve(geometry->getMeshBufferCount());
+	for (u32 b = 0; b < geometry->getMeshBufferCount(); ++b)
+		bufferIndex.insert(geometry->getMeshBuffer(b), (s32) b);
+
+	for (i = 0; i < NumFaces; i++)
+	{
+		const core::hash_map<IMeshBuffer*, s32>::Node* node =
+			FaceBuffers[i] ? bufferIndex.find(FaceBuffers[i]) : 0;
+		Visibility.Faces[i].Buffer = node ? node->getValue() : -1;
+	}
+
+	Visibility.Nodes.reallocate(NumNodes);
+	for (i = 0; i < NumNodes; i++)
+	{
+		SVisNode node;
+		if ( Nodes[i].plane >= 0 && Nodes[i].plane < NumPlanes )
+		{
+			const tBSPPlane& plane = Planes[Nodes[i].plane];
+			node.Plane.setPlane(core::vector3df(plane.vNormal[0], plane.vNormal[2], plane.vNormal[1]),
+				-plane.d);
+		}
+		node.Children[0] = Nodes[i].front < NumNodes ? Nodes[i].front : -1;
+		node.Children[1] = Nodes[i].back < NumNodes ? Nodes[i].back : -1;
+		Visibility.Nodes.push_back(node);
+	}
+
+	// broken entries end up out of range of Faces and are skipped
+	Visibility.LeafFaces.reallocate(NumLeafFaces);
+	for (i = 0; i < NumLeafFaces; i++)
+		Visibility.LeafFaces.push_back((u32) LeafFaces[i]);
+
+	Visibility.Leafs.reallocate(NumLeafs);
+	for (i = 0; i < NumLeafs; i++)
+	{
+		const tBSPLeaf& l = Leafs[i];
+
+		SVisLeaf leaf;
+		leaf.Box.MinEdge.set((f32) l.mins[0], (f32) l.mins[2], (f32) l.mins[1]);
+		leaf.Box.MaxEdge.set((f32) l.maxs[0], (f32) l.maxs[2], (f32) l.maxs[1]);
+		leaf.Box.repair();
+		leaf.Cluster = l.cluster < Visibility.ClusterCount ? l.cluster : -1;
+		leaf.FirstFace = 0;
+		leaf.FaceCount = 0;
+		if ( l.leafface >= 0 && l.numOfLeafFaces > 0 && l.leafface <= NumLeafFaces - l.numOfLeafFaces )
+		{
+			leaf.FirstFace = l.leafface;
+			leaf.FaceCount = l.numOfLeafFaces;
+		}
+		Visibility.Leafs.push_back(leaf);
+	}
+}
+
+
 // recalculate bounding boxes
 void CQ3LevelMesh::calcBoundingBoxes()
 {
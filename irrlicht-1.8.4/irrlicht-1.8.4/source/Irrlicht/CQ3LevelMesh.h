@@ -12,6 +12,7 @@
 #include "SMeshBufferLightMap.h"
 #include "IVideoDriver.h"
 #include "irrString.h"
+#include "irrHashMap.h"
 #include "ISceneManager.h"
 #include "os.h"
 
@@ -129,6 +130,53 @@ namespace scene
 			return;
 		}
 
+		//! Node of the BSP tree, in Irrlicht coordinates
+		struct SVisNode
+		{
+			core::plane3df Plane;
+			//! front and back child, a negative value -(n+1) is leaf n
+			s32 Children[2];
+		};
+
+		//! Leaf of the BSP tree
+		struct SVisLeaf
+		{
+			core::aabbox3df Box;
+			s32 Cluster;		// -1 for leafs outside of the level
+			u32 FirstFace;		// first entry in LeafFaces
+			u32 FaceCount;
+		};
+
+		//! Where the indices of a face are in the level geometry
+		struct SVisFace
+		{
+			s32 Buffer;			// mesh buffer of the E_Q3_MESH_GEOMETRY mesh, -1 for none
+			u32 FirstIndex;
+			u32 IndexCount;
+		};
+
+		//! BSP tree and potentially visible sets of the level
+		struct SVisibility
+		{
+			SVisibility() : ClusterCount(0), BytesPerCluster(0) {}
+
+			core::array<SVisNode> Nodes;
+			core::array<SVisLeaf> Leafs;
+			core::array<u32> LeafFaces;
+			core::array<SVisFace> Faces;
+
+			//! one bit per cluster for each cluster, set when visible from there
+			core::array<u8> ClusterBits;
+			s32 ClusterCount;
+			s32 BytesPerCluster;
+		};
+
+		//! returns the visibility data, used by CQ3LevelSceneNode
+		const SVisibility& getVisibility() const
+		{
+			return Visibility;
+		}
+
 	private:
 
 
@@ -458,12 +506,15 @@ namespace scene
 		void scriptcallback_config( quake3::SVarGroupList *& grouplist, eToken token );
 
 		core::array < quake3::IShader > Shader;
+		//! index of each shader name in Shader, the first one wins like in a linear search
+		core::hash_map < core::stringc, u32 > ShaderIndex;
 		core::array < quake3::IShader > Entity;		//quake3::tQ3EntityList Entity;
 
 
 		quake3::tStringList ShaderFile;
 		void InitShader();
 		void ReleaseShader();
+		s32 findShader( const core::stringc& name ) const;
 		void ReleaseEntity();
 
 
@@ -480,6 +531,11 @@ namespace scene
 		void cleanMesh(SMesh *m, const bool texture0important = false);
 		void cleanLoader ();
 		void calcBoundingBoxes();
+		void buildVisibility();
+
+		SVisibility Visibility;
+		//! mesh buffer of each face while the level is built
+		core::array<IMeshBuffer*> FaceBuffers;
 		c8 buf[128];
 		f32 FramesPerSecond;
 	};
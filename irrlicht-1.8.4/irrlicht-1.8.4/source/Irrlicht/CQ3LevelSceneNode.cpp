@@ -0,0 +1,286 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
+
+#include "CQ3LevelSceneNode.h"
+#include "ISceneManager.h"
+#include "IVideoDriver.h"
+#include "ICameraSceneNode.h"
+#include "IMaterialRenderer.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+
+
+//! constructor
+CQ3LevelSceneNode::CQ3LevelSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+		CQ3LevelMesh* mesh)
+	: ISceneNode(parent, mgr, id), Mesh(mesh), Geometry(0), Frame(0), PassCount(0)
+{
+#ifdef _DEBUG
+	setDebugName("CQ3LevelSceneNode");
+#endif
+
+	Mesh->grab();
+	Geometry = Mesh->getMesh(quake3::E_Q3_MESH_GEOMETRY);
+	Box = Geometry->getBoundingBox();
+
+	const u32 count = Geometry->getMeshBufferCount();
+	Materials.reallocate(count);
+	Indices.reallocate(count);
+	for (u32 i=0; i<count; ++i)
+	{
+		Materials.push_back(Geometry->getMeshBuffer(i)->getMaterial());
+		Indices.push_back(core::array<u16>());
+	}
+
+	FaceFrame.set_used(Mesh->getVisibility().Faces.size());
+	for (u32 f=0; f<FaceFrame.size(); ++f)
+		FaceFrame[f] = 0;
+}
+
+
+//! destructor
+CQ3LevelSceneNode::~CQ3LevelSceneNode()
+{
+	Mesh->drop();
+}
+
+
+void CQ3LevelSceneNode::OnRegisterSceneNode()
+{
+	if (IsVisible)
+	{
+		// the level mixes solid and transparent materials, so register
+		// for each pass the materials need
+		video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+		PassCount = 0;
+		u32 transparentCount = 0;
+		u32 solidCount = 0;
+
+		for (u32 i=0; i<Materials.size(); ++i)
+		{
+			const video::IMaterialRenderer* const rnd =
+				driver->getMaterialRenderer(Materials[i].MaterialType);
+
+			if (rnd && rnd->isTransparent())
+				++transparentCount;
+			else
+				++solidCount;
+
+			if (solidCount && transparentCount)
+				break;
+		}
+
+		if (solidCount)
+			SceneManager->registerNodeForRendering(this, scene::ESNRP_SOLID);
+
+		if (transparentCount)
+			SceneManager->registerNodeForRendering(this, scene::ESNRP_TRANSPARENT);
+
+		ISceneNode::OnRegisterSceneNode();
+	}
+}
+
+
+//! renders the node.
+void CQ3LevelSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	ICameraSceneNode* camera = SceneManager->getActiveCamera();
+
+	if (!driver || !camera)
+		return;
+
+	const bool isTransparentPass =
+		SceneManager->getSceneNodeRenderPass() == scene::ESNRP_TRANSPARENT;
+
+	// the visible faces are the same for both passes
+	if (++PassCount == 1)
+		collectVisibleFaces(camera);
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+	for (u32 i=0; i<Materials.size(); ++i)
+	{
+		if (Indices[i].empty())
+			continue;
+
+		const video::IMaterialRenderer* const rnd = driver->getMaterialRenderer(Materials[i].MaterialType);
+		const bool transparent = (rnd && rnd->isTransparent());
+
+		// only render transparent buffer if this is the transparent render pass
+		// and solid only in solid pass
+		if (transparent == isTransparentPass)
+		{
+			const IMeshBuffer* mb = Geometry->getMeshBuffer(i);
+
+			driver->setMaterial(Materials[i]);
+			driver->drawVertexPrimitiveList(mb->getVertices(), mb->getVertexCount(),
+				Indices[i].const_pointer(), Indices[i].size() / 3, mb->getVertexType(),
+				scene::EPT_TRIANGLES, video::EIT_16BIT);
+		}
+	}
+
+	// for debug purposes only
+	if (DebugDataVisible && PassCount==1)
+	{
+		video::SMaterial m;
+		m.Lighting = false;
+		driver->setMaterial(m);
+
+		if (DebugDataVisible & scene::EDS_BBOX_BUFFERS)
+		{
+			const CQ3LevelMesh::SVisibility& vis = Mesh->getVisibility();
+			for (u32 l=0; l<VisibleLeafs.size(); ++l)
+				driver->draw3DBox(vis.Leafs[VisibleLeafs[l]].Box, video::SColor(255,190,128,128));
+		}
+
+		if (DebugDataVisible & scene::EDS_BBOX)
+			driver->draw3DBox(Box, video::SColor(255,255,255,255));
+	}
+}
+
+
+//! returns the cluster of the leaf containing pos, -1 if outside of the level
+s32 CQ3LevelSceneNode::getCluster(const core::vector3df& pos) const
+{
+	const CQ3LevelMesh::SVisibility& vis = Mesh->getVisibility();
+
+	if (vis.Nodes.empty())
+		return -1;
+
+	s32 index = 0;
+	u32 steps = 0;
+	while (index >= 0)
+	{
+		// a broken tree with a loop
+		if (++steps > vis.Nodes.size())
+			return -1;
+
+		const CQ3LevelMesh::SVisNode& node = vis.Nodes[index];
+		index = node.Children[node.Plane.getDistanceTo(pos) >= 0.f ? 0 : 1];
+	}
+
+	const u32 leaf = (u32)(-(index + 1));
+	return leaf < vis.Leafs.size() ? vis.Leafs[leaf].Cluster : -1;
+}
+
+
+//! fills Indices with the visible faces
+void CQ3LevelSceneNode::collectVisibleFaces(const ICameraSceneNode* camera)
+{
+	const CQ3LevelMesh::SVisibility& vis = Mesh->getVisibility();
+
+	SViewFrustum frust = *camera->getViewFrustum();
+	core::vector3df cameraPos = camera->getAbsolutePosition();
+
+	// test in the space of the level
+	if (!AbsoluteTransformation.isIdentity())
+	{
+		core::matrix4 invTrans(AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE);
+		frust.transform(invTrans);
+		invTrans.transformVect(cameraPos);
+	}
+
+	for (u32 i=0; i<Indices.size(); ++i)
+		Indices[i].set_used(0);
+	VisibleLeafs.set_used(0);
+
+	// restart the frame stamps before they wrap around
+	if (++Frame == 0)
+	{
+		for (u32 f=0; f<FaceFrame.size(); ++f)
+			FaceFrame[f] = 0;
+		Frame = 1;
+	}
+
+	// the potentially visible set of the camera cluster, all clusters
+	// are visible from outside of the level or without vis data
+	const s32 cluster = getCluster(cameraPos);
+	const u8* pvs = 0;
+	if (cluster >= 0 && cluster < vis.ClusterCount)
+		pvs = &vis.ClusterBits[cluster * vis.BytesPerCluster];
+
+	for (u32 l=0; l<vis.Leafs.size(); ++l)
+	{
+		const CQ3LevelMesh::SVisLeaf& leaf = vis.Leafs[l];
+
+		if (!leaf.FaceCount)
+			continue;
+
+		if (pvs && (leaf.Cluster < 0 || !(pvs[leaf.Cluster >> 3] & (1 << (leaf.Cluster & 7)))))
+			continue;
+
+		bool inside = true;
+		for (u32 p=0; p!=scene::SViewFrustum::VF_PLANE_COUNT; ++p)
+		{
+			if (leaf.Box.classifyPlaneRelation(frust.planes[p]) == core::ISREL3D_FRONT)
+			{
+				inside = false;
+				break;
+			}
+		}
+		if (!inside)
+			continue;
+
+		VisibleLeafs.push_back(l);
+
+		for (u32 k=leaf.FirstFace; k<leaf.FirstFace+leaf.FaceCount; ++k)
+		{
+			const u32 f = vis.LeafFaces[k];
+			if (f >= FaceFrame.size() || FaceFrame[f] == Frame)
+				continue;
+			FaceFrame[f] = Frame;
+
+			const CQ3LevelMesh::SVisFace& face = vis.Faces[f];
+			if (face.Buffer < 0 || !face.IndexCount)
+				continue;
+
+			const u16* src = Geometry->getMeshBuffer(face.Buffer)->getIndices() + face.FirstIndex;
+			core::array<u16>& dst = Indices[face.Buffer];
+			const u32 first = dst.size();
+			dst.set_used(first + face.IndexCount);
+			memcpy(dst.pointer() + first, src, face.IndexCount * sizeof(u16));
+		}
+	}
+}
+
+
+//! returns the axis aligned bounding box of this node
+const core::aabbox3d<f32>& CQ3LevelSceneNode::getBoundingBox() const
+{
+	return Box;
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CQ3LevelSceneNode::getMaterial(u32 i)
+{
+	if ( i >= Materials.size() )
+		return ISceneNode::getMaterial(i);
+
+	return Materials[i];
+}
+
+
+//! returns amount of materials used by this scene node.
+u32 CQ3LevelSceneNode::getMaterialCount() const
+{
+	return Materials.size();
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_BSP_LOADER_
+
@@ -0,0 +1,80 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_Q3_LEVEL_SCENE_NODE_H_INCLUDED__
+#define __C_Q3_LEVEL_SCENE_NODE_H_INCLUDED__
+
+#include "ISceneNode.h"
+#include "CQ3LevelMesh.h"
+
+namespace irr
+{
+namespace scene
+{
+	class ICameraSceneNode;
+
+	//! Scene node drawing the geometry of a quake3 level.
+	/** Each frame the leaf of the BSP tree holding the camera is looked
+	up, and only the faces of the leafs in its potentially visible set
+	which are inside the view frustum are drawn. */
+	class CQ3LevelSceneNode : public ISceneNode
+	{
+	public:
+
+		//! constructor
+		CQ3LevelSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			CQ3LevelMesh* mesh);
+
+		//! destructor
+		virtual ~CQ3LevelSceneNode();
+
+		virtual void OnRegisterSceneNode();
+
+		//! renders the node.
+		virtual void render();
+
+		//! returns the axis aligned bounding box of this node
+		virtual const core::aabbox3d<f32>& getBoundingBox() const;
+
+		//! returns the material based on the zero based index i.
+		virtual video::SMaterial& getMaterial(u32 i);
+
+		//! returns amount of materials used by this scene node.
+		virtual u32 getMaterialCount() const;
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const { return ESNT_Q3LEVEL; }
+
+	private:
+
+		//! fills Indices with the visible faces
+		void collectVisibleFaces(const ICameraSceneNode* camera);
+
+		//! returns the cluster of the leaf containing pos, -1 if outside of the level
+		s32 getCluster(const core::vector3df& pos) const;
+
+		CQ3LevelMesh* Mesh;
+		IMesh* Geometry;
+		core::aabbox3d<f32> Box;
+
+		core::array<video::SMaterial> Materials;
+
+		//! indices of the visible faces, one array per mesh buffer
+		core::array< core::array<u16> > Indices;
+
+		//! frame in which each face was added last, so faces in several leafs are added once
+		core::array<u32> FaceFrame;
+		u32 Frame;
+
+		//! leafs drawn this frame, for the debug boxes
+		core::array<u32> VisibleLeafs;
+
+		u32 PassCount;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
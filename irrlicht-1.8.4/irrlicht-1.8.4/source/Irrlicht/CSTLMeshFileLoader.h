@@ -29,6 +29,9 @@ public:
 	//! See IReferenceCounted::drop() for more information.
 	virtual IAnimatedMesh* createMesh(io::IReadFile* file);
 
+	//! the loader keeps no state, so meshes can be loaded on worker threads
+	virtual bool isThreadSafe() const { return true; }
+
 private:
 
 	// skips to the first non-space character available
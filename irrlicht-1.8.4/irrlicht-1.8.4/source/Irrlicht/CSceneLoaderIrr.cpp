@@ -5,9 +5,13 @@
 #include "CSceneLoaderIrr.h"
 #include "ISceneNodeAnimatorFactory.h"
 #include "ISceneUserDataSerializer.h"
-#include "ISceneManager.h"
+#include "CSceneManager.h"
+#include "IMeshLoader.h"
 #include "IVideoDriver.h"
 #include "IFileSystem.h"
+#include "IReadFile.h"
+#include "IMeshCache.h"
+#include "irrMap.h"
 #include "os.h"
 
 namespace irr
@@ -16,8 +20,8 @@ namespace scene
 {
 
 //! Constructor
-CSceneLoaderIrr::CSceneLoaderIrr(ISceneManager *smgr, io::IFileSystem* fs)
- : SceneManager(smgr), FileSystem(fs),
+CSceneLoaderIrr::CSceneLoaderIrr(CSceneManager *smgr, io::IFileSystem* fs)
+ : SceneManager(smgr), FileSystem(fs), NextResource(0), AttributeBlock(0),
    IRR_XML_FORMAT_SCENE(L"irr_scene"), IRR_XML_FORMAT_NODE(L"node"), IRR_XML_FORMAT_NODE_ATTR_TYPE(L"type"),
    IRR_XML_FORMAT_ATTRIBUTES(L"attributes"), IRR_XML_FORMAT_MATERIALS(L"materials"),
    IRR_XML_FORMAT_ANIMATORS(L"animators"), IRR_XML_FORMAT_USERDATA(L"userData")
@@ -54,10 +58,21 @@ bool CSceneLoaderIrr::loadScene(io::IReadFile* file, ISceneUserDataSerializer* u
 		return false;
 	}
 
+	// with worker threads, the meshes and textures are loaded on the
+	// thread pool while the nodes are created
+	CThreadPool* pool = CThreadPool::getSharedPool();
+	if (pool && pool->getThreadCount())
+	{
+		collectResources(file);
+		file->seek(0);
+		prefetchResources();
+	}
+
 	io::IXMLReader* reader = FileSystem->createXMLReader(file);
 	if (!reader)
 	{
 		os::Printer::log("Scene is not a valid XML file", file->getFileName().c_str(), ELL_ERROR);
+		clearResources();
 		return false;
 	}
 
@@ -76,10 +91,233 @@ bool CSceneLoaderIrr::loadScene(io::IReadFile* file, ISceneUserDataSerializer* u
 
 	// clean up
 	reader->drop();
+	clearResources();
 	return true;
 }
 
 
+//! reads the mesh file and parses it if possible, or decodes the texture
+void CSceneLoaderIrr::SResource::run()
+{
+	if (!IsMesh)
+	{
+		Texture.run();
+		return;
+	}
+
+	if (!Data)
+		readFile();
+	if (!Data || !Loader)
+		return;
+
+	io::IReadFile* file = FileSystem->createMemoryReadFile(Data, Size, Path, false);
+
+	// the messages are logged on the loading thread if the mesh is used
+	core::array<os::SLogMessage>* previous = os::Printer::setMessageBuffer(&Messages);
+	Mesh = Loader->createMesh(file);
+	os::Printer::setMessageBuffer(previous);
+
+	file->drop();
+}
+
+
+//! reads the contents of the mesh file
+void CSceneLoaderIrr::SResource::readFile()
+{
+	// opened like ISceneManager::getMesh() does
+	io::IReadFile* file = FileSystem->createAndOpenFile(Path);
+	if (!file)
+		return;
+
+	Size = file->getSize();
+	Data = new c8[Size];
+	if (file->read(Data, Size) != Size)
+	{
+		delete [] Data;
+		Data = 0;
+	}
+
+	file->drop();
+}
+
+
+//! frees what the job loaded
+void CSceneLoaderIrr::SResource::clear()
+{
+	if (Mesh)
+		Mesh->drop();
+	Mesh = 0;
+
+	delete [] Data;
+	Data = 0;
+
+	Messages.clear();
+	Texture.clear();
+}
+
+
+//! Finds the meshes and textures the scene refers to
+void CSceneLoaderIrr::collectResources(io::IReadFile* file)
+{
+	io::IXMLReader* reader = FileSystem->createXMLReader(file);
+	if (!reader)
+		return;
+
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	core::map<io::path, bool> meshes;
+	core::map<io::path, bool> textures;
+	u32 blocks = 0;
+
+	while (reader->read())
+	{
+		if (reader->getNodeType() != io::EXN_ELEMENT)
+			continue;
+
+		const wchar_t* name = reader->getNodeName();
+		if (IRR_XML_FORMAT_ATTRIBUTES == name)
+		{
+			++blocks;
+			continue;
+		}
+
+		// meshes of the scene nodes, and all textures
+		const core::stringw element(name);
+		const bool isMesh = element == L"string" &&
+			core::stringw(L"Mesh") == reader->getAttributeValueSafe(L"name");
+		const bool isTexture = element == L"texture" && driver;
+		if (!blocks || !(isMesh || isTexture))
+			continue;
+
+		const io::path path = reader->getAttributeValueSafe(L"value");
+		if (!path.size())
+			continue;
+
+		IMeshLoader* loader = 0;
+		video::CTextureImageJob texture;
+		if (isMesh)
+		{
+			if (meshes.find(path) || SceneManager->getMeshCache()->getMeshByName(path))
+				continue;
+			meshes.insert(path, true);
+
+			// the loader ISceneManager::getMesh() tries first
+			for (s32 i=(s32)SceneManager->getMeshLoaderCount()-1; i>=0; --i)
+			{
+				IMeshLoader* candidate = SceneManager->getMeshLoader(i);
+				if (candidate->isALoadableFileExtension(path))
+				{
+					if (candidate->isThreadSafe())
+						loader = candidate;
+					break;
+				}
+			}
+		}
+		else
+		{
+			if (textures.find(path))
+				continue;
+			textures.insert(path, true);
+
+			if (texture.setFile(driver, FileSystem, path))
+				continue;
+		}
+
+		Resources.push_back(SResource());
+		SResource& res = Resources.getLast();
+		res.Path = path;
+		res.FileSystem = FileSystem;
+		res.Loader = loader;
+		res.Texture = texture;
+		res.FirstBlock = blocks-1;
+		res.IsMesh = isMesh;
+	}
+
+	reader->drop();
+}
+
+
+//! Starts loading the collected meshes and textures on the thread pool
+void CSceneLoaderIrr::prefetchResources()
+{
+	CThreadPool* pool = CThreadPool::getSharedPool();
+
+	// archives read their files through one shared file, so files which
+	// might be in an archive are read here, and only parsed by the workers
+	const bool readHere = FileSystem->getFileArchiveCount() != 0;
+
+	for (u32 i=0; i<Resources.size(); ++i)
+	{
+		SResource& res = Resources[i];
+
+		if (!res.IsMesh)
+		{
+			if (res.Texture.prepare())
+				pool->addJob(&res, res.Group);
+		}
+		else if (!readHere)
+			pool->addJob(&res, res.Group);
+		else
+		{
+			res.readFile();
+			if (res.Data && res.Loader)
+				pool->addJob(&res, res.Group);
+		}
+	}
+}
+
+
+//! Moves the resources needed by the next attributes block into the caches
+void CSceneLoaderIrr::useResources()
+{
+	for (; NextResource < Resources.size() &&
+		Resources[NextResource].FirstBlock <= AttributeBlock; ++NextResource)
+	{
+		SResource& res = Resources[NextResource];
+		CThreadPool::getSharedPool()->waitForJobs(res.Group);
+
+		// meshes which couldn't be read are loaded again by the nodes, for the usual warnings
+		const bool cached = res.IsMesh && SceneManager->getMeshCache()->getMeshByName(res.Path);
+		if (!res.IsMesh)
+			res.Texture.createTexture();
+		else if (res.Mesh && !cached)
+		{
+			// named like in the scene file, so the node finds it in the mesh cache
+			os::Printer::log(res.Messages);
+			SceneManager->addLoadedMesh(res.Path, res.Mesh);
+			os::Printer::log("Loaded mesh", res.Path, ELL_INFORMATION);
+		}
+		else if (res.Data && !cached)
+		{
+			// parsed here if the loader isn't thread safe, or again if it failed on the worker
+			// named like in the scene file, so the node finds it in the mesh cache
+			io::IReadFile* file = FileSystem->createMemoryReadFile(res.Data, res.Size, res.Path, true);
+			res.Data = 0;
+			SceneManager->getMesh(file);
+			file->drop();
+		}
+
+		res.clear();
+	}
+
+	++AttributeBlock;
+}
+
+
+//! Waits for all prefetch jobs and frees what was not used
+void CSceneLoaderIrr::clearResources()
+{
+	for (; NextResource < Resources.size(); ++NextResource)
+	{
+		CThreadPool::getSharedPool()->waitForJobs(Resources[NextResource].Group);
+		Resources[NextResource].clear();
+	}
+
+	Resources.clear();
+	NextResource = 0;
+	AttributeBlock = 0;
+}
+
+
 //! Reads the next node
 void CSceneLoaderIrr::readSceneNode(io::IXMLReader* reader, ISceneNode* parent,
 	ISceneUserDataSerializer* userDataSerializer)
@@ -124,6 +362,7 @@ void CSceneLoaderIrr::readSceneNode(io::IXMLReader* reader, ISceneNode* parent,
 			if (IRR_XML_FORMAT_ATTRIBUTES == name)
 			{
 				// read attributes
+				useResources();
 				io::IAttributes* attr = FileSystem->createEmptyAttributes(SceneManager->getVideoDriver());
 				attr->read(reader, true);
 
@@ -183,6 +422,7 @@ void CSceneLoaderIrr::readMaterials(io::IXMLReader* reader, ISceneNode* node)
 			if (IRR_XML_FORMAT_ATTRIBUTES == name)
 			{
 				// read materials from attribute list
+				useResources();
 				io::IAttributes* attr = FileSystem->createEmptyAttributes(SceneManager->getVideoDriver());
 				attr->read(reader);
 
@@ -220,6 +460,7 @@ void CSceneLoaderIrr::readAnimators(io::IXMLReader* reader, ISceneNode* node)
 			if (IRR_XML_FORMAT_ATTRIBUTES == name)
 			{
 				// read animator data from attribute list
+				useResources();
 				io::IAttributes* attr = FileSystem->createEmptyAttributes(SceneManager->getVideoDriver());
 				attr->read(reader);
 
@@ -262,6 +503,7 @@ void CSceneLoaderIrr::readUserData(io::IXMLReader* reader, ISceneNode* node, ISc
 			if (IRR_XML_FORMAT_ATTRIBUTES == name)
 			{
 				// read user data from attribute list
+				useResources();
 				io::IAttributes* attr = FileSystem->createEmptyAttributes(SceneManager->getVideoDriver());
 				attr->read(reader);
 
@@ -8,6 +8,7 @@
 #include "ISceneLoader.h"
 
 #include "IXMLReader.h"
+#include "CTextureImageJob.h"
 
 namespace irr
 {
@@ -20,7 +21,9 @@ namespace io
 namespace scene
 {
 
-class ISceneManager;
+class CSceneManager;
+class IMeshLoader;
+class IAnimatedMesh;
 
 //! Class which can load a scene into the scene manager.
 class CSceneLoaderIrr : public virtual ISceneLoader
@@ -28,7 +31,7 @@ class CSceneLoaderIrr : public virtual ISceneLoader
 public:
 
 	//! Constructor
-	CSceneLoaderIrr(ISceneManager *smgr, io::IFileSystem* fs);
+	CSceneLoaderIrr(CSceneManager *smgr, io::IFileSystem* fs);
 
 	//! Destructor
 	virtual ~CSceneLoaderIrr();
@@ -45,6 +48,55 @@ public:
 
 private:
 
+	//! Mesh or texture file the scene refers to, loaded ahead on the thread pool
+	struct SResource : public IThreadJob
+	{
+		SResource() : FileSystem(0), Loader(0), Mesh(0), Data(0), Size(0),
+			FirstBlock(0), IsMesh(false) {}
+
+		//! reads the mesh file and parses it if possible, or decodes the texture
+		virtual void run();
+
+		//! reads the contents of the mesh file
+		void readFile();
+
+		//! frees what the job loaded
+		void clear();
+
+		//! path as written in the scene file
+		io::path Path;
+		io::IFileSystem* FileSystem;
+		//! thread safe loader of the mesh, 0 to parse it on the loading thread
+		IMeshLoader* Loader;
+		//! mesh parsed by the worker
+		IAnimatedMesh* Mesh;
+		//! contents of the mesh file
+		c8* Data;
+		long Size;
+		//! messages of the mesh loader
+		core::array<os::SLogMessage> Messages;
+		video::CTextureImageJob Texture;
+		//! index of the first attributes block referring to the file
+		u32 FirstBlock;
+		bool IsMesh;
+		CThreadPool::SJobGroup Group;
+	};
+
+	//! Finds the meshes and textures the scene refers to
+	void collectResources(io::IReadFile* file);
+
+	//! Starts loading the collected meshes and textures on the thread pool
+	void prefetchResources();
+
+	//! Moves the resources needed by the next attributes block into the caches
+	/** Called before each attributes block, waits for its files and
+	creates their textures, and the meshes which the workers could not
+	parse, on the loading thread. */
+	void useResources();
+
+	//! Waits for all prefetch jobs and frees what was not used
+	void clearResources();
+
 	//! Recursively reads nodes from the xml file
 	void readSceneNode(io::IXMLReader* reader, ISceneNode* parent,
 		ISceneUserDataSerializer* userDataSerializer);
@@ -59,9 +111,16 @@ private:
 	void readUserData(io::IXMLReader* reader, ISceneNode* node,
 		ISceneUserDataSerializer* userDataSerializer);
 
-	ISceneManager   *SceneManager;
+	CSceneManager   *SceneManager;
 	io::IFileSystem *FileSystem;
 
+	//! resources of the scene being loaded, ordered by FirstBlock
+	core::array<SResource> Resources;
+	//! first resource not moved into the caches yet
+	u32 NextResource;
+	//! index of the next attributes block
+	u32 AttributeBlock;
+
 	//! constants for reading and writing XML.
 	//! Not made static due to portability problems.
 	// TODO: move to own header
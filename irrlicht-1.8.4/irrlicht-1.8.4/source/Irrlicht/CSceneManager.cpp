@@ -28,8 +28,13 @@
 #include "CIrrMeshFileLoader.h"
 #endif
 
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+#include "CIrrBinaryMeshFileLoader.h"
+#endif
+
 #ifdef _IRR_COMPILE_WITH_BSP_LOADER_
 #include "CBSPMeshFileLoader.h"
+#include "CQ3LevelSceneNode.h"
 #endif
 
 #ifdef _IRR_COMPILE_WITH_MD2_LOADER_
@@ -120,6 +125,10 @@
 #include "CIrrMeshWriter.h"
 #endif
 
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_WRITER_
+#include "CIrrBinaryMeshWriter.h"
+#endif
+
 #ifdef _IRR_COMPILE_WITH_STL_WRITER_
 #include "CSTLMeshWriter.h"
 #endif
@@ -140,6 +149,8 @@
 #include "CLightSceneNode.h"
 #include "CBillboardSceneNode.h"
 #include "CMeshSceneNode.h"
+#include "CLODMeshSceneNode.h"
+#include "CInstancedMeshSceneNode.h"
 #include "CSkyBoxSceneNode.h"
 #include "CSkyDomeSceneNode.h"
 #include "CParticleSystemSceneNode.h"
@@ -185,7 +196,11 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 : ISceneNode(0, 0), Driver(driver), FileSystem(fs), GUIEnvironment(gui),
 	CursorControl(cursorControl), CollisionManager(0),
 	ActiveCamera(0), ShadowColor(150,0,0,0), AmbientLight(0,0,0,0),
-	MeshCache(cache), CurrentRendertime(ESNRP_NONE), LightManager(0),
+	AllowZWriteParameter(ALLOW_ZWRITE_ON_TRANSPARENT),
+#ifdef _IRR_SCENEMANAGER_DEBUG
+	CallsParameter("calls"), CulledParameter("culled"),
+#endif
+	MeshCache(cache), CurrentRendertime(ESNRP_NONE), LightManager(0), TriangleBudget(0),
 	IRR_XML_FORMAT_SCENE(L"irr_scene"), IRR_XML_FORMAT_NODE(L"node"), IRR_XML_FORMAT_NODE_ATTR_TYPE(L"type")
 {
 	#ifdef _DEBUG
@@ -272,6 +287,9 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 	#ifdef _IRR_COMPILE_WITH_IRR_MESH_LOADER_
 	MeshLoaderList.push_back(new CIrrMeshFileLoader(this, FileSystem));
 	#endif
+	#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+	MeshLoaderList.push_back(new CIrrBinaryMeshFileLoader(this, FileSystem));
+	#endif
 	#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
 	MeshLoaderList.push_back(new CBSPMeshFileLoader(this, FileSystem));
 	#endif
@@ -396,7 +414,7 @@ IAnimatedMesh* CSceneManager::getMesh(const io::path& filename)
 			msh = MeshLoaderList[i]->createMesh(file);
 			if (msh)
 			{
-				MeshCache->addMesh(filename, msh);
+				addLoadedMesh(filename, msh);
 				msh->drop();
 				break;
 			}
@@ -436,7 +454,7 @@ IAnimatedMesh* CSceneManager::getMesh(io::IReadFile* file)
 			msh = MeshLoaderList[i]->createMesh(file);
 			if (msh)
 			{
-				MeshCache->addMesh(file->getFileName(), msh);
+				addLoadedMesh(file->getFileName(), msh);
 				msh->drop();
 				break;
 			}
@@ -542,6 +560,29 @@ IMeshSceneNode* CSceneManager::addQuake3SceneNode(const IMeshBuffer* meshBuffer,
 }
 
 
+//! Adds a scene node drawing the visible part of a quake3 level
+ISceneNode* CSceneManager::addQ3LevelSceneNode(IQ3LevelMesh* mesh,
+		ISceneNode* parent, s32 id)
+{
+#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
+	// the visibility data is only known to the level loaded by the engine
+	if (!mesh || mesh->getMeshType() != EAMT_BSP)
+		return 0;
+
+	if (!parent)
+		parent = this;
+
+	CQ3LevelSceneNode* node = new CQ3LevelSceneNode(parent, this, id,
+		static_cast<CQ3LevelMesh*>(mesh));
+	node->drop();
+
+	return node;
+#else
+	return 0;
+#endif
+}
+
+
 //! adds Volume Lighting Scene Node.
 //! the returned pointer must not be dropped.
 IVolumeLightSceneNode* CSceneManager::addVolumeLightSceneNode(
@@ -610,6 +651,48 @@ IMeshSceneNode* CSceneManager::addMeshSceneNode(IMesh* mesh, ISceneNode* parent,
 }
 
 
+//! adds a scene node for rendering a static mesh with levels of detail
+//! the returned pointer must not be dropped.
+ILODMeshSceneNode* CSceneManager::addLODMeshSceneNode(IMesh* mesh, u32 levelCount, f32 reduction,
+	ISceneNode* parent, s32 id, const core::vector3df& position,
+	const core::vector3df& rotation, const core::vector3df& scale,
+	bool alsoAddIfMeshPointerZero)
+{
+	if (!alsoAddIfMeshPointerZero && !mesh)
+		return 0;
+
+	if (!parent)
+		parent = this;
+
+	ILODMeshSceneNode* node = new CLODMeshSceneNode(mesh, levelCount, reduction,
+		parent, this, id, position, rotation, scale);
+	node->drop();
+
+	return node;
+}
+
+
+//! adds a scene node for rendering many copies of a static mesh
+//! the returned pointer must not be dropped.
+IInstancedMeshSceneNode* CSceneManager::addInstancedMeshSceneNode(IMesh* mesh,
+	ISceneNode* parent, s32 id, const core::vector3df& position,
+	const core::vector3df& rotation, const core::vector3df& scale,
+	bool alsoAddIfMeshPointerZero)
+{
+	if (!alsoAddIfMeshPointerZero && !mesh)
+		return 0;
+
+	if (!parent)
+		parent = this;
+
+	IInstancedMeshSceneNode* node = new CInstancedMeshSceneNode(mesh, parent, this, id,
+		position, rotation, scale);
+	node->drop();
+
+	return node;
+}
+
+
 //! Adds a scene node for rendering a animated water surface mesh.
 ISceneNode* CSceneManager::addWaterSurfaceSceneNode(IMesh* mesh, f32 waveHeight, f32 waveSpeed, f32 waveLength,
 	ISceneNode* parent, s32 id, const core::vector3df& position,
@@ -1323,13 +1406,21 @@ u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDE
 		break;
 	}
 
+	// collect visible level of detail nodes for the triangle budget,
+	// nodes with solid and transparent parts are registered twice
+	if (taken && TriangleBudget && node->getType() == ESNT_LOD_MESH &&
+		(LODNodeList.empty() || LODNodeList.getLast().Node != node))
+	{
+		LODNodeList.push_back(LODNodeEntry(static_cast<ILODMeshSceneNode*>(node)));
+	}
+
 #ifdef _IRR_SCENEMANAGER_DEBUG
-	s32 index = Parameters.findAttribute ( "calls" );
+	s32 index = CallsParameter.getIndex ( Parameters );
 	Parameters.setAttribute ( index, Parameters.getAttributeAsInt ( index ) + 1 );
 
 	if (!taken)
 	{
-		index = Parameters.findAttribute ( "culled" );
+		index = CulledParameter.getIndex ( Parameters );
 		Parameters.setAttribute ( index, Parameters.getAttributeAsInt ( index ) + 1 );
 	}
 #endif
@@ -1345,6 +1436,9 @@ void CSceneManager::drawAll()
 	if (!Driver)
 		return;
 
+	// scratch memory of this frame, see core::irrAllocatorFrame
+	core::CMemoryArenaScope frameScope;
+
 #ifdef _IRR_SCENEMANAGER_DEBUG
 	// reset attributes
 	Parameters.setAttribute ( "culled", 0 );
@@ -1364,8 +1458,7 @@ void CSceneManager::drawAll()
 	for (i=video::ETS_COUNT-1; i>=video::ETS_TEXTURE_0; --i)
 		Driver->setTransform ( (video::E_TRANSFORMATION_STATE)i, core::IdentityMatrix );
 
-	// TODO: This should not use an attribute here but a real parameter when necessary (too slow!)
-	Driver->setAllowZWriteOnTransparent(Parameters.getAttributeAsBool( ALLOW_ZWRITE_ON_TRANSPARENT) );
+	Driver->setAllowZWriteOnTransparent(Parameters.getAttributeAsBool( AllowZWriteParameter.getIndex(Parameters) ) );
 
 	// do animations and other stuff.
 	OnAnimate(os::Timer::getTime());
@@ -1384,6 +1477,8 @@ void CSceneManager::drawAll()
 	// let all nodes register themselves
 	OnRegisterSceneNode();
 
+	applyTriangleBudget();
+
 	if (LightManager)
 		LightManager->OnPreRender(LightList);
 
@@ -1420,7 +1515,7 @@ void CSceneManager::drawAll()
 			if (ActiveCamera)
 				camWorldPos = ActiveCamera->getAbsolutePosition();
 
-			core::array<DistanceNodeEntry> SortedLights;
+			core::array<DistanceNodeEntry, core::irrAllocatorFrame<DistanceNodeEntry> > SortedLights;
 			SortedLights.set_used(LightList.size());
 			for (s32 light = (s32)LightList.size() - 1; light >= 0; --light)
 				SortedLights[light].setNodeAndDistanceFromPosition(LightList[light], camWorldPos);
@@ -2456,6 +2551,93 @@ const video::SColorf& CSceneManager::getAmbientLight() const
 }
 
 
+//! Sets the maximal amount of triangles drawn by level of detail nodes per frame
+void CSceneManager::setTriangleBudget(u32 triangles)
+{
+	TriangleBudget = triangles;
+}
+
+
+//! Returns the maximal amount of triangles drawn by level of detail nodes per frame
+u32 CSceneManager::getTriangleBudget() const
+{
+	return TriangleBudget;
+}
+
+
+//! adds a mesh created by a mesh loader to the cache, optimized if requested by MESH_OPTIMIZE_ON_LOAD
+void CSceneManager::addLoadedMesh(const io::path& name, IAnimatedMesh* mesh)
+{
+	const u32 flags = (u32)Parameters.getAttributeAsInt(MESH_OPTIMIZE_ON_LOAD);
+
+	// vertices of these are referenced by animation data or the level entities
+	bool optimize = flags && Driver && mesh->getFrameCount() == 1;
+	switch (mesh->getMeshType())
+	{
+	case EAMT_MD2:
+	case EAMT_MD3:
+	case EAMT_BSP:
+	case EAMT_MDL_HALFLIFE:
+	case EAMT_SKINNED:
+		optimize = false;
+		break;
+	default:
+		break;
+	}
+
+	if (optimize)
+		Driver->getMeshManipulator()->optimizeMesh(mesh->getMesh(0), flags);
+
+	MeshCache->addMesh(name, mesh);
+}
+
+
+//! switches level of detail nodes to coarser levels until the triangle budget is met
+void CSceneManager::applyTriangleBudget()
+{
+	if (!TriangleBudget || LODNodeList.empty())
+	{
+		LODNodeList.set_used(0);
+		return;
+	}
+
+	u32 triangles = 0;
+	u32 i;
+	for (i=0; i<LODNodeList.size(); ++i)
+	{
+		const ILODMeshSceneNode* node = LODNodeList[i].Node;
+		triangles += node->getLODTriangleCount(node->getCurrentLOD());
+	}
+
+	if (triangles > TriangleBudget)
+	{
+		// step the smallest nodes down first, one level per round, so
+		// detail is taken away evenly instead of wiping out single nodes
+		LODNodeList.sort();
+
+		bool changed = true;
+		while (changed && triangles > TriangleBudget)
+		{
+			changed = false;
+			for (i=0; i<LODNodeList.size() && triangles > TriangleBudget; ++i)
+			{
+				ILODMeshSceneNode* node = LODNodeList[i].Node;
+				const u32 level = node->getCurrentLOD();
+				if (level+1 >= node->getLODCount() || node->getForcedLOD() >= 0)
+					continue;
+
+				triangles -= node->getLODTriangleCount(level);
+				triangles += node->getLODTriangleCount(level+1);
+				node->setCurrentLOD(level+1);
+				changed = true;
+			}
+		}
+	}
+
+	LODNodeList.set_used(0);
+}
+
+
 //! Get a skinned mesh, which is not available as header-only code
 ISkinnedMesh* CSceneManager::createSkinnedMesh()
 {
@@ -2502,6 +2684,13 @@ IMeshWriter* CSceneManager::createMeshWriter(EMESH_WRITER_TYPE type)
 #else
 		return 0;
 #endif
+
+	case EMWT_IRR_BINARY_MESH:
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_WRITER_
+		return new CIrrBinaryMeshWriter(Driver, FileSystem);
+#else
+		return 0;
+#endif
 	}
 
 	return 0;
@@ -13,6 +13,7 @@
 #include "IMeshLoader.h"
 #include "CAttributes.h"
 #include "ILightManager.h"
+#include "ILODMeshSceneNode.h"
 
 namespace irr
 {
@@ -95,6 +96,24 @@ namespace scene
 			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
 			bool alsoAddIfMeshPointerZero=false);
 
+		//! adds a scene node for rendering a static mesh with levels of detail
+		//! the returned pointer must not be dropped.
+		virtual ILODMeshSceneNode* addLODMeshSceneNode(IMesh* mesh, u32 levelCount=4, f32 reduction=0.5f,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
+			bool alsoAddIfMeshPointerZero=false);
+
+		//! adds a scene node for rendering many copies of a static mesh
+		//! the returned pointer must not be dropped.
+		virtual IInstancedMeshSceneNode* addInstancedMeshSceneNode(IMesh* mesh,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
+			bool alsoAddIfMeshPointerZero=false);
+
 		//! Adds a scene node for rendering a animated water surface mesh.
 		virtual ISceneNode* addWaterSurfaceSceneNode(IMesh* mesh, f32 waveHeight, f32 waveSpeed, f32 wlenght, ISceneNode* parent=0, s32 id=-1,
 			const core::vector3df& position = core::vector3df(0,0,0),
@@ -200,6 +219,10 @@ namespace scene
 												ISceneNode* parent=0, s32 id=-1
 												);
 
+		//! Adds a scene node drawing the visible part of a quake3 level
+		virtual ISceneNode* addQ3LevelSceneNode(IQ3LevelMesh* mesh,
+			ISceneNode* parent=0, s32 id=-1);
+
 
 		//! Adds a Hill Plane mesh to the mesh pool. The mesh is
 		//! generated on the fly and looks like a plane with some hills
@@ -506,6 +529,12 @@ namespace scene
 		//! Returns ambient color of the scene
 		virtual const video::SColorf& getAmbientLight() const;
 
+		//! Sets the maximal amount of triangles drawn by level of detail nodes per frame
+		virtual void setTriangleBudget(u32 triangles);
+
+		//! Returns the maximal amount of triangles drawn by level of detail nodes per frame
+		virtual u32 getTriangleBudget() const;
+
 		//! Register a custom callbacks manager which gets callbacks during scene rendering.
 		virtual void setLightManager(ILightManager* lightManager);
 
@@ -521,14 +550,47 @@ namespace scene
 		//! returns if node is culled
 		virtual bool isCulled(const ISceneNode* node) const;
 
+		//! Adds a mesh created by a mesh loader to the mesh cache
+		/** Optimizes it first if requested by MESH_OPTIMIZE_ON_LOAD. Used
+		by getMesh() and by the scene loaders which let mesh loaders run
+		on the thread pool. */
+		void addLoadedMesh(const io::path& name, IAnimatedMesh* mesh);
+
 	private:
 
 		//! clears the deletion list
 		void clearDeletionList();
 
+		//! switches level of detail nodes to coarser levels until the triangle budget is met
+		void applyTriangleBudget();
+
+
 		//! writes a scene node
 		void writeSceneNode(io::IXMLWriter* writer, ISceneNode* node, ISceneUserDataSerializer* userDataSerializer, const fschar_t* currentPath=0, bool init=false);
 
+		//! Index of a parameter which is accessed very often
+		/** The name is only looked up again after indices of the
+		parameters changed, e.g. because the user cleared them. */
+		struct ParameterHandle
+		{
+			ParameterHandle(const c8* name)
+				: Name(name), Index(-1), Revision(0) {}
+
+			s32 getIndex(const io::CAttributes& parameters)
+			{
+				if (Index == -1 || Revision != parameters.getIndexRevision())
+				{
+					Index = parameters.findAttribute(Name);
+					Revision = parameters.getIndexRevision();
+				}
+				return Index;
+			}
+
+			const c8* Name;
+			s32 Index;
+			u32 Revision;
+		};
+
 		struct DefaultNodeEntry
 		{
 			DefaultNodeEntry(ISceneNode* n) :
@@ -593,6 +655,21 @@ namespace scene
 			f64 Distance;
 		};
 
+		//! sort on size on the screen, smallest first
+		struct LODNodeEntry
+		{
+			LODNodeEntry(ILODMeshSceneNode* n)
+				: Node(n), ScreenSize(n->getScreenSize()) {}
+
+			bool operator < (const LODNodeEntry& other) const
+			{
+				return ScreenSize < other.ScreenSize;
+			}
+
+			ILODMeshSceneNode* Node;
+			f32 ScreenSize;
+		};
+
 		//! video driver
 		video::IVideoDriver* Driver;
 
@@ -616,6 +693,7 @@ namespace scene
 		core::array<DefaultNodeEntry> SolidNodeList;
 		core::array<TransparentNodeEntry> TransparentNodeList;
 		core::array<TransparentNodeEntry> TransparentEffectNodeList;
+		core::array<LODNodeEntry> LODNodeList;
 
 		core::array<IMeshLoader*> MeshLoaderList;
 		core::array<ISceneLoader*> SceneLoaderList;
@@ -634,6 +712,13 @@ namespace scene
 		// NODE: Attributes are slow and should only be used for debug-info and not in release
 		io::CAttributes Parameters;
 
+		//! parameters read every frame
+		ParameterHandle AllowZWriteParameter;
+#ifdef _IRR_SCENEMANAGER_DEBUG
+		ParameterHandle CallsParameter;
+		ParameterHandle CulledParameter;
+#endif
+
 		//! Mesh cache
 		IMeshCache* MeshCache;
 
@@ -643,6 +728,9 @@ namespace scene
 		//! over the scene lighting and rendering.
 		ILightManager* LightManager;
 
+		//! maximal triangles of level of detail nodes per frame, 0 for no limit
+		u32 TriangleBudget;
+
 		//! constants for reading and writing XML.
 		//! Not made static due to portability problems.
 		const core::stringw IRR_XML_FORMAT_SCENE;
@@ -104,7 +104,7 @@ void CSceneNodeAnimatorCameraFPS::animateNode(ISceneNode* node, u32 timeMs)
 
 	if (firstUpdate)
 	{
-		camera->updateAbsolutePosition();
+		camera->updateAbsolutePositionAndRevision();
 		if (CursorControl )
 		{
 			CursorControl->setPosition(0.5f, 0.5f);
@@ -495,20 +495,29 @@ void CSkinnedMesh::skinJoint(SJoint *joint, SJoint *parentJoint)
 		core::matrix4 jointVertexPull(core::matrix4::EM4CONST_NOTHING);
 		jointVertexPull.setbyproduct(joint->GlobalAnimatedMatrix, joint->GlobalInversedMatrix);
 
-		core::vector3df thisVertexMove, thisNormalMove;
-
 		core::array<scene::SSkinMeshBuffer*> &buffersUsed=*SkinningBuffers;
 
-		//Skin Vertices Positions and Normals...
-		for (u32 i=0; i<joint->Weights.size(); ++i)
+		// Pull the vertices of all weights at once...
+		const u32 weightCount = joint->Weights.size();
+		if (SkinnedPositions.size() < weightCount)
 		{
-			SWeight& weight = joint->Weights[i];
+			SkinnedPositions.set_used(weightCount);
+			SkinnedNormals.set_used(weightCount);
+		}
 
-			// Pull this vertex...
-			jointVertexPull.transformVect(thisVertexMove, weight.StaticPos);
+		jointVertexPull.transformVects(SkinnedPositions.pointer(), &joint->Weights[0].StaticPos,
+			weightCount, sizeof(core::vector3df), sizeof(SWeight));
 
-			if (AnimateNormals)
-				jointVertexPull.rotateVect(thisNormalMove, weight.StaticNormal);
+		if (AnimateNormals)
+			jointVertexPull.rotateVects(SkinnedNormals.pointer(), &joint->Weights[0].StaticNormal,
+				weightCount, sizeof(core::vector3df), sizeof(SWeight));
+
+		//Skin Vertices Positions and Normals...
+		for (u32 i=0; i<weightCount; ++i)
+		{
+			SWeight& weight = joint->Weights[i];
+			const core::vector3df& thisVertexMove = SkinnedPositions[i];
+			const core::vector3df& thisNormalMove = SkinnedNormals[i];
 
 			if (! (*(weight.Moved)) )
 			{
@@ -1285,7 +1294,7 @@ void CSkinnedMesh::recoverJointsFromMesh(core::array<IBoneSceneNode*> &jointChil
 		node->scaleHint=joint->scaleHint;
 		node->rotationHint=joint->rotationHint;
 
-		node->updateAbsolutePosition();
+		node->updateAbsolutePositionAndRevision();
 	}
 }
 
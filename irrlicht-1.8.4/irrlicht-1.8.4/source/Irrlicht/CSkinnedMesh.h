@@ -192,6 +192,10 @@ private:
 
 		core::array< core::array<bool> > Vertices_Moved;
 
+		//! joint space positions and normals of the weights of one joint, reused while skinning
+		core::array<core::vector3df> SkinnedPositions;
+		core::array<core::vector3df> SkinnedNormals;
+
 		core::aabbox3d<f32> BoundingBox;
 
 		f32 AnimationFrames;
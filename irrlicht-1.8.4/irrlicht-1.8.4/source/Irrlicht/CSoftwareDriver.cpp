@@ -360,7 +360,8 @@ void CSoftwareDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCo
 void CSoftwareDriver::drawVertexPrimitiveList16(const void* vertices, u32 vertexCount, const u16* indexList, u32 primitiveCount, E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType)
 {
 	const u16* indexPointer=0;
-	core::array<u16> newBuffer;
+	core::CMemoryArenaScope scratch;
+	core::array<u16, core::irrAllocatorFrame<u16> > newBuffer;
 	switch (pType)
 	{
 		case scene::EPT_LINE_STRIP:
@@ -492,8 +493,9 @@ void CSoftwareDriver::drawClippedIndexedTriangleListT(const VERTEXTYPE* vertices
 		return;
 
 	// arrays for storing clipped vertices
-	core::array<VERTEXTYPE> clippedVertices;
-	core::array<u16> clippedIndices;
+	core::CMemoryArenaScope scratch;
+	core::array<VERTEXTYPE, core::irrAllocatorFrame<VERTEXTYPE> > clippedVertices;
+	core::array<u16, core::irrAllocatorFrame<u16> > clippedIndices;
 
 	// calculate inverse world transformation
 	core::matrix4 worldinv(TransformationMatrix[ETS_WORLD]);
@@ -510,7 +512,7 @@ void CSoftwareDriver::drawClippedIndexedTriangleListT(const VERTEXTYPE* vertices
 	core::EIntersectionRelation3D inout[3]; // is point in front or back of plane?
 
 	// temporary buffer for vertices to be clipped by all planes
-	core::array<VERTEXTYPE> tClpBuf;
+	core::array<VERTEXTYPE, core::irrAllocatorFrame<VERTEXTYPE> > tClpBuf;
 	int t;
 
 	int i;
@@ -644,7 +646,7 @@ void CSoftwareDriver::drawClippedIndexedTriangleListT(const VERTEXTYPE* vertices
 			clippedIndices.push_back(clippedVertices.size());
 			clippedVertices.push_back(tClpBuf[t]);
 		}
-		tClpBuf.clear();
+		tClpBuf.set_used(0);
 
 	} // end for all input triangles
 
@@ -946,6 +948,14 @@ u32 CSoftwareDriver::getMaximalPrimitiveCount() const
 	return 0x00800000;
 }
 
+
+//! Returns the color format the textures store images of a color format in
+ECOLOR_FORMAT CSoftwareDriver::getTextureFormat(ECOLOR_FORMAT imageFormat) const
+{
+	// CSoftwareTexture converts everything
+	return ECF_A1R5G5B5;
+}
+
 } // end namespace video
 } // end namespace irr
 
@@ -118,6 +118,9 @@ namespace video
 		//! call.
 		virtual u32 getMaximalPrimitiveCount() const;
 
+		//! Returns the color format the textures store images of a color format in
+		virtual ECOLOR_FORMAT getTextureFormat(ECOLOR_FORMAT imageFormat) const;
+
 	protected:
 
 		//! sets a render target
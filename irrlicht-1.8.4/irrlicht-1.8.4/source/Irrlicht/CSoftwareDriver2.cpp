@@ -628,6 +628,10 @@ bool CBurningVideoDriver::queryFeature(E_VIDEO_DRIVER_FEATURE feature) const
 	case EVDF_HARDWARE_TL:
 	case EVDF_TEXTURE_NSQUARE:
 		return true;
+#ifdef SOFTWARE_DRIVER_2_TEXTURE_COMPRESSION
+	case EVDF_TEXTURE_COMPRESSED_DXT:
+		return true;
+#endif
 
 	default:
 		return false;
@@ -2253,14 +2257,14 @@ void CBurningVideoDriver::draw2DLine(const core::position2d<s32>& start,
 					const core::position2d<s32>& end,
 					SColor color)
 {
-	drawLine(BackBuffer, start, end, color );
+	drawLine(RenderTargetSurface, start, end, color );
 }
 
 
 //! Draws a pixel
 void CBurningVideoDriver::drawPixel(u32 x, u32 y, const SColor & color)
 {
-	BackBuffer->setPixel(x, y, color, true);
+	RenderTargetSurface->setPixel(x, y, color, true);
 }
 
 
@@ -2277,14 +2281,14 @@ void CBurningVideoDriver::draw2DRectangle(SColor color, const core::rect<s32>& p
 		if(!p.isValid())
 			return;
 
-		drawRectangle(BackBuffer, p, color);
+		drawRectangle(RenderTargetSurface, p, color);
 	}
 	else
 	{
 		if(!pos.isValid())
 			return;
 
-		drawRectangle(BackBuffer, pos, color);
+		drawRectangle(RenderTargetSurface, pos, color);
 	}
 }
 
@@ -2588,6 +2592,14 @@ ITexture* CBurningVideoDriver::createDeviceDependentTexture(IImage* surface, con
 }
 
 
+//! returns the memory used by the texture data in a color format
+u32 CBurningVideoDriver::getTextureDataSize(const ITexture* texture, ECOLOR_FORMAT format) const
+{
+	// the levels may differ in format
+	return ((const CSoftwareTexture2*)texture)->getMemorySize(format);
+}
+
+
 //! Returns the maximum amount of primitives (mostly vertices) which
 //! the device is able to render with one drawIndexedTriangleList
 //! call.
@@ -179,6 +179,9 @@ namespace video
 		//! THIS METHOD HAS TO BE OVERRIDDEN BY DERIVED DRIVERS WITH OWN TEXTURES
 		virtual video::ITexture* createDeviceDependentTexture(IImage* surface, const io::path& name, void* mipmapData=0);
 
+		//! returns the memory used by the texture data in a color format
+		virtual u32 getTextureDataSize(const ITexture* texture, ECOLOR_FORMAT format) const;
+
 		video::CImage* BackBuffer;
 		video::IImagePresenter* Presenter;
 
@@ -8,6 +8,7 @@
 #include "SoftwareDriver2_compile_config.h"
 #include "SoftwareDriver2_helper.h"
 #include "CSoftwareTexture2.h"
+#include "CColorConverter.h"
 #include "os.h"
 
 namespace irr
@@ -15,10 +16,17 @@ namespace irr
 namespace video
 {
 
+namespace
+{
+	// ids of the texture contents, see getContentId()
+	u32 NextContentId = 0;
+}
+
 //! constructor
 CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name,
 		u32 flags, void* mipmapData)
-		: ITexture(name), MipMapLOD(0), Flags ( flags ), OriginalFormat(video::ECF_UNKNOWN)
+		: ITexture(name), DecodedImage(0), MipMapLOD(0), Flags ( flags ),
+		OriginalFormat(video::ECF_UNKNOWN), ContentId(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CSoftwareTexture2");
@@ -35,9 +43,12 @@ CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name,
 		OrigSize = image->getDimension();
 		OriginalFormat = image->getColorFormat();
 
+		const bool compressed = IImage::isCompressedFormat(OriginalFormat);
+
 		core::setbit_cond(Flags,
 				image->getColorFormat () == video::ECF_A8R8G8B8 ||
-				image->getColorFormat () == video::ECF_A1R5G5B5,
+				image->getColorFormat () == video::ECF_A1R5G5B5 ||
+				compressed,
 				HAS_ALPHA);
 
 		core::dimension2d<u32> optSize(
@@ -46,7 +57,27 @@ CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name,
 				( Flags & NP2_SIZE ) ? SOFTWARE_DRIVER_2_TEXTURE_MAXSIZE : 0)
 			);
 
-		if ( OrigSize == optSize )
+		// the blitter and the box filter need pixels
+		IImage* decoded = 0;
+		if ( compressed )
+		{
+#ifdef SOFTWARE_DRIVER_2_TEXTURE_COMPRESSION
+			// the texel fetch needs power of two sizes
+			if ( OrigSize != optSize || OrigSize != OrigSize.getOptimalSize() )
+#endif
+			{
+				decoded = createDecodedImage(image);
+				image = decoded;
+			}
+		}
+
+		if ( IImage::isCompressedFormat(image->getColorFormat()) )
+		{
+			// keep the blocks
+			MipMap[0] = new CImage(image->getColorFormat(), OrigSize, image->lock(), false);
+			image->unlock();
+		}
+		else if ( OrigSize == optSize )
 		{
 			MipMap[0] = new CImage(BURNINGSHADER_COLOR_FORMAT, image->getDimension());
 			image->copyTo(MipMap[0]);
@@ -67,6 +98,9 @@ CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name,
 			image->copyToScalingBoxFilter ( MipMap[0],0, false );
 		}
 
+		if ( decoded )
+			decoded->drop();
+
 		OrigImageDataSizeInPixels = (f32) 0.3f * MipMap[0]->getImageDataSizeInPixels();
 	}
 
@@ -82,6 +116,75 @@ CSoftwareTexture2::~CSoftwareTexture2()
 		if ( MipMap[i] )
 			MipMap[i]->drop();
 	}
+
+	dropDecodedImage();
+}
+
+
+//! returns unoptimized surface
+CImage* CSoftwareTexture2::getImage() const
+{
+	if ( !IImage::isCompressedFormat(MipMap[0]->getColorFormat()) )
+		return MipMap[0];
+
+	if ( !DecodedImage )
+		DecodedImage = createDecodedImage(MipMap[0]);
+
+	return DecodedImage;
+}
+
+
+//! Returns the memory in bytes used by the levels in the color format
+u32 CSoftwareTexture2::getMemorySize(ECOLOR_FORMAT format) const
+{
+	u32 size = 0;
+	for ( s32 i = 0; i!= SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i )
+	{
+		if ( MipMap[i] && MipMap[i]->getColorFormat() == format )
+			size += MipMap[i]->getImageDataSizeInBytes();
+	}
+
+	if ( DecodedImage && DecodedImage->getColorFormat() == format )
+		size += DecodedImage->getImageDataSizeInBytes();
+
+	return size;
+}
+
+
+//! assigns a new content id
+void CSoftwareTexture2::contentChanged()
+{
+	// 0 is left for empty caches
+	if ( ++NextContentId == 0 )
+		++NextContentId;
+	ContentId = NextContentId;
+
+	// the decoded copy is outdated
+	dropDecodedImage();
+}
+
+
+//! creates an A8R8G8B8 copy of a block compressed image
+CImage* CSoftwareTexture2::createDecodedImage(IImage* image)
+{
+	const core::dimension2d<u32>& dim = image->getDimension();
+	CImage* decoded = new CImage(ECF_A8R8G8B8, dim);
+	CColorConverter::convert_DXTtoA8R8G8B8(image->lock(), image->getColorFormat(),
+		dim.Width, dim.Height, decoded->lock());
+	image->unlock();
+	decoded->unlock();
+	return decoded;
+}
+
+
+//! drops the decoded copy of getImage()
+void CSoftwareTexture2::dropDecodedImage() const
+{
+	if ( DecodedImage )
+	{
+		DecodedImage->drop();
+		DecodedImage = 0;
+	}
 }
 
 
@@ -90,7 +193,10 @@ CSoftwareTexture2::~CSoftwareTexture2()
 void CSoftwareTexture2::regenerateMipMapLevels(void* mipmapData)
 {
 	if ( !hasMipMaps () )
+	{
+		contentChanged();
 		return;
+	}
 
 	s32 i;
 
@@ -104,6 +210,13 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* mipmapData)
 	core::dimension2d<u32> newSize;
 	core::dimension2d<u32> origSize=OrigSize;
 
+	// the box filter needs pixels
+	IImage* source = MipMap[0];
+	if ( IImage::isCompressedFormat(source->getColorFormat()) )
+		source = createDecodedImage(source);
+	else
+		source->grab();
+
 	for (i=1; i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i)
 	{
 		newSize = MipMap[i-1]->getDimension();
@@ -117,6 +230,12 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* mipmapData)
 			if (OriginalFormat != BURNINGSHADER_COLOR_FORMAT)
 			{
 				IImage* tmpImage = new CImage(OriginalFormat, origSize, mipmapData, true, false);
+				if (IImage::isCompressedFormat(OriginalFormat))
+				{
+					IImage* blocks = tmpImage;
+					tmpImage = createDecodedImage(blocks);
+					blocks->drop();
+				}
 				MipMap[i] = new CImage(BURNINGSHADER_COLOR_FORMAT, newSize);
 				if (origSize==newSize)
 					tmpImage->copyTo(MipMap[i]);
@@ -136,7 +255,10 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* mipmapData)
 					tmpImage->drop();
 				}
 			}
-			mipmapData = (u8*)mipmapData+origSize.getArea()*IImage::getBitsPerPixelFromFormat(OriginalFormat)/8;
+			if (IImage::isCompressedFormat(OriginalFormat))
+				mipmapData = (u8*)mipmapData+((origSize.Width+3)/4)*((origSize.Height+3)/4)*IImage::getBlockSizeFromFormat(OriginalFormat);
+			else
+				mipmapData = (u8*)mipmapData+origSize.getArea()*IImage::getBitsPerPixelFromFormat(OriginalFormat)/8;
 		}
 		else
 		{
@@ -144,9 +266,12 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* mipmapData)
 
 			//static u32 color[] = { 0, 0xFFFF0000, 0xFF00FF00,0xFF0000FF,0xFFFFFF00,0xFFFF00FF,0xFF00FFFF,0xFF0F0F0F };
 			MipMap[i]->fill ( 0 );
-			MipMap[0]->copyToScalingBoxFilter( MipMap[i], 0, false );
+			source->copyToScalingBoxFilter( MipMap[i], 0, false );
 		}
 	}
+
+	source->drop();
+	contentChanged();
 }
 
 
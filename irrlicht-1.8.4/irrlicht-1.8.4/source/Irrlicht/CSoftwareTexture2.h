@@ -28,7 +28,8 @@ public:
 		GEN_MIPMAP	= 1,
 		IS_RENDERTARGET	= 2,
 		NP2_SIZE	= 4,
-		HAS_ALPHA	= 8
+		HAS_ALPHA	= 8,
+		LOCKED_WRITE	= 16
 	};
 	CSoftwareTexture2(IImage* surface, const io::path& name, u32 flags, void* mipmapData=0);
 
@@ -36,10 +37,13 @@ public:
 	virtual ~CSoftwareTexture2();
 
 	//! lock function
+	/** The data of block compressed levels are the blocks, see getColorFormat() */
 	virtual void* lock(E_TEXTURE_LOCK_MODE mode=ETLM_READ_WRITE, u32 mipmapLevel=0)
 	{
 		if (Flags & GEN_MIPMAP)
 			MipMapLOD=mipmapLevel;
+		if (mode != ETLM_READ_ONLY)
+			Flags |= LOCKED_WRITE;
 		return MipMap[MipMapLOD]->lock();
 	}
 
@@ -47,6 +51,11 @@ public:
 	virtual void unlock()
 	{
 		MipMap[MipMapLOD]->unlock();
+		if (Flags & LOCKED_WRITE)
+		{
+			Flags &= ~LOCKED_WRITE;
+			contentChanged();
+		}
 	}
 
 	//! Returns original size of the texture.
@@ -70,10 +79,8 @@ public:
 	}
 
 	//! returns unoptimized surface
-	virtual CImage* getImage() const
-	{
-		return MipMap[0];
-	}
+	/** Block compressed textures return a decoded copy, created on first use. */
+	virtual CImage* getImage() const;
 
 	//! returns texture surface
 	virtual CImage* getTexture() const
@@ -88,10 +95,12 @@ public:
 		return EDT_BURNINGSVIDEO;
 	}
 
-	//! returns color format of texture
+	//! returns color format of the current mip map level
+	/** BURNINGSHADER_COLOR_FORMAT, or ECF_DXT1 and ECF_DXT5 for a
+	compressed largest level. */
 	virtual ECOLOR_FORMAT getColorFormat() const
 	{
-		return BURNINGSHADER_COLOR_FORMAT;
+		return MipMap[MipMapLOD]->getColorFormat();
 	}
 
 	//! returns pitch of texture (in bytes)
@@ -122,15 +131,40 @@ public:
 		return (Flags & IS_RENDERTARGET) != 0;
 	}
 
+	//! Returns an id which changes whenever the texels are modified.
+	/** The ids are unique over all textures, so caches of decoded texels
+	can use them to detect both a new texture and modified texels. */
+	u32 getContentId() const
+	{
+		return ContentId;
+	}
+
+	//! Returns the memory in bytes used by the levels in the color format
+	u32 getMemorySize(ECOLOR_FORMAT format) const;
+
 private:
+
+	//! assigns a new content id
+	void contentChanged();
+
+	//! creates an A8R8G8B8 copy of a block compressed image
+	static CImage* createDecodedImage(IImage* image);
+
+	//! drops the decoded copy of getImage()
+	void dropDecodedImage() const;
+
 	f32 OrigImageDataSizeInPixels;
 	core::dimension2d<u32> OrigSize;
 
 	CImage * MipMap[SOFTWARE_DRIVER_2_MIPMAPPING_MAX];
 
+	//! decoded largest level of a compressed texture, for the 2d blitter
+	mutable CImage* DecodedImage;
+
 	u32 MipMapLOD;
 	u32 Flags;
 	ECOLOR_FORMAT OriginalFormat;
+	u32 ContentId;
 };
 
 
@@ -94,15 +94,11 @@ void CTerrainTriangleSelector::getTriangles(core::triangle3df* triangles,
 	for (s32 i=0; i<TrianglePatches.NumPatches; ++i)
 	{
 		if (tIndex + TrianglePatches.TrianglePatchArray[i].NumTriangles <= count)
-			for (s32 j=0; j<TrianglePatches.TrianglePatchArray[i].NumTriangles; ++j)
 			{
-				triangles[tIndex] = TrianglePatches.TrianglePatchArray[i].Triangles[j];
-
-				mat.transformVect(triangles[tIndex].pointA);
-				mat.transformVect(triangles[tIndex].pointB);
-				mat.transformVect(triangles[tIndex].pointC);
-
-				++tIndex;
+				mat.transformTriangles(triangles + tIndex,
+					TrianglePatches.TrianglePatchArray[i].Triangles.const_pointer(),
+					TrianglePatches.TrianglePatchArray[i].NumTriangles);
+				tIndex += TrianglePatches.TrianglePatchArray[i].NumTriangles;
 			}
 	}
 
@@ -131,15 +127,11 @@ void CTerrainTriangleSelector::getTriangles(core::triangle3df* triangles,
 	{
 		if (tIndex + TrianglePatches.TrianglePatchArray[i].NumTriangles <= count &&
 			TrianglePatches.TrianglePatchArray[i].Box.intersectsWithBox(box))
-			for (s32 j=0; j<TrianglePatches.TrianglePatchArray[i].NumTriangles; ++j)
 			{
-				triangles[tIndex] = TrianglePatches.TrianglePatchArray[i].Triangles[j];
-
-				mat.transformVect(triangles[tIndex].pointA);
-				mat.transformVect(triangles[tIndex].pointB);
-				mat.transformVect(triangles[tIndex].pointC);
-
-				++tIndex;
+				mat.transformTriangles(triangles + tIndex,
+					TrianglePatches.TrianglePatchArray[i].Triangles.const_pointer(),
+					TrianglePatches.TrianglePatchArray[i].NumTriangles);
+				tIndex += TrianglePatches.TrianglePatchArray[i].NumTriangles;
 			}
 	}
 
@@ -166,16 +158,10 @@ void CTerrainTriangleSelector::getTriangles(core::triangle3df* triangles,
 		if (tIndex + TrianglePatches.TrianglePatchArray[i].NumTriangles <= count
             && TrianglePatches.TrianglePatchArray[i].Box.intersectsWithLine(line))
 		{
-			for (s32 j=0; j<TrianglePatches.TrianglePatchArray[i].NumTriangles; ++j)
-			{
-				triangles[tIndex] = TrianglePatches.TrianglePatchArray[i].Triangles[j];
-
-				mat.transformVect(triangles[tIndex].pointA);
-				mat.transformVect(triangles[tIndex].pointB);
-				mat.transformVect(triangles[tIndex].pointC);
-
-				++tIndex;
-			}
+			mat.transformTriangles(triangles + tIndex,
+				TrianglePatches.TrianglePatchArray[i].Triangles.const_pointer(),
+				TrianglePatches.TrianglePatchArray[i].NumTriangles);
+			tIndex += TrianglePatches.TrianglePatchArray[i].NumTriangles;
 		}
 	}
 
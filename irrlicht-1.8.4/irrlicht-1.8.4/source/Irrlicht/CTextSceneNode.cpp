@@ -94,7 +94,7 @@ CBillboardTextSceneNode::CBillboardTextSceneNode(ISceneNode* parent, ISceneManag
 	const core::vector3df& position, const core::dimension2d<f32>& size,
 	video::SColor colorTop,video::SColor shade_bottom )
 : IBillboardTextSceneNode(parent, mgr, id, position),
-	Font(0), ColorTop(colorTop), ColorBottom(shade_bottom), Mesh(0)
+	Font(0), TextureRect(0.f, 0.f, 1.f, 1.f), ColorTop(colorTop), ColorBottom(shade_bottom), Mesh(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CBillboardTextSceneNode");
@@ -127,6 +127,17 @@ namespace scene
 			topEdgeWidth = Size.Width;
 		}
 
+		//! the texture coordinates of the text come from the glyphs of the font
+		virtual void setTextureRect(const core::rect<f32>& rect)
+		{
+			TextureRect = rect;
+		}
+
+		virtual const core::rect<f32>& getTextureRect() const
+		{
+			return TextureRect;
+		}
+
 	private:
 
 		core::stringw Text;
@@ -134,6 +145,7 @@ namespace scene
 		gui::IGUIFontBitmap* Font;
 
 		core::dimension2d<f32> Size;
+		core::rect<f32> TextureRect;
 		core::aabbox3d<f32> BBox;
 		video::SMaterial Material;
 
@@ -0,0 +1,398 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CTextureAtlas.h"
+#include "IVideoDriver.h"
+#include "IImage.h"
+#include "ITexture.h"
+#include "CColorConverter.h"
+#include "os.h"
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+	//! Sorts the images to pack, tall ones first
+	struct SPackOrder
+	{
+		u32 Index;
+		u32 Width;
+		u32 Height;
+
+		bool operator<(const SPackOrder& other) const
+		{
+			if (Height != other.Height)
+				return Height > other.Height;
+			if (Width != other.Width)
+				return Width > other.Width;
+			return Index < other.Index;
+		}
+	};
+}
+
+
+//! constructor
+CTextureAtlas::CTextureAtlas(IVideoDriver* driver, const io::path& name,
+		const core::dimension2d<u32>& pageSize, u32 padding)
+	: Driver(driver), Name(name), PageSize(pageSize), Padding((s32)padding)
+{
+	#ifdef _DEBUG
+	setDebugName("CTextureAtlas");
+	#endif
+
+	if (Driver)
+		Driver->grab();
+}
+
+
+//! destructor
+CTextureAtlas::~CTextureAtlas()
+{
+	for (u32 i=0; i<Entries.size(); ++i)
+		if (Entries[i].Image)
+			Entries[i].Image->drop();
+
+	for (u32 i=0; i<Pages.size(); ++i)
+		Pages[i]->drop();
+
+	if (Driver)
+		Driver->drop();
+}
+
+
+//! Adds an image to be packed with the next call of build().
+bool CTextureAtlas::addImage(const io::path& name, IImage* image)
+{
+	if (!image || EntryIndex.find(name))
+		return false;
+
+	switch (image->getColorFormat())
+	{
+	case ECF_A1R5G5B5:
+	case ECF_R5G6B5:
+	case ECF_R8G8B8:
+	case ECF_A8R8G8B8:
+	case ECF_DXT1:
+	case ECF_DXT5:
+		break;
+	default:
+		os::Printer::log("Unsupported color format of image for texture atlas", name, ELL_WARNING);
+		return false;
+	}
+
+	const core::dimension2d<u32> slot = getSlotSize(image->getDimension());
+	if (slot.Width > PageSize.Width || slot.Height > PageSize.Height)
+	{
+		os::Printer::log("Image too large for texture atlas", name, ELL_WARNING);
+		return false;
+	}
+
+	SEntry entry;
+	entry.Image = image;
+	entry.Page = -1;
+	image->grab();
+
+	EntryIndex.insert(name, Entries.size());
+	Entries.push_back(entry);
+	return true;
+}
+
+
+//! Loads an image from a file and adds it to be packed with the next call of build().
+bool CTextureAtlas::addImage(const io::path& filename)
+{
+	if (!Driver)
+		return false;
+
+	IImage* image = Driver->createImageFromFile(filename);
+	if (!image)
+		return false;
+
+	const bool ret = addImage(filename, image);
+	image->drop();
+	return ret;
+}
+
+
+//! Packs all images added since the last call and creates the textures of their pages.
+bool CTextureAtlas::build()
+{
+	core::array<SPackOrder> order;
+	for (u32 i=0; i<Entries.size(); ++i)
+	{
+		if (!Entries[i].Image)
+			continue;
+
+		const core::dimension2d<u32> slot = getSlotSize(Entries[i].Image->getDimension());
+		SPackOrder o;
+		o.Index = i;
+		o.Width = slot.Width;
+		o.Height = slot.Height;
+		order.push_back(o);
+	}
+	if (order.empty())
+		return true;
+	order.sort();
+
+	bool ret = true;
+	core::array<SPackOrder> remaining;
+
+	// fill one page after the other, images not fitting anymore are tried on the next one
+	while (!order.empty())
+	{
+		Skyline.set_used(1);
+		Skyline[0].X = 0;
+		Skyline[0].Y = 0;
+		Skyline[0].Width = (s32)PageSize.Width;
+
+		IImage* page = Driver ? Driver->createImage(ECF_A8R8G8B8, PageSize) : 0;
+		if (!page)
+			return false;
+		page->fill(SColor(0));
+
+		const s32 pageIndex = (s32)Pages.size();
+		remaining.set_used(0);
+
+		for (u32 i=0; i<order.size(); ++i)
+		{
+			s32 x, y;
+			u32 node;
+			if (!findPosition((s32)order[i].Width, (s32)order[i].Height, x, y, node))
+			{
+				remaining.push_back(order[i]);
+				continue;
+			}
+			addToSkyline(node, x, y, (s32)order[i].Width, (s32)order[i].Height);
+
+			SEntry& entry = Entries[order[i].Index];
+			const core::dimension2d<u32>& size = entry.Image->getDimension();
+			entry.Page = pageIndex;
+			entry.Rect = core::rect<s32>(x + Padding, y + Padding,
+				x + Padding + (s32)size.Width, y + Padding + (s32)size.Height);
+
+			copyToPage(page, entry.Image, core::rect<s32>(x, y,
+				x + (s32)order[i].Width, y + (s32)order[i].Height));
+
+			entry.Image->drop();
+			entry.Image = 0;
+		}
+
+		io::path pageName(Name);
+		pageName += "#";
+		pageName += io::path(pageIndex);
+
+		ITexture* texture = Driver->addTexture(pageName, page);
+		page->drop();
+
+		if (texture)
+			texture->grab();
+		else
+			ret = false;
+		Pages.push_back(texture);
+
+		order.swap(remaining);
+	}
+
+	Skyline.clear();
+	return ret;
+}
+
+
+//! Returns the amount of images in the atlas
+u32 CTextureAtlas::getImageCount() const
+{
+	return Entries.size();
+}
+
+
+//! Returns the page texture of an image.
+ITexture* CTextureAtlas::getTexture(const io::path& name, core::rect<s32>* sourceRect) const
+{
+	const core::hash_map<io::path, u32>::Node* n = EntryIndex.find(name);
+	if (!n)
+		return 0;
+
+	const SEntry& entry = Entries[n->getValue()];
+	if (entry.Page < 0)
+		return 0;
+
+	if (sourceRect)
+		*sourceRect = entry.Rect;
+	return Pages[entry.Page];
+}
+
+
+//! Returns the texture coordinates of an image on its page.
+core::rect<f32> CTextureAtlas::getTextureCoords(const io::path& name) const
+{
+	const core::hash_map<io::path, u32>::Node* n = EntryIndex.find(name);
+	if (!n || Entries[n->getValue()].Page < 0)
+		return core::rect<f32>(0.f, 0.f, 1.f, 1.f);
+
+	const core::rect<s32>& r = Entries[n->getValue()].Rect;
+	const f32 w = (f32)PageSize.Width;
+	const f32 h = (f32)PageSize.Height;
+	return core::rect<f32>(r.UpperLeftCorner.X / w, r.UpperLeftCorner.Y / h,
+		r.LowerRightCorner.X / w, r.LowerRightCorner.Y / h);
+}
+
+
+//! Returns the amount of pages
+u32 CTextureAtlas::getPageCount() const
+{
+	return Pages.size();
+}
+
+
+//! Returns the texture of a page.
+ITexture* CTextureAtlas::getPage(u32 index) const
+{
+	return index < Pages.size() ? Pages[index] : 0;
+}
+
+
+//! Returns the size of the pages
+const core::dimension2d<u32>& CTextureAtlas::getPageSize() const
+{
+	return PageSize;
+}
+
+
+//! Area reserved for an image, with borders and rounded up to multiples of 4
+core::dimension2d<u32> CTextureAtlas::getSlotSize(const core::dimension2d<u32>& imageSize) const
+{
+	return core::dimension2d<u32>((imageSize.Width + 2*(u32)Padding + 3) & ~3u,
+		(imageSize.Height + 2*(u32)Padding + 3) & ~3u);
+}
+
+
+//! Finds the lowest position for a slot on the current page, false if it doesn't fit
+bool CTextureAtlas::findPosition(s32 width, s32 height, s32& x, s32& y, u32& node) const
+{
+	s32 bestBottom = 0x7fffffff;
+	s32 bestWidth = 0x7fffffff;
+
+	for (u32 i=0; i<Skyline.size(); ++i)
+	{
+		const s32 left = Skyline[i].X;
+		if (left + width > (s32)PageSize.Width)
+			break;
+
+		// the slot rests on the highest segment below it
+		s32 top = 0;
+		s32 widthLeft = width;
+		for (u32 j=i; widthLeft > 0; ++j)
+		{
+			top = core::max_(top, Skyline[j].Y);
+			widthLeft -= Skyline[j].Width;
+		}
+
+		const s32 bottom = top + height;
+		if (bottom > (s32)PageSize.Height)
+			continue;
+
+		if (bottom < bestBottom || (bottom == bestBottom && Skyline[i].Width < bestWidth))
+		{
+			bestBottom = bottom;
+			bestWidth = Skyline[i].Width;
+			x = left;
+			y = top;
+			node = i;
+		}
+	}
+
+	return bestBottom != 0x7fffffff;
+}
+
+
+//! Adds a slot placed at x,y to the skyline
+void CTextureAtlas::addToSkyline(u32 node, s32 x, s32 y, s32 width, s32 height)
+{
+	SSkylineNode n;
+	n.X = x;
+	n.Y = y + height;
+	n.Width = width;
+	Skyline.insert(n, node);
+
+	// cut the segments below the slot away
+	for (u32 i=node+1; i<Skyline.size(); )
+	{
+		const s32 end = Skyline[i-1].X + Skyline[i-1].Width;
+		if (Skyline[i].X >= end)
+			break;
+
+		const s32 shrink = end - Skyline[i].X;
+		Skyline[i].X += shrink;
+		Skyline[i].Width -= shrink;
+		if (Skyline[i].Width > 0)
+			break;
+		Skyline.erase(i);
+	}
+
+	// merge neighbours of the same height
+	for (u32 i=0; i+1<Skyline.size(); )
+	{
+		if (Skyline[i].Y == Skyline[i+1].Y)
+		{
+			Skyline[i].Width += Skyline[i+1].Width;
+			Skyline.erase(i+1);
+		}
+		else
+			++i;
+	}
+}
+
+
+//! Copies an image onto a page and fills its slot with the edge texels
+void CTextureAtlas::copyToPage(IImage* page, IImage* image, const core::rect<s32>& slot) const
+{
+	const core::dimension2d<u32>& size = image->getDimension();
+	const s32 width = (s32)size.Width;
+	const s32 height = (s32)size.Height;
+	const ECOLOR_FORMAT format = image->getColorFormat();
+
+	// convert the image into the format of the page first
+	core::array<u32> texels;
+	texels.set_used(width * height);
+
+	const u8* src = (const u8*)image->lock();
+	if (IImage::isCompressedFormat(format))
+		CColorConverter::convert_DXTtoA8R8G8B8(src, format, width, height, texels.pointer());
+	else
+	{
+		for (s32 y=0; y<height; ++y)
+			CColorConverter::convert_viaFormat(src + y * image->getPitch(), format, width,
+				texels.pointer() + y * width, ECF_A8R8G8B8);
+	}
+	image->unlock();
+
+	// the borders repeat the texels of the nearest edge
+	u8* dst = (u8*)page->lock();
+	const u32 pitch = page->getPitch();
+	const s32 left = slot.UpperLeftCorner.X + Padding;
+	const s32 top = slot.UpperLeftCorner.Y + Padding;
+
+	for (s32 y=slot.UpperLeftCorner.Y; y<slot.LowerRightCorner.Y; ++y)
+	{
+		const u32* row = texels.const_pointer() + core::s32_clamp(y - top, 0, height - 1) * width;
+		u32* out = (u32*)(dst + y * pitch);
+
+		s32 x = slot.UpperLeftCorner.X;
+		for (; x<left; ++x)
+			out[x] = row[0];
+		memcpy(out + x, row, width * sizeof(u32));
+		for (x+=width; x<slot.LowerRightCorner.X; ++x)
+			out[x] = row[width - 1];
+	}
+
+	page->unlock();
+}
+
+
+} // end namespace video
+} // end namespace irr
+
@@ -0,0 +1,110 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_TEXTURE_ATLAS_H_INCLUDED__
+#define __C_TEXTURE_ATLAS_H_INCLUDED__
+
+#include "ITextureAtlas.h"
+#include "irrArray.h"
+#include "irrHashMap.h"
+
+namespace irr
+{
+namespace video
+{
+	class IVideoDriver;
+
+	//! Texture atlas packing the images with a skyline bottom left packer
+	/** The skyline is the upper outline of the areas used on a page so
+	far. Each image is put onto the position of the skyline where its upper
+	edge ends up lowest, tall images first, which wastes few space for the
+	sprites and glyphs atlases are usually built from, and is much simpler
+	than keeping track of all free rectangles. */
+	class CTextureAtlas : public ITextureAtlas
+	{
+	public:
+
+		//! constructor
+		CTextureAtlas(IVideoDriver* driver, const io::path& name,
+			const core::dimension2d<u32>& pageSize, u32 padding);
+
+		//! destructor
+		virtual ~CTextureAtlas();
+
+		//! Adds an image to be packed with the next call of build().
+		virtual bool addImage(const io::path& name, IImage* image);
+
+		//! Loads an image from a file and adds it to be packed with the next call of build().
+		virtual bool addImage(const io::path& filename);
+
+		//! Packs all images added since the last call and creates the textures of their pages.
+		virtual bool build();
+
+		//! Returns the amount of images in the atlas
+		virtual u32 getImageCount() const;
+
+		//! Returns the page texture of an image.
+		virtual ITexture* getTexture(const io::path& name, core::rect<s32>* sourceRect=0) const;
+
+		//! Returns the texture coordinates of an image on its page.
+		virtual core::rect<f32> getTextureCoords(const io::path& name) const;
+
+		//! Returns the amount of pages
+		virtual u32 getPageCount() const;
+
+		//! Returns the texture of a page.
+		virtual ITexture* getPage(u32 index) const;
+
+		//! Returns the size of the pages
+		virtual const core::dimension2d<u32>& getPageSize() const;
+
+	private:
+
+		struct SEntry
+		{
+			//! image until it is packed
+			IImage* Image;
+			//! page index, -1 until it is packed
+			s32 Page;
+			//! area of the image on the page
+			core::rect<s32> Rect;
+		};
+
+		//! Horizontal line segment of the skyline
+		struct SSkylineNode
+		{
+			s32 X;
+			s32 Y;
+			s32 Width;
+		};
+
+		//! Area reserved for an image, with borders and rounded up to multiples of 4
+		core::dimension2d<u32> getSlotSize(const core::dimension2d<u32>& imageSize) const;
+
+		//! Finds the lowest position for a slot on the current page, false if it doesn't fit
+		bool findPosition(s32 width, s32 height, s32& x, s32& y, u32& node) const;
+
+		//! Adds a slot placed at x,y to the skyline
+		void addToSkyline(u32 node, s32 x, s32 y, s32 width, s32 height);
+
+		//! Copies an image onto a page and fills its slot with the edge texels
+		void copyToPage(IImage* page, IImage* image, const core::rect<s32>& slot) const;
+
+		IVideoDriver* Driver;
+		io::path Name;
+		core::dimension2d<u32> PageSize;
+		s32 Padding;
+
+		core::array<SEntry> Entries;
+		core::hash_map<io::path, u32> EntryIndex;
+		core::array<ITexture*> Pages;
+
+		core::array<SSkylineNode> Skyline;
+	};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
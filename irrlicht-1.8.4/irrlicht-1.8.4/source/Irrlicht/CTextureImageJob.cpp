@@ -0,0 +1,149 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CTextureImageJob.h"
+#include "IVideoDriver.h"
+#include "IFileSystem.h"
+#include "IReadFile.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! constructor
+CTextureImageJob::CTextureImageJob()
+: FileSystem(0), Driver(0), File(0), Image(0), Texture(0)
+{
+}
+
+
+//! Sets the file of the texture, like IVideoDriver::getTexture() finds it
+ITexture* CTextureImageJob::setFile(IVideoDriver* driver, io::IFileSystem* fileSystem,
+	const io::path& filename)
+{
+	Driver = driver;
+	FileSystem = fileSystem;
+	Path = filename;
+	AbsolutePath = FileSystem->getAbsolutePath(filename);
+
+	Texture = Driver->findTexture(AbsolutePath);
+	if (!Texture)
+		Texture = Driver->findTexture(Path);
+	return Texture;
+}
+
+
+//! Prepares the job before it is added to the pool
+bool CTextureImageJob::prepare()
+{
+	if (Texture)
+		return false;
+
+	if (!FileSystem->getFileArchiveCount())
+		return true;
+
+	io::IReadFile* file = FileSystem->createAndOpenFile(AbsolutePath);
+	if (!file)
+		file = FileSystem->createAndOpenFile(Path);
+	if (!file)
+		return false;
+
+	// Re-check name for actual archive names
+	FileName = file->getFileName();
+	Texture = Driver->findTexture(FileName);
+	if (!Texture)
+	{
+		const long size = file->getSize();
+		c8* data = new c8[size];
+		if (file->read(data, size) == size)
+			File = FileSystem->createMemoryReadFile(data, size, FileName, true);
+		else
+			delete [] data;
+	}
+	file->drop();
+
+	return File != 0;
+}
+
+
+//! Reads and decodes the image
+void CTextureImageJob::run()
+{
+	io::IReadFile* file = File;
+	if (!file)
+	{
+		// open the file like IVideoDriver::getTexture() does
+		file = FileSystem->createAndOpenFile(AbsolutePath);
+		if (!file)
+			file = FileSystem->createAndOpenFile(Path);
+		if (!file)
+			return;
+	}
+
+	FileName = file->getFileName();
+
+	// the image loaders log, which is done later on the loading thread
+	core::array<os::SLogMessage>* previous = os::Printer::setMessageBuffer(&Messages);
+	Image = Driver->createTextureImageFromFile(file);
+	os::Printer::setMessageBuffer(previous);
+
+	if (file != File)
+		file->drop();
+}
+
+
+//! Creates the texture after the job ran
+ITexture* CTextureImageJob::createTexture()
+{
+	os::Printer::log(Messages);
+	Messages.clear();
+
+	if (File)
+		File->drop();
+	File = 0;
+
+	if (Image)
+	{
+		// Re-check name for actual archive names
+		Texture = Driver->findTexture(FileName);
+		if (!Texture)
+		{
+			Texture = Driver->addTexture(FileName, Image);
+			os::Printer::log("Loaded texture", FileName);
+		}
+		Image->drop();
+		Image = 0;
+	}
+
+	if (!Texture)
+	{
+		if (FileName.size())
+			os::Printer::log("Could not load texture", Path, ELL_ERROR);
+		else
+			os::Printer::log("Could not open file of texture", Path, ELL_WARNING);
+	}
+
+	return Texture;
+}
+
+
+//! Frees what the job loaded, if its texture isn't created
+void CTextureImageJob::clear()
+{
+	if (File)
+		File->drop();
+	File = 0;
+
+	if (Image)
+		Image->drop();
+	Image = 0;
+
+	Messages.clear();
+}
+
+
+} // end namespace video
+} // end namespace irr
+
@@ -0,0 +1,88 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_TEXTURE_IMAGE_JOB_H_INCLUDED__
+#define __C_TEXTURE_IMAGE_JOB_H_INCLUDED__
+
+#include "CThreadPool.h"
+#include "path.h"
+#include "os.h"
+
+namespace irr
+{
+namespace io
+{
+	class IFileSystem;
+	class IReadFile;
+}
+namespace video
+{
+	class IVideoDriver;
+	class IImage;
+	class ITexture;
+
+//! Reads and decodes the image of a texture on the thread pool
+/** Used by IVideoDriver::getTextures() and the scene loaders which read
+ahead. setFile(), prepare() and createTexture() are called on the loading
+thread, run() on a worker. The job doesn't free what it loaded on its own,
+so it can be kept in a core::array, call createTexture() or clear(). */
+class CTextureImageJob : public IThreadJob
+{
+public:
+
+	//! constructor
+	CTextureImageJob();
+
+	//! Sets the file of the texture, like IVideoDriver::getTexture() finds it
+	/** \return The texture if it is loaded already, the job isn't needed then. */
+	ITexture* setFile(IVideoDriver* driver, io::IFileSystem* fileSystem, const io::path& filename);
+
+	//! Prepares the job before it is added to the pool
+	/** Archives read their files through one shared file, so files which
+	might be in an archive are read here, and only decoded by the worker.
+	\return False if the job doesn't need to run. */
+	bool prepare();
+
+	//! Reads and decodes the image
+	virtual void run();
+
+	//! Creates the texture after the job ran
+	/** Logs the messages of the image loader and whether the texture
+	could be loaded.
+	\return The texture, or 0 if it could not be loaded. */
+	ITexture* createTexture();
+
+	//! Frees what the job loaded, if its texture isn't created
+	void clear();
+
+	//! Returns the texture created by createTexture()
+	ITexture* getTexture() const { return Texture; }
+
+	//! Returns the absolute path of the file
+	const io::path& getAbsolutePath() const { return AbsolutePath; }
+
+	CThreadPool::SJobGroup Group;
+
+private:
+
+	//! filename as passed by the user
+	io::path Path;
+	io::path AbsolutePath;
+	//! name of the file which was read, empty if it couldn't be opened
+	io::path FileName;
+	io::IFileSystem* FileSystem;
+	IVideoDriver* Driver;
+	//! file read on the loading thread already, 0 to open it on the worker
+	io::IReadFile* File;
+	IImage* Image;
+	ITexture* Texture;
+	//! messages of the image loader
+	core::array<os::SLogMessage> Messages;
+};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
@@ -0,0 +1,418 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CThreadPool.h"
+
+#if defined(_IRR_WINDOWS_API_)
+	#ifdef _IRR_XBOX_PLATFORM_
+	#include <xtl.h>
+	#else
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+	#endif
+#else
+	#include <unistd.h>
+	#if defined(_IRR_COMPILE_WITH_THREADS_)
+	#include <pthread.h>
+	#endif
+#endif
+
+namespace irr
+{
+
+CThreadPool* CThreadPool::SharedPool = 0;
+u32 CThreadPool::SharedPoolUsers = 0;
+
+namespace
+{
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_IRR_WINDOWS_API_)
+	// a spin lock needs no initialization, so it works before main()
+	volatile LONG SharedPoolLock = 0;
+
+	void lockSharedPool()
+	{
+		while (InterlockedCompareExchange(&SharedPoolLock, 1, 0) != 0)
+			Sleep(0);
+	}
+
+	void unlockSharedPool()
+	{
+		InterlockedExchange(&SharedPoolLock, 0);
+	}
+#elif defined(_IRR_COMPILE_WITH_THREADS_)
+	pthread_mutex_t SharedPoolLock = PTHREAD_MUTEX_INITIALIZER;
+
+	void lockSharedPool()
+	{
+		pthread_mutex_lock(&SharedPoolLock);
+	}
+
+	void unlockSharedPool()
+	{
+		pthread_mutex_unlock(&SharedPoolLock);
+	}
+#else
+	void lockSharedPool() {}
+	void unlockSharedPool() {}
+#endif
+}
+
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_IRR_WINDOWS_API_)
+
+struct CThreadPool::SPlatformData
+{
+	CRITICAL_SECTION Lock;
+	//! counts queued jobs for the workers
+	HANDLE JobSemaphore;
+	//! pulsed whenever a job finished
+	HANDLE JobDone;
+	core::array<HANDLE> Threads;
+};
+
+#elif defined(_IRR_COMPILE_WITH_THREADS_)
+
+struct CThreadPool::SPlatformData
+{
+	pthread_mutex_t Lock;
+	pthread_cond_t JobAdded;
+	pthread_cond_t JobDone;
+	core::array<pthread_t> Threads;
+};
+
+#else
+
+struct CThreadPool::SPlatformData
+{
+};
+
+#endif
+
+
+//! constructor
+CThreadPool::CThreadPool(u32 threadCount)
+	: QueueHead(0), ThreadCount(0), Quit(false), Platform(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CThreadPool");
+	#endif
+
+	Platform = new SPlatformData();
+
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+	if (!threadCount)
+		threadCount = getProcessorCount() - 1;
+
+#if defined(_IRR_WINDOWS_API_)
+	InitializeCriticalSection(&Platform->Lock);
+	Platform->JobSemaphore = CreateSemaphore(0, 0, 0x7fffffff, 0);
+	Platform->JobDone = CreateEvent(0, FALSE, FALSE, 0);
+
+	for (u32 i=0; i<threadCount; ++i)
+	{
+		HANDLE thread = CreateThread(0, 0, workerEntry, this, 0, 0);
+		if (!thread)
+			break;
+		Platform->Threads.push_back(thread);
+	}
+	ThreadCount = Platform->Threads.size();
+#else
+	pthread_mutex_init(&Platform->Lock, 0);
+	pthread_cond_init(&Platform->JobAdded, 0);
+	pthread_cond_init(&Platform->JobDone, 0);
+
+	for (u32 i=0; i<threadCount; ++i)
+	{
+		pthread_t thread;
+		if (pthread_create(&thread, 0, workerEntry, this))
+			break;
+		Platform->Threads.push_back(thread);
+	}
+	ThreadCount = Platform->Threads.size();
+#endif
+#endif
+}
+
+
+//! destructor
+CThreadPool::~CThreadPool()
+{
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+#if defined(_IRR_WINDOWS_API_)
+	EnterCriticalSection(&Platform->Lock);
+	Quit = true;
+	LeaveCriticalSection(&Platform->Lock);
+	ReleaseSemaphore(Platform->JobSemaphore, ThreadCount, 0);
+
+	for (u32 i=0; i<Platform->Threads.size(); ++i)
+	{
+		WaitForSingleObject(Platform->Threads[i], INFINITE);
+		CloseHandle(Platform->Threads[i]);
+	}
+
+	CloseHandle(Platform->JobDone);
+	CloseHandle(Platform->JobSemaphore);
+	DeleteCriticalSection(&Platform->Lock);
+#else
+	pthread_mutex_lock(&Platform->Lock);
+	Quit = true;
+	pthread_cond_broadcast(&Platform->JobAdded);
+	pthread_mutex_unlock(&Platform->Lock);
+
+	for (u32 i=0; i<Platform->Threads.size(); ++i)
+		pthread_join(Platform->Threads[i], 0);
+
+	pthread_cond_destroy(&Platform->JobDone);
+	pthread_cond_destroy(&Platform->JobAdded);
+	pthread_mutex_destroy(&Platform->Lock);
+#endif
+#endif
+
+	delete Platform;
+}
+
+
+//! Queues a job.
+void CThreadPool::addJob(IThreadJob* job, SJobGroup& group)
+{
+	if (!job)
+		return;
+
+	SQueuedJob q;
+	q.Job = job;
+	q.Group = &group;
+
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_IRR_WINDOWS_API_)
+	EnterCriticalSection(&Platform->Lock);
+	++group.Pending;
+	Queue.push_back(q);
+	LeaveCriticalSection(&Platform->Lock);
+	ReleaseSemaphore(Platform->JobSemaphore, 1, 0);
+#elif defined(_IRR_COMPILE_WITH_THREADS_)
+	pthread_mutex_lock(&Platform->Lock);
+	++group.Pending;
+	Queue.push_back(q);
+	pthread_cond_signal(&Platform->JobAdded);
+	pthread_mutex_unlock(&Platform->Lock);
+#else
+	++group.Pending;
+	Queue.push_back(q);
+#endif
+}
+
+
+//! Runs queued jobs until all jobs of the group have finished
+void CThreadPool::waitForJobs(SJobGroup& group)
+{
+	SQueuedJob job;
+
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_IRR_WINDOWS_API_)
+	EnterCriticalSection(&Platform->Lock);
+	while (group.Pending)
+	{
+		if (popJob(job))
+		{
+			LeaveCriticalSection(&Platform->Lock);
+			// the semaphore still counts this job, a worker will find the queue empty
+			job.Job->run();
+			EnterCriticalSection(&Platform->Lock);
+			finishJob(job);
+		}
+		else
+		{
+			LeaveCriticalSection(&Platform->Lock);
+			// short timeout, several threads may be waiting on the same pulse
+			WaitForSingleObject(Platform->JobDone, 1);
+			EnterCriticalSection(&Platform->Lock);
+		}
+	}
+	LeaveCriticalSection(&Platform->Lock);
+#elif defined(_IRR_COMPILE_WITH_THREADS_)
+	pthread_mutex_lock(&Platform->Lock);
+	while (group.Pending)
+	{
+		if (popJob(job))
+		{
+			pthread_mutex_unlock(&Platform->Lock);
+			job.Job->run();
+			pthread_mutex_lock(&Platform->Lock);
+			finishJob(job);
+		}
+		else
+			pthread_cond_wait(&Platform->JobDone, &Platform->Lock);
+	}
+	pthread_mutex_unlock(&Platform->Lock);
+#else
+	while (group.Pending && popJob(job))
+	{
+		job.Job->run();
+		finishJob(job);
+	}
+#endif
+}
+
+
+//! Returns the amount of worker threads
+u32 CThreadPool::getThreadCount() const
+{
+	return ThreadCount;
+}
+
+
+//! Returns the amount of processors available to the process
+u32 CThreadPool::getProcessorCount()
+{
+#if defined(_IRR_WINDOWS_API_) && !defined(_IRR_XBOX_PLATFORM_)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return core::max_((u32)info.dwNumberOfProcessors, 1u);
+#elif defined(_SC_NPROCESSORS_ONLN)
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (u32)count : 1;
+#else
+	return 1;
+#endif
+}
+
+
+//! Returns the pool shared by the engine
+CThreadPool* CThreadPool::getSharedPool()
+{
+	lockSharedPool();
+	// without a device nobody would drop a new pool again
+	if (!SharedPool && SharedPoolUsers)
+		SharedPool = new CThreadPool();
+	CThreadPool* pool = SharedPool;
+	unlockSharedPool();
+	return pool;
+}
+
+
+//! Registers a user of the shared pool
+void CThreadPool::grabSharedPool()
+{
+	lockSharedPool();
+	++SharedPoolUsers;
+	unlockSharedPool();
+}
+
+
+//! Releases the shared pool when its last user is gone
+void CThreadPool::dropSharedPool()
+{
+	CThreadPool* pool = 0;
+
+	lockSharedPool();
+	if (SharedPoolUsers && --SharedPoolUsers == 0)
+	{
+		pool = SharedPool;
+		SharedPool = 0;
+	}
+	unlockSharedPool();
+
+	// joins the workers, so not while holding the lock
+	if (pool)
+		pool->drop();
+}
+
+
+//! takes the oldest job from the queue, lock must be held
+bool CThreadPool::popJob(SQueuedJob& out)
+{
+	if (QueueHead >= Queue.size())
+		return false;
+
+	out = Queue[QueueHead++];
+	if (QueueHead == Queue.size())
+	{
+		Queue.set_used(0);
+		QueueHead = 0;
+	}
+	return true;
+}
+
+
+//! marks a job as done and wakes up waiting threads, lock must be held
+void CThreadPool::finishJob(SQueuedJob& job)
+{
+	--job.Group->Pending;
+
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_IRR_WINDOWS_API_)
+	SetEvent(Platform->JobDone);
+#elif defined(_IRR_COMPILE_WITH_THREADS_)
+	pthread_cond_broadcast(&Platform->JobDone);
+#endif
+}
+
+
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+
+void CThreadPool::workerLoop()
+{
+	SQueuedJob job;
+
+#if defined(_IRR_WINDOWS_API_)
+	for (;;)
+	{
+		WaitForSingleObject(Platform->JobSemaphore, INFINITE);
+
+		EnterCriticalSection(&Platform->Lock);
+		if (Quit)
+		{
+			LeaveCriticalSection(&Platform->Lock);
+			return;
+		}
+		const bool found = popJob(job);
+		LeaveCriticalSection(&Platform->Lock);
+
+		if (!found)
+			continue;
+
+		job.Job->run();
+
+		EnterCriticalSection(&Platform->Lock);
+		finishJob(job);
+		LeaveCriticalSection(&Platform->Lock);
+	}
+#else
+	pthread_mutex_lock(&Platform->Lock);
+	for (;;)
+	{
+		if (Quit)
+			break;
+
+		if (popJob(job))
+		{
+			pthread_mutex_unlock(&Platform->Lock);
+			job.Job->run();
+			pthread_mutex_lock(&Platform->Lock);
+			finishJob(job);
+		}
+		else
+			pthread_cond_wait(&Platform->JobAdded, &Platform->Lock);
+	}
+	pthread_mutex_unlock(&Platform->Lock);
+#endif
+}
+
+
+#if defined(_IRR_WINDOWS_API_)
+unsigned long __stdcall CThreadPool::workerEntry(void* data)
+#else
+void* CThreadPool::workerEntry(void* data)
+#endif
+{
+	((CThreadPool*)data)->workerLoop();
+	return 0;
+}
+
+#else
+
+void CThreadPool::workerLoop()
+{
+}
+
+#endif
+
+} // end namespace irr
+
@@ -0,0 +1,180 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_THREAD_POOL_H_INCLUDED__
+#define __C_THREAD_POOL_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+#include "IReferenceCounted.h"
+#include "irrArray.h"
+#include "irrMath.h"
+
+namespace irr
+{
+
+//! A piece of work which can be run by a CThreadPool
+/** Jobs are run on worker threads, so they must not grab() or drop()
+objects which are shared with other threads. Messages they log have to be
+collected with os::Printer::setMessageBuffer() and logged after the job. */
+class IThreadJob
+{
+public:
+
+	virtual ~IThreadJob() {}
+
+	//! Does the work
+	virtual void run() = 0;
+};
+
+
+//! Simple pool of worker threads for expensive, independent work.
+/** Jobs are collected in groups. Waiting for a group lets the waiting
+thread run queued jobs itself, so jobs may start and wait for jobs of
+their own without deadlocking the pool. Without _IRR_COMPILE_WITH_THREADS_
+the pool has no workers and all jobs run inside waitForJobs(). */
+class CThreadPool : public virtual IReferenceCounted
+{
+public:
+
+	//! Counts the unfinished jobs of one batch
+	struct SJobGroup
+	{
+		SJobGroup() : Pending(0) {}
+
+		u32 Pending;
+	};
+
+	//! constructor
+	/** \param threadCount Amount of worker threads, 0 for one less than
+	the number of processors. */
+	CThreadPool(u32 threadCount=0);
+
+	//! destructor, waits for the workers to finish
+	virtual ~CThreadPool();
+
+	//! Queues a job.
+	/** The pool does not own the job, it must stay alive until
+	waitForJobs() for its group returned. */
+	void addJob(IThreadJob* job, SJobGroup& group);
+
+	//! Runs queued jobs until all jobs of the group have finished
+	void waitForJobs(SJobGroup& group);
+
+	//! Returns the amount of worker threads, not counting the caller
+	u32 getThreadCount() const;
+
+	//! Returns the amount of processors available to the process
+	static u32 getProcessorCount();
+
+	//! Returns the pool shared by the engine
+	/** The pool is created on first use while a device is alive and lives
+	until the last device is destroyed.
+	\return The shared pool, or 0 if no device is alive. Run the work on
+	the calling thread then. */
+	static CThreadPool* getSharedPool();
+
+	//! Registers a user of the shared pool, called when a device is created
+	/** Doesn't create the pool, so devices which never use it don't start
+	worker threads. */
+	static void grabSharedPool();
+
+	//! Releases the shared pool, called when a device is destroyed
+	static void dropSharedPool();
+
+private:
+
+	struct SQueuedJob
+	{
+		IThreadJob* Job;
+		SJobGroup* Group;
+	};
+
+	struct SPlatformData;
+
+	bool popJob(SQueuedJob& out);
+	void finishJob(SQueuedJob& job);
+	void workerLoop();
+
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+#if defined(_IRR_WINDOWS_API_)
+	static unsigned long __stdcall workerEntry(void* data);
+#else
+	static void* workerEntry(void* data);
+#endif
+#endif
+
+	core::array<SQueuedJob> Queue;
+	u32 QueueHead;
+	u32 ThreadCount;
+	bool Quit;
+	SPlatformData* Platform;
+
+	static CThreadPool* SharedPool;
+	static u32 SharedPoolUsers;
+};
+
+
+//! Job running a functor on a range of items, used by parallelFor
+template <class T>
+class CRangeJob : public IThreadJob
+{
+public:
+
+	CRangeJob() : Functor(0), Begin(0), End(0) {}
+
+	CRangeJob(T* functor, u32 begin, u32 end)
+		: Functor(functor), Begin(begin), End(end) {}
+
+	virtual void run()
+	{
+		(*Functor)(Begin, End);
+	}
+
+private:
+
+	T* Functor;
+	u32 Begin;
+	u32 End;
+};
+
+
+//! Calls functor(begin, end) for consecutive ranges covering [0,count)
+/** Ranges are spread over the shared thread pool and contain at least
+minBatch items. Small counts are run directly on the calling thread. */
+template <class T>
+inline void parallelFor(u32 count, u32 minBatch, T& functor)
+{
+	if (!count)
+		return;
+
+	CThreadPool* pool = CThreadPool::getSharedPool();
+	const u32 threads = pool ? pool->getThreadCount() + 1 : 1;
+	if (minBatch == 0)
+		minBatch = 1;
+
+	if (threads < 2 || count <= minBatch)
+	{
+		functor(0, count);
+		return;
+	}
+
+	// a few more batches than threads to balance uneven ranges
+	const u32 batchCount = core::min_(threads * 4, (count + minBatch - 1) / minBatch);
+	const u32 batchSize = (count + batchCount - 1) / batchCount;
+
+	core::array< CRangeJob<T> > jobs;
+	jobs.reallocate(batchCount);
+	for (u32 begin=0; begin<count; begin+=batchSize)
+		jobs.push_back(CRangeJob<T>(&functor, begin, core::min_(begin + batchSize, count)));
+
+	CThreadPool::SJobGroup group;
+	for (u32 i=0; i<jobs.size(); ++i)
+		pool->addJob(&jobs[i], group);
+	pool->waitForJobs(group);
+}
+
+} // end namespace irr
+
+#endif
+
@@ -71,6 +71,16 @@ CTriangleSelector::CTriangleSelector(IAnimatedMeshSceneNode* node)
 }
 
 
+namespace
+{
+	//! reads an index of a meshbuffer with 16 or 32 bit indices
+	inline u32 getBufferIndex(const u16* indices, bool large, u32 i)
+	{
+		return large ? ((const u32*)indices)[i] : indices[i];
+	}
+}
+
+
 void CTriangleSelector::createFromMesh(const IMesh* mesh)
 {
 	const u32 cnt = mesh->getMeshBufferCount();
@@ -87,13 +97,14 @@ void CTriangleSelector::createFromMesh(const IMesh* mesh)
 
 		const u32 idxCnt = buf->getIndexCount();
 		const u16* const indices = buf->getIndices();
+		const bool large = (buf->getIndexType() == video::EIT_32BIT);
 
 		for (u32 j=0; j<idxCnt; j+=3)
 		{
 			Triangles.push_back(core::triangle3df(
-					buf->getPosition(indices[j+0]),
-					buf->getPosition(indices[j+1]),
-					buf->getPosition(indices[j+2])));
+					buf->getPosition(getBufferIndex(indices, large, j+0)),
+					buf->getPosition(getBufferIndex(indices, large, j+1)),
+					buf->getPosition(getBufferIndex(indices, large, j+2))));
 			const core::triangle3df& tri = Triangles.getLast();
 			BoundingBox.addInternalPoint(tri.pointA);
 			BoundingBox.addInternalPoint(tri.pointB);
@@ -117,13 +128,14 @@ void CTriangleSelector::updateFromMesh(const IMesh* mesh) const
 		IMeshBuffer* buf = mesh->getMeshBuffer(i);
 		u32 idxCnt = buf->getIndexCount();
 		const u16* indices = buf->getIndices();
+		const bool large = (buf->getIndexType() == video::EIT_32BIT);
 
 		for (u32 index = 0; index < idxCnt; index += 3)
 		{
 			core::triangle3df& tri = Triangles[triangleCount++];
-			tri.pointA = buf->getPosition(indices[index + 0]);
-			tri.pointB = buf->getPosition(indices[index + 1]);
-			tri.pointC = buf->getPosition(indices[index + 2]);
+			tri.pointA = buf->getPosition(getBufferIndex(indices, large, index + 0));
+			tri.pointB = buf->getPosition(getBufferIndex(indices, large, index + 1));
+			tri.pointC = buf->getPosition(getBufferIndex(indices, large, index + 2));
 			BoundingBox.addInternalPoint(tri.pointA);
 			BoundingBox.addInternalPoint(tri.pointB);
 			BoundingBox.addInternalPoint(tri.pointC);
@@ -172,12 +184,7 @@ void CTriangleSelector::getTriangles(core::triangle3df* triangles,
 	if (SceneNode)
 		mat *= SceneNode->getAbsoluteTransformation();
 
-	for (u32 i=0; i<cnt; ++i)
-	{
-		mat.transformVect( triangles[i].pointA, Triangles[i].pointA );
-		mat.transformVect( triangles[i].pointB, Triangles[i].pointB );
-		mat.transformVect( triangles[i].pointC, Triangles[i].pointC );
-	}
+	mat.transformTriangles(triangles, Triangles.const_pointer(), cnt);
 
 	outTriangleCount = cnt;
 }
@@ -222,9 +229,6 @@ void CTriangleSelector::getTriangles(core::triangle3df* triangles,
 		   continue;
 
 		triangles[triangleCount] = Triangles[i];
-		mat.transformVect(triangles[triangleCount].pointA);
-		mat.transformVect(triangles[triangleCount].pointB);
-		mat.transformVect(triangles[triangleCount].pointC);
 
 		++triangleCount;
 
@@ -232,6 +236,9 @@ void CTriangleSelector::getTriangles(core::triangle3df* triangles,
 			break;
 	}
 
+	// transform all found triangles at once
+	mat.transformTriangles(triangles, triangles, triangleCount);
+
 	outTriangleCount = triangleCount;
 }
 
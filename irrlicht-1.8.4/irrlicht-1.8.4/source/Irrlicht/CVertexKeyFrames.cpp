@@ -0,0 +1,163 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#if defined(_IRR_COMPILE_WITH_MD2_LOADER_) || defined(_IRR_COMPILE_WITH_MD3_LOADER_)
+
+#include "CVertexKeyFrames.h"
+#include "irrMath.h"
+#include "irrSIMD.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! constructor
+CVertexKeyFrames::CVertexKeyFrames()
+	: VertexCount(0), Pitch(0)
+{
+}
+
+
+//! Sets the amount of keyframes and vertices, frees all decoded frames
+void CVertexKeyFrames::setSize(u32 frameCount, u32 vertexCount)
+{
+	// set_used() doesn't construct the new elements
+	Frames.clear();
+	Frames.reallocate(frameCount);
+	for (u32 i=0; i<frameCount; ++i)
+		Frames.push_back(core::array<f32>());
+
+	VertexCount = vertexCount;
+
+	// whole groups of four, so the vector code never reads into the next component
+	Pitch = (vertexCount + 3) & ~3u;
+}
+
+
+//! Returns the decoded data of a frame, 0 if it wasn't decoded yet
+const f32* CVertexKeyFrames::getFrame(u32 frame) const
+{
+	if (frame >= Frames.size() || Frames[frame].empty())
+		return 0;
+
+	return Frames[frame].const_pointer();
+}
+
+
+//! Allocates the data of a frame for decoding it
+f32* CVertexKeyFrames::addFrame(u32 frame)
+{
+	if (frame >= Frames.size())
+		return 0;
+
+	core::array<f32>& data = Frames[frame];
+	data.set_used(COMPONENT_COUNT * Pitch);
+	memset(data.pointer(), 0, data.size() * sizeof(f32));
+	return data.pointer();
+}
+
+
+//! Interpolates the positions and normals of two decoded frames into vertices
+void CVertexKeyFrames::interpolate(u32 frameA, u32 frameB, f32 t,
+		video::S3DVertex* dest, u32 destStride, core::aabbox3df* box) const
+{
+	const f32* a = getFrame(frameA);
+	const f32* b = getFrame(frameB);
+	if (!a || !b)
+		return;
+
+	f32 minEdge[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	f32 maxEdge[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+	c8* out = (c8*)dest;
+	u32 i = 0;
+
+#if defined(_IRR_COMPILE_WITH_SIMD_)
+	const core::simd4f st = core::simd_splat(t);
+	core::simd4f bmin[3], bmax[3];
+	for (u32 k=0; k<3; ++k)
+	{
+		bmin[k] = core::simd_splat(FLT_MAX);
+		bmax[k] = core::simd_splat(-FLT_MAX);
+	}
+
+	for (; i+4<=VertexCount; i+=4, out+=4*destStride)
+	{
+		core::simd4f c[COMPONENT_COUNT];
+		for (u32 k=0; k<COMPONENT_COUNT; ++k)
+		{
+			const core::simd4f va = core::simd_load(a + k*Pitch + i);
+			const core::simd4f vb = core::simd_load(b + k*Pitch + i);
+			c[k] = core::simd_add(va, core::simd_mul(st, core::simd_sub(vb, va)));
+		}
+
+		for (u32 k=0; k<3; ++k)
+		{
+			bmin[k] = core::simd_min(bmin[k], c[k]);
+			bmax[k] = core::simd_max(bmax[k], c[k]);
+		}
+
+		// the vertices are stored interleaved, so turn the components around
+		core::simd4f v[4];
+		core::simd_transpose3x4(c[POS_X], c[POS_Y], c[POS_Z], v[0], v[1], v[2], v[3]);
+		for (u32 k=0; k<4; ++k)
+			core::simd_store3(&((video::S3DVertex*)(out + k*destStride))->Pos.X, v[k]);
+
+		core::simd_transpose3x4(c[NORMAL_X], c[NORMAL_Y], c[NORMAL_Z], v[0], v[1], v[2], v[3]);
+		for (u32 k=0; k<4; ++k)
+			core::simd_store3(&((video::S3DVertex*)(out + k*destStride))->Normal.X, v[k]);
+	}
+
+	if (box && i)
+	{
+		for (u32 k=0; k<3; ++k)
+		{
+			f32 lo[4], hi[4];
+			core::simd_store(lo, bmin[k]);
+			core::simd_store(hi, bmax[k]);
+			minEdge[k] = core::min_(core::min_(lo[0], lo[1]), core::min_(lo[2], lo[3]));
+			maxEdge[k] = core::max_(core::max_(hi[0], hi[1]), core::max_(hi[2], hi[3]));
+		}
+	}
+#endif
+
+	for (; i<VertexCount; ++i, out+=destStride)
+	{
+		video::S3DVertex& v = *(video::S3DVertex*)out;
+
+		f32* pos = &v.Pos.X;
+		f32* normal = &v.Normal.X;
+		for (u32 k=0; k<3; ++k)
+		{
+			const f32 pa = a[(POS_X+k)*Pitch + i];
+			pos[k] = pa + t * (b[(POS_X+k)*Pitch + i] - pa);
+
+			const f32 na = a[(NORMAL_X+k)*Pitch + i];
+			normal[k] = na + t * (b[(NORMAL_X+k)*Pitch + i] - na);
+
+			minEdge[k] = core::min_(minEdge[k], pos[k]);
+			maxEdge[k] = core::max_(maxEdge[k], pos[k]);
+		}
+	}
+
+	if (box)
+	{
+		if (VertexCount)
+		{
+			box->MinEdge.set(minEdge[0], minEdge[1], minEdge[2]);
+			box->MaxEdge.set(maxEdge[0], maxEdge[1], maxEdge[2]);
+		}
+		else
+			box->reset(0.f, 0.f, 0.f);
+	}
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_MD2_LOADER_ || _IRR_COMPILE_WITH_MD3_LOADER_
+
@@ -0,0 +1,82 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_VERTEX_KEY_FRAMES_H_INCLUDED__
+#define __C_VERTEX_KEY_FRAMES_H_INCLUDED__
+
+#include "irrArray.h"
+#include "aabbox3d.h"
+#include "S3DVertex.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Decoded keyframes of a vertex animated mesh, like md2 and md3 models.
+	/** The files store the vertices of each keyframe quantized, decoding
+	them costs more than the interpolation. So each keyframe is decoded once,
+	when it is needed first, into one float array per component, which
+	interpolate() processes four vertices at a time. */
+	class CVertexKeyFrames
+	{
+	public:
+
+		//! Components of a decoded vertex, each is an array of its own
+		enum E_COMPONENT
+		{
+			POS_X = 0,
+			POS_Y,
+			POS_Z,
+			NORMAL_X,
+			NORMAL_Y,
+			NORMAL_Z,
+			COMPONENT_COUNT
+		};
+
+		//! constructor
+		CVertexKeyFrames();
+
+		//! Sets the amount of keyframes and vertices, frees all decoded frames
+		void setSize(u32 frameCount, u32 vertexCount);
+
+		//! Returns the amount of keyframes
+		u32 getFrameCount() const { return Frames.size(); }
+
+		//! Returns the amount of vertices per keyframe
+		u32 getVertexCount() const { return VertexCount; }
+
+		//! Returns the distance between the components of a frame in floats
+		u32 getPitch() const { return Pitch; }
+
+		//! Returns the decoded data of a frame, 0 if it wasn't decoded yet
+		const f32* getFrame(u32 frame) const;
+
+		//! Allocates the data of a frame for decoding it
+		/** \return Array of COMPONENT_COUNT*getPitch() floats, component c of
+		vertex i is at c*getPitch()+i. */
+		f32* addFrame(u32 frame);
+
+		//! Interpolates the positions and normals of two decoded frames into vertices
+		/** \param frameA First frame, weighted 1-t.
+		\param frameB Second frame, weighted t.
+		\param t Interpolation factor.
+		\param dest First vertex to write, only Pos and Normal are changed.
+		\param destStride Distance between the vertices in bytes.
+		\param box If not 0, receives the bounding box of the positions. */
+		void interpolate(u32 frameA, u32 frameB, f32 t,
+			video::S3DVertex* dest, u32 destStride, core::aabbox3df* box=0) const;
+
+	private:
+
+		core::array< core::array<f32> > Frames;
+		u32 VertexCount;
+		u32 Pitch;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
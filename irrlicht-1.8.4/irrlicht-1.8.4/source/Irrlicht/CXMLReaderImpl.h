@@ -31,9 +31,12 @@ public:
 
 	//! Constructor
 	CXMLReaderImpl(IFileReadCallBack* callback, bool deleteCallBack = true)
-		: IgnoreWhitespaceText(true), TextData(0), P(0), TextBegin(0), TextSize(0), CurrentNodeType(EXN_NONE),
-		SourceFormat(ETF_ASCII), TargetFormat(ETF_ASCII), IsEmptyElement(false)
+		: IgnoreWhitespaceText(true), TextData(0), P(0), TextBegin(0), TextSize(0), TagPending(false),
+		CurrentNodeType(EXN_NONE), SourceFormat(ETF_ASCII), TargetFormat(ETF_ASCII),
+		NodeName(0), NodeNameEncoded(false), IsEmptyElement(false)
 	{
+		NodeName = const_cast<char_type*>(EmptyString.c_str());
+
 		if (!callback)
 			return;
 
@@ -69,7 +72,7 @@ public:
 	virtual bool read()
 	{
 		// if not end reached, parse the node
-		if (P && ((unsigned int)(P - TextBegin) < TextSize - 1) && (*P != 0))
+		if (P && ((unsigned int)(P - TextBegin) < TextSize - 1) && (*P != 0 || TagPending))
 		{
 			return parseCurrentNode();
 		}
@@ -99,7 +102,7 @@ public:
 		if ((u32)idx >= Attributes.size())
 			return 0;
 
-		return Attributes[idx].Name.c_str();
+		return Attributes[idx].Name;
 	}
 
 
@@ -109,7 +112,7 @@ public:
 		if ((unsigned int)idx >= Attributes.size())
 			return 0;
 
-		return Attributes[idx].Value.c_str();
+		return getValue(Attributes[idx]);
 	}
 
 
@@ -120,7 +123,7 @@ public:
 		if (!attr)
 			return 0;
 
-		return attr->Value.c_str();
+		return getValue(*attr);
 	}
 
 
@@ -131,7 +134,32 @@ public:
 		if (!attr)
 			return EmptyString.c_str();
 
-		return attr->Value.c_str();
+		return getValue(*attr);
+	}
+
+
+	//! Returns the index of an attribute, using the precomputed hash of its name.
+	virtual int getAttributeIndex(const char_type* name, unsigned int nameHash) const
+	{
+		if (!name)
+			return -1;
+
+		for (u32 i=0; i<Attributes.size(); ++i)
+			if (Attributes[i].NameHash == nameHash && equals(Attributes[i].Name, name))
+				return (int)i;
+
+		return -1;
+	}
+
+
+	//! Returns the length of the value of an attribute in characters.
+	virtual unsigned int getAttributeValueLength(int idx) const
+	{
+		if ((unsigned int)idx >= Attributes.size())
+			return 0;
+
+		getValue(Attributes[idx]);
+		return Attributes[idx].ValueLength;
 	}
 
 
@@ -143,7 +171,7 @@ public:
 		if (!attr)
 			return 0;
 
-		core::stringc c(attr->Value.c_str());
+		core::stringc c(getValue(*attr));
 		return core::strtol10(c.c_str());
 	}
 
@@ -167,7 +195,7 @@ public:
 		if (!attr)
 			return 0;
 
-		core::stringc c = attr->Value.c_str();
+		core::stringc c = getValue(*attr);
 		return core::fast_atof(c.c_str());
 	}
 
@@ -187,14 +215,14 @@ public:
 	//! Returns the name of the current node.
 	virtual const char_type* getNodeName() const
 	{
-		return NodeName.c_str();
+		return getNodeText();
 	}
 
 
 	//! Returns data of the current node.
 	virtual const char_type* getNodeData() const
 	{
-		return NodeName.c_str();
+		return getNodeText();
 	}
 
 
@@ -222,21 +250,29 @@ private:
 	// return false if no further node is found
 	bool parseCurrentNode()
 	{
-		char_type* start = P;
+		if (TagPending)
+		{
+			// the '<' of this tag was replaced by the end of the text before
+			TagPending = false;
+		}
+		else
+		{
+			char_type* start = P;
 
-		// more forward until '<' found
-		while(*P != L'<' && *P)
-			++P;
+			// more forward until '<' found
+			while(*P != L'<' && *P)
+				++P;
 
-		// not a node, so return false
-		if (!*P)
-			return false;
+			// not a node, so return false
+			if (!*P)
+				return false;
 
-		if (P - start > 0)
-		{
-			// we found some text, store it
-			if (setText(start, P))
-				return true;
+			if (P - start > 0)
+			{
+				// we found some text, store it
+				if (setText(start, P))
+					return true;
+			}
 		}
 
 		++P;
@@ -279,9 +315,11 @@ private:
 				return false;
 		}
 
-		// set current text to the parsed text, and replace xml special characters
-		core::string<char_type> s(start, (int)(end - start));
-		NodeName = replaceSpecialCharacters(s);
+		// terminate the text in place, in the '<' of the following tag.
+		// Special characters are replaced when the text is requested.
+		setNodeText(start, end);
+		NodeNameEncoded = true;
+		TagPending = true;
 
 		// current XML node type is text
 		CurrentNodeType = EXN_TEXT;
@@ -327,7 +365,7 @@ private:
 		}
 
 		P -= 3;
-		NodeName = core::string<char_type>(pCommentBegin+2, (int)(P - pCommentBegin-2));
+		setNodeText(pCommentBegin+2, P);
 		P += 3;
 	}
 
@@ -337,16 +375,16 @@ private:
 	{
 		CurrentNodeType = EXN_ELEMENT;
 		IsEmptyElement = false;
-		Attributes.clear();
+		Attributes.set_used(0);
 
 		// find name
-		const char_type* startName = P;
+		char_type* startName = P;
 
 		// find end of element
 		while(*P != L'>' && !isWhiteSpace(*P))
 			++P;
 
-		const char_type* endName = P;
+		char_type* endName = P;
 
 		// find Attributes
 		while(*P != L'>')
@@ -360,12 +398,19 @@ private:
 					// we've got an attribute
 
 					// read the attribute names
-					const char_type* attributeNameBegin = P;
+					SAttribute attr;
+					attr.Name = P;
+					attr.NameHash = 2166136261u;
 
 					while(!isWhiteSpace(*P) && *P != L'=')
+					{
+						attr.NameHash = (attr.NameHash ^ (unsigned int)*P) * 16777619u;
 						++P;
+					}
+					if (!attr.NameHash)
+						attr.NameHash = 1;
 
-					const char_type* attributeNameEnd = P;
+					char_type* attributeNameEnd = P;
 					++P;
 
 					// read the attribute value
@@ -379,25 +424,25 @@ private:
 					const char_type attributeQuoteChar = *P;
 
 					++P;
-					const char_type* attributeValueBegin = P;
+					attr.Value = P;
+					attr.ValueEncoded = false;
 
 					while(*P != attributeQuoteChar && *P)
+					{
+						if (*P == L'&')
+							attr.ValueEncoded = true;
 						++P;
+					}
 
 					if (!*P) // malformatted xml file
 						return;
 
-					const char_type* attributeValueEnd = P;
+					// terminate name and value in place, both ends are behind us now
+					attr.ValueLength = (unsigned int)(P - attr.Value);
+					*attributeNameEnd = 0;
+					*P = 0;
 					++P;
 
-					SAttribute attr;
-					attr.Name = core::string<char_type>(attributeNameBegin,
-						(int)(attributeNameEnd - attributeNameBegin));
-
-					core::string<char_type> s(attributeValueBegin,
-						(int)(attributeValueEnd - attributeValueBegin));
-
-					attr.Value = replaceSpecialCharacters(s);
 					Attributes.push_back(attr);
 				}
 				else
@@ -418,7 +463,7 @@ private:
 			endName--;
 		}
 
-		NodeName = core::string<char_type>(startName, (int)(endName - startName));
+		setNodeText(startName, endName);
 
 		++P;
 	}
@@ -429,16 +474,16 @@ private:
 	{
 		CurrentNodeType = EXN_ELEMENT_END;
 		IsEmptyElement = false;
-		Attributes.clear();
+		Attributes.set_used(0);
 
 		++P;
-		const char_type* pBeginClose = P;
+		char_type* pBeginClose = P;
 
 		while(*P != L'>')
 			++P;
 
-		NodeName = core::string<char_type>(pBeginClose, (int)(P - pBeginClose));
 		++P;
+		setNodeText(pBeginClose, P-1);
 	}
 
 	//! parses a possible CDATA section, returns false if begin was not a CDATA section
@@ -477,85 +522,95 @@ private:
 		}
 
 		if ( cDataEnd )
-			NodeName = core::string<char_type>(cDataBegin, (int)(cDataEnd - cDataBegin));
+			setNodeText(cDataBegin, cDataEnd);
 		else
-			NodeName = "";
+			setNodeText(P, P);
 
 		return true;
 	}
 
 
-	// structure for storing attribute-name pairs
+	// structure for storing attribute-name pairs, both point into the text
 	struct SAttribute
 	{
-		core::string<char_type> Name;
-		core::string<char_type> Value;
+		char_type* Name;
+		char_type* Value;
+		unsigned int NameHash;
+		mutable unsigned int ValueLength;
+		mutable bool ValueEncoded;	// value still contains special characters
 	};
 
 	// finds a current attribute by name, returns 0 if not found
 	const SAttribute* getAttributeByName(const char_type* name) const
 	{
-		if (!name)
-			return 0;
-
-		core::string<char_type> n = name;
-
-		for (int i=0; i<(int)Attributes.size(); ++i)
-			if (Attributes[i].Name == n)
-				return &Attributes[i];
-
-		return 0;
+		const int idx = getAttributeIndex(name, getXMLNameHash(name));
+		return idx >= 0 ? &Attributes[idx] : 0;
 	}
 
-	// replaces xml special characters in a string and creates a new one
-	core::string<char_type> replaceSpecialCharacters(
-		core::string<char_type>& origstr)
+	// returns the value of an attribute, replacing special characters on first access
+	const char_type* getValue(const SAttribute& attr) const
 	{
-		int pos = origstr.findFirst(L'&');
-		int oldPos = 0;
+		if (attr.ValueEncoded)
+		{
+			attr.ValueLength = replaceSpecialCharacters(attr.Value);
+			attr.ValueEncoded = false;
+		}
+		return attr.Value;
+	}
 
-		if (pos == -1)
-			return origstr;
+	// returns name or data of the current node, replacing special characters on first access
+	const char_type* getNodeText() const
+	{
+		if (NodeNameEncoded)
+		{
+			replaceSpecialCharacters(NodeName);
+			NodeNameEncoded = false;
+		}
+		return NodeName;
+	}
 
-		core::string<char_type> newstr;
+	// sets name or data of the current node, terminated in place at end
+	void setNodeText(char_type* begin, char_type* end)
+	{
+		if (end < begin) // too short for a comment
+			begin = end;
+		*end = 0;
+		NodeName = begin;
+		NodeNameEncoded = false;
+	}
 
-		while(pos != -1 && pos < (int)origstr.size()-2)
+	// replaces xml special characters of a terminated string in place, returns the new length
+	unsigned int replaceSpecialCharacters(char_type* str) const
+	{
+		char_type* out = str;
+		for (const char_type* in = str; *in; )
 		{
-			// check if it is one of the special characters
-
-			int specialChar = -1;
-			for (int i=0; i<(int)SpecialCharacters.size(); ++i)
+			if (*in == L'&')
 			{
-				const char_type* p = &origstr.c_str()[pos]+1;
-
-				if (equalsn(&SpecialCharacters[i][1], p, SpecialCharacters[i].size()-1))
+				// check if it is one of the special characters
+				int specialChar = -1;
+				for (int i=0; i<(int)SpecialCharacters.size(); ++i)
 				{
-					specialChar = i;
-					break;
+					if (startsWith(in+1, &SpecialCharacters[i][1], SpecialCharacters[i].size()-1))
+					{
+						specialChar = i;
+						break;
+					}
 				}
-			}
 
-			if (specialChar != -1)
-			{
-				newstr.append(origstr.subString(oldPos, pos - oldPos));
-				newstr.append(SpecialCharacters[specialChar][0]);
-				pos += SpecialCharacters[specialChar].size();
-			}
-			else
-			{
-				newstr.append(origstr.subString(oldPos, pos - oldPos + 1));
-				pos += 1;
+				if (specialChar != -1)
+				{
+					*out++ = SpecialCharacters[specialChar][0];
+					in += SpecialCharacters[specialChar].size();
+					continue;
+				}
 			}
 
-			// find next &
-			oldPos = pos;
-			pos = origstr.findNext(L'&', pos);
+			*out++ = *in++;
 		}
+		*out = 0;
 
-		if (oldPos < (int)origstr.size()-1)
-			newstr.append(origstr.subString(oldPos, origstr.size()-oldPos));
-
-		return newstr;
+		return (unsigned int)(out - str);
 	}
 
 
@@ -755,17 +810,24 @@ private:
 	}
 
 
-	//! compares the first n characters of the strings
-	bool equalsn(const char_type* str1, const char_type* str2, int len)
+	//! returns if str begins with the first len characters of prefix
+	static bool startsWith(const char_type* str, const char_type* prefix, int len)
 	{
-		int i;
-		for(i=0; str1[i] && str2[i] && i < len; ++i)
-			if (str1[i] != str2[i])
+		for (int i=0; i<len; ++i)
+			if (str[i] != prefix[i])
 				return false;
 
-		// if one (or both) of the strings was smaller then they
-		// are only equal if they have the same lenght
-		return (i == len) || (str1[i] == 0 && str2[i] == 0);
+		return true;
+	}
+
+
+	//! compares two terminated strings
+	static bool equals(const char_type* str1, const char_type* str2)
+	{
+		for (; *str1 && *str1 == *str2; ++str1, ++str2)
+			;
+
+		return *str1 == *str2;
 	}
 
 
@@ -798,12 +860,16 @@ private:
 	char_type* P;                // current point in text to parse
 	char_type* TextBegin;        // start of text to parse
 	unsigned int TextSize;       // size of text to parse in characters, not bytes
+	bool TagPending;             // the '<' at P was overwritten to terminate a text node
 
 	EXML_NODE CurrentNodeType;   // type of the currently parsed node
 	ETEXT_FORMAT SourceFormat;   // source format of the xml file
 	ETEXT_FORMAT TargetFormat;   // output format of this parser
 
-	core::string<char_type> NodeName;    // name of the node currently in - also used for text
+	// The names and values point into the text, where they are terminated in place.
+	// They stay valid until the reader is deleted.
+	char_type* NodeName;                 // name of the node currently in - also used for text
+	mutable bool NodeNameEncoded;        // text node still contains special characters
 	core::string<char_type> EmptyString; // empty string to be returned by getSafe() methods
 
 	bool IsEmptyElement;       // is the currently parsed node empty?
@@ -15,6 +15,7 @@
 #include "IVideoDriver.h"
 #include "IFileSystem.h"
 #include "IReadFile.h"
+#include "CThreadPool.h"
 
 #ifdef _DEBUG
 #define _XREADER_DEBUG
@@ -30,7 +31,8 @@ namespace scene
 CXMeshFileLoader::CXMeshFileLoader(scene::ISceneManager* smgr, io::IFileSystem* fs)
 : SceneManager(smgr), FileSystem(fs), AllJoints(0), AnimatedMesh(0),
 	Buffer(0), P(0), End(0), BinaryNumCount(0), Line(0),
-	CurFrame(0), MajorVersion(0), MinorVersion(0), BinaryFormat(false), FloatSize(0)
+	CurFrame(0), Messages(0), DeferObjects(false),
+	MajorVersion(0), MinorVersion(0), BinaryFormat(false), FloatSize(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CXMeshFileLoader");
@@ -77,7 +79,7 @@ IAnimatedMesh* CXMeshFileLoader::createMesh(io::IReadFile* f)
 	tmpString += " X file: ";
 	tmpString += time;
 	tmpString += "ms";
-	os::Printer::log(tmpString.c_str());
+	log(tmpString.c_str());
 #endif
 	//Clear up
 
@@ -91,6 +93,10 @@ IAnimatedMesh* CXMeshFileLoader::createMesh(io::IReadFile* f)
 	CurFrame=0;
 	TemplateMaterials.clear();
 
+	for (u32 i=0; i<DeferredObjects.size(); ++i)
+		delete DeferredObjects[i].Animation;
+	DeferredObjects.clear();
+
 	delete [] Buffer;
 	Buffer = 0;
 
@@ -107,9 +113,17 @@ bool CXMeshFileLoader::load(io::IReadFile* file)
 	if (!readFileIntoMemory(file))
 		return false;
 
+	// with worker threads, meshes and animations are only skipped while
+	// parsing the file, and parsed all at once afterwards
+	CThreadPool* pool = CThreadPool::getSharedPool();
+	DeferObjects = pool && pool->getThreadCount() > 0;
+
 	if (!parseFile())
 		return false;
 
+	if (!parseDeferredObjects())
+		return false;
+
 	for (u32 n=0; n<Meshes.size(); ++n)
 	{
 		SXMesh *mesh=Meshes[n];
@@ -242,7 +256,7 @@ bool CXMeshFileLoader::load(io::IReadFile* file)
 
 				if (id>=verticesLinkIndex.size())
 				{
-					os::Printer::log("X loader: Weight id out of range", ELL_WARNING);
+					log("X loader: Weight id out of range", ELL_WARNING);
 					id=0;
 					weight.strength=0.f;
 				}
@@ -288,7 +302,7 @@ bool CXMeshFileLoader::load(io::IReadFile* file)
 					{
 						if (!warned)
 						{
-							os::Printer::log("X loader", "Duplicated vertex, animation might be corrupted.", ELL_WARNING);
+							log("X loader", "Duplicated vertex, animation might be corrupted.", ELL_WARNING);
 							warned=true;
 						}
 						const u32 tmp = mesh->Vertices.size();
@@ -375,7 +389,7 @@ bool CXMeshFileLoader::load(io::IReadFile* file)
 
 				if (id>=verticesLinkIndex.size())
 				{
-					os::Printer::log("X loader: Weight id out of range", ELL_WARNING);
+					log("X loader: Weight id out of range", ELL_WARNING);
 					id=0;
 					weight.strength=0.f;
 				}
@@ -398,7 +412,7 @@ bool CXMeshFileLoader::readFileIntoMemory(io::IReadFile* file)
 	const long size = file->getSize();
 	if (size < 12)
 	{
-		os::Printer::log("X File is too small.", ELL_WARNING);
+		log("X File is too small.", ELL_WARNING);
 		return false;
 	}
 
@@ -407,7 +421,7 @@ bool CXMeshFileLoader::readFileIntoMemory(io::IReadFile* file)
 	//! read all into memory
 	if (file->read(Buffer, size) != size)
 	{
-		os::Printer::log("Could not read from x file.", ELL_WARNING);
+		log("Could not read from x file.", ELL_WARNING);
 		return false;
 	}
 
@@ -417,7 +431,7 @@ bool CXMeshFileLoader::readFileIntoMemory(io::IReadFile* file)
 	//! check header "xof "
 	if (strncmp(Buffer, "xof ", 4)!=0)
 	{
-		os::Printer::log("Not an x file, wrong header.", ELL_WARNING);
+		log("Not an x file, wrong header.", ELL_WARNING);
 		return false;
 	}
 
@@ -439,7 +453,7 @@ bool CXMeshFileLoader::readFileIntoMemory(io::IReadFile* file)
 		BinaryFormat = true;
 	else
 	{
-		os::Printer::log("Only uncompressed x files currently supported.", ELL_WARNING);
+		log("Only uncompressed x files currently supported.", ELL_WARNING);
 		return false;
 	}
 	BinaryNumCount=0;
@@ -451,7 +465,7 @@ bool CXMeshFileLoader::readFileIntoMemory(io::IReadFile* file)
 		FloatSize = 8;
 	else
 	{
-		os::Printer::log("Float size not supported.", ELL_WARNING);
+		log("Float size not supported.", ELL_WARNING);
 		return false;
 	}
 
@@ -476,6 +490,455 @@ bool CXMeshFileLoader::parseFile()
 }
 
 
+//! Parses a Mesh data object, or remembers it for parseDeferredObjects()
+bool CXMeshFileLoader::parseOrDeferMesh(SXMesh* mesh)
+{
+	if (DeferObjects)
+		return deferDataObject(mesh, 0);
+
+	// weights read before an error are kept
+	const bool result = parseDataObjectMesh(*mesh);
+	applyMesh(*mesh);
+	return result;
+}
+
+
+//! Parses an Animation data object, or remembers it for parseDeferredObjects()
+bool CXMeshFileLoader::parseOrDeferAnimation()
+{
+	if (DeferObjects)
+		return deferDataObject(0, new SXAnimation());
+
+	SXAnimation animation;
+	if (!parseDataObjectAnimation(animation))
+		return false;
+
+	applyAnimation(animation);
+	return true;
+}
+
+
+//! Skips a data object and remembers it for parsing it on a worker thread
+bool CXMeshFileLoader::deferDataObject(SXMesh* mesh, SXAnimation* animation)
+{
+	DeferredObjects.push_back(SXDeferredObject());
+	SXDeferredObject& object = DeferredObjects.getLast();
+	object.Mesh = mesh;
+	object.Animation = animation;
+	object.Begin = P;
+	object.Line = Line;
+	object.TemplateMaterialCount = TemplateMaterials.size();
+	object.Result = false;
+
+	// broken objects are parsed as well, for the same warnings as without threads
+	core::array<core::stringc> jointNames;
+	const bool result = readHeadOfDataObject() && skipDataObject(animation != 0, jointNames);
+	object.End = core::min_(P, End);
+
+	// the joints are created now, so they get the same order as when
+	// parsing the objects right away
+	for (u32 i=0; i<jointNames.size(); ++i)
+		getJoint(jointNames[i]);
+
+	return result;
+}
+
+
+//! Parses the deferred objects of one worker
+struct CXMeshFileLoader::SXParseJob
+{
+	SXParseJob(CXMeshFileLoader* loader) : Loader(loader) {}
+
+	void operator()(u32 begin, u32 end)
+	{
+		for (u32 i=begin; i<end; ++i)
+			Loader->parseDeferredObject(Loader->DeferredObjects[i]);
+	}
+
+	CXMeshFileLoader* Loader;
+};
+
+
+//! Parses all deferred data objects at once, and applies them in file order
+bool CXMeshFileLoader::parseDeferredObjects()
+{
+	SXParseJob job(this);
+	parallelFor(DeferredObjects.size(), 1, job);
+
+	for (u32 i=0; i<DeferredObjects.size(); ++i)
+	{
+		SXDeferredObject& object = DeferredObjects[i];
+
+		for (u32 m=0; m<object.Messages.size(); ++m)
+		{
+			const SXLogMessage& message = object.Messages[m];
+			if (message.HasHint)
+				os::Printer::log(message.Text.c_str(), message.Hint.c_str(), message.Level);
+			else
+				os::Printer::log(message.Text.c_str(), message.Level);
+		}
+
+		if (object.Mesh)
+			applyMesh(*object.Mesh);
+		else if (object.Result)
+			applyAnimation(*object.Animation);
+
+		delete object.Animation;
+	}
+	DeferredObjects.clear();
+
+	return true;
+}
+
+
+//! Parses one deferred data object, called by the workers
+void CXMeshFileLoader::parseDeferredObject(SXDeferredObject& object) const
+{
+	// a parser of its own for each object, which only sees the object
+	CXMeshFileLoader parser(SceneManager, FileSystem);
+	parser.AnimatedMesh = AnimatedMesh;
+	parser.P = object.Begin;
+	parser.End = object.End;
+	parser.Line = object.Line;
+	parser.FilePath = FilePath;
+	parser.MajorVersion = MajorVersion;
+	parser.MinorVersion = MinorVersion;
+	parser.BinaryFormat = BinaryFormat;
+	parser.FloatSize = FloatSize;
+	parser.Messages = &object.Messages;
+
+	// only the template materials defined before the object are known to it
+	parser.TemplateMaterials.reallocate(object.TemplateMaterialCount);
+	for (u32 i=0; i<object.TemplateMaterialCount; ++i)
+		parser.TemplateMaterials.push_back(TemplateMaterials[i]);
+
+	if (object.Mesh)
+		object.Result = parser.parseDataObjectMesh(*object.Mesh);
+	else
+		object.Result = parser.parseDataObjectAnimation(*object.Animation);
+}
+
+
+//! Skips the rest of a data object after its opening brace
+bool CXMeshFileLoader::skipDataObject(bool animation, core::array<core::stringc>& jointNames)
+{
+	enum E_TOKEN { TOKEN_OTHER, TOKEN_NAME, TOKEN_STRING, TOKEN_OPEN, TOKEN_CLOSE };
+
+	// skin weights start with the name of their joint, animations
+	// refer to their joint with a { name } in the animation itself
+	enum E_STATE
+	{
+		STATE_NONE,
+		STATE_SKIN_WEIGHTS,
+		STATE_SKIN_WEIGHTS_OPEN,
+		STATE_REFERENCE_OPEN,
+		STATE_REFERENCE_NAME
+	};
+
+	E_STATE state = STATE_NONE;
+	core::stringc reference;
+	core::stringc frameName;
+	u32 depth = 1;
+
+	while (depth)
+	{
+		E_TOKEN token = TOKEN_OTHER;
+		const c8* text = 0;
+		u32 length = 0;
+
+		if (BinaryFormat)
+		{
+			if (P + 2 > End)
+				return false;
+
+			const u16 tok = readBinWord();
+			switch (tok)
+			{
+			case 1: // name
+			case 2: // string, followed by a separator token
+				length = readBinDWord();
+				text = P;
+				P += (tok == 2) ? length + 2 : length;
+				token = (tok == 1) ? TOKEN_NAME : TOKEN_STRING;
+				break;
+			case 3: // integer
+				P += 4;
+				break;
+			case 5: // GUID
+				P += 16;
+				break;
+			case 6: // integer list
+				P += readBinDWord() * 4;
+				break;
+			case 7: // float list
+				P += readBinDWord() * FloatSize;
+				break;
+			case 0x0a:
+				token = TOKEN_OPEN;
+				break;
+			case 0x0b:
+				token = TOKEN_CLOSE;
+				break;
+			}
+
+			if (P > End)
+				return false;
+		}
+		else
+		{
+			findNextNoneWhiteSpace();
+			if (P >= End)
+				return false;
+
+			switch (P[0])
+			{
+			case '{':
+				token = TOKEN_OPEN;
+				++P;
+				break;
+			case '}':
+				token = TOKEN_CLOSE;
+				++P;
+				break;
+			case ';':
+			case ',':
+				++P;
+				break;
+			case '"':
+				text = ++P;
+				while (P < End && P[0] != '"')
+				{
+					if (P[0] == '\n')
+						++Line;
+					++P;
+				}
+				if (P >= End)
+					return false;
+				length = (u32)(P - text);
+				++P;
+				token = TOKEN_STRING;
+				break;
+			default:
+				// names and numbers
+				text = P;
+				while (P < End && !core::isspace(P[0]) && P[0] != ';' && P[0] != ',' &&
+					P[0] != '{' && P[0] != '}' && P[0] != '"')
+					++P;
+				length = (u32)(P - text);
+				token = TOKEN_NAME;
+				break;
+			}
+		}
+
+		switch (token)
+		{
+		case TOKEN_OPEN:
+			++depth;
+			if (state == STATE_SKIN_WEIGHTS)
+				state = STATE_SKIN_WEIGHTS_OPEN;
+			else
+				state = (animation && depth == 2) ? STATE_REFERENCE_OPEN : STATE_NONE;
+			break;
+		case TOKEN_CLOSE:
+			--depth;
+			if (state == STATE_REFERENCE_NAME && depth == 1)
+				frameName = reference;
+			state = STATE_NONE;
+			break;
+		case TOKEN_NAME:
+			if (!animation && length == 11 && strncmp(text, "SkinWeights", 11) == 0)
+				state = STATE_SKIN_WEIGHTS;
+			else if (state == STATE_REFERENCE_OPEN)
+			{
+				reference = core::stringc(text, length);
+				state = STATE_REFERENCE_NAME;
+			}
+			else if (state != STATE_SKIN_WEIGHTS) // skin weights may have a name
+				state = STATE_NONE;
+			break;
+		case TOKEN_STRING:
+			if (state == STATE_SKIN_WEIGHTS_OPEN)
+				jointNames.push_back(core::stringc(text, length));
+			state = STATE_NONE;
+			break;
+		default:
+			state = STATE_NONE;
+			break;
+		}
+	}
+
+	if (frameName.size())
+		jointNames.push_back(frameName);
+
+	return true;
+}
+
+
+//! Returns a joint by name, creates it if there is none
+CSkinnedMesh::SJoint* CXMeshFileLoader::getJoint(const core::stringc& name, u32* index)
+{
+	const core::array<CSkinnedMesh::SJoint*>& joints = AnimatedMesh->getAllJoints();
+
+	for (u32 n=0; n < joints.size(); ++n)
+	{
+		if (joints[n]->Name==name)
+		{
+			if (index)
+				*index = n;
+			return joints[n];
+		}
+	}
+
+#ifdef _XREADER_DEBUG
+	log("creating joint ", name.c_str(), ELL_DEBUG);
+#endif
+	if (index)
+		*index = joints.size();
+	CSkinnedMesh::SJoint* joint=AnimatedMesh->addJoint(0);
+	joint->Name=name;
+	return joint;
+}
+
+
+//! Adds the skin weights and textures of a mesh to the animated mesh
+void CXMeshFileLoader::applyMesh(SXMesh& mesh)
+{
+	for (u32 w=0; w<mesh.SkinWeights.size(); ++w)
+	{
+		const SXMesh::SXWeights& weights = mesh.SkinWeights[w];
+
+		u32 n;
+		CSkinnedMesh::SJoint* joint = getJoint(weights.JointName, &n);
+
+		const u32 nWeights = weights.VertexIds.size();
+		joint->Weights.reallocate(joint->Weights.size()+nWeights);
+		mesh.WeightJoint.reallocate(mesh.WeightJoint.size()+nWeights);
+		mesh.WeightNum.reallocate(mesh.WeightNum.size()+nWeights);
+
+		for (u32 i=0; i<nWeights; ++i)
+		{
+			mesh.WeightJoint.push_back(n);
+			mesh.WeightNum.push_back(joint->Weights.size());
+
+			CSkinnedMesh::SWeight *weight=AnimatedMesh->addWeight(joint);
+
+			weight->buffer_id=0;
+			weight->vertex_id=weights.VertexIds[i];
+			weight->strength=weights.Strengths[i];
+		}
+
+		joint->GlobalInversedMatrix = weights.MatrixOffset;
+	}
+	mesh.SkinWeights.clear();
+
+	for (u32 t=0; t<mesh.Textures.size(); ++t)
+	{
+		const SXMesh::SXTexture& texture = mesh.Textures[t];
+		mesh.Materials[texture.Material].setTexture(texture.Layer, loadTexture(texture.Name));
+	}
+	mesh.Textures.clear();
+}
+
+
+//! Adds the keys of an animation to its joint
+void CXMeshFileLoader::applyAnimation(SXAnimation& animation)
+{
+	if (animation.FrameName.size() == 0)
+	{
+		log("joint name was never given", ELL_WARNING);
+		return;
+	}
+
+#ifdef _XREADER_DEBUG
+	log("frame name", animation.FrameName.c_str(), ELL_DEBUG);
+#endif
+	CSkinnedMesh::SJoint* joint = getJoint(animation.FrameName);
+	const CSkinnedMesh::SJoint& keys = animation.Keys;
+
+	u32 n;
+	joint->PositionKeys.reallocate(joint->PositionKeys.size()+keys.PositionKeys.size());
+	for (n=0; n<keys.PositionKeys.size(); ++n)
+		joint->PositionKeys.push_back(keys.PositionKeys[n]);
+
+	joint->ScaleKeys.reallocate(joint->ScaleKeys.size()+keys.ScaleKeys.size());
+	for (n=0; n<keys.ScaleKeys.size(); ++n)
+		joint->ScaleKeys.push_back(keys.ScaleKeys[n]);
+
+	joint->RotationKeys.reallocate(joint->RotationKeys.size()+keys.RotationKeys.size());
+	for (n=0; n<keys.RotationKeys.size(); ++n)
+		joint->RotationKeys.push_back(keys.RotationKeys[n]);
+}
+
+
+//! Loads a texture into a material, or only remembers its name if textures is not 0
+void CXMeshFileLoader::setTexture(video::SMaterial& material, u32 layer, const core::stringc& name,
+		core::array<SXMesh::SXTexture>* textures, u32 materialIndex)
+{
+	if (!textures)
+	{
+		material.setTexture(layer, loadTexture(name));
+		return;
+	}
+
+	SXMesh::SXTexture texture;
+	texture.Name = name;
+	texture.Material = materialIndex;
+	texture.Layer = layer;
+	textures->push_back(texture);
+}
+
+
+//! Loads a texture referenced by a material
+video::ITexture* CXMeshFileLoader::loadTexture(core::stringc name) const
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+	// original name
+	if (FileSystem->existFile(name))
+		return driver->getTexture(name);
+
+	// mesh path
+	name = FilePath + FileSystem->getFileBasename(name);
+	if (FileSystem->existFile(name))
+		return driver->getTexture(name);
+
+	// working directory
+	return driver->getTexture(FileSystem->getFileBasename(name));
+}
+
+
+//! Logs a message, or keeps it when parsing on a worker thread
+void CXMeshFileLoader::log(const c8* text, ELOG_LEVEL level) const
+{
+	if (!Messages)
+	{
+		os::Printer::log(text, level);
+		return;
+	}
+
+	Messages->push_back(SXLogMessage());
+	Messages->getLast().Text = text;
+	Messages->getLast().Level = level;
+	Messages->getLast().HasHint = false;
+}
+
+
+void CXMeshFileLoader::log(const c8* text, const c8* hint, ELOG_LEVEL level) const
+{
+	if (!Messages)
+	{
+		os::Printer::log(text, hint, level);
+		return;
+	}
+
+	Messages->push_back(SXLogMessage());
+	Messages->getLast().Text = text;
+	Messages->getLast().Hint = hint;
+	Messages->getLast().Level = level;
+	Messages->getLast().HasHint = true;
+}
+
+
 //! Parses the next Data object in the file
 bool CXMeshFileLoader::parseDataObject()
 {
@@ -486,7 +949,7 @@ bool CXMeshFileLoader::parseDataObject()
 
 	// parse specific object
 #ifdef _XREADER_DEBUG
-	os::Printer::log("debug DataObject:", objectName.c_str(), ELL_DEBUG);
+	log("debug DataObject:", objectName.c_str(), ELL_DEBUG);
 #endif
 
 	if (objectName == "template")
@@ -507,7 +970,7 @@ bool CXMeshFileLoader::parseDataObject()
 		//mesh->Buffer=AnimatedMesh->addMeshBuffer();
 		Meshes.push_back(mesh);
 
-		return parseDataObjectMesh(*mesh);
+		return parseOrDeferMesh(mesh);
 	}
 	else
 	if (objectName == "AnimationSet")
@@ -525,11 +988,11 @@ bool CXMeshFileLoader::parseDataObject()
 	else
 	if (objectName == "}")
 	{
-		os::Printer::log("} found in dataObject", ELL_WARNING);
+		log("} found in dataObject", ELL_WARNING);
 		return true;
 	}
 
-	os::Printer::log("Unknown data object in animation of .x file", objectName.c_str(), ELL_WARNING);
+	log("Unknown data object in animation of .x file", objectName.c_str(), ELL_WARNING);
 
 	return parseUnknownDataObject();
 }
@@ -538,7 +1001,7 @@ bool CXMeshFileLoader::parseDataObject()
 bool CXMeshFileLoader::parseDataObjectTemplate()
 {
 #ifdef _XREADER_DEBUG
-	os::Printer::log("CXFileReader: Reading template", ELL_DEBUG);
+	log("CXFileReader: Reading template", ELL_DEBUG);
 #endif
 
 	// parse a template data object. Currently not stored.
@@ -546,9 +1009,9 @@ bool CXMeshFileLoader::parseDataObjectTemplate()
 
 	if (!readHeadOfDataObject(&name))
 	{
-		os::Printer::log("Left delimiter in template data object missing.",
+		log("Left delimiter in template data object missing.",
 			name.c_str(), ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -574,7 +1037,7 @@ bool CXMeshFileLoader::parseDataObjectTemplate()
 bool CXMeshFileLoader::parseDataObjectFrame(CSkinnedMesh::SJoint *Parent)
 {
 #ifdef _XREADER_DEBUG
-	os::Printer::log("CXFileReader: Reading frame", ELL_DEBUG);
+	log("CXFileReader: Reading frame", ELL_DEBUG);
 #endif
 
 	// A coordinate frame, or "frame of reference." The Frame template
@@ -589,8 +1052,8 @@ bool CXMeshFileLoader::parseDataObjectFrame(CSkinnedMesh::SJoint *Parent)
 
 	if (!readHeadOfDataObject(&name))
 	{
-		os::Printer::log("No opening brace in Frame found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No opening brace in Frame found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -612,7 +1075,7 @@ bool CXMeshFileLoader::parseDataObjectFrame(CSkinnedMesh::SJoint *Parent)
 	if (!joint)
 	{
 #ifdef _XREADER_DEBUG
-		os::Printer::log("creating joint ", name.c_str(), ELL_DEBUG);
+		log("creating joint ", name.c_str(), ELL_DEBUG);
 #endif
 		joint=AnimatedMesh->addJoint(Parent);
 		joint->Name=name;
@@ -621,7 +1084,7 @@ bool CXMeshFileLoader::parseDataObjectFrame(CSkinnedMesh::SJoint *Parent)
 	else
 	{
 #ifdef _XREADER_DEBUG
-		os::Printer::log("using joint ", name.c_str(), ELL_DEBUG);
+		log("using joint ", name.c_str(), ELL_DEBUG);
 #endif
 		if (Parent)
 			Parent->Children.push_back(joint);
@@ -635,13 +1098,13 @@ bool CXMeshFileLoader::parseDataObjectFrame(CSkinnedMesh::SJoint *Parent)
 		core::stringc objectName = getNextToken();
 
 #ifdef _XREADER_DEBUG
-		os::Printer::log("debug DataObject in frame:", objectName.c_str(), ELL_DEBUG);
+		log("debug DataObject in frame:", objectName.c_str(), ELL_DEBUG);
 #endif
 
 		if (objectName.size() == 0)
 		{
-			os::Printer::log("Unexpected ending found in Frame in x file.", ELL_WARNING);
-			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+			log("Unexpected ending found in Frame in x file.", ELL_WARNING);
+			log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 			return false;
 		}
 		else
@@ -680,12 +1143,12 @@ bool CXMeshFileLoader::parseDataObjectFrame(CSkinnedMesh::SJoint *Parent)
 
 			Meshes.push_back(mesh);
 
-			if (!parseDataObjectMesh(*mesh))
+			if (!parseOrDeferMesh(mesh))
 				return false;
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in frame in x file", objectName.c_str(), ELL_WARNING);
+			log("Unknown data object in frame in x file", objectName.c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -698,13 +1161,13 @@ bool CXMeshFileLoader::parseDataObjectFrame(CSkinnedMesh::SJoint *Parent)
 bool CXMeshFileLoader::parseDataObjectTransformationMatrix(core::matrix4 &mat)
 {
 #ifdef _XREADER_DEBUG
-	os::Printer::log("CXFileReader: Reading Transformation Matrix", ELL_DEBUG);
+	log("CXFileReader: Reading Transformation Matrix", ELL_DEBUG);
 #endif
 
 	if (!readHeadOfDataObject())
 	{
-		os::Printer::log("No opening brace in Transformation Matrix found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No opening brace in Transformation Matrix found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -712,14 +1175,14 @@ bool CXMeshFileLoader::parseDataObjectTransformationMatrix(core::matrix4 &mat)
 
 	if (!checkForOneFollowingSemicolons())
 	{
-		os::Printer::log("No finishing semicolon in Transformation Matrix found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No finishing semicolon in Transformation Matrix found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 	}
 
 	if (!checkForClosingBrace())
 	{
-		os::Printer::log("No closing brace in Transformation Matrix found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No closing brace in Transformation Matrix found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -734,15 +1197,15 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 	if (!readHeadOfDataObject(&name))
 	{
 #ifdef _XREADER_DEBUG
-		os::Printer::log("CXFileReader: Reading mesh", ELL_DEBUG);
+		log("CXFileReader: Reading mesh", ELL_DEBUG);
 #endif
-		os::Printer::log("No opening brace in Mesh found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No opening brace in Mesh found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
 #ifdef _XREADER_DEBUG
-	os::Printer::log("CXFileReader: Reading mesh", name.c_str(), ELL_DEBUG);
+	log("CXFileReader: Reading mesh", name.c_str(), ELL_DEBUG);
 #endif
 
 	// read vertex count
@@ -750,16 +1213,15 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 
 	// read vertices
 	mesh.Vertices.set_used(nVertices);
+	if (nVertices)
+		readFloatArray(&mesh.Vertices[0].Pos.X, nVertices, 3, sizeof(video::S3DVertex));
 	for (u32 n=0; n<nVertices; ++n)
-	{
-		readVector3(mesh.Vertices[n].Pos);
 		mesh.Vertices[n].Color=0xFFFFFFFF;
-	}
 
 	if (!checkForTwoFollowingSemicolons())
 	{
-		os::Printer::log("No finishing semicolon in Mesh Vertex Array found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No finishing semicolon in Mesh Vertex Array found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 	}
 
 	// read faces
@@ -779,8 +1241,8 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		{
 			if (fcnt < 3)
 			{
-				os::Printer::log("Invalid face count (<3) found in Mesh x file reader.", ELL_WARNING);
-				os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+				log("Invalid face count (<3) found in Mesh x file reader.", ELL_WARNING);
+				log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 				return false;
 			}
 
@@ -790,8 +1252,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 			mesh.Indices.set_used(mesh.Indices.size() + ((triangles-1)*3));
 			mesh.IndexCountPerFace[k] = (u16)(triangles * 3);
 
-			for (u32 f=0; f<fcnt; ++f)
-				polygonfaces[f] = readInt();
+			readIntArray(polygonfaces.pointer(), fcnt);
 
 			for (u32 jk=0; jk<triangles; ++jk)
 			{
@@ -804,17 +1265,16 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		}
 		else
 		{
-			mesh.Indices[currentIndex++] = readInt();
-			mesh.Indices[currentIndex++] = readInt();
-			mesh.Indices[currentIndex++] = readInt();
+			readIntArray(&mesh.Indices[currentIndex], 3);
+			currentIndex += 3;
 			mesh.IndexCountPerFace[k] = 3;
 		}
 	}
 
 	if (!checkForTwoFollowingSemicolons())
 	{
-		os::Printer::log("No finishing semicolon in Mesh Face Array found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No finishing semicolon in Mesh Face Array found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 	}
 
 	// here, other data objects may follow
@@ -825,8 +1285,8 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 
 		if (objectName.size() == 0)
 		{
-			os::Printer::log("Unexpected ending found in Mesh in x file.", ELL_WARNING);
-			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+			log("Unexpected ending found in Mesh in x file.", ELL_WARNING);
+			log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 			return false;
 		}
 		else
@@ -836,7 +1296,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		}
 
 #ifdef _XREADER_DEBUG
-		os::Printer::log("debug DataObject in mesh:", objectName.c_str(), ELL_DEBUG);
+		log("debug DataObject in mesh:", objectName.c_str(), ELL_DEBUG);
 #endif
 
 		if (objectName == "MeshNormals")
@@ -983,18 +1443,17 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 			}
 			const u32 datasize = readInt();
 			u32* data = new u32[datasize];
-			for (j=0; j<datasize; ++j)
-				data[j]=readInt();
+			readIntArray(data, datasize);
 
 			if (!checkForOneFollowingSemicolons())
 			{
-				os::Printer::log("No finishing semicolon in DeclData found.", ELL_WARNING);
-				os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+				log("No finishing semicolon in DeclData found.", ELL_WARNING);
+				log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 			}
 			if (!checkForClosingBrace())
 			{
-				os::Printer::log("No closing brace in DeclData.", ELL_WARNING);
-				os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+				log("No closing brace in DeclData.", ELL_WARNING);
+				log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 				delete [] data;
 				return false;
 			}
@@ -1018,15 +1477,14 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		{
 			if (!readHeadOfDataObject())
 			{
-				os::Printer::log("No starting brace in FVFData found.", ELL_WARNING);
-				os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+				log("No starting brace in FVFData found.", ELL_WARNING);
+				log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 				return false;
 			}
 			const u32 dataformat = readInt();
 			const u32 datasize = readInt();
 			u32* data = new u32[datasize];
-			for (u32 j=0; j<datasize; ++j)
-				data[j]=readInt();
+			readIntArray(data, datasize);
 			if (dataformat&0x102) // 2nd uv set
 			{
 				mesh.TCoords2.reallocate(mesh.Vertices.size());
@@ -1041,13 +1499,13 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 			delete [] data;
 			if (!checkForOneFollowingSemicolons())
 			{
-				os::Printer::log("No finishing semicolon in FVFData found.", ELL_WARNING);
-				os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+				log("No finishing semicolon in FVFData found.", ELL_WARNING);
+				log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 			}
 			if (!checkForClosingBrace())
 			{
-				os::Printer::log("No closing brace in FVFData found in x file", ELL_WARNING);
-				os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+				log("No closing brace in FVFData found in x file", ELL_WARNING);
+				log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 				return false;
 			}
 		}
@@ -1067,7 +1525,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in mesh in x file", objectName.c_str(), ELL_WARNING);
+			log("Unknown data object in mesh in x file", objectName.c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1080,13 +1538,13 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 bool CXMeshFileLoader::parseDataObjectSkinWeights(SXMesh &mesh)
 {
 #ifdef _XREADER_DEBUG
-	os::Printer::log("CXFileReader: Reading mesh skin weights", ELL_DEBUG);
+	log("CXFileReader: Reading mesh skin weights", ELL_DEBUG);
 #endif
 
 	if (!readHeadOfDataObject())
 	{
-		os::Printer::log("No opening brace in Skin Weights found in .x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No opening brace in Skin Weights found in .x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -1094,82 +1552,46 @@ bool CXMeshFileLoader::parseDataObjectSkinWeights(SXMesh &mesh)
 
 	if (!getNextTokenAsString(TransformNodeName))
 	{
-		os::Printer::log("Unknown syntax while reading transfrom node name string in .x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("Unknown syntax while reading transfrom node name string in .x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
 	mesh.HasSkinning=true;
 
-	CSkinnedMesh::SJoint *joint=0;
-
-	u32 n;
-	for (n=0; n < AnimatedMesh->getAllJoints().size(); ++n)
-	{
-		if (AnimatedMesh->getAllJoints()[n]->Name==TransformNodeName)
-		{
-			joint=AnimatedMesh->getAllJoints()[n];
-			break;
-		}
-	}
-
-	if (!joint)
-	{
-#ifdef _XREADER_DEBUG
-		os::Printer::log("creating joint for skinning ", TransformNodeName.c_str(), ELL_DEBUG);
-#endif
-		n = AnimatedMesh->getAllJoints().size();
-		joint=AnimatedMesh->addJoint(0);
-		joint->Name=TransformNodeName;
-	}
+	// the weights are added to the joint by applyMesh()
+	mesh.SkinWeights.push_back(SXMesh::SXWeights());
+	SXMesh::SXWeights& weights = mesh.SkinWeights.getLast();
+	weights.JointName = TransformNodeName;
 
 	// read vertex weights
 	const u32 nWeights = readInt();
 
 	// read vertex indices
-	u32 i;
-
-	const u32 jointStart = joint->Weights.size();
-	joint->Weights.reallocate(jointStart+nWeights);
-
-	mesh.WeightJoint.reallocate( mesh.WeightJoint.size() + nWeights );
-	mesh.WeightNum.reallocate( mesh.WeightNum.size() + nWeights );
-
-	for (i=0; i<nWeights; ++i)
-	{
-		mesh.WeightJoint.push_back(n);
-		mesh.WeightNum.push_back(joint->Weights.size());
-
-		CSkinnedMesh::SWeight *weight=AnimatedMesh->addWeight(joint);
-
-		weight->buffer_id=0;
-		weight->vertex_id=readInt();
-	}
+	weights.VertexIds.set_used(nWeights);
+	readIntArray(weights.VertexIds.pointer(), nWeights);
 
 	// read vertex weights
-
-	for (i=jointStart; i<jointStart+nWeights; ++i)
-		joint->Weights[i].strength = readFloat();
+	weights.Strengths.set_used(nWeights);
+	readFloatArray(weights.Strengths.pointer(), nWeights, 1, sizeof(f32));
 
 	// read matrix offset
 
 	// transforms the mesh vertices to the space of the bone
 	// When concatenated to the bone's transform, this provides the
 	// world space coordinates of the mesh as affected by the bone
-	core::matrix4& MatrixOffset = joint->GlobalInversedMatrix;
-
-	readMatrix(MatrixOffset);
+	readMatrix(weights.MatrixOffset);
 
 	if (!checkForOneFollowingSemicolons())
 	{
-		os::Printer::log("No finishing semicolon in Skin Weights found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No finishing semicolon in Skin Weights found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 	}
 
 	if (!checkForClosingBrace())
 	{
-		os::Printer::log("No closing brace in Skin Weights found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No closing brace in Skin Weights found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -1180,13 +1602,13 @@ bool CXMeshFileLoader::parseDataObjectSkinWeights(SXMesh &mesh)
 bool CXMeshFileLoader::parseDataObjectSkinMeshHeader(SXMesh& mesh)
 {
 #ifdef _XREADER_DEBUG
-	os::Printer::log("CXFileReader: Reading skin mesh header", ELL_DEBUG);
+	log("CXFileReader: Reading skin mesh header", ELL_DEBUG);
 #endif
 
 	if (!readHeadOfDataObject())
 	{
-		os::Printer::log("No opening brace in Skin Mesh header found in .x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No opening brace in Skin Mesh header found in .x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -1199,8 +1621,8 @@ bool CXMeshFileLoader::parseDataObjectSkinMeshHeader(SXMesh& mesh)
 
 	if (!checkForClosingBrace())
 	{
-		os::Printer::log("No closing brace in skin mesh header in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No closing brace in skin mesh header in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -1211,13 +1633,13 @@ bool CXMeshFileLoader::parseDataObjectSkinMeshHeader(SXMesh& mesh)
 bool CXMeshFileLoader::parseDataObjectMeshNormals(SXMesh &mesh)
 {
 #ifdef _XREADER_DEBUG
-	os::Printer::log("CXFileReader: reading mesh normals", ELL_DEBUG);
+	log("CXFileReader: reading mesh normals", ELL_DEBUG);
 #endif
 
 	if (!readHeadOfDataObject())
 	{
-		os::Printer::log("No opening brace in Mesh Normals found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No opening brace in Mesh Normals found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -1227,13 +1649,13 @@ bool CXMeshFileLoader::parseDataObjectMeshNormals(SXMesh &mesh)
 	normals.set_used(nNormals);
 
 	// read normals
-	for (u32 i=0; i<nNormals; ++i)
-		readVector3(normals[i]);
+	if (nNormals)
+		readFloatArray(&normals[0].X, nNormals, 3, sizeof(core::vector3df));
 
 	if (!checkForTwoFollowingSemicolons())
 	{
-		os::Printer::log("No finishing semicolon in Mesh Normals Array found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No finishing semicolon in Mesh Normals Array found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 	}
 
 	core::array<u32> normalIndices;
@@ -1252,26 +1674,24 @@ bool CXMeshFileLoader::parseDataObjectMeshNormals(SXMesh &mesh)
 
 		if (indexcount != mesh.IndexCountPerFace[k])
 		{
-			os::Printer::log("Not matching normal and face index count found in x file", ELL_WARNING);
-			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+			log("Not matching normal and face index count found in x file", ELL_WARNING);
+			log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 			return false;
 		}
 
 		if (indexcount == 3)
 		{
 			// default, only one triangle in this face
+			u32 normalnum[3];
+			readIntArray(normalnum, 3);
 			for (u32 h=0; h<3; ++h)
-			{
-				const u32 normalnum = readInt();
-				mesh.Vertices[mesh.Indices[normalidx++]].Normal.set(normals[normalnum]);
-			}
+				mesh.Vertices[mesh.Indices[normalidx++]].Normal.set(normals[normalnum[h]]);
 		}
 		else
 		{
 			polygonfaces.set_used(fcnt);
 			// multiple triangles in this face
-			for (u32 h=0; h<fcnt; ++h)
-				polygonfaces[h] = readInt();
+			readIntArray(polygonfaces.pointer(), fcnt);
 
 			for (u32 jk=0; jk<triangles; ++jk)
 			{
@@ -1284,14 +1704,14 @@ bool CXMeshFileLoader::parseDataObjectMeshNormals(SXMesh &mesh)
 
 	if (!checkForTwoFollowingSemicolons())
 	{
-		os::Printer::log("No finishing semicolon in Mesh Face Normals Array found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No finishing semicolon in Mesh Face Normals Array found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 	}
 
 	if (!checkForClosingBrace())
 	{
-		os::Printer::log("No closing brace in Mesh Normals found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No closing brace in Mesh Normals found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -1302,30 +1722,36 @@ bool CXMeshFileLoader::parseDataObjectMeshNormals(SXMesh &mesh)
 bool CXMeshFileLoader::parseDataObjectMeshTextureCoords(SXMesh &mesh)
 {
 #ifdef _XREADER_DEBUG
-	os::Printer::log("CXFileReader: reading mesh texture coordinates", ELL_DEBUG);
+	log("CXFileReader: reading mesh texture coordinates", ELL_DEBUG);
 #endif
 
 	if (!readHeadOfDataObject())
 	{
-		os::Printer::log("No opening brace in Mesh Texture Coordinates found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No opening brace in Mesh Texture Coordinates found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
 	const u32 nCoords = readInt();
-	for (u32 i=0; i<nCoords; ++i)
-		readVector2(mesh.Vertices[i].TCoords);
+	const u32 nUsed = core::min_(nCoords, mesh.Vertices.size());
+	if (nUsed)
+		readFloatArray(&mesh.Vertices[0].TCoords.X, nUsed, 2, sizeof(video::S3DVertex));
+
+	// skip coordinates without a vertex
+	core::vector2df unused;
+	for (u32 i=nUsed; i<nCoords; ++i)
+		readVector2(unused);
 
 	if (!checkForTwoFollowingSemicolons())
 	{
-		os::Printer::log("No finishing semicolon in Mesh Texture Coordinates Array found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No finishing semicolon in Mesh Texture Coordinates Array found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 	}
 
 	if (!checkForClosingBrace())
 	{
-		os::Printer::log("No closing brace in Mesh Texture Coordinates Array found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No closing brace in Mesh Texture Coordinates Array found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -1336,13 +1762,13 @@ bool CXMeshFileLoader::parseDataObjectMeshTextureCoords(SXMesh &mesh)
 bool CXMeshFileLoader::parseDataObjectMeshVertexColors(SXMesh &mesh)
 {
 #ifdef _XREADER_DEBUG
-	os::Printer::log("CXFileReader: reading mesh vertex colors", ELL_DEBUG);
+	log("CXFileReader: reading mesh vertex colors", ELL_DEBUG);
 #endif
 
 	if (!readHeadOfDataObject())
 	{
-		os::Printer::log("No opening brace for Mesh Vertex Colors found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No opening brace for Mesh Vertex Colors found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -1353,8 +1779,8 @@ bool CXMeshFileLoader::parseDataObjectMeshVertexColors(SXMesh &mesh)
 		const u32 Index=readInt();
 		if (Index>=mesh.Vertices.size())
 		{
-			os::Printer::log("index value in parseDataObjectMeshVertexColors out of bounds", ELL_WARNING);
-			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+			log("index value in parseDataObjectMeshVertexColors out of bounds", ELL_WARNING);
+			log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 			return false;
 		}
 		readRGBA(mesh.Vertices[Index].Color);
@@ -1363,14 +1789,14 @@ bool CXMeshFileLoader::parseDataObjectMeshVertexColors(SXMesh &mesh)
 
 	if (!checkForOneFollowingSemicolons())
 	{
-		os::Printer::log("No finishing semicolon in Mesh Vertex Colors Array found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No finishing semicolon in Mesh Vertex Colors Array found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 	}
 
 	if (!checkForClosingBrace())
 	{
-		os::Printer::log("No closing brace in Mesh Texture Coordinates Array found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No closing brace in Mesh Texture Coordinates Array found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -1381,13 +1807,13 @@ bool CXMeshFileLoader::parseDataObjectMeshVertexColors(SXMesh &mesh)
 bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 {
 #ifdef _XREADER_DEBUG
-	os::Printer::log("CXFileReader: Reading mesh material list", ELL_DEBUG);
+	log("CXFileReader: Reading mesh material list", ELL_DEBUG);
 #endif
 
 	if (!readHeadOfDataObject())
 	{
-		os::Printer::log("No opening brace in Mesh Material List found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No opening brace in Mesh Material List found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -1401,7 +1827,7 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 	// being represented as 1;1;0;; which means 1 material, 1 face with first material
 	// all the other faces have to obey then, so check is disabled
 	//if (nFaceIndices != mesh.IndexCountPerFace.size())
-	//	os::Printer::log("Index count per face not equal to face material index count in x file.", ELL_WARNING);
+	//	log("Index count per face not equal to face material index count in x file.", ELL_WARNING);
 
 	// read non triangulated face indices and create triangulated ones
 	mesh.FaceMaterialIndices.set_used( mesh.Indices.size() / 3);
@@ -1432,8 +1858,8 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 
 		if (objectName.size() == 0)
 		{
-			os::Printer::log("Unexpected ending found in Mesh Material list in .x file.", ELL_WARNING);
-			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+			log("Unexpected ending found in Mesh Material list in .x file.", ELL_WARNING);
+			log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 			return false;
 		}
 		else
@@ -1455,7 +1881,7 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 		if (objectName == "Material")
 		{
 			mesh.Materials.push_back(video::SMaterial());
-			if (!parseDataObjectMaterial(mesh.Materials.getLast()))
+			if (!parseDataObjectMaterial(mesh.Materials.getLast(), &mesh.Textures, mesh.Materials.size()-1))
 				return false;
 		}
 		else
@@ -1465,7 +1891,7 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in material list in x file", objectName.c_str(), ELL_WARNING);
+			log("Unknown data object in material list in x file", objectName.c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1474,16 +1900,17 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 }
 
 
-bool CXMeshFileLoader::parseDataObjectMaterial(video::SMaterial& material)
+bool CXMeshFileLoader::parseDataObjectMaterial(video::SMaterial& material,
+		core::array<SXMesh::SXTexture>* textures, u32 materialIndex)
 {
 #ifdef _XREADER_DEBUG
-	os::Printer::log("CXFileReader: Reading mesh material", ELL_DEBUG);
+	log("CXFileReader: Reading mesh material", ELL_DEBUG);
 #endif
 
 	if (!readHeadOfDataObject())
 	{
-		os::Printer::log("No opening brace in Mesh Material found in .x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No opening brace in Mesh Material found in .x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -1507,8 +1934,8 @@ bool CXMeshFileLoader::parseDataObjectMaterial(video::SMaterial& material)
 
 		if (objectName.size() == 0)
 		{
-			os::Printer::log("Unexpected ending found in Mesh Material in .x file.", ELL_WARNING);
-			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+			log("Unexpected ending found in Mesh Material in .x file.", ELL_WARNING);
+			log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 			return false;
 		}
 		else
@@ -1524,19 +1951,7 @@ bool CXMeshFileLoader::parseDataObjectMaterial(video::SMaterial& material)
 			if (!parseDataObjectTextureFilename(TextureFileName))
 				return false;
 
-			// original name
-			if (FileSystem->existFile(TextureFileName))
-				material.setTexture(textureLayer, SceneManager->getVideoDriver()->getTexture(TextureFileName));
-			// mesh path
-			else
-			{
-				TextureFileName=FilePath + FileSystem->getFileBasename(TextureFileName);
-				if (FileSystem->existFile(TextureFileName))
-					material.setTexture(textureLayer, SceneManager->getVideoDriver()->getTexture(TextureFileName));
-				// working directory
-				else
-					material.setTexture(textureLayer, SceneManager->getVideoDriver()->getTexture(FileSystem->getFileBasename(TextureFileName)));
-			}
+			setTexture(material, textureLayer, TextureFileName, textures, materialIndex);
 			++textureLayer;
 			if (textureLayer==2)
 				material.MaterialType=video::EMT_LIGHTMAP;
@@ -1549,25 +1964,13 @@ bool CXMeshFileLoader::parseDataObjectMaterial(video::SMaterial& material)
 			if (!parseDataObjectTextureFilename(TextureFileName))
 				return false;
 
-			// original name
-			if (FileSystem->existFile(TextureFileName))
-				material.setTexture(1, SceneManager->getVideoDriver()->getTexture(TextureFileName));
-			// mesh path
-			else
-			{
-				TextureFileName=FilePath + FileSystem->getFileBasename(TextureFileName);
-				if (FileSystem->existFile(TextureFileName))
-					material.setTexture(1, SceneManager->getVideoDriver()->getTexture(TextureFileName));
-				// working directory
-				else
-					material.setTexture(1, SceneManager->getVideoDriver()->getTexture(FileSystem->getFileBasename(TextureFileName)));
-			}
+			setTexture(material, 1, TextureFileName, textures, materialIndex);
 			if (textureLayer==1)
 				++textureLayer;
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in material in .x file", objectName.c_str(), ELL_WARNING);
+			log("Unknown data object in material in .x file", objectName.c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1580,18 +1983,18 @@ bool CXMeshFileLoader::parseDataObjectMaterial(video::SMaterial& material)
 bool CXMeshFileLoader::parseDataObjectAnimationSet()
 {
 #ifdef _XREADER_DEBUG
-	os::Printer::log("CXFileReader: Reading animation set", ELL_DEBUG);
+	log("CXFileReader: Reading animation set", ELL_DEBUG);
 #endif
 
 	core::stringc AnimationName;
 
 	if (!readHeadOfDataObject(&AnimationName))
 	{
-		os::Printer::log("No opening brace in Animation Set found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No opening brace in Animation Set found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
-	os::Printer::log("Reading animationset ", AnimationName, ELL_DEBUG);
+	log("Reading animationset ", AnimationName.c_str(), ELL_DEBUG);
 
 	while(true)
 	{
@@ -1599,8 +2002,8 @@ bool CXMeshFileLoader::parseDataObjectAnimationSet()
 
 		if (objectName.size() == 0)
 		{
-			os::Printer::log("Unexpected ending found in Animation set in x file.", ELL_WARNING);
-			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+			log("Unexpected ending found in Animation set in x file.", ELL_WARNING);
+			log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 			return false;
 		}
 		else
@@ -1611,12 +2014,12 @@ bool CXMeshFileLoader::parseDataObjectAnimationSet()
 		else
 		if (objectName == "Animation")
 		{
-			if (!parseDataObjectAnimation())
+			if (!parseOrDeferAnimation())
 				return false;
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in animation set in x file", objectName.c_str(), ELL_WARNING);
+			log("Unknown data object in animation set in x file", objectName.c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1625,24 +2028,21 @@ bool CXMeshFileLoader::parseDataObjectAnimationSet()
 }
 
 
-bool CXMeshFileLoader::parseDataObjectAnimation()
+bool CXMeshFileLoader::parseDataObjectAnimation(SXAnimation& animation)
 {
 #ifdef _XREADER_DEBUG
-	os::Printer::log("CXFileReader: reading animation", ELL_DEBUG);
+	log("CXFileReader: reading animation", ELL_DEBUG);
 #endif
 
 	if (!readHeadOfDataObject())
 	{
-		os::Printer::log("No opening brace in Animation found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No opening brace in Animation found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
 	//anim.closed = true;
 	//anim.linearPositionQuality = true;
-	CSkinnedMesh::SJoint animationDump;
-
-	core::stringc FrameName;
 
 	while(true)
 	{
@@ -1650,8 +2050,8 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 
 		if (objectName.size() == 0)
 		{
-			os::Printer::log("Unexpected ending found in Animation in x file.", ELL_WARNING);
-			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+			log("Unexpected ending found in Animation in x file.", ELL_WARNING);
+			log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 			return false;
 		}
 		else
@@ -1662,7 +2062,7 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 		else
 		if (objectName == "AnimationKey")
 		{
-			if (!parseDataObjectAnimationKey(&animationDump))
+			if (!parseDataObjectAnimationKey(&animation.Keys))
 				return false;
 		}
 		else
@@ -1676,70 +2076,23 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 		if (objectName == "{")
 		{
 			// read frame name
-			FrameName = getNextToken();
+			animation.FrameName = getNextToken();
 
 			if (!checkForClosingBrace())
 			{
-				os::Printer::log("Unexpected ending found in Animation in x file.", ELL_WARNING);
-				os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+				log("Unexpected ending found in Animation in x file.", ELL_WARNING);
+				log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 				return false;
 			}
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in animation in x file", objectName.c_str(), ELL_WARNING);
+			log("Unknown data object in animation in x file", objectName.c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
 	}
 
-	if (FrameName.size() != 0)
-	{
-#ifdef _XREADER_DEBUG
-		os::Printer::log("frame name", FrameName.c_str(), ELL_DEBUG);
-#endif
-		CSkinnedMesh::SJoint *joint=0;
-
-		u32 n;
-		for (n=0; n < AnimatedMesh->getAllJoints().size(); ++n)
-		{
-			if (AnimatedMesh->getAllJoints()[n]->Name==FrameName)
-			{
-				joint=AnimatedMesh->getAllJoints()[n];
-				break;
-			}
-		}
-
-		if (!joint)
-		{
-#ifdef _XREADER_DEBUG
-			os::Printer::log("creating joint for animation ", FrameName.c_str(), ELL_DEBUG);
-#endif
-			joint=AnimatedMesh->addJoint(0);
-			joint->Name=FrameName;
-		}
-
-		joint->PositionKeys.reallocate(joint->PositionKeys.size()+animationDump.PositionKeys.size());
-		for (n=0; n<animationDump.PositionKeys.size(); ++n)
-		{
-			joint->PositionKeys.push_back(animationDump.PositionKeys[n]);
-		}
-
-		joint->ScaleKeys.reallocate(joint->ScaleKeys.size()+animationDump.ScaleKeys.size());
-		for (n=0; n<animationDump.ScaleKeys.size(); ++n)
-		{
-			joint->ScaleKeys.push_back(animationDump.ScaleKeys[n]);
-		}
-
-		joint->RotationKeys.reallocate(joint->RotationKeys.size()+animationDump.RotationKeys.size());
-		for (n=0; n<animationDump.RotationKeys.size(); ++n)
-		{
-			joint->RotationKeys.push_back(animationDump.RotationKeys[n]);
-		}
-	}
-	else
-		os::Printer::log("joint name was never given", ELL_WARNING);
-
 	return true;
 }
 
@@ -1747,13 +2100,13 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 bool CXMeshFileLoader::parseDataObjectAnimationKey(ISkinnedMesh::SJoint *joint)
 {
 #ifdef _XREADER_DEBUG
-	os::Printer::log("CXFileReader: reading animation key", ELL_DEBUG);
+	log("CXFileReader: reading animation key", ELL_DEBUG);
 #endif
 
 	if (!readHeadOfDataObject())
 	{
-		os::Printer::log("No opening brace in Animation Key found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No opening brace in Animation Key found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -1763,8 +2116,8 @@ bool CXMeshFileLoader::parseDataObjectAnimationKey(ISkinnedMesh::SJoint *joint)
 
 	if (keyType > 4)
 	{
-		os::Printer::log("Unknown key type found in Animation Key in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("Unknown key type found in Animation Key in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -1776,6 +2129,23 @@ bool CXMeshFileLoader::parseDataObjectAnimationKey(ISkinnedMesh::SJoint *joint)
 	if (numberOfKeys == 0)
 		checkForOneFollowingSemicolons();
 
+	switch(keyType)
+	{
+	case 0:
+		joint->RotationKeys.reallocate(joint->RotationKeys.size()+numberOfKeys);
+		break;
+	case 1:
+		joint->ScaleKeys.reallocate(joint->ScaleKeys.size()+numberOfKeys);
+		break;
+	case 2:
+		joint->PositionKeys.reallocate(joint->PositionKeys.size()+numberOfKeys);
+		break;
+	default:
+		joint->RotationKeys.reallocate(joint->RotationKeys.size()+numberOfKeys);
+		joint->PositionKeys.reallocate(joint->PositionKeys.size()+numberOfKeys);
+		break;
+	}
+
 	for (u32 i=0; i<numberOfKeys; ++i)
 	{
 		// read time
@@ -1791,25 +2161,23 @@ bool CXMeshFileLoader::parseDataObjectAnimationKey(ISkinnedMesh::SJoint *joint)
 				// read count
 				if (readInt() != 4)
 				{
-					os::Printer::log("Expected 4 numbers in animation key in x file", ELL_WARNING);
-					os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+					log("Expected 4 numbers in animation key in x file", ELL_WARNING);
+					log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 					return false;
 				}
 
-				f32 W = -readFloat();
-				f32 X = -readFloat();
-				f32 Y = -readFloat();
-				f32 Z = -readFloat();
+				f32 WXYZ[4];
+				readFloatArray(WXYZ, 1, 4, sizeof(WXYZ));
 
 				if (!checkForTwoFollowingSemicolons())
 				{
-					os::Printer::log("No finishing semicolon after quaternion animation key in x file", ELL_WARNING);
-					os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+					log("No finishing semicolon after quaternion animation key in x file", ELL_WARNING);
+					log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 				}
 
 				ISkinnedMesh::SRotationKey *key=AnimatedMesh->addRotationKey(joint);
 				key->frame=time;
-				key->rotation.set(X,Y,Z,W);
+				key->rotation.set(-WXYZ[1],-WXYZ[2],-WXYZ[3],-WXYZ[0]);
 				key->rotation.normalize();
 			}
 			break;
@@ -1821,18 +2189,18 @@ bool CXMeshFileLoader::parseDataObjectAnimationKey(ISkinnedMesh::SJoint *joint)
 				// read count
 				if (readInt() != 3)
 				{
-					os::Printer::log("Expected 3 numbers in animation key in x file", ELL_WARNING);
-					os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+					log("Expected 3 numbers in animation key in x file", ELL_WARNING);
+					log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 					return false;
 				}
 
 				core::vector3df vector;
-				readVector3(vector);
+				readFloatArray(&vector.X, 1, 3, sizeof(vector));
 
 				if (!checkForTwoFollowingSemicolons())
 				{
-					os::Printer::log("No finishing semicolon after vector animation key in x file", ELL_WARNING);
-					os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+					log("No finishing semicolon after vector animation key in x file", ELL_WARNING);
+					log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 				}
 
 				if (keyType==2)
@@ -1857,8 +2225,8 @@ bool CXMeshFileLoader::parseDataObjectAnimationKey(ISkinnedMesh::SJoint *joint)
 				// read count
 				if (readInt() != 16)
 				{
-					os::Printer::log("Expected 16 numbers in animation key in x file", ELL_WARNING);
-					os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+					log("Expected 16 numbers in animation key in x file", ELL_WARNING);
+					log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 					return false;
 				}
 
@@ -1870,8 +2238,8 @@ bool CXMeshFileLoader::parseDataObjectAnimationKey(ISkinnedMesh::SJoint *joint)
 
 				if (!checkForOneFollowingSemicolons())
 				{
-					os::Printer::log("No finishing semicolon after matrix animation key in x file", ELL_WARNING);
-					os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+					log("No finishing semicolon after matrix animation key in x file", ELL_WARNING);
+					log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 				}
 
 				//core::vector3df rotation = mat.getRotationDegrees();
@@ -1910,8 +2278,8 @@ bool CXMeshFileLoader::parseDataObjectAnimationKey(ISkinnedMesh::SJoint *joint)
 
 	if (!checkForClosingBrace())
 	{
-		os::Printer::log("No closing brace in animation key in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No closing brace in animation key in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -1922,27 +2290,27 @@ bool CXMeshFileLoader::parseDataObjectAnimationKey(ISkinnedMesh::SJoint *joint)
 bool CXMeshFileLoader::parseDataObjectTextureFilename(core::stringc& texturename)
 {
 #ifdef _XREADER_DEBUG
-	os::Printer::log("CXFileReader: reading texture filename", ELL_DEBUG);
+	log("CXFileReader: reading texture filename", ELL_DEBUG);
 #endif
 
 	if (!readHeadOfDataObject())
 	{
-		os::Printer::log("No opening brace in Texture filename found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No opening brace in Texture filename found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
 	if (!getNextTokenAsString(texturename))
 	{
-		os::Printer::log("Unknown syntax while reading texture filename string in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("Unknown syntax while reading texture filename string in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
 	if (!checkForClosingBrace())
 	{
-		os::Printer::log("No closing brace in Texture filename found in x file", ELL_WARNING);
-		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		log("No closing brace in Texture filename found in x file", ELL_WARNING);
+		log("Line", core::stringc(Line).c_str(), ELL_WARNING);
 		return false;
 	}
 
@@ -2332,35 +2700,160 @@ f32 CXMeshFileLoader::readFloat()
 				BinaryNumCount = 1; // single int
 		}
 		--BinaryNumCount;
-		if (FloatSize == 8)
-		{
+		return readBinFloat();
+	}
+	findNextNoneWhiteSpaceNumber();
+	f32 ftmp;
+	P = core::fast_atof_move(P, ftmp);
+	return ftmp;
+}
+
+
+//! reads one float of a binary float list
+f32 CXMeshFileLoader::readBinFloat()
+{
+	if (FloatSize == 8)
+	{
+#ifdef __BIG_ENDIAN__
+		//TODO: Check if data is properly converted here
+		f32 ctmp[2];
+		ctmp[1] = os::Byteswap::byteswap(*(f32*)P);
+		ctmp[0] = os::Byteswap::byteswap(*(f32*)P+4);
+		const f32 tmp = (f32)(*(f64*)(void*)ctmp);
+#else
+		const f32 tmp = (f32)(*(f64 *)P);
+#endif
+		P += 8;
+		return tmp;
+	}
+	else
+	{
 #ifdef __BIG_ENDIAN__
-			//TODO: Check if data is properly converted here
-			f32 ctmp[2];
-			ctmp[1] = os::Byteswap::byteswap(*(f32*)P);
-			ctmp[0] = os::Byteswap::byteswap(*(f32*)P+4);
-			const f32 tmp = (f32)(*(f64*)(void*)ctmp);
+		const f32 tmp = os::Byteswap::byteswap(*(f32 *)P);
 #else
-			const f32 tmp = (f32)(*(f64 *)P);
+		const f32 tmp = *(f32 *)P;
 #endif
-			P += 8;
-			return tmp;
+		P += 4;
+		return tmp;
+	}
+}
+
+
+//! reads count groups of components floats, group i is written to out+i*stride bytes
+/** In binary files, whole runs of a float list are taken at once, and
+copied directly when they are laid out like the destination. */
+void CXMeshFileLoader::readFloatArray(f32* out, u32 count, u32 components, u32 stride)
+{
+	u32 k = 0;
+
+	if (!BinaryFormat)
+	{
+		for (u32 i=0; i<count; ++i)
+		{
+			for (k=0; k<components; ++k)
+				out[k] = readFloat();
+			out = (f32*)((c8*)out + stride);
 		}
-		else
+		return;
+	}
+
+	u32 left = count * components;
+	while (left)
+	{
+		if (!BinaryNumCount)
+		{
+			const u16 tmp = readBinWord();
+			if (tmp == 0x07)
+				BinaryNumCount = readBinDWord();
+			else
+				BinaryNumCount = 1; // single value
+		}
+
+		u32 n = core::min_(left, BinaryNumCount);
+		if (P + n * FloatSize > End)
 		{
+			// truncated file, the rest is read as zeros
+			P = End;
+			BinaryNumCount = 0;
+			for (; left; --left)
+			{
+				out[k] = 0.f;
+				if (++k == components)
+				{
+					k = 0;
+					out = (f32*)((c8*)out + stride);
+				}
+			}
+			return;
+		}
+		BinaryNumCount -= n;
+		left -= n;
+
+#ifndef __BIG_ENDIAN__
+		if (FloatSize == 4 && stride == components*sizeof(f32))
+		{
+			memcpy(out + k, P, n*sizeof(f32));
+			P += n*sizeof(f32);
+			out += (k + n) / components * components;
+			k = (k + n) % components;
+			continue;
+		}
+#endif
+		for (; n; --n)
+		{
+			out[k] = readBinFloat();
+			if (++k == components)
+			{
+				k = 0;
+				out = (f32*)((c8*)out + stride);
+			}
+		}
+	}
+}
+
+
+//! reads count integers
+void CXMeshFileLoader::readIntArray(u32* out, u32 count)
+{
+	if (!BinaryFormat)
+	{
+		for (u32 i=0; i<count; ++i)
+			out[i] = readInt();
+		return;
+	}
+
+	while (count)
+	{
+		if (!BinaryNumCount)
+		{
+			const u16 tmp = readBinWord();
+			if (tmp == 0x06)
+				BinaryNumCount = readBinDWord();
+			else
+				BinaryNumCount = 1; // single int
+		}
+
+		u32 n = core::min_(count, BinaryNumCount);
+		if (P + n * 4 > End)
+		{
+			// truncated file, the rest is read as zeros
+			P = End;
+			BinaryNumCount = 0;
+			memset(out, 0, count*sizeof(u32));
+			return;
+		}
+		BinaryNumCount -= n;
+		count -= n;
+
 #ifdef __BIG_ENDIAN__
-			const f32 tmp = os::Byteswap::byteswap(*(f32 *)P);
+		for (; n; --n)
+			*out++ = readBinDWord();
 #else
-			const f32 tmp = *(f32 *)P;
+		memcpy(out, P, n*sizeof(u32));
+		P += n*sizeof(u32);
+		out += n;
 #endif
-			P += 4;
-			return tmp;
-		}
 	}
-	findNextNoneWhiteSpaceNumber();
-	f32 ftmp;
-	P = core::fast_atof_move(P, ftmp);
-	return ftmp;
 }
 
 
@@ -6,6 +6,7 @@
 #define __C_X_MESH_FILE_LOADER_H_INCLUDED__
 
 #include "IMeshLoader.h"
+#include "ILogger.h"
 #include "irrString.h"
 #include "CSkinnedMesh.h"
 
@@ -78,6 +79,25 @@ public:
 		core::array<u32> WeightJoint;
 		core::array<u32> WeightNum;
 
+		//! skin weights of one joint, added to the joint when the mesh is complete
+		struct SXWeights
+		{
+			core::stringc JointName;
+			core::array<u32> VertexIds;
+			core::array<f32> Strengths;
+			core::matrix4 MatrixOffset;
+		};
+		core::array<SXWeights> SkinWeights;
+
+		//! texture file of a material, loaded when the mesh is complete
+		struct SXTexture
+		{
+			core::stringc Name;
+			u32 Material;
+			u32 Layer;
+		};
+		core::array<SXTexture> Textures;
+
 		s32 AttachedJointID;
 
 		bool HasSkinning;
@@ -86,6 +106,37 @@ public:
 
 private:
 
+	//! keys of an Animation data object, added to its joint when complete
+	struct SXAnimation
+	{
+		core::stringc FrameName;
+		CSkinnedMesh::SJoint Keys;
+	};
+
+	//! message logged by a worker thread, printed after the workers finished
+	struct SXLogMessage
+	{
+		core::stringc Text;
+		core::stringc Hint;
+		ELOG_LEVEL Level;
+		bool HasHint;
+	};
+
+	//! Mesh or Animation data object which is parsed on a worker thread
+	struct SXDeferredObject
+	{
+		SXMesh* Mesh;
+		SXAnimation* Animation;
+		const c8* Begin;
+		const c8* End;
+		u32 Line;
+		u32 TemplateMaterialCount;
+		core::array<SXLogMessage> Messages;
+		bool Result;
+	};
+
+	struct SXParseJob;
+
 	bool load(io::IReadFile* file);
 
 	bool readFileIntoMemory(io::IReadFile* file);
@@ -114,11 +165,16 @@ private:
 
 	bool parseDataObjectMeshMaterialList(SXMesh &mesh);
 
-	bool parseDataObjectMaterial(video::SMaterial& material);
+	bool parseDataObjectMaterial(video::SMaterial& material,
+		core::array<SXMesh::SXTexture>* textures=0, u32 materialIndex=0);
+
+	//! Loads a texture into a material, or only remembers its name if textures is not 0
+	void setTexture(video::SMaterial& material, u32 layer, const core::stringc& name,
+		core::array<SXMesh::SXTexture>* textures, u32 materialIndex);
 
 	bool parseDataObjectAnimationSet();
 
-	bool parseDataObjectAnimation();
+	bool parseDataObjectAnimation(SXAnimation& animation);
 
 	bool parseDataObjectAnimationKey(ISkinnedMesh::SJoint *joint);
 
@@ -126,6 +182,42 @@ private:
 
 	bool parseUnknownDataObject();
 
+	//! parses a Mesh data object, or remembers it for parseDeferredObjects()
+	bool parseOrDeferMesh(SXMesh* mesh);
+
+	//! parses an Animation data object, or remembers it for parseDeferredObjects()
+	bool parseOrDeferAnimation();
+
+	//! skips a data object and remembers it for parsing it on a worker thread
+	bool deferDataObject(SXMesh* mesh, SXAnimation* animation);
+
+	//! parses all deferred data objects at once, and applies them in file order
+	bool parseDeferredObjects();
+
+	//! parses one deferred data object, called by the workers
+	void parseDeferredObject(SXDeferredObject& object) const;
+
+	//! skips the rest of a data object after its opening brace
+	/** \param jointNames Receives the names of the joints the
+	skin weights or animation in the object refer to. */
+	bool skipDataObject(bool animation, core::array<core::stringc>& jointNames);
+
+	//! returns a joint by name, creates it if there is none
+	CSkinnedMesh::SJoint* getJoint(const core::stringc& name, u32* index=0);
+
+	//! adds the skin weights and textures of a mesh to the animated mesh
+	void applyMesh(SXMesh& mesh);
+
+	//! adds the keys of an animation to its joint
+	void applyAnimation(SXAnimation& animation);
+
+	//! loads a texture referenced by a material
+	video::ITexture* loadTexture(core::stringc name) const;
+
+	//! logs a message, or keeps it when parsing on a worker thread
+	void log(const c8* text, ELOG_LEVEL level=ELL_INFORMATION) const;
+	void log(const c8* text, const c8* hint, ELOG_LEVEL level=ELL_INFORMATION) const;
+
 	//! places pointer to next begin of a token, and ignores comments
 	void findNextNoneWhiteSpace();
 
@@ -159,6 +251,11 @@ private:
 	u32 readBinDWord();
 	u32 readInt();
 	f32 readFloat();
+	f32 readBinFloat();
+	//! reads count groups of components floats, group i is written to out+i*stride bytes
+	void readFloatArray(f32* out, u32 count, u32 components, u32 stride);
+	//! reads count integers
+	void readIntArray(u32* out, u32 count);
 	bool readVector2(core::vector2df& vec);
 	bool readVector3(core::vector3df& vec);
 	bool readMatrix(core::matrix4& mat);
@@ -174,7 +271,7 @@ private:
 
 	c8* Buffer;
 	const c8* P;
-	c8* End;
+	const c8* End;
 	// counter for number arrays in binary format
 	u32 BinaryNumCount;
 	u32 Line;
@@ -186,6 +283,13 @@ private:
 
 	core::array<SXTemplateMaterial> TemplateMaterials;
 
+	//! Mesh and Animation objects to parse on worker threads, in file order
+	core::array<SXDeferredObject> DeferredObjects;
+	//! messages of a worker, 0 when running on the main thread
+	core::array<SXLogMessage>* Messages;
+	//! parse Mesh and Animation objects later on worker threads
+	bool DeferObjects;
+
 	u32 MajorVersion;
 	u32 MinorVersion;
 	bool BinaryFormat;
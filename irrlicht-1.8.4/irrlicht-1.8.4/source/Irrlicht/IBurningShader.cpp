@@ -8,6 +8,7 @@
 #include "SoftwareDriver2_compile_config.h"
 #include "IBurningShader.h"
 #include "CSoftwareDriver2.h"
+#include "CColorConverter.h"
 
 namespace irr
 {
@@ -31,6 +32,10 @@ namespace video
 		for ( u32 i = 0; i != BURNING_MATERIAL_MAX_TEXTURES; ++i )
 		{
 			IT[i].Texture = 0;
+#ifdef SOFTWARE_DRIVER_2_TEXTURE_COMPRESSION
+			IT[i].blockSize = 0;
+			IT[i].blockCache = 0;
+#endif
 		}
 
 		Driver = driver;
@@ -63,6 +68,9 @@ namespace video
 		{
 			if ( IT[i].Texture )
 				IT[i].Texture->drop();
+#ifdef SOFTWARE_DRIVER_2_TEXTURE_COMPRESSION
+			delete IT[i].blockCache;
+#endif
 		}
 	}
 
@@ -110,11 +118,78 @@ namespace video
 			const core::dimension2d<u32> &dim = it->Texture->getSize();
 			it->textureXMask = s32_to_fixPoint ( dim.Width - 1 ) & FIX_POINT_UNSIGNED_MASK;
 			it->textureYMask = s32_to_fixPoint ( dim.Height - 1 ) & FIX_POINT_UNSIGNED_MASK;
+
+#ifdef SOFTWARE_DRIVER_2_TEXTURE_COMPRESSION
+			it->blockFormat = it->Texture->getColorFormat();
+			it->blockSize = IImage::getBlockSizeFromFormat ( it->blockFormat );
+			if ( it->blockSize )
+			{
+				// the samplers address the texels as if the level was uncompressed
+				it->pitchlog2 = s32_log2_s32 ( dim.Width << VIDEO_SAMPLE_GRANULARITY );
+				it->blockPitchlog2 = s32_log2_s32 ( core::s32_max ( 1, dim.Width >> 2 ) );
+
+				if ( !it->blockCache )
+				{
+					it->blockCache = new sBlockCache;
+					it->blockCache->contentId = 0;
+				}
+
+				// the triangles set the texture one after another, keep the
+				// decoded blocks as long as the texels are the same
+				if ( it->blockCache->contentId != it->Texture->getContentId() )
+				{
+					it->blockCache->contentId = it->Texture->getContentId();
+					memset ( it->blockCache->tag, 0, sizeof ( it->blockCache->tag ) );
+				}
+			}
+#endif
 		}
 	}
 
 
 } // end namespace video
+
+
+#ifdef SOFTWARE_DRIVER_2_TEXTURE_COMPRESSION
+
+//! decodes the block of the texel at byte offset ofs of the uncompressed level
+tVideoSample getTexel_block ( const sInternalTexture * t, const u32 ofs )
+{
+	const u32 y = ofs >> t->pitchlog2;
+	const u32 x = ( ofs & ( ( 1 << t->pitchlog2 ) - 1 ) ) >> VIDEO_SAMPLE_GRANULARITY;
+
+	const u32 bx = x >> 2;
+	const u32 by = y >> 2;
+
+	// a quarter of the cache for each of four rows of blocks, so
+	// neighbouring scanlines and the bilinear samples find their blocks
+	const u32 slot = ( bx & ( SOFTWARE_DRIVER_2_BLOCK_CACHE_SIZE / 4 - 1 ) ) |
+			( ( by & 3 ) * ( SOFTWARE_DRIVER_2_BLOCK_CACHE_SIZE / 4 ) );
+	const u32 block = ( by << t->blockPitchlog2 ) + bx;
+
+	sBlockCache* cache = t->blockCache;
+	if ( cache->tag[slot] != block + 1 )
+	{
+		u32 texel[16];
+		video::CColorConverter::decodeDXTBlock ( (u8*) t->data + block * t->blockSize,
+				t->blockFormat, texel );
+
+		for ( u32 i = 0; i != 16; ++i )
+		{
+#ifdef SOFTWARE_DRIVER_2_32BIT
+			cache->texel[slot][i] = texel[i];
+#else
+			cache->texel[slot][i] = video::A8R8G8B8toA1R5G5B5 ( texel[i] );
+#endif
+		}
+		cache->tag[slot] = block + 1;
+	}
+
+	return cache->texel[slot][ ( ( y & 3 ) << 2 ) | ( x & 3 ) ];
+}
+
+#endif
+
 } // end namespace irr
 
 #endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
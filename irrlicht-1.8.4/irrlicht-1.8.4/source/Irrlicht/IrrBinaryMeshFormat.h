@@ -0,0 +1,115 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __IRR_BINARY_MESH_FORMAT_H_INCLUDED__
+#define __IRR_BINARY_MESH_FORMAT_H_INCLUDED__
+
+#include "irrMath.h"
+#include "vector2d.h"
+#include "vector3d.h"
+
+namespace irr
+{
+namespace scene
+{
+//! Constants and vertex encodings of the binary Irrlicht mesh format (.irrbmesh)
+/** The file starts with a header of 16 bytes, all values little endian:
+\code
+	c8  Magic[4];       // "IRBM"
+	u16 Version;        // IRR_BINARY_MESH_VERSION
+	u16 Flags;          // E_IRR_BINARY_MESH_FLAGS
+	u32 DataSize;       // size of the mesh data
+	u32 StoredSize;     // size of the mesh data in the file, zlib compressed if EIBMF_COMPRESSED is set
+\endcode
+The mesh data holds the mesh buffers, and the joints of skinned meshes. Each
+buffer stores its material, vertex type, index type and bounding box. The
+vertex attributes follow one after another, so that similar values are close
+together for the compression:
+- positions as three u16 per vertex, relative to the bounding box
+- normals, tangents and binormals as two u16 in octahedral encoding
+- texture coordinates as two u16, relative to the range of the buffer
+- colors as u32
+Indices are stored as zigzag coded difference to the previous index, with
+7 bits per byte. */
+namespace binarymesh
+{
+	const u16 IRR_BINARY_MESH_VERSION = 1;
+
+	//! Flags of the file header
+	enum E_IRR_BINARY_MESH_FLAGS
+	{
+		//! The mesh data is zlib compressed
+		EIBMF_COMPRESSED = 0x1,
+
+		//! The mesh data is followed by joints and animation keys
+		EIBMF_SKINNED = 0x2
+	};
+
+	//! Size of the file header
+	const u32 IRR_BINARY_MESH_HEADER_SIZE = 16;
+
+	//! Flags of the material layers
+	enum E_IRR_BINARY_MESH_LAYER_FLAGS
+	{
+		EIBMLF_BILINEAR = 0x1,
+		EIBMLF_TRILINEAR = 0x2,
+		EIBMLF_TEXTURE_MATRIX = 0x4
+	};
+
+	//! Quantizes a value in [minValue, minValue+extent] to 16 bit
+	inline u16 quantize(f32 value, f32 minValue, f32 extent)
+	{
+		if (extent <= 0.f)
+			return 0;
+		return (u16)core::clamp(core::round32((value-minValue)/extent*65535.f), 0, 65535);
+	}
+
+	//! Restores a value quantized with quantize()
+	inline f32 dequantize(u16 value, f32 minValue, f32 extent)
+	{
+		return minValue + value*(extent/65535.f);
+	}
+
+	//! Encodes a direction in octahedral mapping, two times 16 bit
+	/** Null vectors are stored as (0,0,1). */
+	inline void encodeDirection(const core::vector3df& dir, u16& u, u16& v)
+	{
+		const f32 l1 = core::abs_(dir.X)+core::abs_(dir.Y)+core::abs_(dir.Z);
+		f32 x = 0.f;
+		f32 y = 0.f;
+		if (l1 > 0.f)
+		{
+			x = dir.X/l1;
+			y = dir.Y/l1;
+			if (dir.Z < 0.f)
+			{
+				const f32 fx = (1.f-core::abs_(y)) * (x >= 0.f ? 1.f : -1.f);
+				y = (1.f-core::abs_(x)) * (y >= 0.f ? 1.f : -1.f);
+				x = fx;
+			}
+		}
+		u = quantize(x, -1.f, 2.f);
+		v = quantize(y, -1.f, 2.f);
+	}
+
+	//! Restores a direction encoded with encodeDirection(), as unit vector
+	inline core::vector3df decodeDirection(u16 u, u16 v)
+	{
+		core::vector3df dir(dequantize(u, -1.f, 2.f), dequantize(v, -1.f, 2.f), 0.f);
+		dir.Z = 1.f-core::abs_(dir.X)-core::abs_(dir.Y);
+		if (dir.Z < 0.f)
+		{
+			const f32 fx = (1.f-core::abs_(dir.Y)) * (dir.X >= 0.f ? 1.f : -1.f);
+			dir.Y = (1.f-core::abs_(dir.X)) * (dir.Y >= 0.f ? 1.f : -1.f);
+			dir.X = fx;
+		}
+		return dir.normalize();
+	}
+
+} // end namespace binarymesh
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -117,6 +117,25 @@ namespace core
 {
 	const matrix4 IdentityMatrix(matrix4::EM4CONST_IDENTITY);
 	irr::core::stringc LOCALE_DECIMAL_POINTS(".");
+
+#ifdef _IRR_COUNT_ALLOCATIONS_
+	//! allocations of all threads, see getAllocationCount()
+	static volatile long AllocationCount = 0;
+
+	IRRLICHT_API u32 IRRCALLCONV getAllocationCount()
+	{
+		return (u32)AllocationCount;
+	}
+
+	IRRLICHT_API void IRRCALLCONV countAllocation()
+	{
+#if defined(_IRR_WINDOWS_)
+		InterlockedIncrement(&AllocationCount);
+#else
+		__sync_fetch_and_add(&AllocationCount, 1);
+#endif
+	}
+#endif
 }
 
 namespace video
@@ -10,6 +10,7 @@
 #include "aabbox3d.h"
 #include "irrArray.h"
 #include "CMeshBuffer.h"
+#include "CThreadPool.h"
 
 /**
 	Flags for Octree
@@ -22,14 +23,24 @@
 #define OCTREE_BOX_BASED true
 //! bypass full invisible/visible test
 #define OCTREE_PARENTTEST
+//! subtrees with more triangles than this are built by the thread pool
+#define OCTREE_PARALLEL_BUILD_TRIANGLES 16384
 
 namespace irr
 {
 
 //! template octree.
 /** T must be a vertex type which has a member
-called .Pos, which is a core::vertex3df position. */
-template <class T>
+called .Pos, which is a core::vertex3df position.
+TIndex is the index type, u16 or u32. With u32 indices the chunks
+take their indices from SMeshChunk::LargeIndices, so meshes with more
+than 65535 vertices per buffer can be used.
+
+All triangles are kept in one array per chunk, sorted in depth first
+order of the nodes. Each node only stores where its own triangles and
+those of its whole subtree start and end, so a node which is fully
+visible is copied with a single memcpy per chunk. */
+template <class T, class TIndex = u16>
 class Octree
 {
 public:
@@ -48,17 +59,14 @@ public:
 		}
 
 		s32 MaterialId;
-	};
 
-	struct SIndexChunk
-	{
-		core::array<u16> Indices;
-		s32 MaterialId;
+		//! 32 bit indices, used instead of the meshbuffer indices by Octree<T, u32>
+		core::array<u32> LargeIndices;
 	};
 
 	struct SIndexData
 	{
-		u16* Indices;
+		TIndex* Indices;
 		s32 CurrentSize;
 		s32 MaxSize;
 	};
@@ -69,26 +77,48 @@ public:
 		IndexData(0), IndexDataCount(meshes.size()), NodeCount(0)
 	{
 		IndexData = new SIndexData[IndexDataCount];
+		SortedIndices.reallocate(IndexDataCount);
 
-		// construct array of all indices
-
-		core::array<SIndexChunk>* indexChunks = new core::array<SIndexChunk>;
-		indexChunks->reallocate(meshes.size());
-		for (u32 i=0; i!=meshes.size(); ++i)
+		// collect all triangles in one flat array
+		u32 triangleCount = 0;
+		u32 i;
+		for (i=0; i!=IndexDataCount; ++i)
 		{
+			const u32 idxCount = getChunkIndexCount(meshes[i]);
+
 			IndexData[i].CurrentSize = 0;
-			IndexData[i].MaxSize = meshes[i].Indices.size();
-			IndexData[i].Indices = new u16[IndexData[i].MaxSize];
+			IndexData[i].MaxSize = idxCount;
+			IndexData[i].Indices = new TIndex[idxCount];
+
+			SortedIndices.push_back(core::array<TIndex>());
+			triangleCount += idxCount / 3;
+		}
 
-			indexChunks->push_back(SIndexChunk());
-			SIndexChunk& tic = indexChunks->getLast();
+		SBuildData build(meshes, minimalPolysPerNode);
+		build.Triangles.set_used(triangleCount);
+		build.Temp.set_used(triangleCount);
+		build.Classes.set_used(triangleCount);
 
-			tic.MaterialId = meshes[i].MaterialId;
-			tic.Indices = meshes[i].Indices;
+		u32 t = 0;
+		for (i=0; i!=IndexDataCount; ++i)
+		{
+			const u32 idxCount = getChunkIndexCount(meshes[i]) / 3 * 3;
+			for (u32 j=0; j<idxCount; j+=3, ++t)
+			{
+				build.Triangles[t].Chunk = i;
+				build.Triangles[t].FirstIndex = j;
+			}
 		}
 
 		// create tree
-		Root = new OctreeNode(NodeCount, 0, meshes, indexChunks, minimalPolysPerNode);
+		Root = new OctreeNode();
+		NodeCount = Root->build(build, 0, triangleCount);
+
+		// store the triangles of each chunk in depth first node order
+		for (i=0; i!=IndexDataCount; ++i)
+			SortedIndices[i].reallocate(IndexData[i].MaxSize);
+		NodeRanges.reallocate(NodeCount * IndexDataCount * 3);
+		Root->sortIndices(build, SortedIndices, NodeRanges);
 	}
 
 	//! returns all ids of polygons partially or fully enclosed
@@ -98,7 +128,7 @@ public:
 		for (u32 i=0; i!=IndexDataCount; ++i)
 			IndexData[i].CurrentSize = 0;
 
-		Root->getPolys(box, IndexData, 0);
+		Root->getPolys(box, *this, 0);
 	}
 
 	//! returns all ids of polygons partially or fully enclosed
@@ -108,7 +138,7 @@ public:
 		for (u32 i=0; i!=IndexDataCount; ++i)
 			IndexData[i].CurrentSize = 0;
 
-		Root->getPolys(frustum, IndexData, 0);
+		Root->getPolys(frustum, *this, 0);
 	}
 
 	const SIndexData* getIndexData() const
@@ -144,133 +174,203 @@ public:
 	}
 
 private:
+
+	static u32 getChunkIndexCount(const SMeshChunk& chunk)
+	{
+		return sizeof(TIndex) == sizeof(u16) ? chunk.Indices.size() : chunk.LargeIndices.size();
+	}
+
+	static u32 getChunkIndex(const SMeshChunk& chunk, u32 i)
+	{
+		return sizeof(TIndex) == sizeof(u16) ? chunk.Indices[i] : chunk.LargeIndices[i];
+	}
+
+	// one triangle of a chunk, moved around while building the tree
+	struct STriangle
+	{
+		u32 Chunk;
+		u32 FirstIndex;
+	};
+
+	// shared state while building the tree. Subtrees only touch their
+	// own range of the arrays, so they can be built in parallel.
+	struct SBuildData
+	{
+		SBuildData(const core::array<SMeshChunk>& meshes, s32 minimalPolysPerNode)
+			: Meshes(meshes), MinimalPolysPerNode(minimalPolysPerNode) {}
+
+		const core::vector3df& getPos(const STriangle& tri, u32 corner) const
+		{
+			const SMeshChunk& chunk = Meshes[tri.Chunk];
+			return chunk.Vertices[getChunkIndex(chunk, tri.FirstIndex + corner)].Pos;
+		}
+
+		const core::array<SMeshChunk>& Meshes;
+		core::array<STriangle> Triangles;
+		core::array<STriangle> Temp;
+		core::array<u8> Classes;
+		s32 MinimalPolysPerNode;
+	};
+
 	// private inner class
 	class OctreeNode
 	{
 	public:
 
 		// constructor
-		OctreeNode(u32& nodeCount, u32 currentdepth,
-			const core::array<SMeshChunk>& allmeshdata,
-			core::array<SIndexChunk>* indices,
-			s32 minimalPolysPerNode) : IndexData(0),
-			Depth(currentdepth+1)
+		OctreeNode() : TriangleBegin(0), TriangleOwnEnd(0), RangeIndex(0)
 		{
-			++nodeCount;
-
-			u32 i; // new ISO for scoping problem with different compilers
-
-			for (i=0; i!=8; ++i)
+			for (u32 i=0; i!=8; ++i)
 				Children[i] = 0;
+		}
 
-			if (indices->empty())
-			{
-				delete indices;
-				return;
-			}
+		// destructor
+		~OctreeNode()
+		{
+			for (u32 i=0; i<8; ++i)
+				delete Children[i];
+		}
 
-			bool found = false;
+		// builds the subtree for the triangles [begin,end), returns the amount of nodes
+		u32 build(SBuildData& data, u32 begin, u32 end)
+		{
+			TriangleBegin = begin;
+			TriangleOwnEnd = end;
+
+			if (begin == end)
+				return 1;
 
-			// find first point for bounding box
+			u32 i;
 
-			for (i=0; i<indices->size(); ++i)
+			// now lets calculate our bounding box
+			Box.reset(data.getPos(data.Triangles[begin], 0));
+			for (i=begin; i<end; ++i)
 			{
-				if (!(*indices)[i].Indices.empty())
-				{
-					Box.reset(allmeshdata[i].Vertices[(*indices)[i].Indices[0]].Pos);
-					found = true;
-					break;
-				}
+				Box.addInternalPoint(data.getPos(data.Triangles[i], 0));
+				Box.addInternalPoint(data.getPos(data.Triangles[i], 1));
+				Box.addInternalPoint(data.getPos(data.Triangles[i], 2));
 			}
 
-			if (!found)
+			if ((s32)((end - begin) * 3) <= data.MinimalPolysPerNode || Box.isEmpty())
+				return 1;
+
+			// find the first child box which contains each triangle,
+			// class 8 means the triangle stays in this node
+			const core::vector3df middle = Box.getCenter();
+			const core::vector3df diag = middle - Box.MaxEdge;
+			u32 counts[9];
+			for (i=0; i!=9; ++i)
+				counts[i] = 0;
+
+			for (i=begin; i<end; ++i)
 			{
-				delete indices;
-				return;
+				const u8 c = classify(data, data.Triangles[i], middle, diag);
+				data.Classes[i] = c;
+				++counts[c];
 			}
 
-			s32 totalPrimitives = 0;
+			if (counts[8] == end - begin)
+				return 1;
 
-			// now lets calculate our bounding box
-			for (i=0; i<indices->size(); ++i)
+			// stable partition: own triangles first, then the children in order
+			u32 starts[9];
+			starts[8] = begin;
+			u32 pos = begin + counts[8];
+			for (i=0; i!=8; ++i)
 			{
-				totalPrimitives += (*indices)[i].Indices.size();
-				for (u32 j=0; j<(*indices)[i].Indices.size(); ++j)
-					Box.addInternalPoint(allmeshdata[i].Vertices[(*indices)[i].Indices[j]].Pos);
+				starts[i] = pos;
+				pos += counts[i];
 			}
 
-			core::vector3df middle = Box.getCenter();
-			core::vector3df edges[8];
-			Box.getEdges(edges);
+			u32 cursor[9];
+			for (i=0; i!=9; ++i)
+				cursor[i] = starts[i];
+			for (i=begin; i<end; ++i)
+				data.Temp[cursor[data.Classes[i]]++] = data.Triangles[i];
+			memcpy(&data.Triangles[begin], &data.Temp[begin], (end - begin) * sizeof(STriangle));
 
-			// calculate all children
-			core::aabbox3d<f32> box;
-			core::array<u16> keepIndices;
+			TriangleOwnEnd = begin + counts[8];
 
-			if (totalPrimitives > minimalPolysPerNode && !Box.isEmpty())
-			for (u32 ch=0; ch!=8; ++ch)
+			// calculate all children
+			SChildJob jobs[8];
+			bool queued[8];
+			CThreadPool::SJobGroup group;
+			CThreadPool* pool = 0;
+			for (i=0; i!=8; ++i)
 			{
-				box.reset(middle);
-				box.addInternalPoint(edges[ch]);
-
-				// create indices for child
-				bool added = false;
-				core::array<SIndexChunk>* cindexChunks = new core::array<SIndexChunk>;
-				cindexChunks->reallocate(allmeshdata.size());
-				for (i=0; i<allmeshdata.size(); ++i)
-				{
-					cindexChunks->push_back(SIndexChunk());
-					SIndexChunk& tic = cindexChunks->getLast();
-					tic.MaterialId = allmeshdata[i].MaterialId;
+				queued[i] = false;
+				if (!counts[i])
+					continue;
+
+				Children[i] = new OctreeNode();
+				jobs[i].set(Children[i], &data, starts[i], starts[i] + counts[i]);
 
-					for (u32 t=0; t<(*indices)[i].Indices.size(); t+=3)
+				if (counts[i] > OCTREE_PARALLEL_BUILD_TRIANGLES)
+				{
+					if (!pool)
+						pool = CThreadPool::getSharedPool();
+					if (pool)
 					{
-						if (box.isPointInside(allmeshdata[i].Vertices[(*indices)[i].Indices[t]].Pos) &&
-							box.isPointInside(allmeshdata[i].Vertices[(*indices)[i].Indices[t+1]].Pos) &&
-							box.isPointInside(allmeshdata[i].Vertices[(*indices)[i].Indices[t+2]].Pos))
-						{
-							tic.Indices.push_back((*indices)[i].Indices[t]);
-							tic.Indices.push_back((*indices)[i].Indices[t+1]);
-							tic.Indices.push_back((*indices)[i].Indices[t+2]);
-
-							added = true;
-						}
-						else
-						{
-							keepIndices.push_back((*indices)[i].Indices[t]);
-							keepIndices.push_back((*indices)[i].Indices[t+1]);
-							keepIndices.push_back((*indices)[i].Indices[t+2]);
-						}
+						pool->addJob(&jobs[i], group);
+						queued[i] = true;
 					}
-
-					(*indices)[i].Indices.set_used(keepIndices.size());
-					memcpy( (*indices)[i].Indices.pointer(), keepIndices.pointer(), keepIndices.size()*sizeof(u16));
-					keepIndices.set_used(0);
 				}
+			}
 
-				if (added)
-					Children[ch] = new OctreeNode(nodeCount, Depth,
-						allmeshdata, cindexChunks, minimalPolysPerNode);
-				else
-					delete cindexChunks;
+			// build the other children here while the pool works on the large ones
+			for (i=0; i!=8; ++i)
+				if (counts[i] && !queued[i])
+					jobs[i].run();
 
-			} // end for all possible children
+			if (pool)
+				pool->waitForJobs(group);
 
-			IndexData = indices;
+			u32 nodeCount = 1;
+			for (i=0; i!=8; ++i)
+				nodeCount += jobs[i].NodeCount;
+			return nodeCount;
 		}
 
-		// destructor
-		~OctreeNode()
+		// moves the triangles into the sorted index arrays of the chunks
+		// and remembers the ranges of this node and its subtree
+		void sortIndices(const SBuildData& data, core::array< core::array<TIndex> >& sorted,
+			core::array<u32>& ranges)
 		{
-			delete IndexData;
+			const u32 chunkCount = sorted.size();
+			RangeIndex = ranges.size();
 
-			for (u32 i=0; i<8; ++i)
-				delete Children[i];
+			u32 c;
+			for (c=0; c!=chunkCount; ++c)
+			{
+				ranges.push_back(sorted[c].size());
+				ranges.push_back(0);
+				ranges.push_back(0);
+			}
+
+			for (u32 i=TriangleBegin; i<TriangleOwnEnd; ++i)
+			{
+				const STriangle& tri = data.Triangles[i];
+				const SMeshChunk& chunk = data.Meshes[tri.Chunk];
+				core::array<TIndex>& out = sorted[tri.Chunk];
+				out.push_back((TIndex)getChunkIndex(chunk, tri.FirstIndex));
+				out.push_back((TIndex)getChunkIndex(chunk, tri.FirstIndex+1));
+				out.push_back((TIndex)getChunkIndex(chunk, tri.FirstIndex+2));
+			}
+
+			for (c=0; c!=chunkCount; ++c)
+				ranges[RangeIndex + c*3 + 1] = sorted[c].size();
+
+			for (u32 ch=0; ch!=8; ++ch)
+				if (Children[ch])
+					Children[ch]->sortIndices(data, sorted, ranges);
+
+			for (c=0; c!=chunkCount; ++c)
+				ranges[RangeIndex + c*3 + 2] = sorted[c].size();
 		}
 
 		// returns all ids of polygons partially or full enclosed
 		// by this bounding box.
-		void getPolys(const core::aabbox3d<f32>& box, SIndexData* idxdata, u32 parentTest ) const
+		void getPolys(const core::aabbox3d<f32>& box, Octree& tree, u32 parentTest ) const
 		{
 #if defined (OCTREE_PARENTTEST )
 			// if not full inside
@@ -283,34 +383,28 @@ private:
 				// fully inside ?
 				parentTest = Box.isFullInside(box)?2:1;
 			}
+
+			// the whole subtree is visible
+			if ( parentTest == 2 )
+			{
+				copyIndices(tree, 2);
+				return;
+			}
 #else
 			if (Box.intersectsWithBox(box))
 #endif
 			{
-				const u32 cnt = IndexData->size();
-				u32 i; // new ISO for scoping problem in some compilers
-
-				for (i=0; i<cnt; ++i)
-				{
-					const s32 idxcnt = (*IndexData)[i].Indices.size();
+				copyIndices(tree, 1);
 
-					if (idxcnt)
-					{
-						memcpy(&idxdata[i].Indices[idxdata[i].CurrentSize],
-							&(*IndexData)[i].Indices[0], idxcnt * sizeof(s16));
-						idxdata[i].CurrentSize += idxcnt;
-					}
-				}
-
-				for (i=0; i!=8; ++i)
+				for (u32 i=0; i!=8; ++i)
 					if (Children[i])
-						Children[i]->getPolys(box, idxdata,parentTest);
+						Children[i]->getPolys(box, tree, parentTest);
 			}
 		}
 
 		// returns all ids of polygons partially or full enclosed
 		// by the view frustum.
-		void getPolys(const scene::SViewFrustum& frustum, SIndexData* idxdata,u32 parentTest) const
+		void getPolys(const scene::SViewFrustum& frustum, Octree& tree, u32 parentTest) const
 		{
 			u32 i; // new ISO for scoping problem in some compilers
 
@@ -334,24 +428,20 @@ private:
 				}
 			}
 
-
-			const u32 cnt = IndexData->size();
-
-			for (i=0; i!=cnt; ++i)
+#if defined (OCTREE_PARENTTEST )
+			// the whole subtree is visible
+			if ( parentTest == 2 )
 			{
-				s32 idxcnt = (*IndexData)[i].Indices.size();
-
-				if (idxcnt)
-				{
-					memcpy(&idxdata[i].Indices[idxdata[i].CurrentSize],
-						&(*IndexData)[i].Indices[0], idxcnt * sizeof(s16));
-					idxdata[i].CurrentSize += idxcnt;
-				}
+				copyIndices(tree, 2);
+				return;
 			}
+#endif
+
+			copyIndices(tree, 1);
 
 			for (i=0; i!=8; ++i)
 				if (Children[i])
-					Children[i]->getPolys(frustum, idxdata,parentTest);
+					Children[i]->getPolys(frustum, tree, parentTest);
 		}
 
 		//! for debug purposes only, collects the bounding boxes of the node
@@ -370,16 +460,104 @@ private:
 
 	private:
 
+		// builds one child, run directly or by the thread pool
+		struct SChildJob : public IThreadJob
+		{
+			SChildJob() : Node(0), Data(0), Begin(0), End(0), NodeCount(0) {}
+
+			void set(OctreeNode* node, SBuildData* data, u32 begin, u32 end)
+			{
+				Node = node;
+				Data = data;
+				Begin = begin;
+				End = end;
+			}
+
+			virtual void run()
+			{
+				NodeCount = Node->build(*Data, Begin, End);
+			}
+
+			OctreeNode* Node;
+			SBuildData* Data;
+			u32 Begin;
+			u32 End;
+			u32 NodeCount;
+		};
+
+		// returns the first child which fully contains the triangle, or 8
+		u8 classify(const SBuildData& data, const STriangle& tri,
+			const core::vector3df& middle, const core::vector3df& diag) const
+		{
+			core::aabbox3df t(data.getPos(tri, 0));
+			t.addInternalPoint(data.getPos(tri, 1));
+			t.addInternalPoint(data.getPos(tri, 2));
+
+			// children are ordered like the edges of aabbox3d::getEdges,
+			// bit 0 selects the upper Y, bit 1 the upper Z and bit 2 the upper X half.
+			u8 child = 0;
+			if (!isInsideHalf(t.MinEdge.Y, t.MaxEdge.Y, middle.Y + diag.Y, middle.Y))
+			{
+				if (!isInsideHalf(t.MinEdge.Y, t.MaxEdge.Y, middle.Y, middle.Y - diag.Y))
+					return 8;
+				child |= 1;
+			}
+			if (!isInsideHalf(t.MinEdge.Z, t.MaxEdge.Z, middle.Z + diag.Z, middle.Z))
+			{
+				if (!isInsideHalf(t.MinEdge.Z, t.MaxEdge.Z, middle.Z, middle.Z - diag.Z))
+					return 8;
+				child |= 2;
+			}
+			if (!isInsideHalf(t.MinEdge.X, t.MaxEdge.X, middle.X + diag.X, middle.X))
+			{
+				if (!isInsideHalf(t.MinEdge.X, t.MaxEdge.X, middle.X, middle.X - diag.X))
+					return 8;
+				child |= 4;
+			}
+			return child;
+		}
+
+		static bool isInsideHalf(f32 triMin, f32 triMax, f32 halfMin, f32 halfMax)
+		{
+			return triMin >= halfMin && triMax <= halfMax;
+		}
+
+		// appends the own (part 1) or whole subtree (part 2) indices to the output
+		void copyIndices(Octree& tree, u32 part) const
+		{
+			const u32 cnt = tree.IndexDataCount;
+			const u32* range = &tree.NodeRanges[RangeIndex];
+
+			for (u32 i=0; i!=cnt; ++i, range+=3)
+			{
+				const u32 idxcnt = range[part] - range[0];
+
+				if (idxcnt)
+				{
+					SIndexData& out = tree.IndexData[i];
+					memcpy(&out.Indices[out.CurrentSize],
+						&tree.SortedIndices[i][range[0]], idxcnt * sizeof(TIndex));
+					out.CurrentSize += idxcnt;
+				}
+			}
+		}
+
 		core::aabbox3df Box;
-		core::array<SIndexChunk>* IndexData;
 		OctreeNode* Children[8];
-		u32 Depth;
+		u32 TriangleBegin;
+		u32 TriangleOwnEnd;
+		u32 RangeIndex;
 	};
 
 	OctreeNode* Root;
 	SIndexData* IndexData;
 	u32 IndexDataCount;
 	u32 NodeCount;
+
+	//! indices of each chunk, sorted by node in depth first order
+	core::array< core::array<TIndex> > SortedIndices;
+	//! start, own end and subtree end into SortedIndices per node and chunk
+	core::array<u32> NodeRanges;
 };
 
 } // end namespace
@@ -93,6 +93,12 @@
 
 #define SOFTWARE_DRIVER_2_MIPMAPPING_SCALE (8/SOFTWARE_DRIVER_2_MIPMAPPING_MAX)
 
+// block compressed textures
+// the largest mip map level of DXT1 and DXT5 textures stays compressed, the
+// sampled 4x4 blocks are decoded into a small cache of each texture stage
+#define SOFTWARE_DRIVER_2_TEXTURE_COMPRESSION
+#define SOFTWARE_DRIVER_2_BLOCK_CACHE_SIZE		64
+
 #ifndef REALINLINE
 	#ifdef _MSC_VER
 		#define REALINLINE __forceinline
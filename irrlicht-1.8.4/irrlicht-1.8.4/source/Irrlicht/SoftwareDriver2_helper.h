@@ -703,6 +703,21 @@ struct fp24
 
 // ------------------------ Internal Texture -----------------------------
 
+#ifdef SOFTWARE_DRIVER_2_TEXTURE_COMPRESSION
+
+// decoded 4x4 blocks of a compressed texture, direct mapped
+struct sBlockCache
+{
+	// content id of the texture, see CSoftwareTexture2::getContentId()
+	u32 contentId;
+
+	// block index + 1, 0 is empty
+	u32 tag[SOFTWARE_DRIVER_2_BLOCK_CACHE_SIZE];
+	tVideoSample texel[SOFTWARE_DRIVER_2_BLOCK_CACHE_SIZE][16];
+};
+
+#endif
+
 struct sInternalTexture
 {
 	u32 textureXMask;
@@ -713,8 +728,34 @@ struct sInternalTexture
 
 	video::CSoftwareTexture2 *Texture;
 	s32 lodLevel;
+
+#ifdef SOFTWARE_DRIVER_2_TEXTURE_COMPRESSION
+	// bytes per block of a compressed level, 0 for plain texels. data are
+	// the blocks then and pitchlog2 is the pitch of the uncompressed level
+	u32 blockSize;
+	u32 blockPitchlog2;
+	video::ECOLOR_FORMAT blockFormat;
+
+	// owned by the shader, so every thread rendering has its own
+	sBlockCache *blockCache;
+#endif
 };
 
+#ifdef SOFTWARE_DRIVER_2_TEXTURE_COMPRESSION
+// decodes the block of the texel at byte offset ofs of the uncompressed level
+tVideoSample getTexel_block ( const sInternalTexture * t, const u32 ofs );
+#endif
+
+// get texel at byte offset ofs of the current level
+REALINLINE tVideoSample getTexel_ofs ( const sInternalTexture * t, const u32 ofs )
+{
+#ifdef SOFTWARE_DRIVER_2_TEXTURE_COMPRESSION
+	if ( t->blockSize )
+		return getTexel_block ( t, ofs );
+#endif
+	return *((tVideoSample*)( (u8*) t->data + ofs ));
+}
+
 
 
 // get video sample plain
@@ -726,7 +767,7 @@ inline tVideoSample getTexel_plain ( const sInternalTexture * t, const tFixPoint
 	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
 
 	// texel
-	return *((tVideoSample*)( (u8*) t->data + ofs ));
+	return getTexel_ofs ( t, ofs );
 }
 
 // get video sample to fix
@@ -741,7 +782,7 @@ inline void getTexel_fix ( tFixPoint &r, tFixPoint &g, tFixPoint &b,
 
 	// texel
 	tVideoSample t00;
-	t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
+	t00 = getTexel_ofs ( t, ofs );
 
 	r	 =	(t00 & MASK_R) >> ( SHIFT_R - FIX_POINT_PRE);
 	g	 =	(t00 & MASK_G) << ( FIX_POINT_PRE - SHIFT_G );
@@ -761,7 +802,7 @@ REALINLINE void getTexel_fix ( tFixPoint &a,
 
 	// texel
 	tVideoSample t00;
-	t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
+	t00 = getTexel_ofs ( t, ofs );
 
 	a	 =	(t00 & MASK_A) >> ( SHIFT_A - FIX_POINT_PRE);
 }
@@ -790,7 +831,7 @@ inline void getSample_texture_dither (	tFixPoint &r, tFixPoint &g, tFixPoint &b,
 	ofs |= ( _ntx ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
 
 	// texel
-	const tVideoSample t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
+	const tVideoSample t00 = getTexel_ofs ( t, ofs );
 
 	(tFixPointu &) r	 =	(t00 & MASK_R) >> ( SHIFT_R - FIX_POINT_PRE);
 	(tFixPointu &) g	 =	(t00 & MASK_G) << ( FIX_POINT_PRE - SHIFT_G );
@@ -815,7 +856,7 @@ inline void getSample_texture ( tFixPoint &r, tFixPoint &g, tFixPoint &b,
 	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
 
 	// texel
-	const tVideoSample t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
+	const tVideoSample t00 = getTexel_ofs ( t, ofs );
 
 	(tFixPointu &) r	 =	(t00 & MASK_R) >> ( SHIFT_R - FIX_POINT_PRE);
 	(tFixPointu &) g	 =	(t00 & MASK_G) << ( FIX_POINT_PRE - SHIFT_G );
@@ -832,7 +873,7 @@ inline void getSample_texture ( tFixPointu &a, tFixPointu &r, tFixPointu &g, tFi
 	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
 
 	// texel
-	const tVideoSample t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
+	const tVideoSample t00 = getTexel_ofs ( t, ofs );
 
 	(tFixPointu &)a	 =	(t00 & MASK_A) >> ( SHIFT_A - FIX_POINT_PRE);
 	(tFixPointu &)r	 =	(t00 & MASK_R) >> ( SHIFT_R - FIX_POINT_PRE);
@@ -856,7 +897,7 @@ REALINLINE void getSample_linear ( tFixPointu &r, tFixPointu &g, tFixPointu &b,
 
 	// texel
 	tVideoSample t00;
-	t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
+	t00 = getTexel_ofs ( t, ofs );
 
 	r	 =	(t00 & MASK_R) >> SHIFT_R;
 	g	 =	(t00 & MASK_G) >> SHIFT_G;
@@ -888,16 +929,16 @@ REALINLINE void getSample_texture ( tFixPoint &r, tFixPoint &g, tFixPoint &b,
 	o2 =   ( (tx) & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
 	o3 =   ( (tx+FIX_POINT_ONE) & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
 
-	t00 = *((tVideoSample*)( (u8*) t->data + (o0 | o2 ) ));
+	t00 = getTexel_ofs ( t, (o0 | o2 ) );
 	r00	 =	(t00 & MASK_R) >> SHIFT_R; g00  =	(t00 & MASK_G) >> SHIFT_G; b00	 =	(t00 & MASK_B);
 
-	t00 = *((tVideoSample*)( (u8*) t->data + (o0 | o3 ) ));
+	t00 = getTexel_ofs ( t, (o0 | o3 ) );
 	r10	 =	(t00 & MASK_R) >> SHIFT_R; g10  =	(t00 & MASK_G) >> SHIFT_G; b10	 =	(t00 & MASK_B);
 
-	t00 = *((tVideoSample*)( (u8*) t->data + (o1 | o2 ) ));
+	t00 = getTexel_ofs ( t, (o1 | o2 ) );
 	r01	 =	(t00 & MASK_R) >> SHIFT_R; g01  =	(t00 & MASK_G) >> SHIFT_G; b01	 =	(t00 & MASK_B);
 
-	t00 = *((tVideoSample*)( (u8*) t->data + (o1 | o3 ) ));
+	t00 = getTexel_ofs ( t, (o1 | o3 ) );
 	r11	 =	(t00 & MASK_R) >> SHIFT_R; g11  =	(t00 & MASK_G) >> SHIFT_G; b11	 =	(t00 & MASK_B);
 
 #endif
@@ -943,7 +984,7 @@ REALINLINE void getSample_linear ( tFixPointu &a, tFixPointu &r, tFixPointu &g,
 
 	// texel
 	tVideoSample t00;
-	t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
+	t00 = getTexel_ofs ( t, ofs );
 
 	a	 =	(t00 & MASK_A) >> SHIFT_A;
 	r	 =	(t00 & MASK_R) >> SHIFT_R;
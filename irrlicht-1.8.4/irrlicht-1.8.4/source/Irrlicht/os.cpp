@@ -170,30 +170,79 @@ namespace os
 	// The platform independent implementation of the printer
 	ILogger* Printer::Logger = 0;
 
+	namespace
+	{
+		// buffer of the calling thread, see Printer::setMessageBuffer()
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_MSC_VER)
+		__declspec(thread) core::array<SLogMessage>* MessageBuffer = 0;
+#elif defined(_IRR_COMPILE_WITH_THREADS_)
+		__thread core::array<SLogMessage>* MessageBuffer = 0;
+#else
+		core::array<SLogMessage>* MessageBuffer = 0;
+#endif
+
+		void bufferMessage(const c8* message, const c8* hint, ELOG_LEVEL ll)
+		{
+			MessageBuffer->push_back(SLogMessage());
+			SLogMessage& buffered = MessageBuffer->getLast();
+			buffered.Text = message;
+			buffered.HasHint = hint != 0;
+			if (hint)
+				buffered.Hint = hint;
+			buffered.Level = ll;
+		}
+	}
+
 	void Printer::log(const c8* message, ELOG_LEVEL ll)
 	{
-		if (Logger)
+		if (MessageBuffer)
+			bufferMessage(message, 0, ll);
+		else if (Logger)
 			Logger->log(message, ll);
 	}
 
 	void Printer::log(const wchar_t* message, ELOG_LEVEL ll)
 	{
-		if (Logger)
+		if (MessageBuffer)
+			bufferMessage(core::stringc(message).c_str(), 0, ll);
+		else if (Logger)
 			Logger->log(message, ll);
 	}
 
 	void Printer::log(const c8* message, const c8* hint, ELOG_LEVEL ll)
 	{
-		if (Logger)
+		if (MessageBuffer)
+			bufferMessage(message, hint, ll);
+		else if (Logger)
 			Logger->log(message, hint, ll);
 	}
 
 	void Printer::log(const c8* message, const io::path& hint, ELOG_LEVEL ll)
 	{
-		if (Logger)
+		if (MessageBuffer)
+			bufferMessage(message, hint.c_str(), ll);
+		else if (Logger)
 			Logger->log(message, hint.c_str(), ll);
 	}
 
+	void Printer::log(const core::array<SLogMessage>& messages)
+	{
+		for (u32 i=0; i<messages.size(); ++i)
+		{
+			if (messages[i].HasHint)
+				log(messages[i].Text.c_str(), messages[i].Hint.c_str(), messages[i].Level);
+			else
+				log(messages[i].Text.c_str(), messages[i].Level);
+		}
+	}
+
+	core::array<SLogMessage>* Printer::setMessageBuffer(core::array<SLogMessage>* messages)
+	{
+		core::array<SLogMessage>* previous = MessageBuffer;
+		MessageBuffer = messages;
+		return previous;
+	}
+
 	// our Randomizer is not really os specific, so we
 	// code one for all, which should work on every platform the same,
 	// which is desireable.
@@ -8,6 +8,7 @@
 #include "IrrCompileConfig.h" // for endian check
 #include "irrTypes.h"
 #include "irrString.h"
+#include "irrArray.h"
 #include "path.h"
 #include "ILogger.h"
 #include "ITimer.h"
@@ -30,6 +31,15 @@ namespace os
 		static c8  byteswap(c8  num);
 	};
 
+	//! A message logged while the messages of a thread were buffered
+	struct SLogMessage
+	{
+		core::stringc Text;
+		core::stringc Hint;
+		ELOG_LEVEL Level;
+		bool HasHint;
+	};
+
 	class Printer
 	{
 	public:
@@ -39,6 +49,18 @@ namespace os
 		static void log(const wchar_t* message, ELOG_LEVEL ll = ELL_INFORMATION);
 		static void log(const c8* message, const c8* hint, ELOG_LEVEL ll = ELL_INFORMATION);
 		static void log(const c8* message, const io::path& hint, ELOG_LEVEL ll = ELL_INFORMATION);
+
+		//! Logs messages which were buffered, in their order
+		static void log(const core::array<SLogMessage>& messages);
+
+		//! Collects the messages logged by the calling thread instead of logging them
+		/** Used around work on worker threads, as the loggers are only
+		called from the main thread. The messages are logged later on the
+		main thread with log(const core::array<SLogMessage>&).
+		\param messages Array receiving the messages, 0 to log directly again.
+		\return The buffer set before, to be restored afterwards. */
+		static core::array<SLogMessage>* setMessageBuffer(core::array<SLogMessage>* messages);
+
 		static ILogger* Logger;
 	};
 
@@ -0,0 +1,51 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Runs all tests, or only the one whose name is passed as argument.
+// Returns the number of failed tests.
+
+#include <stdio.h>
+#include <string.h>
+
+// each test returns true if it passed
+bool simdMatrix(void);
+
+struct STest
+{
+	const char* Name;
+	bool (*Function)(void);
+};
+
+static const STest Tests[] =
+{
+	{ "simdMatrix", simdMatrix }
+};
+
+int main(int argc, char* argv[])
+{
+	const char* only = argc > 1 ? argv[1] : 0;
+	int run = 0;
+	int failed = 0;
+
+	for (unsigned int i=0; i<sizeof(Tests)/sizeof(Tests[0]); ++i)
+	{
+		if (only && strcmp(only, Tests[i].Name))
+			continue;
+
+		const bool passed = Tests[i].Function();
+		printf("%s: %s\n", Tests[i].Name, passed ? "passed" : "FAILED");
+		++run;
+		if (!passed)
+			++failed;
+	}
+
+	if (!run)
+	{
+		printf("No test named %s\n", only);
+		return 1;
+	}
+
+	printf("%d of %d tests failed\n", failed, run);
+	return failed;
+}
@@ -0,0 +1,186 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Measures the f32 matrix functions. The Makefile builds it twice, with the
+// SIMD code and with NO_IRR_COMPILE_WITH_SIMD_ for the C++ code, so both
+// can be compared on the same machine. The printed checksums of both builds
+// have to be close.
+
+#include <stdio.h>
+#include <time.h>
+#include "matrix4.h"
+#include "S3DVertex.h"
+
+using namespace irr;
+using namespace core;
+
+namespace
+{
+
+u32 Seed = 1;
+
+f32 random(f32 low, f32 high)
+{
+	Seed = Seed * 1103515245 + 12345;
+	return low + (high - low) * ((Seed >> 8) & 0xffff) / 65535.f;
+}
+
+vector3df randomVector(f32 range)
+{
+	const f32 x = random(-range, range);
+	const f32 y = random(-range, range);
+	const f32 z = random(-range, range);
+	return vector3df(x, y, z);
+}
+
+matrix4 randomAffine()
+{
+	matrix4 m;
+	m.setRotationDegrees(randomVector(180.f));
+	matrix4 scale;
+	scale.setScale(vector3df(random(0.5f, 2.f), random(0.5f, 2.f), random(0.5f, 2.f)));
+	m *= scale;
+	m.setTranslation(randomVector(10.f));
+	return m;
+}
+
+// the results of all runs, keeps the compiler from removing the work
+f64 Checksum = 0.0;
+
+void report(const char* name, clock_t start, u32 operations)
+{
+	const f64 seconds = (f64)(clock() - start) / CLOCKS_PER_SEC;
+	printf("%-32s %8.2f ns\n", name, seconds * 1e9 / operations);
+}
+
+const u32 Count = 1024;
+const u32 Runs = 2000;
+
+} // end anonymous namespace
+
+int main()
+{
+#if defined(_IRR_COMPILE_WITH_SSE_)
+	printf("SSE matrix functions, time per operation\n");
+#elif defined(_IRR_COMPILE_WITH_NEON_)
+	printf("NEON matrix functions, time per operation\n");
+#else
+	printf("C++ matrix functions, time per operation\n");
+#endif
+
+	matrix4 matrices[Count];
+	for (u32 i=0; i<Count; ++i)
+		matrices[i] = randomAffine();
+
+	// results are written to arrays and a different one is added to the
+	// checksum on each run, so the compiler can't skip calculating any of them
+	matrix4* products = new matrix4[Count];
+	vector3df* vectors = new vector3df[Count];
+	vector3df* results = new vector3df[Count];
+	video::S3DVertex* vertices = new video::S3DVertex[Count];
+	triangle3df* triangles = new triangle3df[Count];
+	aabbox3df* boxes = new aabbox3df[Count];
+	aabbox3df* transformedBoxes = new aabbox3df[Count];
+	for (u32 i=0; i<Count; ++i)
+	{
+		vectors[i] = randomVector(100.f);
+		vertices[i].Pos = vectors[i];
+		triangles[i].set(randomVector(100.f), randomVector(100.f), randomVector(100.f));
+		boxes[i].reset(randomVector(100.f));
+		boxes[i].addInternalPoint(randomVector(100.f));
+	}
+
+	// the transformations are applied to their own results, so they are
+	// done with an orthonormal matrix to keep the numbers in range
+	matrix4 rotation;
+	rotation.setRotationDegrees(vector3df(10.f, 20.f, 30.f));
+
+	clock_t start = clock();
+	for (u32 r=0; r<Runs; ++r)
+	{
+		for (u32 i=0; i+1<Count; ++i)
+			products[i].setbyproduct_nocheck(matrices[i], matrices[i+1]);
+		Checksum += products[r%(Count-1)][r%16];
+	}
+	report("matrix product", start, Runs*(Count-1));
+
+	start = clock();
+	for (u32 r=0; r<Runs/20; ++r)
+	{
+		for (u32 i=0; i<Count; ++i)
+			matrices[i].getInverse(products[i]);
+		Checksum += products[r%Count][r%16];
+	}
+	report("getInverse", start, Runs/20*Count);
+
+	start = clock();
+	for (u32 r=0; r<Runs; ++r)
+	{
+		for (u32 i=0; i<Count; ++i)
+		{
+			results[i] = vectors[i];
+			rotation.transformVect(results[i]);
+		}
+		Checksum += results[r%Count].X;
+	}
+	report("transformVect", start, Runs*Count);
+
+	start = clock();
+	for (u32 r=0; r<Runs; ++r)
+	{
+		rotation.transformVects(results, vectors, Count);
+		Checksum += results[r%Count].X;
+	}
+	report("transformVects, packed", start, Runs*Count);
+
+	start = clock();
+	for (u32 r=0; r<Runs; ++r)
+	{
+		rotation.transformVects(&vertices[0].Pos, &vertices[0].Pos, Count,
+			sizeof(video::S3DVertex), sizeof(video::S3DVertex));
+		Checksum += vertices[r%Count].Pos.X;
+	}
+	report("transformVects, vertices", start, Runs*Count);
+
+	start = clock();
+	for (u32 r=0; r<Runs; ++r)
+	{
+		rotation.rotateVects(results, vectors, Count);
+		Checksum += results[r%Count].X;
+	}
+	report("rotateVects, packed", start, Runs*Count);
+
+	start = clock();
+	for (u32 r=0; r<Runs; ++r)
+	{
+		rotation.transformTriangles(triangles, triangles, Count);
+		Checksum += triangles[r%Count].pointA.X;
+	}
+	report("transformTriangles", start, Runs*Count);
+
+	start = clock();
+	for (u32 r=0; r<Runs; ++r)
+	{
+		for (u32 i=0; i<Count; ++i)
+		{
+			transformedBoxes[i] = boxes[i];
+			matrices[i].transformBoxEx(transformedBoxes[i]);
+		}
+		const aabbox3df& box = transformedBoxes[r%Count];
+		Checksum += box.MinEdge.X + box.MinEdge.Y + box.MinEdge.Z +
+			box.MaxEdge.X + box.MaxEdge.Y + box.MaxEdge.Z;
+	}
+	report("transformBoxEx", start, Runs*Count);
+
+	printf("checksum %.6g\n", Checksum);
+
+	delete [] transformedBoxes;
+	delete [] boxes;
+	delete [] triangles;
+	delete [] vertices;
+	delete [] results;
+	delete [] vectors;
+	delete [] products;
+	return 0;
+}
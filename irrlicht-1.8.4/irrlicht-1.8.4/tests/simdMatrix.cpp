@@ -0,0 +1,370 @@
+// Copyright (C) 2002-2012 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+// Compares the SIMD versions of the f32 matrix functions with the C++ code.
+// The C++ code runs as CMatrix4<f64>, which has no SIMD version, and as the
+// single vector functions transformVect() and rotateVect(). When the engine
+// is compiled without SIMD support this tests the C++ code against itself.
+
+#include <stdio.h>
+#include <math.h>
+#include "matrix4.h"
+#include "S3DVertex.h"
+
+using namespace irr;
+using namespace core;
+
+namespace
+{
+
+// the same numbers on each run and each platform
+u32 Seed = 1;
+
+f32 random(f32 low, f32 high)
+{
+	Seed = Seed * 1103515245 + 12345;
+	return low + (high - low) * ((Seed >> 8) & 0xffff) / 65535.f;
+}
+
+vector3df randomVector(f32 range)
+{
+	const f32 x = random(-range, range);
+	const f32 y = random(-range, range);
+	const f32 z = random(-range, range);
+	return vector3df(x, y, z);
+}
+
+//! Random scale, rotation and translation, what most nodes have
+matrix4 randomAffine()
+{
+	matrix4 rotation;
+	rotation.setRotationDegrees(randomVector(180.f));
+	matrix4 scale;
+	scale.setScale(vector3df(random(0.1f, 10.f), random(0.1f, 10.f), random(0.1f, 10.f)));
+	matrix4 result(rotation * scale);
+	result.setTranslation(randomVector(1000.f));
+	return result;
+}
+
+//! Random entries, with a strong diagonal so the matrix can be inverted
+matrix4 randomMatrix()
+{
+	matrix4 result;
+	for (u32 i=0; i<16; ++i)
+		result[i] = random(-2.f, 2.f) + (i%5 ? 0.f : 4.f);
+	return result;
+}
+
+CMatrix4<f64> toDouble(const matrix4& m)
+{
+	CMatrix4<f64> result;
+	for (u32 i=0; i<16; ++i)
+		result[i] = m[i];
+	return result;
+}
+
+bool close(f32 value, f64 expected, f64 scale, const char* what)
+{
+	if (fabs(value - expected) <= 1e-5 * core::max_(1.0, scale))
+		return true;
+
+	printf("%s: %.9g instead of %.9g\n", what, value, expected);
+	return false;
+}
+
+bool close(const vector3df& value, const vector3df& expected, const char* what)
+{
+	const f64 scale = core::max_(fabs(expected.X), core::max_(fabs(expected.Y), fabs(expected.Z)));
+	return close(value.X, expected.X, scale, what) &&
+		close(value.Y, expected.Y, scale, what) &&
+		close(value.Z, expected.Z, scale, what);
+}
+
+bool testProduct()
+{
+	for (u32 n=0; n<1000; ++n)
+	{
+		const matrix4 a = n%2 ? randomAffine() : randomMatrix();
+		const matrix4 b = n%3 ? randomAffine() : randomMatrix();
+
+		const CMatrix4<f64> expected = toDouble(a) * toDouble(b);
+		matrix4 product = a * b;
+		matrix4 assigned(a);
+		assigned *= b;
+
+		for (u32 i=0; i<16; ++i)
+		{
+			// compare with the sum of the absolute products, the size of the rounding errors
+			f64 scale = 0.0;
+			for (u32 k=0; k<4; ++k)
+				scale += fabs((f64)a[k*4+i%4] * b[(i/4)*4+k]);
+			if (!close(product[i], expected[i], scale, "operator*") ||
+				!close(assigned[i], expected[i], scale, "operator*="))
+				return false;
+		}
+	}
+	return true;
+}
+
+//! Transforms vectors in a packed array at all alignments and all counts around the four vector steps
+bool testPackedVectors(bool rotate)
+{
+	const char* what = rotate ? "rotateVects" : "transformVects";
+	const f32 guard = 12345.f;
+
+	f32 input[3*16+4];
+	f32 output[3*16+4+4];
+
+	for (u32 n=0; n<50; ++n)
+	{
+		const matrix4 m = n%2 ? randomAffine() : randomMatrix();
+		for (u32 offset=0; offset<4; ++offset)
+		{
+			for (u32 count=0; count<=16; ++count)
+			{
+				vector3df* in = (vector3df*)(input + offset);
+				vector3df* out = (vector3df*)(output + (3-offset));
+				for (u32 i=0; i<3*16+4; ++i)
+					input[i] = random(-100.f, 100.f);
+				for (u32 i=0; i<3*16+4+4; ++i)
+					output[i] = guard;
+
+				if (rotate)
+					m.rotateVects(out, in, count);
+				else
+					m.transformVects(out, in, count);
+
+				for (u32 i=0; i<count; ++i)
+				{
+					vector3df expected(in[i]);
+					if (rotate)
+						m.rotateVect(expected);
+					else
+						m.transformVect(expected);
+					if (!close(out[i], expected, what))
+						return false;
+				}
+
+				// nothing written in front of or behind the vectors
+				for (u32 i=0; i<3*16+4+4; ++i)
+				{
+					const f32* p = output + i;
+					if ((p < &out[0].X || p >= &out[count].X) && output[i] != guard)
+					{
+						printf("%s: overwrote a float outside of %u vectors\n", what, count);
+						return false;
+					}
+				}
+
+				// in place
+				vector3df copy[16];
+				for (u32 i=0; i<count; ++i)
+					copy[i] = out[i];
+				for (u32 i=0; i<count; ++i)
+					out[i] = in[i];
+				if (rotate)
+					m.rotateVects(out, out, count);
+				else
+					m.transformVects(out, out, count);
+				for (u32 i=0; i<count; ++i)
+				{
+					if (out[i] != copy[i])
+					{
+						printf("%s: different results when transforming in place\n", what);
+						return false;
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+//! Transforms the positions of vertices, the three float stores must keep the normals
+bool testStridedVectors(bool rotate)
+{
+	const char* what = rotate ? "rotateVects with stride" : "transformVects with stride";
+
+	video::S3DVertex vertices[13];
+	vector3df packed[13];
+
+	for (u32 n=0; n<50; ++n)
+	{
+		const matrix4 m = n%2 ? randomAffine() : randomMatrix();
+		for (u32 i=0; i<13; ++i)
+		{
+			vertices[i].Pos = randomVector(100.f);
+			vertices[i].Normal = randomVector(1.f);
+			vertices[i].Color = video::SColor(Seed);
+			vertices[i].TCoords.set(random(0.f, 1.f), random(0.f, 1.f));
+		}
+		video::S3DVertex original[13];
+		for (u32 i=0; i<13; ++i)
+			original[i] = vertices[i];
+
+		// vertices to packed, and then in place
+		if (rotate)
+		{
+			m.rotateVects(packed, &vertices[0].Pos, 13, sizeof(vector3df), sizeof(video::S3DVertex));
+			m.rotateVects(&vertices[0].Pos, &vertices[0].Pos, 13, sizeof(video::S3DVertex), sizeof(video::S3DVertex));
+		}
+		else
+		{
+			m.transformVects(packed, &vertices[0].Pos, 13, sizeof(vector3df), sizeof(video::S3DVertex));
+			m.transformVects(&vertices[0].Pos, &vertices[0].Pos, 13, sizeof(video::S3DVertex), sizeof(video::S3DVertex));
+		}
+
+		for (u32 i=0; i<13; ++i)
+		{
+			vector3df expected(original[i].Pos);
+			if (rotate)
+				m.rotateVect(expected);
+			else
+				m.transformVect(expected);
+
+			if (!close(packed[i], expected, what) || !close(vertices[i].Pos, expected, what))
+				return false;
+
+			if (vertices[i].Normal != original[i].Normal || vertices[i].Color != original[i].Color ||
+				vertices[i].TCoords != original[i].TCoords)
+			{
+				printf("%s: overwrote the other members of vertex %u\n", what, i);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool testTriangles()
+{
+	triangle3df triangles[7];
+	triangle3df result[7];
+
+	for (u32 n=0; n<50; ++n)
+	{
+		const matrix4 m = randomAffine();
+		for (u32 i=0; i<7; ++i)
+			triangles[i].set(randomVector(100.f), randomVector(100.f), randomVector(100.f));
+
+		m.transformTriangles(result, triangles, 7);
+
+		for (u32 i=0; i<7; ++i)
+		{
+			vector3df a(triangles[i].pointA), b(triangles[i].pointB), c(triangles[i].pointC);
+			m.transformVect(a);
+			m.transformVect(b);
+			m.transformVect(c);
+			if (!close(result[i].pointA, a, "transformTriangles") ||
+				!close(result[i].pointB, b, "transformTriangles") ||
+				!close(result[i].pointC, c, "transformTriangles"))
+				return false;
+		}
+	}
+	return true;
+}
+
+bool testBoxes()
+{
+	aabbox3df boxes[5];
+	aabbox3df expected[5];
+
+	for (u32 n=0; n<200; ++n)
+	{
+		const matrix4 m = n%2 ? randomAffine() : randomMatrix();
+		const CMatrix4<f64> reference = toDouble(m);
+
+		for (u32 i=0; i<5; ++i)
+		{
+			boxes[i].reset(randomVector(100.f));
+			boxes[i].addInternalPoint(randomVector(100.f));
+			expected[i] = boxes[i];
+			reference.transformBoxEx(expected[i]);
+		}
+
+		aabbox3df single(boxes[0]);
+		m.transformBoxEx(single);
+		m.transformBoxesEx(boxes, 5);
+
+		if (!close(single.MinEdge, expected[0].MinEdge, "transformBoxEx") ||
+			!close(single.MaxEdge, expected[0].MaxEdge, "transformBoxEx"))
+			return false;
+
+		for (u32 i=0; i<5; ++i)
+		{
+			if (!close(boxes[i].MinEdge, expected[i].MinEdge, "transformBoxesEx") ||
+				!close(boxes[i].MaxEdge, expected[i].MaxEdge, "transformBoxesEx"))
+				return false;
+		}
+	}
+	return true;
+}
+
+bool testInverse()
+{
+	for (u32 n=0; n<1000; ++n)
+	{
+		const matrix4 m = n%2 ? randomAffine() : randomMatrix();
+
+		CMatrix4<f64> expected;
+		if (!toDouble(m).getInverse(expected))
+			continue;
+
+		matrix4 inverse;
+		if (!m.getInverse(inverse))
+		{
+			printf("getInverse: failed on an invertible matrix\n");
+			return false;
+		}
+
+		// the error grows with the largest entry of the inverse
+		f64 scale = 0.0;
+		for (u32 i=0; i<16; ++i)
+			scale = core::max_(scale, fabs(expected[i]));
+		for (u32 i=0; i<16; ++i)
+		{
+			if (fabs(inverse[i] - expected[i]) > 1e-4 * core::max_(1.0, scale))
+			{
+				printf("getInverse: %.9g instead of %.9g\n", inverse[i], expected[i]);
+				return false;
+			}
+		}
+	}
+
+	// no inverse with a row of zeros
+	matrix4 singular = randomMatrix();
+	singular[4] = singular[5] = singular[6] = singular[7] = 0.f;
+	matrix4 inverse;
+	if (singular.getInverse(inverse))
+	{
+		printf("getInverse: inverted a singular matrix\n");
+		return false;
+	}
+	return true;
+}
+
+} // end anonymous namespace
+
+//! Compares the SIMD matrix functions with the C++ code
+bool simdMatrix(void)
+{
+#if defined(_IRR_COMPILE_WITH_SSE_)
+	printf("Testing the SSE matrix functions\n");
+#elif defined(_IRR_COMPILE_WITH_NEON_)
+	printf("Testing the NEON matrix functions\n");
+#else
+	printf("No SIMD support, testing the C++ matrix functions\n");
+#endif
+
+	bool result = true;
+	result &= testProduct();
+	result &= testPackedVectors(false);
+	result &= testPackedVectors(true);
+	result &= testStridedVectors(false);
+	result &= testStridedVectors(true);
+	result &= testTriangles();
+	result &= testBoxes();
+	result &= testInverse();
+	return result;
+}
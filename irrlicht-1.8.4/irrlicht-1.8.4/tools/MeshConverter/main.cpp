@@ -18,7 +18,8 @@ void usage(const char* name)
 	std::cerr << "Usage: " << name << " [options] <srcFile> <destFile>" << std::endl;
 	std::cerr << "  where options are" << std::endl;
 	std::cerr << " --createTangents: convert to tangents mesh is possible." << std::endl;
-	std::cerr << " --format=[irrmesh|collada|stl|obj|ply]: Choose target format" << std::endl;
+	std::cerr << " --compress: compress the mesh, for the irrbmesh format." << std::endl;
+	std::cerr << " --format=[irrmesh|irrbmesh|collada|stl|obj|ply]: Choose target format" << std::endl;
 }
 
 int main(int argc, char* argv[])
@@ -38,6 +39,7 @@ int main(int argc, char* argv[])
 	scene::EMESH_WRITER_TYPE type = EMWT_IRR_MESH;
 	u32 i=1;
 	bool createTangents=false;
+	s32 flags=EMWF_NONE;
 	while (argv[i][0]=='-')
 	{
 		core::stringc format = argv[i];
@@ -46,7 +48,9 @@ int main(int argc, char* argv[])
 			if (format.equalsn("--format=",9))
 			{
 				format = format.subString(9,format.size());
-				if (format=="collada")
+				if (format=="irrbmesh")
+					type = EMWT_IRR_BINARY_MESH;
+				else if (format=="collada")
 					type = EMWT_COLLADA;
 				else if (format=="stl")
 					type = EMWT_STL;
@@ -60,6 +64,9 @@ int main(int argc, char* argv[])
 			else
 			if (format =="--createTangents")
 				createTangents=true;
+			else
+			if (format =="--compress")
+				flags |= EMWF_WRITE_COMPRESSED;
 		}
 		else
 		if (format=="--")
@@ -81,24 +88,39 @@ int main(int argc, char* argv[])
 		return 1;
 	}
 
-	createTangents = createTangents && (type==EMWT_IRR_MESH);
+	createTangents = createTangents && (type==EMWT_IRR_MESH || type==EMWT_IRR_BINARY_MESH);
 	std::cout << "Converting " << argv[srcmesh] << " to " << argv[destmesh] << std::endl;
-	IMesh* mesh = device->getSceneManager()->getMesh(argv[srcmesh])->getMesh(0);
+	IAnimatedMesh* animatedMesh = device->getSceneManager()->getMesh(argv[srcmesh]);
+	IMesh* mesh = animatedMesh ? animatedMesh->getMesh(0) : 0;
 	if (!mesh)
 	{
 		std::cerr << "Could not load " << argv[srcmesh] << std::endl;
 		return 1;
 	}
+	// skinned meshes keep their joints and animation where the writer supports it
+	IMesh* tangentMesh = 0;
 	if (createTangents)
 	{
-		IMesh* tmp = device->getSceneManager()->getMeshManipulator()->createMeshWithTangents(mesh);
-		mesh->drop();
-		mesh=tmp;
+		if (animatedMesh->getMeshType() == EAMT_SKINNED)
+			((ISkinnedMesh*)animatedMesh)->convertMeshToTangents();
+		else
+		{
+			tangentMesh = device->getSceneManager()->getMeshManipulator()->createMeshWithTangents(mesh);
+			mesh=tangentMesh;
+		}
 	}
 	IMeshWriter* mw = device->getSceneManager()->createMeshWriter(type);
 	IWriteFile* file = device->getFileSystem()->createAndWriteFile(argv[destmesh]);
-	mw->writeMesh(file, mesh);
-	
+	if (!mw || !file)
+	{
+		std::cerr << "Could not write " << argv[destmesh] << std::endl;
+		return 1;
+	}
+	if (tangentMesh || !mw->writeAnimatedMesh(file, animatedMesh, flags))
+		mw->writeMesh(file, mesh, flags);
+
+	if (tangentMesh)
+		tangentMesh->drop();
 	file->drop();
 	mw->drop();
 	device->drop();